@@ -0,0 +1,214 @@
+#include "drive_mix.h"
+/*ֲ أ˵ drive_mix.h */
+
+#define DRIVE_ABS(x)		((x)<0?-(x):(x))
+#define DRIVE_MAX(a,b)		((a)>(b)?(a):(b))
+#define DRIVE_CLAMP(x)		((x)>DRIVE_FULL?DRIVE_FULL:((x)<-DRIVE_FULL?-DRIVE_FULL:(x)))
+
+const u16 Drive_Curve_Expo[DRIVE_LUT_N]={
+	0,23,46,72,100,132,169,213,262,320,386,463,550,648,760,884,1024};
+
+// + 
+//x:DRIVE_FULL (İ)
+s16 Drive_Shape(s16 x,u16 deadband,const u16 *curve)
+{
+	s32 a=DRIVE_ABS((s32)x);
+	u16 i,f;
+	if(a>DRIVE_FULL)a=DRIVE_FULL;
+	if(deadband>=DRIVE_FULL)return 0;
+	a=a>deadband?(a-deadband)*DRIVE_FULL/(DRIVE_FULL-deadband):0;	//ȥ 
+	if(curve)
+	{
+		i=a>>6;							//DRIVE_FULL/(DRIVE_LUT_N-1)=64 һ
+		f=a&63;
+		a=i<DRIVE_LUT_N-1?curve[i]+(((s32)curve[i+1]-curve[i])*f>>6):curve[DRIVE_LUT_N-1];
+	}
+	return x<0?-a:a;
+}
+
+///ת -> /֣ʱ ְͬһ
+void Drive_Mix(s16 thr,s16 str,s16 *left,s16 *right)
+{
+	s32 l=(s32)thr+str;
+	s32 r=(s32)thr-str;
+	s32 m=DRIVE_MAX(DRIVE_MAX(DRIVE_ABS(l),DRIVE_ABS(r)),DRIVE_FULL);
+	*left=l*DRIVE_FULL/m;
+	*right=r*DRIVE_FULL/m;
+}
+
+//cur  target  step (0:)
+s16 Drive_Slew(s16 cur,s16 target,u16 step)
+{
+	s32 d=(s32)target-cur;
+	if(step==0)return target;
+	if(d>step)d=step;
+	else if(d<-(s32)step)d=-(s32)step;
+	return cur+d;
+}
+
+//DRIVE_FULL -> CCR ( ɲʱ ռգи 0)
+u16 Drive_Duty(const Drive_Config *cfg,s16 v)
+{
+	u32 a=DRIVE_ABS((s32)v);
+	if(a==0)return cfg->brake?cfg->pwm_max:0;
+	if(a>DRIVE_FULL)a=DRIVE_FULL;
+	return cfg->pwm_min+a*(cfg->pwm_max-cfg->pwm_min)/DRIVE_FULL;
+}
+
+/*/CCR*/
+
+static const Drive_Config *Drive_Cfg=0;
+static u8  Drive_Thr_Gain=100,Drive_Str_Gain=100;
+static s16 Drive_Cur[2]={0,0};				//б֮ / 
+
+//ж   ֮佻ӵ ״̬
+typedef struct{
+				u8  now;					// ڵ״̬ DRIVE_xxx
+				u8  want;					//Ҫе״̬
+				u16 ccr;					//Ҫд CCR
+				u8  zero;					//1:Ѿд CCR=0һ¼ ٷ
+				}Drive_Out;
+static volatile Drive_Out Drive_State[2];
+
+//ţin1=dir ĵ0λin2=1λ (STOP 00 / FWD 01 / REV 10 / BRAKE 11)
+static void Drive_Pins(const Drive_Motor *m,u8 dir)
+{
+	*m->in1=dir&1;
+	*m->in2=dir>>1;
+}
+
+// Drive_Cur ж
+//жϸģֻ UIE ס Ѿ/ڽ ĸжϣ want  ccr  һ룻
+//жȼ (0)BASEPRI Ҳס ٽٽֻмθֵ
+static void Drive_Publish(void)
+{
+	u8 i,want[2];
+	u16 ccr[2];
+	s16 v;
+	for(i=0;i<2;i++)
+	{
+		v=Drive_Cur[i];
+		want[i]=v>0?DRIVE_FWD:(v<0?DRIVE_REV:(Drive_Cfg->brake?DRIVE_BRAKE:DRIVE_STOP));
+		ccr[i]=Drive_Duty(Drive_Cfg,v);
+	}
+	__disable_irq();
+	for(i=0;i<2;i++)
+	{
+		Drive_State[i].want=want[i];
+		Drive_State[i].ccr=ccr[i];
+	}
+	DRIVE_TIM->DIER|=TIM_DIER_UIE;
+	__enable_irq();
+}
+
+void Drive_Init(const Drive_Config *cfg)
+{
+	NVIC_InitTypeDef NVIC_InitStructure;
+	u8 i;
+
+	DRIVE_TIM->DIER&=~TIM_DIER_UIE;
+	Drive_Cfg=cfg;
+	Drive_Thr_Gain=100;
+	Drive_Str_Gain=100;
+	for(i=0;i<2;i++)
+	{
+		Drive_Cur[i]=0;
+		Drive_Pins(&cfg->m[i],DRIVE_STOP);
+		*cfg->m[i].ccr=0;
+		Drive_State[i].now=DRIVE_STOP;
+		Drive_State[i].want=DRIVE_STOP;
+		Drive_State[i].ccr=0;
+		Drive_State[i].zero=0;
+	}
+
+	//жȼNVICãߣжϺ̣ܶ дһʱ 
+	NVIC_InitStructure.NVIC_IRQChannel = DRIVE_TIM_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0;  	//ռȼ0
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;  		//ȼ0
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE; 			//IRQͨʹ
+	NVIC_Init(&NVIC_InitStructure);  							//ʼNVICĴ
+	DRIVE_TIM->SR=(u16)~TIM_SR_UIF;
+}
+
+void Drive_Gain(u8 thr_pct,u8 str_pct)
+{
+	Drive_Thr_Gain=thr_pct;
+	Drive_Str_Gain=str_pct;
+}
+
+// :ǰ  ת :ת (ֿ)
+void Drive_Arcade(s16 thr,s16 str)
+{
+	s16 t,s,l,r;
+	if(Drive_Cfg==0)return;
+	t=(s32)Drive_Shape(thr,Drive_Cfg->deadband,Drive_Cfg->thr_curve)*Drive_Thr_Gain/100;
+	s=(s32)Drive_Shape(str,Drive_Cfg->deadband,Drive_Cfg->str_curve)*Drive_Str_Gain/100;
+	Drive_Mix(DRIVE_CLAMP(t),DRIVE_CLAMP(s),&l,&r);
+	Drive_Cur[0]=Drive_Slew(Drive_Cur[0],l,Drive_Cfg->slew);
+	Drive_Cur[1]=Drive_Slew(Drive_Cur[1],r,Drive_Cfg->slew);
+	Drive_Publish();
+}
+
+void Drive_Tank(s16 left,s16 right)
+{
+	if(Drive_Cfg==0)return;
+	left=Drive_Shape(left,Drive_Cfg->deadband,0);
+	right=Drive_Shape(right,Drive_Cfg->deadband,0);
+	Drive_Cur[0]=Drive_Slew(Drive_Cur[0],left,Drive_Cfg->slew);
+	Drive_Cur[1]=Drive_Slew(Drive_Cur[1],right,Drive_Cfg->slew);
+	Drive_Publish();
+}
+
+//ͣ (ʧ/ͣãб)
+void Drive_Stop(u8 brake)
+{
+	u8 i;
+	if(Drive_Cfg==0)return;
+	__disable_irq();					//ͬ Drive_Publish
+	for(i=0;i<2;i++)
+	{
+		Drive_Cur[i]=0;
+		Drive_State[i].want=brake?DRIVE_BRAKE:DRIVE_STOP;
+		Drive_State[i].ccr=brake?Drive_Cfg->pwm_max:0;
+	}
+	DRIVE_TIM->DIER|=TIM_DIER_UIE;
+	__enable_irq();
+}
+
+void Drive_Get(s16 *left,s16 *right)
+{
+	*left=Drive_Cur[0];
+	*right=Drive_Cur[1];
+}
+
+//PWM ʱжϣʱտʼһµ PWM 
+void DRIVE_TIM_IRQHandler(void)
+{
+	u8 i,busy=0;
+	volatile Drive_Out *d;
+	const Drive_Motor *m;
+	if(DRIVE_TIM->SR&TIM_SR_UIF)
+	{
+		for(i=0;i<2;i++)
+		{
+			d=&Drive_State[i];
+			m=&Drive_Cfg->m[i];
+			if(d->want!=d->now)
+			{
+				if(!d->zero)				//д 0ڻǾռձȣ¸ 0
+				{
+					*m->ccr=0;
+					d->zero=1;
+					busy=1;
+					continue;
+				}
+				Drive_Pins(m,d->want);		//ϸ¼Ѿװ 0ʱ ûë
+				d->now=d->want;
+			}
+			*m->ccr=d->ccr;					//¸Ч
+			d->zero=0;
+		}
+		DRIVE_TIM->SR=(u16)~TIM_SR_UIF;		//д CCR ־һνж һһ¼
+		if(!busy)DRIVE_TIM->DIER&=~TIM_DIER_UIE;	//ûҪȵ ж
+	}
+}
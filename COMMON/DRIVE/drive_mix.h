@@ -0,0 +1,81 @@
+#ifndef __DRIVE_MIX_H
+#define __DRIVE_MIX_H
+#include "sys.h"
+
+/*ֲ  ( 񶷻 / PS2С һ)
+  Ҫ FWLibļ "stm32f10x_tim.c"  "misc.c"Keil  · COMMON\DRIVE\drive_mix.c
+
+  ԭÿ̵ Motor__Control / Motor_Control / Motor_Speed_Control һ if/else 
+  ÿ֧дһ   TIM3->CCRxת (swerve*65/100 ֮) дڷ֧
+  ת һе ٷתܰѵԴ硣ͳһһˮߣ
+	 (/ת򣬡DRIVE_FULL)
+	->  (ȥ)
+	->  (DRIVE_LUT_N  + ԲֵÿԼ䣬NULL Ϊֱ)
+	->  (ٷֱȣ L3/R3 ֮ / )
+	->   = +ת = -ת򣬳ʱ ְһ (ת)
+	-> б (ÿε ÿ slewתҪȼ 0 ټȥ)
+	-> ռձ (pwm_min~pwm_max  ɲ/)
+    CCR ֻ PWM ʱ ж д
+	CCR Ԥװأждֵ һ PWM ڲЧ
+	Ҫʱ д CCR=0ȵһж (ʱѾ 0 ռ) ٷšдµ CCR
+	Բ "Ѿ ɵռձȻ" ë塣
+	ûҪĵĶʱ صжϣռ CPU
+  ʱ PWM ʼ (̵ TIM3_PWM_Init) Ҫ CCR Ԥװ (OCxPE)еĶˡ
+
+  ʹã
+	static const Drive_Config Motor_Drive={
+		{{&M1_1,&M1_2,&TIM3->CCR1},{&M2_1,&M2_2,&TIM3->CCR2}},	// (in1=1 in2=0 Ϊǰ)
+		250,0,16,150,0,Drive_Curve_Expo,1};
+	TIM3_PWM_Init(250-1,72-1);
+	Drive_Init(&Motor_Drive);
+	Drive_Arcade(speed,swerve);		//̶ڵ (бʰô)
+*/
+
+#ifndef DRIVE_TIM								//PWM ʱ (/CCR ĸжд)
+#define DRIVE_TIM				TIM3
+#define DRIVE_TIM_IRQn			TIM3_IRQn
+#define DRIVE_TIM_IRQHandler	TIM3_IRQHandler
+#endif
+
+#define DRIVE_FULL		1024	///м 
+#define DRIVE_LUT_N		17		//ߵ0,64,128,...,1024 
+
+#define DRIVE_STOP		0		// in1=0 in2=0
+#define DRIVE_FWD		1		//ǰ in1=1 in2=0
+#define DRIVE_REV		2		// in1=0 in2=1
+#define DRIVE_BRAKE		3		//ɲ in1=1 in2=1 (TB6612 ·ƶ)
+
+typedef struct{
+				volatile unsigned long *in1;	// λַ (&PAout(0) ֮)
+				volatile unsigned long *in2;
+				volatile u16 *ccr;				//ռձȼĴ (&TIM3->CCR1 ֮)
+				}Drive_Motor;
+
+typedef struct{
+				Drive_Motor m[2];				//0: 1:
+				u16 pwm_max;					//ռյ CCR ֵ
+				u16 pwm_min;					//С CCR (˷Ħ)0:
+				u16 deadband;					// (0~DRIVE_FULL)
+				u16 slew;						//ÿε ÿ仯 (DRIVE_FULL λ)0:
+				const u16 *thr_curve;			// DRIVE_LUT_N  (0~DRIVE_FULL)NULL:ֱ
+				const u16 *str_curve;			//ת
+				u8  brake;						// 1:ɲ 0:
+				}Drive_Config;
+
+extern const u16 Drive_Curve_Expo[DRIVE_LUT_N];	//м ͷӲ (0.35x+0.65x^3)
+
+/* (Ӳ)*/
+s16  Drive_Shape(s16 x,u16 deadband,const u16 *curve);	// + 
+void Drive_Mix(s16 thr,s16 str,s16 *left,s16 *right);	///ת -> / ( DRIVE_FULL)
+s16  Drive_Slew(s16 cur,s16 target,u16 step);			//cur  target  step
+u16  Drive_Duty(const Drive_Config *cfg,s16 v);			//DRIVE_FULL -> CCR
+
+/* (Drive_Arcade/Tank/Stop ݹжϣҪ ж ĵط)*/
+void Drive_Init(const Drive_Config *cfg);	// PWM ʱʼ֮ͣ ()
+void Drive_Gain(u8 thr_pct,u8 str_pct);		///ת  % (Ĭ 100)
+void Drive_Arcade(s16 thr,s16 str);			// :ǰ  ת :ת
+void Drive_Tank(s16 left,s16 right);		//ֱӸ / (ߺͻأ /б)
+void Drive_Stop(u8 brake);					//ͣ (б) 1:ɲ 0:
+void Drive_Get(s16 *left,s16 *right);		//ǰ /  (б֮)
+
+#endif
@@ -0,0 +1,158 @@
+#include "telem.h"
+#include "string.h"
+//////////////////////////////////////////////////////////////////////////////////
+//STM32F103ZEİ
+// -> ̨ NRF24L01 ݰ / (˵ telem.h)
+//////////////////////////////////////////////////////////////////////////////////
+
+//CRC16 CCITT (0x1021ֵ 0xFFFFÿβ 4 λ)
+static const u16 Telem_Crc_Tab[16]={
+	0x0000,0x1021,0x2042,0x3063,0x4084,0x50A5,0x60C6,0x70E7,
+	0x8108,0x9129,0xA14A,0xB16B,0xC18C,0xD1AD,0xE1CE,0xF1EF};
+u16 Telem_CRC16(const u8 *buf,u16 len)
+{
+	u16 crc=0XFFFF;
+	while(len--)
+	{
+		crc=(crc<<4)^Telem_Crc_Tab[(crc>>12)^(*buf>>4)];
+		crc=(crc<<4)^Telem_Crc_Tab[(crc>>12)^(*buf&0x0F)];
+		buf++;
+	}
+	return crc;
+}
+
+//map ͨ
+static u8 Telem_Ch_Num(u16 map)
+{
+	u8 i,n=0;
+	for(i=0;i<TELEM_CH_MAX;i++)if(map&(1<<i))n++;
+	return n;
+}
+
+void Telem_Enc_Init(Telem_Enc *e,u16 map,u8 batch)
+{
+	memset(e,0,sizeof(Telem_Enc));
+	e->map=map&((1<<TELEM_CH_MAX)-1);
+	e->ch=Telem_Ch_Num(e->map);
+	if(batch==0)batch=1;
+	if(batch>TELEM_SAMPLE_MAX)batch=TELEM_SAMPLE_MAX;
+	e->batch=batch;
+}
+
+//һ
+//ֵ:0,װȥ;1,װ ( Telem_Enc_Flush ټ)
+u8 Telem_Enc_Add(Telem_Enc *e,u32 ms,const s16 *val)
+{
+	s16 v[TELEM_CH_MAX];
+	s32 d;
+	u32 dt;
+	u8 i,k=0,wide=0,need;
+	for(i=0;i<TELEM_CH_MAX;i++)if(e->map&(1<<i))v[k++]=val[i];
+	if(e->n==0)											//°ͷ + ֵ
+	{
+		if(TELEM_HEAD+2*e->ch+2>TELEM_FRAME_MAX)return 1;
+		e->buf[0]=(TELEM_VERSION<<4)|1;
+		e->buf[1]=e->seq;
+		e->buf[2]=e->map;
+		e->buf[3]=e->map>>8;
+		e->buf[4]=ms;
+		e->buf[5]=ms>>8;
+		e->len=TELEM_HEAD;
+		for(i=0;i<e->ch;i++)
+		{
+			e->buf[e->len++]=v[i];
+			e->buf[e->len++]=(u16)v[i]>>8;
+			e->last[i]=v[i];
+		}
+		e->last_ms=ms;
+		e->n=1;
+		return 0;
+	}
+	if(e->n>=e->batch)return 1;
+	dt=(ms-e->last_ms+TELEM_DT_UNIT/2)/TELEM_DT_UNIT;
+	if(dt>0x7F)return 1;
+	for(i=0;i<e->ch;i++)
+	{
+		d=(s32)v[i]-e->last[i];
+		if(d<-128||d>127)return 1;
+		if(d<-8||d>7)wide=1;
+	}
+	need=1+(wide?e->ch:(e->ch+1)/2);
+	if(e->len+need+2>TELEM_FRAME_MAX)return 1;
+	e->buf[e->len++]=(wide<<7)|dt;
+	for(i=0;i<e->ch;i++)
+	{
+		d=(s32)v[i]-e->last[i];
+		if(wide)e->buf[e->len++]=(u8)d;
+		else if((i&1)==0)e->buf[e->len++]=d&0x0F;
+		else e->buf[e->len-1]|=(d&0x0F)<<4;
+		e->last[i]=v[i];
+	}
+	e->last_ms+=dt*TELEM_DT_UNIT;						//Ǳһۻ
+	e->n++;
+	e->buf[0]=(TELEM_VERSION<<4)|e->n;
+	return 0;
+}
+
+u8 Telem_Enc_Full(const Telem_Enc *e)
+{
+	return e->n>=e->batch;
+}
+
+//
+//ֵ:ȣ0:û
+u8 Telem_Enc_Flush(Telem_Enc *e,u8 *out)
+{
+	u16 crc;
+	u8 len=e->len;
+	if(e->n==0)return 0;
+	memcpy(out,e->buf,len);
+	crc=Telem_CRC16(out,len);
+	out[len++]=crc;
+	out[len++]=crc>>8;
+	e->seq++;
+	e->n=0;
+	e->len=0;
+	return len;
+}
+
+//һ
+//ֵ:0,ɹ;1,/汾;2,CRC ;3,ݲ
+u8 Telem_Decode(const u8 *buf,u8 len,Telem_Frame *f)
+{
+	u8 ch[TELEM_CH_MAX];
+	u8 i,k,s,num=0,tag,p=TELEM_HEAD;
+	s16 d;
+	if(len<TELEM_HEAD+2||len>TELEM_FRAME_MAX||(buf[0]>>4)!=TELEM_VERSION)return 1;
+	if(Telem_CRC16(buf,len-2)!=(buf[len-2]|(buf[len-1]<<8)))return 2;
+	len-=2;
+	f->n=buf[0]&0x0F;
+	f->seq=buf[1];
+	f->map=buf[2]|(buf[3]<<8);
+	if(f->n==0||(f->map>>TELEM_CH_MAX))return 3;
+	for(i=0;i<TELEM_CH_MAX;i++)if(f->map&(1<<i))ch[num++]=i;
+	memset(f->val,0,sizeof(f->val[0])*f->n);
+	f->time[0]=buf[4]|(buf[5]<<8);
+	if(p+2*num>len)return 3;
+	for(k=0;k<num;k++,p+=2)f->val[0][ch[k]]=buf[p]|(buf[p+1]<<8);
+	for(s=1;s<f->n;s++)
+	{
+		if(p>=len)return 3;
+		tag=buf[p++];
+		if(p+((tag&0x80)?num:(num+1)/2)>len)return 3;
+		f->time[s]=f->time[s-1]+(tag&0x7F)*TELEM_DT_UNIT;
+		for(k=0;k<num;k++)
+		{
+			if(tag&0x80)d=(s8)buf[p++];
+			else
+			{
+				d=(k&1)?(buf[p++]>>4):(buf[p]&0x0F);
+				if(d&0x08)d-=16;						//4 λз
+			}
+			f->val[s][ch[k]]=f->val[s-1][ch[k]]+d;
+		}
+		if((tag&0x80)==0&&(num&1))p++;					//ͨ ֽ
+	}
+	if(p!=len)return 3;
+	return 0;
+}
@@ -0,0 +1,90 @@
+#ifndef __TELEM_H
+#define __TELEM_H
+#include "sys.h"
+//////////////////////////////////////////////////////////////////////////////////
+//STM32F103ZEİ
+// -> ̨ NRF24L01 ݰ /
+//TFTLCD_sensor / TFTLCD_consule һݣKeil  · COMMON\TELEM\telem.c
+//////////////////////////////////////////////////////////////////////////////////
+
+/* ʽ (Сˣһ 32 ֽ)
+	u8  ver_n		4λ 汾 TELEM_VERSION4λ  n (1~15)
+	u8  seq			ţÿ 1 (̨㶪)
+	u16 map			ͨλͼbit i = ͨ TELEM_CH_xxx ֵֵ bit ӵ͵
+	u16 time		һʱ ms (16λ)
+	һ		ÿͨ s16 ֵ
+	 n-1 	1 ֽ tag + ͨһĲֵ
+					tag bit7:0,ֵ 4 λ (-8~7ͨһֽ Ͱֽǰ);1,ֵ 8 λ (-128~127)
+					tag bit6~0:һʱ 10ms λ ( 1.27s)
+	u16 crc			ǰȫֽڵ CRC16 (CCITT 0x1021ֵ 0xFFFF)
+	7 ͨ1  22 ֽڣ仯ʱһװ 3  (ASCII һ 1 )
+	ֵŲ¡ʱ̫   ͷһ°
+
+	ֵ λ
+	MQ135/MQ2/MQ6/MQ7	1 ppm
+	CHIP_T/DHT_T/DS18_T	0.1 
+	DHT_RH				0.1 %
+	SHT_T				0.01 
+	SHT_RH				0.01 %
+
+	
+	Telem_Enc_Init(&enc,TELEM_MAP_NODE,3);		//ÿ 3 
+	if(Telem_Enc_Add(&enc,ms,val))				//װ£Ȱ
+	{
+		NRF_Link_Send(buf,Telem_Enc_Flush(&enc,buf));
+		Telem_Enc_Add(&enc,ms,val);
+	}
+	if(Telem_Enc_Full(&enc))NRF_Link_Send(buf,Telem_Enc_Flush(&enc,buf));
+	̨
+	if(Telem_Decode(buf,len,&frame)==0) frame.val[frame.n-1][TELEM_CH_MQ2] ...
+*/
+
+#define TELEM_VERSION		1
+#define TELEM_FRAME_MAX		32			//NRF24L01 һ
+#define TELEM_HEAD			6
+#define TELEM_SAMPLE_MAX	15			//ver_n 4λ
+#define TELEM_DT_UNIT		10			//tag ʱĵλ ms
+
+//ͨ
+#define TELEM_CH_MQ135		0			// 
+#define TELEM_CH_MQ2		1			//ȼ
+#define TELEM_CH_MQ6		2			//Һ
+#define TELEM_CH_MQ7		3			//CO
+#define TELEM_CH_CHIP_T		4			//оƬڲ¶
+#define TELEM_CH_SHT_T		5			//SHT2X ¶
+#define TELEM_CH_SHT_RH		6			//SHT2X ʪ
+#define TELEM_CH_DHT_T		7			//DHT11 ¶
+#define TELEM_CH_DHT_RH		8			//DHT11 ʪ
+#define TELEM_CH_DS18_T		9			//DS18B20 ¶
+#define TELEM_CH_MAX		10
+
+#define TELEM_MAP_NODE		0X007F		//ڵװ: MQ135~SHT2X
+
+typedef struct{
+				u8  buf[TELEM_FRAME_MAX];	//ƴİ ( CRC)
+				u8  len;
+				u8  n;						//װ
+				u8  batch;					//ÿ
+				u8  seq;
+				u16 map;
+				u8  ch;						//map ͨ
+				s16 last[TELEM_CH_MAX];		//һ ( map ˳)
+				u32 last_ms;
+				}Telem_Enc;
+
+typedef struct{
+				u8  seq;
+				u8  n;						//
+				u16 map;
+				u16 time[TELEM_SAMPLE_MAX];	//ÿʱ ms (16λ)
+				s16 val[TELEM_SAMPLE_MAX][TELEM_CH_MAX];	//ͨŷţmap ûеͨ Ϊ 0
+				}Telem_Frame;
+
+u16  Telem_CRC16(const u8 *buf,u16 len);
+void Telem_Enc_Init(Telem_Enc *e,u16 map,u8 batch);			//batch:ÿ 1~15
+u8   Telem_Enc_Add(Telem_Enc *e,u32 ms,const s16 *val);	//val ͨ (TELEM_CH_MAX ) 0:װȥ 1:װ
+u8   Telem_Enc_Full(const Telem_Enc *e);						//1: batch  ÷
+u8   Telem_Enc_Flush(Telem_Enc *e,u8 *out);					// ( CRC)  outسȣ0:û
+u8   Telem_Decode(const u8 *buf,u8 len,Telem_Frame *f);		//0:ɹ 1:/汾 2:CRC  3:ݲ
+
+#endif
@@ -0,0 +1,185 @@
+/* ֲ   (УƬ)
+	ֱӱ COMMON/DRIVE/drive_mix.cTIM3   ڴ棺
+		/ֵ߲ ļ㣬 Գƣ
+		 ļ㣬 /ת ̡תԣ
+		бʡռձ (ɲ/Сpwm_min)
+		ģ PWM ¼ (CCR Ԥװأ¼ʱ  CCR װ)
+			ת -> ٷת Ҫбߣֻ װռձΪ 0 ʱ
+			 /ͣ¼  ж ڼ (жϺ ܹж)
+			ÿηŶ飬ͣԺ /CCR  Drive_Get Եϡ
+
+	룺gcc -O2 -I .. -I stub -I ../../DRIVE -o drive_test drive_test.c
+	÷drive_test []   Ĭ 200000ȫͨ 0򷵻 1 ӡ 
+*/
+#include "test_common.h"
+#include "drive_mix.c"
+
+TIM_TypeDef Test_TIM3;
+static volatile unsigned long Pin[4];			// in1 in2 in1 in2
+static u16 Act[2];								//¼ʱ װ ռձ ()
+static u8  Irq_Off=0,Irq_Pend=0,Irq_Rand=0;
+
+static const Drive_Config Cfg={
+	{{&Pin[0],&Pin[1],&Test_TIM3.CCR1},{&Pin[2],&Pin[3],&Test_TIM3.CCR2}},
+	250,0,16,150,0,Drive_Curve_Expo,1};
+
+//һθжϣ鷭ʱ ռձ 0
+static void Run_Irq(void)
+{
+	unsigned long o[4];
+	u8 i;
+	for(i=0;i<4;i++)o[i]=Pin[i];
+	TIM3_IRQHandler();
+	for(i=0;i<2;i++)
+		if(o[2*i]!=Pin[2*i]||o[2*i+1]!=Pin[2*i+1])
+			CHECK(Act[i]==0,"%s ʱ ռձ %u",i?"":"",Act[i]);
+}
+
+//һ PWM ڽװ CCRø±־ж ͹
+static void Tick(void)
+{
+	Act[0]=Test_TIM3.CCR1;
+	Act[1]=Test_TIM3.CCR2;
+	Test_TIM3.SR|=TIM_SR_UIF;
+	if(!(Test_TIM3.DIER&TIM_DIER_UIE))return;
+	if(Irq_Off)Irq_Pend=1;
+	else Run_Irq();
+}
+
+//жڼ һ¼ (Irq_Rand=1 ʱ)
+void Test_Irq_Off(void)
+{
+	CHECK(Irq_Off==0,"ж Ƕ");
+	Irq_Off=1;
+	if(Irq_Rand&&Rand()%4==0)Tick();
+}
+
+//жϣж Ѿ NVIC UIE Ҳס
+void Test_Irq_On(void)
+{
+	Irq_Off=0;
+	if(Irq_Pend)
+	{
+		Irq_Pend=0;
+		Run_Irq();
+	}
+}
+
+//Drive_State ķ ڽ϶Ӧĵƽ
+static u8 Pins(u8 i)
+{
+	return (u8)(Pin[2*i]|Pin[2*i+1]<<1);
+}
+
+static void Test_Shape(void)
+{
+	s16 x;
+	CHECK(Drive_Shape(10,16,0)==0,"  0");
+	CHECK(Drive_Shape(-1024,16,0)==-1024,"ȥ ̲");
+	CHECK(Drive_Shape(2000,0,0)==1024&&Drive_Shape(-32767,0,0)==-1024," ûа");
+	CHECK(Drive_Shape(512,0,Drive_Curve_Expo)==262,"  %d ӦΪ 262",Drive_Shape(512,0,Drive_Curve_Expo));
+	CHECK(Drive_Shape(544,0,Drive_Curve_Expo)==(262+320)/2," ֵ %d ӦΪ 291",Drive_Shape(544,0,Drive_Curve_Expo));
+	CHECK(Drive_Shape(100,1024,Drive_Curve_Expo)==0,"  ӦΪ 0");
+	for(x=-1024;x<1024;x++)
+	{
+		CHECK(Drive_Shape(x,16,Drive_Curve_Expo)<=Drive_Shape(x+1,16,Drive_Curve_Expo),"  %d ",x);
+		CHECK(Drive_Shape(-x,16,Drive_Curve_Expo)==-Drive_Shape(x,16,Drive_Curve_Expo),"  %d Գ",x);
+	}
+}
+
+static void Test_Mix(void)
+{
+	s16 l,r;
+	int t,s;
+	Drive_Mix(1024,0,&l,&r);	CHECK(l==1024&&r==1024,"ֱ %d %d",l,r);
+	Drive_Mix(0,1024,&l,&r);	CHECK(l==1024&&r==-1024,"ԭת %d %d",l,r);
+	Drive_Mix(1024,1024,&l,&r);	CHECK(l==1024&&r==0,"ת %d %d",l,r);
+	Drive_Mix(500,200,&l,&r);	CHECK(l==700&&r==300," %d %d",l,r);
+	Drive_Mix(-1024,512,&l,&r);	CHECK(l==-341&&r==-1024,"ת  %d %d",l,r);
+	for(t=-1024;t<=1024;t+=37)
+		for(s=-1024;s<=1024;s+=41)
+		{
+			Drive_Mix(t,s,&l,&r);
+			CHECK(abs(l)<=1024&&abs(r)<=1024," %d ת %d  %d %d",t,s,l,r);
+			CHECK((l-r)*s>=0&&(l+r)*t>=0," %d ת %d 򲻶 %d %d",t,s,l,r);
+		}
+}
+
+static void Test_Slew_Duty(void)
+{
+	Drive_Config c=Cfg;
+	CHECK(Drive_Slew(0,1000,150)==150&&Drive_Slew(100,-1000,150)==-50,"б ");
+	CHECK(Drive_Slew(5,7,150)==7&&Drive_Slew(0,-900,0)==-900,"б λ/ ");
+	CHECK(Drive_Duty(&c,0)==250&&Drive_Duty(&c,1024)==250&&Drive_Duty(&c,-512)==125,"ռձ (ɲ) ");
+	c.brake=0;
+	c.pwm_min=50;
+	CHECK(Drive_Duty(&c,0)==0&&Drive_Duty(&c,1)==50&&Drive_Duty(&c,-1024)==250,"ռձ (/pwm_min) ");
+}
+
+//ת -> ٷת
+static void Test_Reverse(void)
+{
+	s16 l,r;
+	int k,steps=0;
+	Drive_Init(&Cfg);
+	for(k=0;k<10;k++){ Drive_Arcade(1024,0); Tick(); Tick(); }
+	CHECK(Act[0]==250&&Pins(0)==DRIVE_FWD,"ת ûλ ռձ %u",Act[0]);
+	while(!(Pins(0)==DRIVE_REV&&Act[0]==250)&&steps<100)
+	{
+		Drive_Arcade(-1024,0);
+		Tick();
+		Tick();
+		steps++;
+	}
+	Drive_Get(&l,&r);
+	CHECK(l==-1024&&r==-1024,"ת û %d %d",l,r);
+	CHECK(steps>=13&&steps<20,"ٷת  %d ε (б 150 ӦΪ 14 )",steps);
+	Drive_Stop(0);
+	for(k=0;k<3;k++)Tick();
+	CHECK(Pins(0)==DRIVE_STOP&&Pins(1)==DRIVE_STOP&&Act[0]==0&&Act[1]==0,"ͣ /ռձȲ");
+	CHECK(!(Test_TIM3.DIER&TIM_DIER_UIE),"ͣ ж û");
+}
+
+// /ͣ¼  ж 
+static void Test_Random(u32 n)
+{
+	s16 v[2];
+	u8 i,want;
+	u32 k;
+	Drive_Init(&Cfg);
+	Irq_Rand=1;
+	for(k=0;k<n;k++)
+	{
+		switch(Rand()%4)
+		{
+			case 0: Drive_Arcade(Rand()%2049-1024,Rand()%2049-1024); break;
+			case 1: Drive_Tank(Rand()%2049-1024,Rand()%2049-1024); break;
+			case 2: if(Rand()%50==0)Drive_Stop(Rand()&1); break;
+			default: break;
+		}
+		CHECK(Irq_Off==0&&Irq_Pend==0," %u  ʱ жϻ/",k);
+		Tick();
+		if(Fail)break;
+	}
+	Irq_Rand=0;
+	for(k=0;k<4;k++)Tick();
+	Drive_Get(&v[0],&v[1]);
+	for(i=0;i<2;i++)
+	{
+		want=v[i]>0?DRIVE_FWD:(v[i]<0?DRIVE_REV:(Drive_State[i].want));
+		CHECK(Pins(i)==want&&Act[i]==(v[i]||Drive_State[i].want==DRIVE_BRAKE?Drive_Duty(&Cfg,v[i]):0),
+			"%s ͣ  %u ռձ %u  %d Բ",i?"":"",Pins(i),Act[i],v[i]);
+	}
+	CHECK(!(Test_TIM3.DIER&TIM_DIER_UIE),"ͣ ж û");
+}
+
+int main(int argc,char *argv[])
+{
+	u32 n=argc>1?strtoul(argv[1],0,0):200000;
+	Test_Shape();
+	Test_Mix();
+	Test_Slew_Duty();
+	Test_Reverse();
+	Test_Random(n);
+	return Test_Done();
+}
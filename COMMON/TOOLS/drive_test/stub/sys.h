@@ -0,0 +1,40 @@
+/* ϱãֻ drive_mix.c õͺͼĴ
+	TIM3 һڴ棬¼ ɲԼģ⣻
+	__disable_irq/__enable_irq  Irq_Off ڿжʱ  жڼ ж */
+#ifndef __SYS_H
+#define __SYS_H
+#include <stdint.h>
+typedef int32_t  s32;
+typedef int16_t  s16;
+typedef int8_t   s8;
+typedef uint32_t u32;
+typedef uint16_t u16;
+typedef uint8_t  u8;
+
+typedef struct
+{
+	volatile u16 CR1,DIER,SR,CCR1,CCR2,CCR3,CCR4;
+} TIM_TypeDef;
+
+typedef struct
+{
+	u8 NVIC_IRQChannel;
+	u8 NVIC_IRQChannelPreemptionPriority;
+	u8 NVIC_IRQChannelSubPriority;
+	u8 NVIC_IRQChannelCmd;
+} NVIC_InitTypeDef;
+
+#define ENABLE			1
+#define TIM3_IRQn		29
+#define TIM_DIER_UIE	((u16)0x0001)
+#define TIM_SR_UIF		((u16)0x0001)
+
+extern TIM_TypeDef Test_TIM3;
+#define TIM3			(&Test_TIM3)
+#define NVIC_Init(x)	((void)(x))
+
+void Test_Irq_Off(void);
+void Test_Irq_On(void);
+#define __disable_irq()	Test_Irq_Off()
+#define __enable_irq()	Test_Irq_On()
+#endif
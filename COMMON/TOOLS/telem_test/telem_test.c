@@ -0,0 +1,118 @@
+/* ݰ /  (УƬ)
+	ֱӱ COMMON/TELEM/telem.c
+		CRC16 Уֵһֽ  telem.h дĸʽֽڶϣ
+		 ͨλͼ/ÿ/ֵ/ʱ ٽ룬ֵһģһʱ TELEM_DT_UNIT/2 32 ֽڣ
+		ڵ 7 ͨ һװ 3 С仯
+		CRC 汾ȴض İ ա
+
+	룺gcc -O2 -I .. -I stub -I ../../TELEM -o telem_test telem_test.c
+	÷telem_test []   Ĭ 100000ȫͨ 0򷵻 1 ӡ һ
+*/
+#include "test_common.h"
+#include "telem.c"
+
+// telem.h ĸʽ һͨ 0,1 ڶ ֵ 4 λ
+static void Test_Format(void)
+{
+	static const u8 want[]={0x12,0x00,0x03,0x00,0xE8,0x03,0x64,0x00,0xFB,0xFF,0x01,0xE3};
+	Telem_Enc e;
+	Telem_Frame f;
+	s16 v[TELEM_CH_MAX]={0};
+	u8 out[TELEM_FRAME_MAX];
+	u8 len;
+	u16 crc;
+
+	CHECK(Telem_CRC16((const u8*)"123456789",9)==0x29B1,"CRC16 Уֵ %04X ӦΪ 29B1",Telem_CRC16((const u8*)"123456789",9));
+	Telem_Enc_Init(&e,0x0003,3);
+	v[0]=100;v[1]=-5;v[2]=1234;						//ͨ 2 λͼ
+	CHECK(Telem_Enc_Add(&e,1000,v)==0,"һ װȥ");
+	v[0]=103;v[1]=-7;
+	CHECK(Telem_Enc_Add(&e,1012,v)==0,"ڶ װȥ");
+	len=Telem_Enc_Flush(&e,out);
+	crc=Telem_CRC16(want,sizeof(want));
+	CHECK(len==sizeof(want)+2&&memcmp(out,want,sizeof(want))==0&&out[len-2]==(u8)crc&&out[len-1]==crc>>8,"ʽ  telem.h Բ");
+	CHECK(Telem_Decode(out,len,&f)==0,"İ ⲻ");
+	CHECK(f.n==2&&f.time[0]==1000&&f.time[1]==1010&&f.val[1][0]==103&&f.val[1][1]==-7&&f.val[1][2]==0,"İ ");
+	CHECK(Telem_Enc_Flush(&e,out)==0,"յı ܷ");
+	CHECK(e.seq==1," ûм 1");
+}
+
+//ڵ㣺7 ͨ ÿ 3 
+static void Test_Node(void)
+{
+	Telem_Enc e;
+	s16 v[TELEM_CH_MAX]={200,150,80,30,312,2534,4810,0,0,0};
+	u8 out[TELEM_FRAME_MAX],i,k;
+	Telem_Enc_Init(&e,TELEM_MAP_NODE,3);
+	for(i=0;i<3;i++)
+	{
+		CHECK(Telem_Enc_Add(&e,5000+i*1000,v)==0,"ڵ  %u  װȥ",i);
+		for(k=0;k<7;k++)v[k]+=(k&1)?-3:5;
+	}
+	CHECK(Telem_Enc_Full(&e),"ڵ 3  û");
+	CHECK(Telem_Enc_Add(&e,8000,v)==1," װ");
+	CHECK(Telem_Enc_Flush(&e,out)==TELEM_FRAME_MAX,"ڵ 3  Ӧ 32 ֽ");
+}
+
+// ٽ
+static void Test_Random(u32 times)
+{
+	Telem_Enc e;
+	Telem_Frame f;
+	s16 v[TELEM_CH_MAX],want[TELEM_SAMPLE_MAX][TELEM_CH_MAX];
+	u32 ms,when[TELEM_SAMPLE_MAX];
+	u8 out[TELEM_FRAME_MAX+8],len,n,i,s,r;
+	u16 map;
+	s32 err;
+	u32 t;
+	for(t=0;t<times&&!Fail;t++)
+	{
+		map=Rand()&((1<<TELEM_CH_MAX)-1);
+		if(map==0)map=1;
+		Telem_Enc_Init(&e,map,1+Rand()%TELEM_SAMPLE_MAX);
+		for(i=0;i<TELEM_CH_MAX;i++)v[i]=Rand();
+		ms=Rand();
+		n=0;
+		while(Telem_Enc_Add(&e,ms,v)==0)
+		{
+			for(i=0;i<TELEM_CH_MAX;i++)want[n][i]=(map&(1<<i))?v[i]:0;
+			when[n++]=ms;
+			if(Telem_Enc_Full(&e))break;
+			for(i=0;i<TELEM_CH_MAX;i++)v[i]+=Rand()%3?(s16)(Rand()%16)-8:(s16)(Rand()%256)-128;
+			ms+=Rand()%1300;
+		}
+		if(n==0)										//10 ͨ һͷŲ
+		{
+			CHECK(TELEM_HEAD+2*e.ch+2>TELEM_FRAME_MAX," %u  һ װȥ",t);
+			continue;
+		}
+		len=Telem_Enc_Flush(&e,out);
+		CHECK(len<=TELEM_FRAME_MAX," %u   %u",t,len);
+		r=Telem_Decode(out,len,&f);
+		CHECK(r==0&&f.n==n&&f.map==map," %u   %u  %u/%u",t,r,f.n,n);
+		if(Fail)break;
+		for(s=0;s<n;s++)
+		{
+			CHECK(memcmp(f.val[s],want[s],sizeof(want[s]))==0," %u   %u  ֵ",t,s);
+			err=(s16)(f.time[s]-(u16)when[s]);
+			CHECK(err>=-TELEM_DT_UNIT/2&&err<=TELEM_DT_UNIT/2," %u   %u  ʱ %d",t,s,err);
+		}
+		//
+		i=Rand()%len;
+		s=out[i];
+		out[i]^=1<<(Rand()%8);
+		r=Telem_Decode(out,len,&f);
+		CHECK(r==1||r==2," %u  һλ ܽ (%u)",t,r);
+		out[i]=s;
+		CHECK(Telem_Decode(out,len-1,&f)!=0," %u  ضϵİ ܽ",t);
+		CHECK(Telem_Decode(out,TELEM_FRAME_MAX+1,&f)==1," %u  İ ܽ",t);
+	}
+}
+
+int main(int argc,char *argv[])
+{
+	Test_Format();
+	Test_Node();
+	Test_Random(argc>1?strtoul(argv[1],0,0):100000);
+	return Test_Done();
+}
@@ -0,0 +1,30 @@
+#ifndef __TEST_COMMON_H
+#define __TEST_COMMON_H
+/* ܵ ط/  ò ( TOOLS/xxx_test ļƬ)
+	CHECK(,ʽ,...)	 ӡһ ʧܣ
+	Rand()					ƽ̨޹ص LCG αظ 24 λRand_Seed ֱӸֵ 
+	Test_Done()				main βӡ ͨ/ʧܣ 0/1 ( main ķֵ)
+
+	ʱ  -I ָ COMMON/TOOLS /TOOLS/xxx_test £-I ../../../COMMON/TOOLS
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+static int Fail=0;
+#define CHECK(c,...)	do{ if(!(c)){ printf(__VA_ARGS__); printf("\n"); Fail=1; } }while(0)
+
+static uint32_t Rand_Seed=1;
+static inline uint32_t Rand(void)
+{
+	Rand_Seed=Rand_Seed*1103515245u+12345u;
+	return Rand_Seed>>8;
+}
+
+static inline int Test_Done(void)
+{
+	printf(Fail?"ʧ\n":"ͨ\n");
+	return Fail;
+}
+
+#endif
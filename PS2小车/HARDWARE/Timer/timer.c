@@ -226,18 +226,7 @@ void TIM2_IRQHandler(void)   //TIM2
 	}
 }
 
-//ʱ3жϷ
-void TIM3_IRQHandler(void)   //TIM3ж
-{
-	if (TIM_GetITStatus(TIM3, TIM_IT_Update) != RESET)  //TIM3жϷ
-	{
-		TIM_ClearITPendingBit(TIM3, TIM_IT_Update  );  //TIMxжϱ־ 
-
-            //////////***//////////////
-//         printf(" //ʱ 3 жϷ\r\n");  
-            //////////***//////////////
-	}
-}
+//ʱ3жϷTIM3 ǵ PWMж drive_mix.c (DRIVE_TIM_IRQHandler)
 	
 #if 0
 //ڶ
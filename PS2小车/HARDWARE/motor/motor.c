@@ -2,6 +2,17 @@
 
 u8 flywheel=0;
 
+//ãML= CH1(PA6)MR= CH2(PA7)GO=1 BACK=0 Ϊǰ
+static const Drive_Config Motor_Drive={
+	{{&ML_GO,&ML_BACK,&TIM3->CCR1},{&MR_GO,&MR_BACK,&TIM3->CCR2}},
+	speed_max,				//pwm_max (ԭ Motor_Control )
+	0,						//pwm_min
+	0,						//deadband (speed_select Ѿȥ)
+	150,					//slew Լ 9ms һΣ0-> Լ 60ms
+	0,						//thr_curve ֱ
+	0,						//str_curve ֱ
+	0};						//brake
+
 void motor_Init(void)//ƶ˿ڳʼ
 {
 	GPIO_InitTypeDef GPIO_InitStructure;
@@ -16,8 +27,7 @@ void motor_Init(void)//
     GPIO_Init(GPIOB, &GPIO_InitStructure);  
     GPIO_ResetBits(GPIOB,GPIO_Pin_5);  // 0
 	
-	PWMA(0); //ٶȿ CH1(PA6)
-	PWMB(0); //ҵٶȿ CH2(PA7)
+	Drive_Init(&Motor_Drive);	///CCR  (Ҫ TIM3_PWM_Init ֮)ͣ
 }
 
 void PWMA(u16 speedval)/*ٶȿ CH1(PA6)*/
@@ -64,337 +74,25 @@ void TIM3_PWM_Init(u16 arr,u16 psc)  // 7200 * (speed_max=100) / 72Mhz = 10 ms
 	TIM3->CCR2=0;//ҵٶȿ CH2(PA7) //PWMB()
 }
 
-#if 1
-void Motor_Control(s16 speed, s16 swerve)//speed:ǰ/ , swerve:ת/ת 
-{
-	u8 sweval=20;
-	speed=speed*7.0/10.0;/* ٱ *///ˣ  ǰ
-
-	if( speed >= +1 )//ǰ
-	{
-		if(flywheel==PSB_L3)
-		{
-			speed=speed*10.0/7.0;/* ٱ */
-			//speed=speed*7.0/10.0;/* ٱ */
-		}
-		MR_GO = 1;
-		MR_BACK = 0;	
-		ML_GO = 1;
-		ML_BACK = 0;			
-		if( swerve >= +1 )//ת
-		{
-			PWMA(speed);/*ٶȿ CH1(PA6)*/
-			PWMB(	((100.0-swerve)<=sweval)?  sweval:(speed*(100.0-swerve)/100.0)	);
-		}
-		else if( swerve <= -1 )//ת
-			{
-				swerve=-swerve;//ȡ
-				PWMA(((100.0-swerve)<=sweval)?  sweval:(speed*(100.0-swerve)/100.0)); 				
-				PWMB(speed); 
-			}
-			else //ǰ
-			{
-				PWMA(speed);
-				PWMB(speed); 
-			}
-	}
-	else if( speed <= -1 )//
-		{
-			speed=-speed;//ȡ
-			MR_GO = 0;
-			MR_BACK = 1;	
-			ML_GO = 0;
-			ML_BACK = 1;			
-			if( swerve >= +1 )//ת
-			{
-				PWMA(speed); 
-				PWMB(((100.0-swerve)<=sweval)? sweval:(speed*(100.0-swerve)/100.0));				
-			}
-			else if( swerve <= -1 )//ת
-				{		
-					swerve=-swerve;//ȡ
-					PWMA(((100.0-swerve)<=sweval)?  sweval:(speed*(100.0-swerve)/100.0)); 				
-					PWMB(speed); 
-				}
-				else //
-				{
-					PWMA(speed);
-					PWMB(speed); 
-				}
-		}
-		else //ԭشת--ȲǰҲ
-		{
-			if( swerve >= +1 )//ԭת
-			{
-				MR_GO = 0;
-				MR_BACK = 1;	
-				ML_GO = 1;
-				ML_BACK = 0;	
-				if(flywheel==PSB_R3) 
-				{
-					PWMA(swerve);
-					PWMB(swerve); 
-				}
-				else 
-				{
-					PWMA(swerve*70.0/100.0);
-					PWMB(swerve*70.0/100.0); 
-				}
-			}		
-			else if( swerve <= -1 )//ԭת
-				{
-					swerve=-swerve;//ȡ
-					MR_GO = 1;
-					MR_BACK = 0;	
-					ML_GO = 0;
-					ML_BACK = 1;			
-					if(flywheel==PSB_R3) 
-					{
-						PWMA(swerve);
-						PWMB(swerve); 
-					}
-					else 
-					{
-						PWMA(swerve*70.0/100.0);
-						PWMB(swerve*70.0/100.0); 
-					}
-				}
-				else //speed=0,swerve=0
-				{
-					stop();
-				}
-		}	
-}
-#else
-void Motor_Control(s16 speed, s16 swerve)//speed:ǰ/ , swerve:ת/ת 
+//speed:ǰ/ , swerve:ת/ת speed_max (speed_select Ѿȥ)
+//ԭ L3/R3  ٱȣ ص棻ת䲻ٷ֧ (100-swerve)% =ٶ+ת =ٶ-ת
+void Motor_Control(s16 speed, s16 swerve)
 {
-//	printf("ֱ\r\n");
-	if( speed >= +1 )//ǰ
-	{
-		if( swerve >= +1 )//ת
-		{
-			if(speed_max<=speed*(100.0-swerve)/100.0)			
-			{
-				MR_GO = 1;
-				MR_BACK = 0;	
-			}
-			else
-			{
-				MR_GO = 0;
-				MR_BACK = 0;	
-			}
-			if(speed_max<=speed)		
-			{
-				ML_GO = 1;
-				ML_BACK = 0;			
-			}
-			else
-			{
-				ML_GO = 0;
-				ML_BACK = 0;			
-			}
-		}
-		else if( swerve <= -1 )//ת
-			{
-				swerve=-swerve;//ȡ
-				if(speed_max<=speed)				
-				{
-					MR_GO = 1;
-					MR_BACK = 0;	
-				}
-				else
-				{
-					MR_GO = 0;
-					MR_BACK = 0;	
-				}
-				if(speed_max<=speed*(100.0-swerve)/100.0)	
-				{
-					ML_GO = 1;
-					ML_BACK = 0;			
-				}
-				else
-				{
-					ML_GO = 0;
-					ML_BACK = 0;			
-				}
-			}
-			else //ǰ
-			{
-				MR_GO = 1;
-				MR_BACK = 0;	
-				ML_GO = 1;
-				ML_BACK = 0;			
-			}
-		}
-		else if( speed <= -1 )//
-		{
-			speed=-speed;//ȡ
-			if( swerve >= +1 )//ת
-			{
-				if(speed_max<=speed*(100.0-swerve)/100.0)			
-				{
-					MR_GO = 0;
-					MR_BACK = 1;	
-				}
-				else
-				{
-					MR_GO = 0;
-					MR_BACK = 0;	
-				}
-				if(speed_max<=speed )			
-				{
-					ML_GO = 0;
-					ML_BACK = 1;			
-				}
-				else
-				{
-					ML_GO = 0;
-					ML_BACK = 0;			
-				}
-			}
-			else if( swerve <= -1 )//ת
-				{		
-					swerve=-swerve;//ȡ
-					if(speed_max<=speed)			
-					{
-						MR_GO = 0;
-						MR_BACK = 1;	
-					}
-					else
-					{
-						MR_GO = 0;
-						MR_BACK = 0;	
-					}
-					if(speed_max<=speed*(100.0-swerve)/100.0 )			
-					{
-						ML_GO = 0;
-						ML_BACK = 1;			
-					}
-					else
-					{
-						ML_GO = 0;
-						ML_BACK = 0;			
-					}
-				}
-				else //
-				{
-					MR_GO = 0;
-					MR_BACK = 1;	
-					ML_GO = 0;
-					ML_BACK = 1;			
-				}
-		}
-		else //ԭشת--ȲǰҲ
-		{
-			if( swerve >= +1 )//ԭת
-			{
-				if(flywheel==PSB_R3) 
-				{
-					if(speed_max<= swerve)			
-					{
-						MR_GO = 0;
-						MR_BACK = 1;	
-						ML_GO = 1;
-						ML_BACK = 0;			
-					}
-					else 		
-					{
-						MR_GO = 0;
-						MR_BACK = 0;	
-						ML_GO = 0;
-						ML_BACK = 0;			
-					}
-				}
-				else 
-				{
-					if(speed_max<= swerve*6.0/8.0)			
-					{
-						MR_GO = 0;
-						MR_BACK = 1;	
-						ML_GO = 1;
-						ML_BACK = 0;			
-					}
-					else 		
-					{
-						MR_GO = 0;
-						MR_BACK = 0;	
-						ML_GO = 0;
-						ML_BACK = 0;			
-					}
-				}
-			}
-			else if( swerve <= -1 )//ԭת
-				{
-					swerve=-swerve;//ȡ
-					if(flywheel==PSB_R3) 
-					{
-						if(speed_max<= swerve)			
-						{
-							MR_GO = 1;
-							MR_BACK = 0;	
-							ML_GO = 0;
-							ML_BACK = 1;			
-						}
-						else 		
-						{
-							MR_GO = 0;
-							MR_BACK = 0;	
-							ML_GO = 0;
-							ML_BACK = 0;			
-						}
-					}
-					else 
-					{
-						if(speed_max<= swerve*6.0/8.0)			
-						{
-							MR_GO = 1;
-							MR_BACK = 0;	
-							ML_GO = 0;
-							ML_BACK = 1;			
-						}
-						else 		
-						{
-							MR_GO = 0;
-							MR_BACK = 0;	
-							ML_GO = 0;
-							ML_BACK = 0;			
-						}
-					}
-				}
-				else //speed=0,swerve=0
-				{
-					stop();
-				}
-		}	
+	Drive_Gain(flywheel==PSB_L3?100:70,flywheel==PSB_R3?100:70);	/* ٱ */
+	Drive_Arcade((s32)speed*DRIVE_FULL/speed_max,(s32)swerve*DRIVE_FULL/speed_max);
 }
-#endif 
 
 void stop(void)//ɲ
 {
-	MR_GO = 0;
-	MR_BACK = 0;
-	ML_GO = 0;
-	ML_BACK = 0;
-	PWMA(0);
-	PWMB(0);
+	Drive_Stop(0);
 }
 
-void stop_Measure(void)//ɲ
+void stop_Measure(void)//ɲ (ٺˣб)
 {
-	MR_GO = 0;
-	MR_BACK = 1;
-	ML_GO = 0;
-	ML_BACK = 1;
-	PWMA(speed_max);
-	PWMB(speed_max);
+	Drive_Tank(-DRIVE_FULL,-DRIVE_FULL);
 }
-void stop_Measure_B(void)//ɲ
+void stop_Measure_B(void)//ɲ (ǰб)
 {
-	MR_GO = 1;
-	MR_BACK = 0;
-	ML_GO = 1;
-	ML_BACK = 0;
-	PWMA(speed_max);
-	PWMB(speed_max);
+	Drive_Tank(DRIVE_FULL,DRIVE_FULL);
 }
 
@@ -9,6 +9,8 @@
 
 #include "ultrasonic.h"
 
+#include "drive_mix.h"
+
 #define MR_GO PBout(5)//ҵ 
 #define MR_BACK PBout(4)
 
@@ -249,77 +249,124 @@ void TIM3_IRQHandler(void)   //TIM3
 #endif
 
 
-#if 1
-
-/* ʱ2 ͨ2 (PA1)  PPM  */
-//TIM2_Capture_PPM_Init(0XFFFF,72-1);	//1MhzƵʼ 
-void TIM2_Capture_PPM_Init() //  ң PPM ͨ
+/* ʱ2 ͨ2 (PA1)  PPM 
+	TIM2 1MHz ɼCH2 ֻأÿ DMA1 ͨ7  CCR2 λ ppm_dma_buf
+	жﲻأ/ (DMA 봫/ж) һδʱ
+		֮ = һͨ (͵ƽ) PPM_SYNC_MIN ͬͷ
+		ͬͷ֮ͨҪ PPM_CH_MIN~PPM_CH_MAXÿ PPM_PULSE_MIN~PPM_PULSE_MAX֡
+	֡Ž˫ ppm_frame[]PPM_Get ȡµһ֡ + ֡ + ʧر־
+	жϴֻСйأͨ޹أصʱӲ棬жӳӰ졣
+	TIM2 ж (65.5ms һ)  32 λʱƸλңûʱ ֡
+	˳  Ҳû  65.5msܻ 32 λʱ䣬
+	ңͣ˺ܾٿ֮ ᰴ 16 λ һͨ */
+
+static u16 ppm_dma_buf[PPM_DMA_LEN];		//ʱ λ
+static volatile u16 ppm_ovf=0;				//TIM2  (32λʱĸ16λ)
+static u16 ppm_rd=0;						//һҪʱ
+
+static PPM_Frame ppm_frame[2];				//˫壺д [ppm_idx^1]д귭 ppm_idx
+static volatile u8 ppm_idx=0;
+static volatile u8 ppm_new=0;				//ûȡ֡
+
+static u32 ppm_last=0;						//һ (32λ us)
+static u8  ppm_first=1;						//ûһ
+static u16 ppm_ch[PPM_CH_MAX];				//յһ֡
+static u8  ppm_n=0;							//ͨ
+static u8  ppm_ok=0;						//0:ûͬͷ  ֡лͨ
+static u8  ppm_ch_num=0;					//һ֡ͨǰ
+static u8  ppm_done=0;						//֡Ѿǰ
+
+volatile u32 ppm_frames=0;					//֡
+volatile u32 ppm_bad=0;						//֡ (ͨ/)
+
+//32λ us ʱ (TIM2 <<16 | CNT)
+//ѭ (PPM_Get)  жﶼUIF ҲŽ ضѭ
+// UIF ֮ жϲ ( UIF ppm_ovf) ض  65ms
+static u32 PPM_Now(void)
 {
-	EXTI_InitTypeDef EXTI_InitStructure;
-	TIM_ICInitTypeDef  TIM_ICInitStructure;
-	
-    TIM_TimeBaseInitTypeDef  TIM_TimeBaseStructure;	//ʱTIM2ʼ   
-	NVIC_InitTypeDef NVIC_InitStructure; 	//жȼNVIC
-	GPIO_InitTypeDef GPIO_InitStructure;
-    
-	RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM2, ENABLE);	//ʹTIM2ʱ
- 	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA|RCC_APB2Periph_AFIO, ENABLE);  //ʹGPIOAʱ
-
-	//gpioʼ
-	GPIO_InitStructure.GPIO_Pin  = GPIO_Pin_1;    
-	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IN_FLOATING; //   
-	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
-	GPIO_Init(GPIOA, &GPIO_InitStructure);
-
-	//жϷʼ
-	NVIC_InitStructure.NVIC_IRQChannel = TIM2_IRQn;  //ж
-	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0;  //ռȼ2
-	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;  //ȼ0
-	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE; //IRQͨʹ
-	NVIC_Init(&NVIC_InitStructure);  //NVIC_InitStructָĲʼNVICĴ 
+	u16 hi,cnt,uif;
+	do{
+		hi=ppm_ovf;
+		cnt=TIM2->CNT;
+		uif=TIM2->SR&TIM_SR_UIF;
+	}while(hi!=ppm_ovf);
+	if(uif&&cnt<0x8000)hi++;	// жϻû (ͬж  жϻûü)
+	return ((u32)hi<<16)|cnt;
+}
 
-    TIM_DeInit(TIM2);//λʱ2мĴ
-	
-	//ʼʱ2 TIM2	 
-	TIM_TimeBaseStructInit(&TIM_TimeBaseStructure);
-	TIM_TimeBaseStructure.TIM_Period = 0xFFFF; //趨Զװֵ 
-	TIM_TimeBaseStructure.TIM_Prescaler =72; 	//ԤƵ   
-	TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1; //ʱӷָ:TDTS = Tck_tim
-	TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;  //TIMϼģʽ
-	TIM_TimeBaseStructure.TIM_RepetitionCounter = 0;
-	TIM_TimeBaseInit(TIM2, &TIM_TimeBaseStructure); //TIM_TimeBaseInitStructָĲʼTIMxʱλ
-  
-	//벶ʼ
-	TIM_ICStructInit(&TIM_ICInitStructure);
-	TIM_ICInitStructure.TIM_Channel = TIM_Channel_2; //CC1S=01 	ѡ IC1ӳ䵽TI1
-  	TIM_ICInitStructure.TIM_ICPolarity = TIM_ICPolarity_Rising;	//ز
-//TIM_ICInitStructure.TIM_ICPolarity = TIM_ICPolarity_Falling; //ȼ͵ƽͬͷ½ش
-  	//½ش
-	TIM_ICInitStructure.TIM_ICSelection = TIM_ICSelection_DirectTI; //ӳ䵽TI1
-  	TIM_ICInitStructure.TIM_ICPrescaler = TIM_ICPSC_DIV1;	 //Ƶ,Ƶ 
-  	TIM_ICInitStructure.TIM_ICFilter = 0x05;//IC1F=0000 ˲ ˲
-  	TIM_ICInit(TIM2, &TIM_ICInitStructure);
+//һ֡ edge:һ (32λ us)
+static void PPM_Publish(u32 edge)
+{
+	PPM_Frame *f=&ppm_frame[ppm_idx^1];
+	u8 i;
+	for(i=0;i<ppm_n;i++)f->ch[i]=ppm_ch[i];
+	for(;i<PPM_CH_MAX;i++)f->ch[i]=0;
+	f->num=ppm_n;
+	f->time=edge;
+	ppm_idx^=1;
+	ppm_new=1;
+	ppm_ch_num=ppm_n;
+	ppm_frames++;
+}
 
-	//ʼ	
-	TIM_Cmd(TIM2, ENABLE);	// ʱ    
-	TIM_ClearFlag(TIM2, TIM_FLAG_Update);	// жϱ־ 
-	TIM_ITConfig(TIM2,TIM_IT_Update|TIM_IT_CC1,ENABLE);//ж ,CC1IEж	
+// DMA Ѿ û (DMA /ȫ  TIM2  жͬһ)
+static void PPM_Decode(void)
+{
+	u16 wr=PPM_DMA_LEN-DMA1_Channel7->CNDTR;	//DMA һдλ (ȶ ٶʱ䣬ض now ֮ǰ)
+	u32 now=PPM_Now(),t,d;
+	while(ppm_rd!=wr)
+	{
+		t=now-(u16)((u16)now-ppm_dma_buf[ppm_rd]);	// 65.5ms   32 λʱ
+		if(++ppm_rd==PPM_DMA_LEN)ppm_rd=0;
+		d=t-ppm_last;
+		ppm_last=t;
+		if(ppm_first){ppm_first=0;continue;}
+		if(d>=PPM_SYNC_MIN)					//ͬͷһ֡
+		{
+			if(!ppm_done)
+			{
+				if(ppm_ok&&ppm_n>=PPM_CH_MIN)PPM_Publish(t-d);	//֡һ ͬͷǰǸ
+				else if(ppm_ok)ppm_bad++;			//ͨ
+			}
+			ppm_n=0;
+			ppm_ok=1;
+			ppm_done=0;
+			continue;
+		}
+		if(!ppm_ok)continue;				//ûͬ һͬͷ
+		if(ppm_done)						// أͨˣһ֡ ͬͷ 
+		{
+			ppm_ch_num=0;
+			continue;
+		}
+		if(d<PPM_PULSE_MIN||d>PPM_PULSE_MAX||ppm_n>=PPM_CH_MAX)
+		{
+			ppm_ok=0;						//֡һͬͷ
+			ppm_n=0;
+			ppm_bad++;
+			continue;
+		}
+		ppm_ch[ppm_n++]=d;
+		if(ppm_n==ppm_ch_num)				//ͨһ֡һͬͷ ֱӷ
+		{
+			PPM_Publish(t);
+			ppm_done=1;
+		}
+	}
 }
 
-#else
-/* ʱ2 ͨ2 (PA1)  PPM  */
-//TIM2_Capture_PPM_Init(0XFFFF,72-1);	//1MhzƵʼ 
+//TIM2_Capture_PPM_Init();	//1MhzƵʼ 
 void TIM2_Capture_PPM_Init() //  ң PPM ͨ
 {
 	TIM_ICInitTypeDef  TIM_ICInitStructure;
-	
     TIM_TimeBaseInitTypeDef  TIM_TimeBaseStructure;	//ʱTIM2ʼ   
 	NVIC_InitTypeDef NVIC_InitStructure; 	//жȼNVIC
 	GPIO_InitTypeDef GPIO_InitStructure;
+	DMA_InitTypeDef DMA_InitStructure;
     
 	RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM2, ENABLE);	//ʹTIM2ʱ
  	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA|RCC_APB2Periph_AFIO, ENABLE);  //ʹGPIOAʱ
-
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);	//ʹDMA1ʱ
 
 	//gpioʼ
 	GPIO_InitStructure.GPIO_Pin  = GPIO_Pin_1;    
@@ -327,19 +374,38 @@ void TIM2_Capture_PPM_Init() // 
 	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
 	GPIO_Init(GPIOA, &GPIO_InitStructure);
 
-	//жϷʼ
+	//DMA1 ͨ7 = TIM2_CH2CCR2 -> ppm_dma_buf ѭ
+	DMA_DeInit(DMA1_Channel7);
+	DMA_InitStructure.DMA_PeripheralBaseAddr = (u32)&TIM2->CCR2;
+	DMA_InitStructure.DMA_MemoryBaseAddr = (u32)ppm_dma_buf;
+	DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;
+	DMA_InitStructure.DMA_BufferSize = PPM_DMA_LEN;
+	DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+	DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+	DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+	DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+	DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+	DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+	DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+	DMA_Init(DMA1_Channel7, &DMA_InitStructure);
+	DMA_ITConfig(DMA1_Channel7, DMA_IT_HT|DMA_IT_TC, ENABLE);	///
+	DMA_Cmd(DMA1_Channel7, ENABLE);
+
+	//жϷʼDMA   ͬһPPM_Now Ŷ
+	NVIC_InitStructure.NVIC_IRQChannel = DMA1_Channel7_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
 	NVIC_InitStructure.NVIC_IRQChannel = TIM2_IRQn;  //ж
-	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0;  //ռȼ2
-	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;  //ȼ0
-	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE; //IRQͨʹ
 	NVIC_Init(&NVIC_InitStructure);  //NVIC_InitStructָĲʼNVICĴ 
 
     TIM_DeInit(TIM2);//λʱ2мĴ
 	
 	//ʼʱ2 TIM2	 
 	TIM_TimeBaseStructInit(&TIM_TimeBaseStructure);
-	TIM_TimeBaseStructure.TIM_Period = 0xFFFF; //趨Զװֵ 
-	TIM_TimeBaseStructure.TIM_Prescaler =72; 	//ԤƵ   
+	TIM_TimeBaseStructure.TIM_Period = 0xFFFF; //趨Զװֵֵ16λ
+	TIM_TimeBaseStructure.TIM_Prescaler =72-1; 	//ԤƵ 72M/72=1MHz  
 	TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1; //ʱӷָ:TDTS = Tck_tim
 	TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;  //TIMϼģʽ
 	TIM_TimeBaseStructure.TIM_RepetitionCounter = 0;
@@ -347,83 +413,54 @@ void TIM2_Capture_PPM_Init() // 
   
 	//벶ʼ
 	TIM_ICStructInit(&TIM_ICInitStructure);
-	TIM_ICInitStructure.TIM_Channel = TIM_Channel_2; //CC1S=01 	ѡ IC1ӳ䵽TI1
-  	TIM_ICInitStructure.TIM_ICPolarity = TIM_ICPolarity_Rising;	//ز
-//TIM_ICInitStructure.TIM_ICPolarity = TIM_ICPolarity_Falling; //ȼ͵ƽͬͷ½ش
-  	//½ش
-	TIM_ICInitStructure.TIM_ICSelection = TIM_ICSelection_DirectTI; //ӳ䵽TI1
+	TIM_ICInitStructure.TIM_Channel = TIM_Channel_2; //CC2S=01 	ѡ IC2ӳ䵽TI2
+  	TIM_ICInitStructure.TIM_ICPolarity = TIM_ICPolarity_Rising;	//ֻҪأԲ
+	TIM_ICInitStructure.TIM_ICSelection = TIM_ICSelection_DirectTI; //ӳ䵽TI2
   	TIM_ICInitStructure.TIM_ICPrescaler = TIM_ICPSC_DIV1;	 //Ƶ,Ƶ 
-  	TIM_ICInitStructure.TIM_ICFilter = 0x05;//IC1F=0000 ˲ ˲
+  	TIM_ICInitStructure.TIM_ICFilter = 0x05;//IC2F=0101 ˲
   	TIM_ICInit(TIM2, &TIM_ICInitStructure);
 
 	//ʼ	
-	TIM_Cmd(TIM2, ENABLE);	// ʱ    
+	TIM_DMACmd(TIM2, TIM_DMA_CC2, ENABLE);	//һ һ DMA
 	TIM_ClearFlag(TIM2, TIM_FLAG_Update);	// жϱ־ 
-	TIM_ITConfig(TIM2,TIM_IT_Update|TIM_IT_CC1,ENABLE);//ж ,CC1IEж	
+	TIM_ITConfig(TIM2,TIM_IT_Update,ENABLE);//ֻж (ʱλ)񲻽ж
+	TIM_Cmd(TIM2, ENABLE);	// ʱ    
 }
-#endif
-
 
-/**/
-u32 temp=0;
-u8  TIM2_CH2_capture_state=0,ppm_rx_sta=0,ppm_rx_num=0;	//벶״̬		    				
-u16	TIM2_CH2_capture_value;	//벶ֵ
-u16 ppm_rx[10];//ppm_rx[0]   1   յppm
-
-//ʱ2жϷ
+//ʱ2жϷֻ
 void TIM2_IRQHandler(void)   //TIM2ж
 {
- 	if( (TIM2_CH2_capture_state&0X80)==0)//δɹ	
-	{	  
-		if (TIM_GetITStatus(TIM2, TIM_IT_Update) != RESET)		 
-		{	    
-			if(TIM2_CH2_capture_state&0X40)//Ѿ񵽸ߵƽ
-			{
-				if((TIM2_CH2_capture_state&0X3F)==0X3F)//ߵƽ̫
-				{
-					TIM2_CH2_capture_state|=0X80;//ǳɹһ
-					TIM2_CH2_capture_value=0XFFFF;
-				}
-				else TIM2_CH2_capture_state++;
-			}	 
-		}
-		if (TIM_GetITStatus(TIM2, TIM_IT_CC1) != RESET)//1¼
-		{	
-			if(TIM2_CH2_capture_state&0X40)		//һ½ 		
-			{	  			
-				TIM2_CH2_capture_state|=0X80;		//ǳɹһθߵƽ
-				TIM2_CH2_capture_value=TIM_GetCapture1(TIM2);
-				TIM_OC1PolarityConfig(TIM2,TIM_ICPolarity_Rising); //CC1P=0 Ϊز
-			}
-			else  								//δʼ,һβ
-			{
-				TIM2_CH2_capture_state=0;			//
-				TIM2_CH2_capture_value=0;
-				TIM_SetCounter(TIM2,0);
-				TIM2_CH2_capture_state|=0X40;		//ǲ
-				TIM_OC1PolarityConfig(TIM2,TIM_ICPolarity_Falling);		//CC1P=1 Ϊ½ز
-			}		    
-		}			     	    					   
- 	}
-	
-	/* ֡ */
-	if( (TIM2_CH2_capture_state&0X80)==1)//ɹһ
+	if(TIM2->SR&TIM_SR_UIF)
 	{
-//			temp=TIM2_CH2_capture_state&0X3F;
-//			temp*=65536;//ʱܺ
-//			temp+=TIM2_CH2_capture_value;//õܵĸߵƽʱ	
-		if(ppm_rx_sta==1) {ppm_rx[ppm_rx_num+1]=TIM2_CH2_capture_value;ppm_rx_num++;}//printf("TIM2_CH2_capture_value:%d\r\n",TIM2_CH2_capture_value);
-		if(4>TIM2_CH2_capture_state&0X3F>0||TIM2_CH2_capture_value>3000) ppm_rx_sta++;//͵ƽʱ3000usΪʼ֡
-		if(ppm_rx_sta==2) {ppm_rx_sta=0;ppm_rx[0]=1;ppm_rx_num=0;}//printf("receive\r\n");//ppm_rx_sta   1 ʾյͬ֡/ 2յһʼ֡ ppmݽ
-		
-		TIM2_CH2_capture_state=0;//һβ
-		
+		TIM2->SR=(u16)~TIM_SR_UIF;
+		ppm_ovf++;
+		PPM_Decode();						// Ҳ
 	}
-	
-	TIM_ClearITPendingBit(TIM2, TIM_IT_CC1|TIM_IT_Update); //жϱ־λ
 }
 
+// / 
+void DMA1_Channel7_IRQHandler(void)
+{
+	DMA1->IFCR=DMA1_IT_HT7|DMA1_IT_TC7;
+	PPM_Decode();
+}
 
+//ȡһ֡
+//ֵ:1,ϴȡԺ֡;0,û (frame ﻹһ֡֡/ʧ)
+u8 PPM_Get(PPM_Frame *frame)
+{
+	u8 fresh;
+	u32 age;
+	do{
+		fresh=ppm_new;
+		ppm_new=0;
+		*frame=ppm_frame[ppm_idx];
+	}while(ppm_new);						//ȡʱһ֡ ȡһ
+	age=ppm_frames?(PPM_Now()-frame->time)/1000:0xFFFF;
+	frame->age_ms=age>0xFFFF?0xFFFF:age;
+	frame->failsafe=frame->age_ms>PPM_FAILSAFE_MS;
+	return fresh;
+}
 
 //----------------------------------------------------------------
 //  ڶ
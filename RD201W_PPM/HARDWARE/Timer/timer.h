@@ -18,11 +18,28 @@ void TIM2_Int_Init(u16 arr,u16 psc);
 void TIM3_Int_Init(u16 arr,u16 psc);
 #endif
 
-/* ʱ2 ͨ2 (PA1)  PPM  */
-extern u16 ppm_rx[];
-//TIM2_Capture_PPM_Init(0XFFFF,72-1);	//1MhzƵʼ 
-//void TIM2_Capture_PPM_Init(u16 arr,u16 psc); //  ң PPM ͨ
-void TIM2_Capture_PPM_Init(); //  ң PPM ͨ
+/* ʱ2 ͨ2 (PA1)  PPM  (ʱ DMA λ壬/ȫʱ֡) */
+#define PPM_DMA_LEN		24		//ʱ (ż)һж
+#define PPM_CH_MIN		4		//һ֡ͨ
+#define PPM_CH_MAX		10		//һ֡ͨ
+#define PPM_SYNC_MIN	3000	//us ֮ͬͷ
+#define PPM_PULSE_MIN	700		//us ͨȷΧ (͵ƽ)
+#define PPM_PULSE_MAX	2300
+#define PPM_FAILSAFE_MS	100		//ms ôûк֡ ʧ
+
+typedef struct{
+	u16 ch[PPM_CH_MAX];		//ͨ us (1000~2000)ch[0] ͨ1
+	u8  num;				//һ֡ͨ
+	u8  failsafe;			//1:ʧ (̫ûк֡ / ûյ)
+	u16 age_ms;				//֡ ms
+	u32 time;				//һصʱ (32λ us)
+}PPM_Frame;
+
+extern volatile u32 ppm_frames;	//֡
+extern volatile u32 ppm_bad;	//֡
+
+void TIM2_Capture_PPM_Init(void); //  ң PPM ͨ
+u8 PPM_Get(PPM_Frame *frame);	//ȡһ֡ 1:֡
 
 void TIM4_Int_Init(void);
 void TIM4_PWM_SG90_MG90_Init(void); 
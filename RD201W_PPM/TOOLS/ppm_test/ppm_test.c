@@ -0,0 +1,233 @@
+/* PPM   (УƬ)
+	ֱӱ HARDWARE/Timer/timer.cTIM2/DMA1 ڴļ裬 us ʱ䣺
+		ÿ DMA  16 λֵ д ppm_dma_buf/ȫ  DMA жϣ  жϣ
+		ж ͬһ ӳһ Ⱥ (ж ʱ PPM_Now ҪԼ)
+		ң  4~10 ͨͨ (̫/̫)ͣһ ( 16 λƺ һͨ)
+			ÿһ֡ ͨ//һصʱ ȥһ֡ һ٣֡ һppm_bad ԣ
+			ͨ һ֡ ֻǰ漸ͨ (ǰ)֮ճ
+			PPM_Get֡ ֻһΣ֡ ԣͣ˳ PPM_FAILSAFE_MS ʧأ32 λ us  (71 ) Ҳԡ
+
+	룺gcc -O2 -Wno-pointer-to-int-cast -I ../../../COMMON/TOOLS -I stub -I ../../HARDWARE/Timer -o ppm_test ppm_test.c
+	÷ppm_test [֡]   Ĭ 300000 (ģԼ 1.6 Сʱ)ȫͨ 0򷵻 1 ӡ 
+*/
+#include "test_common.h"
+#include <string.h>
+#include "timer.c"
+
+TIM_TypeDef Test_TIM2,Test_TIM4;
+DMA_TypeDef Test_DMA1;
+DMA_Channel_TypeDef Test_DMA1_Channel7={PPM_DMA_LEN};
+
+typedef unsigned long long u64;
+
+static u64 Now=1000;						//us
+static u64 Next_Wrap=65536;
+static u8  Tim_Pend=0,Dma_Pend=0;
+static u64 Tim_Due,Dma_Due;
+static u16 Dma_Pos=0;
+
+//ȥĺ֡ (˳)
+#define REC_N			64
+typedef struct{
+	u32 time;
+	u8  num;
+	u16 ch[PPM_CH_MAX];
+	u8  trunc;								//ͨĵһֻ֡ǰ trunc  ( trunc_time )
+	u32 trunc_time;
+	u8  sent;
+}Rec;
+static Rec Recs[REC_N];
+static u32 Rec_Head=0,Rec_Pub=0;				//һд / һ÷
+static u32 Good=0,Glitch=0,Published=0;
+static u32 Last_Frames=0;
+static u32 Last_Time;						//󷢲֡ ʱ
+static u8  Any_Pub=0;
+
+static void Set_Cnt(void)
+{
+	Test_TIM2.CNT=(u16)Now;
+}
+
+//·֡ȥĶ
+static void Check_Frame(Rec *r,PPM_Frame *f)
+{
+	u32 i,num=r->num;
+	if(r->trunc&&f->time==r->trunc_time)num=r->trunc;
+	else CHECK(f->time==r->time,"֡ ʱ %u ӦΪ %u",f->time,r->time);
+	CHECK(f->num==num,"ʱ %u ͨ %u ӦΪ %u",f->time,f->num,num);
+	for(i=0;i<num;i++)
+		CHECK(f->ch[i]==r->ch[i],"ʱ %u ͨ %u  %u ӦΪ %u",f->time,i+1,f->ch[i],r->ch[i]);
+	for(;i<PPM_CH_MAX;i++)
+		CHECK(!f->ch[i],"ʱ %u ͨ %u ӦΪ 0",f->time,i+1);
+}
+
+//·֡˳ ȥĺ֡ 
+//һж ܷ 3 ֡ (4 ͨ)˫ ֻõ ֡ǰ ֻ
+static void Check_Publish(void)
+{
+	Rec *r;
+	u32 k,n=ppm_frames-Last_Frames;
+	if(!n)return;
+	Last_Frames=ppm_frames;
+	for(k=0;k<n;k++)
+	{
+		r=&Recs[Rec_Pub++%REC_N];
+		CHECK(Rec_Pub<=Rec_Head&&!r->sent," ûȥ֡");
+		if(Rec_Pub>Rec_Head)return;
+		r->sent=1;
+		if(k+2==n)Check_Frame(r,&ppm_frame[ppm_idx^1]);
+		if(k+1==n)Check_Frame(r,&ppm_frame[ppm_idx]);
+	}
+	Published+=n;
+	Last_Time=ppm_frame[ppm_idx].time;
+	Any_Pub=1;
+}
+
+static void Tim_Irq(void)
+{
+	Tim_Pend=0;
+	TIM2_IRQHandler();
+	Check_Publish();
+}
+
+static void Dma_Irq(void)
+{
+	Dma_Pend=0;
+	DMA1_Channel7_IRQHandler();
+	Test_DMA1.ISR&=~Test_DMA1.IFCR;
+	Check_Publish();
+}
+
+//ʱߵ tм /ж Ⱥ
+static void Run_To(u64 t)
+{
+	u64 e;
+	for(;;)
+	{
+		e=t;
+		if(Next_Wrap<=e)e=Next_Wrap;
+		if(Tim_Pend&&Tim_Due<=e)e=Tim_Due;
+		if(Dma_Pend&&Dma_Due<=e)e=Dma_Due;
+		Now=e;
+		Set_Cnt();
+		if(e==Next_Wrap)
+		{
+			Next_Wrap+=65536;
+			Test_TIM2.SR|=TIM_SR_UIF;
+			if(!Tim_Pend){ Tim_Pend=1; Tim_Due=Now+Rand()%6; }
+		}
+		else if(Tim_Pend&&e==Tim_Due&&(!Dma_Pend||Dma_Due!=e||Rand()&1))Tim_Irq();
+		else if(Dma_Pend&&e==Dma_Due)Dma_Irq();
+		else if(e==t)break;
+	}
+}
+
+//һأDMA  CCR2
+static void Edge(u64 t)
+{
+	Run_To(t);
+	ppm_dma_buf[Dma_Pos++]=(u16)t;
+	if(Dma_Pos==PPM_DMA_LEN/2)Test_DMA1.ISR|=DMA1_IT_HT7;
+	if(Dma_Pos==PPM_DMA_LEN){ Dma_Pos=0; Test_DMA1.ISR|=DMA1_IT_TC7; }
+	Test_DMA1_Channel7.CNDTR=PPM_DMA_LEN-Dma_Pos;
+	if((Test_DMA1.ISR&(DMA1_IT_HT7|DMA1_IT_TC7))&&!Dma_Pend){ Dma_Pend=1; Dma_Due=Now+Rand()%300; }
+}
+
+//ѭ ȡһ֡
+static void Main_Get(void)
+{
+	PPM_Frame f;
+	u8 fresh=PPM_Get(&f),again;
+	u32 age;
+	static u32 seen=0;
+	CHECK(fresh==(ppm_frames!=seen),"PPM_Get ֡ ־ %u ",fresh);
+	seen=ppm_frames;
+	again=PPM_Get(&f);
+	CHECK(!again,"ͬһ֡ ֡");
+	if(!Any_Pub)
+	{
+		CHECK(f.failsafe,"ûյ֡ ʧ");
+		return;
+	}
+	age=((u32)Now-Last_Time)/1000;
+	CHECK(f.time==Last_Time&&f.age_ms==(age>0xFFFF?0xFFFF:age),"PPM_Get ʱ %u ֡ %u ӦΪ %u %u",f.time,f.age_ms,Last_Time,age);
+	CHECK(f.failsafe==(f.age_ms>PPM_FAILSAFE_MS),"֡ %u ʧر־ %u",f.age_ms,f.failsafe);
+}
+
+//һ֡ (N+1 )bad:0 ֡ 1 һ̫ͨ (мһ) 2 һ̫ͨ
+//֡ ȼ ٷ (ж һ һͿܷ)
+static void Send_Frame(u8 n,u8 bad,u8 trunc,u8 first)
+{
+	static Rec tmp;
+	Rec *r=&tmp;
+	u8 i,b=Rand()%n;
+	u64 t=Now+1,e;
+	if(!bad&&!first)						//һ֡ ǰûͬͷ
+	{
+		r=&Recs[Rec_Head%REC_N];
+		CHECK(!r->num||r->sent,"ʱ %u ĺ֡ û",r->time);
+		Rec_Head++;
+		Good++;
+	}
+	memset(r,0,sizeof(*r));
+	for(e=t,i=0;i<n;i++)
+	{
+		r->ch[i]=1000+Rand()%1001;
+		if(bad==2&&i==b)r->ch[i]=PPM_PULSE_MAX+1+Rand()%(PPM_SYNC_MIN-PPM_PULSE_MAX-1);
+		e+=r->ch[i];
+		if(i+1==trunc)r->trunc_time=(u32)e;
+	}
+	r->time=(u32)e;
+	r->trunc=trunc;
+	r->num=bad?0:n;
+	if(bad)Glitch++;
+	Edge(t);
+	for(i=0;i<n;i++)
+	{
+		if(bad==1&&i==b)Edge(t+100+Rand()%500);
+		t+=r->ch[i];
+		Edge(t);
+		if(Rand()%8==0){ Run_To(t+Rand()%100); Main_Get(); }
+	}
+}
+
+//ͬͷ / ͣһ
+static void Gap(u32 us)
+{
+	u64 t=Now+us;
+	while(Now+20000<t)
+	{
+		Run_To(Now+10000+Rand()%10000);
+		Main_Get();
+	}
+	Run_To(t);
+}
+
+int main(int argc,char *argv[])
+{
+	u32 n=argc>1?strtoul(argv[1],0,0):300000;
+	u32 k;
+	u8 ch=8,last=0,bad;
+	Set_Cnt();
+	TIM2_Capture_PPM_Init();
+	Main_Get();
+	for(k=0;k<n&&!Fail;k++)
+	{
+		if(k>10&&Rand()%300==0)ch=4+Rand()%(PPM_CH_MAX-3);
+		bad=k>10&&ch<=last&&Rand()%25==0?1+Rand()%2:0;	//ͨ֡ ǰ 滵Ҳ㻵֡
+		Send_Frame(ch,bad,(last&&ch>last)?last:0,k==0);
+		if(!bad)last=ch;
+		switch(Rand()%400)
+		{
+			case 0: Gap(100000+Rand()%300000); break;		//ң
+			case 1: Gap(65536*(1+Rand()%3)+PPM_PULSE_MIN+Rand()%(PPM_PULSE_MAX-PPM_PULSE_MIN)); break;	//ƺ һͨ
+			default: Gap(PPM_SYNC_MIN+1000+Rand()%8000); break;
+		}
+	}
+	Gap(PPM_FAILSAFE_MS*1000+100000);
+	Main_Get();
+	CHECK(Published+1>=Good&&Published<=Good,"֡ %u   %u ",Good,Published);	//һ֡ ûһͬͷ
+	CHECK(ppm_bad==Glitch,"֡ %u  ppm_bad  %u",Glitch,ppm_bad);
+	CHECK(Now>0x100000000ull||n<300000,"ʱ û߹ 32 λ");
+	return Test_Done();
+}
@@ -0,0 +1,73 @@
+/* ϱãtimer.c õ F103 Ĵ ڴļ (ppm_test.c ﶨ)
+	⺯ ȫʲôҲ */
+#ifndef __STM32F10x_H
+#define __STM32F10x_H
+#include <stdint.h>
+
+typedef uint32_t u32;
+typedef uint16_t u16;
+typedef uint8_t  u8;
+
+typedef struct{volatile uint16_t CNT,SR,CCR1,CCR2,CCR3,CCR4;}TIM_TypeDef;
+typedef struct{volatile uint32_t ISR,IFCR;}DMA_TypeDef;
+typedef struct{volatile uint32_t CNDTR;}DMA_Channel_TypeDef;
+
+extern TIM_TypeDef Test_TIM2,Test_TIM4;
+extern DMA_TypeDef Test_DMA1;
+extern DMA_Channel_TypeDef Test_DMA1_Channel7;
+#define TIM2				(&Test_TIM2)
+#define TIM4				(&Test_TIM4)
+#define DMA1				(&Test_DMA1)
+#define DMA1_Channel7		(&Test_DMA1_Channel7)
+
+#define TIM_SR_UIF			0x0001
+#define DMA1_IT_HT7			0x04000000
+#define DMA1_IT_TC7			0x02000000
+
+//ʼṹ  õĳֻҪֵܸ
+typedef struct{uint16_t TIM_Channel,TIM_ICPolarity,TIM_ICSelection,TIM_ICPrescaler,TIM_ICFilter;}TIM_ICInitTypeDef;
+typedef struct{uint16_t TIM_Period,TIM_Prescaler,TIM_ClockDivision,TIM_CounterMode;uint8_t TIM_RepetitionCounter;}TIM_TimeBaseInitTypeDef;
+typedef struct{uint16_t TIM_OCMode,TIM_OutputState,TIM_OutputNState,TIM_Pulse,TIM_OCPolarity,TIM_OCNPolarity,TIM_OCIdleState,TIM_OCNIdleState;}TIM_OCInitTypeDef;
+typedef struct{uint8_t NVIC_IRQChannel,NVIC_IRQChannelPreemptionPriority,NVIC_IRQChannelSubPriority,NVIC_IRQChannelCmd;}NVIC_InitTypeDef;
+typedef struct{uint16_t GPIO_Pin;uint32_t GPIO_Speed,GPIO_Mode;}GPIO_InitTypeDef;
+typedef struct{uint32_t DMA_PeripheralBaseAddr,DMA_MemoryBaseAddr,DMA_DIR,DMA_BufferSize,DMA_PeripheralInc,DMA_MemoryInc,
+				DMA_PeripheralDataSize,DMA_MemoryDataSize,DMA_Mode,DMA_Priority,DMA_M2M;}DMA_InitTypeDef;
+enum{RCC_APB1Periph_TIM2,RCC_APB1Periph_TIM4,RCC_APB2Periph_GPIOA,RCC_APB2Periph_GPIOB,RCC_APB2Periph_AFIO,RCC_AHBPeriph_DMA1,
+	 GPIO_Pin_1,GPIO_Pin_6,GPIO_Pin_7,GPIO_Pin_8,GPIO_Pin_9,GPIO_Mode_IN_FLOATING,GPIO_Mode_AF_PP,GPIO_Speed_50MHz,
+	 DMA_DIR_PeripheralSRC,DMA_PeripheralInc_Disable,DMA_MemoryInc_Enable,DMA_PeripheralDataSize_HalfWord,DMA_MemoryDataSize_HalfWord,
+	 DMA_Mode_Circular,DMA_Priority_High,DMA_M2M_Disable,DMA_IT_HT,DMA_IT_TC,DMA1_Channel7_IRQn,TIM2_IRQn,
+	 TIM_CKD_DIV1,TIM_CounterMode_Up,TIM_Channel_2,TIM_ICPolarity_Rising,TIM_ICSelection_DirectTI,TIM_ICPSC_DIV1,TIM_DMA_CC2,
+	 TIM_FLAG_Update,TIM_IT_Update,TIM_OCMode_PWM2,TIM_OutputState_Enable,TIM_OutputNState_Enable,TIM_OCPolarity_Low,
+	 TIM_OCNPolarity_High,TIM_OCIdleState_Set,TIM_OCIdleState_Reset,TIM_OCPreload_Enable,ENABLE};
+
+#define RCC_APB1PeriphClockCmd(...)
+#define RCC_APB2PeriphClockCmd(...)
+#define RCC_AHBPeriphClockCmd(...)
+#define GPIO_Init(...)
+#define GPIOA				0
+#define GPIOB				0
+#define DMA_DeInit(...)
+#define DMA_Init(...)
+#define DMA_ITConfig(...)
+#define DMA_Cmd(...)
+#define NVIC_Init(...)
+#define TIM_DeInit(...)
+#define TIM_TimeBaseStructInit(...)
+#define TIM_TimeBaseInit(...)
+#define TIM_ICStructInit(...)
+#define TIM_ICInit(...)
+#define TIM_DMACmd(...)
+#define TIM_ClearFlag(...)
+#define TIM_ITConfig(...)
+#define TIM_Cmd(...)
+#define TIM_OC1Init(...)
+#define TIM_OC2Init(...)
+#define TIM_OC3Init(...)
+#define TIM_OC4Init(...)
+#define TIM_OC1PreloadConfig(...)
+#define TIM_OC2PreloadConfig(...)
+#define TIM_OC3PreloadConfig(...)
+#define TIM_OC4PreloadConfig(...)
+#define TIM_ARRPreloadConfig(...)
+#define TIM_CtrlPWMOutputs(...)
+#endif
@@ -0,0 +1 @@
+/* ϱãtimer.c Ķ */
@@ -14,6 +14,8 @@ int main(void)
 {
 	u16 num=500;
 	u8 flag=0;
+	u8 lost=0;		//1:Ѿ ʧ
+	PPM_Frame ppm;
 	SystemInit();//ϵͳʱ,ϵͳʱΪ72M	
 	delay_init(72);//ʱʼ  
 	JTAG_SWD_GPIO_Config();//ʹJTAGԣӦIOPB3,PB4,PA15ΪͨIOʹãʹSWD¼ͷų
@@ -64,11 +66,15 @@ int main(void)
 				printf("\r\n");
 			}
 		}
-		if(ppm_rx[0])//ɹһ
+		if(PPM_Get(&ppm))//֡
 		{
 			printf(":%d ǰ:%d :%d :%d chanel5:%d chanel6:%d\r\n",
-				ppm_rx[1],ppm_rx[2],ppm_rx[3],ppm_rx[4],ppm_rx[5],ppm_rx[6]);
-			ppm_rx[0]=0;
+				ppm.ch[0],ppm.ch[1],ppm.ch[2],ppm.ch[3],ppm.ch[4],ppm.ch[5]);
+		}
+		if(ppm.failsafe!=lost)//ʧ ʼ/ָ һ
+		{
+			lost=ppm.failsafe;
+			printf("PPM %s ֡:%lu ֡:%lu\r\n",lost?"ʧ":"ָ",(unsigned long)ppm_frames,(unsigned long)ppm_bad);
 		}
 	}
 }
@@ -1,4 +1,5 @@
 #include "serial_bus.h"
+#include <string.h>
 
 /* SBUSȫserial-busһִͨЭ飬㷺ӦںģңջС
 ֻһź߾ܴ16ͨݣȶ·PWMЧʡԴ
@@ -57,28 +58,207 @@ ch16=6 5;
 
 */
 	
-void USART1_SBUS_Init(void) // ֻ
+volatile SBUS_Stat_TypeDef sbus_stat;
+
+static volatile uint32_t sbus_ms=0;				//1ms 
+static volatile uint8_t  sbus_period=0;			//֡ 0:ͣ
+static uint32_t sbus_tx_last=0;					//һ֡ʼʱ
+static uint32_t sbus_tx_last_us=0;
+
+//滷sbus_push (ѭ) ֻд sbus_ring_wʱж ֻд sbus_ring_rһֱϼ ò
+typedef struct
+{
+	uint16_t raw[SBUS_CH_NUM];
+	uint8_t  flags;
+	uint32_t t_us;				//ƽʱ
+} SBUS_Report_TypeDef;
+static SBUS_Report_TypeDef sbus_ring[SBUS_RING_N];
+static volatile uint8_t sbus_ring_w=0;
+static volatile uint8_t sbus_ring_r=0;
+
+//ʱж ӻȡ± (ֻж)
+static SBUS_Report_TypeDef sbus_tx_rep;
+static uint8_t sbus_tx_new=0;					//sbus_tx_rep û
+static uint8_t sbus_tx_ready=0;					//յ ſʼ
+
+//ֻͣ DMA ûڷʱ ȥ
+static uint8_t sbus_tx_buf[SBUS_FRAME_SIZE];
+
+//գDMA յ sbus_rx_bufжŵ sbus_rx_frame[sbus_rx_idx]
+static uint8_t sbus_rx_buf[SBUS_RX_BUF];
+static SBUS_Frame_TypeDef sbus_rx_frame[2];
+static volatile uint8_t sbus_rx_idx=0;
+static volatile uint8_t sbus_rx_new=0;
+static volatile uint8_t sbus_rx_fs=1;			//һ֡ʧر־ (ûյʧ)
+
+//TX DMA  buf  SBUS_FRAME_SIZE ֽ
+static void sbus_tx_dma(uint8_t *buf)
+{
+#if defined(STM32F40_41xxx)
+	SBUS_TX_STREAM->CR&=~DMA_SxCR_EN;
+	while(SBUS_TX_STREAM->CR&DMA_SxCR_EN);
+	DMA2->HIFCR=DMA_HIFCR_CTCIF7|DMA_HIFCR_CHTIF7|DMA_HIFCR_CTEIF7|DMA_HIFCR_CDMEIF7|DMA_HIFCR_CFEIF7;
+	SBUS_TX_STREAM->M0AR=(uint32_t)buf;
+	SBUS_TX_STREAM->NDTR=SBUS_FRAME_SIZE;
+	SBUS_TX_STREAM->CR|=DMA_SxCR_EN;
+#else
+	SBUS_TX_CHANNEL->CCR&=~DMA_CCR1_EN;
+	SBUS_TX_CHANNEL->CMAR=(uint32_t)buf;
+	SBUS_TX_CHANNEL->CNDTR=SBUS_FRAME_SIZE;
+	SBUS_TX_CHANNEL->CCR|=DMA_CCR1_EN;
+#endif
+}
+
+//һ֡û
+static uint8_t sbus_tx_busy(void)
+{
+#if defined(STM32F40_41xxx)
+	return SBUS_TX_STREAM->NDTR!=0&&(SBUS_TX_STREAM->CR&DMA_SxCR_EN);
+#else
+	return SBUS_TX_CHANNEL->CNDTR!=0&&(SBUS_TX_CHANNEL->CCR&DMA_CCR1_EN);
+#endif
+}
+
+//RX DMA ´ͷ
+static void sbus_rx_dma(void)
+{
+#if defined(STM32F40_41xxx)
+	SBUS_RX_STREAM->CR&=~DMA_SxCR_EN;
+	while(SBUS_RX_STREAM->CR&DMA_SxCR_EN);
+	DMA2->LIFCR=DMA_LIFCR_CTCIF2|DMA_LIFCR_CHTIF2|DMA_LIFCR_CTEIF2|DMA_LIFCR_CDMEIF2|DMA_LIFCR_CFEIF2;
+	SBUS_RX_STREAM->NDTR=SBUS_RX_BUF;
+	SBUS_RX_STREAM->CR|=DMA_SxCR_EN;
+#else
+	SBUS_RX_CHANNEL->CCR&=~DMA_CCR1_EN;
+	SBUS_RX_CHANNEL->CNDTR=SBUS_RX_BUF;
+	SBUS_RX_CHANNEL->CCR|=DMA_CCR1_EN;
+#endif
+}
+
+static uint16_t sbus_rx_left(void)
+{
+#if defined(STM32F40_41xxx)
+	return SBUS_RX_STREAM->NDTR;
+#else
+	return SBUS_RX_CHANNEL->CNDTR;
+#endif
+}
+
+static void sbus_dma_init(void)
+{
+	DMA_InitTypeDef DMA_InitStructure;
+#if defined(STM32F40_41xxx)
+	RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA2,ENABLE);//DMA2ʱʹ
+	DMA_DeInit(SBUS_TX_STREAM);
+	DMA_DeInit(SBUS_RX_STREAM);
+	DMA_InitStructure.DMA_Channel = SBUS_DMA_CHANNEL;
+	DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&SBUS_USART->DR;
+	DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)sbus_tx_buf;
+	DMA_InitStructure.DMA_DIR = DMA_DIR_MemoryToPeripheral;
+	DMA_InitStructure.DMA_BufferSize = SBUS_FRAME_SIZE;
+	DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+	DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+	DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+	DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+	DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+	DMA_InitStructure.DMA_Priority = DMA_Priority_Medium;
+	DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Disable;
+	DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_Full;
+	DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+	DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+	DMA_Init(SBUS_TX_STREAM,&DMA_InitStructure);		//TX õʱʹ
+
+	DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)sbus_rx_buf;
+	DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralToMemory;
+	DMA_InitStructure.DMA_BufferSize = SBUS_RX_BUF;
+	DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+	DMA_Init(SBUS_RX_STREAM,&DMA_InitStructure);
+#else
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1,ENABLE);	//DMA1ʱʹ
+	DMA_DeInit(SBUS_TX_CHANNEL);
+	DMA_DeInit(SBUS_RX_CHANNEL);
+	DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&SBUS_USART->DR;
+	DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)sbus_tx_buf;
+	DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;
+	DMA_InitStructure.DMA_BufferSize = SBUS_FRAME_SIZE;
+	DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+	DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+	DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+	DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+	DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+	DMA_InitStructure.DMA_Priority = DMA_Priority_Medium;
+	DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+	DMA_Init(SBUS_TX_CHANNEL,&DMA_InitStructure);
+
+	DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)sbus_rx_buf;
+	DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;
+	DMA_InitStructure.DMA_BufferSize = SBUS_RX_BUF;
+	DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+	DMA_Init(SBUS_RX_CHANNEL,&DMA_InitStructure);
+#endif
+	sbus_rx_dma();
+}
+
+//1ms ģͼʱ + ճʱ
+static void sbus_tim_init(void)
+{
+	TIM_TimeBaseInitTypeDef TIM_TimeBaseInitStructure;
+	NVIC_InitTypeDef NVIC_InitStructure;
+#if defined(STM32F40_41xxx)
+	RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM7,ENABLE);	//ʹTIM7ʱ
+#else
+	RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM4,ENABLE);	//ʹTIM4ʱ
+#endif
+	TIM_TimeBaseInitStructure.TIM_Period = 1000-1;		//1MHz  1000  = 1ms
+	TIM_TimeBaseInitStructure.TIM_Prescaler = SBUS_TIM_PSC;
+	TIM_TimeBaseInitStructure.TIM_CounterMode = TIM_CounterMode_Up;
+	TIM_TimeBaseInitStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+	TIM_TimeBaseInitStructure.TIM_RepetitionCounter = 0;
+	TIM_TimeBaseInit(SBUS_TIM,&TIM_TimeBaseInitStructure);
+	TIM_ClearITPendingBit(SBUS_TIM,TIM_IT_Update);
+	TIM_ITConfig(SBUS_TIM,TIM_IT_Update,ENABLE);
+
+	NVIC_InitStructure.NVIC_IRQChannel = SBUS_TIM_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;	//ռȼ1 USB ĵһ
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+	TIM_Cmd(SBUS_TIM,ENABLE);
+}
+
+void USART1_SBUS_Init(void) // շ DMA
 {
-#if EN_USART1_RX	
 	NVIC_InitTypeDef NVIC_InitStructure ;//жϽṹ
- #endif
 	GPIO_InitTypeDef GPIO_InitStructure;//IOʼṹ
 	USART_InitTypeDef USART_InitStructure;//崮ڽṹ
 	
+#if defined(STM32F40_41xxx)
 	RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_GPIOA,ENABLE); //ʹGPIOAʱ
 	RCC_APB2PeriphClockCmd(RCC_APB2Periph_USART1,ENABLE);//ʹUSART1ʱ
  
 	//1ӦŸӳ
 	GPIO_PinAFConfig(GPIOA,GPIO_PinSource9,GPIO_AF_USART1); /*GPIOA9ΪUSART1 TX */
-//	GPIO_PinAFConfig(GPIOA,GPIO_PinSource10,GPIO_AF_USART1); //GPIOA10ΪUSART1 RX
+	GPIO_PinAFConfig(GPIOA,GPIO_PinSource10,GPIO_AF_USART1); //GPIOA10ΪUSART1 RX
 	
 	//USART1˿
-	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_9; /* | GPIO_Pin_10 ; */
+	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_9 | GPIO_Pin_10 ;
 	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF;//ù
 	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_100MHz;	/*ٶ*/
 	GPIO_InitStructure.GPIO_OType = GPIO_OType_PP; //츴
 	GPIO_InitStructure.GPIO_PuPd = GPIO_PuPd_UP; //
 	GPIO_Init(GPIOA,&GPIO_InitStructure); //ʼPA9PA10
+#else
+	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA|RCC_APB2Periph_USART1,ENABLE);//ʹGPIOA,USART1ʱ
+
+	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_9; //PA9 TX
+	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;	//
+	GPIO_Init(GPIOA,&GPIO_InitStructure);
+
+	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_10;//PA10 RX
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IPU;// ()
+	GPIO_Init(GPIOA,&GPIO_InitStructure);
+#endif
 
 	//USART1 ʼ
 	USART_InitStructure.USART_BaudRate = 100000;/* 100kbps*/
@@ -86,114 +266,244 @@ void USART1_SBUS_Init(void) // ֻ
 	USART_InitStructure.USART_StopBits = USART_StopBits_2;/*2ֹͣλ*/
 	USART_InitStructure.USART_Parity = USART_Parity_Even;/*żУ*/
 	USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;//Ӳ
-	USART_InitStructure.USART_Mode = USART_Mode_Tx;	/*ֻģʽ*/
-//	USART_InitStructure.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;	//շģʽ
-	USART_Init(USART1, &USART_InitStructure); //ʼ1
-	
-	USART_Cmd(USART1, ENABLE);  //ʹܴ1 
-	
-	//USART_ClearFlag(USART1, USART_FLAG_TC);
+	USART_InitStructure.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;	//շģʽ
+	USART_Init(SBUS_USART, &USART_InitStructure); //ʼ1
 	
-#if EN_USART1_RX	
-	USART_ITConfig(USART1, USART_IT_RXNE, ENABLE);//ж
+	sbus_dma_init();
+	USART_DMACmd(SBUS_USART,USART_DMAReq_Tx|USART_DMAReq_Rx,ENABLE);
+	USART_ITConfig(SBUS_USART, USART_IT_IDLE, ENABLE);//һ֡ (Ͽ) ж
+	USART_Cmd(SBUS_USART, ENABLE);  //ʹܴ1 
 
 	//Usart1 NVIC 
 	NVIC_InitStructure.NVIC_IRQChannel = USART1_IRQn;//1жͨ
-	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority=3;//ռȼ3
-	NVIC_InitStructure.NVIC_IRQChannelSubPriority =3;		//ȼ3
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority=1;//ռȼ1
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority =2;		//ȼ2
 	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;			//IRQͨʹ
 	NVIC_Init(&NVIC_InitStructure);	//ָĲʼVICĴ
 
-#endif
+	sbus_stat_reset();
+	sbus_period = SBUS_TX_FAST;
+	sbus_tim_init();
 }
 
-uint16_t sbus_8b(uint8_t num) // 1000 ~ 2000
+void sbus_tx_period(uint8_t ms)
 {
-	float val = (num / 255.0f) * 1000.0f;
-	uint16_t sbusval = val + 1000.0f + 0.5f;
-	return sbusval;
+	sbus_period = ms;
+	sbus_tx_last_us = 0;	//ͣ/Ĺڣһ
 }
 
-uint16_t sbus_16b(uint16_t num) // 1000 ~ 2000
+uint32_t sbus_millis(void)
 {
-	float val = (num / 1023.0f) * 1000.0f;
-	uint16_t sbusval = val + 1000.0f + 0.5f;
-	return sbusval;
+	return sbus_ms;
 }
 
-//uint16_t button_to_sbus(uint8_t flag)
-//{
-//	if(flag != 0) return 1800;
-//	return 1200;	
-//}
+uint32_t sbus_micros(void)
+{
+	uint32_t ms, cnt, pend;
+	do {
+		ms = sbus_ms;
+		cnt = SBUS_TIM->CNT;
+		pend = SBUS_TIM->SR & TIM_IT_Update;
+	} while (ms != sbus_ms);	//;һνж ٶ
+	if (pend && cnt < 500) ms++;	// 0  жϻû (ڱȼߵж)
+	return ms * 1000 + cnt;
+}
 
-#define SBUS_FRAME_SIZE 25
-#define SBUS_RANGE_MIN 200.0f
-#define SBUS_RANGE_MAX 1800.0f
-#define SBUS_TARGET_MIN 1000.0f
-#define SBUS_TARGET_MAX 2000.0f 
-#define SBUS_SCALE_FACTOR ((SBUS_TARGET_MAX - SBUS_TARGET_MIN)/(SBUS_RANGE_MAX-SBUS_RANGE_MIN))//0.625f = (2000-1000) / (1800-200)
-#define SBUS_SCALE_OFFSET (int)(SBUS_TARGET_MIN - (SBUS_SCALE_FACTOR * SBUS_RANGE_MIN + 0.5f)) //874.5f = 1000 - (0.625f * 200)
+//ͳ (һ½жϣжĸ½һ)
+void sbus_stat_reset(void)
+{
+	SBUS_TIM->DIER &= ~TIM_IT_Update;
+	memset((void*)&sbus_stat, 0, sizeof(sbus_stat));
+	sbus_stat.tx_period_min = 0xFFFFFFFF;
+	sbus_tx_last_us = 0;
+	SBUS_TIM->DIER |= TIM_IT_Update;
+}
 
-//ϳɺ
-//void sbus_outuint8_t num_values;//Ϊͨ
-//values[16]ǶӦ16ͨ
+//ֵͨ  ȫԭĸ㹫ʽֵԹ (8λ 256 10λ 1024 us 1000~2000)
+uint16_t sbus_8b(uint8_t num) // 1000 ~ 2000 num*1000/255
+{
+	return 1000 + ((uint32_t)num * 2000 + 255) / 510;
+}
 
-uint16_t values[16]={0}; // ͨ
+uint16_t sbus_16b(uint16_t num) // 1000 ~ 2000 num*1000/1023
+{
+	return 1000 + ((uint32_t)num * 2000 + 1023) / 2046;
+}
 
-void sbus_send(uint8_t num_values/*ͨ*/)
+uint16_t sbus_axis(uint16_t num) // 1000 ~ 2000 num*1000/65535
 {
-	uint16_t value=0;
-	
-	uint8_t oframe[25];
-	memset(oframe, 0, 25);
-	oframe[0]=0x0f;
-//	oframe[24]=0x00;
+	return 1000 + ((uint32_t)num * 2000 + 65535) / 131070;
+}
+
+uint16_t sbus_us_to_raw(uint16_t us) // 1000~2000 -> 200~1800
+{
+	uint32_t raw;
+	if (us <= SBUS_US_OFFSET) return 0;
+	raw = ((uint32_t)(us - SBUS_US_OFFSET) * 16 + 5) / 10;
+	if (raw > 0x07ff) raw = 0x07ff; // 0x07ff = 2047
+	return raw;
+}
+
+uint16_t sbus_raw_to_us(uint16_t raw)
+{
+	return SBUS_US_OFFSET + ((uint32_t)raw * 10 + 8) / 16;
+}
 
-	for (uint8_t i=0, byteindex=1, offset=0; (i < num_values) && (i < 16); ++i)
+//11 λһͨ λǰܹ 8 λһֽ
+void sbus_pack(uint8_t *frame,const uint16_t *raw,uint8_t num,uint8_t flags)
+{
+	uint32_t acc = 0;
+	uint8_t bits = 0, i;
+	uint8_t *p = frame + 1;
+	frame[0] = SBUS_HEADER;
+	for (i = 0; i < SBUS_CH_NUM; ++i)
 	{
-//		value = values[i];
-		value = (unsigned short)( ( (values[i]-SBUS_SCALE_OFFSET) / SBUS_SCALE_FACTOR) + 0.5f);
-		if (value > 0x07ff)	value = 0x07ff; // 0x07ff = 2047
-		while (offset >= 8) {
-			++byteindex;
-			offset -= 8;
-		}		 
-		oframe[byteindex] |= (value << (offset)) & 0xff;
-		oframe[byteindex + 1] |= (value >> (8 - offset)) & 0xff;
-		oframe[byteindex + 2] |= (value >> (16 - offset)) & 0xff;
-		offset += 11;
+		if (i < num) acc |= (uint32_t)(raw[i] & 0x07ff) << bits;
+		bits += 11;
+		while (bits >= 8) {
+			*p++ = acc;
+			acc >>= 8;
+			bits -= 8;
+		}
 	}
-	
-	for (uint8_t i=0; i < 25 ; ++i)
+	frame[23] = flags;
+	frame[24] = SBUS_FOOTER;
+}
+
+// ()
+//ֵ:0,ɹ;1,ͷβ
+uint8_t sbus_unpack(const uint8_t *frame,SBUS_Frame_TypeDef *out)
+{
+	uint32_t acc = 0;
+	uint8_t bits = 0, i;
+	const uint8_t *p = frame + 1;
+	if (frame[0] != SBUS_HEADER) return 1;
+	if (frame[24] != SBUS_FOOTER && (frame[24] & 0x0f) != 0x04) return 1; //SBUS2 β 0x04/0x14/0x24/0x34
+	for (i = 0; i < SBUS_CH_NUM; ++i)
 	{
-		while(USART_GetFlagStatus(USART1, USART_FLAG_TC) == RESET);	// ȴͽ
-		USART_SendData(USART1, (uint16_t)oframe[i]); // ÿ1ֽݷ͵
+		while (bits < 11) {
+			acc |= (uint32_t)(*p++) << bits;
+			bits += 8;
+		}
+		out->ch[i] = acc & 0x07ff;
+		acc >>= 11;
+		bits -= 11;
 	}
-#if 0 
-	while(USART_GetFlagStatus(USART1, USART_FLAG_TC) == RESET);	// ȴͽ
-	USART_SendData(USART1, (uint16_t)'\n'); // ÿ1ֽݷ͵
-#endif
+	out->flags = frame[23];
+	return 0;
+}
+
+//һ (ߣֻһط) raw ʱʱ
+uint8_t sbus_push(const uint16_t *us,uint8_t num,uint8_t flags)
+{
+	SBUS_Report_TypeDef *r;
+	uint8_t w = sbus_ring_w, i;
+	sbus_stat.tx_reports++;
+	if ((uint8_t)(w - sbus_ring_r) >= SBUS_RING_N) {	// (ʱ 1ms ȡһΣ)
+		sbus_stat.tx_drop++;
+		return 1;
+	}
+	r = &sbus_ring[w & (SBUS_RING_N - 1)];
+	if (num > SBUS_CH_NUM) num = SBUS_CH_NUM;
+	for (i = 0; i < SBUS_CH_NUM; ++i) r->raw[i] = i < num ? sbus_us_to_raw(us[i]) : 0;
+	r->flags = flags;
+	r->t_us = sbus_micros();
+	__DMB();			//д Ų±
+	sbus_ring_w = w + 1;
+	return 0;
 }
 
-/* Эʽ[startbyte]  [data1] [data2]  [data22]      [flags] [endbyte]  : 25ֽ 
-          0x0f        X Y RZ Slider Hat_Switch button   0x00    0x00      : 25ֽ */
+//ѻıȫȡ ֻµ (ߣʱж)
+static void sbus_ring_take(void)
+{
+	uint8_t r = sbus_ring_r, w = sbus_ring_w, n;
+	n = (uint8_t)(w - r);
+	if (n == 0) return;
+	__DMB();			//ȿ± ٶ
+	if (sbus_tx_new) n++;	//һûȥ Ҳ㱻
+	sbus_stat.tx_merged += n - 1;
+	sbus_tx_rep = sbus_ring[(uint8_t)(w - 1) & (SBUS_RING_N - 1)];
+	sbus_ring_r = w;
+	sbus_tx_new = 1;
+	sbus_tx_ready = 1;
+}
 
-void sbus_out(HID_Logitech_Data_Analyze *Logitech_data) // 
+uint8_t sbus_get(SBUS_Frame_TypeDef *frame)
 {
-	values[0] = 2000 - (sbus_8b(Logitech_data->RZ) - 1000); // CH1
-	values[1] = sbus_16b(Logitech_data->Y); // CH2
-	values[2] = sbus_8b(Logitech_data->Slider); // CH3
-	values[3] = sbus_16b(Logitech_data->X); // CH4
+	uint8_t fresh = sbus_rx_new;
+	sbus_rx_new = 0;
+	*frame = sbus_rx_frame[sbus_rx_idx];
+	return fresh;
+}
 
-	for (uint16_t i=0x0001, j=0; i & 0x0fff ; i = i<<1, ++j) 
+uint8_t sbus_failsafe(void)
+{
+	if (sbus_rx_fs) return 1;
+	return (uint32_t)(sbus_ms - sbus_stat.rx_last_ms) > SBUS_RX_TIMEOUT;
+}
+
+//1ms ģȡ滷 һ֡Ҳ Ͱµı DMA
+void SBUS_TIM_IRQHandler(void)
+{
+	uint32_t now, d;
+	if (SBUS_TIM->SR & TIM_IT_Update)
 	{
-//		if (Logitech_data->button & i) retval = button_to_sbus(1);
-//		else retval = button_to_sbus(0);
-		if (Logitech_data->button & i) values[4+j] = 1800;
-		else values[4+j] = 1200;
+		SBUS_TIM->SR = (uint16_t)~TIM_IT_Update;
+		sbus_ms++;
+		sbus_ring_take();	//ͣʱҲȡָһ֡Ǿɱ
+		if (sbus_period && sbus_tx_ready && (uint32_t)(sbus_ms - sbus_tx_last) >= sbus_period && !sbus_tx_busy())
+		{
+			now = sbus_micros();
+			if (sbus_tx_new) {
+				sbus_pack(sbus_tx_buf, sbus_tx_rep.raw, SBUS_CH_NUM, sbus_tx_rep.flags);
+				sbus_tx_new = 0;
+				d = now - sbus_tx_rep.t_us;
+				sbus_stat.tx_lat_last = d;
+				if (d > sbus_stat.tx_lat_max) sbus_stat.tx_lat_max = d;
+				sbus_stat.tx_lat_avg = sbus_stat.tx_lat_avg ? sbus_stat.tx_lat_avg + ((int32_t)(d - sbus_stat.tx_lat_avg) >> 3) : d;
+			}
+			else sbus_stat.tx_repeat++;
+			sbus_tx_dma(sbus_tx_buf);	//û¾طһ֡ջΪ
+			if (sbus_tx_last_us) {
+				d = now - sbus_tx_last_us;
+				sbus_stat.tx_period_last = d;
+				if (d < sbus_stat.tx_period_min) sbus_stat.tx_period_min = d;
+				if (d > sbus_stat.tx_period_max) sbus_stat.tx_period_max = d;
+			}
+			sbus_tx_last_us = now ? now : 1;
+			sbus_tx_last = sbus_ms;
+			sbus_stat.tx_frames++;
+		}
 	}
-	sbus_send(16);
 }
 
-
+//жϣͣˣ DMA ˼ֽ
+void USART1_IRQHandler(void)
+{
+	uint16_t sr = SBUS_USART->SR, len;
+	uint8_t w;
+	if (sr & USART_FLAG_IDLE)
+	{
+		(void)SBUS_USART->DR;	// SR ٶ DR  IDLE/PE/FE/NE
+		len = SBUS_RX_BUF - sbus_rx_left();
+		if (len == SBUS_FRAME_SIZE && (sr & (USART_FLAG_PE | USART_FLAG_FE | USART_FLAG_NE)) == 0)
+		{
+			w = sbus_rx_idx ^ 1;
+			if (sbus_unpack(sbus_rx_buf, &sbus_rx_frame[w]) == 0)
+			{
+				if (sbus_rx_frame[w].flags & SBUS_FLAG_FRAME_LOST) sbus_stat.rx_lost++;
+				if ((sbus_rx_frame[w].flags & SBUS_FLAG_FAILSAFE) && !sbus_rx_fs) sbus_stat.rx_failsafe++;
+				sbus_rx_fs = (sbus_rx_frame[w].flags & SBUS_FLAG_FAILSAFE) != 0;
+				__DMB();
+				sbus_rx_idx = w;
+				sbus_rx_new = 1;
+				sbus_stat.rx_frames++;
+				sbus_stat.rx_last_ms = sbus_ms;
+			}
+			else sbus_stat.rx_bad++;
+		}
+		else if (len) sbus_stat.rx_bad++;
+		sbus_rx_dma();
+	}
+	else if (sr & USART_FLAG_ORE) (void)SBUS_USART->DR;
+}
@@ -3,11 +3,6 @@
 #define __SERIAL_BUS_H
 
 #include "sys.h"
-#include "usbh_hid_Logitech.h"
-
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
 
 /* SBUSȫserial-busһִͨЭ飬㷺ӦںģңջС
 ֻһź߾ܴ16ͨݣȶ·PWMЧʡԴ
@@ -66,12 +61,111 @@ ch16=6 5;
 
 */		
 
-void USART1_SBUS_Init(void);
+/* ģ÷ (F407 / F103 ͨã STM32F40_41xxx )
+	USART1_SBUS_Init();						//USART1 շ + DMA + 1ms ʱĬϸģʽ 7ms һ֡
+	sbus_push(us,16,0);						//һ (16 ͨ 1000~2000us) 滷ȷ
+	if(sbus_get(&frame)) ...				//յ֡ (DMA + ж ֡)
+	if(sbus_failsafe()) ...					//ջʧ  SBUS_RX_TIMEOUT ûյ֡
+	ͣUSB Ǳ (USBH_Process һ HID ) ֻ sbus_push us ʱŽ
+		/ ı滷 (жϣд±һ)
+		ʱÿ 1ms һΣѻıȫȡ ֻµģ֡ һ֡Ҳˣ
+		Ͱµı TX DMACPU  TC˭Ҳ˭USB ѯ춼 SBUS ֡ڣ
+		SBUS Ҳռ USB ״̬ʱ䡣
+		sbus_stat  -> ʱ/ı桢֡ ()sbus_stat_reset() 㡣
+	գRX DMA һֱ sbus_rx_buf գжﰴյֽжһ֡
+
+	 (Ҫľ͸ĺ)
+	F407: USART1 PA9/PA10, DMA2 Stream7/Stream2 ͨ4, TIM7
+	F103: USART1 PA9/PA10, DMA1 ͨ4/ͨ5, TIM4 ( SPI2 DMA ͬһͨһ)
+	USART1  SBUS ãusart.c  EN_USART1_RX ҪΪ 0 (Ȼ USART1_IRQHandler ظ)
+*/
+
+#define SBUS_FRAME_SIZE		25
+#define SBUS_CH_NUM			16
+#define SBUS_HEADER			0x0F
+#define SBUS_FOOTER			0x00
+
+//flags ֽ
+#define SBUS_FLAG_CH17			0x01	//ͨ17
+#define SBUS_FLAG_CH18			0x02	//ͨ18
+#define SBUS_FLAG_FRAME_LOST	0x04	//ջ һ֡
+#define SBUS_FLAG_FAILSAFE		0x08	//ջ ʧر
+
+#define SBUS_TX_FAST		7			//ģʽ ֡ ms
+#define SBUS_TX_NORMAL		14			//ͨģʽ
+#define SBUS_RX_TIMEOUT		100			//ms ûյ֡͵ʧ
+#define SBUS_RX_BUF			32			//һ֡նҲܿ
+#define SBUS_RING_N			8			//滷  (2 )ʱÿ 1ms ȡһ
+
+#define SBUS_US_OFFSET		874			//ԭ㹫ʽ (us-874)/0.625 棺raw=((us-874)*16+5)/10
+#define SBUS_US_MIN			1000
+#define SBUS_US_MAX			2000
+
+#if defined(STM32F40_41xxx)
+#define SBUS_USART				USART1
+#define SBUS_TX_STREAM			DMA2_Stream7
+#define SBUS_RX_STREAM			DMA2_Stream2
+#define SBUS_DMA_CHANNEL		DMA_Channel_4
+#define SBUS_TIM				TIM7
+#define SBUS_TIM_IRQn			TIM7_IRQn
+#define SBUS_TIM_IRQHandler		TIM7_IRQHandler
+#define SBUS_TIM_PSC			(84-1)		//APB1 ʱʱ 84M -> 1MHz
+#else
+#define SBUS_USART				USART1
+#define SBUS_TX_CHANNEL			DMA1_Channel4
+#define SBUS_RX_CHANNEL			DMA1_Channel5
+#define SBUS_TIM				TIM4
+#define SBUS_TIM_IRQn			TIM4_IRQn
+#define SBUS_TIM_IRQHandler		TIM4_IRQHandler
+#define SBUS_TIM_PSC			(72-1)		//72M -> 1MHz
+#endif
 
-void sbus_out(HID_Logitech_Data_Analyze *Logitech_data);
+typedef struct
+{
+	uint16_t ch[SBUS_CH_NUM];	//0~2047
+	uint8_t  flags;				//SBUS_FLAG_xxx
+} SBUS_Frame_TypeDef;
+
+typedef struct
+{
+	uint32_t tx_frames;			//ȥ֡
+	uint32_t rx_frames;			//յĺ֡
+	uint32_t rx_bad;			///ͷβ/У鲻
+	uint32_t rx_lost;			//֡ FRAME_LOST λĴ
+	uint32_t rx_failsafe;		//ʧصĴ
+	uint32_t rx_last_ms;		//һ֡ʱ
+
+	uint32_t tx_reports;		//sbus_push ı
+	uint32_t tx_drop;			//滷  (ʱͣ˲Ż)
+	uint32_t tx_merged;			//ûֵ ͱµı涥
+	uint32_t tx_repeat;			//û± طһ֡
+	uint32_t tx_lat_last;		//-> ʱ us (sbus_push  DMA ʼ)ֻ±֡
+	uint32_t tx_lat_max;
+	uint32_t tx_lat_avg;		//ƽ (1/8)
+	uint32_t tx_period_last;	//֡ʼļ us = max-min
+	uint32_t tx_period_min;
+	uint32_t tx_period_max;
+} SBUS_Stat_TypeDef;
+
+extern volatile SBUS_Stat_TypeDef sbus_stat;
 
+void USART1_SBUS_Init(void);
+void sbus_tx_period(uint8_t ms);		//֡ SBUS_TX_FAST/SBUS_TX_NORMAL0:ͣ
+uint32_t sbus_millis(void);				//SBUS ʱ ms 
+uint32_t sbus_micros(void);				//SBUS ʱ us  (ms *1000 + CNT)
+void sbus_stat_reset(void);
 
-#endif
+uint16_t sbus_8b(uint8_t num);			//0~255  -> 1000~2000us
+uint16_t sbus_16b(uint16_t num);		//0~1023 -> 1000~2000us
+uint16_t sbus_axis(uint16_t num);		//0~65535 (HID һ) -> 1000~2000us
+uint16_t sbus_us_to_raw(uint16_t us);	//1000~2000us -> 0~2047
+uint16_t sbus_raw_to_us(uint16_t raw);
 
+void sbus_pack(uint8_t *frame,const uint16_t *raw,uint8_t num,uint8_t flags);	//һ֡ 25 ֽڣnum ͨΪ 0
+uint8_t sbus_unpack(const uint8_t *frame,SBUS_Frame_TypeDef *out);				//0:ɹ 1:ͷβ
 
+uint8_t sbus_push(const uint16_t *us,uint8_t num,uint8_t flags);	//һ (ֻһطѭ/USBH_Process) 0:ɹ 1:
+uint8_t sbus_get(SBUS_Frame_TypeDef *frame);		//ȡյ֡ 1:ûȡ֡ 0:һ֡
+uint8_t sbus_failsafe(void);						//1:ʧ
 
+#endif
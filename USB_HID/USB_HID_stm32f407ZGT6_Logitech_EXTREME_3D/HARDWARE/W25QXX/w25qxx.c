@@ -0,0 +1,273 @@
+#include "w25qxx.h"
+
+//W25Q128 F407 棺SPI1 + DMA2˵ w25qxx.h
+
+u16 W25QXX_TYPE=W25Q128;	//ĬW25Q128
+
+static u8 W25QXX_Dummy=0XFF;			//TX DMA ַ һֱ 0xFF
+static u8 W25QXX_Dummy_Rx;				//RX DMA ַ յĶ
+static volatile u8 W25QXX_DMA_Run=0;
+static W25QXX_Callback W25QXX_DMA_Cb=0;
+
+//SPI1 дһֽ
+static u8 SPI1_ReadWriteByte(u8 TxData)
+{
+	while((SPI1->SR&SPI_I2S_FLAG_TXE)==0);
+	SPI1->DR=TxData;
+	while((SPI1->SR&SPI_I2S_FLAG_RXNE)==0);
+	return SPI1->DR;
+}
+
+//ʼSPI FLASHIOڡSPI1DMA
+void W25QXX_Init(void)
+{
+	GPIO_InitTypeDef  GPIO_InitStructure;
+	SPI_InitTypeDef  SPI_InitStructure;
+	DMA_InitTypeDef  DMA_InitStructure;
+	NVIC_InitTypeDef NVIC_InitStructure;
+
+	RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_GPIOB,ENABLE);//ʹGPIOBʱ
+	RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA2,ENABLE);//DMA2ʱʹ
+	RCC_APB2PeriphClockCmd(RCC_APB2Periph_SPI1,ENABLE);//ʹSPI1ʱ
+
+	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_14;//PB14 Ƭѡ
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_OUT;//
+	GPIO_InitStructure.GPIO_OType = GPIO_OType_PP;//
+	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_100MHz;//100MHz
+	GPIO_InitStructure.GPIO_PuPd = GPIO_PuPd_UP;//
+	GPIO_Init(GPIOB,&GPIO_InitStructure);
+	W25QXX_CS=1;			//SPI FLASHѡ
+
+	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_3|GPIO_Pin_4|GPIO_Pin_5;//PB3~5ù (ú JTAG  PB3/PB4 ԶóSWD ճ)
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF;//ù
+	GPIO_Init(GPIOB,&GPIO_InitStructure);
+	GPIO_PinAFConfig(GPIOB,GPIO_PinSource3,GPIO_AF_SPI1);//PB3Ϊ SPI1
+	GPIO_PinAFConfig(GPIOB,GPIO_PinSource4,GPIO_AF_SPI1);//PB4Ϊ SPI1
+	GPIO_PinAFConfig(GPIOB,GPIO_PinSource5,GPIO_AF_SPI1);//PB5Ϊ SPI1
+
+	SPI_InitStructure.SPI_Direction = SPI_Direction_2Lines_FullDuplex;//˫˫ȫ˫
+	SPI_InitStructure.SPI_Mode = SPI_Mode_Master;//SPI
+	SPI_InitStructure.SPI_DataSize = SPI_DataSize_8b;//8λ֡ṹ
+	SPI_InitStructure.SPI_CPOL = SPI_CPOL_High;//״̬Ϊߵƽ
+	SPI_InitStructure.SPI_CPHA = SPI_CPHA_2Edge;//ڶز
+	SPI_InitStructure.SPI_NSS = SPI_NSS_Soft;//Ƭѡ
+	SPI_InitStructure.SPI_BaudRatePrescaler = SPI_BaudRatePrescaler_2;//84M/2=42M ( FastRead)
+	SPI_InitStructure.SPI_FirstBit = SPI_FirstBit_MSB;//MSBλʼ
+	SPI_InitStructure.SPI_CRCPolynomial = 7;
+	SPI_Init(SPI1,&SPI_InitStructure);
+	SPI_Cmd(SPI1,ENABLE);
+
+	DMA_DeInit(W25QXX_DMA_RX);
+	DMA_DeInit(W25QXX_DMA_TX);
+	DMA_InitStructure.DMA_Channel = W25QXX_DMA_CHANNEL;
+	DMA_InitStructure.DMA_PeripheralBaseAddr = (u32)&SPI1->DR;
+	DMA_InitStructure.DMA_Memory0BaseAddr = (u32)&W25QXX_Dummy_Rx;
+	DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralToMemory;
+	DMA_InitStructure.DMA_BufferSize = 1;
+	DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+	DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+	DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+	DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+	DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+	DMA_InitStructure.DMA_Priority = DMA_Priority_VeryHigh;		// ȷȣᶪֽ
+	DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Disable;
+	DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_Full;
+	DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+	DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+	DMA_Init(W25QXX_DMA_RX,&DMA_InitStructure);
+	DMA_ITConfig(W25QXX_DMA_RX,DMA_IT_TC,ENABLE);
+
+	DMA_InitStructure.DMA_Memory0BaseAddr = (u32)&W25QXX_Dummy;
+	DMA_InitStructure.DMA_DIR = DMA_DIR_MemoryToPeripheral;
+	DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+	DMA_Init(W25QXX_DMA_TX,&DMA_InitStructure);
+
+	NVIC_InitStructure.NVIC_IRQChannel = DMA2_Stream0_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0x00;//ռȼ0 ( OTG_FS һ)
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0x02;//ȼ2
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+
+	W25QXX_TYPE=W25QXX_ReadID();//ȡFLASH ID.
+}
+
+//ȡW25QXX״̬Ĵ
+//BIT7  6   5   4   3   2   1   0
+//SPR   RV  TB BP2 BP1 BP0 WEL BUSY
+//BUSY:æλ(1,æ;0,)
+u8 W25QXX_ReadSR(void)
+{
+	u8 byte=0;
+	W25QXX_CS=0;                            //ʹ
+	SPI1_ReadWriteByte(W25X_ReadStatusReg); //Ͷȡ״̬Ĵ
+	byte=SPI1_ReadWriteByte(0Xff);          //ȡһֽ
+	W25QXX_CS=1;                            //ȡƬѡ
+	return byte;
+}
+//W25QXXдʹ
+//WELλ
+void W25QXX_Write_Enable(void)
+{
+	W25QXX_CS=0;                          	//ʹ
+	SPI1_ReadWriteByte(W25X_WriteEnable); 	//дʹ
+	W25QXX_CS=1;                           	//ȡƬѡ
+}
+//ȡоƬID
+//0XEF17,ʾоƬͺΪW25Q128
+u16 W25QXX_ReadID(void)
+{
+	u16 Temp = 0;
+	W25QXX_CS=0;
+	SPI1_ReadWriteByte(0x90);//ͶȡID
+	SPI1_ReadWriteByte(0x00);
+	SPI1_ReadWriteByte(0x00);
+	SPI1_ReadWriteByte(0x00);
+	Temp|=SPI1_ReadWriteByte(0xFF)<<8;
+	Temp|=SPI1_ReadWriteByte(0xFF);
+	W25QXX_CS=1;
+	return Temp;
+}
+// + 24bitַ
+static void W25QXX_Cmd_Addr(u8 cmd,u32 addr)
+{
+	SPI1_ReadWriteByte(cmd);
+	SPI1_ReadWriteByte((u8)((addr)>>16));
+	SPI1_ReadWriteByte((u8)((addr)>>8));
+	SPI1_ReadWriteByte((u8)addr);
+}
+//ȡSPI FLASH
+//pBuffer:ݴ洢
+//ReadAddr:ʼȡĵַ(24bit)
+//NumByteToRead:Ҫȡֽ(65535)
+void W25QXX_Read(u8* pBuffer,u32 ReadAddr,u16 NumByteToRead)
+{
+	u16 i;
+	W25QXX_Wait_Busy();							//̨/ ʱ 
+	W25QXX_CS=0;                            	//ʹ
+	W25QXX_Cmd_Addr(W25X_ReadData,ReadAddr);
+	for(i=0;i<NumByteToRead;i++)pBuffer[i]=SPI1_ReadWriteByte(0XFF);   	//ѭ
+	W25QXX_CS=1;
+}
+//SPIһҳ(0~65535)д256ֽڵ (Ѿ)
+void W25QXX_Write_Page(u8* pBuffer,u32 WriteAddr,u16 NumByteToWrite)
+{
+	u16 i;
+	W25QXX_Wait_Busy();
+	W25QXX_Write_Enable();                  	//SET WEL
+	W25QXX_CS=0;                            	//ʹ
+	W25QXX_Cmd_Addr(W25X_PageProgram,WriteAddr);
+	for(i=0;i<NumByteToWrite;i++)SPI1_ReadWriteByte(pBuffer[i]);//ѭд
+	W25QXX_CS=1;                            	//ȡƬѡ
+	W25QXX_Wait_Busy();					   		//ȴд
+}
+//һ
+//Dst_Addr:ַ ʵ
+//һʱ:150ms
+void W25QXX_Erase_Sector(u32 Dst_Addr)
+{
+	W25QXX_Erase_Sector_Start(Dst_Addr);
+	W25QXX_Wait_Busy();   				   		//ȴ
+}
+//һ ֻȴ (W25QXX_Busy Ƿ)
+//Dst_Addr:ַ
+void W25QXX_Erase_Sector_Start(u32 Dst_Addr)
+{
+	Dst_Addr*=W25QXX_SECTOR_SIZE;
+	W25QXX_Wait_Busy();
+	W25QXX_Write_Enable();                  	//SET WEL
+	W25QXX_CS=0;                            	//ʹ
+	W25QXX_Cmd_Addr(W25X_SectorErase,Dst_Addr);	//ָ
+	W25QXX_CS=1;                            	//ȡƬѡ
+}
+//1:ڲ/
+u8 W25QXX_Busy(void)
+{
+	return W25QXX_ReadSR()&0x01;
+}
+//ȴ
+void W25QXX_Wait_Busy(void)
+{
+	while((W25QXX_ReadSR()&0x01)==0x01);  		// ȴBUSYλ
+}
+
+//Ƭѡ͡ѷ꣬DMA շ len ֽ (rx/tx Ϊ 0 ʱ ֽڲַ)
+static void W25QXX_DMA_Start(u8 *rx,u8 *tx,u16 len,W25QXX_Callback cb)
+{
+	if(len==0)
+	{
+		W25QXX_CS=1;
+		if(cb)cb();
+		return;
+	}
+	W25QXX_DMA_Cb=cb;
+	W25QXX_DMA_Run=1;
+	W25QXX_DMA_RX->CR&=~DMA_SxCR_EN;
+	W25QXX_DMA_TX->CR&=~DMA_SxCR_EN;
+	while((W25QXX_DMA_RX->CR|W25QXX_DMA_TX->CR)&DMA_SxCR_EN);
+	DMA2->LIFCR=DMA_LIFCR_CTCIF0|DMA_LIFCR_CHTIF0|DMA_LIFCR_CTEIF0|DMA_LIFCR_CDMEIF0|DMA_LIFCR_CFEIF0
+	           |DMA_LIFCR_CTCIF3|DMA_LIFCR_CHTIF3|DMA_LIFCR_CTEIF3|DMA_LIFCR_CDMEIF3|DMA_LIFCR_CFEIF3;
+	if(rx)
+	{
+		W25QXX_DMA_RX->M0AR=(u32)rx;
+		W25QXX_DMA_RX->CR|=DMA_SxCR_MINC;
+	}
+	else
+	{
+		W25QXX_DMA_RX->M0AR=(u32)&W25QXX_Dummy_Rx;
+		W25QXX_DMA_RX->CR&=~DMA_SxCR_MINC;
+	}
+	if(tx)
+	{
+		W25QXX_DMA_TX->M0AR=(u32)tx;
+		W25QXX_DMA_TX->CR|=DMA_SxCR_MINC;
+	}
+	else
+	{
+		W25QXX_DMA_TX->M0AR=(u32)&W25QXX_Dummy;
+		W25QXX_DMA_TX->CR&=~DMA_SxCR_MINC;
+	}
+	W25QXX_DMA_RX->NDTR=len;
+	W25QXX_DMA_TX->NDTR=len;
+	W25QXX_DMA_RX->CR|=DMA_SxCR_EN;
+	W25QXX_DMA_TX->CR|=DMA_SxCR_EN;
+	SPI1->CR2|=SPI_I2S_DMAReq_Rx|SPI_I2S_DMAReq_Tx;
+}
+
+//̨FastRead (42M  03  50M С) + 1 ֽڣ֮󽻸 DMA
+void W25QXX_Read_DMA(u8* pBuffer,u32 ReadAddr,u16 NumByteToRead,W25QXX_Callback cb)
+{
+	W25QXX_CS=0;
+	W25QXX_Cmd_Addr(W25X_FastReadData,ReadAddr);
+	SPI1_ReadWriteByte(0XFF);
+	W25QXX_DMA_Start(pBuffer,0,NumByteToRead,cb);
+}
+
+//̨дһҳصʱ ƬѡߣоƬʼ (0.7ms ңW25QXX_Busy )
+void W25QXX_Write_Page_DMA(u8* pBuffer,u32 WriteAddr,u16 NumByteToWrite,W25QXX_Callback cb)
+{
+	W25QXX_Write_Enable();
+	W25QXX_CS=0;
+	W25QXX_Cmd_Addr(W25X_PageProgram,WriteAddr);
+	W25QXX_DMA_Start(0,pBuffer,NumByteToWrite,cb);
+}
+
+u8 W25QXX_DMA_Busy(void)
+{
+	return W25QXX_DMA_Run;
+}
+
+//һֽڣȡƬѡص (صԽŷһ)
+void DMA2_Stream0_IRQHandler(void)
+{
+	W25QXX_Callback cb;
+	if(DMA2->LISR&DMA_LISR_TCIF0)
+	{
+		DMA2->LIFCR=DMA_LIFCR_CTCIF0;
+		SPI1->CR2&=~(SPI_I2S_DMAReq_Rx|SPI_I2S_DMAReq_Tx);
+		W25QXX_CS=1;
+		cb=W25QXX_DMA_Cb;
+		W25QXX_DMA_Cb=0;
+		W25QXX_DMA_Run=0;
+		if(cb)cb();
+	}
+}
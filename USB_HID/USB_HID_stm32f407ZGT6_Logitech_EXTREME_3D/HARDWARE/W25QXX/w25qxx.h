@@ -0,0 +1,73 @@
+#ifndef __W25QXX_H
+#define __W25QXX_H
+#include "sys.h"
+
+/* W25Q128 (̽ F407 )SPI1 PB3/PB4/PB5Ƭѡ PB14
+	4KbytesΪһSector16Ϊ1BlockW25Q128 Ϊ16Mֽ,256Block,4096Sector
+	ͨд  ALIENTEK  W25QXX һ (ѯŷ)
+	̨д (SPI1 DMADMA2 Stream0 ͨ3 գStream3 ͨ3 )
+		W25QXX_Read_DMA(buf,addr,len,cb);			//Ƭѡ++ַ ֮ DMA  len ֽڣ
+		W25QXX_Write_Page_DMA(buf,addr,len,cb);		//дʹ++ַ ֮ DMA һҳ
+		һֽ (Stream0 TC ж) ȡƬѡ ٵ cb (ж)
+		дҳ صʱоƬſʼ̣W25QXX_Busy() ûС
+	DMA û (W25QXX_DMA_Busy) ֮ǰ Ҫĺ
+	DMA2_Stream0 ж ռȼ OTG_FS һ (0)жϻ (usbd_storage_msd.c ) */
+
+//W25Xϵ/QϵоƬб
+//W25Q80  ID  0XEF13
+//W25Q16  ID  0XEF14
+//W25Q32  ID  0XEF15
+//W25Q64  ID  0XEF16
+//W25Q128 ID  0XEF17
+#define W25Q80 	0XEF13
+#define W25Q16 	0XEF14
+#define W25Q32 	0XEF15
+#define W25Q64 	0XEF16
+#define W25Q128	0XEF17
+
+extern u16 W25QXX_TYPE;					//W25QXXоƬͺ
+
+#define	W25QXX_CS 		PBout(14)  		//W25QXXƬѡź
+
+#define W25QXX_PAGE_SIZE	256
+#define W25QXX_SECTOR_SIZE	4096
+
+#define W25QXX_DMA_RX		DMA2_Stream0
+#define W25QXX_DMA_TX		DMA2_Stream3
+#define W25QXX_DMA_CHANNEL	DMA_Channel_3
+
+//ָ
+#define W25X_WriteEnable		0x06
+#define W25X_WriteDisable		0x04
+#define W25X_ReadStatusReg		0x05
+#define W25X_WriteStatusReg		0x01
+#define W25X_ReadData			0x03
+#define W25X_FastReadData		0x0B
+#define W25X_FastReadDual		0x3B
+#define W25X_PageProgram		0x02
+#define W25X_BlockErase			0xD8
+#define W25X_SectorErase		0x20
+#define W25X_ChipErase			0xC7
+#define W25X_PowerDown			0xB9
+#define W25X_ReleasePowerDown	0xAB
+#define W25X_DeviceID			0xAB
+#define W25X_ManufactDeviceID	0x90
+#define W25X_JedecDeviceID		0x9F
+
+typedef void (*W25QXX_Callback)(void);
+
+void W25QXX_Init(void);
+u16  W25QXX_ReadID(void);  	    		//ȡFLASH ID
+u8	 W25QXX_ReadSR(void);        		//ȡ״̬Ĵ
+void W25QXX_Write_Enable(void);  		//дʹ
+void W25QXX_Read(u8* pBuffer,u32 ReadAddr,u16 NumByteToRead);   //ȡflash
+void W25QXX_Write_Page(u8* pBuffer,u32 WriteAddr,u16 NumByteToWrite);	//дһҳ (Ѳ)ȱ
+void W25QXX_Erase_Sector(u32 Dst_Addr);	//
+void W25QXX_Erase_Sector_Start(u32 Dst_Addr);	// ȴ
+u8   W25QXX_Busy(void);					//1:ڲ/
+void W25QXX_Wait_Busy(void);           	//ȴ
+
+void W25QXX_Read_DMA(u8* pBuffer,u32 ReadAddr,u16 NumByteToRead,W25QXX_Callback cb);
+void W25QXX_Write_Page_DMA(u8* pBuffer,u32 WriteAddr,u16 NumByteToWrite,W25QXX_Callback cb);	//ܿҳ
+u8   W25QXX_DMA_Busy(void);				//1:DMA û
+#endif
@@ -27,7 +27,7 @@
 //4,޸EN_USART1_RXʹܷʽ
 ////////////////////////////////////////////////////////////////////////////////// 	
 #define USART_REC_LEN  			200  	//ֽ 200
-#define EN_USART1_RX 			1		//ʹܣ1/ֹ01 
+#define EN_USART1_RX 			0		//ʹܣ1/ֹ01  (USART1  SBUS ˣserial_bus.c ж)
 	  	
 extern u8  USART_RX_BUF[USART_REC_LEN]; //ջ,USART_REC_LENֽ.ĩֽΪз 
 extern u16 USART_RX_STA;         		//״̬	
@@ -0,0 +1,49 @@
+/* HID õ    (hid_test.c )
+	Extreme 3D ProLogitech ҡ (046D:C215)  Input ֣7 ֽڱ棬û Report ID
+		X/Y 10 λñ 4 λ (0~78 û)Rz 8 λ 1~8Slider 8 λ 9~124 λ
+		ԭ Logitech_Decode λ ֹ
+			X  = (d[1]&3)<<8 | d[0]		Y = (d[2]&0x0F)<<6 | d[1]>>2		Hat = d[2]>>4
+			Rz = d[3]		 = d[6]<<8 | d[4]		Slider = d[5]
+	12 λ꣺ Report ID 25  + 3 λ䣬X/Y 12 λзţ 8 λзţ
+		ԭ MOUSE_Decode ϵ "6 ֽ" һ (data[3]<<4|data[2]>>4 Ǹ Y)
+	boot /   usbh_hid_parser.c  (HID_Boot_Keyboard_Desc / HID_Boot_Mouse_Desc)
+*/
+#ifndef __HID_FIXTURES_H
+#define __HID_FIXTURES_H
+#include <stdint.h>
+
+static const uint8_t Extreme3D_Desc[]={
+	0x05,0x01,0x09,0x04,0xA1,0x01,0xA1,0x02,
+	0x75,0x0A,0x95,0x02,0x15,0x00,0x26,0xFF,0x03,0x35,0x00,0x46,0xFF,0x03,0x09,0x30,0x09,0x31,0x81,0x02,	//X Y
+	0x75,0x04,0x95,0x01,0x25,0x07,0x46,0x3B,0x01,0x66,0x14,0x00,0x09,0x39,0x81,0x42,					//ñ (Null State)
+	0x66,0x00,0x00,0x75,0x08,0x95,0x01,0x26,0xFF,0x00,0x46,0xFF,0x00,0x09,0x35,0x81,0x02,				//Rz
+	0x05,0x09,0x19,0x01,0x29,0x08,0x15,0x00,0x25,0x01,0x35,0x00,0x45,0x01,0x75,0x01,0x95,0x08,0x81,0x02,// 1~8
+	0x05,0x01,0x09,0x36,0x26,0xFF,0x00,0x75,0x08,0x95,0x01,0x81,0x02,									//Slider
+	0x05,0x09,0x19,0x09,0x29,0x0C,0x25,0x01,0x75,0x01,0x95,0x04,0x81,0x02,								// 9~12
+	0x75,0x04,0x95,0x01,0x81,0x01,																		//
+	0xC0,
+	0xA1,0x02,0x06,0x00,0xFF,0x15,0x00,0x26,0xFF,0x00,0x75,0x08,0x95,0x04,0x09,0x01,0xB1,0x02,0xC0,	// Feature ()
+	0xC0};
+
+//ҡ Сñû (8)Slider 
+static const uint8_t Extreme3D_Center[7]={0x00,0x02,0x88,0x80,0x00,0xFF,0x00};
+
+static const uint8_t Mouse12_Desc[]={
+	0x05,0x01,0x09,0x02,0xA1,0x01,0x85,0x02,0x09,0x01,0xA1,0x00,
+	0x05,0x09,0x19,0x01,0x29,0x05,0x15,0x00,0x25,0x01,0x95,0x05,0x75,0x01,0x81,0x02,0x95,0x01,0x75,0x03,0x81,0x01,
+	0x05,0x01,0x16,0x01,0xF8,0x26,0xFF,0x07,0x75,0x0C,0x95,0x02,0x09,0x30,0x09,0x31,0x81,0x06,
+	0x15,0x81,0x25,0x7F,0x75,0x08,0x95,0x01,0x09,0x38,0x81,0x06,0xC0,0xC0};
+
+//ID 2ҼX=-300 Y=+1000 -1
+static const uint8_t Mouse12_Report[6]={0x02,0x03,0xD4,0x8E,0x3E,0xFF};
+
+//boot ꣺м + X=-2 Y=+3
+static const uint8_t Boot_Mouse_Report[3]={0x05,0xFE,0x03};
+
+//boot ̣ Shift +  Alt (0x22) a b
+static const uint8_t Boot_Keyboard_Report[8]={0x22,0x00,0x04,0x05,0x00,0x00,0x00,0x00};
+
+//boot  ̫ (Error Roll Over 0x01)
+static const uint8_t Boot_Keyboard_Rollover[8]={0x02,0x00,0x01,0x01,0x01,0x01,0x01,0x01};
+
+#endif
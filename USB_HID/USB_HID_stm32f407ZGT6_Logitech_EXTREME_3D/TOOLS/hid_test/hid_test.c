@@ -0,0 +1,282 @@
+/* HID  /ȡֵ  (УƬ)
+	ֱӱ USB/.../Class/HID/src/usbh_hid_parser.cͱ  hid_fixtures.h
+		Extreme 3D ProX/Y ȫ 1024 ֵñ 0~8Rz/Slider ȫ 256 ֵ12 
+			ԭ Logitech_Decode ֹλ  (һ 0~HID_AXIS_MAX 1)
+		boot ̣μ롢Error Roll Overboot ꣺з X/Y
+		12 λ (Report ID 2)з 12 λ ID  ض̵ı ֶ Ҳϴελƣ
+			걨   Report ID ʱ λܺ ֻ걨ģ
+		Push/Pop (Simulation ҳ)4 ñֶα  skipped
+		 ض/Ļ   棺Խ ( -fsanitize=address )ֶηŵλöԡ/ñ Χ
+
+	룺gcc -O2 -I ../../../../COMMON/TOOLS -I stub -I ../../USB/STM32_USB_HOST_Library/Class/HID/inc -o hid_test hid_test.c
+	÷hid_test []   Ĭ 100000ȫͨ 0򷵻 1 ӡ 
+*/
+#include "test_common.h"
+#include "../../USB/STM32_USB_HOST_Library/Class/HID/src/usbh_hid_parser.c"
+#include "hid_fixtures.h"
+
+//raw (0~max) һ 0~HID_AXIS_MAX ľȷֵ ()
+static uint32_t Axis_Want(uint32_t raw,uint32_t max)
+{
+	return (raw*HID_AXIS_MAX+max/2)/max;
+}
+
+static int Axis_Ok(uint16_t v,uint32_t raw,uint32_t max)
+{
+	return abs((int)v-(int)Axis_Want(raw,max))<=1&&(raw!=0||v==0)&&(raw!=max||v==HID_AXIS_MAX);
+}
+
+static void Test_Extreme3D(void)
+{
+	HID_Map_TypeDef m;
+	HID_Input_TypeDef in;
+	uint8_t d[7];
+	uint32_t x,y,hat,rz,sl,b;
+	uint32_t oX,oY,oH,oRz,oS,oB;
+
+	CHECK(HID_Parse(Extreme3D_Desc,sizeof(Extreme3D_Desc),&m)==7,"Extreme 3D ֶ %u ӦΪ 7",m.num);
+	CHECK(!m.has_id&&!m.skipped,"Extreme 3D  Report ID/ֶ");
+
+	memset(&in,0,sizeof(in));
+	HID_Extract(&m,Extreme3D_Center,sizeof(Extreme3D_Center),&in);
+	CHECK(Axis_Ok(in.axis[HID_AXIS_X],512,1023)&&Axis_Ok(in.axis[HID_AXIS_Y],512,1023)," X/Y %u %u",in.axis[0],in.axis[1]);
+	CHECK(in.hat==HID_HAT_NULL&&in.axis[HID_AXIS_SLIDER]==HID_AXIS_MAX&&in.button==0," ñ/Slider/ ");
+
+	for(x=0;x<1024;x++)
+	{
+		y=1023-x;
+		hat=x%9;
+		rz=x&255;
+		sl=(x*7)&255;
+		b=(x*37)&0xFFF;
+		d[0]=x;
+		d[1]=(x>>8)|(y<<2);
+		d[2]=(y>>6)|(hat<<4);
+		d[3]=rz;
+		d[4]=b;
+		d[5]=sl;
+		d[6]=b>>8;
+		HID_Extract(&m,d,sizeof(d),&in);
+		//ԭ Logitech_Decode Ĳ
+		oX=((d[1]&0x03)<<8)|d[0];
+		oY=((d[2]&0x0F)<<6)|(d[1]>>2);
+		oH=d[2]>>4;
+		oRz=d[3];
+		oS=d[5];
+		oB=(d[6]<<8|d[4])&0xFFF;
+		CHECK(Axis_Ok(in.axis[HID_AXIS_X],oX,1023)&&Axis_Ok(in.axis[HID_AXIS_Y],oY,1023),
+			"X/Y %u/%u ȡ %u/%u",oX,oY,in.axis[HID_AXIS_X],in.axis[HID_AXIS_Y]);
+		CHECK(Axis_Ok(in.axis[HID_AXIS_RZ],oRz,255)&&Axis_Ok(in.axis[HID_AXIS_SLIDER],oS,255),
+			"Rz/Slider %u/%u ȡ %u/%u",oRz,oS,in.axis[HID_AXIS_RZ],in.axis[HID_AXIS_SLIDER]);
+		CHECK(in.hat==(oH<8?oH:HID_HAT_NULL)&&in.button==oB,"ñ %u  %03X ȡ %u %03X",oH,oB,in.hat,in.button);
+		if(Fail)return;
+	}
+
+	//ˣֶ ԭֵ
+	in.button=0x5A5;
+	d[0]=0;
+	d[1]=0;
+	HID_Extract(&m,d,3,&in);
+	CHECK(in.axis[HID_AXIS_X]==0&&in.button==0x5A5,"ض̵ı ˺ֶ");
+}
+
+static void Test_Boot(void)
+{
+	HID_Map_TypeDef m;
+	HID_Input_TypeDef in;
+
+	memset(&in,0,sizeof(in));
+	CHECK(HID_Parse(HID_Boot_Keyboard_Desc,sizeof(HID_Boot_Keyboard_Desc),&m)==1+HID_KEY_NUM,"boot  ֶ %u",m.num);
+	HID_Extract(&m,Boot_Keyboard_Report,sizeof(Boot_Keyboard_Report),&in);
+	CHECK(in.modifier==0x22&&in.key[0]==0x04&&in.key[1]==0x05&&in.key[2]==0,"boot  %02X %02X %02X",in.modifier,in.key[0],in.key[1]);
+	HID_Extract(&m,Boot_Keyboard_Rollover,sizeof(Boot_Keyboard_Rollover),&in);
+	CHECK(in.modifier==0x02&&in.key[0]==0x01&&in.key[5]==0x01,"boot  Error Roll Over ԭ");
+
+	memset(&in,0,sizeof(in));
+	CHECK(HID_Parse(HID_Boot_Mouse_Desc,sizeof(HID_Boot_Mouse_Desc),&m)==3,"boot  ֶ %u",m.num);
+	HID_Extract(&m,Boot_Mouse_Report,sizeof(Boot_Mouse_Report),&in);
+	CHECK(in.button==0x05&&in.rel[HID_AXIS_X]==-2&&in.rel[HID_AXIS_Y]==3,"boot  %X %d %d",in.button,in.rel[0],in.rel[1]);
+}
+
+static void Test_Mouse12(void)
+{
+	HID_Map_TypeDef m;
+	HID_Input_TypeDef in;
+	uint8_t r[6];
+	int x,y;
+
+	memset(&in,0,sizeof(in));
+	CHECK(HID_Parse(Mouse12_Desc,sizeof(Mouse12_Desc),&m)==4&&m.has_id,"12 λ ֶ %u",m.num);
+	HID_Extract(&m,Mouse12_Report,sizeof(Mouse12_Report),&in);
+	CHECK(in.report_id==2&&in.button==0x03&&in.rel[HID_AXIS_X]==-300&&in.rel[HID_AXIS_Y]==1000&&in.rel[HID_AXIS_WHEEL]==-1,
+		"12 λ %X %d %d %d",in.button,in.rel[0],in.rel[1],in.rel[HID_AXIS_WHEEL]);
+
+	for(x=-2047;x<=2047;x+=13)
+	{
+		y=-x/2;
+		r[0]=2;
+		r[1]=0x10;
+		r[2]=(unsigned)x;
+		r[3]=(((unsigned)x>>8)&0x0F)|((unsigned)y<<4);
+		r[4]=(unsigned)y>>4;
+		r[5]=0;
+		HID_Extract(&m,r,sizeof(r),&in);
+		//ԭ 6 ֽ Y = data[3]<<4|data[2]>>4 (data  ID)
+		CHECK(in.rel[HID_AXIS_X]==x&&in.rel[HID_AXIS_Y]==y&&(((r[4]<<4|r[3]>>4)^y)&0xFFF)==0,"12 λ X %d Y %d ȡ %d %d",x,y,in.rel[0],in.rel[1]);
+	}
+
+	memcpy(r,Mouse12_Report,sizeof(r));
+	r[0]=3;
+	r[1]=0x1F;
+	HID_Extract(&m,r,sizeof(r),&in);
+	CHECK(in.report_id==3&&in.button==0x10," Report ID ֶ");
+	CHECK(!in.rel[HID_AXIS_X]&&!in.rel[HID_AXIS_Y]&&!in.rel[HID_AXIS_WHEEL]," Report ID ϴελ %d %d %d",in.rel[0],in.rel[1],in.rel[HID_AXIS_WHEEL]);
+	HID_Extract(&m,Mouse12_Report,sizeof(Mouse12_Report),&in);
+	HID_Extract(&m,r,0,&in);
+	CHECK(in.button==0x03,"ձ ֶ");
+	CHECK(!in.rel[HID_AXIS_X]&&!in.rel[HID_AXIS_Y]&&!in.rel[HID_AXIS_WHEEL],"ձ ϴελ");
+	HID_Extract(&m,Mouse12_Report,sizeof(Mouse12_Report),&in);
+	HID_Extract(&m,Mouse12_Report,3,&in);
+	CHECK(!in.rel[HID_AXIS_X]&&!in.rel[HID_AXIS_Y]&&!in.rel[HID_AXIS_WHEEL],"ض̵ı ϴελ %d %d %d",in.rel[0],in.rel[1],in.rel[HID_AXIS_WHEEL]);
+}
+
+//걨 м  Report ID (ý ֮)λ  MOUSE_Decode  ÿһΣܺ ֻ걨
+static void Test_Mouse12_Mixed(uint32_t n)
+{
+	HID_Map_TypeDef m;
+	HID_Input_TypeDef in;
+	uint8_t r[6];
+	int x,y,sx=0,sy=0,gx=0,gy=0;
+
+	memset(&in,0,sizeof(in));
+	HID_Parse(Mouse12_Desc,sizeof(Mouse12_Desc),&m);
+	while(n--&&!Fail)
+	{
+		if(Rand()%3)
+		{
+			x=(int)(Rand()%41)-20;
+			y=(int)(Rand()%41)-20;
+			sx+=x;
+			sy+=y;
+			r[0]=2;
+			r[1]=0;
+			r[2]=(unsigned)x;
+			r[3]=(((unsigned)x>>8)&0x0F)|((unsigned)y<<4);
+			r[4]=(unsigned)y>>4;
+			r[5]=0;
+			HID_Extract(&m,r,sizeof(r),&in);
+		}
+		else
+		{
+			r[0]=3+Rand()%3;			//ý 棺ID 3~5 2 ֽ ÷
+			r[1]=Rand();
+			r[2]=Rand();
+			HID_Extract(&m,r,1+Rand()%3,&in);
+		}
+		gx+=in.rel[HID_AXIS_X];
+		gy+=in.rel[HID_AXIS_Y];
+		CHECK(gx==sx&&gy==sy,"űı  (%d,%d) ӦΪ (%d,%d)",gx,gy,sx,sy);
+	}
+}
+
+//Push/Popš4 ñֶα
+static void Test_Items(void)
+{
+	static const uint8_t desc[]={
+		0x05,0x01,0x09,0x04,0xA1,0x01,
+		0xFE,0x02,0x55,0xAA,0x55,							// ֽ
+		0x15,0x00,0x26,0xFF,0x00,0x75,0x08,0x95,0x01,
+		0xA4,												//Push
+		0x15,0x81,0x25,0x7F,0x09,0x30,0x81,0x02,			//X з
+		0xB4,												//Popص 0~255
+		0x05,0x02,0x09,0xBB,0x81,0x02,						// -> Slider
+		0x05,0x01,0x15,0x00,0x25,0x03,0x75,0x04,0x09,0x39,0x81,0x42,	//4 ñ
+		0x75,0x04,0x81,0x01,
+		0xC0};
+	HID_Map_TypeDef m;
+	HID_Input_TypeDef in;
+	uint8_t r[3]={0x81,0x40,0x02},big[10+(HID_MAX_FIELD+4)*4],i;
+	uint16_t n;
+
+	memset(&in,0,sizeof(in));
+	CHECK(HID_Parse(desc,sizeof(desc),&m)==3,"Push/Pop  ֶ %u",m.num);
+	HID_Extract(&m,r,sizeof(r),&in);
+	CHECK(in.axis[HID_AXIS_X]==0&&Axis_Ok(in.axis[HID_AXIS_SLIDER],0x40,255),"Push/Pop Χ %u %u",in.axis[0],in.axis[HID_AXIS_SLIDER]);
+	CHECK(in.hat==4,"4 ñ 2 ӦΪ 4 ()ȡ %u",in.hat);
+	r[2]=0x04;
+	HID_Extract(&m,r,sizeof(r),&in);
+	CHECK(in.hat==HID_HAT_NULL,"4 ñ Χ ӦΪû");
+
+	//HID_MAX_FIELD+4  8 λ X ᣬֻܷ HID_MAX_FIELD 
+	memcpy(big,(const uint8_t[]){0x05,0x01,0x15,0x00,0x25,0x7F,0x75,0x08,0x95,0x01},10);
+	n=10;
+	for(i=0;i<HID_MAX_FIELD+4;i++)
+	{
+		big[n++]=0x09;big[n++]=0x30;big[n++]=0x81;big[n++]=0x02;
+	}
+	CHECK(HID_Parse(big,10,&m)==0,"û Input  ֶ 0");
+	CHECK(HID_Parse(big,n,&m)==HID_MAX_FIELD&&m.skipped==4,"ֶα %u  %u",m.num,m.skipped);
+}
+
+//ֶ ŵλ  HID_Input_TypeDef 
+static int Field_Ok(const HID_Field_TypeDef *f)
+{
+	if(f->size<1||f->size>32)return 0;
+	switch(f->type)
+	{
+		case HID_FIELD_AXIS:
+		case HID_FIELD_REL:			return f->index<HID_AXIS_NUM;
+		case HID_FIELD_BUTTON:		return f->index+f->size<=32;
+		case HID_FIELD_MODIFIER:	return f->index+f->size<=8;
+		case HID_FIELD_HAT:			return f->index==0;
+		case HID_FIELD_KEY:			return f->index<HID_KEY_NUM;
+		default:					return 0;
+	}
+}
+
+//ض/Ļ (Ҳ l ֽ)
+static void Test_Random(uint32_t n)
+{
+	static const uint8_t *const desc[]={Extreme3D_Desc,Mouse12_Desc,HID_Boot_Keyboard_Desc,HID_Boot_Mouse_Desc};
+	static const uint16_t len[]={sizeof(Extreme3D_Desc),sizeof(Mouse12_Desc),sizeof(HID_Boot_Keyboard_Desc),sizeof(HID_Boot_Mouse_Desc)};
+	HID_Map_TypeDef m;
+	HID_Input_TypeDef in;
+	uint8_t *d,*r;
+	uint16_t l,i,k;
+	uint32_t t;
+
+	memset(&in,0,sizeof(in));
+	for(t=0;t<n;t++)
+	{
+		k=Rand()%4;
+		l=Rand()%(len[k]+1);
+		d=malloc(l?l:1);						// l ֽڣԽ asan ץ
+		memcpy(d,desc[k],l);
+		for(i=Rand()%4;i&&l;i--)d[Rand()%l]=Rand();
+		HID_Parse(d,l,&m);
+		CHECK(m.num<=HID_MAX_FIELD,"ֶ %u ",m.num);
+		for(i=0;i<m.num;i++)
+			CHECK(Field_Ok(&m.field[i])," %u  ֶ %u  %u С %u ± %u ",t,i,m.field[i].type,m.field[i].size,m.field[i].index);
+		l=Rand()%65;
+		r=malloc(l?l:1);
+		for(i=0;i<l;i++)r[i]=Rand();
+		HID_Extract(&m,r,l,&in);
+		free(r);
+		for(i=0;i<HID_AXIS_NUM;i++)CHECK(in.axis[i]<=HID_AXIS_MAX," ");
+		CHECK(in.hat<8||in.hat==HID_HAT_NULL,"ñ %u Χ",in.hat);
+		free(d);
+		if(Fail)return;
+	}
+}
+
+int main(int argc,char *argv[])
+{
+	uint32_t n=argc>1?strtoul(argv[1],0,0):100000;
+	Test_Extreme3D();
+	Test_Boot();
+	Test_Mouse12();
+	Test_Mouse12_Mixed(n);
+	Test_Items();
+	Test_Random(n);
+	return Test_Done();
+}
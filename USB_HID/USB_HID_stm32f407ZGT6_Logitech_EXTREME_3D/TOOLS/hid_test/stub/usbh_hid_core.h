@@ -0,0 +1,35 @@
+/* ϱãֻ usbh_hid_parser.c õ  /ǩ ( usbh_hid_core.h һ) */
+#ifndef __USBH_HID_CORE_H
+#define __USBH_HID_CORE_H
+
+#define  HID_ITEM_LONG                              0xFEU
+
+#define  HID_ITEM_TYPE_MAIN                         0x00U
+#define  HID_ITEM_TYPE_GLOBAL                       0x01U
+#define  HID_ITEM_TYPE_LOCAL                        0x02U
+#define  HID_ITEM_TYPE_RESERVED                     0x03U
+
+#define  HID_MAIN_ITEM_TAG_INPUT                    0x08U
+#define  HID_MAIN_ITEM_TAG_OUTPUT                   0x09U
+#define  HID_MAIN_ITEM_TAG_COLLECTION               0x0AU
+#define  HID_MAIN_ITEM_TAG_FEATURE                  0x0BU
+#define  HID_MAIN_ITEM_TAG_ENDCOLLECTION            0x0CU
+
+#define  HID_GLOBAL_ITEM_TAG_USAGE_PAGE             0x00U
+#define  HID_GLOBAL_ITEM_TAG_LOG_MIN                0x01U
+#define  HID_GLOBAL_ITEM_TAG_LOG_MAX                0x02U
+#define  HID_GLOBAL_ITEM_TAG_PHY_MIN                0x03U
+#define  HID_GLOBAL_ITEM_TAG_PHY_MAX                0x04U
+#define  HID_GLOBAL_ITEM_TAG_UNIT_EXPONENT          0x05U
+#define  HID_GLOBAL_ITEM_TAG_UNIT                   0x06U
+#define  HID_GLOBAL_ITEM_TAG_REPORT_SIZE            0x07U
+#define  HID_GLOBAL_ITEM_TAG_REPORT_ID              0x08U
+#define  HID_GLOBAL_ITEM_TAG_REPORT_COUNT           0x09U
+#define  HID_GLOBAL_ITEM_TAG_PUSH                   0x0AU
+#define  HID_GLOBAL_ITEM_TAG_POP                    0x0BU
+
+#define  HID_LOCAL_ITEM_TAG_USAGE                   0x00U
+#define  HID_LOCAL_ITEM_TAG_USAGE_MIN               0x01U
+#define  HID_LOCAL_ITEM_TAG_USAGE_MAX               0x02U
+
+#endif
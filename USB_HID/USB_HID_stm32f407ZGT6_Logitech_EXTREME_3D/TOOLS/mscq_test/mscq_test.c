@@ -0,0 +1,181 @@
+/* U д + FatFs ̽ӿ  (УƬ)
+	ֱӱ Class/MSC/src µ usbh_msc_queue.c  usbh_msc_fatfs.c MSCQ_RamDisk (һ RAM  U)
+		Уصύ˳ͬ LBA ӵϵƴһ MSCQ_MAX_SECT ķּ
+			 Submit  1MSCQ_Abort ʱ ص Submit ѭ (ŵ)
+		disk_read/disk_write/disk_ioctl /д/˳  վ ֽڱȣ
+			CTRL_SYNC ֮ RAM   վ һ
+			һдһ ˳д/ ÿ ƽֹһ (дϲԤ)
+		һ ε (RAM  ÿ)ŵȫʧܣCTRL_SYNC ȡ
+
+	룺gcc -O2 -I ../../../../COMMON/TOOLS -I stub -I ../../USB/STM32_USB_HOST_Library/Class/MSC/inc -o mscq_test mscq_test.c
+	÷mscq_test []   Ĭ 60000ȫͨ 0򷵻 1 ӡ 
+*/
+#include "test_common.h"
+#include "../../USB/STM32_USB_HOST_Library/Class/MSC/src/usbh_msc_queue.c"
+#include "../../USB/STM32_USB_HOST_Library/Class/MSC/src/usbh_msc_fatfs.c"
+
+#define DISK_SECT		4096
+
+static BYTE Disk[DISK_SECT*MSCQ_SECTOR];		//RAM 
+static BYTE Ref[DISK_SECT*MSCQ_SECTOR];			//վ
+static BYTE Buf[255*MSCQ_SECTOR];
+
+//ص¼ص˳  ctx
+static uint32_t Done_Order[MSCQ_N*2];
+static uint8_t  Done_Status[MSCQ_N*2];
+static uint32_t Done_Num;
+static void Done(void *ctx,uint8_t status)
+{
+	if(Done_Num<MSCQ_N*2)
+	{
+		Done_Order[Done_Num]=(uint32_t)(uintptr_t)ctx;
+		Done_Status[Done_Num]=status;
+	}
+	Done_Num++;
+}
+
+//ʧܻص һ (εʱ ϲԵ) Resubmit_Left Abort Ҳѭ
+static uint32_t Resubmit_Left;
+static void Done_Resubmit(void *ctx,uint8_t status)
+{
+	Done(ctx,status);
+	if(Resubmit_Left)
+	{
+		Resubmit_Left--;
+		MSCQ_Submit(MSCQ_READ,Buf,0,1,Done_Resubmit,(void *)(uintptr_t)99);
+	}
+}
+
+static void Run(void)
+{
+	while(!MSCQ_Idle())MSCQ_Process();
+}
+
+static void Test_Queue(void)
+{
+	uint32_t i;
+
+	MSCQ_RamDisk_Init(Disk,DISK_SECT);
+	MSCQ_Init(&MSCQ_RamDisk);
+
+	//д 0~3 (ƴһ) 10д 4 ( 0~3 ֮Ķһ)
+	for(i=0;i<4*MSCQ_SECTOR;i++)Buf[i]=i/MSCQ_SECTOR+1;
+	MSCQ_Stat_Reset();
+	Done_Num=0;
+	for(i=0;i<4;i++)CHECK(MSCQ_Submit(MSCQ_WRITE,Buf+i*MSCQ_SECTOR,i,1,Done,(void *)(uintptr_t)i)==0,"Ų");
+	MSCQ_Submit(MSCQ_READ,Buf+8*MSCQ_SECTOR,10,1,Done,(void *)(uintptr_t)4);
+	MSCQ_Submit(MSCQ_WRITE,Buf,4,1,Done,(void *)(uintptr_t)5);
+	Run();
+	CHECK(Done_Num==6,"ص %u  ӦΪ 6",Done_Num);
+	for(i=0;i<Done_Num;i++)CHECK(Done_Order[i]==i&&Done_Status[i]==MSCQ_OK," %u ص  %u ״̬ %u",i,Done_Order[i],Done_Status[i]);
+	CHECK(MSCQ_Stat.cmds==3&&MSCQ_Stat.merged==3&&MSCQ_Stat.sectors==6," %u ϲ %u  %u",MSCQ_Stat.cmds,MSCQ_Stat.merged,MSCQ_Stat.sectors);
+	CHECK(Disk[0]==1&&Disk[3*MSCQ_SECTOR]==4&&Disk[4*MSCQ_SECTOR]==1,"дȥĲ");
+
+	//һ  MSCQ_MAX_SECT ּ
+	MSCQ_Stat_Reset();
+	Done_Num=0;
+	MSCQ_Submit(MSCQ_READ,Buf,100,MSCQ_MAX_SECT*2+3,Done,0);
+	Run();
+	CHECK(Done_Num==1&&MSCQ_Stat.cmds==3&&MSCQ_Stat.sectors==MSCQ_MAX_SECT*2+3,"  %u  %u",MSCQ_Stat.cmds,MSCQ_Stat.sectors);
+	CHECK(memcmp(Buf,Disk+100*MSCQ_SECTOR,(MSCQ_MAX_SECT*2+3)*MSCQ_SECTOR)==0," ");
+
+	//
+	for(i=0;i<MSCQ_N;i++)MSCQ_Submit(MSCQ_READ,Buf,i*2,1,0,0);
+	CHECK(MSCQ_Free()==0&&MSCQ_Submit(MSCQ_READ,Buf,0,1,0,0)==1," ");
+	CHECK(MSCQ_Submit(MSCQ_READ,Buf,0,0,0,0)==1,"0  Ҳ");
+	Run();
+
+	//Abortص Submitֻԭ
+	Done_Num=0;
+	Resubmit_Left=MSCQ_N*4;
+	for(i=0;i<MSCQ_N;i++)MSCQ_Submit(MSCQ_READ,Buf,i*2,1,Done_Resubmit,(void *)(uintptr_t)i);
+	MSCQ_Process();							//һ Ѿȥ
+	MSCQ_Abort();
+	CHECK(Done_Num==MSCQ_N,"Abort ص %u  ӦΪ %u",Done_Num,MSCQ_N);
+	for(i=0;i<MSCQ_N;i++)CHECK(Done_Order[i]==i&&Done_Status[i]==MSCQ_FAIL,"Abort  %u ص ",i);
+	CHECK(MSCQ_Free()==0,"صŵ Ӧ ( %u λ)",MSCQ_Free());
+	Done_Num=0;
+	Resubmit_Left=0;
+	Run();
+	CHECK(Done_Num==MSCQ_N&&Done_Order[0]==99&&Done_Status[0]==MSCQ_OK,"ŵ û");
+}
+
+static void Test_Disk(uint32_t n)
+{
+	uint32_t it,i,k,s,c,q;
+	DWORD cap;
+	WORD ss;
+
+	for(i=0;i<sizeof(Disk);i++)Disk[i]=Ref[i]=Rand();
+	MSCQ_RamDisk_Init(Disk,DISK_SECT);
+	MSCQ_Init(&MSCQ_RamDisk);
+	CHECK(disk_initialize(0)==0,"disk_initialize ʧ");
+	CHECK(disk_ioctl(0,GET_SECTOR_COUNT,&cap)==RES_OK&&cap==DISK_SECT," %u",cap);
+	CHECK(disk_ioctl(0,GET_SECTOR_SIZE,&ss)==RES_OK&&ss==MSCQ_SECTOR,"С %u",ss);
+	CHECK(disk_read(0,Buf,0,0)==RES_PARERR&&disk_read(1,Buf,0,1)==RES_PARERR," û");
+
+	for(it=0;it<n&&!Fail;it++)
+	{
+		s=Rand()%(DISK_SECT-255);
+		c=1+Rand()%(Rand()%4==0?255:8);
+		switch(Rand()%3)
+		{
+			case 0:
+				for(i=0;i<c*MSCQ_SECTOR;i++)Buf[i]=Rand();
+				CHECK(disk_write(0,Buf,s,c)==RES_OK,"д %u+%u ʧ",s,c);
+				memcpy(Ref+s*MSCQ_SECTOR,Buf,c*MSCQ_SECTOR);
+				break;
+			case 1:
+				CHECK(disk_read(0,Buf,s,c)==RES_OK," %u+%u ʧ",s,c);
+				CHECK(memcmp(Buf,Ref+s*MSCQ_SECTOR,c*MSCQ_SECTOR)==0," %u   %u+%u ",it,s,c);
+				break;
+			default:								//˳һ (Ԥ)
+				for(k=0,q=s;k<20&&q+c<DISK_SECT;k++,q+=c)
+				{
+					CHECK(disk_read(0,Buf,q,c)==RES_OK,"˳ %u+%u ʧ",q,c);
+					CHECK(memcmp(Buf,Ref+q*MSCQ_SECTOR,c*MSCQ_SECTOR)==0," %u  ˳ %u+%u ",it,q,c);
+				}
+				break;
+		}
+		if(Rand()%50==0)
+		{
+			CHECK(disk_ioctl(0,CTRL_SYNC,0)==RES_OK,"CTRL_SYNC ʧ");
+			CHECK(memcmp(Disk,Ref,sizeof(Disk))==0," %u  CTRL_SYNC  RAM  Ͳ һ",it);
+		}
+	}
+	CHECK(disk_ioctl(0,CTRL_SYNC,0)==RES_OK&&memcmp(Disk,Ref,sizeof(Disk))==0," CTRL_SYNC  һ");
+
+	//һһ ˳д/
+	MSCQ_Stat_Reset();
+	for(s=0;s<DISK_SECT;s++)
+	{
+		memset(Buf,s,MSCQ_SECTOR);
+		CHECK(disk_write(0,Buf,s,1)==RES_OK,"˳д %u ʧ",s);
+	}
+	disk_ioctl(0,CTRL_SYNC,0);
+	for(s=0;s<DISK_SECT;s++)CHECK(Disk[s*MSCQ_SECTOR]==(BYTE)s,"˳д %u ",s);
+	CHECK(MSCQ_Stat.cmds*2<MSCQ_Stat.sectors,"һ˳д %u   %u  (ûϲ)",MSCQ_Stat.sectors,MSCQ_Stat.cmds);
+	MSCQ_Stat_Reset();
+	for(s=0;s<DISK_SECT;s++)
+	{
+		CHECK(disk_read(0,Buf,s,1)==RES_OK&&Buf[0]==(BYTE)s,"˳ %u ",s);
+	}
+	CHECK(MSCQ_Stat.cmds*2<MSCQ_Stat.sectors,"һ˳ %u   %u  (ûԤ)",MSCQ_Stat.sectors,MSCQ_Stat.cmds);
+	printf("˳д/ һһΣ%u  %u  ()\n",MSCQ_Stat.sectors,MSCQ_Stat.cmds);
+
+	//д Ͱε
+	memset(Buf,1,MSCQ_SECTOR);
+	CHECK(disk_write(0,Buf,5,1)==RES_OK,"֮ǰ дʧ");
+	MSCQ_RamDisk_Init(0,0);
+	CHECK(disk_ioctl(0,CTRL_SYNC,0)==RES_ERROR,"ε CTRL_SYNC û");
+	CHECK(disk_read(0,Buf,0,1)!=RES_OK&&disk_write(0,Buf,0,1)!=RES_OK,"ε д û");
+	CHECK(MSCQ_Idle()&&(disk_status(0)&STA_NOINIT),"ε û/״̬û");
+}
+
+int main(int argc,char *argv[])
+{
+	uint32_t n=argc>1?strtoul(argv[1],0,0):60000;
+	Test_Queue();
+	Test_Disk(n);
+	return Test_Done();
+}
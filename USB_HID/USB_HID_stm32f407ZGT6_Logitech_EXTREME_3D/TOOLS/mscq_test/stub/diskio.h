@@ -0,0 +1,37 @@
+/* ϱãFatFs diskio.h  usbh_msc_fatfs.c õͺͳ (û FatFs) */
+#ifndef _DISKIO
+#define _DISKIO
+
+typedef unsigned char	BYTE;
+typedef unsigned short	WORD;
+typedef unsigned int	DWORD;
+
+#define _READONLY	0
+#define _USE_IOCTL	1
+
+typedef BYTE	DSTATUS;
+
+typedef enum {
+	RES_OK = 0,
+	RES_ERROR,
+	RES_WRPRT,
+	RES_NOTRDY,
+	RES_PARERR
+} DRESULT;
+
+DSTATUS disk_initialize (BYTE);
+DSTATUS disk_status (BYTE);
+DRESULT disk_read (BYTE, BYTE*, DWORD, BYTE);
+DRESULT disk_write (BYTE, const BYTE*, DWORD, BYTE);
+DRESULT disk_ioctl (BYTE, BYTE, void*);
+
+#define STA_NOINIT		0x01
+#define STA_NODISK		0x02
+#define STA_PROTECT		0x04
+
+#define CTRL_SYNC			0
+#define GET_SECTOR_COUNT	1
+#define GET_SECTOR_SIZE		2
+#define GET_BLOCK_SIZE		3
+
+#endif
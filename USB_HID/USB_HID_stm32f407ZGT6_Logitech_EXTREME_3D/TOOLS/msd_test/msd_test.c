@@ -0,0 +1,496 @@
+/* U (ӻ MSC) SCSI ˮ + USBD_MSC_MediaDone  (УƬ)
+	ֱӱ usbd_msc_bot.c / usbd_msc_scsi.c / usbd_msc_data.c  USB_APP µ usbd_storage_msd.c
+	W25Q128  OTG ˵ ڴļٵģDMAдUSB շ ʱֻԳ  
+	(DMA ж  OTG ж ͬһȼһֻһ)
+		  READ10/WRITE10 (ġ4K )  վ ֽڱȣ
+			дػ flash  վ һǰ һҳһ DMA ҳ
+		ÿ һ CSWtag ԡPASSEDresidue 0CSW ֮ ˵ϲж
+		MSC_BOT_Data 룺USB շ   DMA ڶд ͬһ飻
+		д USB   ȷʵͬʱ (ˮ)
+		READ10 һ λǿ֮ǰ  NOT_READYԺ ճ
+		 ŵ USBD_MSC_MediaDone  RAM ʣʧܣCSW  FAILEDֻһΣճ
+		ֻ Read/Write  ͬ Ҳճ
+
+	룺gcc -O2 -I ../../../../COMMON/TOOLS -I stub -I ../../USB/STM32_USB_Device_Library/Class/msc/inc -I ../../USB/STM32_USB_Device_Library/Core/inc
+			-I ../../USB/USB_APP -I ../../HARDWARE/W25QXX -o msd_test msd_test.c
+	÷msd_test []   Ĭ 3000 ȫͨ 0򷵻 1 ӡ 
+*/
+#include "test_common.h"
+#include "../../USB/STM32_USB_Device_Library/Class/msc/src/usbd_msc_bot.c"
+#include "../../USB/STM32_USB_Device_Library/Class/msc/src/usbd_msc_scsi.c"
+#include "../../USB/STM32_USB_Device_Library/Class/msc/src/usbd_msc_data.c"
+#include "../../USB/USB_APP/usbd_storage_msd.c"
+
+#define FLASH_SIZE		(16*1024*1024)
+#define TEST_BLK		4096				//ֻǰ 2M 
+#define MAX_BLK			64					//һ 32K
+#define BIG_LEN			(MSC_MEDIA_PACKET*2)
+
+#define KIND_FLASH		0					//W25Q128 (usbd_storage_msd.c)
+#define KIND_ASYNC		1					//RAMReadStart/WriteStart USBD_MSC_MediaDone
+#define KIND_SYNC		2					//RAMֻ Read/Write
+
+static u8  Flash[FLASH_SIZE];
+static u8  Ref[TEST_BLK*512];				//վ (KIND_FLASH)
+static u8  Host_Buf[MAX_BLK*512];
+u16 W25QXX_TYPE=W25Q128;
+
+static u8  Kind=KIND_FLASH;
+static u32 Fail_Rate=0;						//KIND_ASYNC1/Fail_Rate Ŀ ʧ
+static u8  Injected;						// пʧ
+static u32 Ms=0;
+
+//Ľʲ (W25Q  DMA RAM ʵһ)
+static u8  Med_Pend=0;
+static u8  *Med_Buf;
+static u32 Med_Addr,Med_Len;
+static u8  Med_Write;
+static W25QXX_Callback Med_Cb;
+static u32 Flash_Busy=0;					/// Ҫ ѭת
+
+//Ķ˵
+USB_OTG_CORE_HANDLE Test_Dev;
+static u8  In_Armed=0,Out_Armed=0,In_Stall=0;
+static u8  *In_Buf,*Out_Buf;
+static u32 In_Len,Out_Len;
+static u16 Out_Count;
+
+//
+static u32 Tag=0;
+static u32 Host_Len,Host_Pos;
+static u8  Csw_Got;
+static MSC_BOT_CSW_TypeDef Csw;
+static u32 Usb_Chunks=0,Usb_Overlap=0;		//дUSB շĿ /   ͬʱ
+
+static int Overlap(u8 *a,u32 an,u8 *b,u32 bn)
+{
+	return a<b+bn&&b<a+an;
+}
+
+//  USB ͬʱͬһ黺
+static void Owner_Check(void)
+{
+	if(Med_Pend&&In_Armed)CHECK(!Overlap(Med_Buf,Med_Len,In_Buf,In_Len),"tag %u   IN ͬʱһ黺",Tag);
+	if(Med_Pend&&Out_Armed)CHECK(!Overlap(Med_Buf,Med_Len,Out_Buf,Out_Len),"tag %u   OUT ͬʱһ黺",Tag);
+}
+
+static void Med_Start(u8 *buf,u32 addr,u32 len,u8 write,W25QXX_Callback cb)
+{
+	CHECK(!Med_Pend,"tag %u  һû ַ",Tag);
+	CHECK(len>0&&addr+len<=FLASH_SIZE,"tag %u  ַ %x  %u ",Tag,addr,len);
+	Med_Pend=1;
+	Med_Buf=buf;
+	Med_Addr=addr;
+	Med_Len=len;
+	Med_Write=write;
+	Med_Cb=cb;
+	Owner_Check();
+}
+
+// W25Q128
+void W25QXX_Init(void)
+{
+}
+
+u8 W25QXX_Busy(void)
+{
+	return Flash_Busy>0;
+}
+
+void W25QXX_Erase_Sector_Start(u32 Dst_Addr)
+{
+	CHECK(!Med_Pend&&!Flash_Busy," %u ʱ оƬ/DMA æ",Dst_Addr);
+	CHECK(Dst_Addr<FLASH_SIZE/W25QXX_SECTOR_SIZE," %u Խ",Dst_Addr);
+	memset(&Flash[Dst_Addr*W25QXX_SECTOR_SIZE],0xFF,W25QXX_SECTOR_SIZE);
+	Flash_Busy=1+Rand()%6;
+}
+
+void W25QXX_Read_DMA(u8* pBuffer,u32 ReadAddr,u16 NumByteToRead,W25QXX_Callback cb)
+{
+	CHECK(!Flash_Busy,"оƬæ ʱ ");
+	Med_Start(pBuffer,ReadAddr,NumByteToRead,0,cb);
+}
+
+void W25QXX_Write_Page_DMA(u8* pBuffer,u32 WriteAddr,u16 NumByteToWrite,W25QXX_Callback cb)
+{
+	CHECK(!Flash_Busy,"оƬæ ʱ ");
+	CHECK(WriteAddr%W25QXX_PAGE_SIZE+NumByteToWrite<=W25QXX_PAGE_SIZE," %x  %u ҳ",WriteAddr,NumByteToWrite);
+	Med_Start(pBuffer,WriteAddr,NumByteToWrite,1,cb);
+}
+
+//RAM  (Flash[]  RAM )
+static int8_t Ram_Init(uint8_t lun)
+{
+	return 0;
+}
+
+static int8_t Ram_GetCapacity(uint8_t lun,uint32_t *block_num,uint32_t *block_size)
+{
+	*block_num=TEST_BLK;
+	*block_size=512;
+	return 0;
+}
+
+static int8_t Ram_IsReady(uint8_t lun)
+{
+	return 0;
+}
+
+static int8_t Ram_IsWriteProtected(uint8_t lun)
+{
+	return 0;
+}
+
+static int8_t Ram_Read(uint8_t lun,uint8_t *buf,uint32_t blk_addr,uint16_t blk_len)
+{
+	memcpy(buf,&Flash[blk_addr*512],blk_len*512);
+	return 0;
+}
+
+static int8_t Ram_Write(uint8_t lun,uint8_t *buf,uint32_t blk_addr,uint16_t blk_len)
+{
+	memcpy(&Flash[blk_addr*512],buf,blk_len*512);
+	return 0;
+}
+
+static int8_t Ram_ReadStart(uint8_t lun,uint8_t *buf,uint32_t blk_addr,uint16_t blk_len)
+{
+	Med_Start(buf,blk_addr*512,blk_len*512,0,0);
+	return 0;
+}
+
+static int8_t Ram_WriteStart(uint8_t lun,uint8_t *buf,uint32_t blk_addr,uint16_t blk_len)
+{
+	Med_Start(buf,blk_addr*512,blk_len*512,1,0);
+	return 0;
+}
+
+static int8_t Ram_GetMaxLun(void)
+{
+	return 0;
+}
+
+static USBD_STORAGE_cb_TypeDef Ram_Async_fops={Ram_Init,Ram_GetCapacity,Ram_IsReady,Ram_IsWriteProtected,0,0,Ram_GetMaxLun,
+											   (int8_t *)MSD_Inquirydata,Ram_ReadStart,Ram_WriteStart};
+static USBD_STORAGE_cb_TypeDef Ram_Sync_fops={Ram_Init,Ram_GetCapacity,Ram_IsReady,Ram_IsWriteProtected,Ram_Read,Ram_Write,Ram_GetMaxLun,
+											  (int8_t *)MSD_Inquirydata,0,0};
+
+// һ (DMA ж)ʱŰᣬ ֮ǰ USB  ͻ/д
+static void Med_Done(void)
+{
+	W25QXX_Callback cb=Med_Cb;
+	u32 i;
+	Med_Pend=0;
+	if(Kind==KIND_ASYNC&&Fail_Rate&&Rand()%Fail_Rate==0)
+	{
+		Injected=1;
+		USBD_MSC_MediaDone(-1);
+		return;
+	}
+	if(!Med_Write)memcpy(Med_Buf,&Flash[Med_Addr],Med_Len);
+	else if(Kind==KIND_FLASH)
+	{
+		for(i=0;i<Med_Len;i++)
+		{
+			if(Flash[Med_Addr+i]!=0xFF)
+			{
+				CHECK(0," %x ǰ û",Med_Addr+i);
+				break;
+			}
+			Flash[Med_Addr+i]&=Med_Buf[i];
+		}
+		Flash_Busy=Rand()%3;
+	}
+	else memcpy(&Flash[Med_Addr],Med_Buf,Med_Len);
+	if(Kind==KIND_FLASH)cb();
+	else USBD_MSC_MediaDone(0);
+}
+
+//USB ʼշһ ʱ ǲҲ
+static void Usb_Chunk(u8 *buf)
+{
+	if(Kind!=KIND_FLASH||Host_Len<BIG_LEN||buf<MSC_BOT_Data||buf>=MSC_BOT_Data+MSC_MEDIA_PACKET*2)return;
+	Usb_Chunks++;
+	if(SCSI_Media_Busy)Usb_Overlap++;
+}
+
+// OTG ˵
+uint32_t DCD_EP_Tx(USB_OTG_CORE_HANDLE *pdev,uint8_t ep_addr,uint8_t *pbuf,uint32_t buf_len)
+{
+	CHECK(ep_addr==MSC_IN_EP,"IN ˵ %x ",ep_addr);
+	CHECK(!In_Armed,"tag %u IN û ַ",Tag);
+	In_Armed=1;
+	In_Buf=pbuf;
+	In_Len=buf_len;
+	Usb_Chunk(pbuf);
+	Owner_Check();
+	return 0;
+}
+
+uint32_t DCD_EP_PrepareRx(USB_OTG_CORE_HANDLE *pdev,uint8_t ep_addr,uint8_t *pbuf,uint16_t buf_len)
+{
+	CHECK(ep_addr==MSC_OUT_EP,"OUT ˵ %x ",ep_addr);
+	CHECK(!Out_Armed,"tag %u OUT û ׼",Tag);
+	Out_Armed=1;
+	Out_Buf=pbuf;
+	Out_Len=buf_len;
+	Usb_Chunk(pbuf);
+	Owner_Check();
+	return 0;
+}
+
+uint32_t DCD_EP_Stall(USB_OTG_CORE_HANDLE *pdev,uint8_t epnum)
+{
+	if(epnum==MSC_IN_EP)In_Stall=1;
+	return 0;
+}
+
+uint32_t DCD_EP_Flush(USB_OTG_CORE_HANDLE *pdev,uint8_t epnum)
+{
+	return 0;
+}
+
+uint16_t USBD_GetRxCount(USB_OTG_CORE_HANDLE *pdev,uint8_t epnum)
+{
+	return Out_Count;
+}
+
+// һ IN (OTG ж)
+static void In_Done(void)
+{
+	In_Armed=0;
+	if(In_Buf==(u8 *)&MSC_BOT_csw)
+	{
+		CHECK(In_Len==BOT_CSW_LENGTH,"CSW  %u",In_Len);
+		CHECK(!Csw_Got,"tag %u  CSW",Tag);
+		Csw=MSC_BOT_csw;
+		Csw_Got=1;
+	}
+	else
+	{
+		CHECK(!Csw_Got,"tag %u CSW ֮ ַ",Tag);
+		CHECK(Host_Pos+In_Len<=Host_Len,"tag %u IN  ",Tag);
+		if(Host_Pos+In_Len<=Host_Len)memcpy(&Host_Buf[Host_Pos],In_Buf,In_Len);
+		Host_Pos+=In_Len;
+	}
+	MSC_BOT_DataIn(&Test_Dev,MSC_IN_EP&0x7F);
+}
+
+// һ OUT (OTG ж)
+static void Out_Done(void)
+{
+	u32 n=Out_Len;
+	CHECK(Host_Pos+n<=Host_Len,"tag %u OUT Ҫ ",Tag);
+	if(Host_Pos+n>Host_Len)n=Host_Len-Host_Pos;
+	memcpy(Out_Buf,&Host_Buf[Host_Pos],n);
+	Host_Pos+=n;
+	Out_Armed=0;
+	Out_Count=n;
+	MSC_BOT_DataOut(&Test_Dev,MSC_OUT_EP);
+}
+
+//ѭ תһ
+static void Main_Loop(void)
+{
+	if(Flash_Busy)Flash_Busy--;
+	Ms+=Rand()%3;
+	if(Kind==KIND_FLASH)MSD_Process(Ms);
+}
+
+// һ
+static void Step(void)
+{
+	u8 can[4],n=0;
+	if(Med_Pend)can[n++]=0;
+	if(In_Armed)can[n++]=1;
+	if(Out_Armed&&Out_Buf!=(u8 *)&MSC_BOT_cbw&&!Csw_Got)can[n++]=2;
+	can[n++]=3;
+	switch(can[Rand()%n])
+	{
+		case 0: Med_Done(); break;
+		case 1: In_Done(); break;
+		case 2: Out_Done(); break;
+		default: Main_Loop(); break;
+	}
+}
+
+static void Send_Cbw(const u8 *cb,u8 cb_len,u32 len,u8 in)
+{
+	MSC_BOT_CBW_TypeDef *c=&MSC_BOT_cbw;
+	CHECK(!In_Armed,"tag %u ֮ IN ϻж",Tag);
+	CHECK(Out_Armed&&Out_Buf==(u8 *)&MSC_BOT_cbw&&Out_Len==BOT_CBW_LENGTH,"tag %u ֮ û׼ CBW",Tag);
+	memset(c,0,sizeof(*c));
+	c->dSignature=BOT_CBW_SIGNATURE;
+	c->dTag=++Tag;
+	c->dDataLength=len;
+	c->bmFlags=in?0x80:0;
+	c->bCBLength=cb_len;
+	memcpy(c->CB,cb,cb_len);
+	Host_Len=len;
+	Host_Pos=0;
+	Csw_Got=0;
+	Injected=0;
+	In_Stall=0;
+	Out_Armed=0;
+	Out_Count=BOT_CBW_LENGTH;
+	MSC_BOT_DataOut(&Test_Dev,MSC_OUT_EP);
+}
+
+// CSWٶת ûжĶ CSW ״̬ס 0xFF
+static u8 Wait_Csw(void)
+{
+	u32 k;
+	for(k=0;k<200000&&!Csw_Got;k++)Step();
+	CHECK(Csw_Got,"tag %u ס û CSW",Tag);
+	if(!Csw_Got)return 0xFF;
+	for(k=0;k<20;k++)Step();
+	CHECK(Csw.dSignature==BOT_CSW_SIGNATURE&&Csw.dTag==Tag,"tag %u CSW ǩ/tag ",Tag);
+	if(Csw.bStatus==CSW_CMD_PASSED)
+		CHECK(Csw.dDataResidue==0&&Host_Pos==Host_Len,"tag %u residue %u  %u/%u",Tag,Csw.dDataResidue,Host_Pos,Host_Len);
+	return Csw.bStatus;
+}
+
+static void Cdb10(u8 *cb,u8 op,u32 lba,u16 n)
+{
+	memset(cb,0,10);
+	cb[0]=op;
+	cb[2]=lba>>24;
+	cb[3]=lba>>16;
+	cb[4]=lba>>8;
+	cb[5]=lba;
+	cb[7]=n>>8;
+	cb[8]=n;
+}
+
+static void Read_Capacity(u32 blk)
+{
+	u8 cb[10]={SCSI_READ_CAPACITY10};
+	u32 last;
+	Send_Cbw(cb,10,8,1);
+	CHECK(Wait_Csw()==CSW_CMD_PASSED,"READ CAPACITY ʧ");
+	last=(u32)Host_Buf[0]<<24|Host_Buf[1]<<16|Host_Buf[2]<<8|Host_Buf[3];
+	CHECK(last==blk-1&&Host_Buf[6]==2&&Host_Buf[7]==0,"READ CAPACITY һ %u",last);
+}
+
+//PASSED Ļ  վ (RAM ʾ Flash[]) 
+static void Read10(u32 lba,u16 n)
+{
+	u8 cb[10];
+	u8 st;
+	const u8 *ref=Kind==KIND_FLASH?&Ref[lba*512]:&Flash[lba*512];
+	Cdb10(cb,SCSI_READ10,lba,n);
+	Send_Cbw(cb,10,n*512,1);
+	st=Wait_Csw();
+	CHECK(st==CSW_CMD_PASSED||(st==CSW_CMD_FAILED&&Injected),"tag %u READ10 %u+%u ״̬ %u",Tag,lba,n,st);
+	CHECK(st!=CSW_CMD_PASSED||!Injected,"tag %u READ10 пʧ  PASSED",Tag);
+	if(st==CSW_CMD_PASSED)CHECK(memcmp(Host_Buf,ref,n*512)==0,"tag %u READ10 %u+%u ",Tag,lba,n);
+}
+
+static void Write10(u32 lba,u16 n)
+{
+	u8 cb[10];
+	u8 st;
+	u32 i;
+	for(i=0;i<n*512;i++)Host_Buf[i]=Rand();
+	Cdb10(cb,SCSI_WRITE10,lba,n);
+	Send_Cbw(cb,10,n*512,0);
+	st=Wait_Csw();
+	CHECK(st==CSW_CMD_PASSED||(st==CSW_CMD_FAILED&&Injected),"tag %u WRITE10 %u+%u ״̬ %u",Tag,lba,n,st);
+	CHECK(st!=CSW_CMD_PASSED||!Injected,"tag %u WRITE10 пʧ  PASSED",Tag);
+	if(st!=CSW_CMD_PASSED)return;
+	if(Kind==KIND_FLASH)memcpy(&Ref[lba*512],Host_Buf,n*512);
+	else CHECK(memcmp(&Flash[lba*512],Host_Buf,n*512)==0,"tag %u WRITE10 %u+%u ûд",Tag,lba,n);
+}
+
+// READ10 һ λ
+static void Reset_Read(void)
+{
+	u8 cb[10]={SCSI_TEST_UNIT_READY};
+	u8 rd[10];
+	u32 k;
+	Cdb10(rd,SCSI_READ10,0,MAX_BLK);
+	Send_Cbw(rd,10,MAX_BLK*512,1);
+	for(k=0;k<200000&&!(Host_Pos>0&&Med_Pend&&SCSI_Media_Busy)&&!Csw_Got;k++)Step();
+	if(Csw_Got)return;
+	In_Armed=0;
+	MSC_BOT_Reset(&Test_Dev);
+	CHECK(SCSI_Media_Busy,"λ ѽæ ");
+	Send_Cbw(cb,6,0,0);
+	CHECK(In_Stall&&!Csw_Got&&SCSI_Sense[(SCSI_Sense_Tail+SENSE_LIST_DEEPTH-1)%SENSE_LIST_DEEPTH].Skey==NOT_READY,
+		  "λ ʻ  û NOT_READY");
+	MSC_BOT_Reset(&Test_Dev);
+	for(k=0;k<200000&&SCSI_Media_Busy;k++)
+	{
+		if(Med_Pend)Med_Done();
+		else Main_Loop();
+	}
+	CHECK(!SCSI_Media_Busy&&!In_Armed,"λ  ǿ û");
+	Send_Cbw(cb,6,0,0);
+	CHECK(Wait_Csw()==CSW_CMD_PASSED,"λ TEST UNIT READY ʧ");
+}
+
+// д / 4K 
+static void Test_Cmds(u32 n,u8 reset)
+{
+	u32 k,lba;
+	u16 cnt;
+	for(k=0;k<n&&!Fail;k++)
+	{
+		if(Rand()%4==0)
+		{
+			lba=Rand()%(TEST_BLK/8)*8;
+			cnt=(1+Rand()%(MAX_BLK/8))*8;
+		}
+		else
+		{
+			lba=Rand()%TEST_BLK;
+			cnt=1+Rand()%MAX_BLK;
+		}
+		if(lba+cnt>TEST_BLK)cnt=TEST_BLK-lba;
+		switch(Rand()%16)
+		{
+			case 0: if(reset){ Reset_Read(); break; }		//⸴λ ͵д
+			case 1: case 2: case 3: case 4: case 5: case 6: case 7: Write10(lba,cnt); break;
+			default: Read10(lba,cnt); break;
+		}
+	}
+}
+
+static void Test_Flash(u32 n)
+{
+	u32 k;
+	Kind=KIND_FLASH;
+	Read_Capacity(MSD_FLASH_SIZE/MSD_BLOCK_SIZE);
+	Test_Cmds(n,1);
+	// дػ
+	Ms+=MSD_FLUSH_MS;
+	for(k=0;k<200000&&!MSD_Idle();k++)Step();
+	CHECK(MSD_Idle()," ûд");
+	MSD_Sync();
+	CHECK(memcmp(&Flash[MSD_FLASH_BASE],Ref,sizeof(Ref))==0,"д֮ flash  վ һ");
+	CHECK(Usb_Overlap*2>=Usb_Chunks,"ˮ ûãд USB շ %u 飬ͬʱ ֻ %u ",Usb_Chunks,Usb_Overlap);
+	CHECK(MSD_Stat.direct_sect&&MSD_Stat.cache_hit&&MSD_Stat.flush,"ֱд %u  %u д %u ûߵ",
+		  MSD_Stat.direct_sect,MSD_Stat.cache_hit,MSD_Stat.flush);
+}
+
+static void Test_Ram(u32 n,USBD_STORAGE_cb_TypeDef *fops,u8 kind,u32 fail_rate)
+{
+	Kind=kind;
+	Fail_Rate=fail_rate;
+	USBD_STORAGE_fops=fops;
+	Read_Capacity(TEST_BLK);
+	Test_Cmds(n,0);
+	Fail_Rate=0;
+}
+
+int main(int argc,char *argv[])
+{
+	u32 n=argc>1?strtoul(argv[1],0,0):3000;
+	memset(Flash,0xFF,sizeof(Flash));
+	memset(Ref,0xFF,sizeof(Ref));
+	MSC_BOT_Init(&Test_Dev);
+	Test_Flash(n);
+	Test_Ram(n,&Ram_Async_fops,KIND_ASYNC,20);
+	Test_Ram(n/4,&Ram_Sync_fops,KIND_SYNC,0);
+	return Test_Done();
+}
@@ -0,0 +1,13 @@
+/* ϱãw25qxx.h / usbd_storage_msd.c õͣж ʲôҲ (Գ жϱͲụ) */
+#ifndef __SYS_H
+#define __SYS_H
+#include <stdint.h>
+
+typedef uint32_t u32;
+typedef uint16_t u16;
+typedef uint8_t  u8;
+
+enum{OTG_FS_IRQn,DMA2_Stream0_IRQn};
+#define NVIC_DisableIRQ(n)
+#define NVIC_EnableIRQ(n)
+#endif
@@ -0,0 +1,15 @@
+/* ϱãU (MSC) õ usbd_conf.h ãϵһ */
+#ifndef __USBD_CONF_H
+#define __USBD_CONF_H
+#include <stdint.h>
+
+#define __ALIGN_BEGIN
+#define __ALIGN_END
+
+#define USBD_CFG_MAX_NUM		1
+#define USBD_ITF_MAX_NUM		1
+#define MSC_IN_EP				0x81
+#define MSC_OUT_EP				0x01
+#define MSC_MAX_PACKET			64
+#define MSC_MEDIA_PACKET		4096
+#endif
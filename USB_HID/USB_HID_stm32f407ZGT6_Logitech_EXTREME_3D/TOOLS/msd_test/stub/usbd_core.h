@@ -0,0 +1,16 @@
+/* ϱãOTG   msd_test.c ļٶ˵ (շ ֻԳ  ) */
+#ifndef __USBD_CORE_H
+#define __USBD_CORE_H
+#include <stdint.h>
+#include "usbd_def.h"
+
+#define MIN(a, b)		(((a) < (b)) ? (a) : (b))
+
+typedef struct{int dummy;}USB_OTG_CORE_HANDLE;
+
+uint32_t DCD_EP_PrepareRx(USB_OTG_CORE_HANDLE *pdev,uint8_t ep_addr,uint8_t *pbuf,uint16_t buf_len);
+uint32_t DCD_EP_Tx(USB_OTG_CORE_HANDLE *pdev,uint8_t ep_addr,uint8_t *pbuf,uint32_t buf_len);
+uint32_t DCD_EP_Stall(USB_OTG_CORE_HANDLE *pdev,uint8_t epnum);
+uint32_t DCD_EP_Flush(USB_OTG_CORE_HANDLE *pdev,uint8_t epnum);
+uint16_t USBD_GetRxCount(USB_OTG_CORE_HANDLE *pdev,uint8_t epnum);
+#endif
@@ -0,0 +1,5 @@
+/* ϱãֻҪ usbd_core.h ļٶ˵ */
+#ifndef __USBD_IOREQ_H
+#define __USBD_IOREQ_H
+#include "usbd_core.h"
+#endif
@@ -0,0 +1,161 @@
+/* SBUS ͨ/  (УƬ)
+	 HARDWARE/Serial-BUS/serial_bus.c (Ĵ ɼ)ԭĸ sbus_8b/sbus_16b/sbus_send ֽڱȽϣ
+		sbus_8b ȫ 256 ֵsbus_16b ȫ 1024 ֵ
+		sbus_us_to_raw + sbus_pack ͨ us 875~3000 ÿֵ 0~16 ͨ ֡
+		sbus_unpack   raw һsbus_raw_to_us  1000~2000  sbus_us_to_raw ķ
+	һ ̼·sbus_push -> 1ms ж -> TX DMA 壬֡  һ
+		RX DMA һ֡ жϣsbus_get õͨ  ʧر־ ԡ
+
+	룺gcc -O2 -Wno-pointer-to-int-cast -I ../../../../COMMON/TOOLS -I stub -I ../../HARDWARE/Serial-BUS -o sbus_test sbus_test.c
+	÷sbus_test [֡]   Ĭ 1000000ȫͨ 0򷵻 1 ӡ һ
+*/
+#include "test_common.h"
+#include "serial_bus.c"
+
+DMA_Stream_TypeDef Fake_DMA2_Stream7,Fake_DMA2_Stream2;
+DMA_TypeDef Fake_DMA2;
+USART_TypeDef Fake_USART1;
+TIM_TypeDef Fake_TIM7;
+
+/*------------------------ ԭĸ (ĳ֮ǰ serial_bus.c) ------------------------*/
+#define OLD_RANGE_MIN		200.0f
+#define OLD_RANGE_MAX		1800.0f
+#define OLD_TARGET_MIN		1000.0f
+#define OLD_TARGET_MAX		2000.0f
+#define OLD_SCALE_FACTOR	((OLD_TARGET_MAX - OLD_TARGET_MIN) / (OLD_RANGE_MAX - OLD_RANGE_MIN))
+#define OLD_SCALE_OFFSET	(int)(OLD_TARGET_MIN - (OLD_SCALE_FACTOR * OLD_RANGE_MIN + 0.5f))
+
+static uint16_t Old_8b(uint8_t num)
+{
+	float val = (num / 255.0f) * 1000.0f;
+	uint16_t sbusval = val + 1000.0f + 0.5f;
+	return sbusval;
+}
+
+static uint16_t Old_16b(uint16_t num)
+{
+	float val = (num / 1023.0f) * 1000.0f;
+	uint16_t sbusval = val + 1000.0f + 0.5f;
+	return sbusval;
+}
+
+//ԭ sbus_send  ȥ֮ǰ ƴ֡Ĳ
+static void Old_Frame(const uint16_t *values, uint8_t num_values, uint8_t *oframe)
+{
+	uint16_t value = 0;
+	uint8_t i, byteindex = 1, offset = 0;
+	memset(oframe, 0, SBUS_FRAME_SIZE);
+	oframe[0] = 0x0f;
+	for (i = 0; (i < num_values) && (i < 16); ++i)
+	{
+		value = (unsigned short)(((values[i] - OLD_SCALE_OFFSET) / OLD_SCALE_FACTOR) + 0.5f);
+		if (value > 0x07ff) value = 0x07ff;
+		while (offset >= 8) { ++byteindex; offset -= 8; }
+		oframe[byteindex] |= (value << (offset)) & 0xff;
+		oframe[byteindex + 1] |= (value >> (8 - offset)) & 0xff;
+		oframe[byteindex + 2] |= (value >> (16 - offset)) & 0xff;
+		offset += 11;
+	}
+}
+/*----------------------------------------------------------------------------------------*/
+
+static void Test_Scale(void)
+{
+	u32 i;
+	uint16_t us,raw;
+	uint8_t a[SBUS_FRAME_SIZE],b[SBUS_FRAME_SIZE];
+	for(i=0;i<256;i++)CHECK(sbus_8b(i)==Old_8b(i),"sbus_8b(%u)=%u ԭ %u",i,sbus_8b(i),Old_8b(i));
+	for(i=0;i<1024;i++)CHECK(sbus_16b(i)==Old_16b(i),"sbus_16b(%u)=%u ԭ %u",i,sbus_16b(i),Old_16b(i));
+	for(i=875;i<=3000;i++)
+	{
+		us=i;
+		raw=sbus_us_to_raw(us);
+		Old_Frame(&us,1,a);
+		sbus_pack(b,&raw,1,0);
+		CHECK(memcmp(a,b,SBUS_FRAME_SIZE)==0,"ͨ %uus ֡һ",i);
+	}
+	for(i=1000;i<=2000;i++)CHECK(sbus_raw_to_us(sbus_us_to_raw(i))==i,"sbus_raw_to_us  %u ",i);
+	CHECK(sbus_axis(0)==1000&&sbus_axis(32768)==1500&&sbus_axis(65535)==2000,"sbus_axis ˵㲻");
+}
+
+static void Test_Frames(u32 times)
+{
+	uint16_t us[SBUS_CH_NUM],raw[SBUS_CH_NUM];
+	uint8_t a[SBUS_FRAME_SIZE],b[SBUS_FRAME_SIZE];
+	SBUS_Frame_TypeDef f;
+	u32 t,i,k;
+	for(t=0;t<times&&!Fail;t++)
+	{
+		k=Rand()%(SBUS_CH_NUM+1);
+		for(i=0;i<SBUS_CH_NUM;i++)
+		{
+			us[i]=Rand()%8?1000+Rand()%1001:875+Rand()%3000;		//ż 1000~2000
+			raw[i]=sbus_us_to_raw(us[i]);
+		}
+		Old_Frame(us,k,a);
+		sbus_pack(b,raw,k,0);
+		CHECK(memcmp(a,b,SBUS_FRAME_SIZE)==0," %u ֡ (%u ͨ) һ",t,k);
+		CHECK(sbus_unpack(b,&f)==0," %u ֡ ⲻ",t);
+		for(i=0;i<SBUS_CH_NUM;i++)CHECK(f.ch[i]==(i<k?raw[i]:0)," %u ֡ ͨ %u ",t,i);
+	}
+}
+
+//ж  1msٶʱ ø±־ ж
+static void Tick(u32 ms)
+{
+	while(ms--)
+	{
+		Fake_TIM7.SR|=TIM_IT_Update;
+		SBUS_TIM_IRQHandler();
+		Fake_DMA2_Stream7.NDTR=0;			//25 ֽ 100kbps  3msһǰ һ
+	}
+}
+
+//̼·Ʊ -> ж  -> TX DMARX DMA -> ж -> sbus_get
+static void Test_Path(void)
+{
+	uint16_t us[SBUS_CH_NUM];
+	uint8_t a[SBUS_FRAME_SIZE];
+	SBUS_Frame_TypeDef f;
+	u32 i,frames;
+
+	USART1_SBUS_Init();
+	for(i=0;i<SBUS_CH_NUM;i++)us[i]=1000+i*61;
+	CHECK(sbus_push(us,SBUS_CH_NUM,0)==0,"sbus_push ʧ");
+	frames=sbus_stat.tx_frames;
+	Tick(SBUS_TX_FAST);
+	CHECK(sbus_stat.tx_frames==frames+1,"˱ %u ms û֡",SBUS_TX_FAST);
+	CHECK(Fake_DMA2_Stream7.M0AR==(uint32_t)(uintptr_t)sbus_tx_buf&&(Fake_DMA2_Stream7.CR&DMA_SxCR_EN),"TX DMA û");
+	Old_Frame(us,SBUS_CH_NUM,a);
+	CHECK(memcmp(a,sbus_tx_buf,SBUS_FRAME_SIZE)==0,"ж ֡  治һ");
+	Tick(SBUS_TX_FAST);
+	CHECK(sbus_stat.tx_frames==frames+2&&sbus_stat.tx_repeat==1,"û± Ӧطһ֡");
+
+	//գ DMA һ֡ÿб־
+	CHECK(sbus_failsafe(),"ûյ֡ Ӧʧ");
+	memcpy(sbus_rx_buf,a,SBUS_FRAME_SIZE);
+	Fake_DMA2_Stream2.NDTR=SBUS_RX_BUF-SBUS_FRAME_SIZE;
+	Fake_USART1.SR=USART_FLAG_IDLE;
+	USART1_IRQHandler();
+	CHECK(sbus_get(&f)==1&&!sbus_failsafe(),"յ֡ sbus_get/sbus_failsafe ");
+	for(i=0;i<SBUS_CH_NUM;i++)CHECK(f.ch[i]==sbus_us_to_raw(us[i]),"յ ͨ %u ",i);
+	CHECK(sbus_get(&f)==0,"ͬһ֡ sbus_get ˵µ");
+	//˰֡㻵֡
+	Fake_DMA2_Stream2.NDTR=SBUS_RX_BUF-10;
+	USART1_IRQHandler();
+	CHECK(sbus_stat.rx_bad==1&&sbus_get(&f)==0,"֡ Ӧ㻵֡");
+	//ʧر־
+	a[23]=SBUS_FLAG_FAILSAFE;
+	memcpy(sbus_rx_buf,a,SBUS_FRAME_SIZE);
+	Fake_DMA2_Stream2.NDTR=SBUS_RX_BUF-SBUS_FRAME_SIZE;
+	USART1_IRQHandler();
+	CHECK(sbus_failsafe()&&sbus_stat.rx_failsafe==1,"ʧ֡ ûнʧ");
+}
+
+int main(int argc,char *argv[])
+{
+	Test_Scale();
+	Test_Frames(argc>1?strtoul(argv[1],0,0):1000000);
+	Test_Path();
+	return Test_Done();
+}
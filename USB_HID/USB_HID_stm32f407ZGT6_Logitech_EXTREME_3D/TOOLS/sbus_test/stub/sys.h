@@ -0,0 +1,76 @@
+/* ϱãserial_bus.c õ F407 Ĵ ڴļ (sbus_test.c ﶨ)
+	⺯ ȫʲôҲ */
+#ifndef __SYS_H
+#define __SYS_H
+#include <stdint.h>
+
+#define STM32F40_41xxx
+
+typedef uint32_t u32;
+typedef uint16_t u16;
+typedef uint8_t  u8;
+
+typedef struct{volatile uint32_t CR,NDTR,PAR,M0AR,M1AR,FCR;}DMA_Stream_TypeDef;
+typedef struct{volatile uint32_t LISR,HISR,LIFCR,HIFCR;}DMA_TypeDef;
+typedef struct{volatile uint32_t SR,DR,BRR,CR1,CR2,CR3;}USART_TypeDef;
+typedef struct{volatile uint32_t CR1,DIER,SR,CNT;}TIM_TypeDef;
+
+extern DMA_Stream_TypeDef Fake_DMA2_Stream7,Fake_DMA2_Stream2;
+extern DMA_TypeDef Fake_DMA2;
+extern USART_TypeDef Fake_USART1;
+extern TIM_TypeDef Fake_TIM7;
+#define DMA2_Stream7		(&Fake_DMA2_Stream7)
+#define DMA2_Stream2		(&Fake_DMA2_Stream2)
+#define DMA2				(&Fake_DMA2)
+#define USART1				(&Fake_USART1)
+#define TIM7				(&Fake_TIM7)
+
+#define DMA_SxCR_EN			0x01
+#define TIM_IT_Update		0x01
+#define USART_FLAG_PE		0x01
+#define USART_FLAG_FE		0x02
+#define USART_FLAG_NE		0x04
+#define USART_FLAG_ORE		0x08
+#define USART_FLAG_IDLE		0x10
+#define DMA_HIFCR_CTCIF7	0
+#define DMA_HIFCR_CHTIF7	0
+#define DMA_HIFCR_CTEIF7	0
+#define DMA_HIFCR_CDMEIF7	0
+#define DMA_HIFCR_CFEIF7	0
+#define DMA_LIFCR_CTCIF2	0
+#define DMA_LIFCR_CHTIF2	0
+#define DMA_LIFCR_CTEIF2	0
+#define DMA_LIFCR_CDMEIF2	0
+#define DMA_LIFCR_CFEIF2	0
+#define __DMB()
+
+//ʼṹ  õĳֻҪֵܸ
+typedef struct{uint32_t DMA_Channel,DMA_PeripheralBaseAddr,DMA_Memory0BaseAddr,DMA_DIR,DMA_BufferSize,DMA_PeripheralInc,DMA_MemoryInc,
+				DMA_PeripheralDataSize,DMA_MemoryDataSize,DMA_Mode,DMA_Priority,DMA_FIFOMode,DMA_FIFOThreshold,DMA_MemoryBurst,DMA_PeripheralBurst;}DMA_InitTypeDef;
+typedef struct{uint32_t TIM_Period,TIM_Prescaler,TIM_CounterMode,TIM_ClockDivision,TIM_RepetitionCounter;}TIM_TimeBaseInitTypeDef;
+typedef struct{uint32_t NVIC_IRQChannel,NVIC_IRQChannelPreemptionPriority,NVIC_IRQChannelSubPriority,NVIC_IRQChannelCmd;}NVIC_InitTypeDef;
+typedef struct{uint32_t GPIO_Pin,GPIO_Mode,GPIO_Speed,GPIO_OType,GPIO_PuPd;}GPIO_InitTypeDef;
+typedef struct{uint32_t USART_BaudRate,USART_WordLength,USART_StopBits,USART_Parity,USART_HardwareFlowControl,USART_Mode;}USART_InitTypeDef;
+enum{DMA_Channel_4,DMA_DIR_MemoryToPeripheral,DMA_DIR_PeripheralToMemory,DMA_PeripheralInc_Disable,DMA_MemoryInc_Enable,
+	 DMA_PeripheralDataSize_Byte,DMA_MemoryDataSize_Byte,DMA_Mode_Normal,DMA_Priority_Medium,DMA_Priority_High,DMA_FIFOMode_Disable,
+	 DMA_FIFOThreshold_Full,DMA_MemoryBurst_Single,DMA_PeripheralBurst_Single,TIM_CounterMode_Up,TIM_CKD_DIV1,TIM7_IRQn,USART1_IRQn,
+	 GPIO_Pin_9,GPIO_Pin_10,GPIO_Mode_AF,GPIO_Speed_100MHz,GPIO_OType_PP,GPIO_PuPd_UP,USART_WordLength_9b,USART_StopBits_2,
+	 USART_Parity_Even,USART_HardwareFlowControl_None,USART_Mode_Rx,USART_Mode_Tx,ENABLE};
+
+#define RCC_AHB1PeriphClockCmd(...)
+#define RCC_APB1PeriphClockCmd(...)
+#define RCC_APB2PeriphClockCmd(...)
+#define GPIO_PinAFConfig(...)
+#define GPIO_Init(...)
+#define DMA_DeInit(...)
+#define DMA_Init(...)
+#define TIM_TimeBaseInit(...)
+#define TIM_ClearITPendingBit(...)
+#define TIM_ITConfig(...)
+#define TIM_Cmd(...)
+#define NVIC_Init(...)
+#define USART_Init(...)
+#define USART_DMACmd(...)
+#define USART_ITConfig(...)
+#define USART_Cmd(...)
+#endif
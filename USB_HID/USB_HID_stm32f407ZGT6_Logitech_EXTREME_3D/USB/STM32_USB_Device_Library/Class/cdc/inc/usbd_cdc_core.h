@@ -65,6 +65,12 @@
         
 #define CDC_DATA_OUT_PACKET_SIZE               CDC_DATA_MAX_PACKET_SIZE
 
+/* Max bytes handed to the driver in one IN transfer (several packets).
+   May be overridden in usbd_conf.h; must not exceed APP_RX_DATA_SIZE */
+#ifndef CDC_IN_BATCH_SIZE
+#define CDC_IN_BATCH_SIZE                      (CDC_DATA_IN_PACKET_SIZE * 16)
+#endif
+
 /*---------------------------------------------------------------------*/
 /*  CDC definitions                                                    */
 /*---------------------------------------------------------------------*/
@@ -126,6 +132,7 @@ extern USBD_Class_cb_TypeDef  USBD_CDC_cb;
 /** @defgroup USB_CORE_Exported_Functions
   * @{
   */
+void USBD_CDC_RxResume (void);
 /**
   * @}
   */ 
@@ -181,10 +181,13 @@ __ALIGN_BEGIN uint8_t CmdBuff[CDC_CMD_PACKET_SZE] __ALIGN_END ;
 
 uint32_t APP_Rx_ptr_in  = 0;
 uint32_t APP_Rx_ptr_out = 0;
-uint32_t APP_Rx_length  = 0;
+uint32_t APP_Rx_length  = 0;	/* Bytes in flight, added to APP_Rx_ptr_out on DataIn */
 
 uint8_t  USB_Tx_State = 0;
 
+static void    *cdc_pdev = 0;
+static uint8_t USB_Rx_Hold = 0;	/* OUT endpoint left unarmed (host is NAKed) until the interface has room */
+
 static uint32_t cdcCmd = 0xFF;
 static uint32_t cdcLen = 0;
 
@@ -453,6 +456,11 @@ static uint8_t  usbd_cdc_Init (void  *pdev,
   pbuf[4] = DEVICE_CLASS_CDC;
   pbuf[5] = DEVICE_SUBCLASS_CDC;
   
+  cdc_pdev = pdev;
+  USB_Rx_Hold = 0;
+  USB_Tx_State = 0;
+  APP_Rx_length = 0;
+  
   /* Initialize the Interface physical components */
   APP_FOPS.pIf_Init();
 
@@ -487,6 +495,8 @@ static uint8_t  usbd_cdc_DeInit (void  *pdev,
   DCD_EP_Close(pdev,
               CDC_CMD_EP);
 
+  cdc_pdev = 0;
+  
   /* Restore default state of the Interface physical components */
   APP_FOPS.pIf_DeInit();
   
@@ -623,39 +633,28 @@ static uint8_t  usbd_cdc_EP0_RxReady (void  *pdev)
   */
 static uint8_t  usbd_cdc_DataIn (void *pdev, uint8_t epnum)
 {
-  uint16_t USB_Tx_ptr;
-  uint16_t USB_Tx_length;
-
   if (USB_Tx_State == 1)
   {
-    if (APP_Rx_length == 0) 
-    {
-      USB_Tx_State = 0;
-    }
-    else 
+    /* Release the sent run only now, so the application cannot overwrite it while in flight */
+    APP_Rx_ptr_out += APP_Rx_length;
+    
+    /* Transfer ended on a full packet and nothing is pending: send a ZLP to end the host read */
+    if ((APP_Rx_length != 0) &&
+        (APP_Rx_length % CDC_DATA_IN_PACKET_SIZE == 0) &&
+        (APP_Rx_ptr_out % APP_RX_DATA_SIZE == APP_Rx_ptr_in))
     {
-      if (APP_Rx_length > CDC_DATA_IN_PACKET_SIZE){
-        USB_Tx_ptr = APP_Rx_ptr_out;
-        USB_Tx_length = CDC_DATA_IN_PACKET_SIZE;
-        
-        APP_Rx_ptr_out += CDC_DATA_IN_PACKET_SIZE;
-        APP_Rx_length -= CDC_DATA_IN_PACKET_SIZE;    
-      }
-      else 
-      {
-        USB_Tx_ptr = APP_Rx_ptr_out;
-        USB_Tx_length = APP_Rx_length;
-        
-        APP_Rx_ptr_out += APP_Rx_length;
-        APP_Rx_length = 0;
-      }
-      
-      /* Prepare the available data buffer to be sent on IN endpoint */
+      APP_Rx_length = 0;
       DCD_EP_Tx (pdev,
                  CDC_IN_EP,
-                 (uint8_t*)&APP_Rx_Buffer[USB_Tx_ptr],
-                 USB_Tx_length);
+                 (uint8_t*)APP_Rx_Buffer,
+                 0);
+      return USBD_OK;
     }
+    
+    /* Start the next transfer now instead of waiting for the next SOF */
+    APP_Rx_length = 0;
+    USB_Tx_State = 0;
+    Handle_USBAsynchXfer(pdev);
   }  
   
   return USBD_OK;
@@ -677,7 +676,13 @@ static uint8_t  usbd_cdc_DataOut (void *pdev, uint8_t epnum)
   
   /* USB data will be immediately processed, this allow next USB traffic being 
      NAKed till the end of the application Xfer */
-  APP_FOPS.pIf_DataRx(USB_Rx_Buffer, USB_Rx_Cnt);
+  /* Non USBD_OK: this packet was taken but there is no room for the next one.
+     Keep the endpoint unarmed until the interface calls USBD_CDC_RxResume */
+  if (APP_FOPS.pIf_DataRx(USB_Rx_Buffer, USB_Rx_Cnt) != USBD_OK)
+  {
+    USB_Rx_Hold = 1;
+    return USBD_OK;
+  }
   
   /* Prepare Out endpoint to receive next packet */
   DCD_EP_PrepareRx(pdev,
@@ -719,9 +724,6 @@ static uint8_t  usbd_cdc_SOF (void *pdev)
   */
 static void Handle_USBAsynchXfer (void *pdev)
 {
-  uint16_t USB_Tx_ptr;
-  uint16_t USB_Tx_length;
-  
   if(USB_Tx_State != 1)
   {
     if (APP_Rx_ptr_out == APP_RX_DATA_SIZE)
@@ -749,32 +751,41 @@ static void Handle_USBAsynchXfer (void *pdev)
      APP_Rx_length &= ~0x03;
 #endif /* USB_OTG_HS_INTERNAL_DMA_ENABLED */
     
-    if (APP_Rx_length > CDC_DATA_IN_PACKET_SIZE)
-    {
-      USB_Tx_ptr = APP_Rx_ptr_out;
-      USB_Tx_length = CDC_DATA_IN_PACKET_SIZE;
-      
-      APP_Rx_ptr_out += CDC_DATA_IN_PACKET_SIZE;	
-      APP_Rx_length -= CDC_DATA_IN_PACKET_SIZE;
-    }
-    else
+    /* Hand the whole contiguous run to DCD_EP_Tx (the driver splits it into packets) */
+    if (APP_Rx_length > CDC_IN_BATCH_SIZE)
     {
-      USB_Tx_ptr = APP_Rx_ptr_out;
-      USB_Tx_length = APP_Rx_length;
-      
-      APP_Rx_ptr_out += APP_Rx_length;
-      APP_Rx_length = 0;
+      APP_Rx_length = CDC_IN_BATCH_SIZE;
     }
     USB_Tx_State = 1; 
 
     DCD_EP_Tx (pdev,
                CDC_IN_EP,
-               (uint8_t*)&APP_Rx_Buffer[USB_Tx_ptr],
-               USB_Tx_length);
+               (uint8_t*)&APP_Rx_Buffer[APP_Rx_ptr_out],
+               APP_Rx_length);
   }  
   
 }
 
+/**
+  * @brief  USBD_CDC_RxResume
+  *         Re-arm the OUT endpoint once the interface has room again
+  *         (after pIf_DataRx returned non USBD_OK).
+  *         Disable the OTG interrupt when calling from the main loop
+  * @param  None
+  * @retval None
+  */
+void USBD_CDC_RxResume (void)
+{
+  if (USB_Rx_Hold && (cdc_pdev != 0))
+  {
+    USB_Rx_Hold = 0;
+    DCD_EP_PrepareRx(cdc_pdev,
+                     CDC_OUT_EP,
+                     (uint8_t*)(USB_Rx_Buffer),
+                     CDC_DATA_OUT_PACKET_SIZE);
+  }
+}
+
 /**
   * @brief  USBD_cdc_GetCfgDesc 
   *         Return configuration descriptor
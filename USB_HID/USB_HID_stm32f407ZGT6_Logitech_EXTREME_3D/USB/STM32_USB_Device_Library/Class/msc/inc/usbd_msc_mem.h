@@ -65,6 +65,13 @@ typedef struct _USBD_STORAGE
   int8_t (* Write)(uint8_t lun, uint8_t *buf, uint32_t blk_addr, uint16_t blk_len);
   int8_t (* GetMaxLun)(void);
   int8_t *pInquiry;
+  /* Optional (0: the SCSI layer calls Read/Write above synchronously).
+     Start one chunk (DMA etc.) and return 0 at once, then call USBD_MSC_MediaDone
+     when it completes. A return value <0 fails the chunk.
+     buf belongs to the media until USBD_MSC_MediaDone, while USB uses the
+     other half of MSC_BOT_Data */
+  int8_t (* ReadStart) (uint8_t lun, uint8_t *buf, uint32_t blk_addr, uint16_t blk_len);
+  int8_t (* WriteStart)(uint8_t lun, uint8_t *buf, uint32_t blk_addr, uint16_t blk_len);
   
 }USBD_STORAGE_cb_TypeDef;
 /**
@@ -93,6 +100,7 @@ typedef struct _USBD_STORAGE
   * @{
   */ 
 extern USBD_STORAGE_cb_TypeDef *USBD_STORAGE_fops;
+void USBD_MSC_MediaDone (int8_t status);
 /**
   * @}
   */ 
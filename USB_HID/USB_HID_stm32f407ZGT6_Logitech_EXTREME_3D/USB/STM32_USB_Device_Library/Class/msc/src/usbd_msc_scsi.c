@@ -83,6 +83,27 @@ uint64_t  SCSI_blk_addr;	//
 uint32_t  SCSI_blk_len;
 
 USB_OTG_CORE_HANDLE  *cdev;
+
+/* READ10/WRITE10 pipeline: the two halves of MSC_BOT_Data are used in turn,
+   USB transfers one half while the media reads or writes the other.
+   SCSI_blk_addr/SCSI_blk_len track the media side (next address, bytes left),
+   SCSI_usb_addr/SCSI_usb_len track the USB side.
+   A chunk never crosses a MSC_MEDIA_PACKET boundary (the first one is shortened),
+   so it stays aligned to flash sectors and SD blocks.
+   With ReadStart/WriteStart the media only starts a chunk and USBD_MSC_MediaDone
+   pushes the pipeline on; otherwise Read/Write are called synchronously. */
+static uint64_t SCSI_usb_addr;
+static uint32_t SCSI_usb_len;
+static uint32_t SCSI_Pipe_Len[2];	/* Bytes held in each half */
+static uint8_t  SCSI_Pipe_Media;	/* Half used by the next media chunk */
+static uint8_t  SCSI_Pipe_Usb;		/* Half used by the next USB chunk */
+static uint8_t  SCSI_Pipe_Ready;	/* Chunks done on one side, waiting for the other */
+static uint8_t  SCSI_Media_Busy;	/* Media chunk in progress */
+static uint8_t  SCSI_Usb_Busy;		/* USB chunk in progress */
+static uint8_t  SCSI_Pipe_Lun;
+static int8_t   SCSI_Pipe_Err;
+static uint8_t  SCSI_Pipe_Lock;		/* SCSI_Pump running (no re-entry when ReadStart calls MediaDone directly) */
+static uint8_t  SCSI_Pipe_Again;
 /**
   * @}
   */ 
@@ -108,6 +129,8 @@ static int8_t SCSI_CheckAddressRange (uint8_t lun ,
 static int8_t SCSI_ProcessRead (uint8_t lun);
 
 static int8_t SCSI_ProcessWrite (uint8_t lun);
+static void   SCSI_PipeInit (uint8_t lun);
+static int8_t SCSI_Pump (void);
 /**
   * @}
   */ 
@@ -131,7 +154,17 @@ int8_t SCSI_ProcessCmd(USB_OTG_CORE_HANDLE  *pdev,
                            uint8_t *params)
 {
   cdev = pdev;
-  
+
+  /* A reset aborted the last command while the media still owns a chunk of
+     MSC_BOT_Data: do not accept a new command yet */
+  if ((MSC_BOT_State == BOT_IDLE) && SCSI_Media_Busy)
+  {
+    SCSI_SenseCode(lun,
+                   NOT_READY,
+                   MEDIUM_NOT_PRESENT);
+    return -1;
+  }
+
   switch (params[0])
   {
   case SCSI_TEST_UNIT_READY:
@@ -483,7 +516,6 @@ static int8_t SCSI_Read10(uint8_t lun , uint8_t *params)
       return -1; /* error */
     }
     
-    MSC_BOT_State = BOT_DATA_IN;
     SCSI_blk_addr *= SCSI_blk_size;
     SCSI_blk_len  *= SCSI_blk_size;
     
@@ -495,8 +527,17 @@ static int8_t SCSI_Read10(uint8_t lun , uint8_t *params)
                      INVALID_CDB);
       return -1;
     }
+    
+    if (SCSI_blk_len == 0)	/* Zero blocks: no data stage, send the CSW now */
+    {
+      MSC_BOT_DataLen = 0;
+      return 0;
+    }
+    
+    MSC_BOT_State = BOT_DATA_IN;
+    SCSI_PipeInit(lun);
+    return SCSI_Pump();
   }
-  MSC_BOT_DataLen = MSC_MEDIA_PACKET;  
   
   return SCSI_ProcessRead(lun);
 }
@@ -568,12 +609,16 @@ static int8_t SCSI_Write10 (uint8_t lun , uint8_t *params)
       return -1;
     }
     
+    if (SCSI_blk_len == 0)	/* Zero blocks: no data stage, send the CSW now */
+    {
+      MSC_BOT_DataLen = 0;
+      return 0;
+    }
+    
     /* Prepare EP to receive first data packet */
     MSC_BOT_State = BOT_DATA_OUT;  
-    DCD_EP_PrepareRx (cdev,
-                      MSC_OUT_EP,
-                      MSC_BOT_Data, 
-                      MIN (SCSI_blk_len, MSC_MEDIA_PACKET));  
+    SCSI_PipeInit(lun);
+    return SCSI_Pump();
   }
   else /* Write Process ongoing */
   {
@@ -627,89 +672,251 @@ static int8_t SCSI_CheckAddressRange (uint8_t lun , uint32_t blk_offset , uint16
 
 /**
 * @brief  SCSI_ProcessRead
-*         Handle Read Process
+*         Handle Read Process (USB sent a chunk)
 * @param  lun: Logical unit number
 * @retval status
 */
 static int8_t SCSI_ProcessRead (uint8_t lun)
 {
-  uint32_t len;
-  
-  len = MIN(SCSI_blk_len , MSC_MEDIA_PACKET); 
-  
-  if( USBD_STORAGE_fops->Read(lun ,
-                              MSC_BOT_Data, 
-                              SCSI_blk_addr / SCSI_blk_size, 
-                              len / SCSI_blk_size) < 0)
-  {
-    
-    SCSI_SenseCode(lun, HARDWARE_ERROR, UNRECOVERED_READ_ERROR);
-    return -1; 
-  }
-  
-  
-  DCD_EP_Tx (cdev, 
-             MSC_IN_EP,
-             MSC_BOT_Data,
-             len);
-  
-  
-  SCSI_blk_addr   += len; 
-  SCSI_blk_len    -= len;  
-  
-  /* case 6 : Hi = Di */
-  MSC_BOT_csw.dDataResidue -= len;
-  
-  if (SCSI_blk_len == 0)
-  {
-    MSC_BOT_State = BOT_LAST_DATA_IN;
-  }
-  return 0;
+  SCSI_Usb_Busy = 0;
+  SCSI_Pipe_Usb ^= 1;
+  return SCSI_Pump();
 }
 
 /**
 * @brief  SCSI_ProcessWrite
-*         Handle Write Process
+*         Handle Write Process (USB received a chunk)
 * @param  lun: Logical unit number
 * @retval status
 */
 
 static int8_t SCSI_ProcessWrite (uint8_t lun)
+{
+  SCSI_Usb_Busy = 0;
+  SCSI_Pipe_Usb ^= 1;
+  SCSI_Pipe_Ready++;
+  return SCSI_Pump();
+}
+
+/* Chunk length: never crosses a MSC_MEDIA_PACKET boundary */
+static uint32_t SCSI_ChunkLen (uint64_t addr, uint32_t left)
+{
+  uint32_t len = MSC_MEDIA_PACKET - (uint32_t)(addr % MSC_MEDIA_PACKET);
+  
+  return MIN(len, left);
+}
+
+/* Before the READ10/WRITE10 data stage: both sides start at SCSI_blk_addr.
+   SCSI_Media_Busy is not cleared (after a reset the media chunk may still
+   be running and clears it when done) */
+static void SCSI_PipeInit (uint8_t lun)
+{
+  SCSI_usb_addr = SCSI_blk_addr;
+  SCSI_usb_len = SCSI_blk_len;
+  SCSI_Pipe_Media = 0;
+  SCSI_Pipe_Usb = 0;
+  SCSI_Pipe_Ready = 0;
+  SCSI_Usb_Busy = 0;
+  SCSI_Pipe_Lun = lun;
+  SCSI_Pipe_Err = 0;
+}
+
+/* Media finished a chunk */
+static void SCSI_MediaFinish (int8_t status)
 {
   uint32_t len;
   
-  len = MIN(SCSI_blk_len , MSC_MEDIA_PACKET); 
+  if (!SCSI_Media_Busy)
+  {
+    return;
+  }
+  SCSI_Media_Busy = 0;
+  SCSI_Pipe_Again = 1;
   
-  if(USBD_STORAGE_fops->Write(lun ,
-                              MSC_BOT_Data, 
-                              SCSI_blk_addr / SCSI_blk_size, 
-                              len / SCSI_blk_size) < 0)
+  if (status < 0)
   {
-    SCSI_SenseCode(lun, HARDWARE_ERROR, WRITE_FAULT);     
-    return -1; 
+    SCSI_Pipe_Err = -1;
+    if (MSC_BOT_State == BOT_DATA_OUT)
+    {
+      SCSI_SenseCode(SCSI_Pipe_Lun, HARDWARE_ERROR, WRITE_FAULT);
+    }
+    else
+    {
+      SCSI_SenseCode(SCSI_Pipe_Lun, HARDWARE_ERROR, UNRECOVERED_READ_ERROR);
+    }
+    return;
   }
   
+  len = SCSI_Pipe_Len[SCSI_Pipe_Media];
+  SCSI_Pipe_Media ^= 1;
+  SCSI_blk_addr += len;
+  SCSI_blk_len  -= len;
   
-  SCSI_blk_addr  += len; 
-  SCSI_blk_len   -= len; 
+  if (MSC_BOT_State == BOT_DATA_OUT)
+  {
+    /* case 12 : Ho = Do */
+    MSC_BOT_csw.dDataResidue -= len;
+  }
+  else
+  {
+    SCSI_Pipe_Ready++;
+  }
+}
+
+/* Start the next media chunk (read: into the free half; write: from the half USB filled) */
+static void SCSI_MediaStart (uint8_t write)
+{
+  int8_t (*start)(uint8_t lun, uint8_t *buf, uint32_t blk_addr, uint16_t blk_len);
+  uint8_t  *buf = &MSC_BOT_Data[SCSI_Pipe_Media * MSC_MEDIA_PACKET];
+  uint32_t len = SCSI_ChunkLen(SCSI_blk_addr, SCSI_blk_len);
+  uint32_t blk = SCSI_blk_addr / SCSI_blk_size;
+  uint16_t nbr = len / SCSI_blk_size;
   
-  /* case 12 : Ho = Do */
-  MSC_BOT_csw.dDataResidue -= len;
+  SCSI_Pipe_Len[SCSI_Pipe_Media] = len;
+  SCSI_Media_Busy = 1;
   
-  if (SCSI_blk_len == 0)
+  start = write ? USBD_STORAGE_fops->WriteStart : USBD_STORAGE_fops->ReadStart;
+  if (start != 0)
   {
-    MSC_BOT_SendCSW (cdev, CSW_CMD_PASSED);
+    /* Start only; USBD_MSC_MediaDone follows (possibly from inside the start call) */
+    if (start(SCSI_Pipe_Lun, buf, blk, nbr) < 0)
+    {
+      SCSI_MediaFinish(-1);
+    }
+  }
+  else if (write)
+  {
+    SCSI_MediaFinish(USBD_STORAGE_fops->Write(SCSI_Pipe_Lun, buf, blk, nbr));
   }
   else
   {
+    SCSI_MediaFinish(USBD_STORAGE_fops->Read(SCSI_Pipe_Lun, buf, blk, nbr));
+  }
+}
+
+/* Read: the media fills one half while USB sends the other */
+static void SCSI_PumpRead (void)
+{
+  uint8_t  *buf;
+  uint32_t len;
+  
+  if (!SCSI_Media_Busy && SCSI_blk_len && (SCSI_Pipe_Ready + SCSI_Usb_Busy < 2))
+  {
+    SCSI_MediaStart(0);
+  }
+  
+  if (!SCSI_Usb_Busy && SCSI_Pipe_Ready)
+  {
+    buf = &MSC_BOT_Data[SCSI_Pipe_Usb * MSC_MEDIA_PACKET];
+    len = SCSI_Pipe_Len[SCSI_Pipe_Usb];
+    SCSI_Pipe_Ready--;
+    SCSI_Usb_Busy = 1;
+    SCSI_usb_len -= len;
+    
+    /* case 6 : Hi = Di */
+    MSC_BOT_csw.dDataResidue -= len;
+    
+    if (SCSI_usb_len == 0)
+    {
+      MSC_BOT_State = BOT_LAST_DATA_IN;
+    }
+    DCD_EP_Tx (cdev, 
+               MSC_IN_EP,
+               buf,
+               len);
+  }
+}
+
+/* Write: USB fills one half while the media writes the other; CSW after both finish */
+static void SCSI_PumpWrite (void)
+{
+  uint8_t  *buf;
+  uint32_t len;
+  
+  if (!SCSI_Media_Busy && SCSI_Pipe_Ready)
+  {
+    SCSI_Pipe_Ready--;
+    SCSI_MediaStart(1);
+  }
+  
+  if (!SCSI_Usb_Busy && SCSI_usb_len && (SCSI_Pipe_Ready + SCSI_Media_Busy < 2))
+  {
+    buf = &MSC_BOT_Data[SCSI_Pipe_Usb * MSC_MEDIA_PACKET];
+    len = SCSI_ChunkLen(SCSI_usb_addr, SCSI_usb_len);
+    SCSI_Pipe_Len[SCSI_Pipe_Usb] = len;
+    SCSI_usb_addr += len;
+    SCSI_usb_len  -= len;
+    SCSI_Usb_Busy = 1;
+    
     /* Prapare EP to Receive next packet */
     DCD_EP_PrepareRx (cdev,
                       MSC_OUT_EP,
-                      MSC_BOT_Data, 
-                      MIN (SCSI_blk_len, MSC_MEDIA_PACKET)); 
+                      buf, 
+                      len); 
   }
   
-  return 0;
+  if (!SCSI_usb_len && !SCSI_Usb_Busy && !SCSI_Pipe_Ready && !SCSI_Media_Busy)
+  {
+    MSC_BOT_SendCSW (cdev, CSW_CMD_PASSED);
+  }
+}
+
+/* Advance the pipeline: start whatever can start (called from DataIn/DataOut
+   and USBD_MSC_MediaDone). Returns <0 on a media error; the caller then
+   sends CSW_CMD_FAILED */
+static int8_t SCSI_Pump (void)
+{
+  if ((MSC_BOT_State != BOT_DATA_IN) && (MSC_BOT_State != BOT_DATA_OUT))
+  {
+    return 0;
+  }
+  if (SCSI_Pipe_Lock)
+  {
+    SCSI_Pipe_Again = 1;
+    return 0;
+  }
+  
+  SCSI_Pipe_Lock = 1;
+  do
+  {
+    SCSI_Pipe_Again = 0;
+    if (SCSI_Pipe_Err < 0)
+    {
+      break;
+    }
+    if (MSC_BOT_State == BOT_DATA_IN)
+    {
+      SCSI_PumpRead();
+    }
+    else if (MSC_BOT_State == BOT_DATA_OUT)
+    {
+      SCSI_PumpWrite();
+    }
+  }
+  while (SCSI_Pipe_Again);
+  SCSI_Pipe_Lock = 0;
+  
+  return SCSI_Pipe_Err;
+}
+
+/**
+* @brief  USBD_MSC_MediaDone
+*         A chunk started by ReadStart/WriteStart has completed.
+*         Must not race the OTG interrupt: call it from an interrupt of the
+*         same preemption priority (e.g. the media DMA interrupt), or from the
+*         main loop with the OTG interrupt disabled
+* @param  status: 0: success, <0: failure
+* @retval None
+*/
+void USBD_MSC_MediaDone (int8_t status)
+{
+  SCSI_MediaFinish(status);
+  
+  /* If USB is still busy, the CSW is sent from DataIn/DataOut when it finishes */
+  if ((SCSI_Pump() < 0) && !SCSI_Usb_Busy)
+  {
+    MSC_BOT_SendCSW (cdev, CSW_CMD_FAILED);
+  }
 }
 /**
   * @}
@@ -14,35 +14,17 @@ extern "C" {
 # include <string.h>
 
 #include "usbh_hid_core.h"
+#include "usbh_hid_parser.h"
 #include "usb_conf_usr.h"
 
-/** 数据格式    			*data  
-	uint8_t X_L;			data[0]
-	uint8_t Y_L:6;			data[1]
-	uint8_t X_H:2;
-	uint8_t Hat_Switch:4;	data[2]
-	uint8_t Y_H:4;
-	uint8_t RZ;				data[3]
-	uint8_t button_1_8;		data[4]
-	uint8_t Slider;			data[5]
-	uint8_t zero:4;			data[6]
-	uint8_t button_9_12:4;  **/
-typedef struct
-{
-	uint16_t X;
-	uint16_t Y;
-	uint8_t RZ;
-	uint8_t Slider;
-	uint8_t Hat_Switch;
-	uint16_t button;
-	
-} HID_Logitech_Data_Analyze;
-extern HID_Logitech_Data_Analyze  Logitech_Data;
+/** 摇杆/手柄 (接口协议 0)：报告按报告描述符 查表取到 HID_Input 里，不再按字节手拆，
+	Logitech Extreme 3D 是 X/Y 10 位、Hat 4 位、RZ 8 位、按键 1~8、Slider 8 位、按键 9~12，
+	别的手柄 轴/按键 一样会放到 HID_Input.axis[HID_AXIS_xxx] / button 里。 **/
 
 extern HID_cb_TypeDef  HID_Logitech_cb;  // 用户 USB 设备 初始化、驱动
 
 void  USR_Logitech_Init (void);
-void  USR_Logitech_ProcessData (HID_Logitech_Data_Analyze *Logitech_data);
+void  USR_Logitech_ProcessData (HID_Input_TypeDef *in);
 
 #ifdef __cplusplus
 }
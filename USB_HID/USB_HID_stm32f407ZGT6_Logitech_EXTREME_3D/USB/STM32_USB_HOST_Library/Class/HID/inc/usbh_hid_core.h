@@ -36,7 +36,9 @@
 #include "usbh_ioreq.h"
 #include "usbh_hcs.h"
 
-#define HID_MIN_POLL                                10
+#define HID_MIN_POLL                                1	/* 全速 最快 1 帧 (1ms) 一次，按设备的 bInterval 来 */
+#define HID_FRAME_MASK                              0x3FFFU	/* 帧号 14 位 */
+#define HID_BUF_SIZE                                64U
 #define HID_REPORT_SIZE                             16U
 #define HID_MAX_USAGE                               10U
 #define HID_MAX_NBR_REPORT_FMT                      10U
@@ -104,14 +106,32 @@ typedef enum
 typedef struct _HID_cb // 用户 USB 设备 初始化、驱动
 {
 	void  (*Init)   (void);
-	void  (*Decode) (uint8_t *data/*所求数据*/);
+	void  (*Decode) (uint8_t *data/*所求数据，已经按字段表取到 HID_Input 里了*/);
 
 } HID_cb_TypeDef;
 
-/* Structure for HID process */
+/* 每个设备的轮询统计 (USBH_HID_InterfaceInit 清零) */
+typedef struct _HID_Stat
+{
+	uint8_t              interval;	/* 端点描述符的 bInterval */
+	uint32_t             in_req;	/* 发出去的 IN */
+	uint32_t             reports;	/* 收到的报告 */
+	uint32_t             nak;		/* 设备没有新数据 */
+	uint32_t             err;		/* 传输出错 */
+	uint32_t             late;		/* 收到时主循环还在解上一个，推迟到下一帧才交出去 */
+	uint32_t             overrun;	/* 主循环没来得及解 就被更新的报告盖掉 */
+	uint32_t             rate;		/* 最近 1 秒 收到的报告数 (Hz) */
+	uint32_t             lat_last;	/* 报告收到 -> 主循环开始解码 us */
+	uint32_t             lat_max;
+} HID_Stat_TypeDef;
+
+/* Structure for HID process
+   中断 IN 由 SOF 中断按 poll 帧调度 (HC_Done 里收完马上排下一个)，报告 双缓冲：
+   中断往 buff[wr] 收，收完交出去 (rd=wr 再换另一个)；主循环在 HID_POLL 里解 buff[rd]，
+   解的时候置 busy，中断不换缓冲，收好的报告等到下一帧再交。 */
 typedef struct _HID_Process // HID 流程
 {
-	uint8_t              buff[64];/*数据*/
+	uint8_t              buff[2][HID_BUF_SIZE];/*数据 双缓冲*/
 	uint8_t              hc_num_in;
 	uint8_t              hc_num_out;
 	HID_State            state;
@@ -123,6 +143,22 @@ typedef struct _HID_Process // HID 流程
 	uint16_t             poll;
 	__IO uint16_t        timer;
 	HID_cb_TypeDef       *cb;  // 用户 USB 设备 初始化、驱动
+
+	__IO uint8_t         sched;		/* 1: SOF 中断在调度 IN */
+	__IO uint8_t         active;	/* IN 发出去了 还没结果 */
+	__IO uint8_t         done;		/* buff[wr] 收好了 还没交出去 */
+	__IO uint8_t         stall;		/* 端点 STALL，等主循环清 */
+	__IO uint8_t         wr;		/* 中断在收的缓冲 */
+	__IO uint8_t         rd;		/* 最新交出去的缓冲 */
+	__IO uint8_t         fresh;		/* buff[rd] 还没解码 */
+	__IO uint8_t         busy;		/* 主循环在解 buff[rd] */
+	uint16_t             next;		/* 上一个 IN 发在哪一帧 */
+	uint16_t             sof_cnt;
+	uint32_t             rate_base;
+	uint32_t             t_rx[2];	/* 收到的时间 us (帧号*1000 + 帧内)，16.384s 一圈 */
+	uint16_t             rx_len[2];	/* 收到的字节数 */
+	uint8_t              boot;		/* 1:报告描述符解析不出来，用 boot 格式 */
+	HID_Stat_TypeDef     stat;
 } HID_Machine_TypeDef;
 
 typedef  struct  _HID_Report
@@ -28,6 +28,7 @@ extern "C" {
 /* Includes ------------------------------------------------------------------*/
 #include "usb_conf_usr.h"
 #include "usbh_hid_core.h"
+#include "usbh_hid_parser.h"
 
 #define QWERTY_KEYBOARD		//ͨ�ü���
 //#define AZERTY_KEYBOARD	//���������
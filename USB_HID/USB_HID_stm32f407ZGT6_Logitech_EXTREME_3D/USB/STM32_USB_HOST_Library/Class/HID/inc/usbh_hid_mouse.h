@@ -32,6 +32,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "usbh_hid_core.h"
+#include "usbh_hid_parser.h"
 
 
 typedef struct _HID_MOUSE_Data
@@ -0,0 +1,100 @@
+//
+// HID   + ȡֵ
+//
+
+#ifndef __USBH_HID_PARSER_H
+#define __USBH_HID_PARSER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/** ԭÿ豸дһ Decode (Logitech ֽڲλ갴泤Ȳ¸ʽ̰ boot ʽ)
+	ֱҪдһöʱ (GET_REPORT_DESC ֮) ѱ һΣ
+	һ ֶα (λƫơλŵġ߼Χ)ÿһ HID_Extract ˳űȡֵ
+	ʲô豸ͳһŽ HID_Input_TypeDef
+		 (X Y Z Rx Ry Rz Slider Dial Wheelŵ Slider) һ 0~HID_AXIS_MAX
+		 ( X/Y/) ԭֵ
+		 1~32 һλһ ( 1 λ һֶ һȡ)
+		ñ 0~7߼Χ (û) Ϊ HID_HAT_NULL
+		 μ (E0~E7) һֽ + µļ
+	ֻ Input 棻Output/Feature (λ) ֻλá
+	 Report ID 豸һֽ IDֻ ID ֶΣֶαһεֵ */
+
+#define HID_MAX_FIELD		48		/* ֶα ༸ */
+#define HID_MAX_REPORT_ID	8		/* ټ Report ID λƫ */
+#define HID_PARSE_USAGE		16		/* һ Main  Ǽ Usage */
+
+#define HID_AXIS_NUM		9		/* X Y Z Rx Ry Rz Slider Dial Wheel */
+#define HID_AXIS_MAX		0xFFFFU
+#define HID_KEY_NUM			6
+#define HID_HAT_NULL		0xFF
+
+/*  ± = Generic Desktop Usage - 0x30 */
+#define HID_AXIS_X			0
+#define HID_AXIS_Y			1
+#define HID_AXIS_Z			2
+#define HID_AXIS_RX			3
+#define HID_AXIS_RY			4
+#define HID_AXIS_RZ			5
+#define HID_AXIS_SLIDER		6
+#define HID_AXIS_DIAL		7
+#define HID_AXIS_WHEEL		8
+
+/* ֶ ŵ */
+#define HID_FIELD_AXIS		1		/* axis[index] */
+#define HID_FIELD_REL		2		/* rel[index] */
+#define HID_FIELD_BUTTON	3		/* button ӵ index λ size λ */
+#define HID_FIELD_HAT		4		/* hat */
+#define HID_FIELD_MODIFIER	5		/* modifier ӵ index λ */
+#define HID_FIELD_KEY		6		/* key[index] */
+
+typedef struct
+{
+	uint16_t bit;		/* ڱλƫ ( Report ID ֽ) */
+	uint8_t  size;		/* λ 1~32 */
+	uint8_t  type;		/* HID_FIELD_xxx */
+	uint8_t  index;
+	uint8_t  report_id;
+	uint8_t  sign;		/* 1:߼С <0зȡ */
+	int32_t  min;		/* ߼С */
+	uint32_t range;		/* ߼-С */
+	uint32_t scale;		/* ᣺(HID_AXIS_MAX<<16)/rangeȡֵʱ  */
+} HID_Field_TypeDef;
+
+typedef struct
+{
+	HID_Field_TypeDef field[HID_MAX_FIELD];
+	uint8_t  num;		/* ֶ0:ûõ */
+	uint8_t  has_id;	/* 1: Report ID */
+	uint8_t  skipped;	/*  ûŽֶ */
+} HID_Map_TypeDef;
+
+typedef struct
+{
+	uint16_t axis[HID_AXIS_NUM];	/*  0~HID_AXIS_MAX (߼С~) */
+	int16_t  rel[HID_AXIS_NUM];		/*  һ */
+	uint32_t button;				/*  n ڵ n-1 λ */
+	uint8_t  hat;					/* 0~7 ˳ʱ룬HID_HAT_NULL:û */
+	uint8_t  modifier;				/*  KBD_LEFT_CTRL ... KBD_RIGHT_GUI */
+	uint8_t  key[HID_KEY_NUM];		/*  µļ룬0: */
+	uint8_t  report_id;				/* һ ID (û ID Ϊ 0) */
+} HID_Input_TypeDef;
+
+extern HID_Map_TypeDef   HID_Map;	/* ǰ豸ֶα (usbh_hid_core.c öʱ) */
+extern HID_Input_TypeDef HID_Input;	/* ǰ豸 µ */
+
+/* ʱ  HID 淶¼ B  boot ʽ (Ҫ SET_PROTOCOL  boot) */
+extern const uint8_t HID_Boot_Keyboard_Desc[63];
+extern const uint8_t HID_Boot_Mouse_Desc[50];
+
+uint8_t HID_Parse(const uint8_t *desc, uint16_t len, HID_Map_TypeDef *map);	/* ֶ */
+void    HID_Extract(const HID_Map_TypeDef *map, const uint8_t *data, uint16_t len, HID_Input_TypeDef *in);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__USBH_HID_PARSER_H
@@ -44,6 +44,7 @@
 #include "usbh_hid_mouse.h"
 #include "usbh_hid_keybd.h"
 #include "usbh_hid_Logitech.h"
+#include "usbh_hid_parser.h"
 
 
 #ifdef USB_OTG_HS_INTERNAL_DMA_ENABLED
@@ -58,8 +59,6 @@ __ALIGN_BEGIN HID_Report_TypeDef         HID_Report 	__ALIGN_END ;
 __ALIGN_BEGIN USB_Setup_TypeDef          HID_Setup 		__ALIGN_END ;
 __ALIGN_BEGIN USBH_HIDDesc_TypeDef       HID_Desc 		__ALIGN_END ;
 
-__IO uint8_t start_toggle = 0;
-
 /** @defgroup USBH_HID_CORE_Private_FunctionPrototypes
 * @{
 */
@@ -95,14 +94,107 @@ static USBH_Status USBH_Set_Protocol (USB_OTG_CORE_HANDLE *pdev,
 									  USBH_HOST *phost,
 									  uint8_t protocol);
 
+static void USBH_HID_SOF (USB_OTG_CORE_HANDLE *pdev, void *phost);
+
+static void USBH_HID_HC_Done (USB_OTG_CORE_HANDLE *pdev, void *phost, uint8_t hc_num);
+
 //صṹַ
 USBH_Class_cb_TypeDef  CLASS_cb = {
 		USBH_HID_InterfaceInit,
 		USBH_HID_InterfaceDeInit,
 		USBH_HID_ClassRequest,
-		USBH_HID_Handle
+		USBH_HID_Handle,
+		USBH_HID_SOF,
+		USBH_HID_HC_Done
 };
 
+#define HID_TIME_WRAP   (((uint32_t)HID_FRAME_MASK + 1) * 1000)	/* USBH_HID_Time һȦ us */
+
+/* ڵʱ us֡*1000 + ֡ȥĲ (HFIR һ֡ PHY ʱFRREM ) */
+static uint32_t USBH_HID_Time (USB_OTG_CORE_HANDLE *pdev)
+{
+	USB_OTG_HFNUM_TypeDef hfnum;
+	uint32_t frint = USB_OTG_READ_REG32(&pdev->regs.HREGS->HFIR) & 0xFFFF;
+	hfnum.d32 = USB_OTG_READ_REG32(&pdev->regs.HREGS->HFNUM);
+	if (frint == 0 || hfnum.b.frrem > frint) return (hfnum.b.frnum & HID_FRAME_MASK) * 1000;
+	return (hfnum.b.frnum & HID_FRAME_MASK) * 1000 + (frint - hfnum.b.frrem) * 1000 / frint;
+}
+
+/* ж (SOF / HC_Done)պõı潻ȥ poll ˾һ IN */
+static void USBH_HID_Sched (USB_OTG_CORE_HANDLE *pdev)
+{
+	uint16_t f;
+	if (HID_Machine.done && !HID_Machine.busy)
+	{
+		if (HID_Machine.fresh) HID_Machine.stat.overrun++;
+		HID_Machine.rd = HID_Machine.wr;
+		HID_Machine.wr ^= 1;
+		HID_Machine.done = 0;
+		HID_Machine.fresh = 1;
+	}
+	if (HID_Machine.done || HID_Machine.active || HID_Machine.stall) return;
+
+	/* ύ һ֡ŷ (HC_StartXfer ǰ֡ oddfrm) */
+	f = (HCD_GetCurrentFrame(pdev) + 1) & HID_FRAME_MASK;
+	if (((f - HID_Machine.next) & HID_FRAME_MASK) < HID_Machine.poll) return;
+	HID_Machine.next = f;
+	HID_Machine.active = 1;
+	HID_Machine.stat.in_req++;
+	USBH_InterruptReceiveData(pdev,
+							  HID_Machine.buff[HID_Machine.wr],
+							  HID_Machine.length,
+							  HID_Machine.hc_num_in);
+}
+
+/**
+* @brief  USBH_HID_SOF
+*         ÿ֡ʼ (USB ж)IN û/ βͳƱʣٵ
+*/
+static void USBH_HID_SOF (USB_OTG_CORE_HANDLE *pdev, void *phost)
+{
+	USB_OTG_HCCHAR_TypeDef hcchar;
+	uint8_t hc = HID_Machine.hc_num_in;
+
+	if (!HID_Machine.sched) return;
+
+	if (HID_Machine.active)
+	{
+		hcchar.d32 = USB_OTG_READ_REG32(&pdev->regs.HC_REGS[hc]->HCCHAR);
+		if (!hcchar.b.chen) /* ͨͣ û HC_DoneNAK / STALL /  */
+		{
+			HID_Machine.active = 0;
+			if (pdev->host.HC_Status[hc] == HC_NAK) HID_Machine.stat.nak++;
+			else if (pdev->host.HC_Status[hc] == HC_STALL) HID_Machine.stall = 1;
+			else HID_Machine.stat.err++;
+		}
+	}
+
+	if (++HID_Machine.sof_cnt >= 1000)
+	{
+		HID_Machine.sof_cnt = 0;
+		HID_Machine.stat.rate = HID_Machine.stat.reports - HID_Machine.rate_base;
+		HID_Machine.rate_base = HID_Machine.stat.reports;
+	}
+
+	USBH_HID_Sched(pdev);
+}
+
+/**
+* @brief  USBH_HID_HC_Done
+*         ж IN  (USB ж)ʱ䣬һ1ms  bInterval Ҳϵһ֡
+*/
+static void USBH_HID_HC_Done (USB_OTG_CORE_HANDLE *pdev, void *phost, uint8_t hc_num)
+{
+	if (!HID_Machine.sched || hc_num != HID_Machine.hc_num_in) return;
+	HID_Machine.t_rx[HID_Machine.wr] = USBH_HID_Time(pdev);
+	HID_Machine.rx_len[HID_Machine.wr] = pdev->host.XferCnt[hc_num];
+	HID_Machine.active = 0;
+	HID_Machine.done = 1;
+	HID_Machine.stat.reports++;
+	if (HID_Machine.busy) HID_Machine.stat.late++;
+	USBH_HID_Sched(pdev);
+}
+
 /**
 * @brief  USBH_HID_InterfaceInit 
 *         The function init the HID class.
@@ -116,6 +208,7 @@ static USBH_Status USBH_HID_InterfaceInit (USB_OTG_CORE_HANDLE *pdev, void *phos
 
 	uint8_t num =0;
 	USBH_Status status = USBH_BUSY ;
+	HID_Machine.sched = 0;
 	HID_Machine.state = HID_ERROR;
 
 	if(pphost->device_prop.Itf_Desc[0].bInterfaceSubClass/*ӿ*/ == HID_BOOT_CODE
@@ -149,7 +242,20 @@ static USBH_Status USBH_HID_InterfaceInit (USB_OTG_CORE_HANDLE *pdev, void *phos
 		HID_Machine.length    = pphost->device_prop.Ep_Desc[0][0].wMaxPacketSize;
 		HID_Machine.poll      = pphost->device_prop.Ep_Desc[0][0].bInterval ;
 
-		if (HID_Machine.poll < HID_MIN_POLL) HID_Machine.poll = HID_MIN_POLL; // 10 ms
+		if (HID_Machine.poll < HID_MIN_POLL) HID_Machine.poll = HID_MIN_POLL; // ȫ bInterval  ms
+		if (HID_Machine.length > HID_BUF_SIZE) HID_Machine.length = HID_BUF_SIZE;
+
+		HID_Machine.active = 0;
+		HID_Machine.done   = 0;
+		HID_Machine.stall  = 0;
+		HID_Machine.wr     = 0;
+		HID_Machine.rd     = 1;
+		HID_Machine.fresh  = 0;
+		HID_Machine.busy   = 0;
+		HID_Machine.sof_cnt   = 0;
+		HID_Machine.rate_base = 0;
+		memset(&HID_Machine.stat, 0, sizeof(HID_Machine.stat));
+		HID_Machine.stat.interval = pphost->device_prop.Ep_Desc[0][0].bInterval;
 
 		/* Check fo available number of endpoints */
 		/* Find the number of EPs in the Interface Descriptor */
@@ -191,7 +297,6 @@ static USBH_Status USBH_HID_InterfaceInit (USB_OTG_CORE_HANDLE *pdev, void *phos
 
 		}
 
-		start_toggle =0;
 		status = USBH_OK;
 	}
 	else
@@ -216,6 +321,9 @@ void USBH_HID_InterfaceDeInit (USB_OTG_CORE_HANDLE *pdev, void *phost)
 {
 //	USBH_HOST *pphost = phost;
 
+	HID_Machine.sched = 0; /* ͣ ٹͨ */
+	HID_Machine.active = 0;
+
 	if(HID_Machine.hc_num_in != 0x00)
 	{
 		USB_OTG_HC_Halt(pdev, HID_Machine.hc_num_in);
@@ -230,7 +338,6 @@ void USBH_HID_InterfaceDeInit (USB_OTG_CORE_HANDLE *pdev, void *phost)
 		HID_Machine.hc_num_out = 0;     /* Reset the Channel as Free */
 	}
 
-	start_toggle = 0;
 }
 
 /**
@@ -246,6 +353,7 @@ static USBH_Status USBH_HID_ClassRequest(USB_OTG_CORE_HANDLE *pdev, void *phost)
 	USBH_HOST *pphost = phost;
 	USBH_Status status         = USBH_BUSY;
 	USBH_Status classReqStatus = USBH_BUSY;
+	uint16_t len;
 
 	/* Switch HID state machine */
 	switch (HID_Machine.ctl_state)
@@ -263,8 +371,21 @@ static USBH_Status USBH_HID_ClassRequest(USB_OTG_CORE_HANDLE *pdev, void *phost)
 
 		case HID_REQ_GET_REPORT_DESC:
 			/* Get Report Desc */
-			if (USBH_Get_HID_ReportDescriptor(pdev , pphost, HID_Desc.wItemLength) == USBH_OK)
+			len = HID_Desc.wItemLength < MAX_DATA_LENGTH ? HID_Desc.wItemLength : MAX_DATA_LENGTH;
+			if (USBH_Get_HID_ReportDescriptor(pdev , pphost, len) == USBH_OK)
 			{
+				/* ֶαԺÿ ȡֵļ/ ˻ boot ʽ */
+				if (HID_Parse(pdev->host.Rx_Buffer, len, &HID_Map) == 0)
+				{
+					if (pphost->device_prop.Itf_Desc[0].bInterfaceProtocol == HID_KEYBRD_BOOT_CODE)
+						HID_Parse(HID_Boot_Keyboard_Desc, sizeof(HID_Boot_Keyboard_Desc), &HID_Map);
+					else if (pphost->device_prop.Itf_Desc[0].bInterfaceProtocol == HID_MOUSE_BOOT_CODE)
+						HID_Parse(HID_Boot_Mouse_Desc, sizeof(HID_Boot_Mouse_Desc), &HID_Map);
+					HID_Machine.boot = HID_Map.num != 0;
+				}
+				else HID_Machine.boot = 0;
+				memset(&HID_Input, 0, sizeof(HID_Input));
+				HID_Input.hat = HID_HAT_NULL;
 				HID_Machine.ctl_state = HID_REQ_SET_IDLE;
 			}
 			break;
@@ -281,8 +402,8 @@ static USBH_Status USBH_HID_ClassRequest(USB_OTG_CORE_HANDLE *pdev, void *phost)
 			break;
 
 		case HID_REQ_SET_PROTOCOL:
-			/* set protocol */
-			if (USBH_Set_Protocol (pdev ,pphost, 0) == USBH_OK)
+			/* set protocol boot ʽʱҪ bootȻʽԲ */
+			if (USBH_Set_Protocol (pdev ,pphost, HID_Machine.boot) == USBH_OK)
 			{
 				HID_Machine.ctl_state = HID_REQ_IDLE;
 
@@ -309,6 +430,8 @@ static USBH_Status USBH_HID_Handle(USB_OTG_CORE_HANDLE *pdev, void   *phost)
 {
 	USBH_HOST *pphost = phost;
 	USBH_Status status = USBH_OK;
+	uint8_t i;
+	uint32_t lat;
 
 	switch (HID_Machine.state)
 	{
@@ -325,30 +448,29 @@ static USBH_Status USBH_HID_Handle(USB_OTG_CORE_HANDLE *pdev, void   *phost)
 			break;
 
 		case HID_GET_DATA:
-			/**  USB ݰ **/
-			USBH_InterruptReceiveData(pdev,
-									  HID_Machine.buff,
-									  HID_Machine.length,
-									  HID_Machine.hc_num_in);
-			start_toggle = 1;
-			HID_Machine.timer = HCD_GetCurrentFrame(pdev);
+			/**  USB ݰ SOF жϰ poll ȣϿԷһ **/
+			HID_Machine.next = (HCD_GetCurrentFrame(pdev) - HID_Machine.poll) & HID_FRAME_MASK;
+			HID_Machine.stall = 0;
+			HID_Machine.sched = 1;
 			HID_Machine.state = HID_POLL;
 			break;
 
 		case HID_POLL:
-			if(( HCD_GetCurrentFrame(pdev) - HID_Machine.timer) >= HID_Machine.poll)
+			if(HID_Machine.fresh) /* ѭռ USB ж */
 			{
-				HID_Machine.state = HID_GET_DATA;
-			}
-			else if(HCD_GetURB_State(pdev , HID_Machine.hc_num_in) == URB_DONE)
-			{
-				if(start_toggle == 1) /* handle data once */
-				{
-					start_toggle = 0;
-					HID_Machine.cb->Decode(HID_Machine.buff/**/);
-				}
+				HID_Machine.busy = 1;
+				__DMB(); /*  busy жϾͲ壬ȡ rd */
+				i = HID_Machine.rd;
+				HID_Machine.fresh = 0;
+				lat = (USBH_HID_Time(pdev) + HID_TIME_WRAP - HID_Machine.t_rx[i]) % HID_TIME_WRAP;
+				HID_Machine.stat.lat_last = lat;
+				if (lat > HID_Machine.stat.lat_max) HID_Machine.stat.lat_max = lat;
+				HID_Extract(&HID_Map, HID_Machine.buff[i], HID_Machine.rx_len[i], &HID_Input); /* ȡֵ Ž HID_Input */
+				HID_Machine.cb->Decode(HID_Machine.buff[i]/**/);
+				__DMB();
+				HID_Machine.busy = 0;
 			}
-			else if(HCD_GetURB_State(pdev, HID_Machine.hc_num_in) == URB_STALL) /* IN Endpoint Stalled */
+			else if(HID_Machine.stall) /* IN Endpoint Stalled */
 			{
 				/* Issue Clear Feature on interrupt IN endpoint */
 				if( (USBH_ClrFeature(pdev,
@@ -356,8 +478,8 @@ static USBH_Status USBH_HID_Handle(USB_OTG_CORE_HANDLE *pdev, void   *phost)
 									 HID_Machine.ep_addr,
 									 HID_Machine.hc_num_in)) == USBH_OK)
 				{
-					/* Change state to issue next IN token */
-					HID_Machine.state = HID_GET_DATA;
+					/* ˣжϽŵ */
+					HID_Machine.stall = 0;
 				}
 			}
 			break;
@@ -185,6 +185,8 @@ static void  KEYBRD_Init (void)
 * @brief  KEYBRD_ProcessData.
 *         The function is to decode the pressed keys.
 * @param  pbuf : Pointer to the HID IN report data buffer
+*         (modifier/key codes are taken from HID_Input, filled by the
+*         report descriptor field table)
 * @retval None
 */
 
@@ -210,7 +212,7 @@ static void KEYBRD_Decode(uint8_t *pbuf)
   
   
   /* Check if Shift key is pressed */                                                                         
-  if ((pbuf[0] == KBD_LEFT_SHIFT) || (pbuf[0] == KBD_RIGHT_SHIFT)) {
+  if ((HID_Input.modifier == KBD_LEFT_SHIFT) || (HID_Input.modifier == KBD_RIGHT_SHIFT)) {
     shift = TRUE;
   } else {
     shift = FALSE;
@@ -219,10 +221,10 @@ static void KEYBRD_Decode(uint8_t *pbuf)
   error = FALSE;
   
   /* Check for the value of pressed key */
-  for (ix = 2; ix < 2 + KBR_MAX_NBR_PRESSED; ix++) {                       
-    if ((pbuf[ix] == 0x01) ||
-        (pbuf[ix] == 0x02) ||
-          (pbuf[ix] == 0x03)) {
+  for (ix = 0; ix < KBR_MAX_NBR_PRESSED; ix++) {                       
+    if ((HID_Input.key[ix] == 0x01) ||
+        (HID_Input.key[ix] == 0x02) ||
+          (HID_Input.key[ix] == 0x03)) {
             error = TRUE;
           }
   }
@@ -233,18 +235,18 @@ static void KEYBRD_Decode(uint8_t *pbuf)
   
   nbr_keys     = 0;
   nbr_keys_new = 0;
-  for (ix = 2; ix < 2 + KBR_MAX_NBR_PRESSED; ix++) {
-    if (pbuf[ix] != 0) {
-      keys[nbr_keys] = pbuf[ix];                                       
+  for (ix = 0; ix < KBR_MAX_NBR_PRESSED; ix++) {
+    if (HID_Input.key[ix] != 0) {
+      keys[nbr_keys] = HID_Input.key[ix];                                       
       nbr_keys++;
       for (jx = 0; jx < nbr_keys_last; jx++) {                         
-        if (pbuf[ix] == keys_last[jx]) {
+        if (HID_Input.key[ix] == keys_last[jx]) {
           break;
         }
       }
       
       if (jx == nbr_keys_last) {
-        keys_new[nbr_keys_new] = pbuf[ix];
+        keys_new[nbr_keys_new] = HID_Input.key[ix];
         nbr_keys_new++;
       }
     }
@@ -72,24 +72,19 @@ static void  MOUSE_Init ( void)
 * @retval None
 */
 
-/*  ./USB/STM32_USB_HOST_Library/Class/HID/src/usbh_hid_core.c */
-extern HID_Machine_TypeDef HID_Machine;
+/*  ޵ 8 λз (12 λ һζ̫ͽص) */
+static uint8_t MOUSE_Rel8(int16_t v)
+{
+	return (uint8_t)(v > 127 ? 127 : (v < -128 ? -128 : v));
+}
 
+/* Ѿ usbh_hid_core.c ֶαȡ HID_Input ٰ泤Ȳ¸ʽ */
 static void  MOUSE_Decode(uint8_t *data)
 {   
-	if(HID_Machine.length==6)		//6ֽڳȵUSBݴ
-	{
-		HID_MOUSE_Data.button = data[0]; 
-		HID_MOUSE_Data.x      = data[1];
-		HID_MOUSE_Data.y      = data[3]<<4|data[2]>>4;
-		HID_MOUSE_Data.z      = data[4]; 
-	}else if(HID_Machine.length==4)	//4ֽڳȵUSB ݴ
-	{ 
-		HID_MOUSE_Data.button = data[0]; 
-		HID_MOUSE_Data.x      = data[1];
-		HID_MOUSE_Data.y      = data[2];
-		HID_MOUSE_Data.z      = data[3];
-	} 
+	HID_MOUSE_Data.button = HID_Input.button;
+	HID_MOUSE_Data.x      = MOUSE_Rel8(HID_Input.rel[HID_AXIS_X]);
+	HID_MOUSE_Data.y      = MOUSE_Rel8(HID_Input.rel[HID_AXIS_Y]);
+	HID_MOUSE_Data.z      = MOUSE_Rel8(HID_Input.rel[HID_AXIS_WHEEL]);
 	USR_MOUSE_ProcessData(&HID_MOUSE_Data);
 
 }
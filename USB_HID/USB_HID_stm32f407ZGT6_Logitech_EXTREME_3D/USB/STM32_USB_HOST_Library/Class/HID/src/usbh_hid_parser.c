@@ -0,0 +1,324 @@
+//
+// HID   + ȡֵ˵ usbh_hid_parser.h
+//
+
+#include "usbh_hid_parser.h"
+#include "usbh_hid_core.h"
+#include <string.h>
+
+HID_Map_TypeDef   HID_Map;
+HID_Input_TypeDef HID_Input;
+
+const uint8_t HID_Boot_Keyboard_Desc[63] = {
+	0x05, 0x01, 0x09, 0x06, 0xA1, 0x01, 0x05, 0x07, 0x19, 0xE0, 0x29, 0xE7, 0x15, 0x00, 0x25, 0x01,
+	0x75, 0x01, 0x95, 0x08, 0x81, 0x02, 0x95, 0x01, 0x75, 0x08, 0x81, 0x01, 0x95, 0x05, 0x75, 0x01,
+	0x05, 0x08, 0x19, 0x01, 0x29, 0x05, 0x91, 0x02, 0x95, 0x01, 0x75, 0x03, 0x91, 0x01, 0x95, 0x06,
+	0x75, 0x08, 0x15, 0x00, 0x25, 0x65, 0x05, 0x07, 0x19, 0x00, 0x29, 0x65, 0x81, 0x00, 0xC0
+};
+
+const uint8_t HID_Boot_Mouse_Desc[50] = {
+	0x05, 0x01, 0x09, 0x02, 0xA1, 0x01, 0x09, 0x01, 0xA1, 0x00, 0x05, 0x09, 0x19, 0x01, 0x29, 0x03,
+	0x15, 0x00, 0x25, 0x01, 0x95, 0x03, 0x75, 0x01, 0x81, 0x02, 0x95, 0x01, 0x75, 0x05, 0x81, 0x01,
+	0x05, 0x01, 0x09, 0x30, 0x09, 0x31, 0x15, 0x81, 0x25, 0x7F, 0x75, 0x08, 0x95, 0x02, 0x81, 0x06,
+	0xC0, 0xC0
+};
+
+/*  ǰ׺ֽڣbSize(0,1,2,4 ֽ) bType bTagHID_ITEM_TYPE_xxx / xxx_TAG_xxx  usbh_hid_core.h */
+#define HID_ITEM_BYTES(b)		(((b) & 3) == 3 ? 4 : ((b) & 3))
+#define HID_ITEM_TYPE(b)		(((b) >> 2) & 3)
+#define HID_ITEM_TAG(b)			((b) >> 4)
+
+/* õ Usage Page / Usage */
+#define HID_PAGE_DESKTOP		0x01
+#define HID_PAGE_SIMULATION		0x02
+#define HID_PAGE_KEYBOARD		0x07
+#define HID_PAGE_BUTTON			0x09
+#define HID_USAGE_X				0x30
+#define HID_USAGE_WHEEL			0x38
+#define HID_USAGE_HAT			0x39
+#define HID_USAGE_THROTTLE		0xBB
+#define HID_USAGE_LEFT_CTRL		0xE0
+#define HID_USAGE_RIGHT_GUI		0xE7
+
+/* Input  ı־λ */
+#define HID_IN_CONST			0x01
+#define HID_IN_VARIABLE			0x02
+#define HID_IN_RELATIVE			0x04
+
+#define HID_PARSE_STACK			2		/* Push/Pop  */
+
+typedef struct
+{
+	uint16_t page;
+	int32_t  min;
+	int32_t  max;
+	uint32_t max_u;		/* ߼ ޷Ŷֵ (е豸 0~255 д 25 FF) */
+	uint8_t  size;
+	uint16_t count;
+	uint8_t  id;
+} HID_Global_TypeDef;
+
+typedef struct
+{
+	HID_Global_TypeDef g;
+	HID_Global_TypeDef stack[HID_PARSE_STACK];
+	uint8_t  sp;
+	uint32_t usage[HID_PARSE_USAGE];	/*  16 λ Usage Page */
+	uint8_t  nusage;
+	uint32_t umin;
+	uint32_t umax;
+	uint8_t  range;						/* 1: Usage Minimum~Maximum */
+	uint8_t  id[HID_MAX_REPORT_ID];		/* ÿ Report ID  Input λƫ */
+	uint16_t off[HID_MAX_REPORT_ID];
+	uint8_t  nid;
+} HID_Parser_TypeDef;
+
+static uint32_t hid_item_u(const uint8_t *p, uint8_t n)
+{
+	uint32_t v = 0;
+	while (n--) v = (v << 8) | p[n];
+	return v;
+}
+
+static int32_t hid_item_s(const uint8_t *p, uint8_t n)
+{
+	uint32_t v = hid_item_u(p, n);
+	if (n && n < 4 && (v >> (n * 8 - 1)) & 1) v |= 0xFFFFFFFFUL << (n * 8);
+	return (int32_t)v;
+}
+
+/* ǰ Report ID  Input λƫ (һμͼһ) */
+static uint16_t *hid_offset(HID_Parser_TypeDef *ps)
+{
+	uint8_t i;
+	for (i = 0; i < ps->nid; i++)
+		if (ps->id[i] == ps->g.id) return &ps->off[i];
+	if (ps->nid < HID_MAX_REPORT_ID) ps->nid++;
+	i = ps->nid - 1;	/* ˾͸һãȡֵ Խ */
+	ps->id[i] = ps->g.id;
+	ps->off[i] = 0;
+	return &ps->off[i];
+}
+
+/*  i ֵӦ Usage */
+static uint32_t hid_usage(const HID_Parser_TypeDef *ps, uint16_t i)
+{
+	if (ps->nusage) return ps->usage[i < ps->nusage ? i : ps->nusage - 1];
+	if (ps->range) return ps->umin + i <= ps->umax ? ps->umin + i : ps->umax;
+	return 0;
+}
+
+static HID_Field_TypeDef *hid_add(HID_Map_TypeDef *map, const HID_Parser_TypeDef *ps,
+								  uint16_t bit, uint8_t size, uint8_t type, uint8_t index)
+{
+	HID_Field_TypeDef *f;
+	int32_t max = ps->g.max;
+	if (map->num >= HID_MAX_FIELD) {
+		map->skipped++;
+		return 0;
+	}
+	if (ps->g.min >= 0 && max < ps->g.min) max = (int32_t)ps->g.max_u;
+	f = &map->field[map->num];
+	f->bit = bit;
+	f->size = size;
+	f->type = type;
+	f->index = index;
+	f->report_id = ps->g.id;
+	f->sign = ps->g.min < 0;
+	f->min = ps->g.min;
+	f->range = (uint32_t)max - (uint32_t)ps->g.min;
+	f->scale = f->range ? (HID_AXIS_MAX << 16) / f->range : 0;
+	if (type == HID_FIELD_AXIS && f->range == 0) return 0;	/* ûзΧ Ҫ */
+	map->num++;
+	return f;
+}
+
+/*  1 λ/μ ӵһֶκ棬һȡ */
+static void hid_add_bit(HID_Map_TypeDef *map, const HID_Parser_TypeDef *ps,
+						uint16_t bit, uint8_t type, uint8_t index)
+{
+	HID_Field_TypeDef *f = map->num ? &map->field[map->num - 1] : 0;
+	if (f && f->type == type && f->report_id == ps->g.id && f->size < 32
+		&& f->bit + f->size == bit && f->index + f->size == index)
+	{
+		f->size++;
+		return;
+	}
+	hid_add(map, ps, bit, 1, type, index);
+}
+
+/* һ Input  Usage ÿֵ ŵģϲֻռλ */
+static void hid_input(HID_Map_TypeDef *map, HID_Parser_TypeDef *ps, uint32_t flags)
+{
+	uint16_t *off = hid_offset(ps);
+	uint16_t bit = *off, i, page, id;
+	uint8_t size = ps->g.size;
+	uint32_t u;
+
+	*off += (uint16_t)size * ps->g.count;
+	if ((flags & HID_IN_CONST) || size == 0 || size > 32) return;
+
+	if (!(flags & HID_IN_VARIABLE))	/* 飺ֻϼ µļ */
+	{
+		if ((hid_usage(ps, 0) >> 16) != HID_PAGE_KEYBOARD) return;
+		for (i = 0; i < ps->g.count && i < HID_KEY_NUM; i++)
+			hid_add(map, ps, bit + i * size, size, HID_FIELD_KEY, i);
+		return;
+	}
+
+	for (i = 0; i < ps->g.count; i++, bit += size)
+	{
+		u = hid_usage(ps, i);
+		page = u >> 16;
+		id = u & 0xFFFF;
+		if (page == HID_PAGE_BUTTON && size == 1 && id >= 1 && id <= 32)
+			hid_add_bit(map, ps, bit, HID_FIELD_BUTTON, id - 1);
+		else if (page == HID_PAGE_KEYBOARD && size == 1 && id >= HID_USAGE_LEFT_CTRL && id <= HID_USAGE_RIGHT_GUI)
+			hid_add_bit(map, ps, bit, HID_FIELD_MODIFIER, id - HID_USAGE_LEFT_CTRL);
+		else if (page == HID_PAGE_DESKTOP && id >= HID_USAGE_X && id <= HID_USAGE_WHEEL)
+			hid_add(map, ps, bit, size, (flags & HID_IN_RELATIVE) ? HID_FIELD_REL : HID_FIELD_AXIS, id - HID_USAGE_X);
+		else if (page == HID_PAGE_SIMULATION && id == HID_USAGE_THROTTLE)
+			hid_add(map, ps, bit, size, HID_FIELD_AXIS, HID_AXIS_SLIDER);
+		else if (page == HID_PAGE_DESKTOP && id == HID_USAGE_HAT)
+			hid_add(map, ps, bit, size, HID_FIELD_HAT, 0);
+	}
+}
+
+/* ֶα
+   ֵ: ֶ (0:ûõֶ) */
+uint8_t HID_Parse(const uint8_t *desc, uint16_t len, HID_Map_TypeDef *map)
+{
+	HID_Parser_TypeDef ps;
+	const uint8_t *p = desc, *end = desc + len;
+	uint8_t b, n;
+	uint32_t u;
+
+	memset(map, 0, sizeof(*map));
+	memset(&ps, 0, sizeof(ps));
+	while (p < end)
+	{
+		b = *p++;
+		if (b == HID_ITEM_LONG)	/*  */
+		{
+			if (end - p < 2) break;
+			p += 2 + p[0];
+			continue;
+		}
+		n = HID_ITEM_BYTES(b);
+		if (end - p < n) break;
+		u = hid_item_u(p, n);
+
+		switch (HID_ITEM_TYPE(b))
+		{
+		case HID_ITEM_TYPE_MAIN:
+			if (HID_ITEM_TAG(b) == HID_MAIN_ITEM_TAG_INPUT) hid_input(map, &ps, u);
+			ps.nusage = 0;	/* Main ֮ Local  */
+			ps.range = 0;
+			break;
+
+		case HID_ITEM_TYPE_GLOBAL:
+			switch (HID_ITEM_TAG(b))
+			{
+			case HID_GLOBAL_ITEM_TAG_USAGE_PAGE:	ps.g.page = u; break;
+			case HID_GLOBAL_ITEM_TAG_LOG_MIN:		ps.g.min = hid_item_s(p, n); break;
+			case HID_GLOBAL_ITEM_TAG_LOG_MAX:		ps.g.max = hid_item_s(p, n); ps.g.max_u = u; break;
+			case HID_GLOBAL_ITEM_TAG_REPORT_SIZE:	ps.g.size = u > 32 ? 0 : u; break;
+			case HID_GLOBAL_ITEM_TAG_REPORT_COUNT:	ps.g.count = u; break;
+			case HID_GLOBAL_ITEM_TAG_REPORT_ID:		ps.g.id = u; map->has_id = 1; break;
+			case HID_GLOBAL_ITEM_TAG_PUSH:
+				if (ps.sp < HID_PARSE_STACK) ps.stack[ps.sp++] = ps.g;
+				break;
+			case HID_GLOBAL_ITEM_TAG_POP:
+				if (ps.sp) ps.g = ps.stack[--ps.sp];
+				break;
+			default: break;
+			}
+			break;
+
+		case HID_ITEM_TYPE_LOCAL:
+			if (n <= 2) u |= (uint32_t)ps.g.page << 16;	/*  Usage õǰ Usage Page */
+			switch (HID_ITEM_TAG(b))
+			{
+			case HID_LOCAL_ITEM_TAG_USAGE:
+				if (ps.nusage < HID_PARSE_USAGE) ps.usage[ps.nusage++] = u;
+				break;
+			case HID_LOCAL_ITEM_TAG_USAGE_MIN:	ps.umin = u; ps.range = 1; break;
+			case HID_LOCAL_ITEM_TAG_USAGE_MAX:	ps.umax = u; ps.range = 1; break;
+			default: break;
+			}
+			break;
+
+		default: break;
+		}
+		p += n;
+	}
+	return map->num;
+}
+
+/*  data  bit λ ȡ size λ (λǰ) 5 ֽ */
+static uint32_t hid_bits(const uint8_t *data, uint16_t bit, uint8_t size)
+{
+	const uint8_t *p = data + (bit >> 3);
+	uint8_t sh = bit & 7, n = (sh + size + 7) >> 3, i;
+	uint64_t v = 0;
+	for (i = 0; i < n; i++) v |= (uint64_t)p[i] << (i * 8);
+	v >>= sh;
+	return size >= 32 ? (uint32_t)v : (uint32_t)v & ((1UL << size) - 1);
+}
+
+/* һ ֶαȡֵ Ž in (ûֵֶ ԭֵ һ㣬
+    Report ID  ̵̫ı  MOUSE_Decode һελ һ) */
+void HID_Extract(const HID_Map_TypeDef *map, const uint8_t *data, uint16_t len, HID_Input_TypeDef *in)
+{
+	const HID_Field_TypeDef *f = map->field, *end = map->field + map->num;
+	uint32_t bits, v, mask;
+	int64_t d;
+	uint8_t id = 0, i;
+
+	for (i = 0; i < HID_AXIS_NUM; i++) in->rel[i] = 0;
+	if (map->has_id)
+	{
+		if (len == 0) return;
+		id = *data++;
+		len--;
+	}
+	in->report_id = id;
+	bits = (uint32_t)len * 8;
+
+	for (; f < end; f++)
+	{
+		if (f->report_id != id || f->bit + f->size > bits) continue;
+		v = hid_bits(data, f->bit, f->size);
+		if (f->sign && f->size < 32 && (v >> (f->size - 1)) & 1) v |= 0xFFFFFFFFUL << f->size;
+		switch (f->type)
+		{
+		case HID_FIELD_AXIS:
+			d = (f->sign ? (int64_t)(int32_t)v : (int64_t)v) - f->min;
+			if (d < 0) d = 0;
+			else if (d > f->range) d = f->range;
+			v = (uint32_t)(((uint64_t)d * f->scale + 0x8000) >> 16);	/*  */
+			in->axis[f->index] = v > HID_AXIS_MAX ? HID_AXIS_MAX : v;
+			break;
+		case HID_FIELD_REL:
+			d = f->sign ? (int32_t)v : (int64_t)v;
+			in->rel[f->index] = d > 32767 ? 32767 : (d < -32768 ? -32768 : (int16_t)d);
+			break;
+		case HID_FIELD_BUTTON:
+			mask = (f->size >= 32 ? 0xFFFFFFFFUL : ((1UL << f->size) - 1)) << f->index;
+			in->button = (in->button & ~mask) | ((v << f->index) & mask);
+			break;
+		case HID_FIELD_MODIFIER:
+			mask = ((1UL << f->size) - 1) << f->index;
+			in->modifier = (in->modifier & ~mask) | ((v << f->index) & mask);
+			break;
+		case HID_FIELD_HAT:	/* ߼Χ = û4 ñ Ҳ 0~7 */
+			d = (f->sign ? (int64_t)(int32_t)v : (int64_t)v) - f->min;
+			in->hat = (d < 0 || d > f->range) ? HID_HAT_NULL : (uint8_t)(d * 8 / ((int64_t)f->range + 1));
+			break;
+		case HID_FIELD_KEY:
+			in->key[f->index] = v;
+			break;
+		default: break;
+		}
+	}
+}
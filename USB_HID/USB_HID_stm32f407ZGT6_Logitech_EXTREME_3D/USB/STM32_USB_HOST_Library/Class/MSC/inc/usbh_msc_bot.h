@@ -99,6 +99,7 @@ uint8_t* pRxTxBuff;
 uint16_t DataLength;
 uint8_t BOTXferErrorCount;
 uint8_t BOTXferStatus;
+uint8_t* (*NextSeg)(void);  /* Next data buffer every USBH_MSC_PAGE_LENGTH bytes (0: one contiguous buffer) */
 } USBH_BOTXfer_TypeDef;
 
 
@@ -38,6 +38,7 @@
 #include "usbh_msc_core.h"
 #include "usbh_msc_scsi.h"
 #include "usbh_msc_bot.h"
+#include "usbh_msc_queue.h"
 
 /** @addtogroup USBH_LIB
   * @{
@@ -108,6 +109,7 @@ MSC_Machine_TypeDef;
 extern USBH_Class_cb_TypeDef  USBH_MSC_cb;
 extern MSC_Machine_TypeDef    MSC_Machine;
 extern uint8_t MSCErrorCount;
+extern const MSCQ_Backend_TypeDef USBH_MSC_Backend;   /* Request queue backend for the attached device */
 
 /**
   * @}
@@ -0,0 +1,105 @@
+//
+// U д  ()
+//
+
+#ifndef __USBH_MSC_QUEUE_H
+#define __USBH_MSC_QUEUE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/** ԭ disk_read/disk_write ÿζ do{ Read10; HandleBOTXfer; }while(BUSY) ȣ
+	ļϵͳһд ѭͣסڸĳ Ŷ 
+		MSCQ_Submit  (, LBA, , , ص) Ž Ϸأ
+		MSCQ_Process ѭ (USBH_MSC_Handle ʱ) һһƣ
+			ͷ   ͬLBA ӵϵ ƴһ READ10/WRITE10 ( MSCQ_MAX_SECT )
+			ݽ׶  ӸԼĻ ֱշ (MSCQ_Segment)
+			 ˳ÿĻص
+	ύ˳ִ (д ͬһ )
+	˿ɻUSBH_MSC_Backend (usbh_msc_core.c BOT) / MSCQ_RamDisk (һ RAMϲ)
+	ص MSCQ_Process  (ѭ)ص MSCQ_Submit
+
+	BOT  (usbh_msc_bot.c / usbh_msc_core.c) Ϊиĵĵط
+		USBH_BOTXfer_TypeDef.NextSegݽ׶ ÿһ һ һ黺壬
+			 64/512  һ飻0 ʱһ (ʼ)
+		OUT  NAK ԭطһ (ָͳ)ԭ datapointer һ
+			һ  ջ˻ ƴ
+		˷ʱ  MSCStateCurrent ɿУCSW صУ
+			Ȼصһʼ״̬ ٷһ飻
+		CSW ʧ ֻʧܣȥ REQUEST_SENSE (·Ῠס ŵ disk_read)
+			PHASE_ERROR ԭһ  UNRECOVERED֮ȫʧܣεʱ MSCQ_Abort
+
+	FatFs ӿ (usbh_msc_fatfs.c) ҲУ 8 棺
+		д ŶӾͷ (д) Լƴһ WRITE10
+			һд >= 8  ֱõߵĻ () һ ꣬⼸ϣ
+		е ֱӿûе һ ֱӶ߻ (һ READ10)
+			˳ʱ ˳Ѻ 4  Ԥ (FatFs һʱ һѾڴ)
+		а˳ִУŵд һȺŵĶȵ Ụݣ
+		CTRL_SYNC ȶգдʧ һ disk_write / CTRL_SYNC  RES_ERROR */
+
+#define MSCQ_N				16		/*  ༸ */
+#define MSCQ_MAX_SECT		64		/* һ ༸ (32K) */
+#define MSCQ_SECTOR			512
+
+#define MSCQ_READ			0
+#define MSCQ_WRITE			1
+
+/*  USBH_MSC_Status_TypeDef һֵ */
+#define MSCQ_OK				0
+#define MSCQ_FAIL			1
+#define MSCQ_BUSY			3
+
+typedef void (*MSCQ_Callback)(void *ctx, uint8_t status);	/* status: MSCQ_OK / MSCQ_FAIL */
+
+typedef struct
+{
+	uint8_t  *buf;			/* count*MSCQ_SECTOR ֽ */
+	uint32_t lba;
+	uint16_t count;
+	uint8_t  dir;			/* MSCQ_READ / MSCQ_WRITE */
+	MSCQ_Callback cb;		/* Ϊ 0 */
+	void     *ctx;
+} MSCQ_Req_TypeDef;
+
+typedef struct
+{
+	uint8_t  (*Ready)(void);		/* 1:豸 ã0:ȫʧܽ */
+	uint8_t  (*Start)(uint8_t dir, uint32_t lba, uint16_t count);	/* 0:ѷ 1:ڲ ´ */
+	uint8_t  (*Poll)(void);			/* MSCQ_BUSY / MSCQ_OK / MSCQ_FAIL */
+	uint32_t (*Capacity)(void);		/*  */
+} MSCQ_Backend_TypeDef;
+
+typedef struct
+{
+	uint32_t cmds;			/* ȥ READ10/WRITE10  */
+	uint32_t sectors;		/*  */
+	uint32_t merged;		/* ƴ */
+	uint32_t fails;			/* ʧܵ (εʱ) */
+	uint8_t  depth_max;		/*  */
+} MSCQ_Stat_TypeDef;
+
+extern MSCQ_Stat_TypeDef MSCQ_Stat;
+extern const MSCQ_Backend_TypeDef MSCQ_RamDisk;
+
+void     MSCQ_Init(const MSCQ_Backend_TypeDef *be);	/* ˣն (ʧܻص) */
+uint8_t  MSCQ_Submit(uint8_t dir, uint8_t *buf, uint32_t lba, uint16_t count,
+                     MSCQ_Callback cb, void *ctx);	/* 0: 1: */
+void     MSCQ_Process(void);
+void     MSCQ_Abort(void);		/* е ȫʧܽ (صŵ ) */
+uint8_t  MSCQ_Ready(void);
+uint8_t  MSCQ_Idle(void);		/* 1:п */
+uint8_t  MSCQ_Free(void);		/* лмλ */
+uint32_t MSCQ_Capacity(void);
+uint8_t *MSCQ_Segment(void);	/* ãǰ һĻ壬ͷȡһ */
+void     MSCQ_Stat_Reset(void);
+
+void     MSCQ_RamDisk_Init(uint8_t *mem, uint32_t sectors);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__USBH_MSC_QUEUE_H
@@ -94,6 +94,7 @@ __ALIGN_BEGIN HostCSWPkt_TypeDef USBH_MSC_CSWData __ALIGN_END ;
 
 
 static uint32_t BOTStallErrorCount;   /* Keeps count of STALL Error Cases*/
+static uint32_t BOTSegmentLeft;       /* Bytes left in the current data segment */
 
 /**
 * @}
@@ -138,10 +139,40 @@ void USBH_MSC_Init(USB_OTG_CORE_HANDLE *pdev )
     USBH_MSC_BOTXferParam.CmdStateMachine = CMD_SEND_STATE;  
   }
   
+  USBH_MSC_BOTXferParam.NextSeg = 0;
   BOTStallErrorCount = 0;
   MSCErrorCount = 0;
 }
 
+/**
+* @brief  USBH_MSC_BOT_Advance
+*         Advance the data stage pointer; switch to the buffer returned by
+*         NextSeg at each page boundary (MPS divides the page length)
+* @param  p : current data pointer
+* @param  len : bytes just transferred
+* @retval Next data pointer
+*/
+static uint8_t *USBH_MSC_BOT_Advance(uint8_t *p, uint16_t len)
+{
+  uint8_t *next;
+  
+  p += len;
+  if(USBH_MSC_BOTXferParam.NextSeg != 0)
+  {
+    BOTSegmentLeft -= len;
+    if(BOTSegmentLeft == 0)
+    {
+      BOTSegmentLeft = USBH_MSC_PAGE_LENGTH;
+      next = USBH_MSC_BOTXferParam.NextSeg();
+      if(next != 0)
+      {
+        p = next;
+      }
+    }
+  }
+  return p;
+}
+
 /**
 * @brief  USBH_MSC_HandleBOTXfer 
 *         This function manages the different states of BOT transfer and 
@@ -153,8 +184,10 @@ void USBH_MSC_Init(USB_OTG_CORE_HANDLE *pdev )
 void USBH_MSC_HandleBOTXfer (USB_OTG_CORE_HANDLE *pdev ,USBH_HOST *phost)
 {
   uint8_t xferDirection, index;
+  uint16_t length;
   static uint32_t remainingDataLength;
   static uint8_t *datapointer , *datapointer_prev;
+  static uint16_t length_prev;
   static uint8_t error_direction;
   USBH_Status status;
   
@@ -193,6 +226,8 @@ void USBH_MSC_HandleBOTXfer (USB_OTG_CORE_HANDLE *pdev ,USBH_HOST *phost)
           remainingDataLength = USBH_MSC_CBWData.field.CBWTransferLength ;
           datapointer = USBH_MSC_BOTXferParam.pRxTxBuff;
           datapointer_prev = datapointer;
+          length_prev = 0;
+          BOTSegmentLeft = USBH_MSC_PAGE_LENGTH;
           
           /* If there is Data Transfer Stage */
           if (xferDirection == USB_D2H)
@@ -233,29 +268,22 @@ void USBH_MSC_HandleBOTXfer (USB_OTG_CORE_HANDLE *pdev ,USBH_HOST *phost)
         BOTStallErrorCount = 0;
         USBH_MSC_BOTXferParam.BOTStateBkp = USBH_MSC_BOT_DATAIN_STATE;    
         
-        if(remainingDataLength > MSC_Machine.MSBulkInEpSize)
-        {
-          USBH_BulkReceiveData (pdev,
-	                        datapointer, 
-			        MSC_Machine.MSBulkInEpSize , 
-			        MSC_Machine.hc_num_in);
-          
-          remainingDataLength -= MSC_Machine.MSBulkInEpSize;
-          datapointer = datapointer + MSC_Machine.MSBulkInEpSize;
-        }
-        else if ( remainingDataLength == 0)
+        if ( remainingDataLength == 0)
         {
           /* If value was 0, and successful transfer, then change the state */
           USBH_MSC_BOTXferParam.BOTState = USBH_MSC_RECEIVE_CSW_STATE;
         }
         else
-        {       
+        {
+          length = (remainingDataLength > MSC_Machine.MSBulkInEpSize) ?
+                    MSC_Machine.MSBulkInEpSize : remainingDataLength;
           USBH_BulkReceiveData (pdev,
 	                        datapointer, 
-			        remainingDataLength , 
+			        length , 
 			        MSC_Machine.hc_num_in);
           
-          remainingDataLength = 0; /* Reset this value and keep in same state */
+          remainingDataLength -= length;
+          datapointer = USBH_MSC_BOT_Advance(datapointer, length);
         }
       }
       else if(URB_Status == URB_STALL)
@@ -288,47 +316,35 @@ void USBH_MSC_HandleBOTXfer (USB_OTG_CORE_HANDLE *pdev ,USBH_HOST *phost)
       {
         BOTStallErrorCount = 0;
         USBH_MSC_BOTXferParam.BOTStateBkp = USBH_MSC_BOT_DATAOUT_STATE;    
-        if(remainingDataLength > MSC_Machine.MSBulkOutEpSize)
-        {
-          USBH_BulkSendData (pdev,
-                             datapointer, 
-                             MSC_Machine.MSBulkOutEpSize , 
-                             MSC_Machine.hc_num_out);
-          datapointer_prev = datapointer;
-          datapointer = datapointer + MSC_Machine.MSBulkOutEpSize;
-          
-          remainingDataLength = remainingDataLength - MSC_Machine.MSBulkOutEpSize;
-        }
-        else if ( remainingDataLength == 0)
+        if ( remainingDataLength == 0)
         {
           /* If value was 0, and successful transfer, then change the state */
           USBH_MSC_BOTXferParam.BOTState = USBH_MSC_RECEIVE_CSW_STATE;
         }
         else
         {
+          length = (remainingDataLength > MSC_Machine.MSBulkOutEpSize) ?
+                    MSC_Machine.MSBulkOutEpSize : remainingDataLength;
           USBH_BulkSendData (pdev,
-	                     datapointer, 
-			     remainingDataLength , 
-			     MSC_Machine.hc_num_out);
+                             datapointer, 
+                             length , 
+                             MSC_Machine.hc_num_out);
+          datapointer_prev = datapointer;
+          length_prev = length;
+          datapointer = USBH_MSC_BOT_Advance(datapointer, length);
           
-          remainingDataLength = 0; /* Reset this value and keep in same state */   
+          remainingDataLength -= length;
         }      
       }
       
       else if(URB_Status == URB_NOTREADY)
       {
-        if(datapointer != datapointer_prev)
-        {
-          USBH_BulkSendData (pdev,
-                             (datapointer - MSC_Machine.MSBulkOutEpSize), 
-                             MSC_Machine.MSBulkOutEpSize , 
-                             MSC_Machine.hc_num_out);
-        }
-        else
+        /* NAK: resend the last packet with its own pointer and length */
+        if(length_prev != 0)
         {
           USBH_BulkSendData (pdev,
-                             datapointer,
-                             MSC_Machine.MSBulkOutEpSize , 
+                             datapointer_prev, 
+                             length_prev , 
                              MSC_Machine.hc_num_out);
         }
       }
@@ -42,6 +42,7 @@
 #include "usbh_msc_core.h"
 #include "usbh_msc_scsi.h"
 #include "usbh_msc_bot.h"
+#include "usbh_msc_queue.h"
 #include "usbh_core.h"
 
 
@@ -104,6 +105,9 @@ __ALIGN_BEGIN MSC_Machine_TypeDef         MSC_Machine __ALIGN_END ;
 __ALIGN_BEGIN USB_Setup_TypeDef           MSC_Setup __ALIGN_END ;
 uint8_t MSCErrorCount = 0;
 
+static USB_OTG_CORE_HANDLE *MSC_pdev = 0;   /* Saved at attach for the queue backend */
+static USBH_HOST           *MSC_phost = 0;
+
 
 /**
   * @}
@@ -218,6 +222,9 @@ static USBH_Status USBH_MSC_InterfaceInit ( USB_OTG_CORE_HANDLE *pdev,
                         EP_TYPE_BULK,
                         MSC_Machine.MSBulkInEpSize);    
     
+    MSC_pdev = pdev;
+    MSC_phost = pphost;
+    MSCQ_Init(&USBH_MSC_Backend);
   }
   
   else
@@ -240,6 +247,9 @@ static USBH_Status USBH_MSC_InterfaceInit ( USB_OTG_CORE_HANDLE *pdev,
 void USBH_MSC_InterfaceDeInit ( USB_OTG_CORE_HANDLE *pdev,
                                 void *phost)
 {	
+  MSC_pdev = 0;
+  MSCQ_Abort();   /* Fail all pending requests */
+  
   if ( MSC_Machine.hc_num_out)
   {
     USB_OTG_HC_Halt(pdev, MSC_Machine.hc_num_out);
@@ -433,6 +443,8 @@ static USBH_Status USBH_MSC_Handle(USB_OTG_CORE_HANDLE *pdev ,
       break;
     
     case USBH_MSC_DEFAULT_APPLI_STATE:
+      /* Advance the request queue */
+      MSCQ_Process();
       /* Process Application callback for MSC */
       appliStatus = pphost->usr_cb->UserApplication();
       if(appliStatus == 0)
@@ -543,6 +555,110 @@ void USBH_MSC_ErrorHandle(uint8_t status)
     }
 }
 
+/*------------------------- Request queue backend -------------------------*/
+
+/**
+  * @brief  USBH_MSC_BE_Ready 
+  *         Device attached and enumerated (idle or transferring)
+  * @param  None
+  * @retval 1 if ready
+  */
+static uint8_t USBH_MSC_BE_Ready(void)
+{
+  return (MSC_pdev != 0) && HCD_IsDeviceConnected(MSC_pdev) &&
+         ((USBH_MSC_BOTXferParam.MSCState == USBH_MSC_DEFAULT_APPLI_STATE) ||
+          (USBH_MSC_BOTXferParam.MSCState == USBH_MSC_BOT_USB_TRANSFERS));
+}
+
+/**
+  * @brief  USBH_MSC_BE_Start 
+  *         Issue READ10/WRITE10; the data stage takes one buffer per sector
+  *         from the queue
+  * @param  dir : MSCQ_READ or MSCQ_WRITE
+  * @param  lba : first sector
+  * @param  count : number of sectors
+  * @retval 0 if the command was issued, 1 if busy
+  */
+static uint8_t USBH_MSC_BE_Start(uint8_t dir, uint32_t lba, uint16_t count)
+{
+  uint8_t *buff;
+  
+  if((USBH_MSC_BOTXferParam.MSCState != USBH_MSC_DEFAULT_APPLI_STATE) ||
+     (USBH_MSC_BOTXferParam.CmdStateMachine != CMD_SEND_STATE))
+  {
+    return 1;
+  }
+  buff = MSCQ_Segment();
+  USBH_MSC_BOTXferParam.NextSeg = MSCQ_Segment;
+  /* Return to the application state after the CSW */
+  USBH_MSC_BOTXferParam.MSCStateCurrent = USBH_MSC_DEFAULT_APPLI_STATE;
+  if(dir == MSCQ_READ)
+  {
+    USBH_MSC_Read10(MSC_pdev, buff, lba, (uint32_t)count * USBH_MSC_PAGE_LENGTH);
+  }
+  else
+  {
+    USBH_MSC_Write10(MSC_pdev, buff, lba, (uint32_t)count * USBH_MSC_PAGE_LENGTH);
+  }
+  return 0;
+}
+
+/**
+  * @brief  USBH_MSC_BE_Poll 
+  *         Check the current command, running the BOT state machine when
+  *         called outside USBH_Process
+  * @param  None
+  * @retval MSCQ_BUSY, MSCQ_OK or MSCQ_FAIL
+  */
+static uint8_t USBH_MSC_BE_Poll(void)
+{
+  uint8_t status = USBH_MSC_BOTXferParam.BOTXferStatus;
+  
+  if(status == USBH_MSC_BUSY)
+  {
+    if(USBH_MSC_BOTXferParam.MSCState == USBH_MSC_BOT_USB_TRANSFERS)
+    {
+      USBH_MSC_HandleBOTXfer(MSC_pdev, MSC_phost);
+    }
+    status = USBH_MSC_BOTXferParam.BOTXferStatus;
+    if(status == USBH_MSC_BUSY)
+    {
+      return MSCQ_BUSY;
+    }
+  }
+  
+  USBH_MSC_BOTXferParam.CmdStateMachine = CMD_SEND_STATE;
+  USBH_MSC_BOTXferParam.NextSeg = 0;
+  if(status == USBH_MSC_OK)
+  {
+    MSCErrorCount = 0;
+    return MSCQ_OK;
+  }
+  if(status == USBH_MSC_PHASE_ERROR)
+  {
+    USBH_MSC_ErrorHandle(status);   /* Go to unrecovered state */
+  }
+  return MSCQ_FAIL;                 /* Command failed, no REQUEST_SENSE */
+}
+
+/**
+  * @brief  USBH_MSC_BE_Capacity 
+  *         Number of sectors reported by READ_CAPACITY10
+  * @param  None
+  * @retval Sector count
+  */
+static uint32_t USBH_MSC_BE_Capacity(void)
+{
+  return USBH_MSC_Param.MSCapacity;
+}
+
+const MSCQ_Backend_TypeDef USBH_MSC_Backend = {
+  USBH_MSC_BE_Ready,
+  USBH_MSC_BE_Start,
+  USBH_MSC_BE_Poll,
+  USBH_MSC_BE_Capacity,
+};
+
 /**
   * @}
   */ 
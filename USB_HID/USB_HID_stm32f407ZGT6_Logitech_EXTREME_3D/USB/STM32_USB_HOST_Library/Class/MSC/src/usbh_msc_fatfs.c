@@ -1,17 +1,136 @@
 
-#include "usb_conf_usr.h"
+#include <string.h>
 #include "diskio.h"
-#include "usbh_msc_core.h"
+#include "usbh_msc_queue.h"
 /*--------------------------------------------------------------------------
 
 Module Private Functions and Variables
 
+Sector I/O goes through the request queue (usbh_msc_queue.h) with a small
+write-behind / read-ahead sector cache.
+
 ---------------------------------------------------------------------------*/
 
+#define MSC_CACHE_N			8		/* Cache lines, one sector each */
+#define MSC_READ_AHEAD		4		/* Sectors prefetched on sequential reads */
+
+#define LINE_FREE			0
+#define LINE_VALID			1		/* Same as on the device */
+#define LINE_READ			2		/* Read-ahead pending */
+#define LINE_WRITE			3		/* Dirty, write queued */
+
+typedef struct
+{
+	DWORD   lba;
+	DWORD   used;					/* LRU stamp */
+	BYTE    state;
+} MSC_Line_TypeDef;
+
 static volatile DSTATUS Stat = STA_NOINIT;	/* Disk status */
 
-extern USB_OTG_CORE_HANDLE  USB_OTG_Core;
-extern USBH_HOST  USB_Host;
+static BYTE MSC_Cache[MSC_CACHE_N][MSCQ_SECTOR];
+static MSC_Line_TypeDef MSC_Line[MSC_CACHE_N];
+static DWORD MSC_Tick;					/* LRU counter */
+static DWORD MSC_NextLba;				/* End of the last read, for sequential detection */
+static BYTE  MSC_WriteErr;				/* A queued write failed */
+
+static void MSC_Done(void *ctx, uint8_t status)
+{
+	*(volatile BYTE *)ctx = status;
+}
+
+static void MSC_LineDone(void *ctx, uint8_t status)
+{
+	MSC_Line_TypeDef *l = ctx;
+	if (status != MSCQ_OK)
+	{
+		if (l->state == LINE_WRITE) MSC_WriteErr = 1;
+		l->state = LINE_FREE;
+	}
+	else if (l->state == LINE_WRITE && l->used == 0)
+	{
+		l->state = LINE_FREE;				/* Overwritten by a direct write while in flight */
+	}
+	else
+	{
+		l->state = LINE_VALID;
+	}
+}
+
+/* Wait for a request to complete (detach fails it) */
+static BYTE MSC_Wait(volatile BYTE *flag)
+{
+	while (*flag == MSCQ_BUSY) MSCQ_Process();
+	return *flag;
+}
+
+/* Submit, running the queue while it is full */
+static BYTE MSC_Submit(BYTE dir, BYTE *buf, DWORD lba, WORD count, MSCQ_Callback cb, void *ctx)
+{
+	while (MSCQ_Submit(dir, buf, lba, count, cb, ctx))
+	{
+		if (!MSCQ_Ready()) return 1;
+		MSCQ_Process();
+	}
+	return 0;
+}
+
+static MSC_Line_TypeDef *MSC_Find(DWORD lba)
+{
+	BYTE i;
+	for (i = 0; i < MSC_CACHE_N; i++)
+	{
+		if (MSC_Line[i].state != LINE_FREE && MSC_Line[i].lba == lba) return &MSC_Line[i];
+	}
+	return 0;
+}
+
+/* Free line or least recently used valid line, 0 if all busy */
+static MSC_Line_TypeDef *MSC_Alloc(DWORD lba)
+{
+	MSC_Line_TypeDef *l, *best = 0;
+	BYTE i;
+	for (i = 0; i < MSC_CACHE_N; i++)
+	{
+		l = &MSC_Line[i];
+		if (l->state == LINE_FREE)
+		{
+			best = l;
+			break;
+		}
+		if (l->state == LINE_VALID && (best == 0 || l->used < best->used)) best = l;
+	}
+	if (best)
+	{
+		best->lba = lba;
+		best->used = ++MSC_Tick;
+	}
+	return best;
+}
+
+#define MSC_LINE_BUF(l)		(MSC_Cache[(l) - MSC_Line])
+
+/* Wait until the line is not in flight */
+static void MSC_LineIdle(MSC_Line_TypeDef *l)
+{
+	while (l->state == LINE_READ || l->state == LINE_WRITE) MSCQ_Process();
+}
+
+static void MSC_ReadAhead(DWORD lba)
+{
+	MSC_Line_TypeDef *l;
+	DWORD end = lba + MSC_READ_AHEAD;
+	DWORD cap = MSCQ_Capacity();
+	for (; lba < end && lba < cap; lba++)
+	{
+		if (MSC_Find(lba)) continue;
+		if (MSCQ_Free() < 2) break;				/* Keep a slot for the request itself */
+		l = MSC_Alloc(lba);
+		if (l == 0) break;
+		l->state = LINE_READ;
+		MSCQ_Submit(MSCQ_READ, MSC_LINE_BUF(l), lba, 1, MSC_LineDone, l);
+	}
+}
 
 /*-----------------------------------------------------------------------*/
 /* Initialize Disk Drive                                                 */
@@ -21,15 +140,21 @@ DSTATUS disk_initialize (
                          BYTE drv		/* Physical drive number (0) */
                            )
 {
-  
-  if(HCD_IsDeviceConnected(&USB_OTG_Core))
-  {  
+  BYTE i;
+
+  if (drv) return STA_NOINIT;
+
+  if(MSCQ_Ready())
+  {
+    for (i = 0; i < MSC_CACHE_N; i++) MSC_Line[i].state = LINE_FREE;	/* May be a different device */
+    MSC_WriteErr = 0;
+    MSC_NextLba = 0;
     Stat &= ~STA_NOINIT;
   }
-  
+
   return Stat;
-  
-  
+
+
 }
 
 
@@ -43,6 +168,7 @@ DSTATUS disk_status (
                        )
 {
   if (drv) return STA_NOINIT;		/* Supports only single drive */
+  if (!MSCQ_Ready()) Stat |= STA_NOINIT;
   return Stat;
 }
 
@@ -59,32 +185,54 @@ DRESULT disk_read (
                    BYTE count			/* Sector count (1..255) */
                      )
 {
-  BYTE status = USBH_MSC_OK;
-  
+  MSC_Line_TypeDef *l;
+  volatile BYTE done[MSC_CACHE_N];	/* Status of each direct read run */
+  BYTE seq = (sector == MSC_NextLba);
+  BYTE i = 0, n, runs = 0, res = MSCQ_OK;
+
   if (drv || !count) return RES_PARERR;
   if (Stat & STA_NOINIT) return RES_NOTRDY;
-  
-  
-  if(HCD_IsDeviceConnected(&USB_OTG_Core))
-  {  
-    
-    do
+  if (!MSCQ_Ready()) return RES_ERROR;
+
+  while (i < count)
+  {
+    l = MSC_Find(sector + i);
+    if (l)
     {
-      status = USBH_MSC_Read10(&USB_OTG_Core, buff,sector,512 * count);
-      USBH_MSC_HandleBOTXfer(&USB_OTG_Core ,&USB_Host);
-      
-      if(!HCD_IsDeviceConnected(&USB_OTG_Core))
-      { 
-        return RES_ERROR;
-      }      
+      if (l->state == LINE_READ) MSC_LineIdle(l);
+      if (l->state != LINE_FREE)
+      {
+        memcpy(buff + (DWORD)i * MSCQ_SECTOR, MSC_LINE_BUF(l), MSCQ_SECTOR);
+        l->used = ++MSC_Tick;
+        i++;
+        continue;
+      }
+    }
+    /* Run of uncached sectors: read straight into buff */
+    for (n = 1; i + n < count && MSC_Find(sector + i + n) == 0; n++);
+    if (runs == MSC_CACHE_N)				/* Too many runs, wait for the earlier ones */
+    {
+      while (runs) if (MSC_Wait(&done[--runs]) != MSCQ_OK) res = MSCQ_FAIL;
+    }
+    done[runs] = MSCQ_BUSY;
+    if (MSC_Submit(MSCQ_READ, buff + (DWORD)i * MSCQ_SECTOR, sector + i, n, MSC_Done, (void *)&done[runs]))
+    {
+      res = MSCQ_FAIL;
+      break;
     }
-    while(status == USBH_MSC_BUSY );
+    runs++;
+    i += n;
   }
-  
-  if(status == USBH_MSC_OK)
+
+  MSC_NextLba = sector + count;
+  if (seq) MSC_ReadAhead(MSC_NextLba);		/* Queued after this read */
+
+  while (runs) if (MSC_Wait(&done[--runs]) != MSCQ_OK) res = MSCQ_FAIL;
+
+  if(res == MSCQ_OK)
     return RES_OK;
   return RES_ERROR;
-  
+
 }
 
 
@@ -101,32 +249,65 @@ DRESULT disk_write (
                     BYTE count			/* Sector count (1..255) */
                       )
 {
-  BYTE status = USBH_MSC_OK;
+  MSC_Line_TypeDef *l;
+  volatile BYTE done;
+  BYTE i;
+
   if (drv || !count) return RES_PARERR;
   if (Stat & STA_NOINIT) return RES_NOTRDY;
   if (Stat & STA_PROTECT) return RES_WRPRT;
-  
-  
-  if(HCD_IsDeviceConnected(&USB_OTG_Core))
-  {  
-    do
+  if (!MSCQ_Ready()) return RES_ERROR;
+
+  if (count >= MSC_CACHE_N)
+  {
+    /* Large write: bypass the cache and drop cached copies */
+    for (i = 0; i < count; i++)
+    {
+      l = MSC_Find(sector + i);
+      if (l == 0) continue;
+      if (l->state == LINE_READ) MSC_LineIdle(l);
+      if (l->state == LINE_WRITE) l->used = 0;
+      else l->state = LINE_FREE;
+    }
+    done = MSCQ_BUSY;
+    if (MSC_Submit(MSCQ_WRITE, (BYTE *)buff, sector, count, MSC_Done, (void *)&done) ||
+        MSC_Wait(&done) != MSCQ_OK)
     {
-      status = USBH_MSC_Write10(&USB_OTG_Core,(BYTE*)buff,sector,512 * count);
-      USBH_MSC_HandleBOTXfer(&USB_OTG_Core, &USB_Host);
-      
-      if(!HCD_IsDeviceConnected(&USB_OTG_Core))
-      { 
+      return RES_ERROR;
+    }
+  }
+  else
+  {
+    for (i = 0; i < count; i++, buff += MSCQ_SECTOR)
+    {
+      l = MSC_Find(sector + i);
+      if (l) MSC_LineIdle(l);				/* Sector in flight, wait before modifying */
+      if (l == 0 || l->state == LINE_FREE)
+      {
+        while ((l = MSC_Alloc(sector + i)) == 0)	/* All lines busy, run the queue */
+        {
+          if (!MSCQ_Ready()) return RES_ERROR;
+          MSCQ_Process();
+        }
+      }
+      memcpy(MSC_LINE_BUF(l), buff, MSCQ_SECTOR);
+      l->used = ++MSC_Tick;
+      l->state = LINE_WRITE;
+      if (MSC_Submit(MSCQ_WRITE, MSC_LINE_BUF(l), sector + i, 1, MSC_LineDone, l))
+      {
+        l->state = LINE_FREE;
         return RES_ERROR;
       }
     }
-    
-    while(status == USBH_MSC_BUSY );
-    
+    MSCQ_Process();						/* Start the transfer now */
   }
-  
-  if(status == USBH_MSC_OK)
-    return RES_OK;
-  return RES_ERROR;
+
+  if (MSC_WriteErr)
+  {
+    MSC_WriteErr = 0;
+    return RES_ERROR;
+  }
+  return RES_OK;
 }
 #endif /* _READONLY == 0 */
 
@@ -144,43 +325,45 @@ DRESULT disk_ioctl (
                       )
 {
   DRESULT res = RES_OK;
-  
+
   if (drv) return RES_PARERR;
-  
+
   res = RES_ERROR;
-  
+
   if (Stat & STA_NOINIT) return RES_NOTRDY;
-  
+
   switch (ctrl) {
   case CTRL_SYNC :		/* Make sure that no pending write process */
-    
-    res = RES_OK;
+
+    do MSCQ_Process(); while (!MSCQ_Idle());	/* Detach aborts the queue */
+    res = MSC_WriteErr ? RES_ERROR : RES_OK;
+    MSC_WriteErr = 0;
     break;
-    
+
   case GET_SECTOR_COUNT :	/* Get number of sectors on the disk (DWORD) */
-    
-    *(DWORD*)buff = (DWORD) USBH_MSC_Param.MSCapacity;
+
+    *(DWORD*)buff = (DWORD) MSCQ_Capacity();
     res = RES_OK;
     break;
-    
+
   case GET_SECTOR_SIZE :	/* Get R/W sector size (WORD) */
-    *(WORD*)buff = 512;
+    *(WORD*)buff = MSCQ_SECTOR;
     res = RES_OK;
     break;
-    
+
   case GET_BLOCK_SIZE :	/* Get erase block size in unit of sector (DWORD) */
-    
+
     *(DWORD*)buff = 512;
-    
+
     break;
-    
-    
+
+
   default:
     res = RES_PARERR;
   }
-  
-  
-  
+
+
+
   return res;
 }
 #endif /* _USE_IOCTL != 0 */
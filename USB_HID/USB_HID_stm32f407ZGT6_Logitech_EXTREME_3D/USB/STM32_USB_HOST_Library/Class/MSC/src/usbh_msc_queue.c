@@ -0,0 +1,247 @@
+//
+// U д У˵ usbh_msc_queue.h
+//
+
+#include "usbh_msc_queue.h"
+#include <string.h>
+
+#define MSCQ_NEXT(i)		(((i) + 1) % MSCQ_N)
+
+MSCQ_Stat_TypeDef MSCQ_Stat;
+
+static const MSCQ_Backend_TypeDef *MSCQ_Be = 0;
+static MSCQ_Req_TypeDef MSCQ_Q[MSCQ_N];
+static uint8_t  MSCQ_Head, MSCQ_Num;		/* ͷ /  (ֻѭģùж) */
+static uint16_t MSCQ_Off;					/* ͷ Ѿ꼸 (һ󳬹 MSCQ_MAX_SECT ʱ ּ) */
+
+/*  */
+static uint8_t  MSCQ_Run;					/* 1:ѷ */
+static uint8_t  MSCQ_RunReq;				/* 漰 (Ӷͷ) */
+static uint16_t MSCQ_RunSect;				/*  */
+static uint8_t  MSCQ_SegReq;				/* MSCQ_Segment ߵ ڼ (Զͷ) */
+static uint16_t MSCQ_SegSect;				/*                ĵڼ */
+static uint16_t MSCQ_SegLeft;				/*                ʣ */
+
+/* Ӷͷһ ٻص (ص Submit) */
+static void MSCQ_Pop(uint8_t status)
+{
+	MSCQ_Req_TypeDef r = MSCQ_Q[MSCQ_Head];
+	MSCQ_Head = MSCQ_NEXT(MSCQ_Head);
+	MSCQ_Num--;
+	MSCQ_Off = 0;
+	if (r.cb) r.cb(r.ctx, status);
+}
+
+void MSCQ_Init(const MSCQ_Backend_TypeDef *be)
+{
+	MSCQ_Abort();
+	MSCQ_Be = be;
+}
+
+uint8_t MSCQ_Submit(uint8_t dir, uint8_t *buf, uint32_t lba, uint16_t count,
+                    MSCQ_Callback cb, void *ctx)
+{
+	MSCQ_Req_TypeDef *r;
+	if (count == 0 || MSCQ_Num >= MSCQ_N) return 1;
+	r = &MSCQ_Q[(MSCQ_Head + MSCQ_Num) % MSCQ_N];
+	r->buf = buf;
+	r->lba = lba;
+	r->count = count;
+	r->dir = dir;
+	r->cb = cb;
+	r->ctx = ctx;
+	MSCQ_Num++;
+	if (MSCQ_Num > MSCQ_Stat.depth_max) MSCQ_Stat.depth_max = MSCQ_Num;
+	return 0;
+}
+
+/* Ӷͷ ƴһͷʣµ + ͬLBA ӵϵ */
+static void MSCQ_Start(void)
+{
+	MSCQ_Req_TypeDef *r = &MSCQ_Q[MSCQ_Head], *n;
+	uint32_t lba = r->lba + MSCQ_Off;
+	uint16_t sect = r->count - MSCQ_Off;
+	uint8_t  req = 1, i;
+
+	if (sect > MSCQ_MAX_SECT) sect = MSCQ_MAX_SECT;
+	else
+	{
+		for (i = MSCQ_NEXT(MSCQ_Head); req < MSCQ_Num; i = MSCQ_NEXT(i))
+		{
+			n = &MSCQ_Q[i];
+			if (n->dir != r->dir || n->lba != lba + sect || sect + n->count > MSCQ_MAX_SECT) break;
+			sect += n->count;
+			req++;
+		}
+	}
+
+	MSCQ_SegReq = 0;
+	MSCQ_SegSect = MSCQ_Off;
+	MSCQ_SegLeft = sect;
+	if (MSCQ_Be->Start(r->dir, lba, sect)) return;		/* æ´ */
+
+	MSCQ_Run = 1;
+	MSCQ_RunReq = req;
+	MSCQ_RunSect = sect;
+	MSCQ_Stat.cmds++;
+	MSCQ_Stat.merged += req - 1;
+}
+
+/* ɹ ƽͷʧ 漰ȫʧ */
+static void MSCQ_Finish(uint8_t status)
+{
+	uint16_t left;
+	uint8_t  req = MSCQ_RunReq;
+	MSCQ_Run = 0;
+	if (status != MSCQ_OK)
+	{
+		MSCQ_Stat.fails++;
+		while (req--) MSCQ_Pop(MSCQ_FAIL);
+		return;
+	}
+	MSCQ_Stat.sectors += MSCQ_RunSect;
+	left = MSCQ_Q[MSCQ_Head].count - MSCQ_Off;
+	if (MSCQ_RunSect < left)				/*  ֻһ */
+	{
+		MSCQ_Off += MSCQ_RunSect;
+		return;
+	}
+	while (req--) MSCQ_Pop(MSCQ_OK);
+}
+
+uint8_t *MSCQ_Segment(void)
+{
+	MSCQ_Req_TypeDef *r;
+	uint8_t *p;
+	if (MSCQ_SegLeft == 0) return 0;		/* һ֮ BOT ȡһ */
+	r = &MSCQ_Q[(MSCQ_Head + MSCQ_SegReq) % MSCQ_N];
+	p = r->buf + (uint32_t)MSCQ_SegSect * MSCQ_SECTOR;
+	MSCQ_SegLeft--;
+	if (++MSCQ_SegSect >= r->count)
+	{
+		MSCQ_SegReq++;
+		MSCQ_SegSect = 0;
+	}
+	return p;
+}
+
+void MSCQ_Process(void)
+{
+	uint8_t status;
+	if (MSCQ_Be == 0) return;
+	if (!MSCQ_Be->Ready())
+	{
+		if (MSCQ_Num) MSCQ_Abort();
+		return;
+	}
+	if (MSCQ_Run)
+	{
+		status = MSCQ_Be->Poll();
+		if (status == MSCQ_BUSY) return;
+		MSCQ_Finish(status);
+	}
+	if (MSCQ_Num && !MSCQ_Run) MSCQ_Start();
+}
+
+/* ֻ ʱѾڶ (ص Submit MSCQ_Num ѭ һֱ) */
+void MSCQ_Abort(void)
+{
+	uint8_t n = MSCQ_Num;
+	if (MSCQ_Run) MSCQ_Stat.fails++;
+	MSCQ_Run = 0;
+	while (n--) MSCQ_Pop(MSCQ_FAIL);
+}
+
+uint8_t MSCQ_Ready(void)
+{
+	return MSCQ_Be != 0 && MSCQ_Be->Ready();
+}
+
+uint8_t MSCQ_Idle(void)
+{
+	return MSCQ_Num == 0;
+}
+
+uint8_t MSCQ_Free(void)
+{
+	return MSCQ_N - MSCQ_Num;
+}
+
+uint32_t MSCQ_Capacity(void)
+{
+	return MSCQ_Be ? MSCQ_Be->Capacity() : 0;
+}
+
+void MSCQ_Stat_Reset(void)
+{
+	memset(&MSCQ_Stat, 0, sizeof(MSCQ_Stat));
+}
+
+
+/*----------------------------- RAM   -----------------------------*/
+/*  Ụÿ ȿת MSCQ_RAM_CMD_POLL  (CBW/CSW Ŀ)֮ÿ Poll  MSCQ_RAM_BURST 
+    ļϵͳ +  ¡ϲЧ */
+
+#define MSCQ_RAM_CMD_POLL	4
+#define MSCQ_RAM_BURST		4
+
+static uint8_t  *MSCQ_Ram;
+static uint32_t MSCQ_RamSect;
+static uint8_t  MSCQ_RamDir;
+static uint32_t MSCQ_RamLba;
+static uint16_t MSCQ_RamLeft;
+static uint8_t  MSCQ_RamWait;
+
+void MSCQ_RamDisk_Init(uint8_t *mem, uint32_t sectors)
+{
+	MSCQ_Ram = mem;
+	MSCQ_RamSect = sectors;
+	MSCQ_RamLeft = 0;
+}
+
+static uint8_t MSCQ_RamDisk_Ready(void)
+{
+	return MSCQ_Ram != 0;
+}
+
+static uint8_t MSCQ_RamDisk_Start(uint8_t dir, uint32_t lba, uint16_t count)
+{
+	MSCQ_RamDir = dir;
+	MSCQ_RamLba = lba;
+	MSCQ_RamLeft = count;
+	MSCQ_RamWait = MSCQ_RAM_CMD_POLL;
+	return 0;
+}
+
+static uint8_t MSCQ_RamDisk_Poll(void)
+{
+	uint8_t n = MSCQ_RAM_BURST, *p, *m;
+	if (MSCQ_RamLba + MSCQ_RamLeft > MSCQ_RamSect) return MSCQ_FAIL;
+	if (MSCQ_RamWait)
+	{
+		MSCQ_RamWait--;
+		return MSCQ_BUSY;
+	}
+	while (MSCQ_RamLeft && n--)
+	{
+		p = MSCQ_Segment();
+		m = MSCQ_Ram + MSCQ_RamLba * MSCQ_SECTOR;
+		if (MSCQ_RamDir == MSCQ_READ) memcpy(p, m, MSCQ_SECTOR);
+		else memcpy(m, p, MSCQ_SECTOR);
+		MSCQ_RamLba++;
+		MSCQ_RamLeft--;
+	}
+	return MSCQ_RamLeft ? MSCQ_BUSY : MSCQ_OK;
+}
+
+static uint32_t MSCQ_RamDisk_Capacity(void)
+{
+	return MSCQ_RamSect;
+}
+
+const MSCQ_Backend_TypeDef MSCQ_RamDisk = {
+	MSCQ_RamDisk_Ready,
+	MSCQ_RamDisk_Start,
+	MSCQ_RamDisk_Poll,
+	MSCQ_RamDisk_Capacity,
+};
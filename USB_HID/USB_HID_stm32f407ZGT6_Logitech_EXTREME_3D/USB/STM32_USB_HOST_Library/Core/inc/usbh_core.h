@@ -170,6 +170,9 @@ typedef struct _USBH_Class_cb
 	void         (*DeInit) (USB_OTG_CORE_HANDLE *pdev , void *phost);//³ʼ
 	USBH_Status  (*Requests) (USB_OTG_CORE_HANDLE *pdev , void *phost);
 	USBH_Status  (*Machine) (USB_OTG_CORE_HANDLE *pdev , void *phost);
+	/*  USB ж (HOST_CLASS ״̬ŵ)õ */
+	void         (*SOF) (USB_OTG_CORE_HANDLE *pdev , void *phost);	//ÿ֡ʼ
+	void         (*HC_Done) (USB_OTG_CORE_HANDLE *pdev , void *phost , uint8_t hc_num);	//ж IN ͨһ
 
 } USBH_Class_cb_TypeDef;//صṹַ
 
@@ -55,14 +55,19 @@
 uint8_t USBH_Disconnected (USB_OTG_CORE_HANDLE *pdev);
 uint8_t USBH_Connected (USB_OTG_CORE_HANDLE *pdev);
 uint8_t USBH_SOF (USB_OTG_CORE_HANDLE *pdev);
+uint8_t USBH_HC_Done (USB_OTG_CORE_HANDLE *pdev, uint8_t hc_num);
 
 USBH_HCD_INT_cb_TypeDef USBH_HCD_INT_cb =
 		{
 				USBH_SOF,
 				USBH_Connected,
 				USBH_Disconnected,
+				USBH_HC_Done,
 		};
 
+/* USBH_Init ʱ£жϻص ҵǰص */
+static USBH_HOST *USBH_Host_p = 0;
+
 USBH_HCD_INT_cb_TypeDef  *USBH_HCD_INT_fops = &USBH_HCD_INT_cb;
 /**
   * @}
@@ -143,7 +148,27 @@ uint8_t USBH_Disconnected (USB_OTG_CORE_HANDLE *pdev)
 
 uint8_t USBH_SOF (USB_OTG_CORE_HANDLE *pdev)
 {
-	/* This callback could be used to implement a scheduler process */
+	/* ڴĵ (HID  bInterval ж IN) */
+	if (USBH_Host_p && USBH_Host_p->gState == HOST_CLASS && USBH_Host_p->class_cb->SOF)
+	{
+		USBH_Host_p->class_cb->SOF(pdev, USBH_Host_p);
+	}
+	return 0;
+}
+
+/**
+  * @brief  USBH_HC_Done
+  *         жϴ ͨһ (ж)
+  * @param  selected device
+  * @param  hc_num: ͨ
+  * @retval Status
+  */
+uint8_t USBH_HC_Done (USB_OTG_CORE_HANDLE *pdev, uint8_t hc_num)
+{
+	if (USBH_Host_p && USBH_Host_p->gState == HOST_CLASS && USBH_Host_p->class_cb->HC_Done)
+	{
+		USBH_Host_p->class_cb->HC_Done(pdev, USBH_Host_p, hc_num);
+	}
 	return 0;
 }
 
@@ -203,6 +228,7 @@ void USBH_Init(USB_OTG_CORE_HANDLE *pdev,
 	USBH_DeInit(pdev, host_p);//ʼ
 
 	host_p->class_cb = class_cb;	/** صṹַ **/
+	USBH_Host_p = host_p;
 	host_p->usr_cb = usr_cb;		/** ûصṹַ **/
 
 	/* ʼHOST */
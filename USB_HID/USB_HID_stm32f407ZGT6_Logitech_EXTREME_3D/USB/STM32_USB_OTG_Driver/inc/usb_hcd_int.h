@@ -60,6 +60,7 @@ typedef struct _USBH_HCD_INT
   uint8_t (* SOF) (USB_OTG_CORE_HANDLE *pdev);
   uint8_t (* DevConnected) (USB_OTG_CORE_HANDLE *pdev);
   uint8_t (* DevDisconnected) (USB_OTG_CORE_HANDLE *pdev);   
+  uint8_t (* HC_Done) (USB_OTG_CORE_HANDLE *pdev, uint8_t hc_num);
   
 }USBH_HCD_INT_cb_TypeDef;
 
@@ -678,6 +678,7 @@ uint32_t USB_OTG_USBH_handle_hc_n_In_ISR (USB_OTG_CORE_HANDLE *pdev , uint32_t n
       hcchar.b.oddfrm  = 1;
       USB_OTG_WRITE_REG32(&pdev->regs.HC_REGS[num]->HCCHAR, hcchar.d32); 
       pdev->host.URB_State[num] = URB_DONE;  
+      USBH_HCD_INT_fops->HC_Done(pdev, num);
     }
     
   }
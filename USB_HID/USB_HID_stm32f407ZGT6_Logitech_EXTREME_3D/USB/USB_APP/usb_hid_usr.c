@@ -296,21 +296,39 @@ void  USR_KEYBRD_Init(void)
 	USB_FIRST_PLUGIN_FLAG=1;//ǵһβ
 }
 
-/* Logitech Extreme 3D ҡ ݴ */
-void  USR_Logitech_ProcessData (HID_Logitech_Data_Analyze *Logitech_data)
+/* ҡ -> SBUS ͨ (1000~2000us)ᶼѾһ 0~HID_AXIS_MAX
+   CH1 RZ()  CH2 Y  CH3 Slider  CH4 X  CH5~CH16 1~12 (1800 ɿ1200)
+    USBH_Process ֻѱƽ SBUS 滷 SBUS ʱ֡ȴ */
+static void sbus_out(HID_Input_TypeDef *in)
+{
+	uint16_t us[SBUS_CH_NUM];
+	us[0] = 2000 - (sbus_axis(in->axis[HID_AXIS_RZ]) - 1000); // CH1
+	us[1] = sbus_axis(in->axis[HID_AXIS_Y]); // CH2
+	us[2] = sbus_axis(in->axis[HID_AXIS_SLIDER]); // CH3
+	us[3] = sbus_axis(in->axis[HID_AXIS_X]); // CH4
+	for (uint16_t i=0x0001, j=0; i & 0x0fff ; i = i<<1, ++j) 
+	{
+		if (in->button & i) us[4+j] = 1800;
+		else us[4+j] = 1200;
+	}
+	sbus_push(us, SBUS_CH_NUM, 0);
+}
+
+/* Logitech Extreme 3D ҡ (ҡ/ֱ) ݴ */
+void  USR_Logitech_ProcessData (HID_Input_TypeDef *in)
 {
 #ifndef NO_Debug	
-	_debug_log_info_c("X: %d\tY: %d\t", Logitech_data->X, Logitech_data->Y);
-	_debug_log_info_c("RZ: %d\t", Logitech_data->RZ);
-	_debug_log_info_c("Slider: %d\t", Logitech_data->Slider);
-	_debug_log_info_c("Hat_Switch: %d\t", Logitech_data->Hat_Switch);
+	_debug_log_info_c("X: %d\tY: %d\t", in->axis[HID_AXIS_X], in->axis[HID_AXIS_Y]);
+	_debug_log_info_c("RZ: %d\t", in->axis[HID_AXIS_RZ]);
+	_debug_log_info_c("Slider: %d\t", in->axis[HID_AXIS_SLIDER]);
+	_debug_log_info_c("Hat_Switch: %d\t", in->hat);
 	_debug_log_info_c("button: ");
 	for (uint16_t i=0x0001, j=1; i & 0x0fff ; i = i<<1, ++j) {
-		if (Logitech_data->button & i) _debug_log_info_c("%d ", j);
+		if (in->button & i) _debug_log_info_c("%d ", j);
 	}
 	_debug_log_info_c("\r\n");
 #else
-	sbus_out(Logitech_data);
+	sbus_out(in);
 #endif
 }
 
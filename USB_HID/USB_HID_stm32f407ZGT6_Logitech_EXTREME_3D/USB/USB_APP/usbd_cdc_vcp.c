@@ -0,0 +1,160 @@
+//
+// USB ӻ ⴮ (CDC) ӿڲ㣬˵ usbd_cdc_vcp.h
+//
+
+#include "usbd_cdc_vcp.h"
+#include "usbd_conf.h"
+#include "stm32f4xx.h"
+#include <string.h>
+
+#if (VCP_RX_SIZE & (VCP_RX_SIZE - 1)) != 0 || VCP_RX_SIZE < CDC_DATA_OUT_PACKET_SIZE * 2
+#error "VCP_RX_SIZE must be a power of 2 and hold at least 2 packets"
+#endif
+
+/* CDC ں˵ķͻ (usbd_cdc_core.c)
+	APP_Rx_ptr_in  д (0 ~ APP_RX_DATA_SIZE-1)
+	APP_Rx_ptr_out ں˷ǰŲ (ܵ APP_RX_DATA_SIZEõʱȡ) */
+extern uint8_t  APP_Rx_Buffer[];
+extern uint32_t APP_Rx_ptr_in;
+extern uint32_t APP_Rx_ptr_out;
+
+VCP_Stat_TypeDef VCP_Stat;
+
+static uint8_t  vcp_rx[VCP_RX_SIZE];
+static volatile uint32_t vcp_rx_w=0;		/* ж */
+static volatile uint32_t vcp_rx_r=0;		/* ѭ */
+static volatile uint8_t  vcp_rx_hold=0;
+
+/* 115200 8N1 ʹ (洮) */
+static uint8_t vcp_linecoding[7]={0x00,0xC2,0x01,0x00,0x00,0x00,0x08};
+
+static uint16_t VCP_Init(void);
+static uint16_t VCP_DeInit(void);
+static uint16_t VCP_Ctrl(uint32_t Cmd,uint8_t* Buf,uint32_t Len);
+static uint16_t VCP_DataTx(uint8_t* Buf,uint32_t Len);
+static uint16_t VCP_DataRx(uint8_t* Buf,uint32_t Len);
+
+CDC_IF_Prop_TypeDef VCP_fops=
+{
+	VCP_Init,
+	VCP_DeInit,
+	VCP_Ctrl,
+	VCP_DataTx,
+	VCP_DataRx
+};
+
+static uint16_t VCP_Init(void)
+{
+	vcp_rx_w=0;
+	vcp_rx_r=0;
+	vcp_rx_hold=0;
+	return USBD_OK;
+}
+
+static uint16_t VCP_DeInit(void)
+{
+	return USBD_OK;
+}
+
+static uint16_t VCP_Ctrl(uint32_t Cmd,uint8_t* Buf,uint32_t Len)
+{
+	switch(Cmd)
+	{
+		case SET_LINE_CODING:
+			memcpy(vcp_linecoding,Buf,sizeof(vcp_linecoding));
+			break;
+		case GET_LINE_CODING:
+			memcpy(Buf,vcp_linecoding,sizeof(vcp_linecoding));
+			break;
+		default:
+			break;
+	}
+	return USBD_OK;
+}
+
+//ͻܷŶ (һֽ ֱ/)
+uint32_t VCP_TxFree(void)
+{
+	uint32_t out=APP_Rx_ptr_out%APP_RX_DATA_SIZE;
+	uint32_t in=APP_Rx_ptr_in;
+	return (out+APP_RX_DATA_SIZE-in-1)%APP_RX_DATA_SIZE;
+}
+
+//ͻ memcpyһд APP_Rx_ptr_in (ںֻùж)
+uint32_t VCP_Write(const uint8_t *buf,uint32_t len)
+{
+	uint32_t in=APP_Rx_ptr_in;
+	uint32_t n,free=VCP_TxFree();
+
+	if(len>free)
+	{
+		VCP_Stat.tx_drop+=len-free;
+		len=free;
+	}
+	n=APP_RX_DATA_SIZE-in;
+	if(n>len)n=len;
+	memcpy(&APP_Rx_Buffer[in],buf,n);
+	memcpy(&APP_Rx_Buffer[0],buf+n,len-n);
+	in+=len;
+	if(in>=APP_RX_DATA_SIZE)in-=APP_RX_DATA_SIZE;
+	APP_Rx_ptr_in=in;
+	VCP_Stat.tx_bytes+=len;
+	return len;
+}
+
+static uint16_t VCP_DataTx(uint8_t* Buf,uint32_t Len)
+{
+	VCP_Write(Buf,Len);
+	return USBD_OK;
+}
+
+//OTG жһջʣķŲһ  USBD_BUSYںȲ׼ OUT ˵
+static uint16_t VCP_DataRx(uint8_t* Buf,uint32_t Len)
+{
+	uint32_t w=vcp_rx_w;
+	uint32_t free=VCP_RX_SIZE-(w-vcp_rx_r);
+	uint32_t i;
+
+	if(Len>free)
+	{
+		VCP_Stat.rx_drop+=Len-free;
+		Len=free;
+	}
+	for(i=0;i<Len;i++)vcp_rx[(w+i)&(VCP_RX_SIZE-1)]=Buf[i];
+	vcp_rx_w=w+Len;
+	VCP_Stat.rx_bytes+=Len;
+
+	if(free-Len<CDC_DATA_OUT_PACKET_SIZE)
+	{
+		vcp_rx_hold=1;
+		VCP_Stat.rx_hold++;
+		return USBD_BUSY;
+	}
+	return USBD_OK;
+}
+
+uint32_t VCP_Available(void)
+{
+	return vcp_rx_w-vcp_rx_r;
+}
+
+uint32_t VCP_Read(uint8_t *buf,uint32_t len)
+{
+	uint32_t r=vcp_rx_r;
+	uint32_t n=vcp_rx_w-r;
+	uint32_t i;
+
+	if(len>n)len=n;
+	for(i=0;i<len;i++)buf[i]=vcp_rx[(r+i)&(VCP_RX_SIZE-1)];
+	vcp_rx_r=r+len;
+
+	//ڳһĵط ſ OUT ˵
+	if(vcp_rx_hold&&VCP_RX_SIZE-(vcp_rx_w-vcp_rx_r)>=CDC_DATA_OUT_PACKET_SIZE)
+	{
+		NVIC_DisableIRQ(OTG_FS_IRQn);
+		vcp_rx_hold=0;
+		USBD_CDC_RxResume();
+		NVIC_EnableIRQ(OTG_FS_IRQn);
+	}
+	return len;
+}
@@ -0,0 +1,48 @@
+//
+// USB ӻ ⴮ (CDC) ӿڲ㣺շǻλ
+//
+
+#ifndef __USBD_CDC_VCP_H
+#define __USBD_CDC_VCP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "usbd_cdc_core.h"
+
+/** usbd_conf.h ҪУ
+		#define APP_FOPS			VCP_fops
+		#define APP_RX_DATA_SIZE	2048		//ͻ (CDC ں˵ APP_Rx_Buffer)
+		#define CDC_IN_FRAME_INTERVAL 5			//SOF  ֡һηͻ
+	 (ѭ  )VCP_Write 鿽 APP_Rx_Buffer ͷأ
+		CDC ں ŵһ ( CDC_IN_BATCH_SIZE) һνŷ SOF
+		պ û Ͳһ 0 ǱζŽ
+		 β  tx_drop (־ܰѭס)
+	 (  ѭ)OTG ж һ VCP_RX_SIZE ջ
+		ʣĵط һ Ȳ׼ OUT ˵ ( NAK)VCP_Read ڳط ٷſ */
+
+#define VCP_RX_SIZE			1024		/* ջ (2 ݣ 2 ) */
+
+typedef struct
+{
+	uint32_t tx_bytes;		/* Žͻֽ */
+	uint32_t tx_drop;		/* ͻ ֽ */
+	uint32_t rx_bytes;		/* յֽ */
+	uint32_t rx_drop;		/* ջ ֽ () */
+	uint32_t rx_hold;		/* ջ  Ĵ */
+} VCP_Stat_TypeDef;
+
+extern VCP_Stat_TypeDef VCP_Stat;
+extern CDC_IF_Prop_TypeDef VCP_fops;
+
+uint32_t VCP_Write(const uint8_t *buf, uint32_t len);	/* ѭطŽȥֽ */
+uint32_t VCP_Read(uint8_t *buf, uint32_t len);			/* ѭضֽ */
+uint32_t VCP_Available(void);							/* ջжֽ */
+uint32_t VCP_TxFree(void);								/* ͻܷŶֽ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__USBD_CDC_VCP_H
@@ -0,0 +1,384 @@
+//
+// USB ӻ U ʣ W25Q128 (̨ DMA)˵ usbd_storage_msd.h
+//
+
+#include "usbd_storage_msd.h"
+#include "w25qxx.h"
+#include <string.h>
+
+#if (MSD_FLASH_BASE % MSD_SECTOR_SIZE) != 0
+#error "MSD_FLASH_BASE must be 4K aligned"
+#endif
+
+#define MSD_LUN_NBR			1
+#define MSD_PAGES			(MSD_SECTOR_SIZE / W25QXX_PAGE_SIZE)
+#define MSD_READ_MAX		0x8000					/* һ DMA ô (NDTR 16 λ) */
+#define MSD_NONE			0xFFFFFFFF
+
+/*  */
+#define MSD_REQ_NONE		0
+#define MSD_REQ_READ		1
+#define MSD_REQ_WRITE		2
+
+/* ̨״̬ */
+#define MSD_IDLE			0
+#define MSD_READ			1		/* DMA  SCSI  */
+#define MSD_LOAD			2		/* DMA һ */
+#define MSD_ERASE			3		/*  оƬæ */
+#define MSD_PROG			4		/* DMA һҳ */
+#define MSD_PROG_WAIT		5		/* һҳ */
+
+MSD_Stat_TypeDef MSD_Stat;
+
+static u8  msd_inited=0;
+static volatile u8 msd_state=MSD_IDLE;
+static volatile u8 msd_dma_done=0;
+static u8  msd_lock=0,msd_again=0;
+
+/* SCSI һ (ֽڵַ/ȣѼ MSD_FLASH_BASE) */
+static u8  msd_req=MSD_REQ_NONE;
+static u8  *msd_buf;
+static u32 msd_addr;
+static u32 msd_len;
+static u32 msd_step;				/* MSD_READ DMA ĳ */
+
+/* 4K  */
+static u8  msd_cache[MSD_SECTOR_SIZE];
+static u32 msd_cache_addr=MSD_NONE;
+static u32 msd_load_addr;
+static u8  msd_dirty=0;
+static u8  msd_flush_req=0;
+static u32 msd_dirty_ms=0;
+static u32 msd_now=0;
+
+/* ڲдݴ msd_cache (д)  SCSI  (ֱд)  */
+static u8  *msd_prog_src;
+static u32 msd_prog_addr;
+static u8  msd_page;
+
+static void MSD_Step(void);
+
+/* USB MSC Standard Inquiry Data */
+const int8_t MSD_Inquirydata[]={//36
+	/* LUN 0 */
+	0x00,
+	0x80,
+	0x02,
+	0x02,
+	(USBD_STD_INQUIRY_LENGTH - 5),
+	0x00,
+	0x00,
+	0x00,
+	'A', 'L', 'I', 'E', 'N', 'T', 'E', 'K', /* Manufacturer : 8 bytes */
+	'S', 'P', 'I', ' ', 'F', 'L', 'A', 'S', /* Product      : 16 Bytes */
+	'H', ' ', ' ', ' ', ' ', ' ', ' ', ' ',
+	'1', '.', '0' ,'0',                     /* Version      : 4 Bytes */
+};
+
+//DMA  (DMA2_Stream0 ж)
+static void MSD_DmaDone(void)
+{
+	msd_dma_done=1;
+	MSD_Step();
+}
+
+//ǰһ ǰ n ֽڣ SCSI  (SCSI ַһ飬 msd_again )
+static void MSD_Next(u32 n)
+{
+	msd_buf+=n;
+	msd_addr+=n;
+	msd_len-=n;
+	if(msd_len==0)
+	{
+		msd_req=MSD_REQ_NONE;
+		USBD_MSC_MediaDone(0);
+	}
+	msd_again=1;
+}
+
+//һ ҳ src
+static void MSD_ProgStart(u8 *src,u32 sect)
+{
+	msd_prog_src=src;
+	msd_prog_addr=sect;
+	msd_page=0;
+	msd_state=MSD_ERASE;
+	MSD_Stat.erase++;
+	W25QXX_Erase_Sector_Start(sect/MSD_SECTOR_SIZE);
+}
+
+//һ 
+static void MSD_ProgDone(void)
+{
+	msd_state=MSD_IDLE;
+	if(msd_prog_src==msd_cache)
+	{
+		msd_dirty=0;
+		msd_flush_req=0;
+		msd_again=1;
+	}
+	else
+	{
+		MSD_Next(MSD_SECTOR_SIZE);
+	}
+}
+
+//ʱʼ /д   дػ
+static void MSD_Start(void)
+{
+	u32 sect,off,n;
+
+	if(msd_req==MSD_REQ_READ)
+	{
+		sect=msd_addr&~(MSD_SECTOR_SIZE-1);
+		if(sect==msd_cache_addr)
+		{
+			//ı flash ϵ
+			off=msd_addr-sect;
+			n=MSD_SECTOR_SIZE-off;
+			if(n>msd_len)n=msd_len;
+			memcpy(msd_buf,&msd_cache[off],n);
+			MSD_Stat.cache_hit++;
+			MSD_Next(n);
+			return;
+		}
+		//ǰΪֱֹ DMA  SCSI 
+		n=msd_len;
+		if(n>MSD_READ_MAX)n=MSD_READ_MAX;
+		if(msd_cache_addr!=MSD_NONE&&msd_cache_addr>msd_addr&&msd_cache_addr<msd_addr+n)n=msd_cache_addr-msd_addr;
+		msd_step=n;
+		msd_state=MSD_READ;
+		W25QXX_Read_DMA(msd_buf,msd_addr,n,MSD_DmaDone);
+	}
+	else if(msd_req==MSD_REQ_WRITE)
+	{
+		sect=msd_addr&~(MSD_SECTOR_SIZE-1);
+		off=msd_addr-sect;
+		if(off==0&&msd_len>=MSD_SECTOR_SIZE)
+		{
+			//ľϣֱӴ SCSI 
+			if(sect==msd_cache_addr)
+			{
+				msd_cache_addr=MSD_NONE;
+				msd_dirty=0;
+			}
+			MSD_Stat.direct_sect++;
+			MSD_ProgStart(msd_buf,sect);
+		}
+		else if(sect==msd_cache_addr)
+		{
+			n=MSD_SECTOR_SIZE-off;
+			if(n>msd_len)n=msd_len;
+			memcpy(&msd_cache[off],msd_buf,n);
+			msd_dirty=1;
+			msd_dirty_ms=msd_now;
+			MSD_Stat.cache_hit++;
+			MSD_Next(n);
+		}
+		else if(msd_dirty)
+		{
+			//Ǳ д
+			MSD_Stat.flush++;
+			MSD_ProgStart(msd_cache,msd_cache_addr);
+		}
+		else
+		{
+			msd_cache_addr=MSD_NONE;
+			msd_load_addr=sect;
+			msd_state=MSD_LOAD;
+			MSD_Stat.cache_load++;
+			W25QXX_Read_DMA(msd_cache,sect,MSD_SECTOR_SIZE,MSD_DmaDone);
+		}
+	}
+	else if(msd_flush_req&&msd_dirty)
+	{
+		MSD_Stat.flush++;
+		MSD_ProgStart(msd_cache,msd_cache_addr);
+	}
+	else
+	{
+		msd_flush_req=0;
+	}
+}
+
+//״̬ǰ (OTG жϡDMA жϡѭ ж )
+static void MSD_Step(void)
+{
+	if(msd_lock)
+	{
+		msd_again=1;
+		return;
+	}
+	msd_lock=1;
+	do
+	{
+		msd_again=0;
+		switch(msd_state)
+		{
+			case MSD_IDLE:
+				MSD_Start();
+				break;
+			case MSD_READ:
+				if(msd_dma_done)
+				{
+					msd_dma_done=0;
+					msd_state=MSD_IDLE;
+					MSD_Next(msd_step);
+				}
+				break;
+			case MSD_LOAD:
+				if(msd_dma_done)
+				{
+					msd_dma_done=0;
+					msd_state=MSD_IDLE;
+					msd_cache_addr=msd_load_addr;
+					msd_again=1;
+				}
+				break;
+			case MSD_ERASE:
+				if(!W25QXX_Busy())
+				{
+					msd_state=MSD_PROG;
+					W25QXX_Write_Page_DMA(msd_prog_src,msd_prog_addr,W25QXX_PAGE_SIZE,MSD_DmaDone);
+				}
+				break;
+			case MSD_PROG:
+				if(msd_dma_done)
+				{
+					msd_dma_done=0;
+					msd_state=MSD_PROG_WAIT;
+					msd_again=1;			//ҳ 㼸룬
+				}
+				break;
+			case MSD_PROG_WAIT:
+				if(!W25QXX_Busy())
+				{
+					msd_page++;
+					if(msd_page<MSD_PAGES)
+					{
+						msd_state=MSD_PROG;
+						W25QXX_Write_Page_DMA(msd_prog_src+msd_page*W25QXX_PAGE_SIZE,
+						                      msd_prog_addr+msd_page*W25QXX_PAGE_SIZE,W25QXX_PAGE_SIZE,MSD_DmaDone);
+					}
+					else
+					{
+						MSD_ProgDone();
+					}
+				}
+				break;
+		}
+	}
+	while(msd_again);
+	msd_lock=0;
+}
+
+/// 飬ֽڵַ
+static int8_t MSD_Request(u8 req,u8 *buf,u32 blk_addr,u16 blk_len)
+{
+	if(blk_len==0||blk_addr+blk_len>MSD_FLASH_SIZE/MSD_BLOCK_SIZE||msd_req!=MSD_REQ_NONE)
+	{
+		MSD_Stat.fail++;
+		return -1;
+	}
+	msd_buf=buf;
+	msd_addr=MSD_FLASH_BASE+blk_addr*MSD_BLOCK_SIZE;
+	msd_len=(u32)blk_len*MSD_BLOCK_SIZE;
+	msd_req=req;
+	MSD_Step();
+	return 0;
+}
+
+static int8_t MSD_Init(uint8_t lun)
+{
+	if(!msd_inited)
+	{
+		W25QXX_Init();
+		msd_inited=1;
+	}
+	return 0;
+}
+
+static int8_t MSD_GetCapacity(uint8_t lun,uint32_t *block_num,uint32_t *block_size)
+{
+	*block_num=MSD_FLASH_SIZE/MSD_BLOCK_SIZE;
+	*block_size=MSD_BLOCK_SIZE;
+	return 0;
+}
+
+static int8_t MSD_IsReady(uint8_t lun)
+{
+	if(W25QXX_TYPE==0||W25QXX_TYPE==0XFFFF)return -1;	//û ID
+	return 0;
+}
+
+static int8_t MSD_IsWriteProtected(uint8_t lun)
+{
+	return 0;
+}
+
+static int8_t MSD_ReadStart(uint8_t lun,uint8_t *buf,uint32_t blk_addr,uint16_t blk_len)
+{
+	MSD_Stat.read_blk+=blk_len;
+	return MSD_Request(MSD_REQ_READ,buf,blk_addr,blk_len);
+}
+
+static int8_t MSD_WriteStart(uint8_t lun,uint8_t *buf,uint32_t blk_addr,uint16_t blk_len)
+{
+	MSD_Stat.write_blk+=blk_len;
+	return MSD_Request(MSD_REQ_WRITE,buf,blk_addr,blk_len);
+}
+
+static int8_t MSD_GetMaxLun(void)
+{
+	return (MSD_LUN_NBR - 1);
+}
+
+//Read/Write SCSI ֻ ReadStart/WriteStart
+USBD_STORAGE_cb_TypeDef USBD_SPI_FLASH_fops=
+{
+	MSD_Init,
+	MSD_GetCapacity,
+	MSD_IsReady,
+	MSD_IsWriteProtected,
+	0,
+	0,
+	MSD_GetMaxLun,
+	(int8_t *)MSD_Inquirydata,
+	MSD_ReadStart,
+	MSD_WriteStart,
+};
+
+USBD_STORAGE_cb_TypeDef *USBD_STORAGE_fops=&USBD_SPI_FLASH_fops;
+
+void MSD_Process(uint32_t ms)
+{
+	NVIC_DisableIRQ(OTG_FS_IRQn);
+	NVIC_DisableIRQ(DMA2_Stream0_IRQn);
+	msd_now=ms;
+	if(msd_dirty&&msd_req==MSD_REQ_NONE&&msd_state==MSD_IDLE&&ms-msd_dirty_ms>=MSD_FLUSH_MS)msd_flush_req=1;
+	if(msd_inited)MSD_Step();
+	NVIC_EnableIRQ(DMA2_Stream0_IRQn);
+	NVIC_EnableIRQ(OTG_FS_IRQn);
+}
+
+uint8_t MSD_Idle(void)
+{
+	return msd_req==MSD_REQ_NONE&&msd_state==MSD_IDLE&&!msd_dirty;
+}
+
+void MSD_Sync(void)
+{
+	u8 idle;
+	if(!msd_inited)return;
+	do
+	{
+		NVIC_DisableIRQ(OTG_FS_IRQn);
+		NVIC_DisableIRQ(DMA2_Stream0_IRQn);
+		if(msd_dirty)msd_flush_req=1;
+		MSD_Step();
+		idle=MSD_Idle();
+		NVIC_EnableIRQ(DMA2_Stream0_IRQn);
+		NVIC_EnableIRQ(OTG_FS_IRQn);
+	}
+	while(!idle);
+}
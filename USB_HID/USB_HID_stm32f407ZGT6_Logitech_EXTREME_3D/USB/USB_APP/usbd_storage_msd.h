@@ -0,0 +1,54 @@
+//
+// USB ӻ U ʣ W25Q128 (̨ DMA)
+//
+
+#ifndef __USBD_STORAGE_MSD_H
+#define __USBD_STORAGE_MSD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "usbd_msc_mem.h"
+
+/** SCSI  (usbd_msc_scsi.c)  MSC_BOT_Data ãUSB շһ룬ͬʱ DMA дһ롣
+	ֻ ReadStart/WriteStart (Read/Write Ϊ 0)һ ͷأDMA/д ں̨ߣ
+	 USBD_MSC_MediaDoneȫ̲ CPU ֽڰᡣ
+		֮ һ DMA ֱӶ SCSI 壻
+		д (4K )  ֱӴ SCSI ҳ DMA ̣棻
+		    д  4K 棬   MSD_FLUSH_MS дء
+	usbd_conf.h  MSC_MEDIA_PACKET  4096 (һһֱд)
+	/ ҪоƬæ꣬ûжϣѭ MSD_Process 飬ѭҪתڡ
+	DMA2_Stream0 ж  OTG_FS ͬһռȼụϣѭĺ ȹжϡ
+	λʱ һܻ (ռ MSC_BOT_Data)SCSI  MediaDone  Ž */
+
+#define MSD_FLASH_BASE		0						/*  flash ￪ʼ (Ҫ 4K ) */
+#define MSD_FLASH_SIZE		(12*1024*1024)			/* ǰ 12M  Ụ 4M  (ֿ) */
+#define MSD_BLOCK_SIZE		512
+#define MSD_SECTOR_SIZE		4096					/* W25Q λ */
+#define MSD_FLUSH_MS		200						/*  ôûд д */
+
+typedef struct
+{
+	uint32_t read_blk;		/* ˶ٿ (512) */
+	uint32_t write_blk;		/* д˶ٿ */
+	uint32_t direct_sect;	/* ֱд  */
+	uint32_t cache_hit;		/* д л */
+	uint32_t cache_load;	/* дһ ȶ  */
+	uint32_t flush;			/* д  */
+	uint32_t erase;			/*   */
+	uint32_t fail;			/* Խ ʧ */
+} MSD_Stat_TypeDef;
+
+extern MSD_Stat_TypeDef MSD_Stat;
+extern USBD_STORAGE_cb_TypeDef USBD_SPI_FLASH_fops;
+
+void    MSD_Process(uint32_t ms);	/* ѭдûСʱдػ档ms: */
+void    MSD_Sync(void);				/* Ȼдء̨ (/ػǰ) */
+uint8_t MSD_Idle(void);				/* 1:ûҪ ҲǸɾ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__USBD_STORAGE_MSD_H
@@ -9,6 +9,7 @@
 #include "debug.h"
 #include "timer_delay.h"
 #include "serial_bus.h"
+#include "usbh_hid_Logitech.h"
 #include "timer.h"
 
 /**޼ DģʽXģʽDģʽͨģʽÿ֡ݴ8ֽڣXģʽxboxֱģʽ
@@ -51,7 +52,7 @@ int main(void)
 #if  0
 	uart_init(115200); //ڳʼΪ115200
 #else
-	USART1_SBUS_Init();
+	USART1_SBUS_Init(); //SBUS շ֡ԼĶʱ
 #endif
 	LED_Init();					//ʼLED
 	timer_delay_init();
@@ -70,8 +71,8 @@ int main(void)
 			{
 				_debug_log_info("USB HID 쳣")
 //				TIM_Cmd(TIM3,DISABLE); 	
-				memset(&Logitech_Data, 0, sizeof(Logitech_Data));
-				USR_Logitech_ProcessData (&Logitech_Data);
+				memset(&HID_Input, 0, sizeof(HID_Input));
+				USR_Logitech_ProcessData (&HID_Input);
 				
 				USBH_HID_Reconnect();//				
 			}
@@ -88,8 +89,8 @@ int main(void)
 			if (serval != 0) {
 				serval = 0;
 				//TIM_Cmd(TIM3,DISABLE); 	
-				memset(&Logitech_Data, 0, sizeof(Logitech_Data));
-				USR_Logitech_ProcessData (&Logitech_Data);
+				memset(&HID_Input, 0, sizeof(HID_Input));
+				USR_Logitech_ProcessData (&HID_Input);
 			}
 			LED0=LED1=1;
 			t = 0;
@@ -141,17 +142,15 @@ void TIM3_IRQHandler(void)
 		if(serval == 1)//ӽ
 		{
 #if 0		
-			_debug_log_info_c("X: %d\tY: %d\t", Logitech_Data.X, Logitech_Data.Y);
-			_debug_log_info_c("RZ: %d\t", Logitech_Data.RZ);
-			_debug_log_info_c("Slider: %d\t", Logitech_Data.Slider);
-			_debug_log_info_c("Hat_Switch: %d\t", Logitech_Data.Hat_Switch);
+			_debug_log_info_c("X: %d\tY: %d\t", HID_Input.axis[HID_AXIS_X], HID_Input.axis[HID_AXIS_Y]);
+			_debug_log_info_c("RZ: %d\t", HID_Input.axis[HID_AXIS_RZ]);
+			_debug_log_info_c("Slider: %d\t", HID_Input.axis[HID_AXIS_SLIDER]);
+			_debug_log_info_c("Hat_Switch: %d\t", HID_Input.hat);
 			_debug_log_info_c("button: ");
 			for (uint16_t i=0x0001, j=1; i & 0x0fff ; i = i<<1, ++j) {
-				if (Logitech_Data.button & i) _debug_log_info_c("%d ", j);
+				if (HID_Input.button & i) _debug_log_info_c("%d ", j);
 			}
 			_debug_log_info_c("\r\n") 
-#else		
-			sbus_out(&Logitech_Data);
 #endif
 		}
 	}	
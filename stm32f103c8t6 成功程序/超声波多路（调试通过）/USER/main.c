@@ -13,28 +13,37 @@
 #include "led.h"
 #include "Time_test.h"
 #include "misc.h"
-#include "ultrasonic.h"
-
-extern unsigned short int Distance; 
+#include "ultrasonic_ic.h"
 
 int main(void)
 { 
+  u8 seq = 0;
+  u8 n;
+
   SystemInit();//ϵͳʱΪ72M	
   USART1_Config();//ô
 	LED_GPIO_Config();//ledʼ
 	
-	TIM2_NVIC_Configuration(); // TIM2 ʱ 
-	TIM2_Configuration(); 	
-	Ultrasonic_Config();//˿ڳʼ
+	Ultrasonic_IC_Init();//7· 벶ʼTIM1~TIM4
 	
   printf(" -------------\r\n");
 	while(1)
 	{		
-		if(Distance < 100)
-			
-		Ultrasonic_Measure();
-		Delayms(500);
-		LED_Toggle();
+		Ultrasonic_IC_Poll();//ʱ·
+		
+		if(Ultrasonic_Seq[5] != seq)//һ·ˣ˵һ (Լ 7 x 30ms)
+		{
+			seq = Ultrasonic_Seq[5];
+			for(n = 0; n < ULTRASONIC_NUM; n++)
+			{
+				if(Ultrasonic_mm[n] != ULTRASONIC_NO_ECHO)
+					printf("%d_", Ultrasonic_mm[n]);
+				else
+					printf("0000_");
+			}
+			printf("mm\r\n");
+			LED_Toggle();
+		}
 	}
 }
 
@@ -168,18 +168,7 @@ void USART1_IRQHandler(void)
 	 
 }
 
-/**
-  * @brief  This function handles TIM2 interrupt request.
-  * @param  None
-  * @retval : None
-  */
-void TIM2_IRQHandler(void)
-{
-	if ( TIM_GetITStatus(TIM2 , TIM_IT_Update) != RESET ) 
-	{	
-		TIM_ClearITPendingBit(TIM2 , TIM_FLAG_Update);    
-	}		 	
-}
+/* TIM1_CC / TIM2 / TIM3 / TIM4 ж  ultrasonic_ic.c  (벶) */
 
 
 /******************* (C) COPYRIGHT 2009 STMicroelectronics *****END OF FILE****/
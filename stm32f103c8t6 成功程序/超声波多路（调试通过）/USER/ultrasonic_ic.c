@@ -0,0 +1,289 @@
+/*************************************
+ * ļ  ultrasonic_ic.c
+ *     ·࣬ʱ벶 + ʱ
+ * ʵƽ̨STM32F103C8T6
+ * ӿ     ultrasonic_ic.h
+ * ע    ԭ Ultrasonic_Measure()  while Ȼزһ· 20 ms
+ *           ﴥأɲĴѭֻ Ultrasonic_IC_Poll()
+**********************************************************************************/
+#include "ultrasonic_ic.h"
+#include "misc.h"
+#include "stm32f10x_gpio.h"
+#include "stm32f10x_tim.h"
+
+typedef struct
+{
+	GPIO_TypeDef *trig_port;
+	u16           trig_pin;
+	GPIO_TypeDef *echo_port;
+	u16           echo_pin;
+	TIM_TypeDef  *tim;          //ʱ
+	u8            ch;           //ͨ 0~3 (CH1~CH4)
+} Ultrasonic_Def;
+
+static const Ultrasonic_Def Ultrasonic_Tab[ULTRASONIC_NUM] =
+{
+	{GPIOA, GPIO_Pin_1,  GPIOA, GPIO_Pin_0, TIM2, 0},
+	{GPIOA, GPIO_Pin_3,  GPIOA, GPIO_Pin_2, TIM2, 2},
+	{GPIOA, GPIO_Pin_5,  GPIOA, GPIO_Pin_7, TIM3, 1},
+	{GPIOA, GPIO_Pin_4,  GPIOA, GPIO_Pin_6, TIM3, 0},
+	{GPIOA, GPIO_Pin_11, GPIOA, GPIO_Pin_8, TIM1, 0},
+	{GPIOB, GPIO_Pin_8,  GPIOB, GPIO_Pin_9, TIM4, 3},
+	{GPIOB, GPIO_Pin_6,  GPIOB, GPIO_Pin_7, TIM4, 1},
+};
+
+/* ˳ڰװ̽ͷһСನ */
+static const u8 Ultrasonic_Order[ULTRASONIC_NUM] = {0, 2, 4, 6, 1, 3, 5};
+
+volatile u16 Ultrasonic_mm[ULTRASONIC_NUM];
+volatile u8  Ultrasonic_Seq[ULTRASONIC_NUM];
+
+static u16 Ultrasonic_Win[ULTRASONIC_NUM][ULTRASONIC_MED_N];   //ֵ˲
+static u8  Ultrasonic_WinPos[ULTRASONIC_NUM];
+
+static volatile u8  Active = 0xFF;    //ǰʱ϶·ţ0xFF:ûʼ
+static volatile u8  EchoState;        //0:  1:½  2:ʱ϶
+static volatile u16 EchoRise;         //زֵ
+static u16 SlotStart;                 //ʱ϶ʼʱ TIM2 ֵ
+static u8  OrderPos;
+
+#define CC_IT(ch)     ((u16)(TIM_IT_CC1 << (ch)))      //CCx ж/־λ
+#define CC_POL(ch)    ((u16)(TIM_CCER_CC1P << ((ch) * 4)))   //CCxP λ 1:½
+
+/*
+ * Ultrasonic_GetCapture
+ *   ȡָͨĲֵ
+ */
+static u16 Ultrasonic_GetCapture(TIM_TypeDef *tim, u8 ch)
+{
+	switch (ch)
+	{
+		case 0:  return TIM_GetCapture1(tim);
+		case 1:  return TIM_GetCapture2(tim);
+		case 2:  return TIM_GetCapture3(tim);
+		default: return TIM_GetCapture4(tim);
+	}
+}
+
+/*
+ * Ultrasonic_Push
+ *   һβֵڣ Ultrasonic_mm[]
+ *   n ·ţmm ξ
+ */
+static void Ultrasonic_Push(u8 n, u16 mm)
+{
+	u16 tmp[ULTRASONIC_MED_N], v;
+	u8 i, j;
+
+	Ultrasonic_Win[n][Ultrasonic_WinPos[n]] = mm;
+	if (++Ultrasonic_WinPos[n] >= ULTRASONIC_MED_N)
+		Ultrasonic_WinPos[n] = 0;
+
+	for (i = 0; i < ULTRASONIC_MED_N; i++)      //5 ܿ
+	{
+		v = Ultrasonic_Win[n][i];
+		for (j = i; j > 0 && tmp[j - 1] > v; j--)
+			tmp[j] = tmp[j - 1];
+		tmp[j] = v;
+	}
+	Ultrasonic_mm[n] = tmp[ULTRASONIC_MED_N / 2];
+	Ultrasonic_Seq[n]++;
+}
+
+/*
+ * Ultrasonic_TimInit
+ *   ʱ 1MHz ɼ
+ */
+static void Ultrasonic_TimInit(TIM_TypeDef *tim)
+{
+	TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
+
+	TIM_DeInit(tim);
+	TIM_TimeBaseStructure.TIM_Period = 0xFFFF;
+	TIM_TimeBaseStructure.TIM_Prescaler = 72 - 1;                     /* 72M/72 = 1MHz1  = 1us */
+	TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+	TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
+	TIM_TimeBaseStructure.TIM_RepetitionCounter = 0;
+	TIM_TimeBaseInit(tim, &TIM_TimeBaseStructure);
+}
+
+/*
+ * Ultrasonic_IC_Init
+ *   TRIG ECHO  + 벶񣬿 TIM1~TIM4 ж
+ *   
+ *   
+ */
+void Ultrasonic_IC_Init(void)
+{
+	GPIO_InitTypeDef GPIO_InitStructure;
+	TIM_ICInitTypeDef TIM_ICInitStructure;
+	NVIC_InitTypeDef NVIC_InitStructure;
+	static const u16 ic_ch[4] = {TIM_Channel_1, TIM_Channel_2, TIM_Channel_3, TIM_Channel_4};
+	u8 n, i;
+
+	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA | RCC_APB2Periph_GPIOB | RCC_APB2Periph_TIM1, ENABLE);
+	RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM2 | RCC_APB1Periph_TIM3 | RCC_APB1Periph_TIM4, ENABLE);
+
+	Ultrasonic_TimInit(TIM1);
+	Ultrasonic_TimInit(TIM2);
+	Ultrasonic_TimInit(TIM3);
+	Ultrasonic_TimInit(TIM4);
+
+	TIM_ICInitStructure.TIM_ICPolarity = TIM_ICPolarity_Rising;
+	TIM_ICInitStructure.TIM_ICSelection = TIM_ICSelection_DirectTI;
+	TIM_ICInitStructure.TIM_ICPrescaler = TIM_ICPSC_DIV1;
+	TIM_ICInitStructure.TIM_ICFilter = 0x03;                           /* 8 ˵ë */
+
+	for (n = 0; n < ULTRASONIC_NUM; n++)
+	{
+		GPIO_InitStructure.GPIO_Pin = Ultrasonic_Tab[n].trig_pin;
+		GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_PP;
+		GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+		GPIO_Init(Ultrasonic_Tab[n].trig_port, &GPIO_InitStructure);
+		GPIO_ResetBits(Ultrasonic_Tab[n].trig_port, Ultrasonic_Tab[n].trig_pin);
+
+		GPIO_InitStructure.GPIO_Pin = Ultrasonic_Tab[n].echo_pin;
+		GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IN_FLOATING;
+		GPIO_Init(Ultrasonic_Tab[n].echo_port, &GPIO_InitStructure);
+
+		TIM_ICInitStructure.TIM_Channel = ic_ch[Ultrasonic_Tab[n].ch];
+		TIM_ICInit(Ultrasonic_Tab[n].tim, &TIM_ICInitStructure);
+
+		Ultrasonic_mm[n] = ULTRASONIC_NO_ECHO;
+		for (i = 0; i < ULTRASONIC_MED_N; i++)
+			Ultrasonic_Win[n][i] = ULTRASONIC_NO_ECHO;
+	}
+
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_InitStructure.NVIC_IRQChannel = TIM1_CC_IRQn;
+	NVIC_Init(&NVIC_InitStructure);
+	NVIC_InitStructure.NVIC_IRQChannel = TIM2_IRQn;
+	NVIC_Init(&NVIC_InitStructure);
+	NVIC_InitStructure.NVIC_IRQChannel = TIM3_IRQn;
+	NVIC_Init(&NVIC_InitStructure);
+	NVIC_InitStructure.NVIC_IRQChannel = TIM4_IRQn;
+	NVIC_Init(&NVIC_InitStructure);
+
+	TIM_Cmd(TIM1, ENABLE);
+	TIM_Cmd(TIM2, ENABLE);
+	TIM_Cmd(TIM3, ENABLE);
+	TIM_Cmd(TIM4, ENABLE);
+
+	Active = 0xFF;
+	OrderPos = ULTRASONIC_NUM - 1;
+	SlotStart = TIM_GetCounter(TIM2) - ULTRASONIC_SLOT_US;     //һ Poll Ϳʼ
+}
+
+/*
+ * Ultrasonic_Trig
+ *   ʼ n ·ࣺ岶״̬ >10us  TRIG ߵƽ
+ */
+static void Ultrasonic_Trig(u8 n)
+{
+	const Ultrasonic_Def *d = &Ultrasonic_Tab[n];
+	u16 t0;
+
+	d->tim->CCER &= ~CC_POL(d->ch);                        //Ȳ
+	TIM_ClearITPendingBit(d->tim, CC_IT(d->ch));
+	EchoState = 0;
+	Active = n;
+	TIM_ITConfig(d->tim, CC_IT(d->ch), ENABLE);
+
+	GPIO_SetBits(d->trig_port, d->trig_pin);
+	t0 = TIM_GetCounter(TIM2);
+	while ((u16)(TIM_GetCounter(TIM2) - t0) < 12);          //12us
+	GPIO_ResetBits(d->trig_port, d->trig_pin);
+}
+
+/*
+ * Ultrasonic_IC_Poll
+ *   ʱ϶ˣûյزļΪ޻زȻ󴥷һ·
+ *   
+ *   
+ *   ѭﾡƵã (ֻ 12us  TRIG )
+ */
+void Ultrasonic_IC_Poll(void)
+{
+	u8 n;
+
+	if ((u16)(TIM_GetCounter(TIM2) - SlotStart) < ULTRASONIC_SLOT_US)
+		return;
+	SlotStart += ULTRASONIC_SLOT_US;
+	if ((u16)(TIM_GetCounter(TIM2) - SlotStart) >= ULTRASONIC_SLOT_US)
+		SlotStart = TIM_GetCounter(TIM2);                  //ѭ̫ã¶
+
+	n = Active;
+	if (n != 0xFF)
+	{
+		TIM_ITConfig(Ultrasonic_Tab[n].tim, CC_IT(Ultrasonic_Tab[n].ch), DISABLE);
+		if (EchoState != 2)
+			Ultrasonic_Push(n, ULTRASONIC_NO_ECHO);
+	}
+
+	if (++OrderPos >= ULTRASONIC_NUM)
+		OrderPos = 0;
+	Ultrasonic_Trig(Ultrasonic_Order[OrderPos]);
+}
+
+/*
+ * Ultrasonic_IC_IRQ
+ *   жϹؼʱ̲Ϊ½أ½
+ *   tim жϵĶʱ
+ */
+static void Ultrasonic_IC_IRQ(TIM_TypeDef *tim)
+{
+	const Ultrasonic_Def *d;
+	u16 cap, us;
+	u32 mm;
+	u8 n = Active;
+
+	if (n == 0xFF || Ultrasonic_Tab[n].tim != tim)
+	{
+		tim->SR = 0;                                        //ǵǰ· (жǰ)
+		return;
+	}
+	d = &Ultrasonic_Tab[n];
+	if (TIM_GetITStatus(tim, CC_IT(d->ch)) == RESET)
+	{
+		tim->SR = 0;
+		return;
+	}
+	cap = Ultrasonic_GetCapture(tim, d->ch);              // CCR ͬʱ CCxIF
+	if (EchoState == 0)
+	{
+		EchoRise = cap;
+		tim->CCER |= CC_POL(d->ch);                        //Ϊ½
+		EchoState = 1;
+	}
+	else if (EchoState == 1)
+	{
+		us = cap - EchoRise;                                //16 λԶ
+		mm = (u32)us * 343 / 2000;                          // 343m/sس 2
+		Ultrasonic_Push(n, mm > ULTRASONIC_MAX_MM ? ULTRASONIC_NO_ECHO : (u16)mm);
+		EchoState = 2;
+		TIM_ITConfig(tim, CC_IT(d->ch), DISABLE);
+	}
+	tim->SR = 0;
+}
+
+void TIM1_CC_IRQHandler(void)
+{
+	Ultrasonic_IC_IRQ(TIM1);
+}
+
+void TIM2_IRQHandler(void)
+{
+	Ultrasonic_IC_IRQ(TIM2);
+}
+
+void TIM3_IRQHandler(void)
+{
+	Ultrasonic_IC_IRQ(TIM3);
+}
+
+void TIM4_IRQHandler(void)
+{
+	Ultrasonic_IC_IRQ(TIM4);
+}
@@ -0,0 +1,38 @@
+#ifndef __ULTRASONIC_IC_H
+#define	__ULTRASONIC_IC_H
+
+#include "stm32f10x.h"
+
+/* 7· ʱ벶 
+ * ECHO Ӷʱ벶ͨ/½صʱӲ棬жӳӰ죻
+ * · Ultrasonic_Order[] ˳ÿ·ռһʱ϶໥ţ
+ * Ϊ mmֵ˲д Ultrasonic_mm[]ʱȡȴ
+ *
+ *  ( ultrasonic.c ~ ultrasonic7.c ȣ3·ECHO  4·TRIG Ե
+ *       Ϊ PA4 ûжʱͨ)
+ *   ·   TRIG   ECHO   ͨ
+ *   0    PA1    PA0    TIM2_CH1
+ *   1    PA3    PA2    TIM2_CH3
+ *   2    PA5    PA7    TIM3_CH2
+ *   3    PA4    PA6    TIM3_CH1
+ *   4    PA11   PA8    TIM1_CH1
+ *   5    PB8    PB9    TIM4_CH4
+ *   6    PB6    PB7    TIM4_CH2
+ * TIM1~TIM4 ȫ 1MHz ɼTIM2 ļֵͬʱΪʱ϶ʱ
+ */
+
+#define ULTRASONIC_NUM        7         //·
+#define ULTRASONIC_SLOT_US    30000     //ÿ·ʱ϶ us (HC-SR04 ԶԼ 4mز <24ms)
+#define ULTRASONIC_MED_N      5         //ֵ˲
+#define ULTRASONIC_MAX_MM     4500      //˾뵱޻ز
+#define ULTRASONIC_NO_ECHO    0xFFFF    //޻ز/
+
+/* ¾ mm (ֵ˲)ÿԪ 16 λдԭӵģֱӶ */
+extern volatile u16 Ultrasonic_mm[ULTRASONIC_NUM];
+/* ÿ·¼仯˵ */
+extern volatile u8 Ultrasonic_Seq[ULTRASONIC_NUM];
+
+void Ultrasonic_IC_Init(void);          //GPIO + TIM1~TIM4 벶ʼ
+void Ultrasonic_IC_Poll(void);          //ѭãʱ϶˾ͽǰ·һ·
+
+#endif /* __ULTRASONIC_IC_H */
@@ -0,0 +1,183 @@
+#include "asset.h"
+#include "w25qxx.h"
+#include "lcd.h"
+#include "string.h"
+//////////////////////////////////////////////////////////////////////////////////
+//STM32F103ZEİ
+//ͼƬ/ֿ Դ ( W25Q128 ) ȡ 
+//////////////////////////////////////////////////////////////////////////////////
+
+u8 Asset_Count=0;
+static Asset_Info Asset_Index[ASSET_MAX];
+
+//ͼ ߶дSPI DMA һͬʱ һд LCD
+static u16 Asset_Buf[2][ASSET_CHUNK/2];
+
+//Сͼ  (ʹ Ȼ)
+static u16 Asset_Cache[ASSET_CACHE_SLOTS][ASSET_CACHE_SIZE/2];
+static s16 Asset_Cache_Idx[ASSET_CACHE_SLOTS];				//Դ -1:
+static u32 Asset_Cache_Use[ASSET_CACHE_SLOTS];
+static u32 Asset_Use_Cnt=0;
+
+//CRC32 (ʽ 0xEDB88320ÿβ 4 λС)
+static const u32 Asset_Crc_Tab[16]={
+	0x00000000,0x1DB71064,0x3B6E20C8,0x26D930AC,0x76DC4190,0x6B6B51F4,0x4DB26158,0x5005713C,
+	0xEDB88320,0xF00F9344,0xD6D6A3E8,0xCB61B38C,0x9B64C2B0,0x86D3D2D4,0xA00AE278,0xBDBDF21C};
+u32 Asset_CRC32(u32 crc,const u8 *buf,u32 len)
+{
+	crc=~crc;
+	while(len--)
+	{
+		crc^=*buf++;
+		crc=(crc>>4)^Asset_Crc_Tab[crc&0x0F];
+		crc=(crc>>4)^Asset_Crc_Tab[crc&0x0F];
+	}
+	return ~crc;
+}
+
+//ļͷ
+//ֵ:0,ɹ;1,ûԴ;2,У
+u8 Asset_Init(void)
+{
+	Asset_Head head;
+	u8 i;
+	Asset_Count=0;
+	for(i=0;i<ASSET_CACHE_SLOTS;i++){Asset_Cache_Idx[i]=-1;Asset_Cache_Use[i]=0;}
+	W25QXX_Read((u8*)&head,ASSET_PACK_ADDR,sizeof(head));
+	if(head.magic!=ASSET_MAGIC||head.version!=ASSET_VERSION||head.count==0||head.count>ASSET_MAX)return 1;
+	W25QXX_Read((u8*)Asset_Index,ASSET_PACK_ADDR+sizeof(head),head.count*sizeof(Asset_Info));
+	if(Asset_CRC32(0,(u8*)Asset_Index,head.count*sizeof(Asset_Info))!=head.index_crc)return 2;
+	Asset_Count=head.count;
+	return 0;
+}
+
+s16 Asset_Find(const char *name)
+{
+	u8 i;
+	for(i=0;i<Asset_Count;i++)
+	{
+		if(strncmp(Asset_Index[i].name,name,ASSET_NAME_LEN)==0)return i;
+	}
+	return -1;
+}
+
+const Asset_Info *Asset_Get(u8 idx)
+{
+	if(idx>=Asset_Count)return 0;
+	return &Asset_Index[idx];
+}
+
+//СԴ 棬ػ (ڻ ٶ FLASH)
+static u8 Asset_Cache_Load(u8 idx)
+{
+	u8 i,slot=0;
+	Asset_Use_Cnt++;
+	for(i=0;i<ASSET_CACHE_SLOTS;i++)
+	{
+		if(Asset_Cache_Idx[i]==idx)
+		{
+			Asset_Cache_Use[i]=Asset_Use_Cnt;
+			return i;
+		}
+		if(Asset_Cache_Use[i]<Asset_Cache_Use[slot])slot=i;	//ûõ
+	}
+	W25QXX_Stream_Begin(ASSET_PACK_ADDR+Asset_Index[idx].offset);
+	W25QXX_Stream_Read_DMA((u8*)Asset_Cache[slot],Asset_Index[idx].size);
+	W25QXX_Stream_End();
+	Asset_Cache_Idx[slot]=idx;
+	Asset_Cache_Use[slot]=Asset_Use_Cnt;
+	return slot;
+}
+
+//RGB565 ͼƬ (x,y)
+//ֵ:0,ɹ;1,ûԴʽ
+u8 Asset_Draw(u16 x,u16 y,u8 idx)
+{
+	const Asset_Info *a;
+	u32 left,len,next;
+	u8 cur=0;
+	if(idx>=Asset_Count)return 1;
+	a=&Asset_Index[idx];
+	if(a->format!=ASSET_FMT_RGB565||a->size!=(u32)a->width*a->height*2)return 1;
+	if(a->size<=ASSET_CACHE_SIZE)					//Сͼ꣺߻
+	{
+		LCD_Blit16(x,y,a->width,a->height,Asset_Cache[Asset_Cache_Load(idx)]);
+		return 0;
+	}
+	//ͼ黺DMA һ ͬʱ дǰ飬 RAM
+	LCD_Stream_Begin(x,y,a->width,a->height);
+	W25QXX_Stream_Begin(ASSET_PACK_ADDR+a->offset);
+	left=a->size;
+	len=left>ASSET_CHUNK?ASSET_CHUNK:left;
+	W25QXX_Stream_Read_DMA((u8*)Asset_Buf[cur],len);
+	while(left)
+	{
+		left-=len;
+		next=left>ASSET_CHUNK?ASSET_CHUNK:left;
+		while(W25QXX_Stream_Busy());
+		if(next)W25QXX_Stream_Read_DMA((u8*)Asset_Buf[cur^1],next);
+		LCD_Stream_Write(Asset_Buf[cur],len/2);
+		cur^=1;
+		len=next;
+	}
+	W25QXX_Stream_End();
+	LCD_Stream_End();
+	return 0;
+}
+
+u8 Asset_Draw_Name(u16 x,u16 y,const char *name)
+{
+	s16 idx=Asset_Find(name);
+	if(idx<0)return 1;
+	return Asset_Draw(x,y,idx);
+}
+
+//ɫλͼһ չһ
+u8 Asset_Draw_Mono(u16 x,u16 y,u8 idx,u16 fg,u16 bg)
+{
+	const Asset_Info *a;
+	u16 row_bytes,rows,i;
+	u32 off=0;
+	if(idx>=Asset_Count)return 1;
+	a=&Asset_Index[idx];
+	row_bytes=(a->width+7)/8;
+	if(a->format!=ASSET_FMT_MONO||row_bytes==0||row_bytes>ASSET_CHUNK||a->size<(u32)row_bytes*a->height)return 1;
+	rows=ASSET_CHUNK/row_bytes;						//һ
+	for(i=0;i<a->height;i+=rows)
+	{
+		if(rows>a->height-i)rows=a->height-i;
+		W25QXX_Read((u8*)Asset_Buf[0],ASSET_PACK_ADDR+a->offset+off,rows*row_bytes);
+		LCD_Blit_Mono(x,y+i,a->width,rows,(u8*)Asset_Buf[0],fg,bg);
+		off+=rows*row_bytes;
+	}
+	return 0;
+}
+
+//Դһ
+//ֵ:0,ɹ;1,Խ
+u8 Asset_Read(u8 idx,u32 offset,u8 *buf,u16 len)
+{
+	if(idx>=Asset_Count||offset+len>Asset_Index[idx].size)return 1;
+	W25QXX_Read(buf,ASSET_PACK_ADDR+Asset_Index[idx].offset+offset,len);
+	return 0;
+}
+
+//Դ У CRC32 (հ һ)
+//ֵ:0,ȷ;1,
+u8 Asset_Verify(u8 idx)
+{
+	u32 left,len,crc=0;
+	if(idx>=Asset_Count)return 1;
+	left=Asset_Index[idx].size;
+	W25QXX_Stream_Begin(ASSET_PACK_ADDR+Asset_Index[idx].offset);
+	while(left)
+	{
+		len=left>ASSET_CHUNK?ASSET_CHUNK:left;
+		W25QXX_Stream_Read_DMA((u8*)Asset_Buf[0],len);
+		while(W25QXX_Stream_Busy());
+		crc=Asset_CRC32(crc,(u8*)Asset_Buf[0],len);
+		left-=len;
+	}
+	W25QXX_Stream_End();
+	return crc!=Asset_Index[idx].crc;
+}
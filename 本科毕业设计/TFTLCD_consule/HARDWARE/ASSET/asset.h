@@ -0,0 +1,72 @@
+#ifndef __ASSET_H
+#define __ASSET_H
+#include "sys.h"
+//////////////////////////////////////////////////////////////////////////////////
+//STM32F103ZEİ
+//ͼƬ/ֿ Դ ( W25Q128 ) ȡ 
+//////////////////////////////////////////////////////////////////////////////////
+
+/* Դʽ (С) TOOLS/asset_pack  Image2Lcd ɣ
+	ļͷ 16 ֽ
+		u32 magic		'A''S''T''1'
+		u16 version		1
+		u16 count		Դ
+		u32 total		ֽ
+		u32 index_crc	 CRC32
+	 count*32 ֽڣÿ Asset_Info
+	 ÿԴ 4 ֽڶ
+	RGB565 ͼƬ ת С u16 (Image2Lcd Ǹֽǰ)ֱд LCD->LCD_RAM
+
+	ʹã
+	W25QXX_Init();
+	if(Asset_Init()==0)						//ļͷ У
+		Asset_Draw_Name(120,163,"green");	//Сͼ һκ RAM 
+*/
+
+#define ASSET_PACK_ADDR		0X100000	//Դ W25Q ʼַ (ǰ 1M ;)
+#define ASSET_MAGIC			0X31545341	//"AST1"
+#define ASSET_VERSION		1
+#define ASSET_MAX			32			//Դ (ȫ RAM)
+#define ASSET_NAME_LEN		12			// 11 ַ + 
+
+#define ASSET_FMT_RGB565	1			//16λɫͼƬ width*height С u16
+#define ASSET_FMT_MONO		2			//ɫλͼ  λǰ ÿв뵽ֽ
+#define ASSET_FMT_RAW		3			//ԭʼ (ֿ)
+
+#define ASSET_CHUNK			512			//ͼ ߶д ÿֽ ()
+#define ASSET_CACHE_SLOTS	4			//Сͼ RAM  
+#define ASSET_CACHE_SIZE	800			//ÿ ֽ (20x20 ͼ 800 ֽ)
+
+typedef struct{
+				u32 magic;
+				u16 version;
+				u16 count;
+				u32 total;
+				u32 index_crc;
+				}Asset_Head;
+
+typedef struct{
+				char name[ASSET_NAME_LEN];	// ( "red")
+				u32  offset;				// ԰ͷƫ
+				u32  size;					// ֽ
+				u16  width;					//ͼƬ  (RAW Ϊ0)
+				u16  height;				//ͼƬ 
+				u8   format;				//ASSET_FMT_xxx
+				u8   flags;
+				u16  reserved;
+				u32  crc;					// CRC32
+				}Asset_Info;
+
+extern u8 Asset_Count;					//Դ0:ûпõԴ
+
+u8   Asset_Init(void);					//ļͷ+ 0:ɹ 1:ûԴ 2:У
+s16  Asset_Find(const char *name);		// ţ-1:û
+const Asset_Info *Asset_Get(u8 idx);	//ԴϢ
+u8   Asset_Draw(u16 x,u16 y,u8 idx);	//RGB565 ͼƬ (x,y) 0:ɹ
+u8   Asset_Draw_Name(u16 x,u16 y,const char *name);	//ͬ 
+u8   Asset_Draw_Mono(u16 x,u16 y,u8 idx,u16 fg,u16 bg);	//ɫλͼ չ
+u8   Asset_Read(u8 idx,u32 offset,u8 *buf,u16 len);		//Դһ (ֿ) 0:ɹ
+u8   Asset_Verify(u8 idx);				//Դ У CRC32 0:ȷ
+u32  Asset_CRC32(u32 crc,const u8 *buf,u32 len);			//CRC32 (ͬ zlib crc32)һ crc  0ɷֿ
+
+#endif
@@ -0,0 +1,490 @@
+#include "kvs.h"
+#include "w25qxx.h"
+#include "string.h"
+//////////////////////////////////////////////////////////////////////////////////
+//STM32F103ZEİ
+//W25Q128 ϵ ֵ洢 + ׷־ 
+//////////////////////////////////////////////////////////////////////////////////
+
+#define KVS_SECTOR			4096
+#define KVS_MAGIC			0X3153564B	//"KVS1"
+#define KVS_HEAD_SIZE		16
+#define KVS_REC_HEAD		8
+#define KVS_REC_SIZE(n)		((KVS_REC_HEAD+(n)+3)&~3)
+#define KVS_REC_MAX			KVS_REC_SIZE(KVS_VAL_MAX)
+
+//״̬
+#define KVS_FREE			0			//Ѳ (ǰٲһǲȫ 0xFF)
+#define KVS_USED			1
+#define KVS_DIRTY			2			//ͷ (ʱ)  ڲ
+
+typedef struct{
+				u32 magic;
+				u32 seq;				//ţԽԽ
+				u32 erase;				//
+				u16 crc;				//ǰ 12 ֽڵ CRC16 (󵥶д)
+				u16 pad;
+				}Kvs_Head;
+
+typedef struct{
+				u16 key;				///־ǩ0xFFFF:հ
+				u16 len;				//ݳȣֵ 0:ɾ
+				u16 nlen;				//~lenֻܰ 1  0ͷдһ len  nlen һԲ
+				u16 crc;				//key,len,  CRC16д ٵд 2 ֽ (ύ)
+				}Kvs_Rec;
+//ȫ 0 ļ¼ͷ =  KVS_REC_MAX ֽ (ϵʱ дһļ¼ͷ )
+
+///д¼Ļ壺ͷ ͨʣ u32 ǿת Kvs_Rec* (Υϸ)
+typedef union{
+				Kvs_Rec h;
+				u8  b[KVS_REC_MAX];
+				u32 align;				//4 ֽڶ
+				}Kvs_Rbuf;
+
+typedef struct{
+				u32 base;
+				u8  num;				//
+				u8  kv;					//1:ֵ ʱЧ¼0:־ ֱӶ
+				u8  active;				//׷ӵ0xFF:û
+				u8  erasing;			//ѷ ûȷɵ0xFF:û
+				u16 wr;					//active һ¼ƫ
+				u32 seq;				//µ
+				u8  state[KVS_AREA_MAX];
+				u32 sseq[KVS_AREA_MAX];
+				u32 erase[KVS_AREA_MAX];
+				}Kvs_Area;
+
+u8 Kvs_Ready=0;
+
+static Kvs_Area Kvs_KV={KVS_ADDR,KVS_SECTORS,1,0XFF,0XFF,0,0,{0},{0},{0}};
+static Kvs_Area Kvs_Log={KLOG_ADDR,KLOG_SECTORS,0,0XFF,0XFF,0,0,{0},{0},{0}};
+static u32 Kvs_Index[KVS_KEY_MAX];		//ÿ ¼¼ĵַ0:û
+static Kvs_Rbuf Kvs_Buf;				//¼
+static Kvs_Rbuf Kvs_Wbuf;				//д¼
+static u8  Kvs_In_GC=0;					//ڰ¼һ
+
+static u8 Kvs_Open_Next(Kvs_Area *a);
+
+//CRC16-CCITT (0x1021)ò
+static u16 Kvs_CRC16(u16 crc,const u8 *buf,u16 len)
+{
+	while(len--)
+	{
+		crc=(crc>>8)|(crc<<8);
+		crc^=*buf++;
+		crc^=(crc&0xFF)>>4;
+		crc^=crc<<12;
+		crc^=(crc&0xFF)<<5;
+	}
+	return crc;
+}
+
+//0xFFFF "ûύ" 0xFFFF  ǳ 0
+static u16 Kvs_Rec_CRC(const Kvs_Rbuf *rec)
+{
+	u16 crc=Kvs_CRC16(Kvs_CRC16(0XFFFF,rec->b,4),rec->b+KVS_REC_HEAD,rec->h.len);
+	return crc==0XFFFF?0:crc;
+}
+
+static u16 Kvs_Head_CRC(const Kvs_Head *h)
+{
+	u16 crc=Kvs_CRC16(0XFFFF,(const u8*)h,12);
+	return crc==0XFFFF?0:crc;
+}
+
+static u32 Kvs_Addr(const Kvs_Area *a,u8 i)
+{
+	return a->base+(u32)i*KVS_SECTOR;
+}
+
+// (ǰ ȷ FLASH æ)
+static void Kvs_Done(Kvs_Area *a)
+{
+	if(a->erasing==0XFF)return;
+	a->state[a->erasing]=KVS_FREE;
+	a->erasing=0XFF;
+}
+
+//д FLASH ǰ Ĳ꣺оƬʱ  // 
+//һڲһҪ
+static void Kvs_Idle(void)
+{
+	if(Kvs_KV.erasing==0XFF&&Kvs_Log.erasing==0XFF)return;
+	W25QXX_Wait_Busy();
+	Kvs_Done(&Kvs_KV);
+	Kvs_Done(&Kvs_Log);
+}
+
+//дһ¼/ͷд CRC Ĳ֣д CRC
+//; CRC  0xFFFF  дһ룬һУ鲻д Ч
+static void Kvs_Program(u8 *buf,u32 addr,u16 len,u16 crc_off)
+{
+	u16 crc,blank=0XFFFF;
+	memcpy(&crc,buf+crc_off,2);
+	Kvs_Idle();
+	memcpy(buf+crc_off,&blank,2);
+	W25QXX_Write_NoCheck(buf,addr,len);
+	memcpy(buf+crc_off,&crc,2);
+	W25QXX_Write_NoCheck(buf+crc_off,addr+crc_off,2);
+}
+
+// addr ʼ len ֽ Ƿȫ 0xFF
+static u8 Kvs_Blank(u32 addr,u16 len)
+{
+	u8 tmp[64];
+	u16 i,n;
+	Kvs_Idle();
+	while(len)
+	{
+		n=len>sizeof(tmp)?sizeof(tmp):len;
+		W25QXX_Read(tmp,addr,n);
+		for(i=0;i<n;i++)if(tmp[i]!=0XFF)return 0;
+		addr+=n;
+		len-=n;
+	}
+	return 1;
+}
+
+// addr ļ¼ Kvs_Buf У
+//ֵ:0,Ч;1,հ(ûм¼);2, (ݻ  ͷȿ);3,¼ͷдһ
+static u8 Kvs_Load(u32 addr)
+{
+	Kvs_Rec *r=&Kvs_Buf.h;
+	u32 end=(addr|(KVS_SECTOR-1))+1;
+	Kvs_Idle();
+	W25QXX_Read(Kvs_Buf.b,addr,KVS_REC_HEAD);
+	if(r->key==0XFFFF&&r->len==0XFFFF&&r->nlen==0XFFFF&&r->crc==0XFFFF)return 1;
+	if(r->key==0&&r->len==0&&r->nlen==0&&r->crc==0)
+	{
+		r->len=KVS_VAL_MAX;
+		return 2;
+	}
+	if((u16)(r->len^r->nlen)!=0XFFFF||r->len>KVS_VAL_MAX||addr+KVS_REC_SIZE(r->len)>end)return 3;
+	W25QXX_Read(Kvs_Buf.b+KVS_REC_HEAD,addr+KVS_REC_HEAD,r->len);
+	if(Kvs_Rec_CRC(&Kvs_Buf)!=r->crc)return 2;
+	return 0;
+}
+
+//ɨһļ¼ֵ˳
+//ֵ:ͣµƫ (հ  дһļ¼ͷ) β
+static u16 Kvs_Scan(Kvs_Area *a,u8 i)
+{
+	Kvs_Rec *r=&Kvs_Buf.h;
+	u32 base=Kvs_Addr(a,i);
+	u16 off=KVS_HEAD_SIZE;
+	u8 res;
+	while(off+KVS_REC_HEAD<=KVS_SECTOR)
+	{
+		res=Kvs_Load(base+off);
+		if(res==1||res==3)return off;
+		if(res==0&&a->kv&&r->key<KVS_KEY_MAX)Kvs_Index[r->key]=r->len?base+off:0;
+		off+=KVS_REC_SIZE(r->len);
+	}
+	return KVS_SECTOR;
+}
+
+static u8 Kvs_Free_Num(const Kvs_Area *a)
+{
+	u8 i,n=0;
+	for(i=0;i<a->num;i++)if(a->state[i]==KVS_FREE)n++;
+	return n;
+}
+
+//һлȲģϵ (ֵȰ滹Чļ¼)
+//ֻ 
+//ֵ:0,ѿʼ;1,ûпɻյ  ¼ʧ
+static u8 Kvs_Reclaim(Kvs_Area *a)
+{
+	u8 i,v=0XFF;
+	u16 k;
+	u32 lo,old;
+	if(a->erasing!=0XFF)return 1;
+	for(i=0;i<a->num;i++)
+	{
+		if(a->state[i]==KVS_DIRTY){v=i;break;}
+	}
+	if(v==0XFF)
+	{
+		for(i=0;i<a->num;i++)		//ϵ
+		{
+			if(a->state[i]==KVS_USED&&i!=a->active&&(v==0XFF||a->sseq[i]<a->sseq[v]))v=i;
+		}
+		if(v==0XFF)return 1;
+		if(a->kv)					//ϵ ɾ¼ ðᣬϵֵѾ
+		{
+			lo=Kvs_Addr(a,v);
+			Kvs_In_GC=1;
+			for(k=0;k<KVS_KEY_MAX;k++)
+			{
+				if(Kvs_Index[k]<lo||Kvs_Index[k]>=lo+KVS_SECTOR)continue;
+				old=Kvs_Index[k];
+				if(Kvs_Load(old)!=0)continue;
+				memcpy(Kvs_Wbuf.b,Kvs_Buf.b,KVS_REC_HEAD+Kvs_Buf.h.len);
+				if(a->active==0XFF||a->wr+KVS_REC_SIZE(Kvs_Wbuf.h.len)>KVS_SECTOR)
+				{
+					if(Kvs_Open_Next(a))		//᲻ βɼ¼
+					{
+						Kvs_In_GC=0;
+						return 1;
+					}
+				}
+				Kvs_Index[k]=Kvs_Addr(a,a->active)+a->wr;
+				Kvs_Program(Kvs_Wbuf.b,Kvs_Index[k],KVS_REC_HEAD+Kvs_Wbuf.h.len,6);
+				a->wr+=KVS_REC_SIZE(Kvs_Wbuf.h.len);
+			}
+			Kvs_In_GC=0;
+		}
+	}
+	Kvs_Idle();
+	W25QXX_Erase_Sector_Start(Kvs_Addr(a,v)/KVS_SECTOR);
+	a->state[v]=KVS_DIRTY;
+	a->erasing=v;
+	a->erase[v]++;
+	return 0;
+}
+
+//һٵ
+//ֵ:0,ɹ;1,ûп
+static u8 Kvs_Open_Next(Kvs_Area *a)
+{
+	Kvs_Head h;
+	u8 i,n=0XFF;
+	Kvs_Idle();
+	for(i=0;i<a->num;i++)
+	{
+		if(a->state[i]==KVS_FREE&&(n==0XFF||a->erase[i]<a->erase[n]))n=i;
+	}
+	if(n==0XFF)						//ûп (һ Kvs_Poll ̫)ֻõ
+	{
+		if(Kvs_In_GC||Kvs_Reclaim(a))return 1;
+		Kvs_Idle();
+		return Kvs_Open_Next(a);
+	}
+	if(Kvs_Blank(Kvs_Addr(a,n),KVS_SECTOR)==0)	//ϵʱֻͷȷһ
+	{
+		W25QXX_Erase_Sector_Start(Kvs_Addr(a,n)/KVS_SECTOR);
+		W25QXX_Wait_Busy();
+		a->erase[n]++;
+	}
+	h.magic=KVS_MAGIC;
+	h.seq=++a->seq;
+	h.erase=a->erase[n];
+	h.crc=Kvs_Head_CRC(&h);
+	h.pad=0;
+	Kvs_Program((u8*)&h,Kvs_Addr(a,n),sizeof(h),12);
+	a->state[n]=KVS_USED;
+	a->sseq[n]=h.seq;
+	a->active=n;
+	a->wr=KVS_HEAD_SIZE;
+	//õһϻһǿյ Ч¼һ
+	if(Kvs_In_GC==0&&Kvs_Free_Num(a)==0&&Kvs_Reclaim(a)==0)Kvs_Idle();
+	return 0;
+}
+
+//׷һ¼
+//ֵ:¼ַ0:ʧ
+static u32 Kvs_Append(Kvs_Area *a,u16 key,const void *data,u16 len)
+{
+	Kvs_Rec *r=&Kvs_Wbuf.h;
+	u32 addr;
+	if(a->active==0XFF||a->wr+KVS_REC_SIZE(len)>KVS_SECTOR)
+	{
+		if(Kvs_Open_Next(a))return 0;
+	}
+	r->key=key;
+	r->len=len;
+	r->nlen=~len;
+	if(len)memcpy(Kvs_Wbuf.b+KVS_REC_HEAD,data,len);
+	r->crc=Kvs_Rec_CRC(&Kvs_Wbuf);
+	addr=Kvs_Addr(a,a->active)+a->wr;
+	Kvs_Program(Kvs_Wbuf.b,addr,KVS_REC_HEAD+len,6);	//ֽڲд  0xFF
+	a->wr+=KVS_REC_SIZE(len);
+	return addr;
+}
+
+//ϵɨһ
+static void Kvs_Mount(Kvs_Area *a)
+{
+	Kvs_Head h;
+	u8 i,j,n=0,order[KVS_AREA_MAX];
+	u32 emax=0;
+	a->active=0XFF;
+	a->erasing=0XFF;
+	a->seq=0;
+	a->wr=KVS_SECTOR;
+	for(i=0;i<a->num;i++)
+	{
+		W25QXX_Read((u8*)&h,Kvs_Addr(a,i),sizeof(h));
+		if(h.magic==KVS_MAGIC&&h.crc==Kvs_Head_CRC(&h))
+		{
+			a->state[i]=KVS_USED;
+			a->sseq[i]=h.seq;
+			a->erase[i]=h.erase;
+			if(h.erase>emax)emax=h.erase;
+			if(h.seq>a->seq)a->seq=h.seq;
+			for(j=n++;j>0&&a->sseq[order[j-1]]>h.seq;j--)order[j]=order[j-1];	// ϵ
+			order[j]=i;
+		}
+		else if(h.magic==0XFFFFFFFF&&h.seq==0XFFFFFFFF&&h.erase==0XFFFFFFFF&&h.crc==0XFFFF)a->state[i]=KVS_FREE;
+		else a->state[i]=KVS_DIRTY;
+	}
+	for(i=0;i<a->num;i++)			//ͷ Ͳ֪ˣ
+	{
+		if(a->state[i]!=KVS_USED)a->erase[i]=emax;
+	}
+	if(n==0)return;
+	if(a->kv)						//ֵ ϵɨһ ־ ֻҪҵдλ
+	{
+		for(j=0;j<n-1;j++)Kvs_Scan(a,order[j]);
+	}
+	a->active=order[n-1];
+	a->wr=Kvs_Scan(a,a->active);
+	if(a->wr<KVS_SECTOR&&Kvs_Blank(Kvs_Addr(a,a->active)+a->wr,KVS_SECTOR-a->wr)==0)
+	{
+		//һдһ룺¼ͷдȫ 0 һ¼λ 
+		memset(&h,0,KVS_REC_HEAD);
+		W25QXX_Write_NoCheck((u8*)&h,Kvs_Addr(a,a->active)+a->wr,KVS_REC_HEAD);
+		a->wr+=KVS_REC_MAX;
+		if(a->wr>=KVS_SECTOR||Kvs_Blank(Kvs_Addr(a,a->active)+a->wr,KVS_SECTOR-a->wr)==0)a->wr=KVS_SECTOR;
+	}
+}
+
+u8 Kvs_Init(void)
+{
+	u16 k;
+	Kvs_Ready=0;
+	if((W25QXX_TYPE&0XFF00)!=0XEF00)return 1;
+	for(k=0;k<KVS_KEY_MAX;k++)Kvs_Index[k]=0;
+	Kvs_Mount(&Kvs_KV);
+	Kvs_Mount(&Kvs_Log);
+	//ϴڻ;е һû
+	if(Kvs_Free_Num(&Kvs_KV)==0&&Kvs_Reclaim(&Kvs_KV)==0)Kvs_Idle();
+	if(Kvs_Free_Num(&Kvs_Log)==0&&Kvs_Reclaim(&Kvs_Log)==0)Kvs_Idle();
+	Kvs_Ready=1;
+	return 0;
+}
+
+static u8 Kvs_Need(const Kvs_Area *a)
+{
+	u8 i;
+	if(Kvs_Free_Num(a)<KVS_FREE_MIN)return 1;
+	for(i=0;i<a->num;i++)if(a->state[i]==KVS_DIRTY)return 1;
+	return 0;
+}
+
+//̨գFLASH ڲ ֱӷأһ෢һ
+void Kvs_Poll(void)
+{
+	if(Kvs_Ready==0)return;
+	if(Kvs_KV.erasing!=0XFF||Kvs_Log.erasing!=0XFF)
+	{
+		if(W25QXX_Busy())return;
+		Kvs_Done(&Kvs_KV);
+		Kvs_Done(&Kvs_Log);
+	}
+	if(Kvs_Need(&Kvs_KV)&&Kvs_Reclaim(&Kvs_KV)==0)return;
+	if(Kvs_Need(&Kvs_Log))Kvs_Reclaim(&Kvs_Log);
+}
+
+//дһ
+//ֵ:0,ɹ;1,  ûпռ
+u8 Kvs_Set(u16 key,const void *val,u16 len)
+{
+	Kvs_Rec *r=&Kvs_Buf.h;
+	u32 addr;
+	if(Kvs_Ready==0||key>=KVS_KEY_MAX||len==0||len>KVS_VAL_MAX)return 1;
+	if(Kvs_Index[key]&&Kvs_Load(Kvs_Index[key])==0&&r->len==len&&memcmp(Kvs_Buf.b+KVS_REC_HEAD,val,len)==0)return 0;	//û д
+	addr=Kvs_Append(&Kvs_KV,key,val,len);
+	if(addr==0)return 1;
+	Kvs_Index[key]=addr;
+	return 0;
+}
+
+//һ
+//ֵ:ֵĳ (ֻǰ size ֽڵ buf)0:û
+u16 Kvs_Get(u16 key,void *buf,u16 size)
+{
+	Kvs_Rec *r=&Kvs_Buf.h;
+	if(Kvs_Ready==0||key>=KVS_KEY_MAX||Kvs_Index[key]==0)return 0;
+	if(Kvs_Load(Kvs_Index[key])!=0)return 0;
+	memcpy(buf,Kvs_Buf.b+KVS_REC_HEAD,size<r->len?size:r->len);
+	return r->len;
+}
+
+//ɾдһΪ 0 ļ¼
+u8 Kvs_Del(u16 key)
+{
+	if(Kvs_Ready==0||key>=KVS_KEY_MAX)return 1;
+	if(Kvs_Index[key]==0)return 0;
+	if(Kvs_Append(&Kvs_KV,key,0,0)==0)return 1;
+	Kvs_Index[key]=0;
+	return 0;
+}
+
+void Kvs_Wear(u8 log,u32 *min,u32 *max)
+{
+	const Kvs_Area *a=log?&Kvs_Log:&Kvs_KV;
+	u8 i;
+	*min=0XFFFFFFFF;
+	*max=0;
+	for(i=0;i<a->num;i++)
+	{
+		if(a->erase[i]<*min)*min=a->erase[i];
+		if(a->erase[i]>*max)*max=a->erase[i];
+	}
+}
+
+//׷һ־־ ϵ
+u8 Klog_Append(u16 tag,const void *data,u16 len)
+{
+	if(Kvs_Ready==0||tag==0XFFFF||len==0||len>KVS_VAL_MAX)return 1;
+	return Kvs_Append(&Kvs_Log,tag,data,len)==0;
+}
+
+void Klog_Rewind(Klog_Iter *it)
+{
+	it->seq=0;
+	it->off=0;
+	it->sec=0XFF;
+}
+
+//ϵ һ־ (Ĺ ϵ ͽŴʣϵĶ)
+u8 Klog_Next(Klog_Iter *it,u16 *tag,void *buf,u16 *len)
+{
+	Kvs_Area *a=&Kvs_Log;
+	Kvs_Rec *r=&Kvs_Buf.h;
+	u8 i,res;
+	if(Kvs_Ready==0)return 1;
+	while(1)
+	{
+		if(it->sec==0XFF||a->state[it->sec]!=KVS_USED||a->sseq[it->sec]!=it->seq)
+		{
+			it->sec=0XFF;			//һ  it->seq µ ϵ
+			for(i=0;i<a->num;i++)
+			{
+				if(a->state[i]==KVS_USED&&a->sseq[i]>it->seq&&(it->sec==0XFF||a->sseq[i]<a->sseq[it->sec]))it->sec=i;
+			}
+			if(it->sec==0XFF)return 1;
+			it->seq=a->sseq[it->sec];
+			it->off=KVS_HEAD_SIZE;
+		}
+		res=3;
+		if(it->off+KVS_REC_HEAD<=KVS_SECTOR&&(it->sec!=a->active||it->off<a->wr))res=Kvs_Load(Kvs_Addr(a,it->sec)+it->off);
+		if(res==2)
+		{
+			it->off+=KVS_REC_SIZE(r->len);
+			continue;
+		}
+		if(res==0)
+		{
+			it->off+=KVS_REC_SIZE(r->len);
+			*tag=r->key;
+			memcpy(buf,Kvs_Buf.b+KVS_REC_HEAD,*len<r->len?*len:r->len);
+			*len=r->len;
+			return 0;
+		}
+		if(it->sec==a->active)return 1;	// ͷˣԺ־ ԽŶ
+		it->off=KVS_SECTOR;
+		it->sec=0XFF;
+	}
+}
@@ -0,0 +1,69 @@
+#ifndef __KVS_H
+#define __KVS_H
+#include "sys.h"
+//////////////////////////////////////////////////////////////////////////////////
+//STM32F103ZEİ
+//W25Q128 ϵ ֵ洢 + ׷־ (ֻ׷дд)
+//////////////////////////////////////////////////////////////////////////////////
+
+/* W25QXX_Write ÿζ 4K дأдֽҲҪʮ ms
+	ܲͬһĳ ־ʽ 洢
+	ÿ 16 ֽͷ (š)һһ׷Ӽ¼
+		¼ = u16  + u16  + u16 ~ + u16 CRC16 + ݣ4 ֽڶ
+	дһֻһҳ ٲд 2 ֽ CRC (<1ms)ͬһ ¼¼Ǿɼ¼ֵû д
+	д һ  Ŀ (ĥƽ)
+	Kvs_Poll() ں̨գϵ (ֵȰ滹Чļ¼ᵽ) أ
+	´ Poll ٲæ־ѭõȲ
+	û Ͷд/־ ҪȵȲ (оƬʱ) Poll Ҫڵд̫ܡ
+	磺¼ͷ CRCдд CRCдһļ¼ ϵɨʱǰļ¼ڣ
+	ʱ Ȱ ᵽһ ¾һµΪ׼
+
+	ֵ 0~KVS_KEY_MAX-1ֵ KVS_VAL_MAX ֽڣ (ÿ¼¼ĵַ)  RAM 
+	־¼ u16 ǩ ϵKlog_Next ϵµĶ
+
+	ʹã
+	W25QXX_Init();
+	Kvs_Init();
+	Kvs_Set(KVS_KEY_LIMIT,limit,sizeof(limit));
+	if(Kvs_Get(KVS_KEY_LIMIT,limit,sizeof(limit))==sizeof(limit)) ...
+	Klog_Append(KLOG_TAG_SENSOR,tx_buf,28);	//ÿǣ޸ ( userr.c RX_)
+	while(1){ ... Kvs_Poll(); }
+*/
+
+#define KVS_ADDR			0X0C0000	//ֵ ʼַ (Դ 0X100000 ֮)
+#define KVS_SECTORS			8			//ֵ  (32K)
+#define KLOG_ADDR			0X0C8000	//־ ʼַ
+#define KLOG_SECTORS		56			//־  (224K) 0X100000 Ϊֹ
+#define KVS_AREA_MAX		64			//һ 
+
+#define KVS_KEY_MAX			32			//ĸ
+#define KVS_VAL_MAX			64			//ֵ/־ ֽ
+#define KVS_FREE_MIN		2			// Kvs_Poll ͻһ
+
+//
+#define KVS_KEY_TP_ADJ		0			//У׼ (Ԥ 24C02 )
+#define KVS_KEY_LIMIT		1			//
+
+//־ǩ
+#define KLOG_TAG_SENSOR		1			//NRF24L01 յĴ
+
+typedef struct{
+				u32 seq;				//ǰ
+				u16 off;				//һ¼ƫ
+				u8  sec;				//ǰ0xFF:ûʼ
+				}Klog_Iter;
+
+extern u8 Kvs_Ready;					//1:ѹ Զд
+
+u8   Kvs_Init(void);					//ɨ  0:ɹ 1:û FLASH
+void Kvs_Poll(void);					//ѭą̃/ȴ
+u8   Kvs_Set(u16 key,const void *val,u16 len);		//д 0:ɹ
+u16  Kvs_Get(u16 key,void *buf,u16 size);			//ֵĳ (ֻ size ֽ)0:û
+u8   Kvs_Del(u16 key);					//ɾ 0:ɹ
+void Kvs_Wear(u8 log,u32 *min,u32 *max);	//ֵ(0)/־(1)   С/
+
+u8   Klog_Append(u16 tag,const void *data,u16 len);	//׷һ־ 0:ɹ
+void Klog_Rewind(Klog_Iter *it);		//ϵһʼ
+u8   Klog_Next(Klog_Iter *it,u16 *tag,void *buf,u16 *len);	//һ 0: 1:ûˣ*len :buf С :ݳ
+
+#endif
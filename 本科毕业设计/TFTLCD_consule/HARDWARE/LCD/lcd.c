@@ -2566,11 +2566,208 @@ void LCD_Init(void)
 	LCD_LED=1;				//
 	LCD_Clear(WHITE);
 }  
+//------------------------------------------------------------
+//д (blit)
+//6804  ҪԵ ( LCD_Fill)ڷʽ֧֣ԭ/д
+#define LCD_WIN_OK()	(!(lcddev.id==0X6804&&lcddev.dir==1))
+
+//贰ڲʼд GRAM
+static void LCD_Win_Begin(u16 sx,u16 sy,u16 width,u16 height)
+{
+	LCD_Set_Window(sx,sy,width,height);
+	LCD_WriteRAM_Prepare();
+}
+//ָȫ (ֻ꣬ڲָС)
+static void LCD_Win_End(void)
+{
+	LCD_Set_Window(0,0,lcddev.width,lcddev.height);
+}
+
+#if LCD_USE_DMA
+//DMA2ͨ5 洢洢src -> LCD->LCD_RAM (Ŀ̶ַ)inc:ԴַǷ
+//һ 65535 ȴٷ
+static void LCD_DMA_Write(const u16 *src,u32 n,u8 inc)
+{
+	u16 len;
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA2, ENABLE);
+	while(n)
+	{
+		len=n>65535?65535:n;
+		DMA2_Channel5->CCR=0;
+		DMA_ClearFlag(DMA2_FLAG_GL5);
+		DMA2_Channel5->CPAR=(u32)src;				//M2M ʱ "" Դ
+		DMA2_Channel5->CMAR=(u32)&LCD->LCD_RAM;
+		DMA2_Channel5->CNDTR=len;
+		DMA2_Channel5->CCR=DMA_M2M_Enable|DMA_Priority_Medium|DMA_MemoryDataSize_HalfWord|DMA_PeripheralDataSize_HalfWord|
+							(inc?DMA_PeripheralInc_Enable:DMA_PeripheralInc_Disable)|DMA_MemoryInc_Disable|DMA_DIR_PeripheralSRC|DMA_CCR5_EN;
+		while(DMA_GetFlagStatus(DMA2_FLAG_TC5)==RESET);
+		DMA2_Channel5->CCR=0;
+		if(inc)src+=len;
+		n-=len;
+	}
+}
+#endif
+
+//д n ͬɫ
+static void LCD_Stream_Fill(u16 color,u32 n)
+{
+#if LCD_USE_DMA
+	if(n>=32){LCD_DMA_Write(&color,n,0);return;}	//ʱ  DMA 
+#endif
+	while(n>=8)
+	{
+		LCD->LCD_RAM=color;LCD->LCD_RAM=color;LCD->LCD_RAM=color;LCD->LCD_RAM=color;
+		LCD->LCD_RAM=color;LCD->LCD_RAM=color;LCD->LCD_RAM=color;LCD->LCD_RAM=color;
+		n-=8;
+	}
+	while(n--)LCD->LCD_RAM=color;
+}
+//д n  u16 
+static void LCD_Stream_Buf(const u16 *buf,u32 n)
+{
+#if LCD_USE_DMA
+	if(n>=32){LCD_DMA_Write(buf,n,1);return;}
+#endif
+	while(n>=8)
+	{
+		LCD->LCD_RAM=buf[0];LCD->LCD_RAM=buf[1];LCD->LCD_RAM=buf[2];LCD->LCD_RAM=buf[3];
+		LCD->LCD_RAM=buf[4];LCD->LCD_RAM=buf[5];LCD->LCD_RAM=buf[6];LCD->LCD_RAM=buf[7];
+		buf+=8;n-=8;
+	}
+	while(n--)LCD->LCD_RAM=*buf++;
+}
+//д n  ֽǰ ĵ (Image2Lcd )
+//4 ֽڶʱ һζһ REV16 õ㣻u8 鲻֤룬ʱ ֽƴ
+static void LCD_Stream_BE(const u8 *p,u32 n)
+{
+	const u32 *q;
+	u32 w;
+	if(((u32)p&3)==0)
+	{
+		q=(const u32 *)p;
+		while(n>=4)
+		{
+			w=__REV16(q[0]);
+			LCD->LCD_RAM=(u16)w;LCD->LCD_RAM=(u16)(w>>16);
+			w=__REV16(q[1]);
+			LCD->LCD_RAM=(u16)w;LCD->LCD_RAM=(u16)(w>>16);
+			q+=2;n-=4;
+		}
+		p=(const u8 *)q;
+	}
+	else
+	{
+		while(n>=4)
+		{
+			LCD->LCD_RAM=(u16)((p[0]<<8)|p[1]);LCD->LCD_RAM=(u16)((p[2]<<8)|p[3]);
+			LCD->LCD_RAM=(u16)((p[4]<<8)|p[5]);LCD->LCD_RAM=(u16)((p[6]<<8)|p[7]);
+			p+=8;n-=4;
+		}
+	}
+	while(n--)
+	{
+		LCD->LCD_RAM=(u16)((p[0]<<8)|p[1]);
+		p+=2;
+	}
+}
+
+//ֿдڣִ֧ڵ סǰ 㻭
+static u16 LCD_Strm_sx,LCD_Strm_w,LCD_Strm_x,LCD_Strm_y;
+void LCD_Stream_Begin(u16 sx,u16 sy,u16 width,u16 height)
+{
+	LCD_Strm_sx=sx;LCD_Strm_w=width;
+	LCD_Strm_x=sx;LCD_Strm_y=sy;
+	if(LCD_WIN_OK())LCD_Win_Begin(sx,sy,width,height);
+}
+void LCD_Stream_Write(const u16 *buf,u32 n)
+{
+	if(LCD_WIN_OK()){LCD_Stream_Buf(buf,n);return;}
+	while(n--)
+	{
+		LCD_Fast_DrawPoint(LCD_Strm_x,LCD_Strm_y,*buf++);
+		if(++LCD_Strm_x>=LCD_Strm_sx+LCD_Strm_w){LCD_Strm_x=LCD_Strm_sx;LCD_Strm_y++;}
+	}
+}
+void LCD_Stream_End(void)
+{
+	if(LCD_WIN_OK())LCD_Win_End();
+}
+
+// ɫ
+void LCD_Blit_Fill(u16 sx,u16 sy,u16 width,u16 height,u16 color)
+{
+	if(width==0||height==0)return;
+	if(!LCD_WIN_OK()){LCD_Fill(sx,sy,sx+width-1,sy+height-1,color);return;}
+	LCD_Win_Begin(sx,sy,width,height);
+	LCD_Stream_Fill(color,(u32)width*height);
+	LCD_Win_End();
+}
+// д u16 أbuf  width*height 
+void LCD_Blit16(u16 sx,u16 sy,u16 width,u16 height,const u16 *buf)
+{
+	if(width==0||height==0)return;
+	LCD_Stream_Begin(sx,sy,width,height);
+	LCD_Stream_Write(buf,(u32)width*height);
+	LCD_Stream_End();
+}
+//Image2Lcd ͼƬ (8ֽͷ + 16λɫ ֽǰ)  (px,py)  pw*ph һ飬 (sx,sy)
+//ͼLCD_Blit_Pic(sx,sy,pic,0,0,LCD_PIC_W(pic),LCD_PIC_H(pic))
+void LCD_Blit_Pic(u16 sx,u16 sy,const u8 *pic,u16 px,u16 py,u16 pw,u16 ph)
+{
+	u16 w=LCD_PIC_W(pic),h=LCD_PIC_H(pic);
+	u16 i,j;
+	const u8 *p;
+	if(px>=w||py>=h)return;
+	if(pw>w-px)pw=w-px;
+	if(ph>h-py)ph=h-py;
+	if(pw==0||ph==0)return;
+	p=pic+LCD_PIC_HEAD+((u32)py*w+px)*2;
+	if(!LCD_WIN_OK())
+	{
+		for(i=0;i<ph;i++,p+=(u32)w*2)
+			for(j=0;j<pw;j++)LCD_Fast_DrawPoint(sx+j,sy+i,(u16)((p[2*j]<<8)|p[2*j+1]));
+		return;
+	}
+	LCD_Win_Begin(sx,sy,pw,ph);
+	if(pw==w)LCD_Stream_BE(p,(u32)pw*ph);		// һд
+	else for(i=0;i<ph;i++,p+=(u32)w*2)LCD_Stream_BE(p,pw);
+	LCD_Win_End();
+}
+//ɫλͼչ (ģ/ͼ)bits ȣÿֽڸλǰÿв뵽ֽ
+//1 д fg0 д bg
+void LCD_Blit_Mono(u16 sx,u16 sy,u16 width,u16 height,const u8 *bits,u16 fg,u16 bg)
+{
+	u16 i,j;
+	u8 temp=0;
+	if(width==0||height==0)return;
+	if(!LCD_WIN_OK())
+	{
+		for(i=0;i<height;i++)
+			for(j=0;j<width;j++)
+			{
+				if((j&7)==0)temp=*bits++;
+				LCD_Fast_DrawPoint(sx+j,sy+i,(temp&0x80)?fg:bg);
+				temp<<=1;
+			}
+		return;
+	}
+	LCD_Win_Begin(sx,sy,width,height);
+	for(i=0;i<height;i++)
+	{
+		for(j=0;j<width;j++)
+		{
+			if((j&7)==0)temp=*bits++;
+			LCD->LCD_RAM=(temp&0x80)?fg:bg;
+			temp<<=1;
+		}
+	}
+	LCD_Win_End();
+}
+
 //
 //color:Ҫɫ
 void LCD_Clear(u16 color)
 {
-	u32 index=0;      
 	u32 totalpoint=lcddev.width;
 	totalpoint*=lcddev.height; 			//õܵ
 	if((lcddev.id==0X6804)&&(lcddev.dir==1))//6804ʱ⴦  
@@ -2584,18 +2781,13 @@ void LCD_Clear(u16 color)
 		lcddev.setycmd=0X2A;  	 
  	}else LCD_SetCursor(0x00,0x0000);	//ùλ 
 	LCD_WriteRAM_Prepare();     		//ʼдGRAM	 	  
-	for(index=0;index<totalpoint;index++)
-	{
-		LCD->LCD_RAM=color;	
-	}
+	LCD_Stream_Fill(color,totalpoint);	//ȫڣд
 }  
 //ָ䵥ɫ
 //(sx,sy),(ex,ey):ζԽ,СΪ:(ex-sx+1)*(ey-sy+1)   
 //color:Ҫɫ
 void LCD_Fill(u16 sx,u16 sy,u16 ex,u16 ey,u16 color)
 {          
-	u16 i,j;
-	u16 xlen=0;
 	u16 temp;
 	if((lcddev.id==0X6804)&&(lcddev.dir==1))	//6804ʱ⴦  
 	{
@@ -2611,32 +2803,14 @@ void LCD_Fill(u16 sx,u16 sy,u16 ex,u16 ey,u16 color)
  		lcddev.dir=1;	 
   		lcddev.setxcmd=0X2B;
 		lcddev.setycmd=0X2A;  	 
- 	}else
-	{
-		xlen=ex-sx+1;	 
-		for(i=sy;i<=ey;i++)
-		{
-		 	LCD_SetCursor(sx,i);      				//ùλ 
-			LCD_WriteRAM_Prepare();     			//ʼдGRAM	  
-			for(j=0;j<xlen;j++)LCD->LCD_RAM=color;	//ʾɫ 	    
-		}
-	}	 
+ 	}else LCD_Blit_Fill(sx,sy,ex-sx+1,ey-sy+1,color);	//һδ д
 }  
 //ָָɫ			 
 //(sx,sy),(ex,ey):ζԽ,СΪ:(ex-sx+1)*(ey-sy+1)   
 //color:Ҫɫ
 void LCD_Color_Fill(u16 sx,u16 sy,u16 ex,u16 ey,u16 *color)
 {  
-	u16 height,width;
-	u16 i,j;
-	width=ex-sx+1; 			//õĿ
-	height=ey-sy+1;			//߶
- 	for(i=0;i<height;i++)
-	{
- 		LCD_SetCursor(sx,sy+i);   	//ùλ 
-		LCD_WriteRAM_Prepare();     //ʼдGRAM
-		for(j=0;j<width;j++)LCD->LCD_RAM=color[i*width+j];//д 
-	}		  
+	LCD_Blit16(sx,sy,ex-sx+1,ey-sy+1,color);	//һδ DMA д
 }  
 //
 //x1,y1:
@@ -2747,12 +2921,32 @@ void LCD_ShowChar_user(u16 x,u16 y,char num,u8 size,u8 mode) //
 		}  	 
 	}  	    	   	 	  
 }
+static u16 LCD_Char_Buf[24*12];		//ǵַ չ ( 24)
 void LCD_ShowChar(u16 x,u16 y,u8 num,u8 size,u8 mode)
 {  							  
     u8 temp,t1,t;
 	u16 y0=y;
 	u8 csize=(size/8+((size%8)?1:0))*(size/2);		//õһַӦռֽ	
+	u8 col=0,row=0;
  	num=num-' ';//õƫƺֵASCIIֿǴӿոʼȡģ-' 'ǶӦַֿ⣩
+	//ǵ  ַڣģ  ģչ  һδ д
+	if(mode==0&&(size==12||size==16||size==24)&&x+size/2<=lcddev.width&&y+size<=lcddev.height&&LCD_WIN_OK())
+	{
+		for(t=0;t<csize;t++)
+		{
+			if(size==12)temp=asc2_1206[num][t];
+			else if(size==16)temp=asc2_1608[num][t];
+			else temp=asc2_2412[num][t];
+			for(t1=0;t1<8;t1++)
+			{
+				LCD_Char_Buf[row*(size/2)+col]=(temp&0x80)?POINT_COLOR:BACK_COLOR;
+				temp<<=1;
+				if(++row==size){row=0;col++;break;}
+			}
+		}
+		LCD_Blit16(x,y,size/2,size,LCD_Char_Buf);
+		return;
+	}
 	for(t=0;t<csize;t++)
 	{   
 		if(size==12)temp=asc2_1206[num][t]; 	 	//1206
@@ -2954,21 +3148,10 @@ void gui_draw_hline(u16 x0,u16 y0,u16 len,u16 color)
 
 
 //ʾͼʾ,Image2Lcd V2.9 ͼ  By:gaofei                
+//ԭ LCD_Fast_DrawPoint (ÿ㶼ط)Ϊһδ д
 void Picture_Draw(u16 S_x,u16 S_y,const unsigned char *pic)
 {
-	u32 i=8,len;
-	u16 temp,x,y,D_x=0,D_y=0;
-	x=(uint16_t)((pic[2]<<8)+pic[3])-1; //ͼȡͼĿ
-	y=(uint16_t)((pic[4]<<8)+pic[5])-1; //ͼȡͼĸ߶
-	len=2*x*y;        //ȡͼƬص
-	while(i<(len+8))      //ʾص
-	{//16λߣ Ҫһη2ֽڵ
-		temp=(uint16_t)((pic[i]<<8)+pic[i+1]);      //image2lcdɵ8λ飬ʮλɫͼΪ8λ͵8λת16λݣ
-		if(D_x>x) {D_x=0;D_y++;}         //ʾ
-		LCD_Fast_DrawPoint(S_x+D_x,S_y+D_y,temp);    //㣬ƴͼ񣬵ԭӿٻ㺯
-		D_x++;
-		i=i+2; //ȡģλü2Ϊȡһ
-	}
+	LCD_Blit_Pic(S_x,S_y,pic,0,0,LCD_PIC_W(pic),LCD_PIC_H(pic));
 }
 
 /*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
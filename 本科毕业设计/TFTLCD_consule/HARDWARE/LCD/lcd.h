@@ -151,6 +151,28 @@ void lcd_draw_bline(u16 x1, u16 y1, u16 x2, u16 y2,u8 size,u16 color);//
 
 //ʾͼʾ,Image2Lcd V2.9 ͼ  By:gaofei                
 void Picture_Draw(u16 S_x,u16 S_y,const unsigned char *pic);//ָ귶ΧʾһͼƬ
+
+//------------------------------------------------------------
+/* д (blit)
+	ԭ ͼ/ ÿ (ÿһ) · X/Y һҪüд
+	 LCD_Set_Window һδڣ֮д LCD->LCD_RAM (GRAM ַԶ)
+	u16  (LCD_Color_Fill/LCD_Blit16)  ɫ  DMA2ͨ5 洢洢 ֱд FSMC ַ
+	Image2Lcd  ֽǰ ֱֽ DMA CPU չѭ (һȡ 2  REV16 )
+	дָȫڣ㺯Ӱ졣*/
+#define LCD_USE_DMA		1		//1:u16 /ɫ  DMA2ͨ5  0:ȫ CPU д
+
+#define LCD_PIC_W(pic)	((u16)(((pic)[2]<<8)|(pic)[3]))		//Image2Lcd  
+#define LCD_PIC_H(pic)	((u16)(((pic)[4]<<8)|(pic)[5]))		//Image2Lcd  
+#define LCD_PIC_HEAD	8									//Image2Lcd ͷ ֽ
+
+void LCD_Blit_Fill(u16 sx,u16 sy,u16 width,u16 height,u16 color);	// ɫ
+void LCD_Blit16(u16 sx,u16 sy,u16 width,u16 height,const u16 *buf);	// д u16  ()
+void LCD_Blit_Pic(u16 sx,u16 sy,const u8 *pic,u16 px,u16 py,u16 pw,u16 ph);//Image2Lcd ͼƬ һ (px,py,pw,ph)  (sx,sy)
+void LCD_Blit_Mono(u16 sx,u16 sy,u16 width,u16 height,const u8 *bits,u16 fg,u16 bg);//ɫλͼչ λǰ ÿв뵽ֽ
+//ֿдһ (ݲһڴʱã SPI FLASH ߶д)
+void LCD_Stream_Begin(u16 sx,u16 sy,u16 width,u16 height);	//贰 ʼд
+void LCD_Stream_Write(const u16 *buf,u32 n);				//д n  ()
+void LCD_Stream_End(void);									//ָȫ
 #if 1
 void LCD_Draw_Picture(u16 xstr,u16 ystr,u16 xend,u16 yend,u16 color_user,u8 *pic);//ָλʾһɫͼ
 void lcd_wr_zf(u16 StartX, u16 StartY, u16 X, u16 Y, u16 Color, u8 Dir, u8 *chr);//ָʾһַ͸ڱͼƬ
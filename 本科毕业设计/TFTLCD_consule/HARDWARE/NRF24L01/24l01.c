@@ -60,9 +60,12 @@ u8 NRF24L01_Check(void)
 {
 	u8 buf[5]={0XA5,0XA5,0XA5,0XA5,0XA5};
 	u8 i;
+	SPI2_Lock();				//·жϿʱ ѭҲ
 	SPI2_SetSpeed(SPI_BaudRatePrescaler_4); //spiٶΪ9Mhz24L01SPIʱΪ10Mhz   	 
 	NRF24L01_Write_Buf(NRF_WRITE_REG+TX_ADDR,buf,5);//д5ֽڵĵַ.	
 	NRF24L01_Read_Buf(TX_ADDR,buf,5); //дĵַ  
+	NRF24L01_Write_Buf(NRF_WRITE_REG+TX_ADDR,(u8*)TX_ADDRESS,TX_ADR_WIDTH);//дط͵ַ (·ֻڳʼʱдһ)
+	SPI2_Unlock();
 	for(i=0;i<5;i++)if(buf[i]!=0XA5)break;	 							   
 	if(i!=5)return 1;//24L01	
 	return 0;		 //⵽24L01
@@ -195,6 +198,302 @@ void NRF24L01_TX_Mode(void)
 	NRF24L01_CE=1;//CEΪ,10us
 }
 
+//////////////////////////////////////////////////////////////////////////////////
+//жշ (·)
+//////////////////////////////////////////////////////////////////////////////////
+typedef struct{
+				u8 len;
+				u8 buf[32];
+				}NRF_Frame;
+
+NRF_Link_Stat_t NRF_Link_Stat;
+
+static NRF_Frame NRF_Txq[NRF_LINK_TXQ];
+static NRF_Frame NRF_Rxq[NRF_LINK_RXQ];
+static volatile u8 NRF_Tx_Head=0,NRF_Tx_Tail=0;	//Head ѭţTail жյ ACK ȥ
+static volatile u8 NRF_Tx_Sent=0;				// Tail  ѾдоƬ TX FIFO İ (2)
+static volatile u8 NRF_Rx_Head=0,NRF_Rx_Tail=0;	//Head жϷţTail ѭȡ
+static volatile u8 NRF_Prx=0;					//1:շ
+static volatile u8 NRF_Mode_Req=0XFF;			//Ҫģʽ 0XFF:
+static volatile u8 NRF_Dma_Op=0;				//0: 1:DMA ڶ 2:DMA д
+static u8  NRF_Rx_Len;							//ڶİ0:  NRF_Drop ӵ
+static u8  NRF_Drop[32];						//ӵİ / дʱ RX DMA ȥ
+static u8  NRF_Dummy=0XFF;						//ʱ TX DMA һֱ 0xFF
+static u16 NRF_Cr1;								//ǰ SPI2->CR1
+
+#define NRF_DMA_READ		1
+#define NRF_DMA_WRITE		2
+#define NRF_CONFIG			0x0e				//PWR_UP,EN_CRC,16BIT_CRC,ж (bit0 PRIM_RX )
+//SPI2 ģʽ0 4Ƶ (9M24L01  10M)W25QXX õǱãʱ
+#define NRF_SPI_CR1			(SPI_Direction_2Lines_FullDuplex|SPI_Mode_Master|SPI_DataSize_8b|SPI_CPOL_Low|SPI_CPHA_1Edge|SPI_NSS_Soft|SPI_BaudRatePrescaler_4|SPI_FirstBit_MSB)
+
+//Ĵãֻ NRF_Link_Init дһΣģʽд
+static const u8 NRF_Reg_Tab[][2]={
+	{EN_AA,0x01},			//ͨ0 ԶӦ
+	{EN_RXADDR,0x01},		//ͨ0 
+	{SETUP_AW,0x03},		//5ֽڵַ
+	{SETUP_RETR,0x1a},		//500us + 86us,ط10 (2Mbps  ACK  32 ֽ 500us )
+	{RF_CH,40},				//RFͨ40
+	{RF_SETUP,0x0f},		//0db,2Mbps,濪
+	{DYNPD,0x01},			//ͨ0 ̬
+	{FEATURE,0x06},			//̬ + ACK
+};
+
+static void NRF_Spi_Enter(void)
+{
+	NRF_Cr1=SPI2->CR1;
+	SPI2->CR1=NRF_SPI_CR1;					// CPOL/CPHA Ҫȹ SPE
+	SPI2->CR1=NRF_SPI_CR1|SPI_CR1_SPE;
+}
+static void NRF_Spi_Exit(void)
+{
+	SPI2->CR1=NRF_Cr1&~SPI_CR1_SPE;
+	SPI2->CR1=NRF_Cr1;
+}
+static u8 NRF_Status(void)
+{
+	u8 sta;
+	NRF24L01_CSN=0;
+	sta=SPI2_ReadWriteByte(NOP);
+	NRF24L01_CSN=1;
+	return sta;
+}
+
+//ֽڲѯ len ֽ DMA ᣬ DMA1_Channel4_IRQHandler
+static void NRF_Dma_Start(u8 cmd,u8 *buf,u8 len,u8 op)
+{
+	NRF24L01_CSN=0;
+	SPI2_ReadWriteByte(cmd);
+	SPI2->CR2&=~(SPI_I2S_DMAReq_Rx|SPI_I2S_DMAReq_Tx);
+	DMA1_Channel4->CCR=0;
+	DMA1_Channel5->CCR=0;
+	DMA1->IFCR=DMA1_FLAG_GL4|DMA1_FLAG_GL5;
+	(void)SPI2->DR;								// RXNE
+	DMA1_Channel4->CPAR=(u32)&SPI2->DR;
+	DMA1_Channel4->CMAR=(u32)(op==NRF_DMA_READ?buf:NRF_Drop);
+	DMA1_Channel4->CNDTR=len;
+	DMA1_Channel5->CPAR=(u32)&SPI2->DR;
+	DMA1_Channel5->CMAR=(u32)(op==NRF_DMA_READ?&NRF_Dummy:buf);
+	DMA1_Channel5->CNDTR=len;
+	//һֽ (ͨ4) ֻ꣬ͨ4 ж
+	DMA1_Channel4->CCR=DMA_DIR_PeripheralSRC|DMA_MemoryInc_Enable|DMA_Priority_VeryHigh|DMA_IT_TC|DMA_CCR4_EN;
+	DMA1_Channel5->CCR=DMA_DIR_PeripheralDST|(op==NRF_DMA_READ?DMA_MemoryInc_Disable:DMA_MemoryInc_Enable)|DMA_Priority_High|DMA_CCR5_EN;
+	NRF_Dma_Op=op;
+	SPI2->CR2|=SPI_I2S_DMAReq_Rx|SPI_I2S_DMAReq_Tx;
+}
+
+//Ͷ ȥ n Ѿİ
+static void NRF_Tx_Pop(u8 n)
+{
+	NRF_Tx_Sent-=n;
+	NRF_Tx_Tail=(NRF_Tx_Tail+n)%NRF_LINK_TXQ;
+}
+
+//жã STATUS Ķ꣬Ҫʱ  DMA أDMA жٽ
+//˳ʱ STATUS ûб־IRQ Ѿصߣһ¼һ½
+static void NRF_Link_Service(void)
+{
+	u8 sta,n,i;
+	while(1)
+	{
+		if(SPI2_Lock_Cnt)						//ѭ SPI2 SPI2_Unlock 
+		{
+			SPI2_Pend_Line|=EXTI_Line6;
+			break;
+		}
+		if(SPI2_Isr_Busy==0)
+		{
+			SPI2_Isr_Busy=1;
+			NRF_Spi_Enter();
+		}
+		if(NRF_Mode_Req!=0XFF)					//ģʽֻ CONFIG/CE
+		{
+			NRF24L01_CE=0;
+			NRF_Prx=NRF_Mode_Req;
+			NRF_Mode_Req=0XFF;
+			NRF24L01_Write_Reg(FLUSH_TX,0xff);	//оƬİϣ д
+			NRF_Tx_Sent=0;
+			NRF24L01_Write_Reg(NRF_WRITE_REG+CONFIG,NRF_CONFIG|NRF_Prx);
+			NRF24L01_CE=1;
+		}
+		sta=NRF_Status();
+		if(sta&(TX_OK|MAX_TX))
+		{
+			NRF24L01_Write_Reg(NRF_WRITE_REG+STATUS,sta&(TX_OK|MAX_TX));
+			if(NRF_Prx==0)NRF_Link_Stat.retrans+=NRF24L01_Read_Reg(OBSERVE_TX)&0x0F;	//һط
+			if(sta&TX_OK)
+			{
+				//־ۼӣжϱƳʱѾ꼸TX FIFO ˾Ƕˣ
+				//û ǻʣ 1  (оƬ 2 ʣ )
+				n=(NRF24L01_Read_Reg(NRF_FIFO_STATUS)&0x10)?NRF_Tx_Sent:1;
+				if(n>NRF_Tx_Sent)n=NRF_Tx_Sent;
+				NRF_Link_Stat.tx_ok+=n;
+				NRF_Tx_Pop(n);
+			}
+			if(sta&MAX_TX)						//ǰһȥӵİдоƬ
+			{
+				NRF24L01_Write_Reg(FLUSH_TX,0xff);
+				if(NRF_Tx_Sent)
+				{
+					NRF_Link_Stat.tx_lost++;
+					NRF_Tx_Pop(1);
+				}
+				NRF_Tx_Sent=0;
+			}
+			continue;
+		}
+		if(((sta>>1)&0x07)!=0x07)				//RX FIFO а
+		{
+			NRF24L01_Write_Reg(NRF_WRITE_REG+STATUS,RX_OK);
+			n=NRF24L01_Read_Reg(R_RX_PL_WID);
+			if(n==0||n>32)						//Ȳ  FIFO ӵ
+			{
+				NRF24L01_Write_Reg(FLUSH_RX,0xff);
+				continue;
+			}
+			if((NRF_Rx_Head+1)%NRF_LINK_RXQ==NRF_Rx_Tail)
+			{
+				NRF_Rx_Len=0;
+				NRF_Link_Stat.rx_drop++;
+				NRF_Dma_Start(RD_RX_PLOAD,NRF_Drop,n,NRF_DMA_READ);
+			}
+			else
+			{
+				NRF_Rx_Len=n;
+				NRF_Dma_Start(RD_RX_PLOAD,NRF_Rxq[NRF_Rx_Head].buf,n,NRF_DMA_READ);
+			}
+			return;
+		}
+		if(sta&RX_OK)							//FIFO Ѿ˵ RX_DR
+		{
+			NRF24L01_Write_Reg(NRF_WRITE_REG+STATUS,RX_OK);
+			continue;
+		}
+		if(NRF_Tx_Sent<2&&(sta&TX_FULL)==0)		//оƬﲻ 2  Ų ( 3  TX_DS/MAX_RT Ƴʱ ֲİ)
+		{
+			i=(NRF_Tx_Tail+NRF_Tx_Sent)%NRF_LINK_TXQ;
+			if(i!=NRF_Tx_Head)
+			{
+				NRF_Dma_Start(NRF_Prx?W_ACK_PAYLOAD:WR_TX_PLOAD,NRF_Txq[i].buf,NRF_Txq[i].len,NRF_DMA_WRITE);
+				return;
+			}
+		}
+		break;
+	}
+	if(SPI2_Isr_Busy)
+	{
+		NRF_Spi_Exit();
+		SPI2_Isr_Busy=0;
+	}
+}
 
+//IRQ ½أ NRF_Link_Send/NRF_Link_Mode/SPI2_Unlock 
+void EXTI9_5_IRQHandler(void)
+{
+	if(EXTI->PR&EXTI_Line6)
+	{
+		EXTI->PR=EXTI_Line6;
+		if(NRF_Dma_Op==0)NRF_Link_Service();	//DMA û DMA жŲ
+	}
+}
 
+//
+void DMA1_Channel4_IRQHandler(void)
+{
+	if(DMA1->ISR&DMA1_FLAG_TC4)
+	{
+		DMA1->IFCR=DMA1_FLAG_GL4|DMA1_FLAG_GL5;
+		if(NRF_Dma_Op==0)return;					//W25QXX  жϣᵽ
+		SPI2->CR2&=~(SPI_I2S_DMAReq_Rx|SPI_I2S_DMAReq_Tx);
+		DMA1_Channel4->CCR=0;
+		DMA1_Channel5->CCR=0;
+		NRF24L01_CSN=1;
+		if(NRF_Dma_Op==NRF_DMA_READ)
+		{
+			if(NRF_Rx_Len)
+			{
+				NRF_Rxq[NRF_Rx_Head].len=NRF_Rx_Len;
+				NRF_Rx_Head=(NRF_Rx_Head+1)%NRF_LINK_RXQ;
+				NRF_Link_Stat.rx_ok++;
+			}
+		}
+		else NRF_Tx_Sent++;
+		NRF_Dma_Op=0;
+		NRF_Link_Service();
+	}
+}
 
+//дȫĴ IRQ/DMA ж
+//prx:0,ͷ;1,շ
+void NRF_Link_Init(u8 prx)
+{
+	u8 i;
+	SPI2_Lock();								//ٴγʼʱ жĴ
+	NRF_Spi_Enter();
+	NRF24L01_CE=0;
+	NRF24L01_Write_Buf(NRF_WRITE_REG+TX_ADDR,(u8*)TX_ADDRESS,TX_ADR_WIDTH);//дTXڵַ
+	NRF24L01_Write_Buf(NRF_WRITE_REG+RX_ADDR_P0,(u8*)RX_ADDRESS,RX_ADR_WIDTH);//RXڵַ (ͷACKҲ)
+	for(i=0;i<sizeof(NRF_Reg_Tab)/2;i++)NRF24L01_Write_Reg(NRF_WRITE_REG+NRF_Reg_Tab[i][0],NRF_Reg_Tab[i][1]);
+	if(NRF24L01_Read_Reg(FEATURE)!=0x06)		//+оƬ FEATURE/DYNPD Ҫ ACTIVATE дý
+	{
+		NRF24L01_Write_Reg(ACTIVATE,0x73);
+		NRF24L01_Write_Reg(NRF_WRITE_REG+FEATURE,0x06);
+		NRF24L01_Write_Reg(NRF_WRITE_REG+DYNPD,0x01);
+	}
+	NRF24L01_Write_Reg(FLUSH_TX,0xff);
+	NRF24L01_Write_Reg(FLUSH_RX,0xff);
+	NRF24L01_Write_Reg(NRF_WRITE_REG+STATUS,RX_OK|TX_OK|MAX_TX);	//жϱ־
+	NRF24L01_Write_Reg(NRF_WRITE_REG+CONFIG,NRF_CONFIG|(prx?1:0));
+	NRF_Spi_Exit();
+	NRF_Tx_Head=NRF_Tx_Tail=NRF_Tx_Sent=0;
+	NRF_Rx_Head=NRF_Rx_Tail=0;
+	NRF_Prx=prx?1:0;
+	NRF_Mode_Req=0XFF;
+	delay_ms(2);								//-> 1.5ms
+	NRF24L01_CE=1;								//ͷ CE һֱߣFIFO аͷ˴
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1,ENABLE);
+	Ex_NVIC_Config(GPIO_G,6,FTIR);				//PG6 ½
+	MY_NVIC_Init(2,1,EXTI9_5_IRQn,2);			//ռ2ȼ12
+	MY_NVIC_Init(2,1,DMA1_Channel4_IRQn,2);		// EXTI ͬһռ
+	SPI2_Pend_Line|=EXTI_Line6;					//SPI2_Unlock ʱһ (IRQ ǵ)
+	SPI2_Unlock();
+}
+
+//ģʽ (ж)
+void NRF_Link_Mode(u8 prx)
+{
+	NRF_Mode_Req=prx?1:0;
+	EXTI->SWIER|=EXTI_Line6;
+}
+
+//ŽͶ (շ:Ž ACK )
+//ֵ:0,ɹ;1,򳤶Ȳ
+u8 NRF_Link_Send(const u8 *buf,u8 len)
+{
+	u8 i,next=(NRF_Tx_Head+1)%NRF_LINK_TXQ;
+	if(len==0||len>32||next==NRF_Tx_Tail)return 1;
+	for(i=0;i<len;i++)NRF_Txq[NRF_Tx_Head].buf[i]=buf[i];
+	NRF_Txq[NRF_Tx_Head].len=len;
+	NRF_Tx_Head=next;
+	EXTI->SWIER|=EXTI_Line6;					//ждоƬ
+	return 0;
+}
+
+//ӽնȡһ
+//ֵ:0,ȡ;1,û
+u8 NRF_Link_Recv(u8 *buf,u8 *len)
+{
+	NRF_Frame *f;
+	u8 i;
+	if(NRF_Rx_Tail==NRF_Rx_Head)return 1;
+	f=&NRF_Rxq[NRF_Rx_Tail];
+	for(i=0;i<f->len;i++)buf[i]=f->buf[i];
+	*len=f->len;
+	NRF_Rx_Tail=(NRF_Rx_Tail+1)%NRF_LINK_RXQ;
+	return 0;
+}
+
+u8 NRF_Link_Tx_Free(void)
+{
+	return (NRF_Tx_Tail+NRF_LINK_TXQ-NRF_Tx_Head-1)%NRF_LINK_TXQ;
+}
@@ -80,6 +80,30 @@ u8 SPI2_ReadWriteByte(u8 TxData)
 	return SPI_I2S_ReceiveData(SPI2); //ͨSPIxյ					    
 }
 
+//SPI2 ߹ãW25QXX ѭãNRF24L01 ж
+//ѭһβ(Ƭѡ͵)ǰ SPI2_Lock/SPI2_UnlockжҪʱȿ SPI2_Lock_Cnt
+//ռžͰԼ EXTI ߼ǵ SPI2_Pend_Line ˳SPI2_Unlock ſʱ жϲһ
+volatile u8  SPI2_Lock_Cnt=0;		//ѭռü (Ƕ)
+volatile u8  SPI2_Isr_Busy=0;		//1:жһδ( DMA)û
+volatile u32 SPI2_Pend_Line=0;		//ߵ EXTI 
+void SPI2_Lock(void)
+{
+	SPI2_Lock_Cnt++;
+	while(SPI2_Isr_Busy);			//ж DMA  (жϿ Lock_Cnt 󲻻ٿµ)
+}
+void SPI2_Unlock(void)
+{
+	u32 line;
+	if(SPI2_Lock_Cnt==0)return;
+	if(--SPI2_Lock_Cnt)return;
+	line=SPI2_Pend_Line;
+	if(line)
+	{
+		SPI2_Pend_Line=0;
+		EXTI->SWIER|=line;			//õŵжһ
+	}
+}
+
 
 
 
@@ -12,6 +12,12 @@
 void SPI2_Init(void);			 //ʼSPI
 void SPI2_SetSpeed(u8 SpeedSet); //SPIٶ   
 u8 SPI2_ReadWriteByte(u8 TxData);//SPI߶дһֽ
+
+extern volatile u8  SPI2_Lock_Cnt;	//ѭռ SPI2 Ĳ
+extern volatile u8  SPI2_Isr_Busy;	//ж SPI2
+extern volatile u32 SPI2_Pend_Line;	//ߵ EXTI  (SPI2_Unlock ʱ)
+void SPI2_Lock(void);			 //ѭռ SPI2 (жĴ)
+void SPI2_Unlock(void);			 //ͷţƳٵж
 		 
 #endif
 
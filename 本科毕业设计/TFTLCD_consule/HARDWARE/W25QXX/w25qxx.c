@@ -53,36 +53,44 @@ void W25QXX_Init(void)
 u8 W25QXX_ReadSR(void)   
 {  
 	u8 byte=0;   
+	SPI2_Lock();
 	W25QXX_CS=0;                            //ʹ   
 	SPI2_ReadWriteByte(W25X_ReadStatusReg); //Ͷȡ״̬Ĵ    
 	byte=SPI2_ReadWriteByte(0Xff);          //ȡһֽ  
 	W25QXX_CS=1;                            //ȡƬѡ     
+	SPI2_Unlock();
 	return byte;   
 } 
 //дW25QXX״̬Ĵ
 //ֻSPR,TB,BP2,BP1,BP0(bit 7,5,4,3,2)д!!!
 void W25QXX_Write_SR(u8 sr)   
 {   
+	SPI2_Lock();
 	W25QXX_CS=0;                            //ʹ   
 	SPI2_ReadWriteByte(W25X_WriteStatusReg);//дȡ״̬Ĵ    
 	SPI2_ReadWriteByte(sr);               	//дһֽ  
 	W25QXX_CS=1;                            //ȡƬѡ     	      
+	SPI2_Unlock();
 }   
 //W25QXXдʹ	
 //WELλ   
 void W25QXX_Write_Enable(void)   
 {
+	SPI2_Lock();
 	W25QXX_CS=0;                          	//ʹ   
     SPI2_ReadWriteByte(W25X_WriteEnable); 	//дʹ  
 	W25QXX_CS=1;                           	//ȡƬѡ     	      
+	SPI2_Unlock();
 } 
 //W25QXXдֹ	
 //WEL  
 void W25QXX_Write_Disable(void)   
 {  
+	SPI2_Lock();
 	W25QXX_CS=0;                            //ʹ   
     SPI2_ReadWriteByte(W25X_WriteDisable);  //дָֹ    
 	W25QXX_CS=1;                            //ȡƬѡ     	      
+	SPI2_Unlock();
 } 		
 //ȡоƬID
 //ֵ:				   
@@ -94,6 +102,7 @@ void W25QXX_Write_Disable(void)
 u16 W25QXX_ReadID(void)
 {
 	u16 Temp = 0;	  
+	SPI2_Lock();
 	W25QXX_CS=0;				    
 	SPI2_ReadWriteByte(0x90);//ͶȡID	    
 	SPI2_ReadWriteByte(0x00); 	    
@@ -102,6 +111,7 @@ u16 W25QXX_ReadID(void)
 	Temp|=SPI2_ReadWriteByte(0xFF)<<8;  
 	Temp|=SPI2_ReadWriteByte(0xFF);	 
 	W25QXX_CS=1;				    
+	SPI2_Unlock();
 	return Temp;
 }   		    
 //ȡSPI FLASH  
@@ -112,6 +122,8 @@ u16 W25QXX_ReadID(void)
 void W25QXX_Read(u8* pBuffer,u32 ReadAddr,u16 NumByteToRead)   
 { 
  	u16 i;   										    
+	W25QXX_Wait_Busy();							//̨ (W25QXX_Erase_Sector_Start) ʱ 
+	SPI2_Lock();
 	W25QXX_CS=0;                            	//ʹ   
     SPI2_ReadWriteByte(W25X_ReadData);         	//Ͷȡ   
     SPI2_ReadWriteByte((u8)((ReadAddr)>>16));  	//24bitַ    
@@ -122,7 +134,64 @@ void W25QXX_Read(u8* pBuffer,u32 ReadAddr,u16 NumByteToRead)
         pBuffer[i]=SPI2_ReadWriteByte(0XFF);   	//ѭ  
     }
 	W25QXX_CS=1;  				    	      
+	SPI2_Unlock();
 }  
+//SPI2 DMA
+static u16 W25QXX_Stream_CR1;		//ǰ SPI2->CR1ʱָ
+static u8  W25QXX_Stream_Run=0;		//1:DMA  û
+static u8  W25QXX_Dummy=0XFF;		//TX DMA һֱ 0xFF
+void W25QXX_Stream_Begin(u32 ReadAddr)
+{
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
+	SPI2_Lock();								//DMA1 ͨ4/5  SPI2 һֱռ Stream_End
+	W25QXX_Stream_CR1=SPI2->CR1;
+	SPI2_SetSpeed(SPI_BaudRatePrescaler_2);		//18M
+	W25QXX_Wait_Busy();
+	W25QXX_CS=0;
+    SPI2_ReadWriteByte(W25X_ReadData);
+    SPI2_ReadWriteByte((u8)((ReadAddr)>>16));
+    SPI2_ReadWriteByte((u8)((ReadAddr)>>8));
+    SPI2_ReadWriteByte((u8)ReadAddr);
+	W25QXX_Stream_Run=0;
+}
+//̨ NumByteToRead ֽڵ pBuffer
+void W25QXX_Stream_Read_DMA(u8* pBuffer,u16 NumByteToRead)
+{
+	while(W25QXX_Stream_Busy());
+	if(NumByteToRead==0)return;
+	SPI2->CR2&=~(SPI_I2S_DMAReq_Rx|SPI_I2S_DMAReq_Tx);
+	DMA1_Channel4->CCR=0;
+	DMA1_Channel5->CCR=0;
+	DMA_ClearFlag(DMA1_FLAG_GL4|DMA1_FLAG_GL5);
+	(void)SPI2->DR;								// RXNE
+	DMA1_Channel4->CPAR=(u32)&SPI2->DR;			//RXDR -> pBuffer
+	DMA1_Channel4->CMAR=(u32)pBuffer;
+	DMA1_Channel4->CNDTR=NumByteToRead;
+	DMA1_Channel4->CCR=DMA_DIR_PeripheralSRC|DMA_MemoryInc_Enable|DMA_Priority_VeryHigh|DMA_CCR4_EN;
+	DMA1_Channel5->CPAR=(u32)&SPI2->DR;			//TX0xFF -> DRַ
+	DMA1_Channel5->CMAR=(u32)&W25QXX_Dummy;
+	DMA1_Channel5->CNDTR=NumByteToRead;
+	DMA1_Channel5->CCR=DMA_DIR_PeripheralDST|DMA_MemoryInc_Disable|DMA_Priority_High|DMA_CCR5_EN;
+	W25QXX_Stream_Run=1;
+	SPI2->CR2|=SPI_I2S_DMAReq_Rx|SPI_I2S_DMAReq_Tx;
+}
+u8 W25QXX_Stream_Busy(void)
+{
+	if(W25QXX_Stream_Run==0)return 0;
+	if(DMA_GetFlagStatus(DMA1_FLAG_TC4)==RESET)return 1;	//һֽ 
+	W25QXX_Stream_Run=0;
+	return 0;
+}
+void W25QXX_Stream_End(void)
+{
+	while(W25QXX_Stream_Busy());
+	SPI2->CR2&=~(SPI_I2S_DMAReq_Rx|SPI_I2S_DMAReq_Tx);
+	DMA1_Channel4->CCR=0;
+	DMA1_Channel5->CCR=0;
+	W25QXX_CS=1;
+	SPI2->CR1=W25QXX_Stream_CR1;
+	SPI2_Unlock();
+}
 //SPIһҳ(0~65535)д256ֽڵ
 //ַָʼд256ֽڵ
 //pBuffer:ݴ洢
@@ -131,7 +200,9 @@ void W25QXX_Read(u8* pBuffer,u32 ReadAddr,u16 NumByteToRead)
 void W25QXX_Write_Page(u8* pBuffer,u32 WriteAddr,u16 NumByteToWrite)
 {
  	u16 i;  
+	W25QXX_Wait_Busy();
     W25QXX_Write_Enable();                  	//SET WEL 
+	SPI2_Lock();
 	W25QXX_CS=0;                            	//ʹ   
     SPI2_ReadWriteByte(W25X_PageProgram);      	//дҳ   
     SPI2_ReadWriteByte((u8)((WriteAddr)>>16)); 	//24bitַ    
@@ -139,6 +210,7 @@ void W25QXX_Write_Page(u8* pBuffer,u32 WriteAddr,u16 NumByteToWrite)
     SPI2_ReadWriteByte((u8)WriteAddr);   
     for(i=0;i<NumByteToWrite;i++)SPI2_ReadWriteByte(pBuffer[i]);//ѭд  
 	W25QXX_CS=1;                            	//ȡƬѡ 
+	SPI2_Unlock();
 	W25QXX_Wait_Busy();					   		//ȴд
 } 
 //޼дSPI FLASH 
@@ -226,9 +298,11 @@ void W25QXX_Erase_Chip(void)
 {                                   
     W25QXX_Write_Enable();                 	 	//SET WEL 
     W25QXX_Wait_Busy();   
+  	SPI2_Lock();
   	W25QXX_CS=0;                            	//ʹ   
     SPI2_ReadWriteByte(W25X_ChipErase);        	//Ƭ  
 	W25QXX_CS=1;                            	//ȡƬѡ     	      
+	SPI2_Unlock();
 	W25QXX_Wait_Busy();   				   		//ȴоƬ
 }   
 //һ
@@ -241,14 +315,37 @@ void W25QXX_Erase_Sector(u32 Dst_Addr)
  	Dst_Addr*=4096;
     W25QXX_Write_Enable();                  	//SET WEL 	 
     W25QXX_Wait_Busy();   
+  	SPI2_Lock();
   	W25QXX_CS=0;                            	//ʹ   
     SPI2_ReadWriteByte(W25X_SectorErase);      	//ָ 
     SPI2_ReadWriteByte((u8)((Dst_Addr)>>16));  	//24bitַ    
     SPI2_ReadWriteByte((u8)((Dst_Addr)>>8));   
     SPI2_ReadWriteByte((u8)Dst_Addr);  
 	W25QXX_CS=1;                            	//ȡƬѡ     	      
+	SPI2_Unlock();
     W25QXX_Wait_Busy();   				   		//ȴ
 }  
+//һ ֻȴ (W25QXX_Busy Ƿ)
+//Dst_Addr:ַ
+void W25QXX_Erase_Sector_Start(u32 Dst_Addr)
+{
+ 	Dst_Addr*=4096;
+    W25QXX_Wait_Busy();
+    W25QXX_Write_Enable();                  	//SET WEL
+  	SPI2_Lock();
+  	W25QXX_CS=0;                            	//ʹ
+    SPI2_ReadWriteByte(W25X_SectorErase);      	//ָ
+    SPI2_ReadWriteByte((u8)((Dst_Addr)>>16));  	//24bitַ
+    SPI2_ReadWriteByte((u8)((Dst_Addr)>>8));
+    SPI2_ReadWriteByte((u8)Dst_Addr);
+	W25QXX_CS=1;                            	//ȡƬѡ
+	SPI2_Unlock();
+}
+//1:ڲ/
+u8 W25QXX_Busy(void)
+{
+	return W25QXX_ReadSR()&0x01;
+}
 //ȴ
 void W25QXX_Wait_Busy(void)   
 {   
@@ -257,17 +354,21 @@ void W25QXX_Wait_Busy(void)
 //ģʽ
 void W25QXX_PowerDown(void)   
 { 
+  	SPI2_Lock();
   	W25QXX_CS=0;                           	 	//ʹ   
     SPI2_ReadWriteByte(W25X_PowerDown);        //͵  
 	W25QXX_CS=1;                            	//ȡƬѡ     	      
+	SPI2_Unlock();
     delay_us(3);                               //ȴTPD  
 }   
 //
 void W25QXX_WAKEUP(void)   
 {  
+  	SPI2_Lock();
   	W25QXX_CS=0;                            	//ʹ   
     SPI2_ReadWriteByte(W25X_ReleasePowerDown);	//  send W25X_PowerDown command 0xAB    
 	W25QXX_CS=1;                            	//ȡƬѡ     	      
+	SPI2_Unlock();
     delay_us(3);                            	//ȴTRES1
 }   
 
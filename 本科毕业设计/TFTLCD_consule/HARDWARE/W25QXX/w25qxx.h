@@ -61,9 +61,23 @@ void W25QXX_Read(u8* pBuffer,u32 ReadAddr,u16 NumByteToRead);   //
 void W25QXX_Write(u8* pBuffer,u32 WriteAddr,u16 NumByteToWrite);//дflash
 void W25QXX_Erase_Chip(void);    	  	//Ƭ
 void W25QXX_Erase_Sector(u32 Dst_Addr);	//
+void W25QXX_Erase_Sector_Start(u32 Dst_Addr);	// ȴ
+u8   W25QXX_Busy(void);					//1:æ
 void W25QXX_Wait_Busy(void);           	//ȴ
 void W25QXX_PowerDown(void);        	//ģʽ
 void W25QXX_WAKEUP(void);				//
+
+/*  (SPI2 DMADMA1ͨ4 գͨ5  0xFF ʱ)
+	W25QXX_Stream_Begin(addr);				//Ƭѡ +  + ַSPI ʱе 18M
+	W25QXX_Stream_Read_DMA(buf,len);		//̨ len ֽڣ
+	while(W25QXX_Stream_Busy());			//ȴڼ CPU Դһ
+	W25QXX_Stream_Read_DMA(buf2,len);		//ַԶ
+	W25QXX_Stream_End();					//ȡƬѡָ SPI 
+	SPI2  NRF24L01 ã߶Թ ģʽ0ֻٶȣʱָ CR1 */
+void W25QXX_Stream_Begin(u32 ReadAddr);
+void W25QXX_Stream_Read_DMA(u8* pBuffer,u16 NumByteToRead);
+u8   W25QXX_Stream_Busy(void);			//1:DMA ڶ
+void W25QXX_Stream_End(void);
 #endif
 
 
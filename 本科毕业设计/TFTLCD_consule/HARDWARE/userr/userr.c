@@ -1,12 +1,16 @@
 #include "userr.h"
 
-u8 tx_buf[32]={0};  
+u8 tx_buf[32]={0};  //հ
+s16 Sensor_Val[TELEM_CH_MAX]={0};	//һ (ֵλ telem.h)
+u16 Sensor_Map=0;					//յͨ0:ûյ
+u8  Sensor_Seq=0;
+u32 Sensor_Lost=0;					//Ķ
+u32 Sensor_Bad=0;					//CRC/ʽԵİ
+#define KLOG_SENSOR_MS	1000		// ־С ms
 //              0123/4567/8901/2345/6789/0123
 u8 flag_func=0;
 u8 NRF_Check=0;
 u8 nrf_gg=1;
-u8 TX_RX=0;
-u8 nrf_d=0;
 u8 bnb[2]={0};
 
 #if  ooioio
@@ -222,115 +226,106 @@ void do_touch_function(void)
 void NRF_01(u8 num_nrf) //  1:RXģʽ      ;    0:TXģʽ  
 {
 	u8 i=0;
-	NRF24L01_Init();    		//ʼNRF24L01 
 	while(NRF24L01_Check())
 	{		
 		i++;
 		if(i>=250)break;
 	}	
-	if(num_nrf)NRF24L01_RX_Mode();//RXģʽ  
-	else NRF24L01_TX_Mode();//TXģʽ  
+	NRF_Link_Init(num_nrf);//дĴ 
 }
 
 #else
 void do_touch_function(void)
 {}
 #endif
-void cmp_sensor(u16 x,u16 y,u8 *p,u16 set_numL,u16 set_numH)
+//band:0,  L   H  ;1,ʪ  L~H  ȥ 15 ڻ 
+void cmp_sensor(u16 x,u16 y,s16 num,u8 band,u16 set_numL,u16 set_numH)
 {
-	u16 cmp_num=0;
-	if(p[2]!='.')
+	if(band==0)
 	{
-		cmp_num=(p[0]-'0')*1000+(p[1]-'0')*100+(p[2]-'0')*10+(p[3]-'0');
-		if(cmp_num<set_numL)
+		if(num<(s16)set_numL)
 		{
-			Picture_Draw(x,y,(u8 *) gImage_green );//ָ귶ΧʾһͼƬ		
+			if(Asset_Draw_Name(x,y,"green"))Picture_Draw(x,y,(u8 *) gImage_green );//ָ귶ΧʾһͼƬ		
 		}	
-		else if(cmp_num<set_numH)
+		else if(num<(s16)set_numH)
 			{
-				Picture_Draw(x,y,(u8 *) gImage_yellow );//ָ귶ΧʾһͼƬ		
+				if(Asset_Draw_Name(x,y,"yellow"))Picture_Draw(x,y,(u8 *) gImage_yellow );//ָ귶ΧʾһͼƬ		
 			}
 			else
 			{
-				Picture_Draw(x,y,(u8 *) gImage_red );//ָ귶ΧʾһͼƬ		
+				if(Asset_Draw_Name(x,y,"red"))Picture_Draw(x,y,(u8 *) gImage_red );//ָ귶ΧʾһͼƬ		
 			}
 	}
 	else
 	{
-		cmp_num=(p[0]-'0')*10+(p[1]-'0');		
-		if(cmp_num<set_numL-15 || cmp_num>set_numH+15)
+		if(num<(s16)set_numL-15 || num>(s16)set_numH+15)
 		{
-			Picture_Draw(x,y,(u8 *) gImage_red );//ָ귶ΧʾһͼƬ		
+			if(Asset_Draw_Name(x,y,"red"))Picture_Draw(x,y,(u8 *) gImage_red );//ָ귶ΧʾһͼƬ		
 		}	
-		else if(cmp_num<set_numL || cmp_num>set_numH)
+		else if(num<(s16)set_numL || num>(s16)set_numH)
 			{
-				Picture_Draw(x,y,(u8 *) gImage_yellow );//ָ귶ΧʾһͼƬ		
+				if(Asset_Draw_Name(x,y,"yellow"))Picture_Draw(x,y,(u8 *) gImage_yellow );//ָ귶ΧʾһͼƬ		
 			}
 			else
 			{
-				Picture_Draw(x,y,(u8 *) gImage_green );//ָ귶ΧʾһͼƬ		
+				if(Asset_Draw_Name(x,y,"green"))Picture_Draw(x,y,(u8 *) gImage_green );//ָ귶ΧʾһͼƬ		
 			}
 	}
 }
+//0.01 λĶֵ -> "dd.dd"
+static void fix_str(char *p,s16 num)
+{
+	if(num<0)num=0;
+	p[0]=num/1000%10+'0';
+	p[1]=num/100%10+'0';
+	p[2]='.';
+	p[3]=num/10%10+'0';
+	p[4]=num%10+'0';
+	p[5]=0;
+}
+//ֱյĶֵٲַ
 void display_sensor_data(void)
 {
-	u8 tt_buf[7][4]={0};
-	char tyu[5]="00.00";
-	u8 i=0;
+	char tyu[6];
 	BACK_COLOR=LBBLUE;  //ɫ 
 	POINT_COLOR=CYAN;// ɫ	
-	for(i=0;i<7;i++)num_char(tt_buf[i],tx_buf,i);
-	for(i=0;i<7;i++)
+	if(Sensor_Map&(1<<TELEM_CH_MQ135))	//MQ135   10-1000ppm 		
 	{
-		switch(i)
-		{
-			case 0:	//MQ135   10-1000ppm 		
-				POINT_COLOR=CYAN;// ɫ	
-				LCD_ShowString(20,80,24*2,18,24,tt_buf[i]);
-				cmp_sensor(120,163,tt_buf[i],150,500);
-				break;
-			case 1://MQ2 ȼ 100~20000ppm Һ(CH4C3H8) 顢顢				
-				POINT_COLOR=CYAN;// ɫ	
-				LCD_ShowString(20+130,80,24*2,18,24,tt_buf[i]);
-				cmp_sensor(120+130,163,tt_buf[i],1000,5000);
-				break;
-			case 2://MQ6   10~10000ppm Һ춡顢C3H8LPG 顢C4H10Һʯ
-				POINT_COLOR=CYAN;// ɫ	
-				LCD_ShowString(20+130*2,80,24*2,18,24,tt_buf[i]);
-				cmp_sensor(120+130*2,163,tt_buf[i],150,400);
-				break;
-			case 3://MQ7 CO10~1000ppm  CO
-				POINT_COLOR=CYAN;// ɫ	
-				LCD_ShowString(20,80+130,24*2,18,24,tt_buf[i]);
-				cmp_sensor(120,162+130,tt_buf[i],140,400);
-				break;
-			case 4://ڲ¶ֵ 
-				tyu[0]=tt_buf[i][1];
-				tyu[1]=tt_buf[i][2];
-				tyu[3]=tt_buf[i][3];
-				POINT_COLOR=CYAN;// ɫ	
-				LCD_ShowString(70+130,51+40+130,24*2,24,24,tyu); //ʾһַ
-				cmp_sensor(120+130,162+130,tyu,15,40);
-				break;
-			case 5: /*¶Ȳ*/
-				tyu[0]=tt_buf[i][0];
-				tyu[1]=tt_buf[i][1];
-				tyu[3]=tt_buf[i][2];
-				tyu[4]=tt_buf[i][3];
-				POINT_COLOR=CYAN;// ɫ	
-				LCD_ShowString_user(60+130*2,51+40+130,24,tyu);//ʾһַ, 12/16/24 
-				cmp_sensor(120+130*2,163+40,tyu,15,40);
-				break;
-			case 6: /*ʪȲ*/
-				tyu[0]=tt_buf[i][0];
-				tyu[1]=tt_buf[i][1];
-				tyu[3]=tt_buf[i][2];
-				tyu[4]=tt_buf[i][3];
-				POINT_COLOR=CYAN;// ɫ	
-				LCD_ShowString_user(60+130*2,51+40+130+30,24,tyu);//ʾһַ, 12/16/24 
-				cmp_sensor(120+130*2,163+115,tyu,60,80);
-				break;
-		}		
+		LCD_ShowxNum(20,80,Sensor_Val[TELEM_CH_MQ135],4,24,0x80);
+		cmp_sensor(120,163,Sensor_Val[TELEM_CH_MQ135],0,150,500);
+	}
+	if(Sensor_Map&(1<<TELEM_CH_MQ2))	//MQ2 ȼ 100~20000ppm Һ(CH4C3H8) 顢顢				
+	{
+		LCD_ShowxNum(20+130,80,Sensor_Val[TELEM_CH_MQ2],4,24,0x80);
+		cmp_sensor(120+130,163,Sensor_Val[TELEM_CH_MQ2],0,1000,5000);
+	}
+	if(Sensor_Map&(1<<TELEM_CH_MQ6))	//MQ6   10~10000ppm Һ춡顢C3H8LPG 顢C4H10Һʯ
+	{
+		LCD_ShowxNum(20+130*2,80,Sensor_Val[TELEM_CH_MQ6],4,24,0x80);
+		cmp_sensor(120+130*2,163,Sensor_Val[TELEM_CH_MQ6],0,150,400);
+	}
+	if(Sensor_Map&(1<<TELEM_CH_MQ7))	//MQ7 CO10~1000ppm  CO
+	{
+		LCD_ShowxNum(20,80+130,Sensor_Val[TELEM_CH_MQ7],4,24,0x80);
+		cmp_sensor(120,162+130,Sensor_Val[TELEM_CH_MQ7],0,140,400);
+	}
+	if(Sensor_Map&(1<<TELEM_CH_CHIP_T))	//ڲ¶ֵ 0.1
+	{
+		fix_str(tyu,Sensor_Val[TELEM_CH_CHIP_T]*10);
+		LCD_ShowString(70+130,51+40+130,24*2,24,24,(u8*)tyu); //ʾһַ
+		cmp_sensor(120+130,162+130,Sensor_Val[TELEM_CH_CHIP_T]/10,1,15,40);
+	}
+	if(Sensor_Map&(1<<TELEM_CH_SHT_T))	/*¶Ȳ*/
+	{
+		fix_str(tyu,Sensor_Val[TELEM_CH_SHT_T]);
+		LCD_ShowString_user(60+130*2,51+40+130,24,tyu);//ʾһַ, 12/16/24 
+		cmp_sensor(120+130*2,163+40,Sensor_Val[TELEM_CH_SHT_T]/100,1,15,40);
+	}
+	if(Sensor_Map&(1<<TELEM_CH_SHT_RH))	/*ʪȲ*/
+	{
+		fix_str(tyu,Sensor_Val[TELEM_CH_SHT_RH]);
+		LCD_ShowString_user(60+130*2,51+40+130+30,24,tyu);//ʾһַ, 12/16/24 
+		cmp_sensor(120+130*2,163+115,Sensor_Val[TELEM_CH_SHT_RH]/100,1,60,80);
 	}
 }
 //////////////////////////////////////////////
@@ -368,25 +363,40 @@ void display_led_data(void)
 void display_col_data(void)
 {}
 /************** RXģʽ *****************/
+//жѾսУȡ һ
 void RX_(void)
 {
-	if( NRF24L01_RxPacket(tx_buf)==0)
+	static Telem_Frame frame;
+	static u16 log_ms=0;
+	u8 len,rec;
+	while( NRF_Link_Recv(tx_buf,&len)==0 )
 	{
+		if( Telem_Decode(tx_buf,len,&frame)!=0 )
+		{
+			Sensor_Bad++;
+			continue;
+		}
+		//ڵʱ ٣ÿ KLOG_SENSOR_MS һͨ ϼ (ÿд W25Q ̫)
+		rec= Sensor_Map!=frame.map || (u16)(frame.time[frame.n-1]-log_ms)>=KLOG_SENSOR_MS;
+		if( Sensor_Map!=0 )Sensor_Lost+=(u8)(frame.seq-Sensor_Seq-1);	//˼
+		Sensor_Seq=frame.seq;
+		Sensor_Map=frame.map;
+		memcpy(Sensor_Val,frame.val[frame.n-1],sizeof(Sensor_Val));
+		if( rec )
+		{
+			log_ms=frame.time[frame.n-1];
+			Klog_Append(KLOG_TAG_SENSOR,tx_buf,len);	//ԭǵ W25Q ־
+		}
 	}
-	else {}	
 }
 /************** TXģʽ *****************/
+//LED Ž ACKһʱȥзģʽ
 void TX_(void)
 {
-	if(LED1==0) tx_buf[0]='+';
-	else tx_buf[0]='-';
-	if( NRF24L01_TxPacket(tx_buf)==TX_OK )
-	{
-		nrf_d=1;
-	}
-	else 
-	{
-	}	
+	u8 cmd;
+	if(LED1==0) cmd='+';
+	else cmd='-';
+	NRF_Link_Send(&cmd,1);
 }
 
 void NRF_check(void)
@@ -10,6 +10,11 @@
 #include "adc.h"
 #include "lcd.h"
 #include "picture.h"
+#include "w25qxx.h"
+#include "asset.h"
+#include "kvs.h"
+#include "telem.h"
+#include "string.h"
 #include "font.h" 
 #include "touch.h"
 #include "24l01.h" 	 
@@ -28,7 +33,7 @@ void TX_(void);
 void num_char(u8 *buf_1,u8 *buf_2,u8 i);
 void NRF_check(void);
 void NRF_01(u8 num_nrf); //  1:RX模式      ;    0:TX模式  
-void cmp_sensor(u16 x,u16 y,u8 *p,u16 set_numL,u16 set_numH);
+void cmp_sensor(u16 x,u16 y,s16 num,u8 band,u16 set_numL,u16 set_numH);
 	
 /************** RXģʽ *****************/
 void RX_(void);
@@ -37,13 +42,15 @@ void TX_(void);
 
 
 extern u8 tx_buf[32];  
+extern s16 Sensor_Val[TELEM_CH_MAX];
+extern u16 Sensor_Map;
+extern u32 Sensor_Lost;
+extern u32 Sensor_Bad;
 
 extern u8 flag_func;
 extern u8 NRF_Check;
-extern u8 TX_RX;
 extern u8 ledf;
 extern u8 nrf_gg;
-extern u8 nrf_d;
 extern u8 bnb[2];
 
 
@@ -0,0 +1,254 @@
+/* Դ  (УƬ)
+	 Image2Lcd ɵ .c ͼƬ (ֿ ļ) һ .bin
+	յ W25Q128  ASSET_PACK_ADDR ʽ HARDWARE/ASSET/asset.h
+
+	룺gcc -O2 -o asset_pack asset_pack.c
+	÷asset_pack out.bin out.h ͼƬ1.c ͼƬ2.c ... [-r =ļ.bin] [-m =x:ļ.bin]
+		.c ÿ unsigned char gImage_xxx[] = {...}; һԴȡ xxx ( 11 ַ)
+		ͷ 8 ֽڵ 2  16   RGB565 ͼƬתСˣĵԭʼ
+		-r  ԭʼ (ֿ)
+		-m  ɫλͼ ( λǰ ÿв뵽ֽ)
+	out.h ÿԴ #define ASSET_ID_xxx nֱ Asset_Draw(x,y,ASSET_ID_xxx)
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdint.h>
+
+#define ASSET_MAGIC			0X31545341
+#define ASSET_VERSION		1
+#define ASSET_MAX			32
+#define ASSET_NAME_LEN		12
+#define ASSET_FMT_RGB565	1
+#define ASSET_FMT_MONO		2
+#define ASSET_FMT_RAW		3
+#define HEAD_SIZE			16
+#define INFO_SIZE			32
+
+typedef struct{
+				char name[ASSET_NAME_LEN];
+				uint8_t *data;
+				uint32_t size;
+				uint16_t width;
+				uint16_t height;
+				uint8_t format;
+				}Item;
+
+static Item Items[ASSET_MAX];
+static int Item_Num=0;
+
+// Asset_CRC32 ͬ (zlib crc32)
+static const uint32_t Crc_Tab[16]={
+	0x00000000,0x1DB71064,0x3B6E20C8,0x26D930AC,0x76DC4190,0x6B6B51F4,0x4DB26158,0x5005713C,
+	0xEDB88320,0xF00F9344,0xD6D6A3E8,0xCB61B38C,0x9B64C2B0,0x86D3D2D4,0xA00AE278,0xBDBDF21C};
+static uint32_t CRC32(uint32_t crc,const uint8_t *buf,uint32_t len)
+{
+	crc=~crc;
+	while(len--)
+	{
+		crc^=*buf++;
+		crc=(crc>>4)^Crc_Tab[crc&0x0F];
+		crc=(crc>>4)^Crc_Tab[crc&0x0F];
+	}
+	return ~crc;
+}
+
+static void Put16(uint8_t *p,uint16_t v){p[0]=v;p[1]=v>>8;}
+static void Put32(uint8_t *p,uint32_t v){p[0]=v;p[1]=v>>8;p[2]=v>>16;p[3]=v>>24;}
+
+static char *Load_File(const char *path,long *len)
+{
+	FILE *f=fopen(path,"rb");
+	char *buf;
+	if(f==NULL){fprintf(stderr,"򲻿 %s\n",path);exit(1);}
+	fseek(f,0,SEEK_END);
+	*len=ftell(f);
+	fseek(f,0,SEEK_SET);
+	buf=malloc(*len+1);
+	if(fread(buf,1,*len,f)!=(size_t)*len){fprintf(stderr," %s \n",path);exit(1);}
+	buf[*len]=0;
+	fclose(f);
+	return buf;
+}
+
+static Item *New_Item(const char *name)
+{
+	Item *it;
+	int i;
+	if(Item_Num>=ASSET_MAX){fprintf(stderr,"Դ̫ ( %d )\n",ASSET_MAX);exit(1);}
+	for(i=0;i<Item_Num;i++)
+	{
+		if(strncmp(Items[i].name,name,ASSET_NAME_LEN-1)==0){fprintf(stderr,"ظ %s\n",name);exit(1);}
+	}
+	it=&Items[Item_Num++];
+	memset(it,0,sizeof(Item));
+	strncpy(it->name,name,ASSET_NAME_LEN-1);
+	return it;
+}
+
+//Image2Lcd  -> Դ
+static void Add_Array(const char *ident,const uint8_t *buf,uint32_t n)
+{
+	Item *it;
+	uint32_t i,w,h;
+	const char *name=ident;
+	if(strncmp(name,"gImage_",7)==0)name+=7;
+	it=New_Item(name);
+	w=(buf[2]<<8)|buf[3];
+	h=(buf[4]<<8)|buf[5];
+	if(n>8&&buf[1]==16&&n-8>=w*h*2)
+	{
+		//RGB565Image2Lcd ǸֽǰС u16
+		it->format=ASSET_FMT_RGB565;
+		it->width=w;
+		it->height=h;
+		it->size=w*h*2;
+		it->data=malloc(it->size);
+		for(i=0;i<w*h;i++)
+		{
+			it->data[i*2]=buf[8+i*2+1];
+			it->data[i*2+1]=buf[8+i*2];
+		}
+	}
+	else
+	{
+		it->format=ASSET_FMT_RAW;
+		it->size=n;
+		it->data=malloc(n);
+		memcpy(it->data,buf,n);
+	}
+	printf("%-12s %s %ux%u %u ֽ\n",it->name,it->format==ASSET_FMT_RGB565?"RGB565":"RAW   ",it->width,it->height,it->size);
+}
+
+// .c  unsigned char [...] = { 0X.., ... };
+static void Parse_C(const char *path)
+{
+	long len;
+	char *src=Load_File(path,&len),*p=src,*q;
+	char ident[64];
+	uint8_t *buf;
+	uint32_t n,cap;
+	int k;
+	while((p=strstr(p,"unsigned char"))!=NULL)
+	{
+		p+=13;
+		while(isspace((unsigned char)*p))p++;
+		for(k=0;(isalnum((unsigned char)*p)||*p=='_')&&k<63;k++)ident[k]=*p++;
+		ident[k]=0;
+		if(k==0||*p!='[')continue;
+		q=strchr(p,'{');
+		if(q==NULL)break;
+		p=q+1;
+		cap=4096;n=0;
+		buf=malloc(cap);
+		while(*p&&*p!='}')
+		{
+			if(isdigit((unsigned char)*p))
+			{
+				if(n==cap){cap*=2;buf=realloc(buf,cap);}
+				buf[n++]=(uint8_t)strtoul(p,&q,0);
+				p=q;
+			}
+			else if(p[0]=='/'&&p[1]=='/')		//ע
+			{
+				while(*p&&*p!='\n')p++;
+			}
+			else p++;
+		}
+		if(n)Add_Array(ident,buf,n);
+		free(buf);
+	}
+	free(src);
+}
+
+//=ļ (-r)  =x:ļ (-m)
+static void Add_Bin(const char *arg,int mono)
+{
+	char name[ASSET_NAME_LEN+1];
+	const char *eq=strchr(arg,'='),*path;
+	unsigned w=0,h=0;
+	long len;
+	Item *it;
+	if(eq==NULL||eq==arg){fprintf(stderr," %s\n",arg);exit(1);}
+	snprintf(name,sizeof(name),"%.*s",(int)(eq-arg),arg);
+	path=eq+1;
+	if(mono)
+	{
+		if(sscanf(path,"%ux%u:",&w,&h)!=2||strchr(path,':')==NULL){fprintf(stderr," %s\n",arg);exit(1);}
+		path=strchr(path,':')+1;
+	}
+	it=New_Item(name);
+	it->data=(uint8_t*)Load_File(path,&len);
+	it->size=len;
+	it->format=mono?ASSET_FMT_MONO:ASSET_FMT_RAW;
+	it->width=w;
+	it->height=h;
+	if(mono&&(uint32_t)len<(w+7)/8*h){fprintf(stderr,"%s ݲ %ux%u\n",path,w,h);exit(1);}
+	printf("%-12s %s %ux%u %u ֽ\n",it->name,mono?"MONO  ":"RAW   ",w,h,it->size);
+}
+
+int main(int argc,char *argv[])
+{
+	FILE *f;
+	uint8_t head[HEAD_SIZE],*index;
+	uint32_t off,total,pad=0;
+	int i;
+	if(argc<4)
+	{
+		fprintf(stderr,"÷: %s out.bin out.h ͼƬ.c ... [-r =ļ] [-m =x:ļ]\n",argv[0]);
+		return 1;
+	}
+	for(i=3;i<argc;i++)
+	{
+		if(strcmp(argv[i],"-r")==0&&i+1<argc)Add_Bin(argv[++i],0);
+		else if(strcmp(argv[i],"-m")==0&&i+1<argc)Add_Bin(argv[++i],1);
+		else Parse_C(argv[i]);
+	}
+	if(Item_Num==0){fprintf(stderr,"ûԴ\n");return 1;}
+
+	// ÿԴ 4 ֽڶ
+	index=calloc(Item_Num,INFO_SIZE);
+	off=HEAD_SIZE+Item_Num*INFO_SIZE;
+	for(i=0;i<Item_Num;i++)
+	{
+		uint8_t *e=index+i*INFO_SIZE;
+		off=(off+3)&~3u;
+		memcpy(e,Items[i].name,ASSET_NAME_LEN);
+		Put32(e+12,off);
+		Put32(e+16,Items[i].size);
+		Put16(e+20,Items[i].width);
+		Put16(e+22,Items[i].height);
+		e[24]=Items[i].format;
+		Put32(e+28,CRC32(0,Items[i].data,Items[i].size));
+		off+=Items[i].size;
+	}
+	total=off;
+	Put32(head,ASSET_MAGIC);
+	Put16(head+4,ASSET_VERSION);
+	Put16(head+6,Item_Num);
+	Put32(head+8,total);
+	Put32(head+12,CRC32(0,index,Item_Num*INFO_SIZE));
+
+	f=fopen(argv[1],"wb");
+	if(f==NULL){fprintf(stderr,"򲻿 %s\n",argv[1]);return 1;}
+	fwrite(head,1,HEAD_SIZE,f);
+	fwrite(index,1,Item_Num*INFO_SIZE,f);
+	off=HEAD_SIZE+Item_Num*INFO_SIZE;
+	for(i=0;i<Item_Num;i++)
+	{
+		while(off&3){fwrite(&pad,1,1,f);off++;}
+		fwrite(Items[i].data,1,Items[i].size,f);
+		off+=Items[i].size;
+	}
+	fclose(f);
+
+	f=fopen(argv[2],"w");
+	if(f==NULL){fprintf(stderr,"򲻿 %s\n",argv[2]);return 1;}
+	fprintf(f,"//asset_pack ɣҪָ\n#ifndef __ASSET_ID_H\n#define __ASSET_ID_H\n\n");
+	for(i=0;i<Item_Num;i++)fprintf(f,"#define ASSET_ID_%-12s %d\n",Items[i].name,i);
+	fprintf(f,"\n#define ASSET_PACK_SIZE %u\n\n#endif\n",total);
+	fclose(f);
+	printf("%d Դ %u ֽ\n",Item_Num,total);
+	return 0;
+}
@@ -0,0 +1,208 @@
+/* Դ /ȡ  (УƬ)
+	ɼ Image2Lcd ʽ .c ͼƬ (ͼ ߷ֿСͼ ߻)һԭʼ  һɫλͼ
+	 asset_pack Žڴ "W25Q128" (ASSET_PACK_ADDR )
+	õƬ HARDWARE/ASSET/asset.c  ڴ֡壬ԭͼȽϣ
+		Asset_Init / Asset_Find / Asset_Draw (ͼ Сͼ л) / Asset_Draw_Mono
+		Asset_Read / Asset_VerifyԼ ͷħġݱ 
+
+	룺gcc -O2 -I ../../../../COMMON/TOOLS -I stub -I ../../HARDWARE/ASSET -o asset_test asset_test.c
+	÷asset_test        ڵǰĿ¼дʱļ (ɾ)ȫͨ 0򷵻 1
+*/
+#define main Asset_Pack_Main
+#include "../asset_pack/asset_pack.c"
+#undef main
+#include "asset.c"
+#include "test_common.h"
+
+#define FLASH_SIZE		(ASSET_PACK_ADDR+0x40000)
+#define FB_W			320
+#define FB_H			240
+
+static u8  Flash[FLASH_SIZE];
+static u32 Flash_Addr;				// ǰַ
+static int Flash_Stream=0;			//1: Stream_Begin ֮
+static u32 Flash_Stream_Reads=0;	//  (Сͼ ڶλ Ӧò flash)
+
+static u16 Fb[FB_H][FB_W];
+static u16 Win_X,Win_Y,Win_W,Win_H;
+static u32 Win_Pos;
+
+void W25QXX_Read(u8* pBuffer,u32 ReadAddr,u16 NumByteToRead)
+{
+	memcpy(pBuffer,&Flash[ReadAddr],NumByteToRead);
+}
+void W25QXX_Stream_Begin(u32 ReadAddr)
+{
+	Flash_Addr=ReadAddr;
+	Flash_Stream=1;
+}
+void W25QXX_Stream_Read_DMA(u8* pBuffer,u16 NumByteToRead)
+{
+	if(!Flash_Stream){printf("Stream_Read ֮ǰû Stream_Begin\n");Fail=1;return;}
+	memcpy(pBuffer,&Flash[Flash_Addr],NumByteToRead);
+	Flash_Addr+=NumByteToRead;
+	Flash_Stream_Reads++;
+}
+u8 W25QXX_Stream_Busy(void)
+{
+	return 0;
+}
+void W25QXX_Stream_End(void)
+{
+	Flash_Stream=0;
+}
+
+void LCD_Blit16(u16 sx,u16 sy,u16 width,u16 height,const u16 *buf)
+{
+	u16 x,y;
+	for(y=0;y<height;y++)for(x=0;x<width;x++)Fb[sy+y][sx+x]=*buf++;
+}
+void LCD_Blit_Mono(u16 sx,u16 sy,u16 width,u16 height,const u8 *bits,u16 fg,u16 bg)
+{
+	u16 x,y,row=(width+7)/8;
+	for(y=0;y<height;y++)for(x=0;x<width;x++)
+		Fb[sy+y][sx+x]=(bits[y*row+x/8]&(0x80>>(x&7)))?fg:bg;
+}
+void LCD_Stream_Begin(u16 sx,u16 sy,u16 width,u16 height)
+{
+	Win_X=sx;Win_Y=sy;Win_W=width;Win_H=height;Win_Pos=0;
+}
+void LCD_Stream_Write(const u16 *buf,u32 n)
+{
+	while(n--)
+	{
+		if(Win_Pos>=(u32)Win_W*Win_H){printf("д \n");Fail=1;return;}
+		Fb[Win_Y+Win_Pos/Win_W][Win_X+Win_Pos%Win_W]=*buf++;
+		Win_Pos++;
+	}
+}
+void LCD_Stream_End(void)
+{
+	if(Win_Pos!=(u32)Win_W*Win_H){printf("д %u 㣬 %u \n",Win_Pos,(u32)Win_W*Win_H);Fail=1;}
+}
+
+//ͼƬ (ÿ㶼ͬλ)
+static u16 Pixel(int img,int x,int y)
+{
+	return (u16)(img*0x3C1B+x*0x0107+y*0x2311);
+}
+
+//дһ Image2Lcd ʽ .c8 ֽͷ (ɨ/λ// ֽǰ) + ֽǰ
+static void Write_Image_C(FILE *f,const char *name,int img,int w,int h)
+{
+	int x,y,n=0;
+	fprintf(f,"const unsigned char %s[%d] = { 0X10,0X10,0X%02X,0X%02X,0X%02X,0X%02X,0X01,0X1B,\n",
+			name,8+w*h*2,w>>8,w&0xFF,h>>8,h&0xFF);
+	for(y=0;y<h;y++)for(x=0;x<w;x++)
+	{
+		u16 c=Pixel(img,x,y);
+		fprintf(f,"0X%02X,0X%02X,%s",c>>8,c&0xFF,(++n%8)?"":"\n");
+	}
+	fprintf(f,"};\n");
+}
+
+static int Check_Image(int img,u16 x0,u16 y0,int w,int h)
+{
+	int x,y;
+	for(y=0;y<h;y++)for(x=0;x<w;x++)
+	{
+		if(Fb[y0+y][x0+x]!=Pixel(img,x,y))
+		{
+			printf("ͼƬ %d (%d,%d)  %04X ӦΪ %04X\n",img,x,y,Fb[y0+y][x0+x],Pixel(img,x,y));
+			return 1;
+		}
+	}
+	return 0;
+}
+
+// out.bin Ž flash ֽ
+static long Load_Pack(const char *path)
+{
+	long len;
+	char *buf=Load_File(path,&len);
+	memset(Flash,0xFF,sizeof(Flash));
+	memcpy(&Flash[ASSET_PACK_ADDR],buf,len);
+	free(buf);
+	return len;
+}
+
+int main(void)
+{
+	char *argv[]={"asset_pack","asset_test_out.bin","asset_test_out.h","asset_test_img.c",
+				  "-r","font=asset_test_font.bin","-m","logo=13x7:asset_test_mono.bin"};
+	u8 font[1000],mono[14],buf[64];
+	s16 big,icon,fnt,logo;
+	u32 reads;
+	long len;
+	int i,x,y;
+	FILE *f;
+
+	//ļ
+	f=fopen("asset_test_img.c","w");
+	Write_Image_C(f,"gImage_big",1,40,30);		//2400 ֽ > ASSET_CACHE_SIZEֿ
+	Write_Image_C(f,"gImage_icon",2,20,20);		//800 ֽڣ
+	Write_Image_C(f,"gImage_odd",3,7,3);		//42 ֽڣú  4 ֽڶ
+	fclose(f);
+	for(i=0;i<(int)sizeof(font);i++)font[i]=(u8)(i*7+3);
+	f=fopen("asset_test_font.bin","wb");fwrite(font,1,sizeof(font),f);fclose(f);
+	for(i=0;i<(int)sizeof(mono);i++)mono[i]=(u8)(0xA5^(i*29));
+	f=fopen("asset_test_mono.bin","wb");fwrite(mono,1,sizeof(mono),f);fclose(f);
+
+	CHECK(Asset_Pack_Main(sizeof(argv)/sizeof(argv[0]),argv)==0,"asset_pack ʧ");
+	len=Load_Pack("asset_test_out.bin");
+
+	//ͷ
+	CHECK(Asset_Init()==0,"Asset_Init ʧ");
+	CHECK(Asset_Count==5,"Դ %u ӦΪ 5",Asset_Count);
+	big=Asset_Find("big");icon=Asset_Find("icon");fnt=Asset_Find("font");logo=Asset_Find("logo");
+	CHECK(big==0&&icon==1&&Asset_Find("odd")==2&&fnt==3&&logo==4,"Asset_Find Ų %d %d %d %d",big,icon,fnt,logo);
+	CHECK(Asset_Find("none")==-1,"Asset_Find ҵڵ");
+	for(i=0;i<Asset_Count;i++)
+	{
+		CHECK((Asset_Get(i)->offset&3)==0,"Դ %d ƫ %u û 4 ֽڶ",i,Asset_Get(i)->offset);
+		CHECK(Asset_Get(i)->offset+Asset_Get(i)->size<=(u32)len,"Դ %d ",i);
+		CHECK(Asset_Verify(i)==0,"Դ %d CRC ",i);
+	}
+	CHECK(Asset_Get(Asset_Count)==0,"Asset_Get Խ ûз 0");
+
+	//ͼ ֿ
+	CHECK(Asset_Draw(5,6,big)==0,"Asset_Draw ͼ ʧ");
+	Fail|=Check_Image(1,5,6,40,30);
+	//Сͼ꣺һζ flashڶ л
+	reads=Flash_Stream_Reads;
+	CHECK(Asset_Draw_Name(100,50,"icon")==0,"Asset_Draw_Name ʧ");
+	CHECK(Flash_Stream_Reads==reads+1,"Сͼ һ Ӧһ flash");
+	Fail|=Check_Image(2,100,50,20,20);
+	memset(Fb,0,sizeof(Fb));
+	CHECK(Asset_Draw(200,100,icon)==0,"Asset_Draw Сͼ ʧ");
+	CHECK(Flash_Stream_Reads==reads+1,"Сͼ ڶ Ӧٶ flash");
+	Fail|=Check_Image(2,200,100,20,20);
+	CHECK(Asset_Draw(0,0,fnt)==1,"ԭʼ ӦܵͼƬ");
+
+	//ɫλͼ
+	CHECK(Asset_Draw_Mono(10,200,logo,0xFFFF,0x0000)==0,"Asset_Draw_Mono ʧ");
+	for(y=0;y<7;y++)for(x=0;x<13;x++)
+	{
+		u16 c=(mono[y*2+x/8]&(0x80>>(x&7)))?0xFFFF:0x0000;
+		if(Fb[200+y][10+x]!=c){printf("ɫλͼ (%d,%d) \n",x,y);Fail=1;y=7;break;}
+	}
+
+	//ԭʼ ֶζ
+	CHECK(Asset_Read(fnt,990,buf,10)==0&&memcmp(buf,font+990,10)==0,"Asset_Read ĩβһ ");
+	CHECK(Asset_Read(fnt,995,buf,10)==1,"Asset_Read Խ ûб");
+
+	//ݱģֻԴ CRC 
+	Flash[ASSET_PACK_ADDR+Asset_Get(fnt)->offset+123]^=0x01;
+	CHECK(Asset_Verify(fnt)==1&&Asset_Verify(big)==0,"ݱ Asset_Verify ");
+	//
+	Load_Pack("asset_test_out.bin");
+	Flash[ASSET_PACK_ADDR+HEAD_SIZE+5]^=0x20;
+	CHECK(Asset_Init()==2&&Asset_Count==0," Asset_Init Ӧ 2");
+	//ûԴ (flash ǿյ)
+	memset(Flash,0xFF,sizeof(Flash));
+	CHECK(Asset_Init()==1&&Asset_Count==0," flash Asset_Init Ӧ 1");
+
+	remove("asset_test_img.c");remove("asset_test_font.bin");remove("asset_test_mono.bin");
+	remove("asset_test_out.bin");remove("asset_test_out.h");
+	return Test_Done();
+}
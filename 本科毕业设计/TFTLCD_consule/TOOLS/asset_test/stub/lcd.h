@@ -0,0 +1,10 @@
+/* ϱãLCD ڴ֡ (asset_test.c ʵ) */
+#ifndef __LCD_H
+#define __LCD_H
+#include "sys.h"
+void LCD_Blit16(u16 sx,u16 sy,u16 width,u16 height,const u16 *buf);
+void LCD_Blit_Mono(u16 sx,u16 sy,u16 width,u16 height,const u8 *bits,u16 fg,u16 bg);
+void LCD_Stream_Begin(u16 sx,u16 sy,u16 width,u16 height);
+void LCD_Stream_Write(const u16 *buf,u32 n);
+void LCD_Stream_End(void);
+#endif
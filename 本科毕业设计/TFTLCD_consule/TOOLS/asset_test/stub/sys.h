@@ -0,0 +1,11 @@
+/* ϱãֻ asset.c õ */
+#ifndef __SYS_H
+#define __SYS_H
+#include <stdint.h>
+typedef int32_t  s32;
+typedef int16_t  s16;
+typedef int8_t   s8;
+typedef uint32_t u32;
+typedef uint16_t u16;
+typedef uint8_t  u8;
+#endif
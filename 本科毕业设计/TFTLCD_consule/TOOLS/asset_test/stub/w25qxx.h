@@ -0,0 +1,10 @@
+/* ϱãW25Q128 ڴ (asset_test.c ʵ) */
+#ifndef __W25QXX_H
+#define __W25QXX_H
+#include "sys.h"
+void W25QXX_Read(u8* pBuffer,u32 ReadAddr,u16 NumByteToRead);
+void W25QXX_Stream_Begin(u32 ReadAddr);
+void W25QXX_Stream_Read_DMA(u8* pBuffer,u16 NumByteToRead);
+u8   W25QXX_Stream_Busy(void);
+void W25QXX_Stream_End(void);
+#endif
@@ -0,0 +1,249 @@
+/* ֵ洢/־  (УƬ)
+	ڴģ W25Q128 (ֻܰ 1 д 0Ҫæ־)
+	ܵƬ HARDWARE/KVS/kvs.c д/ɾ ׷־Kvs_Poll ̨գ
+	ĳһ ҳ   ; ""
+		̵ һҳֻдȥһλ ֻһֱ 0xFF
+	Ȼ Kvs_Init RAM ģͱȽϣ
+		ÿ һγɹдֵдǸ Ǿֵֵ
+		־ 밴˳ãһһγɹ׷ӵ (׷ӵ)
+	  ׷Ӽ¼/հ¼/ ͳƣ඼Ҫ
+
+	룺gcc -O2 -I ../../../../COMMON/TOOLS -I stub -I ../../HARDWARE/KVS -o kvs_test kvs_test.c
+	÷kvs_test [ [ÿӵ]]   Ĭ 20 200ȫͨ 0򷵻 1 ӡ һ
+*/
+#include "test_common.h"
+#include <setjmp.h>
+#include "kvs.c"
+
+#define FLASH_SIZE		0X100000
+#define SECTOR			4096
+#define TEST_KEYS		KVS_KEY_MAX
+#define TEST_LOG_TAG	1
+
+u16 W25QXX_TYPE=0XEF17;
+
+static u8  Flash[FLASH_SIZE];
+static u32 Ops=0;				//(ÿҳһ)/ 
+static u32 Cut_At=0;			//ڼβ 磬0:
+static u8  Busy=0;				// Ҫæβѯ
+static jmp_buf Power;
+static u32 Cut_Num[3];			//㣺0:׷ 1:հ¼ 2:
+static u32 Programs=0,Erases=0;
+
+static char Fail_Msg[128];
+
+static void Flash_Check(u32 addr,u32 n)
+{
+	if(addr<KVS_ADDR||addr+n>FLASH_SIZE)
+	{
+		printf("Խ %06X %u\n",addr,n);
+		exit(1);
+	}
+}
+
+void W25QXX_Read(u8* pBuffer,u32 ReadAddr,u16 NumByteToRead)
+{
+	Flash_Check(ReadAddr,NumByteToRead);
+	if(Busy){printf("оƬæʱ %06X\n",ReadAddr);exit(1);}
+	memcpy(pBuffer,&Flash[ReadAddr],NumByteToRead);
+}
+
+//ҳֻ̣ 1->0ʱڲ  дûλ 
+void W25QXX_Write_NoCheck(u8* pBuffer,u32 WriteAddr,u16 NumByteToWrite)
+{
+	u16 i=0,j,n;
+	Flash_Check(WriteAddr,NumByteToWrite);
+	if(Busy){printf("оƬæʱ %06X\n",WriteAddr);exit(1);}
+	while(i<NumByteToWrite)
+	{
+		n=256-(WriteAddr+i)%256;
+		if(n>NumByteToWrite-i)n=NumByteToWrite-i;
+		Ops++;Programs++;
+		if(Ops==Cut_At)
+		{
+			for(j=0;j<n;j++)Flash[WriteAddr+i+j]&=pBuffer[i+j]|(u8)Rand();
+			Cut_Num[Kvs_In_GC]++;
+			longjmp(Power,1);
+		}
+		for(j=0;j<n;j++)
+		{
+			if((Flash[WriteAddr+i+j]&pBuffer[i+j])!=pBuffer[i+j])
+			{
+				printf("дûֽ %06X\n",WriteAddr+i+j);
+				exit(1);
+			}
+			Flash[WriteAddr+i+j]&=pBuffer[i+j];
+		}
+		i+=n;
+	}
+}
+
+void W25QXX_Erase_Sector_Start(u32 Dst_Addr)
+{
+	u32 addr=Dst_Addr*SECTOR,j;
+	Flash_Check(addr,SECTOR);
+	if(Busy){printf("оƬæʱ %06X\n",addr);exit(1);}
+	Ops++;Erases++;
+	if(Ops==Cut_At)
+	{
+		for(j=0;j<SECTOR;j++)if(Rand()%3==0)Flash[addr+j]=0XFF;
+		Cut_Num[2]++;
+		longjmp(Power,1);
+	}
+	memset(&Flash[addr],0XFF,SECTOR);
+	Busy=Rand()%4;
+}
+
+u8 W25QXX_Busy(void)
+{
+	if(Busy){Busy--;return 1;}
+	return 0;
+}
+
+void W25QXX_Wait_Busy(void)
+{
+	Busy=0;
+}
+
+//ģͣÿֵ ( 0:û)־ һ
+static u8  Model_Val[TEST_KEYS][KVS_VAL_MAX];
+static u16 Model_Len[TEST_KEYS];
+static u32 Log_Last,Log_Next;
+
+//д (ʱдȥ Ҳû)
+static int Pend_Key;
+static u8  Pend_Val[KVS_VAL_MAX];
+static u16 Pend_Len;
+static u8  Pend_Log;
+
+static void Fail_Set(const char *msg,u32 a,u32 b)
+{
+	if(!Fail)snprintf(Fail_Msg,sizeof(Fail_Msg),"%s %u %u",msg,a,b);
+	Fail=1;
+}
+
+//ϵ ģͱȽ
+static void Verify(void)
+{
+	u8 buf[KVS_VAL_MAX],d[KVS_VAL_MAX];
+	u16 len,tag,i;
+	u32 v,prev=0,last=0;
+	int k,old,now;
+	Klog_Iter it;
+
+	for(k=0;k<TEST_KEYS;k++)
+	{
+		len=Kvs_Get(k,buf,sizeof(buf));
+		old=len==Model_Len[k]&&memcmp(buf,Model_Val[k],len)==0;
+		now=k==Pend_Key&&len==Pend_Len&&memcmp(buf,Pend_Val,len)==0;
+		if(!old&&!now){Fail_Set("ֵ /",k,len);return;}
+		if(now){Model_Len[k]=Pend_Len;memcpy(Model_Val[k],Pend_Val,Pend_Len);}
+	}
+	Klog_Rewind(&it);
+	for(;;)
+	{
+		len=sizeof(d);
+		if(Klog_Next(&it,&tag,d,&len))break;
+		memcpy(&v,d,4);
+		if(tag!=TEST_LOG_TAG||len<4||v<=prev){Fail_Set("־˳򲻶",v,prev);return;}
+		for(i=4;i<len;i++)if(d[i]!=(u8)(v+i)){Fail_Set("־ݲ",v,i);return;}
+		prev=last=v;
+	}
+	if(Pend_Log&&last==Log_Next)Log_Last=last;
+	else if(last!=Log_Last){Fail_Set("һ־",last,Log_Last);return;}
+}
+
+//ѡ󲿷дǰ 8 ĺдʱ Ч¼Ҫ
+static int Rand_Key(void)
+{
+	return Rand()%16?Rand()%8:Rand()%TEST_KEYS;
+}
+
+//ֱ
+static void Run(void)
+{
+	u32 v,op;
+	u16 i,n;
+	u8 d[KVS_VAL_MAX];
+	for(;;)
+	{
+		Pend_Key=-1;
+		Pend_Log=0;
+		op=Rand()%10;
+		if(op<5)
+		{
+			Pend_Key=Rand_Key();
+			Pend_Len=1+Rand()%KVS_VAL_MAX;
+			for(i=0;i<Pend_Len;i++)Pend_Val[i]=Rand()%4;		//ֵ䣬Ҳ "û䲻д"
+			if(Kvs_Set(Pend_Key,Pend_Val,Pend_Len)){Fail_Set("Kvs_Set ʧ",Pend_Key,Pend_Len);return;}
+			Model_Len[Pend_Key]=Pend_Len;
+			memcpy(Model_Val[Pend_Key],Pend_Val,Pend_Len);
+		}
+		else if(op==5)
+		{
+			Pend_Key=Rand_Key();
+			Pend_Len=0;
+			if(Kvs_Del(Pend_Key)){Fail_Set("Kvs_Del ʧ",Pend_Key,0);return;}
+			Model_Len[Pend_Key]=0;
+		}
+		else if(op<8)
+		{
+			v=Log_Next;
+			n=4+Rand()%(KVS_VAL_MAX-4);
+			memcpy(d,&v,4);
+			for(i=4;i<n;i++)d[i]=(u8)(v+i);
+			Pend_Log=1;
+			if(Klog_Append(TEST_LOG_TAG,d,n)){Fail_Set("Klog_Append ʧ",v,n);return;}
+			Log_Last=v;
+			Log_Next++;
+		}
+		else Kvs_Poll();
+	}
+}
+
+static int Test_Seed(u32 seed,u32 cuts)
+{
+	u32 c,j;
+	Rand_Seed=seed;
+	memset(Flash,0XFF,sizeof(Flash));
+	for(j=0;j<3000;j++)Flash[KVS_ADDR+Rand()%(FLASH_SIZE-KVS_ADDR)]=Rand();	//ùоƬ 
+	memset(Model_Len,0,sizeof(Model_Len));
+	Log_Last=0;
+	Log_Next=1;
+	Busy=0;
+	Cut_At=0;
+	if(Kvs_Init()){printf(" %u Kvs_Init ʧ\n",seed);return 1;}
+	for(c=0;c<cuts;c++)
+	{
+		Cut_At=Ops+1+Rand()%400;
+		if(setjmp(Power)==0)Run();
+		else
+		{
+			Kvs_In_GC=0;
+			Busy=0;
+			Cut_At=0;
+			if(Kvs_Init()){Fail_Set("ϵ Kvs_Init ʧ",c,0);}
+			else Verify();
+			if(Pend_Log)Log_Next++;		//ûдȥ 
+		}
+		if(Fail)
+		{
+			printf(" %u  %u ε磺%s\n",seed,c,Fail_Msg);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+int main(int argc,char *argv[])
+{
+	u32 seeds=argc>1?strtoul(argv[1],0,0):20;
+	u32 cuts=argc>2?strtoul(argv[2],0,0):200;
+	u32 s,mn,mx;
+	for(s=1;s<=seeds;s++)if(Test_Seed(s,cuts)){Fail=1;return Test_Done();}
+	Kvs_Wear(1,&mn,&mx);
+	printf(" %u Σ׷ %u  %u  %u %u ҳ  %u Σ־ĥ %u~%u\n",
+			seeds*cuts,Cut_Num[0],Cut_Num[1],Cut_Num[2],Programs,Erases,mn,mx);
+	CHECK(Cut_Num[0]&&Cut_Num[1]&&Cut_Num[2],"һû");
+	return Test_Done();
+}
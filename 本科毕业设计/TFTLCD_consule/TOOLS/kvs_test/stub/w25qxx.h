@@ -0,0 +1,11 @@
+/* ϱãW25Q128 ڴ (kvs_test.c ʵ֣һα/; "") */
+#ifndef __W25QXX_H
+#define __W25QXX_H
+#include "sys.h"
+extern u16 W25QXX_TYPE;
+void W25QXX_Read(u8* pBuffer,u32 ReadAddr,u16 NumByteToRead);
+void W25QXX_Write_NoCheck(u8* pBuffer,u32 WriteAddr,u16 NumByteToWrite);
+void W25QXX_Erase_Sector_Start(u32 Dst_Addr);
+u8   W25QXX_Busy(void);
+void W25QXX_Wait_Busy(void);
+#endif
@@ -0,0 +1,447 @@
+/* NRF24L01 ж·  (УƬ)
+	ֱӱ HARDWARE/SPI/spi.c  HARDWARE/NRF24L01/24l01.cSPI2/DMA1/EXTI ڴļ裬
+	һ 24L01Ĵ3  TX/RX FIFOSTATUS ־IRQ  (־޵ ½)
+	+оƬ FEATURE/DYNPD Ҫ ACTIVATE дý Է /ͷ ط/ȥ (MAX_RT)
+	ѭ  NRF_Link_Send / NRF_Link_Recv / ռ SPI2  W25QXX  (жֻƳ) / NRF24L01_Check
+		Էյİ ˳ݶԣ©  tx_lost ǵģtx_ok Էյһࣻ
+		ѭյİ ˳ݶԣ©  rx_drop ǵģ
+		ж ֻ ѭûռ SPI2 ʱ ߣ SPI2->CR1 ԭ W25QXX ã NRF ˵  ģʽ0  9M
+		TX FIFO  д  R_RX_PL_WID һƳٵж SPI2_Unlock  һ ( ж)
+		NRF_Link_Init  Ĵ дˣNRF24L01_Check  TX_ADDR
+	SPI2_Lock  жϴ Ǹѭ ⣺ѭֻ SPI2_Isr_Busy Ϊ 0 ʱ
+	TFTLCD_sensor  24l01.c/spi.c ·㲿 һ-I ǱߵĿ¼ Ҳܱࡣ
+
+	룺gcc -O2 -no-pie -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast -I ../../../../COMMON/TOOLS -I stub -I ../../HARDWARE/SPI -I ../../HARDWARE/NRF24L01 -o nrf_test nrf_test.c
+		(DMA ַĴ 32 λҪ -no-pie ñַ  4G )
+	÷nrf_test []   Ĭ 200 (ͷ/շ һ)ȫͨ 0򷵻 1 ӡ 
+*/
+#include "test_common.h"
+#include <string.h>
+#include <stdint.h>
+#include "spi.c"
+#include "24l01.c"
+
+SPI_TypeDef Test_SPI2;
+DMA_TypeDef Test_DMA1;
+DMA_Channel_TypeDef Test_DMA1_Channel4,Test_DMA1_Channel5;
+EXTI_TypeDef Test_EXTI;
+
+#define STEPS			20000			//ÿ ߶ٲ
+#define W25_CR1			(SPI_Mode_Master|SPI_NSS_Soft|SPI_BaudRatePrescaler_2|SPI_CR1_SPE)	//W25QXX 18M
+
+//----------------------------------------------------------------
+// 24L01
+typedef struct{
+	u8 len;
+	u8 buf[32];
+}Pkt;
+
+static struct{
+	u8  reg[0x20];
+	u8  tx_addr[5],rx_addr[5];
+	Pkt txf[3];							//txf[0] ǰ
+	u8  txn;
+	Pkt rxf[3];
+	u8  rxn;
+	u8  plus;							//+棺FEATURE  ACTIVATE
+	u8  active;
+	u8  cmd,pos;						//pos:ֽ
+	Pkt w;
+	u8  irq;							//IRQ  1:
+}Chip;
+
+static volatile u8 Pin_G[16],Pin_B[16];
+static u8 In_Isr=0;
+static u32 Air_Retr=0;					// ʵط
+
+static void Chip_Irq(void)
+{
+	u8 irq=(Chip.reg[STATUS]&0x70&~Chip.reg[CONFIG])!=0;
+	if(irq&&!Chip.irq)Test_EXTI.PR|=EXTI_Line6;	//½
+	Chip.irq=irq;
+}
+
+static u8 Chip_Status(void)
+{
+	return (Chip.reg[STATUS]&0x70)|(Chip.rxn?0:0x0E)|(Chip.txn==3?TX_FULL:0);
+}
+
+static u8 Chip_Fifo(void)
+{
+	return (Chip.txn==3?0x20:0)|(Chip.txn?0:0x10)|(Chip.rxn==3?0x02:0)|(Chip.rxn?0:0x01);
+}
+
+//Ƭѡߣ
+static void Chip_End(void)
+{
+	u8 i;
+	if(Chip.pos==0)return;
+	if(Chip.cmd==RD_RX_PLOAD&&Chip.w.len)
+	{
+		CHECK(Chip.w.len==Chip.rxf[0].len," %u ֽ  %u",Chip.w.len,Chip.rxf[0].len);
+		for(i=1;i<Chip.rxn;i++)Chip.rxf[i-1]=Chip.rxf[i];
+		Chip.rxn--;
+	}
+	if((Chip.cmd==WR_TX_PLOAD||Chip.cmd==W_ACK_PAYLOAD)&&Chip.w.len)
+	{
+		CHECK(Chip.txn<3,"TX FIFO ˻д");
+		CHECK((Chip.cmd==W_ACK_PAYLOAD)==(Chip.reg[CONFIG]&1)," %02X շģʽ",Chip.cmd);
+		if(Chip.txn<3)Chip.txf[Chip.txn++]=Chip.w;
+	}
+	Chip.pos=0;
+	Chip_Irq();
+}
+
+static u8 Chip_Byte(u8 in)
+{
+	u8 out=0,r,k;
+	if(Pin_G[7])return 0xFF;			//ûѡ (W25QXX )
+	CHECK(Pin_B[12],"NRF  W25QXX Ƭѡͬʱ");
+	CHECK((Test_SPI2.CR1&3)==0&&(Test_SPI2.CR1&0x38)>=SPI_BaudRatePrescaler_4&&(Test_SPI2.CR1&SPI_CR1_SPE)," NRF ˵ʱ CR1=%04X",Test_SPI2.CR1);
+	if(In_Isr)CHECK(SPI2_Lock_Cnt==0,"ѭռ SPI2 ʱ ж϶");
+	else CHECK(SPI2_Lock_Cnt,"ѭ û Ͷ NRF");
+	if(Chip.pos==0)
+	{
+		Chip.cmd=in;
+		Chip.pos=1;
+		Chip.w.len=0;
+		if(in==FLUSH_TX)Chip.txn=0;
+		if(in==FLUSH_RX)Chip.rxn=0;
+		return Chip_Status();
+	}
+	k=Chip.pos++-1;
+	r=Chip.cmd&0x1F;
+	if(Chip.cmd<NRF_WRITE_REG)
+	{
+		if(r==TX_ADDR)out=Chip.tx_addr[k%5];
+		else if(r==RX_ADDR_P0)out=Chip.rx_addr[k%5];
+		else if(r==STATUS)out=Chip_Status();
+		else if(r==NRF_FIFO_STATUS)out=Chip_Fifo();
+		else out=Chip.reg[r];
+	}
+	else if(Chip.cmd<0x40)
+	{
+		if(r==TX_ADDR)Chip.tx_addr[k%5]=in;
+		else if(r==RX_ADDR_P0)Chip.rx_addr[k%5]=in;
+		else if(r==STATUS)Chip.reg[STATUS]&=~(in&0x70);
+		else if(r==FEATURE||r==DYNPD){ if(Chip.plus||Chip.active)Chip.reg[r]=in; }
+		else Chip.reg[r]=in;
+	}
+	else if(Chip.cmd==R_RX_PL_WID)
+	{
+		CHECK(Chip.reg[FEATURE]&4,"û̬ Ͷ");
+		out=Chip.rxn?Chip.rxf[0].len:0;
+	}
+	else if(Chip.cmd==RD_RX_PLOAD)
+	{
+		CHECK(Chip.rxn,"RX FIFO Ŷ");
+		out=Chip.rxf[0].buf[k&31];
+		Chip.w.len=k+1;
+	}
+	else if(Chip.cmd==WR_TX_PLOAD||Chip.cmd==W_ACK_PAYLOAD)
+	{
+		if(k<32)Chip.w.buf[k]=in;
+		CHECK(k<32,"д  32 ֽ");
+		Chip.w.len=k+1;
+	}
+	else if(Chip.cmd==ACTIVATE)
+	{
+		if(in==0x73&&!Chip.plus)Chip.active^=1;
+	}
+	Chip_Irq();
+	return out;
+}
+
+volatile u8 *Test_Pin(char port,u8 n)
+{
+	if(port=='G')
+	{
+		if(n==7)Chip_End();
+		return &Pin_G[n];
+	}
+	return &Pin_B[n];
+}
+
+//SPI2 һֽ ֱӸоƬ
+static u16 Spi_Rx;
+FlagStatus SPI_I2S_GetFlagStatus(SPI_TypeDef *spi,u16 flag)
+{
+	return SET;
+}
+void SPI_I2S_SendData(SPI_TypeDef *spi,u16 data)
+{
+	Spi_Rx=Chip_Byte(data);
+}
+u16 SPI_I2S_ReceiveData(SPI_TypeDef *spi)
+{
+	return Spi_Rx;
+}
+
+//DMA1 ͨ4()/5()һΰ꣬ɱ־
+static void Dma_Run(void)
+{
+	u8 *rx=(u8*)(uintptr_t)Test_DMA1_Channel4.CMAR,*tx=(u8*)(uintptr_t)Test_DMA1_Channel5.CMAR;
+	u32 i,n=Test_DMA1_Channel4.CNDTR;
+	if((Test_SPI2.CR2&3)!=3||!(Test_DMA1_Channel4.CCR&1)||!(Test_DMA1_Channel5.CCR&1)||n==0)return;
+	CHECK(Test_DMA1_Channel5.CNDTR==n,"DMA շȲһ");
+	In_Isr=1;							//ж DMA߻жռ
+	for(i=0;i<n;i++)
+		rx[i]=Chip_Byte(tx[(Test_DMA1_Channel5.CCR&DMA_MemoryInc_Enable)?i:0]);
+	In_Isr=0;
+	Test_DMA1_Channel4.CNDTR=Test_DMA1_Channel5.CNDTR=0;
+	Test_DMA1.ISR|=DMA1_FLAG_TC4|DMA1_FLAG_GL4;
+}
+
+//д 1  /  ļĴ
+static void Sync_Regs(void)
+{
+	u32 i;
+	for(i=0;i<28;i+=4)
+		if(Test_DMA1.IFCR&(1u<<i))Test_DMA1.IFCR|=0x0Fu<<i;	// GIF  ͨб־
+	Test_DMA1.ISR&=~Test_DMA1.IFCR;
+	Test_DMA1.IFCR=0;
+	Test_EXTI.PR|=Test_EXTI.SWIER;
+	Test_EXTI.SWIER=0;
+}
+
+//ͬһж ˭˭һ һ
+static void Run_Irq(void)
+{
+	u8 ext,dma;
+	for(;;)
+	{
+		Sync_Regs();
+		ext=(Test_EXTI.PR&EXTI_Line6)!=0;
+		dma=(Test_DMA1.ISR&DMA1_FLAG_TC4)&&(Test_DMA1_Channel4.CCR&DMA_IT_TC);
+		if(!ext&&!dma)break;
+		In_Isr=1;
+		if(ext&&(!dma||Rand()&1))
+		{
+			EXTI9_5_IRQHandler();
+			Test_EXTI.PR&=~EXTI_Line6;
+		}
+		else DMA1_Channel4_IRQHandler();
+		In_Isr=0;
+	}
+}
+
+//----------------------------------------------------------------
+//Է  ѭ շİǰֽţ水
+static void Pkt_Make(Pkt *p,u16 seq)
+{
+	u8 i;
+	p->len=2+Rand()%31;
+	p->buf[0]=seq;
+	p->buf[1]=seq>>8;
+	for(i=2;i<p->len;i++)p->buf[i]=seq*7+i;
+}
+
+static int Pkt_Seq(const u8 *buf,u8 len)
+{
+	u8 i;
+	u16 seq=buf[0]|buf[1]<<8;
+	if(len<2||len>32)return -1;
+	for(i=2;i<len;i++)if(buf[i]!=(u8)(seq*7+i))return -1;
+	return seq;
+}
+
+static u16 Main_Seq,Peer_Seq;			//һҪ
+static int Peer_Last,Main_Last;			//յһ
+static u32 Peer_Got,Peer_Gap,Main_Got,Main_Gap;
+static u8  Peer_Quiet;					//βԷٷ°
+
+static void Peer_Recv(Pkt *p)
+{
+	int s=Pkt_Seq(p->buf,p->len);
+	CHECK(s>Peer_Last,"Էյ  %d ǰһ %d",s,Peer_Last);
+	if(s<=Peer_Last)return;
+	Peer_Gap+=s-Peer_Last-1;
+	Peer_Last=s;
+	Peer_Got++;
+}
+
+// һշ
+static void Air_Step(void)
+{
+	u8 i,r;
+	if(!(Chip.reg[CONFIG]&2)||!Pin_G[8])return;
+	if((Chip.reg[CONFIG]&1)==0)			//ͷ
+	{
+		if(Chip.txn==0||(Chip.reg[STATUS]&MAX_TX))return;	//MAX_RT û 
+		if(Rand()%8==0)
+		{
+			r=0x0A;						//ȥ FIFO ǰ
+			Chip.reg[STATUS]|=MAX_TX;
+		}
+		else
+		{
+			r=Rand()%3?0:Rand()%10;
+			Peer_Recv(&Chip.txf[0]);
+			for(i=1;i<Chip.txn;i++)Chip.txf[i-1]=Chip.txf[i];
+			Chip.txn--;
+			Chip.reg[STATUS]|=TX_OK;
+			if(!Peer_Quiet&&Chip.rxn<3&&Rand()%2)	//ACK 
+			{
+				Pkt_Make(&Chip.rxf[Chip.rxn++],Peer_Seq++);
+				Chip.reg[STATUS]|=RX_OK;
+			}
+		}
+		Chip.reg[OBSERVE_TX]=(Chip.reg[OBSERVE_TX]&0xF0)|r;
+		Air_Retr+=r;
+	}
+	else								//շ
+	{
+		if(Peer_Quiet&&Chip.txn==0)return;
+		if(Chip.rxn==3)return;			//FIFO   ACKԷط
+		Pkt_Make(&Chip.rxf[Chip.rxn++],Peer_Seq++);
+		Chip.reg[STATUS]|=RX_OK;
+		if(Chip.txn)					//ACK  һ
+		{
+			Peer_Recv(&Chip.txf[0]);
+			for(i=1;i<Chip.txn;i++)Chip.txf[i-1]=Chip.txf[i];
+			Chip.txn--;
+			Chip.reg[STATUS]|=TX_OK;
+		}
+	}
+	Chip_Irq();
+}
+
+static void Main_Recv(void)
+{
+	u8 buf[32],len;
+	int s;
+	while(NRF_Link_Recv(buf,&len)==0)
+	{
+		s=Pkt_Seq(buf,len);
+		CHECK(s>Main_Last,"ѭյ  %d ǰһ %d",s,Main_Last);
+		if(s<=Main_Last)return;
+		Main_Gap+=s-Main_Last-1;
+		Main_Last=s;
+		Main_Got++;
+	}
+}
+
+static void Main_Send(void)
+{
+	Pkt p;
+	u8 free=NRF_Link_Tx_Free();
+	Pkt_Make(&p,Main_Seq);
+	if(free==0)
+	{
+		CHECK(NRF_Link_Send(p.buf,p.len)==1,"Ͷ Žȥ");
+		return;
+	}
+	CHECK(NRF_Link_Send(p.buf,p.len)==0,"Ͷ  %u  Ųȥ",free);
+	Main_Seq++;
+	CHECK(NRF_Link_Tx_Free()==free-1,"Žһ λû");
+}
+
+//ѭ ռ SPI2  W25QXX  (缸мж ֻƳ)
+static u8 W25_Hold=0;
+static u16 Main_Busy=0;					//ѭæ ȡ (նл)
+static void W25_Begin(void)
+{
+	SPI2_Lock();
+	CHECK(Test_SPI2.CR1==W25_CR1,"W25QXX õ SPI2 ʱ CR1=%04X",Test_SPI2.CR1);
+	Pin_B[12]=0;
+	SPI2_ReadWriteByte(0x05);
+	W25_Hold=1+Rand()%6;
+}
+static void W25_End(void)
+{
+	SPI2_ReadWriteByte(0xFF);
+	Pin_B[12]=1;
+	SPI2_Unlock();
+}
+
+static void Check_Regs(u8 prx)
+{
+	CHECK(Chip.reg[CONFIG]==(NRF_CONFIG|prx),"CONFIG=%02X",Chip.reg[CONFIG]);
+	CHECK(Chip.reg[EN_AA]==1&&Chip.reg[EN_RXADDR]==1&&Chip.reg[SETUP_AW]==3&&Chip.reg[SETUP_RETR]==0x1a&&Chip.reg[RF_CH]==40&&Chip.reg[RF_SETUP]==0x0f,"Ĵûд");
+	CHECK(Chip.reg[FEATURE]==6&&Chip.reg[DYNPD]==1,"%s FEATURE=%02X DYNPD=%02X",Chip.plus?"+":"+",Chip.reg[FEATURE],Chip.reg[DYNPD]);
+	CHECK(!memcmp(Chip.tx_addr,TX_ADDRESS,5)&&!memcmp(Chip.rx_addr,RX_ADDRESS,5),"ַûд");
+}
+
+static void Step(void)
+{
+	u32 r;
+	if(Rand()%3==0)Air_Step();
+	if(Rand()%2)Dma_Run();
+	Run_Irq();
+	if(W25_Hold)
+	{
+		if(--W25_Hold==0)W25_End();
+		Run_Irq();
+		return;
+	}
+	r=Rand()%1000;
+	if(r==999&&!Peer_Quiet)Main_Busy=20+Rand()%200;
+	if(Main_Busy)Main_Busy--;
+	r/=10;
+	if(r<25&&!Peer_Quiet)Main_Send();
+	else if(r<35&&!SPI2_Isr_Busy)W25_Begin();
+	else if(r<36&&!SPI2_Isr_Busy)
+	{
+		CHECK(NRF24L01_Check()==0,"NRF24L01_Check ʧ");
+		SPI2_SetSpeed(SPI_BaudRatePrescaler_2);		//W25QXX  18M (Լĳʼһ)
+		CHECK(!memcmp(Chip.tx_addr,TX_ADDRESS,5),"NRF24L01_Check  TX_ADDR ");
+	}
+	else if(!Main_Busy&&r<60)Main_Recv();
+	Run_Irq();
+}
+
+static void Run(u8 prx)
+{
+	u32 i;
+	memset(&Chip,0,sizeof(Chip));
+	Chip.reg[CONFIG]=0x08;
+	Chip.plus=Rand()&1;
+	memset(&NRF_Link_Stat,0,sizeof(NRF_Link_Stat));
+	Main_Seq=Peer_Seq=0;
+	Peer_Last=Main_Last=-1;
+	Peer_Got=Peer_Gap=Main_Got=Main_Gap=0;
+	Air_Retr=0;
+	Peer_Quiet=0;
+	Main_Busy=0;
+	NRF24L01_Init();
+	Test_SPI2.CR1=SPI_Mode_Master|SPI_NSS_Soft|SPI_BaudRatePrescaler_16|SPI_CR1_SPE;	//SPI_Init ǿյģд
+	SPI2_SetSpeed(SPI_BaudRatePrescaler_2);			//W25QXX_Init
+	CHECK(NRF24L01_Check()==0,"NRF24L01_Check ʧ");
+	SPI2_SetSpeed(SPI_BaudRatePrescaler_2);
+	NRF_Link_Init(prx);
+	Sync_Regs();
+	CHECK(Test_SPI2.CR1==W25_CR1,"NRF_Link_Init  CR1=%04X",Test_SPI2.CR1);
+	Check_Regs(prx);
+	for(i=0;i<STEPS&&!Fail;i++)Step();
+	Peer_Quiet=1;						//βٷ°жҪ
+	for(i=0;i<STEPS&&!Fail;i++)
+	{
+		Step();
+		if(W25_Hold||SPI2_Isr_Busy)continue;
+		Main_Recv();
+		if(NRF_Link_Tx_Free()==NRF_LINK_TXQ-1&&!Chip.txn&&!Chip.rxn&&NRF_Rx_Head==NRF_Rx_Tail)break;
+	}
+	if(Fail)return;
+	CHECK(i<STEPS,"%s ղ꣺Ͷ  %u оƬ TX %u RX %u",prx?"շ":"ͷ",NRF_LINK_TXQ-1-NRF_Link_Tx_Free(),Chip.txn,Chip.rxn);
+	Peer_Gap+=Main_Seq-1-Peer_Last;		//󼸰 ˵
+	CHECK(NRF_Link_Stat.tx_ok==Peer_Got&&NRF_Link_Stat.tx_lost==Peer_Gap," %u tx_ok %u tx_lost %uԷյ %u © %u",Main_Seq,NRF_Link_Stat.tx_ok,NRF_Link_Stat.tx_lost,Peer_Got,Peer_Gap);
+	CHECK(prx||Peer_Gap,"ͷ һû (MAX_RT û⵽)");
+	Main_Gap+=Peer_Seq-1-Main_Last;
+	CHECK(NRF_Link_Stat.rx_ok==Main_Got&&NRF_Link_Stat.rx_drop==Main_Gap,"Է %u rx_ok %u rx_drop %uյ %u © %u",Peer_Seq,NRF_Link_Stat.rx_ok,NRF_Link_Stat.rx_drop,Main_Got,Main_Gap);
+	CHECK(Main_Gap,"ն û (rx_drop û⵽)");
+	CHECK(NRF_Link_Stat.retrans<=Air_Retr,"retrans %u ȿе %u ",NRF_Link_Stat.retrans,Air_Retr);
+}
+
+int main(int argc,char *argv[])
+{
+	u32 n=argc>1?strtoul(argv[1],0,0):200;
+	u32 k;
+	Pin_G[7]=Pin_B[12]=1;
+	for(k=0;k<n&&!Fail;k++)
+	{
+		Rand_Seed=k+1;
+		Run(k&1);
+		if(Fail)printf(" %u  (%s)\n",k,k&1?"շ":"ͷ");
+	}
+	return Test_Done();
+}
@@ -0,0 +1,3 @@
+/* ϱãdelay_ms  */
+#define delay_ms(ms)
+#define delay_us(us)
@@ -0,0 +1,96 @@
+/* ϱãֻ 24l01.c / spi.c õ͡Ĵͳ
+	SPI2/DMA1/EXTI  nrf_test.c ڴ⺯ ʲô
+	 PGout/PGin/PBout  Test_Pin() ȡַ ˿ Ƭѡ ÿһα仯 */
+#ifndef __SYS_H
+#define __SYS_H
+#include <stdint.h>
+typedef int32_t  s32;
+typedef int16_t  s16;
+typedef int8_t   s8;
+typedef uint32_t u32;
+typedef uint16_t u16;
+typedef uint8_t  u8;
+
+typedef struct{ volatile u16 CR1,CR2,SR,DR; }SPI_TypeDef;
+typedef struct{ volatile u32 ISR,IFCR; }DMA_TypeDef;
+typedef struct{ volatile u32 CCR,CNDTR,CPAR,CMAR; }DMA_Channel_TypeDef;
+typedef struct{ volatile u32 PR,SWIER; }EXTI_TypeDef;
+
+extern SPI_TypeDef Test_SPI2;
+extern DMA_TypeDef Test_DMA1;
+extern DMA_Channel_TypeDef Test_DMA1_Channel4,Test_DMA1_Channel5;
+extern EXTI_TypeDef Test_EXTI;
+#define SPI2				(&Test_SPI2)
+#define DMA1				(&Test_DMA1)
+#define DMA1_Channel4		(&Test_DMA1_Channel4)
+#define DMA1_Channel5		(&Test_DMA1_Channel5)
+#define EXTI				(&Test_EXTI)
+
+volatile u8 *Test_Pin(char port,u8 n);
+#define PGout(n)			(*Test_Pin('G',n))
+#define PGin(n)				(*Test_Pin('G',n))
+#define PBout(n)			(*Test_Pin('B',n))
+
+typedef enum{RESET=0,SET=1}FlagStatus;
+typedef enum{DISABLE=0,ENABLE=1}FunctionalState;
+
+typedef struct{ u16 GPIO_Pin; int GPIO_Speed,GPIO_Mode; }GPIO_InitTypeDef;
+typedef struct{ u16 SPI_Direction,SPI_Mode,SPI_DataSize,SPI_CPOL,SPI_CPHA,SPI_NSS,SPI_BaudRatePrescaler,SPI_FirstBit,SPI_CRCPolynomial; }SPI_InitTypeDef;
+
+#define SPI_Direction_2Lines_FullDuplex	0x0000
+#define SPI_Mode_Master					0x0104
+#define SPI_DataSize_8b					0x0000
+#define SPI_CPOL_Low					0x0000
+#define SPI_CPOL_High					0x0002
+#define SPI_CPHA_1Edge					0x0000
+#define SPI_CPHA_2Edge					0x0001
+#define SPI_NSS_Soft					0x0200
+#define SPI_BaudRatePrescaler_2			0x0000
+#define SPI_BaudRatePrescaler_4			0x0008
+#define SPI_BaudRatePrescaler_8			0x0010
+#define SPI_BaudRatePrescaler_16		0x0018
+#define SPI_BaudRatePrescaler_256		0x0038
+#define SPI_FirstBit_MSB				0x0000
+#define SPI_CR1_SPE						0x0040
+#define SPI_I2S_DMAReq_Rx				0x0001
+#define SPI_I2S_DMAReq_Tx				0x0002
+#define SPI_I2S_FLAG_TXE				0x0002
+#define SPI_I2S_FLAG_RXNE				0x0001
+
+#define DMA_DIR_PeripheralSRC			0x00000000
+#define DMA_DIR_PeripheralDST			0x00000010
+#define DMA_MemoryInc_Enable			0x00000080
+#define DMA_MemoryInc_Disable			0x00000000
+#define DMA_Priority_VeryHigh			0x00003000
+#define DMA_Priority_High				0x00002000
+#define DMA_IT_TC						0x00000002
+#define DMA_CCR4_EN						0x00000001
+#define DMA_CCR5_EN						0x00000001
+#define DMA1_FLAG_GL4					0x00001000
+#define DMA1_FLAG_TC4					0x00002000
+#define DMA1_FLAG_GL5					0x00010000
+#define EXTI_Line6						0x00000040
+
+enum{GPIO_Pin_6=0x40,GPIO_Pin_7=0x80,GPIO_Pin_8=0x100,GPIO_Pin_12=0x1000,GPIO_Pin_13=0x2000,GPIO_Pin_14=0x4000,GPIO_Pin_15=0x8000,
+	GPIO_Mode_Out_PP,GPIO_Mode_AF_PP,GPIO_Mode_IPD,GPIO_Speed_50MHz,
+	RCC_APB2Periph_GPIOB,RCC_APB2Periph_GPIOG,RCC_APB1Periph_SPI2,RCC_AHBPeriph_DMA1,
+	GPIO_G,FTIR,EXTI9_5_IRQn,DMA1_Channel4_IRQn};
+#define GPIOB							0
+#define GPIOG							0
+
+#define RCC_APB2PeriphClockCmd(...)
+#define RCC_APB1PeriphClockCmd(...)
+#define RCC_AHBPeriphClockCmd(...)
+#define GPIO_Init(...)
+#define GPIO_SetBits(...)
+#define GPIO_ResetBits(...)
+#define SPI_Init(...)
+#define SPI_Cmd(...)
+#define assert_param(...)
+#define Ex_NVIC_Config(...)
+#define MY_NVIC_Init(...)
+
+FlagStatus SPI_I2S_GetFlagStatus(SPI_TypeDef *spi,u16 flag);
+void SPI_I2S_SendData(SPI_TypeDef *spi,u16 data);
+u16  SPI_I2S_ReceiveData(SPI_TypeDef *spi);
+#endif
@@ -0,0 +1 @@
+/* ϱã24l01.h ˣ·ò */
@@ -0,0 +1,6 @@
+/* ϱãУ׼ ֱӸд 24C02 */
+#define AT24CXX_Init()
+#define AT24CXX_Read(...)
+#define AT24CXX_Write(...)
+#define AT24CXX_ReadOneByte(a)		0
+#define AT24CXX_WriteOneByte(...)
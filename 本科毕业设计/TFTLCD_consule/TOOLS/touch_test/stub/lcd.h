@@ -0,0 +1,17 @@
+/* ϱãͼ ʲô (У׼ ﲻ) */
+#ifndef __LCD_H
+#define __LCD_H
+#include <stdlib.h>
+#include <math.h>
+#include "sys.h"
+enum{WHITE=0xFFFF,BLACK=0,BLUE=0x001F,RED=0xF800,GREEN=0x07E0,BROWN=0xBC40,GRED=0xFFE0};
+typedef struct{ u16 width,height,id; u8 dir; }_lcd_dev;
+extern _lcd_dev lcddev;
+extern u16 POINT_COLOR,BACK_COLOR;
+#define LCD_Clear(...)
+#define LCD_DrawLine(...)
+#define LCD_DrawPoint(...)
+#define LCD_Draw_Circle(...)
+#define LCD_ShowNum(...)
+#define LCD_ShowString(...)
+#endif
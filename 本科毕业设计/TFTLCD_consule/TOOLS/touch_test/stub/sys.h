@@ -0,0 +1,45 @@
+/* ϱãֻ touch.c õ͡Ĵͳ
+	TIM4/EXTI/RCC  touch_test.c ڴ⺯ ʲô
+	 PFin/PBin/PFout/PBout  Test_Pin() ȡַ ˿ ʱ ÿһα仯 */
+#ifndef __SYS_H
+#define __SYS_H
+#include <stdint.h>
+typedef int32_t  s32;
+typedef int16_t  s16;
+typedef int8_t   s8;
+typedef uint32_t u32;
+typedef uint16_t u16;
+typedef uint8_t  u8;
+
+typedef struct{ volatile u16 CR1,DIER,SR,EGR,CNT,PSC,ARR; }TIM_TypeDef;
+typedef struct{ volatile u32 IMR,SWIER,PR; }EXTI_TypeDef;
+typedef struct{ volatile u32 APB1ENR; }RCC_TypeDef;
+
+extern TIM_TypeDef Test_TIM4;
+extern EXTI_TypeDef Test_EXTI;
+extern RCC_TypeDef Test_RCC;
+#define TIM4				(&Test_TIM4)
+#define EXTI				(&Test_EXTI)
+#define RCC					(&Test_RCC)
+
+volatile u8 *Test_Pin(char port,u8 n);
+#define PFin(n)				(*Test_Pin('F',n))
+#define PFout(n)			(*Test_Pin('F',n))
+#define PBin(n)				(*Test_Pin('B',n))
+#define PBout(n)			(*Test_Pin('B',n))
+
+typedef enum{DISABLE=0,ENABLE=1}FunctionalState;
+typedef struct{ u16 GPIO_Pin; int GPIO_Speed,GPIO_Mode; }GPIO_InitTypeDef;
+
+enum{GPIO_Pin_1=0x02,GPIO_Pin_2=0x04,GPIO_Pin_9=0x200,GPIO_Pin_10=0x400,GPIO_Pin_11=0x800,
+	GPIO_Mode_Out_PP,GPIO_Mode_IPU,GPIO_Speed_50MHz,RCC_APB2Periph_GPIOB,RCC_APB2Periph_GPIOF,
+	GPIO_F,FTIR,TIM4_IRQn,EXTI15_10_IRQn};
+#define GPIOB				0
+#define GPIOF				0
+
+#define RCC_APB2PeriphClockCmd(...)
+#define GPIO_Init(...)
+#define GPIO_SetBits(...)
+#define Ex_NVIC_Config(gpio,bit,trim)	(Test_EXTI.IMR|=1<<(bit))	// EXTI  (ĻҪ AFIO  )
+#define MY_NVIC_Init(...)
+#endif
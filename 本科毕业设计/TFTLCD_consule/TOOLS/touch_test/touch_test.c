@@ -0,0 +1,414 @@
+/*  жϲ  (Уð)
+	ֱӱ TOUCH/touch.cTIM4/EXTI ڴʱ䰴 ms ߣ  Test_Pin() һ  ADS7846
+		CS  ʼһתDCLK   8 λ (ʼλ/ͨ/12 λģʽ Ҫ) 9   BUSY
+		֮ ½  12 λ ٲ 0һת  25 أתʱ оƬ PENIRQEXTI10  ͻ󴥷
+	TP_Read_XOY5  ȥС ƽ ֱ ȡ
+	ģʻ  1ms~1.5sƶ (Y ʻ ) 3 ɱʻ Ǵβ ƫ֮ܶࣻ ̧ 25ms
+		ѭ ÿ 1~5ms ȡһ¼м Ῠס ܾ ()ż TP_Irq_Stop ѯһ  TP_Irq_Init
+		飺¼ PRESS MOVE.. RELEASE ɶԣȡ¼ tp_dev.sta/x/y Եϣ  һ ߹ķΧ
+		ʱ Ҫס >=50ms ıʻ һ PRESS<20ms  () һûУ̧ 20ms  õ RELEASE
+			MOVE һ¼ ٲ TP_MOVE_MIN һ
+		̧ 15ms Ժ  TIM4 ж Ҳ ADжϲʱ TP_Scan  AD
+
+	룺gcc -O2 -I ../../../../COMMON/TOOLS -I stub -I ../../TOUCH -o touch_test touch_test.c -lm
+	÷touch_test [ʻ]   Ĭ 40000ȫͨ 0򷵻 1 ӡ 
+*/
+#include "test_common.h"
+#include <string.h>
+#include "touch.c"
+
+TIM_TypeDef Test_TIM4;
+EXTI_TypeDef Test_EXTI;
+RCC_TypeDef Test_RCC;
+_lcd_dev lcddev;
+u16 POINT_COLOR,BACK_COLOR;
+void do_touch_function(void){}
+u8 OTT2001A_Init(void){ return 1; }			// ﲻ
+u8 OTT2001A_Scan(u8 mode){ return 0; }
+u8 GT9147_Init(void){ return 1; }
+u8 GT9147_Scan(u8 mode){ return 0; }
+u8 FT5206_Init(void){ return 1; }
+u8 FT5206_Scan(u8 mode){ return 0; }
+
+#define XFAC			0.066f
+#define XOFF			-13
+#define YFAC			0.09f
+#define YOFF			-25
+#define NOISE			3						// 
+#define GLITCH			300						//Ǵ ƫ
+
+static u32 Now=0;								//ms
+static volatile u8 Pin_B[16],Pin_F[16];
+static u8 Old_CS=1,Old_CLK=1;
+static u32 Exti_Pend=0;
+
+//
+static u8  Pen_Down=0;
+static float Pen_X,Pen_Y;						//
+static u32 Glitch_Until=0;
+static u8  Rand_Mode=0;							//1: ȫ ( TP_Read_XOY)
+
+// ADS7846
+static u8  Ads_Edge=0,Ads_Cmd=0,Ads_Bit=0,Ads_Dout=0;
+static u16 Ads_Val;
+static u16 Ads_Log[READ_TIMES];
+static u32 Ads_Conv=0;							//ת
+
+static u16 Ads_Value(u8 cmd)
+{
+	int v;
+	u8 a=(cmd>>4)&7;
+	CHECK((cmd&0x80)&&!(cmd&0x08)," %02X ʼλ/12 λģʽ ",cmd);
+	CHECK(a==5||a==1," %02X  X/Y ͨ",cmd);
+	if(Rand_Mode)return Rand()%4096;
+	v=(int)(a==5?Pen_X:Pen_Y)+(int)(Rand()%(2*NOISE+1))-NOISE;
+	if(Now<Glitch_Until)v+=GLITCH;
+	return v<0?0:v>4095?4095:v;
+}
+
+// CS/DCLK û (ÿֻһ߱)
+static void Ads_Sync(void)
+{
+	u8 cs=Pin_F[11],clk=Pin_B[1];
+	if(cs!=Old_CS)
+	{
+		if(!cs)
+		{
+			Ads_Edge=0;
+			Ads_Cmd=0;
+			Ads_Dout=0;
+			Ads_Conv++;
+			if(Test_EXTI.IMR&(1<<10))Exti_Pend|=1<<10;	//ת PENIRQ
+		}
+		else
+		{
+			CHECK(Ads_Edge==25,"һת %u  ӦΪ 25",Ads_Edge);
+			memmove(Ads_Log,Ads_Log+1,sizeof(Ads_Log)-sizeof(Ads_Log[0]));
+			Ads_Log[READ_TIMES-1]=Ads_Val;
+		}
+	}
+	else if(!cs&&clk!=Old_CLK)
+	{
+		if(clk)
+		{
+			Ads_Edge++;
+			if(Ads_Edge<=8)Ads_Cmd=Ads_Cmd<<1|(Pin_F[9]&1);
+			if(Ads_Edge==8){ Ads_Val=Ads_Value(Ads_Cmd); Ads_Bit=12; }
+		}
+		else if(Ads_Edge>=9)Ads_Dout=Ads_Bit?(Ads_Val>>--Ads_Bit)&1:0;
+	}
+	Old_CS=cs;
+	Old_CLK=clk;
+}
+
+volatile u8 *Test_Pin(char port,u8 n)
+{
+	Ads_Sync();
+	if(port=='B')
+	{
+		if(n==2)Pin_B[2]=Ads_Dout;
+		return &Pin_B[n];
+	}
+	if(n==10)Pin_F[10]=!Pen_Down;
+	return &Pin_F[n];
+}
+
+//EXTI->PR д 1 㣺һδǰ һ (ڱλ дûд)
+#define PR_MARK			0x80000000u
+static void Pr_Enter(void)
+{
+	Test_EXTI.PR=Exti_Pend|PR_MARK;
+}
+static void Pr_Leave(void)
+{
+	if(Test_EXTI.PR!=(Exti_Pend|PR_MARK))Exti_Pend&=~Test_EXTI.PR;
+	if(Test_EXTI.SWIER&Test_EXTI.IMR)Exti_Pend|=Test_EXTI.SWIER&Test_EXTI.IMR;
+	Test_EXTI.SWIER=0;
+}
+
+//ʻ¼
+#define STK_N			64
+typedef struct{
+	u32 down,up;								//up Ϊ 0
+	s16 x0,y0,x1,y1;							//Ļ Χ
+	u8  pressed;								//յ PRESS
+	u8  off;									//; ͣжϲ
+	u32 init;									//ŵʱ ؿжϲ (֮ Ҫ PRESS)
+}Stroke;
+static Stroke Stk[STK_N];
+static u32 Stk_N=0;								//ѿʼıʻ
+static u32 Tim_Irq_N=0;
+static u8  Stall_Run=0;
+static u32 Stroke_Long=0,Stroke_Pressed=0;
+
+static void Stk_Grow(Stroke *s)
+{
+	s16 x=XFAC*Pen_X+XOFF,y=YFAC*Pen_Y+YOFF;
+	if(x<s->x0)s->x0=x;
+	if(x>s->x1)s->x1=x;
+	if(y<s->y0)s->y0=y;
+	if(y>s->y1)s->y1=y;
+}
+
+static int Stk_Has(Stroke *s,u16 x,u16 y)
+{
+	return (s16)x>=s->x0-3&&(s16)x<=s->x1+3&&(s16)y>=s->y0-3&&(s16)y<=s->y1+3;
+}
+
+// 1msTIM4 жϾͽ
+static void Tick(void)
+{
+	Now++;
+	if(Test_TIM4.CR1&1)
+	{
+		Test_TIM4.CNT+=10;
+		if(Test_TIM4.CNT>Test_TIM4.ARR)
+		{
+			Test_TIM4.CNT-=Test_TIM4.ARR+1;
+			Test_TIM4.SR|=1;
+		}
+	}
+	if(Exti_Pend&Test_EXTI.IMR&(1<<10))
+	{
+		Pr_Enter();
+		EXTI15_10_IRQHandler();
+		Pr_Leave();
+	}
+	if((Test_TIM4.SR&1)&&(Test_TIM4.DIER&1))
+	{
+		Tim_Irq_N++;
+		Pr_Enter();
+		TIM4_IRQHandler();
+		Pr_Leave();
+	}
+}
+
+//ѭ ȡ¼
+static u8 Pressed=0;							//ѭ ״̬
+static u32 Cur=0;								//ǰ¼ һ
+static u32 Next_Stk=0;							//һ PRESS  ڼ
+static u16 Prev_X,Prev_Y;
+
+static void Main_Get(void)
+{
+	TP_Event ev;
+	Stroke *s;
+	u32 k;
+	Pr_Enter();
+	while(TP_Get_Event(&ev))
+	{
+		switch(ev.type)
+		{
+			case TP_EV_PRESS:
+				CHECK(!Pressed,"%u ms ûɿ  PRESS",Now);
+				for(k=Stk_N<STK_N?0:Stk_N-STK_N+1;k<Stk_N;k++)	// ûƥһ (Init   ͬһ)
+				{
+					s=&Stk[k%STK_N];
+					if((k>=Next_Stk||(k==Cur&&s->off))&&Stk_Has(s,ev.x,ev.y))break;
+				}
+				CHECK(k<Stk_N,"%u ms PRESS (%u,%u)  κһ",Now,ev.x,ev.y);
+				if(k>=Stk_N)break;
+				s=&Stk[k%STK_N];
+				if(!Stall_Run)
+					CHECK(!s->up||Now<=s->up+20,"%u ms PRESS  %u ms ̧һʵ",Now,s->up);
+				Cur=k;
+				Next_Stk=k+1;
+				s->pressed=1;
+				Pressed=1;
+				CHECK((tp_dev.sta&(TP_PRES_DOWN|TP_CATH_PRES))==(TP_PRES_DOWN|TP_CATH_PRES)&&tp_dev.x[4]==ev.x&&tp_dev.y[4]==ev.y,"PRESS  sta %02X",tp_dev.sta);
+				break;
+			case TP_EV_MOVE:
+			case TP_EV_RELEASE:
+				CHECK(Pressed,"%u ms û PRESS  %s",Now,ev.type==TP_EV_MOVE?"MOVE":"RELEASE");
+				s=&Stk[Cur%STK_N];
+				CHECK(Stk_Has(s,ev.x,ev.y),"%u ms %s (%u,%u)  һ (%d~%d,%d~%d) ",Now,ev.type==TP_EV_MOVE?"MOVE":"RELEASE",ev.x,ev.y,s->x0,s->x1,s->y0,s->y1);
+				if(ev.type==TP_EV_MOVE)
+				{
+					if(!Stall_Run)
+						CHECK(abs(ev.x-Prev_X)>=TP_MOVE_MIN||abs(ev.y-Prev_Y)>=TP_MOVE_MIN,"MOVE ֻ (%d,%d)",ev.x-Prev_X,ev.y-Prev_Y);
+					CHECK(tp_dev.sta&TP_PRES_DOWN,"MOVE  sta %02X",tp_dev.sta);
+					break;
+				}
+				CHECK(ev.x==Prev_X&&ev.y==Prev_Y,"RELEASE (%u,%u)  һ (%u,%u)",ev.x,ev.y,Prev_X,Prev_Y);
+				if(!Stall_Run&&!s->off)
+					CHECK(s->up&&Now<=s->up+20,"%u ms RELEASE һ %u ms ̧",Now,s->up);
+				Pressed=0;
+				CHECK(!(tp_dev.sta&TP_PRES_DOWN),"RELEASE  sta %02X",tp_dev.sta);
+				break;
+			default:
+				CHECK(0,"¼ %u",ev.type);
+		}
+		CHECK(tp_dev.x[0]==ev.x&&tp_dev.y[0]==ev.y,"tp_dev  û");
+		Prev_X=ev.x;
+		Prev_Y=ev.y;
+	}
+	Pr_Leave();
+}
+
+//жϲʱ TP_Scan ֻ״̬
+static void Main_Scan(void)
+{
+	u32 c=Ads_Conv;
+	u8 r;
+	Pr_Enter();
+	r=tp_dev.scan(0);
+	Pr_Leave();
+	CHECK(r==(tp_dev.sta&TP_PRES_DOWN)&&c==Ads_Conv,"жϲʱ TP_Scan  AD");
+}
+
+//ͣжϲ ѯ ms  ٿ ( TP_Adjust һ)
+static u32 Off_Until=0;
+static void Irq_Off(u32 ms)
+{
+	Pr_Enter();
+	TP_Irq_Stop();
+	Pr_Leave();
+	Pressed=0;
+	Off_Until=Now+ms;
+	if(Stk_N)Stk[(Stk_N-1)%STK_N].off=1;
+}
+
+// ms 룬ѭ ȡȡ
+static u32 Next_Get=0;
+static void Run(u32 ms)
+{
+	Stroke *s=Stk_N?&Stk[(Stk_N-1)%STK_N]:0;
+	u32 c,t;
+	while(ms--)
+	{
+		c=Ads_Conv;
+		t=Tim_Irq_N;
+		Tick();
+		if(s&&!s->up)Stk_Grow(s);
+		if(Off_Until)
+		{
+			if(s&&!s->up)s->off=1;
+			if(Now>=Off_Until)
+			{
+				Off_Until=0;
+				Pr_Enter();
+				TP_Irq_Init();
+				Pr_Leave();
+				if(s&&!s->up){ s->init=Now; s->pressed=0; }
+			}
+			else if(Rand()%4==0)
+			{
+				Pr_Enter();
+				tp_dev.scan(0);			//ѯ  AD
+				Pr_Leave();
+			}
+			continue;
+		}
+		if(!Pen_Down&&s&&s->up&&Now>s->up+15)
+			CHECK(c==Ads_Conv&&t==Tim_Irq_N,"%u ms ̧ %u ms  %s",Now,Now-s->up,t!=Tim_Irq_N?" TIM4 ж":" AD");
+		if(Now>=Next_Get)
+		{
+			Main_Get();
+			if(Rand()%8==0)Main_Scan();
+			Next_Get=Now+1+Rand()%5;
+			if(Stall_Run&&Rand()%300==0)Next_Get=Now+200+Rand()%1000;
+		}
+	}
+}
+
+//һʣ ms 룬 (vx,vy)/ms
+//Y  BAND_N  ã ʶʱ Ҳϵó ¼һʵ
+#define BAND_N			24
+#define BAND			145
+static void Stroke_Do(u32 ms)
+{
+	Stroke *s=&Stk[Stk_N%STK_N];
+	float vx=((int)(Rand()%401)-200)/100.0f,vy=((int)(Rand()%61)-30)/100.0f;
+	float lo=300+Stk_N%BAND_N*BAND+35,hi=lo+BAND-70;
+	u32 k;
+	memset(s,0,sizeof(*s));
+	Pen_X=400+Rand()%3300;
+	Pen_Y=lo+Rand()%(BAND-70);
+	s->down=Now;
+	s->x0=s->y0=0x7FFF;
+	s->x1=s->y1=-0x7FFF;
+	Stk_Grow(s);
+	Stk_N++;
+	Glitch_Until=Rand()%10<3?Now+12:0;
+	Pen_Down=1;
+	if(Test_EXTI.IMR&(1<<10))Exti_Pend|=1<<10;		//½
+	for(k=0;k<ms;k++)
+	{
+		Run(1);
+		Pen_X+=vx;
+		Pen_Y+=vy;
+		if(Pen_X<300||Pen_X>3800)vx=-vx;
+		if(Pen_Y<lo||Pen_Y>hi)vy=-vy;
+	}
+	Pen_Down=0;
+	s->up=Now;
+	if(!Stall_Run&&s->init&&s->up-s->init>=50)
+		CHECK(s->pressed,"%u ms  ؿжϲ û PRESS",s->init);
+	if(!Stall_Run&&!s->off)
+	{
+		if(ms<20)CHECK(!s->pressed,"%u ms Ķ  PRESS",ms);
+		if(ms>=50){ Stroke_Long++; Stroke_Pressed+=s->pressed; }
+	}
+}
+
+//TP_Read_XOY 5 
+static void Test_Read_XOY(u32 n)
+{
+	u16 r,sort[READ_TIMES],t;
+	u32 i,j;
+	Rand_Mode=1;
+	while(n--&&!Fail)
+	{
+		r=TP_Read_XOY(n&1?CMD_RDX:CMD_RDY);
+		Ads_Sync();								//Ǵ TCS=1 û
+		memcpy(sort,Ads_Log,sizeof(sort));
+		for(i=0;i<READ_TIMES;i++)
+			for(j=i+1;j<READ_TIMES;j++)
+				if(sort[j]<sort[i]){ t=sort[i]; sort[i]=sort[j]; sort[j]=t; }
+		t=(sort[1]+sort[2]+sort[3])/3;
+		CHECK(r==t,"TP_Read_XOY %u ӦΪ %u (%u %u %u %u %u)",r,t,Ads_Log[0],Ads_Log[1],Ads_Log[2],Ads_Log[3],Ads_Log[4]);
+	}
+	Rand_Mode=0;
+}
+
+int main(int argc,char *argv[])
+{
+	u32 n=argc>1?strtoul(argv[1],0,0):40000;
+	u32 k,len,lost=0;
+	Pin_B[1]=Pin_F[9]=Pin_F[10]=Pin_F[11]=1;
+	Test_Read_XOY(100000);
+	tp_dev.xfac=XFAC;
+	tp_dev.xoff=XOFF;
+	tp_dev.yfac=YFAC;
+	tp_dev.yoff=YOFF;
+	Pr_Enter();
+	TP_Irq_Init();
+	Pr_Leave();
+	for(k=0;k<n&&!Fail;k++)
+	{
+		if(k%5000==0)
+		{
+			if(Stall_Run)Main_Get();			//ס ʣµ ȡ
+			Next_Get=Now;
+			Stall_Run=!Stall_Run&&k;
+			if(!Stall_Run)lost=Tp_Ev_Lost;
+		}
+		switch(Rand()%10)
+		{
+			case 0: len=1+Rand()%19; break;		//
+			case 1: len=20+Rand()%30; break;
+			case 2: len=500+Rand()%1000; break;
+			default: len=50+Rand()%450; break;
+		}
+		if(Rand()%200==0)Irq_Off(Rand()%100);
+		Stroke_Do(len);
+		Run(25+Rand()%300);
+		if(!Stall_Run)CHECK(Tp_Ev_Lost==lost,"ѭ û Ҳ %u ¼",Tp_Ev_Lost-lost);
+	}
+	Run(1000);
+	Main_Get();
+	CHECK(!Pressed&&!(tp_dev.sta&TP_PRES_DOWN)," ûɿ");
+	CHECK(Stroke_Pressed==Stroke_Long,"ʻ %u  ֻ %u  PRESS",Stroke_Long,Stroke_Pressed);
+	CHECK(Tp_Ev_Lost||n<20000," һֱû");
+	return Test_Done();
+}
@@ -31,6 +31,13 @@ _m_tp_dev tp_dev=
 u8 CMD_RDX=0XD0;
 u8 CMD_RDY=0X90;
  	 			    					   
+//λ IO Ҫڣٲһչ ADS7846 DCLK /͵ƽ >200ns
+// delay_usҪ SysTickжѭܵ delay_ms
+static void TP_Dly(void)
+{
+	volatile u8 i=3;
+	while(i--);
+}
 //SPIд
 //ICд1byte    
 //num:Ҫд
@@ -43,8 +50,9 @@ void TP_Write_Byte(u8 num)
 		else TDIN=0;   
 		num<<=1;    
 		TCLK=0; 
-		delay_us(1);
+		TP_Dly();
 		TCLK=1;		//Ч	        
+		TP_Dly();
 	}		 			    
 } 		 
 //SPI 
@@ -59,50 +67,44 @@ u16 TP_Read_AD(u8 CMD)
 	TDIN=0; 	//
 	TCS=0; 		//ѡдIC
 	TP_Write_Byte(CMD);//
-	delay_us(6);//ADS7846תʱΪ6us
+	//ת DCLK ߣ 3 ʱӾǲʱ䣬ٵ 6us
 	TCLK=0; 	     	    
-	delay_us(1);    	   
+	TP_Dly();
 	TCLK=1;		//1ʱӣBUSY
-	delay_us(1);    
+	TP_Dly();
 	TCLK=0; 	     	    
 	for(count=0;count<16;count++)//16λ,ֻи12λЧ 
 	{ 				  
 		Num<<=1; 	 
 		TCLK=0;	//½Ч  	    	   
-		delay_us(1);    
+		TP_Dly();
  		TCLK=1;
  		if(DOUT)Num++; 		 
+		TP_Dly();
 	}  	
 	Num>>=4;   	//ֻи12λЧ.
 	TCS=1;		//ͷƬѡ	 
 	return(Num);   
 }
+// ȽϽ
+#define TP_CSWAP(a,b) if(buf[a]>buf[b]){temp=buf[a];buf[a]=buf[b];buf[b]=temp;}
 //ȡһֵ(xy)
-//ȡREAD_TIMES,Щ,
+//ȡREAD_TIMES, 5  (9 αȽϣ̶֧) ,
 //ȻȥͺLOST_VAL,ȡƽֵ 
 //xy:ָCMD_RDX/CMD_RDY
 //ֵ:
-#define READ_TIMES 5 	//ȡ
+#define READ_TIMES 5 	//ȡ (簴 5 д)
 #define LOST_VAL 1	  	//ֵ
 u16 TP_Read_XOY(u8 xy)
 {
-	u16 i, j;
+	u16 i;
 	u16 buf[READ_TIMES];
 	u16 sum=0;
 	u16 temp;
 	for(i=0;i<READ_TIMES;i++)buf[i]=TP_Read_AD(xy);		 		    
-	for(i=0;i<READ_TIMES-1; i++)//
-	{
-		for(j=i+1;j<READ_TIMES;j++)
-		{
-			if(buf[i]>buf[j])//
-			{
-				temp=buf[i];
-				buf[i]=buf[j];
-				buf[j]=temp;
-			}
-		}
-	}	  
+	TP_CSWAP(0,1);TP_CSWAP(3,4);TP_CSWAP(2,4);	//
+	TP_CSWAP(2,3);TP_CSWAP(0,3);TP_CSWAP(0,2);
+	TP_CSWAP(1,4);TP_CSWAP(1,3);TP_CSWAP(1,2);
 	sum=0;
 	for(i=LOST_VAL;i<READ_TIMES-LOST_VAL;i++)sum+=buf[i];
 	temp=sum/(READ_TIMES-2*LOST_VAL);
@@ -181,6 +183,7 @@ void TP_Draw_Big_Point(u16 x,u16 y,u16 color)
 //0,޴;1,д
 u8 TP_Scan(u8 tp)
 {			   
+	if(Tp_Irq_On)return tp_dev.sta&TP_PRES_DOWN;//жϲУ AD״̬ TP_Get_Event ȡ¼ʱ
 	if(PEN==0)//а
 	{
 		if(tp)TP_Read_XY2(&tp_dev.x[0],&tp_dev.y[0]);//ȡ
@@ -280,6 +283,8 @@ void TP_Adjust(void)
 	u32 tem1,tem2;
 	double fac; 	
 	u16 outtime=0;
+	u8 irq=Tp_Irq_On;
+	TP_Irq_Stop();//У׼ҪԼѯ꣬ͣжϲ
  	cnt=0;				
 	POINT_COLOR=BLUE;
 	BACK_COLOR =WHITE;
@@ -410,6 +415,7 @@ void TP_Adjust(void)
 					delay_ms(1000);
 					TP_Save_Adjdata();  
  					LCD_Clear(WHITE);//   
+					if(irq)TP_Irq_Init();
 					return;//У				 
 			}
 		}
@@ -418,6 +424,7 @@ void TP_Adjust(void)
 		if(outtime>1000)
 		{
 			TP_Get_Adjdata();
+			if(irq)TP_Irq_Init();
 			break;
 	 	} 
  	}
@@ -482,16 +489,171 @@ u8 TP_Init(void)
 	 
 			TP_Read_XY(&tp_dev.x[0],&tp_dev.y[0]);//һζȡʼ	 
 			AT24CXX_Init();			//ʼ24CXX
-			if(TP_Get_Adjdata())return 0;//ѾУ׼
+			if(TP_Get_Adjdata())//ѾУ׼
+			{
+				TP_Irq_Init();		//PEN жϻ + TIM4 ʱ
+				return 0;
+			}
 			else			  		//δУ׼?
 			{ 										    
 				LCD_Clear(WHITE);	//
 				TP_Adjust();  		//ĻУ׼  
 			}			
 			TP_Get_Adjdata();	
+			TP_Irq_Init();
 		}
 	return 1; 									 
 }
+//////////////////////////////////////////////////////////////////////////////////
+// жϲ
+//PEN ½(EXTI10) ѣ EXTI10 TIM4ÿ TP_SAMPLE_MS һ X/Y
+//̧ʺ  TIM4 ٿ EXTI10û˰ʱ жҲ ADѭ rtp_test ֻһ۶С
+//AD תʱ оƬ PENIRQԲڼ EXTI10 һֱţ̧ TIM4  PEN Ϊ׼
+//¼: β ERR_RANGE ڲ㰴(ȥ)֮ƶ TP_MOVE_MIN زŷ MOVE
+static TP_Event Tp_Evq[TP_EVQ_LEN];
+static volatile u8 Tp_Ev_Head=0,Tp_Ev_Tail=0;
+u32 Tp_Ev_Lost=0;					// /ϲ¼
+u8  Tp_Irq_On=0;					//1:жϲѿ
+
+static u8  Tp_Stage=0;				//0:û 1:ȵڶβȷ 2:
+static u16 Tp_Raw_X,Tp_Raw_Y;		//һε
+static u16 Tp_Last_X,Tp_Last_Y;		//һηȥĻ
+static u8  Tp_Ev_Skip=0;				//1:һʵ PRESS ûŽȥMOVE/RELEASE Ҳ
+
+//ж¼PRESS  RELEASE ǳɶԣ
+//	PRESS Ҫ 2 λ (һ RELEASE) һ ʲ
+//	MOVE ҲҪ RELEASE һλ ͸ǵ βͬһʵ MOVEβ PRESS Ͷ
+//ֵ:1,Žȥ(ǵ);0,
+static u8 TP_Ev_Push(u8 type,u16 x,u16 y)
+{
+	u8 used=(Tp_Ev_Head+TP_EVQ_LEN-Tp_Ev_Tail)%TP_EVQ_LEN;
+	u8 last=(Tp_Ev_Head+TP_EVQ_LEN-1)%TP_EVQ_LEN;
+	TP_Event *ev=&Tp_Evq[Tp_Ev_Head];
+	u8 next=(Tp_Ev_Head+1)%TP_EVQ_LEN;
+	if(type==TP_EV_PRESS)Tp_Ev_Skip=used>TP_EVQ_LEN-3;
+	if(Tp_Ev_Skip)
+	{
+		Tp_Ev_Lost++;
+		return 0;
+	}
+	if(type==TP_EV_MOVE&&used>TP_EVQ_LEN-3)
+	{
+		Tp_Ev_Lost++;
+		if(Tp_Evq[last].type!=TP_EV_MOVE)return 0;
+		ev=&Tp_Evq[last];			//п β Tailѭ ڶ
+		next=Tp_Ev_Head;
+	}
+	ev->type=type;
+	ev->x=x;
+	ev->y=y;
+	Tp_Ev_Head=next;
+	return 1;
+}
+
+//ȡһ¼ͬʱ tp_dev.x[0]/y[0]/sta (do_touch_function ǿ)
+//ֵ:1,ȡ;0,п
+u8 TP_Get_Event(TP_Event *ev)
+{
+	if(Tp_Ev_Tail==Tp_Ev_Head)return 0;
+	*ev=Tp_Evq[Tp_Ev_Tail];
+	Tp_Ev_Tail=(Tp_Ev_Tail+1)%TP_EVQ_LEN;
+	tp_dev.x[0]=ev->x;
+	tp_dev.y[0]=ev->y;
+	if(ev->type==TP_EV_PRESS)
+	{
+		tp_dev.sta=TP_PRES_DOWN|TP_CATH_PRES;
+		tp_dev.x[4]=ev->x;//¼һΰʱ
+		tp_dev.y[4]=ev->y;
+	}
+	else if(ev->type==TP_EV_RELEASE)tp_dev.sta&=~TP_PRES_DOWN;
+	return 1;
+}
+
+//жϲ (У׼Ѿ)
+void TP_Irq_Init(void)
+{
+	RCC->APB1ENR|=1<<2;				//TIM4ʱʹ
+	TIM4->CR1=0;
+	TIM4->ARR=TP_SAMPLE_MS*10-1;	//
+	TIM4->PSC=7199;					//72M/7200=10KHz
+	TIM4->EGR=1;					//װ PSC
+	TIM4->SR=0;
+	TIM4->DIER|=1<<0;				//ж
+	MY_NVIC_Init(3,1,TIM4_IRQn,2);	//ռһβ ~150us  NRF
+	Tp_Stage=0;
+	Tp_Ev_Head=Tp_Ev_Tail=0;
+	Tp_Irq_On=1;
+	EXTI->PR=1<<10;
+	Ex_NVIC_Config(GPIO_F,10,FTIR);	//PF10 ½
+	MY_NVIC_Init(3,0,EXTI15_10_IRQn,2);
+	if(PEN==0)EXTI->SWIER|=1<<10;	//ʱѾţһ
+}
+
+//ͣжϲص TP_Scan ѯ
+void TP_Irq_Stop(void)
+{
+	EXTI->IMR&=~(1<<10);
+	TIM4->CR1&=~0x01;
+	TIM4->SR=0;
+	Tp_Irq_On=0;
+	tp_dev.sta=0;
+}
+
+//PEN 
+void EXTI15_10_IRQHandler(void)
+{
+	if(EXTI->PR&(1<<10))
+	{
+		EXTI->PR=1<<10;
+		EXTI->IMR&=~(1<<10);		//ڼ䲻 PENIRQ
+		Tp_Stage=0;
+		TIM4->CNT=0;				//һβ TP_SAMPLE_MS Ժ˳ȥ
+		TIM4->SR=0;
+		TIM4->CR1|=0x01;
+	}
+}
+
+//ʱ
+void TIM4_IRQHandler(void)
+{
+	u16 x,y,sx,sy;
+	if((TIM4->SR&0X0001)==0)return;
+	TIM4->SR&=~(1<<0);
+	if(PEN)							//̧ʣͣһ PEN ж
+	{
+		TIM4->CR1&=~0x01;
+		if(Tp_Stage==2)TP_Ev_Push(TP_EV_RELEASE,Tp_Last_X,Tp_Last_Y);
+		Tp_Stage=0;
+		EXTI->PR=1<<10;
+		EXTI->IMR|=1<<10;
+		return;
+	}
+	TP_Read_XY(&x,&y);
+	if(PEN)return;					//ʱ̧ˣβ㣬´ν RELEASE
+	if(Tp_Stage==0||my_abs(x,Tp_Raw_X)>=ERR_RANGE||my_abs(y,Tp_Raw_Y)>=ERR_RANGE)
+	{
+		Tp_Raw_X=x;					//һ  ϴβ̫(/)µһ
+		Tp_Raw_Y=y;
+		if(Tp_Stage==0)Tp_Stage=1;
+		return;
+	}
+	sx=tp_dev.xfac*((x+Tp_Raw_X)/2)+tp_dev.xoff;//ǰƽ תΪĻ
+	sy=tp_dev.yfac*((y+Tp_Raw_Y)/2)+tp_dev.yoff;
+	Tp_Raw_X=x;
+	Tp_Raw_Y=y;
+	if(Tp_Stage==1)
+	{
+		Tp_Stage=2;
+		TP_Ev_Push(TP_EV_PRESS,sx,sy);
+	}
+	else if(my_abs(sx,Tp_Last_X)>=TP_MOVE_MIN||my_abs(sy,Tp_Last_Y)>=TP_MOVE_MIN)
+	{
+		if(!TP_Ev_Push(TP_EV_MOVE,sx,sy))return;	//ˣ 󷢳ȥĵ ȣRELEASE Ҳ
+	}
+	else return;
+	Tp_Last_X=sx;
+	Tp_Last_Y=sy;
+}
 
 
 
@@ -513,6 +675,15 @@ const u16 POINT_COLOR_TBL[CT_MAX_TOUCH]={RED,GREEN,BLUE,BROWN,GRED};   //5
 ////////////////////////////////////////////////////////////////////////////////
 void rtp_test(void)//败Ժ
 {
+	TP_Event ev;
+	if(Tp_Irq_On)					//жϲпվֱӷ
+	{
+		while(TP_Get_Event(&ev))
+		{
+			if(ev.type!=TP_EV_RELEASE)do_touch_function();///ƶ ǰסʱһ
+		}
+		return;
+	}
 	tp_dev.scan(0); //ɨ败.      0,Ļɨ;1,;	 		 
 	if(tp_dev.sta&TP_PRES_DOWN)//  
 	{	
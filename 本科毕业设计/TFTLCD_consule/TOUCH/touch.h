@@ -75,6 +75,28 @@ void TP_Save_Adjdata(void);						//
 u8 TP_Get_Adjdata(void);						//ȡУ׼
 void TP_Adjust(void);							//У׼
 void TP_Adj_Info_Show(u16 x0,u16 y0,u16 x1,u16 y1,u16 x2,u16 y2,u16 x3,u16 y3,u16 fac);//ʾУ׼Ϣ
+
+// жϲ (PEN ½ػѣTIM4 ʱ̧ʾͣ)
+#define TP_SAMPLE_MS	10				//ڼ 
+#define TP_MOVE_MIN		2				//Ļ仯 >= ôزŷ MOVE
+#define TP_EVQ_LEN		16				//¼г
+
+#define TP_EV_PRESS		1				//
+#define TP_EV_MOVE		2				//ƶ
+#define TP_EV_RELEASE	3				//ɿ (һε)
+
+typedef struct{
+				u8  type;				//TP_EV_xxx
+				u16 x;					//Ļ
+				u16 y;
+				}TP_Event;
+
+extern u8  Tp_Irq_On;					//1:жϲѿTP_Scan ٶ AD
+extern u32 Tp_Ev_Lost;					// /ϲ¼
+
+void TP_Irq_Init(void);					//жϲ (TP_Init У׼)
+void TP_Irq_Stop(void);					//ͣжϲ
+u8 TP_Get_Event(TP_Event *ev);			//ȡһ¼ 1:ȡ 0:
 /// ú
 u8 TP_Scan(u8 tp);								//ɨ
 u8 TP_Init(void);								//ʼ
@@ -8,7 +8,6 @@ int main(void)
 {                  
 	u8 i=0;
 	u8 tt_buf[7][4]={0};   
-	u8 ti_n5um=0;
 	u16 ti_num=0;
 	Stm32_Clock_Init(9); //ϵͳʱ 
 	JTAG_Set(SWD_ENABLE);
@@ -23,6 +22,9 @@ int main(void)
  	tp_dev.init();//
 #endif
  	LED_Init(); //LED˿ڳʼ LED1,LED2	
+	W25QXX_Init();				//Դ W25Q ûհʱ Asset_Draw  1滹ڲ FLASH ͼƬ
+	Asset_Init();
+	Kvs_Init();					//ֵ/־ ϵɨ
 #if  1
 	NRF24L01_Init();    		//ʼNRF24L01 
 	while(NRF24L01_Check())
@@ -36,7 +38,7 @@ int main(void)
 		NRF_Check=1;
 	}
 	else NRF_Check=2;
-	NRF24L01_RX_Mode();//RXģʽ  
+	NRF_Link_Init(1);//շһֱLED  ACK ȥ
 	ti_num=25;
 	while(ti_num--)
 	{
@@ -47,7 +49,6 @@ int main(void)
 #endif
 	LED2=1;
 	LED1=1;
-	TX_RX=1;//RXģʽ
 #if  ooioio
 	display_main(); 
 	POINT_COLOR=MAGENTA;// ɫ
@@ -75,24 +76,7 @@ int main(void)
 				NRF_Check=2;	
 			}
 		}
-		if(TX_RX==1)//RXģʽ  
-		{
-			NRF24L01_RX_Mode();//RXģʽ  
-			TX_RX=3;
-		}		    		    				 
-		if(TX_RX==2)//TXģʽ  
-		{
-			NRF24L01_TX_Mode();//TXģʽ  
-			TX_RX=4;			
-		}	
-		if(TX_RX==3)	   //RXģʽ
-		{
-			RX_();//RXģʽ  
-		}
-		if(TX_RX==4)      //TXģʽ  
-		{
-			TX_();//TXģʽ
-		}
+		RX_();//ȡжյİ
 		rtp_test();//	
 		if( ti_num%10000==0 && flag_func==2 )display_sensor_data();
 		if( ti_num%20000==0 && (flag_func==1||flag_func==2) ) NRF_check(); 
@@ -103,24 +87,16 @@ int main(void)
 				LED1=!LED1;
 				display_led_data();
 				ledf=0;
-				TX_RX=2;//TXģʽ
+				TX_();//LED Ž ACK
 			}
 		}
 		if( bnb[0]==1 && bnb[1]==1 )
 		{		
-			if(ti_n5um==0)
-			{
-				ti_n5um=1;
-				NRF_01(0);//  1:RXģʽ      ;    0:TXģʽ  
-			}
-			if( NRF24L01_TxPacket("-")==TX_OK )
+			if( NRF_Link_Send((const u8*)"-",1)==0 )//صŽ ACK
 			{
-				ti_n5um=0;
 				bnb[0]=0;
 				bnb[1]=0;
-				TX_RX=1;//RXģʽ
 				LED1=1;
-				NRF_01(1);//  1:RXģʽ      ;    0:TXģʽ  
 				switch(flag_func)
 				{
 					case 1:display_main();
@@ -133,11 +109,7 @@ int main(void)
 			}
 			else {}	
 		}
-		if( nrf_d==1 )
-		{
-			nrf_d=0;
-			TX_RX=1;//RXģʽ
-		}
+		Kvs_Poll();//FLASH ̨
 #else 
 		delay_ms(100);		
 #endif
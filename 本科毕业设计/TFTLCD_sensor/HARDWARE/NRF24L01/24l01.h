@@ -49,6 +49,12 @@
 #define RX_PW_P5        0x16  //ͨ5Чݿ(1~32ֽ),Ϊ0Ƿ
 #define NRF_FIFO_STATUS 0x17  //FIFO״̬Ĵ;bit0,RX FIFOĴձ־;bit1,RX FIFO־;bit2,3,
                               //bit4,TX FIFOձ־;bit5,TX FIFO־;bit6,1,ѭһݰ.0,ѭ;
+#define DYNPD           0x1C  //̬ݿ,bit0~5,Ӧͨ0~5 (Ҫ FEATURE bit2)
+#define FEATURE         0x1D  //bit2:̬ݿ;bit1:ACK;bit0:W_TX_PAYLOAD_NOACK
+#define R_RX_PL_WID     0x60  //RX FIFO ǰһĿ
+#define W_ACK_PAYLOAD   0xA8  //дACK,3λΪͨ (շ)
+#define ACTIVATE        0x50  //0x73  R_RX_PL_WID/W_ACK_PAYLOAD/FEATURE (+оƬҪ)
+#define TX_FULL         0x01  //STATUS:TX FIFO
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
 //24L01
 #define NRF24L01_CE   PGout(8) //24L01Ƭѡź
@@ -71,6 +77,43 @@ u8 NRF24L01_Write_Reg(u8 reg, u8 value);		//д
 u8 NRF24L01_Check(void);						//24L01Ƿ
 u8 NRF24L01_TxPacket(u8 *txbuf);				//һ
 u8 NRF24L01_RxPacket(u8 *rxbuf);				//һ
+
+/* жշ (·)
+	IRQ(PG6)  EXTI6 ½أж STATUSյİ նУİ ӷͶȥ
+	ٰѷͶİ оƬ TX FIFO ( 2 һڷ һ)Ͱ֮䲻õѭ
+	 SPI2 DMA(DMA1 ͨ4/5) ᣬ DMA жĴдǲѯʽ
+	Ĵ(ַ/ͨ/ط)ֻ NRF_Link_Init дһΣģʽֻ CONFIG  CE
+	̬ + ACK ݣ
+		ͷ(PTX) NRF_Link_Send İ ȥշص ACK   NRF_Link_Recv 
+		շ(PRX) NRF_Link_Send İ Ž ACK Է´ηʱ ˳ȥлշģʽ
+	SPI2  W25QXX ãѭ (SPI2_Lock) ʱ жȲߣSPI2_Unlock 
+
+	ʹã
+	NRF24L01_Init();
+	if(NRF24L01_Check()==0)NRF_Link_Init(0);	//0:ͷ 1:շ
+	NRF_Link_Send(buf,28);						//Ž Ϸأ0:ɹ 1:
+	while(NRF_Link_Recv(buf,&len)==0){...}		//յİ/ACK ص
+	NRF_Link_Stat.tx_lost ...					//ͳ
+*/
+#define NRF_LINK_TXQ		8			//Ͷ 
+#define NRF_LINK_RXQ		8			//ն 
+
+typedef struct{
+				u32 tx_ok;				//ȥյ ACK İ (շ:ͳȥ ACK )
+				u32 tx_lost;			//ط İ
+				u32 retrans;			//ط
+				u32 rx_ok;				//յİ (ͷ:ACK ص)
+				u32 rx_drop;			//ն İ
+				}NRF_Link_Stat_t;
+
+extern NRF_Link_Stat_t NRF_Link_Stat;
+
+void NRF_Link_Init(u8 prx);						//дȫĴ ж 0:ͷ 1:շ
+void NRF_Link_Mode(u8 prx);						//ģʽ (ֻ CONFIG/CE)
+u8   NRF_Link_Send(const u8 *buf,u8 len);		//ŽͶ 0:ɹ 1:/len 
+u8   NRF_Link_Recv(u8 *buf,u8 *len);			//ӽնȡһ (buf  32 ֽ) 0:ȡ 1:
+u8   NRF_Link_Tx_Free(void);					//Ͷ ܷż
+
 #endif
 
 
@@ -9,22 +9,23 @@
 #include "lcd.h"
 #include "myiic.h"
 #include "SHT2X.h"
+#include "telem.h"
 
 #define ooioio   0  
 
-void str_char_p(int ssdata,u8 *p,u8 i);
 void RX_(void);
 void TX_(void);
 u16 my_abs(u16 x1,u16 x2);//ֵ|x1-x2|
 void NRF_01(u8 num_nrf); //  1:RXģʽ      ;    0:TXģʽ  
+void Tick_Init(void);
+u32 Tick_Ms(void);
 
-static u8 flag_led_p=0;
-u8 TX_RX=0,tmp_buf[20];
+u8 TX_RX=0,tmp_buf[32];
+static Telem_Enc Tx_Enc;//ƴһ 3 
 /*------------------------------------------------------*/
 int main(void)
 {	 
 	u8 i=0;
-	u8 tt=0;
 	SystemInit();//ϵͳʱӳʼ 
 //	Stm32_Clock_Init(9);//ϵͳʱ 
 	JTAG_Set(SWD_ENABLE);
@@ -42,42 +43,22 @@ int main(void)
 		delay_ms(100);
 		if(TX_RX>=50)break;
 	}
+	NRF_Link_Init(0);//ͷһֱ̨ LED  ACK 
+	Telem_Enc_Init(&Tx_Enc,TELEM_MAP_NODE,3);
+	Tick_Init();
 #endif
 	SHT2X_Init();/*ʪ,¶*/	
 	ADC1_Init();
 	LED1=1;
 	LED2=1;
-	TX_RX=2;//TXģʽ
 	while(1)
 	{
-		tt++;
-		if(tt>=253 && flag_led_p==0)
-		{
-			flag_led_p=1;
-			TX_RX=2;//TXģʽ  
-		}
-		else if( flag_led_p==1)
-			{
-				flag_led_p=0;
-				TX_RX=1;//RXģʽ  
-			}
 #if  ooioio
 		TX_();
 #else
-		if(TX_RX==1)//RXģʽ  
+		if(NRF_Link_Tx_Free())//п Ųһ
 		{
-			NRF24L01_RX_Mode();//RXģʽ  
-			TX_RX=3;
-		}		    		    				 
-		if(TX_RX==2)//TXģʽ  
-		{
-			NRF24L01_TX_Mode();//TXģʽ  
-			TX_RX=4;			
-		}	
-		if(TX_RX==3)RX_();//RXģʽ
-		if(TX_RX==4)      //TXģʽ  
-		{
-			TX_();//TXģʽ
+			TX_();//ŽͶУж﷢
 			i++;
 			if(i>30) i=0;	
 			if(i<5)
@@ -86,15 +67,18 @@ int main(void)
 			}
 			else LED2=1;	
 		}
+		RX_();//ACK  LED 
 #endif
 	}
 }
 /************** TXģʽ *****************/
 int ADC_value[7]={1111,2222,3333,4444,0000,0000,0000};		
-u8 tx_buf[4*7]="1999299939994999599969997999";  
+u8 tx_buf[32];  
 void TX_(void)  
 {
 	u8 j=0;
+	s16 val[TELEM_CH_MAX]={0};
+	u32 ms;
  	u16 temperture=0;
     ADC_value[0]  = ADC_ConvertedValue[0]/4096.0*1000.0;//MQ135   10-1000ppm 
     ADC_value[1]  = ADC_ConvertedValue[1]/4096.0*10000.0;//MQ2 ȼ 100~10000ppm
@@ -109,12 +93,14 @@ void TX_(void)
 	SHT2x_Calc_RH();   /*ʪȲ*/ // float humidityRH  		%
 	ADC_value[6]=humidityRH*100;
 #if !ooioio
-	for(j=0;j<7;j++)
+	ms=Tick_Ms();
+	for(j=0;j<7;j++)val[j]=ADC_value[j];	//ADC_value ˳  TELEM_CH_MQ135~TELEM_CH_SHT_RH
+	if(Telem_Enc_Add(&Tx_Enc,ms,val))		//ֵ̫/Ȱ
 	{
-		str_char_p(ADC_value[j],tx_buf,j);
+		NRF_Link_Send(tx_buf,Telem_Enc_Flush(&Tx_Enc,tx_buf));
+		Telem_Enc_Add(&Tx_Enc,ms,val);
 	}
-	if( NRF24L01_TxPacket( tx_buf )==TX_OK ){}
-	else {}
+	if(Telem_Enc_Full(&Tx_Enc))NRF_Link_Send(tx_buf,Telem_Enc_Flush(&Tx_Enc,tx_buf));
 #endif
 #if  ooioio
 		for(j=0;j<7;j++)printf("%d:%d  ",j,ADC_value[j]);//  ppm
@@ -123,23 +109,34 @@ void TX_(void)
 #endif
 }
 /*---------------------------------------------*/
-void str_char_p(int ssdata,u8 *p,u8 j)
+//ʱTIM2 ɼ 2KHzж
+void Tick_Init(void)
+{
+	RCC->APB1ENR|=1<<0;	//TIM2ʱʹ    
+ 	TIM2->ARR=0XFFFF;  	//
+	TIM2->PSC=35999;  	//72M/36000=2KHz
+	TIM2->EGR=1;		//װ PSC
+	TIM2->CR1|=0x01;    //ʹܶʱ2
+}
+//ms32.7 ٵһ (ÿ)
+u32 Tick_Ms(void)
 {
-	u8 i=4*j;
-	p[i]=  (u8)(ssdata/1000%10+0x30);
-	p[i+1]=(u8)(ssdata/100%10+0x30);
-	p[i+2]=(u8)(ssdata/10%10+0x30);
-	p[i+3]=(u8)(ssdata%10+0x30);
+	static u16 last=0;
+	static u32 acc=0;
+	u16 cnt=TIM2->CNT;
+	acc+=(u16)(cnt-last);
+	last=cnt;
+	return acc/2;
 }
 /************** RXģʽ *****************/
 void RX_(void)  
 {
-	if( NRF24L01_RxPacket(tmp_buf)==0)//һյϢ,ʾ.
+	u8 len;
+	while( NRF_Link_Recv(tmp_buf,&len)==0 )//һյϢ,ʾ.
 	{
 		if(tmp_buf[0]=='+')LED1=0;
 		else LED1=1;
 	}
-	else {}
 }
 #if  ooioio
 //֮ľֵ 
@@ -0,0 +1,155 @@
+#include "ctrl_loop.h"
+#include "usart.h"
+/*̶ ѭ (TIM2 Ƚ ʱ)˵ ctrl_loop.h */
+
+volatile Ctrl_Stat ctrl_stat;
+
+static void (*ctrl_loop)(void)=0;
+static u16 ctrl_period=CTRL_PERIOD_US;
+static u16 ctrl_last=0;			//һνжϵʱ
+static u8  ctrl_started=0;		//Ѿһж (ڴӵڶ)
+static u16 ctrl_mark=0;			//һʱ
+
+//TIM2  us (16λƣʱֱǼ)
+u16 Ctrl_Now(void)
+{
+	return TIM2->CNT;
+}
+
+//׶ν㣺¼ һ  ĺʱ
+void Ctrl_Stage(u8 stage)
+{
+	u16 now=TIM2->CNT;
+	u16 d=now-ctrl_mark;
+	ctrl_mark=now;
+	if(stage>=CTRL_STAGE_NUM)return;
+	ctrl_stat.stage_last[stage]=d;
+	if(d>ctrl_stat.stage_max[stage])ctrl_stat.stage_max[stage]=d;
+}
+
+//period_us: us (<= 0x7FFF)
+//loop:ÿ  TIM2 жִһ
+void Ctrl_Init(u16 period_us,void (*loop)(void))
+{
+	TIM_TimeBaseInitTypeDef  TIM_TimeBaseStructure;
+	TIM_OCInitTypeDef  TIM_OCInitStructure;
+	NVIC_InitTypeDef NVIC_InitStructure;
+
+	ctrl_loop=loop;
+	ctrl_period=period_us;
+	ctrl_started=0;
+	Ctrl_Stat_Reset();
+
+	RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM2, ENABLE); //ʱʹ
+	TIM_DeInit(TIM2);//λʱ2мĴ
+
+	//TIM2 1MHz ɼж
+	TIM_TimeBaseStructure.TIM_Period = 0xFFFF; 					// 16 λʱ 16 λ
+	TIM_TimeBaseStructure.TIM_Prescaler =72-1; 					//72M/72=1MHz
+	TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1; 	//ʱӷָ:TDTS = Tck_tim
+	TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up; //TIMϼģʽ
+	TIM_TimeBaseStructure.TIM_RepetitionCounter = 0;
+	TIM_TimeBaseInit(TIM2, &TIM_TimeBaseStructure);
+
+	//CC1 ֻȽϲCCR1 Ԥװ (жЧ)
+	TIM_OCStructInit(&TIM_OCInitStructure);
+	TIM_OCInitStructure.TIM_OCMode = TIM_OCMode_Timing;
+	TIM_OCInitStructure.TIM_OutputState = TIM_OutputState_Disable;
+	TIM_OCInitStructure.TIM_Pulse = period_us;					//һֹʱ
+	TIM_OC1Init(TIM2, &TIM_OCInitStructure);
+	TIM_OC1PreloadConfig(TIM2, TIM_OCPreload_Disable);
+
+	//жȼNVICãڴڣprintf ͳʱ ճ
+	NVIC_InitStructure.NVIC_IRQChannel = TIM2_IRQn;  			//TIM2ж
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;  	//ռȼ1
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;  		//ȼ0
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE; 			//IRQͨʹ
+	NVIC_Init(&NVIC_InitStructure);  							//ʼNVICĴ
+
+	TIM_ClearFlag(TIM2, TIM_FLAG_CC1);
+	TIM_ITConfig(TIM2,TIM_IT_CC1,ENABLE ); 						//ֻ CC1 Ƚж
+	TIM_Cmd(TIM2, ENABLE);  									//ʹTIM2
+}
+
+//TIM2 CC1ֹʱ̣һȦ
+void TIM2_IRQHandler(void)
+{
+	u16 now,due,late,d,n;
+	if(TIM2->SR&TIM_SR_CC1IF)
+	{
+		TIM2->SR=(u16)~TIM_SR_CC1IF;
+		now=TIM2->CNT;
+		due=TIM2->CCR1;
+		late=now-due;
+		if(late>=ctrl_period)			//һȦ̫ ˽ֹʱ̣ĸӣŲ
+		{
+			n=late/ctrl_period;
+			due+=n*ctrl_period;
+			late-=n*ctrl_period;
+			ctrl_stat.overrun+=n;
+		}
+		TIM2->CCR1=due+ctrl_period;		//һֹʱ (ֹʱţۻ)
+
+		ctrl_stat.late_last=late;
+		if(late>ctrl_stat.late_max)ctrl_stat.late_max=late;
+		if(ctrl_started)
+		{
+			d=now-ctrl_last;
+			if(d<ctrl_stat.period_min)ctrl_stat.period_min=d;
+			if(d>ctrl_stat.period_max)ctrl_stat.period_max=d;
+		}
+		ctrl_last=now;
+		ctrl_started=1;
+
+		ctrl_mark=now;
+		if(ctrl_loop)ctrl_loop();
+		d=TIM2->CNT-now;
+		ctrl_stat.busy_last=d;
+		if(d>ctrl_stat.busy_max)ctrl_stat.busy_max=d;
+		ctrl_stat.cycles++;
+	}
+}
+
+//ȡһͳ (ʱ TIM2 жϣ´һ뱻)
+void Ctrl_Stat_Get(Ctrl_Stat *stat)
+{
+	NVIC_DisableIRQ(TIM2_IRQn);
+	*stat=*(Ctrl_Stat*)&ctrl_stat;
+	NVIC_EnableIRQ(TIM2_IRQn);
+}
+
+void Ctrl_Stat_Reset(void)
+{
+	u8 i;
+	NVIC_DisableIRQ(TIM2_IRQn);
+	ctrl_stat.cycles=0;
+	ctrl_stat.overrun=0;
+	ctrl_stat.period_min=0xFFFF;
+	ctrl_stat.period_max=0;
+	ctrl_stat.late_last=0;
+	ctrl_stat.late_max=0;
+	for(i=0;i<CTRL_STAGE_NUM;i++)
+	{
+		ctrl_stat.stage_last[i]=0;
+		ctrl_stat.stage_max[i]=0;
+	}
+	ctrl_stat.busy_last=0;
+	ctrl_stat.busy_max=0;
+	ctrl_started=0;					//ڴһж
+	NVIC_EnableIRQ(TIM2_IRQn);
+}
+
+//1 ӡͳ (ѭҪж)
+void Ctrl_Stat_Dump(void)
+{
+	Ctrl_Stat s;
+	static const char *name[CTRL_STAGE_NUM]={"PS2  ","MIX  ","MOTOR"};
+	u8 i;
+	Ctrl_Stat_Get(&s);
+	printf("ctrl: period=%dus cycles=%lu overrun=%lu\r\n",ctrl_period,(unsigned long)s.cycles,(unsigned long)s.overrun);
+	if(s.period_max)printf("  period min=%d max=%d jitter=%d us\r\n",s.period_min,s.period_max,s.period_max-s.period_min);
+	printf("  late   last=%d max=%d us\r\n",s.late_last,s.late_max);
+	for(i=0;i<CTRL_STAGE_NUM;i++)
+		printf("  %s last=%d max=%d us\r\n",name[i],s.stage_last[i],s.stage_max[i]);
+	printf("  busy   last=%d max=%d us\r\n",s.busy_last,s.busy_max);
+}
@@ -0,0 +1,58 @@
+#ifndef __CTRL_LOOP_H
+#define __CTRL_LOOP_H
+#include "sys.h"
+
+/*̶ ѭ (TIM2 Ƚ ʱ)
+  Ҫ FWLibļ "stm32f10x_tim.c"  "misc.c"
+
+  ԭѭ delay_us(100)  110 δ 11msټ delay_ms(4)   PS2 ʱ䣬
+  ʵ湤Ươ TIM2  1MHz ɼ (0~0xFFFF)CC1 ȽжϾǽֹʱ̣
+  ÿνж CCR1 +=  (ֹʱţжϵʱţۻ)
+  жִ ׶ (PS2 ֱ / speed_select  / Motor__Control)
+  ͬһʱ
+	     νжϵļ (С/)
+	ٵ     жʱ - ֹʱ (жӳ)
+	׶κʱ Ctrl_Stage() δ֮ (/)
+	ʱ     һȦѾһֹʱ̣һ 
+  ͳ ctrl_stat Ctrl_Stat_Dump() Ӵ1 ӡ
+
+  ʹã
+	Ctrl_Init(CTRL_PERIOD_US,Control_Loop);	//Control_Loop  TIM2 жִ
+	void Control_Loop(void)
+	{
+		...ֱ...	Ctrl_Stage(CTRL_STAGE_PS2);
+		......		Ctrl_Stage(CTRL_STAGE_MIX);
+		......		Ctrl_Stage(CTRL_STAGE_MOTOR);
+	}
+*/
+
+#define CTRL_PERIOD_US		11000	// us (<= 0x7FFF)
+
+#define CTRL_STAGE_PS2		0		//ֱ
+#define CTRL_STAGE_MIX		1		//speed_select 
+#define CTRL_STAGE_MOTOR	2		//Motor__Control 
+#define CTRL_STAGE_NUM		3
+
+typedef struct{
+				u32 cycles;						//ִȦ
+				u32 overrun;					//ʱĽֹʱ
+				u16 period_min;					//ʵ us
+				u16 period_max;
+				u16 late_last;					//жʱ - ֹʱ us
+				u16 late_max;
+				u16 stage_last[CTRL_STAGE_NUM];	//׶κʱ us
+				u16 stage_max[CTRL_STAGE_NUM];
+				u16 busy_last;					//һȦܺʱ us
+				u16 busy_max;
+				}Ctrl_Stat;
+
+extern volatile Ctrl_Stat ctrl_stat;
+
+void Ctrl_Init(u16 period_us,void (*loop)(void));	//TIM2 1MHz + CC1 ж ʼ
+u16  Ctrl_Now(void);					//TIM2  us (16λ)
+void Ctrl_Stage(u8 stage);				//׶ν (ֻ loop )
+void Ctrl_Stat_Get(Ctrl_Stat *stat);	//ȡһ һµ ͳ
+void Ctrl_Stat_Reset(void);				// С//
+void Ctrl_Stat_Dump(void);				//1 ӡͳ
+
+#endif
@@ -18,6 +18,18 @@ Description: Balance-STM32 TB6612FNG
 	         󣺴Ҳ࿴ʱ뷽ת  ת  
 ***********************************************************/
 
+//4 ãM1= M2= (ԭ Motor__Control תʱ CCR1 )ɲ
+//11ms һȦ ÿȦ 150/10240-> Լ 80msת->ٷת Լ 160ms
+static const Drive_Config Motor_Drive={
+	{{&M1_1,&M1_2,&TIM3->CCR1},{&M2_1,&M2_2,&TIM3->CCR2}},
+	MOTOR_PWM_MAX,			//pwm_max
+	0,						//pwm_min
+	0,						//deadband (speed_select Ѿȥ)
+	150,					//slew
+	0,						//thr_curve ֱ
+	Drive_Curve_Expo,		//str_curve С תϸ
+	1};						//brake
+
 //תźŶ˿ڳʼ
 //PC0~3
 //void M_Init(void)
@@ -62,6 +74,7 @@ void M_Init(void)
 	GPIO_ResetBits(GPIOA,GPIO_Pin_4);
 	GPIO_ResetBits(GPIOA,GPIO_Pin_5);
 //	GPIO_SetBits(GPIOA,GPIO_Pin_6);
+	Drive_Init(&Motor_Drive);	///CCR  (Ҫ TIM3_PWM_Init ֮)Ȼ
 }
 
 //ʱTIM3PWMƳʼ,CH1PA6CH2(PA7)
@@ -93,103 +106,11 @@ void TIM3_PWM_Init(u16 arr,u16 psc) //arr
 	TIM3->CR1|=0x01;    //ʹܶʱ3 
 }
 /**************        *****************      *****************          *****************/
-void Motor__Control(s16 speed  , s16 swerve/*ת*/)//speed:ǰ/   swerve:ת/ת 
+//speed:ǰ/   swerve:ת/תλ CCR (MOTOR_PWM_MAXspeed_select Ѿȥ)
+///б/  drive_mix.cת䲻 swerve*65/100 ֧ =ٶ+ת =ٶ-ת
+void Motor__Control(s16 speed  , s16 swerve/*ת*/)
 {
-//	printf("ֱ\r\n");
-	if( speed >= +1 )//ǰ 0~46
-	{
-		if( swerve >= +1 )//תswerve: 0~50
-		{
-			M1_1 = 1;
-			M1_2 = 0;	
-			TIM3->CCR1 = speed>swerve ? speed : swerve  ;		
-			M2_1 = 1;
-			M2_2 = 0;			
-			TIM3->CCR2 = speed>swerve ? speed-swerve/2 : swerve*65/100 ;//75-52/2=75-26=49= 65%
-		}
-		else if( swerve <= -1 )//תswerve: -50~0
-			{
-				swerve=-swerve;//ȡ
-				M1_1 = 1;
-				M1_2 = 0;	
-				TIM3->CCR1 = speed>swerve ? speed-swerve/2 : swerve*65/100 ;//75-52/2=75-26=49= 65%
-				M2_1 = 1;
-				M2_2 = 0;			
-				TIM3->CCR2 = speed>swerve ? speed : swerve  ;	
-			}
-			else //ǰspeed: 0~46  
-			{
-				M1_1 = 1;
-				M1_2 = 0;	
-				TIM3->CCR1 = speed ;	
-				M2_1 = 1;
-				M2_2 = 0;			
-				TIM3->CCR2 = speed;		
-			}
-	}
-	else if( speed <= -1 )//
-		{
-			speed=-speed;//ȡ
-			if( swerve >= +1 )//תswerve: 0~50
-			{
-				M1_1 = 0;
-				M1_2 = 1;	
-				TIM3->CCR1 = speed>swerve ? speed : swerve  ;	
-				M2_1 = 0;
-				M2_2 = 1;			
-				TIM3->CCR2 = speed>swerve ? speed-swerve/2 : swerve*65/100 ;//75-52/2=75-26=49= 65%
-			}
-			else if( swerve <= -1 )//תswerve: -50~0
-				{		
-					swerve=-swerve;//ȡ
-					M1_1 = 0;
-					M1_2 = 1;	
-					TIM3->CCR1 =  speed>swerve ? speed-swerve/2 : swerve*65/100 ;//75-52/2=75-26=49= 65%
-					M2_1 = 0;
-					M2_2 = 1;			
-					TIM3->CCR2 =  speed>swerve ? speed : swerve ;
-				}
-				else //speed: 0~46
-				{
-					M1_1 = 0;
-					M1_2 = 1;	
-					TIM3->CCR1 = speed ;	
-					M2_1 = 0;
-					M2_2 = 1;			
-					TIM3->CCR2 = speed;		
-				}
-		}
-		else //ԭشת--ȲǰҲ
-		{
-			if( swerve >= +1 )//ԭתswerve: 0~46
-			{
-				M1_1 = 1;
-				M1_2 = 0;	
-				TIM3->CCR1 = swerve;	
-				M2_1 = 0;
-				M2_2 = 1;			
-				TIM3->CCR2 = swerve;		
-			}
-			else if( swerve <= -1 )//ԭתswerve: -46~0
-				{
-					swerve=-swerve;//ȡ
-					M1_1 = 0;
-					M1_2 = 1;	
-					TIM3->CCR1 = swerve ;	
-					M2_1 = 1;
-					M2_2 = 0;			
-					TIM3->CCR2 = swerve;		
-				}
-				else
-				{
-					M1_1 = 1;
-					M1_2 = 1;
-					M2_1 = 1;
-					M2_2 = 1;
-					TIM3->CCR1 = 255;
-					TIM3->CCR2 = 255;
-				}
-		}	
+	Drive_Arcade((s32)speed*DRIVE_FULL/MOTOR_PWM_MAX,(s32)swerve*DRIVE_FULL/MOTOR_PWM_MAX);
 }
 
 #if 0
@@ -2,6 +2,7 @@
 #define __MOTOR_H
 #include "sys.h"
 #include "pstwo.h"
+#include "drive_mix.h"
 
 #define M1_1 PAout(0)
 #define M1_2 PAout(1)
@@ -13,6 +14,8 @@
 #define F_2  PAout(5)
 //#define F_COM  PAout(6)
 
+#define MOTOR_PWM_MAX	250	//TIM3 ռ (TIM3_PWM_Init(250-1,72-1))
+
 
 void M_Init(void);	   //תźŶ˿ڳʼ
 void TIM3_PWM_Init(u16 arr,u16 psc); //arr趨Զװֵ   
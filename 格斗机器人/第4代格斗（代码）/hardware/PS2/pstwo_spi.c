@@ -0,0 +1,286 @@
+#include "pstwo_spi.h"
+#include "delay.h"
+
+/*PS2ֱ ӲSPI2 + DMA 
+  ˵ pstwo_spi.h
+  һ֡ 01 42 00 M1 M2 00 00 00 00
+		ֱ FF ID 5A KEY_L KEY_H RX RY LX LY
+*/
+
+#define PS2_CS_H	PBout(12)=1		//CS
+#define PS2_CS_L	PBout(12)=0		//CS
+#define PS2_BYTE_US		48			//̨ѯ ÿֽڼ usһֽ 8 λԼ 28us + ֽڼ 16us (ͬ PS2_SPI_Packet)
+
+static u8 ps2_tx[PS2_FRAME_LEN]={0x01,0x42,0x00,0x00,0x00,0x00,0x00,0x00,0x00};	//DMA ͻ
+static u8 ps2_rx[PS2_FRAME_LEN];		//DMA ջ
+static volatile u8 ps2_busy=0;			//1: ڴ
+static u8 ps2_motor1=0,ps2_motor2=0;	//ֵ ´ѯʱд ps2_tx
+
+static PS2_State ps2_state;				//һ֡ (ֻжд)
+static volatile u32 ps2_wr=0;			//дʱǷжϸд
+static u32 ps2_rd=0;					//ϴζȡʱ ps2_wr
+static volatile u16 ps2_ev_pressed=0;	//ۼ ¼
+static volatile u16 ps2_ev_released=0;	//ۼ ɿ¼
+static PS2_SPI_Callback ps2_cb=0;
+
+/* ð ( pstwo.c еһ) */
+static const u8 ps2_short_poll[]  ={0x01,0x42,0x00,0x00,0x00};
+static const u8 ps2_enter_config[]={0x01,0x43,0x00,0x01,0x00,0x00,0x00,0x00,0x00};
+static const u8 ps2_analog_mode[] ={0x01,0x44,0x00,0x01,0xEE,0x00,0x00,0x00,0x00};	//0x01ģ 0xEE(ɰMODEл)
+static const u8 ps2_vibrate_mode[]={0x01,0x4D,0x00,0x00,0x01};
+static const u8 ps2_exit_config[] ={0x01,0x43,0x00,0x00,0x5A,0x5A,0x5A,0x5A,0x5A};
+
+//SPI2 + DMA1 ͨ4(RX)/ͨ5(TX) + TIM1 ʼ
+//  CS->PB12   CLK->PB13   DAT->PB14   CMD->PB15
+void PS2_SPI_Init(void)
+{
+	GPIO_InitTypeDef GPIO_InitStructure;
+	SPI_InitTypeDef  SPI_InitStructure;
+	DMA_InitTypeDef  DMA_InitStructure;
+	NVIC_InitTypeDef NVIC_InitStructure;
+	TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
+
+	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOB|RCC_APB2Periph_TIM1,ENABLE);
+	RCC_APB1PeriphClockCmd(RCC_APB1Periph_SPI2,ENABLE);
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1,ENABLE);
+
+	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_13|GPIO_Pin_15;		//SCK MOSI 
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;
+	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+	GPIO_Init(GPIOB,&GPIO_InitStructure);
+
+	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_14;					//MISO 
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IPU;
+	GPIO_Init(GPIOB,&GPIO_InitStructure);
+
+	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_12;					//CS 
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_PP;
+	GPIO_Init(GPIOB,&GPIO_InitStructure);
+	PS2_CS_H;
+
+	SPI_I2S_DeInit(SPI2);
+	SPI_InitStructure.SPI_Direction = SPI_Direction_2Lines_FullDuplex;
+	SPI_InitStructure.SPI_Mode = SPI_Mode_Master;
+	SPI_InitStructure.SPI_DataSize = SPI_DataSize_8b;
+	SPI_InitStructure.SPI_CPOL = SPI_CPOL_High;					//ʱӿΪ
+	SPI_InitStructure.SPI_CPHA = SPI_CPHA_2Edge;				//ز
+	SPI_InitStructure.SPI_NSS = SPI_NSS_Soft;
+	SPI_InitStructure.SPI_BaudRatePrescaler = PS2_SPI_PRESCALER;
+	SPI_InitStructure.SPI_FirstBit = SPI_FirstBit_LSB;			//PS2 Э λ
+	SPI_InitStructure.SPI_CRCPolynomial = 7;
+	SPI_Init(SPI2,&SPI_InitStructure);
+	SPI_Cmd(SPI2,ENABLE);
+
+	//DMA1 ͨ4: SPI2_RX  ->ڴ
+	DMA_DeInit(DMA1_Channel4);
+	DMA_InitStructure.DMA_PeripheralBaseAddr = (u32)&SPI2->DR;
+	DMA_InitStructure.DMA_MemoryBaseAddr = (u32)ps2_rx;
+	DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;
+	DMA_InitStructure.DMA_BufferSize = PS2_FRAME_LEN;
+	DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+	DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+	DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+	DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+	DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+	DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+	DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+	DMA_Init(DMA1_Channel4,&DMA_InitStructure);
+	DMA_ITConfig(DMA1_Channel4,DMA_IT_TC|DMA_IT_TE,ENABLE);
+
+	//DMA1 ͨ5: ڴ->SPI2_DR TIM1 ¼  ( SPI2  TXE )
+	//ÿ PS2_BYTE_US ֻдһֽڣֽ֮ ֱҪļ
+	DMA_DeInit(DMA1_Channel5);
+	DMA_InitStructure.DMA_MemoryBaseAddr = (u32)ps2_tx;
+	DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;
+	DMA_InitStructure.DMA_Priority = DMA_Priority_Medium;
+	DMA_Init(DMA1_Channel5,&DMA_InitStructure);
+
+	//TIM1: 1MHz PS2_BYTE_US һ (ѯʱſ)
+	TIM_DeInit(TIM1);
+	TIM_TimeBaseStructure.TIM_Period = PS2_BYTE_US-1;
+	TIM_TimeBaseStructure.TIM_Prescaler = 72-1;
+	TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+	TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
+	TIM_TimeBaseStructure.TIM_RepetitionCounter = 0;
+	TIM_TimeBaseInit(TIM1,&TIM_TimeBaseStructure);
+	TIM_DMACmd(TIM1,TIM_DMA_Update,ENABLE);
+
+	NVIC_InitStructure.NVIC_IRQChannel = DMA1_Channel4_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 2;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 2;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+
+	ps2_state.mode = 0;
+	ps2_state.rx = ps2_state.ry = ps2_state.lx = ps2_state.ly = 0x80;
+}
+
+//ʽ շһֽ
+static u8 PS2_SPI_RW(u8 cmd)
+{
+	while(SPI_I2S_GetFlagStatus(SPI2,SPI_I2S_FLAG_TXE)==RESET);
+	SPI_I2S_SendData(SPI2,cmd);
+	while(SPI_I2S_GetFlagStatus(SPI2,SPI_I2S_FLAG_RXNE)==RESET);
+	return (u8)SPI_I2S_ReceiveData(SPI2);
+}
+
+//ʽ һð (ֻڳʼʱãѯвҪ)
+static void PS2_SPI_Packet(const u8 *cmd, u8 len)
+{
+	u8 i;
+	while(ps2_busy);					//ȴ̨ѯ
+	PS2_CS_L;
+	delay_us(16);
+	for(i=0;i<len;i++)
+	{
+		PS2_SPI_RW(cmd[i]);
+		delay_us(16);
+	}
+	PS2_CS_H;
+	delay_us(16);
+}
+
+//ֱóʼ
+void PS2_SPI_SetInit(void)
+{
+	PS2_SPI_Packet(ps2_short_poll,sizeof(ps2_short_poll));
+	PS2_SPI_Packet(ps2_short_poll,sizeof(ps2_short_poll));
+	PS2_SPI_Packet(ps2_short_poll,sizeof(ps2_short_poll));
+	PS2_SPI_Packet(ps2_enter_config,sizeof(ps2_enter_config));	//ģʽ
+	PS2_SPI_Packet(ps2_analog_mode,sizeof(ps2_analog_mode));	//̵ơģʽ
+	PS2_SPI_Packet(ps2_vibrate_mode,sizeof(ps2_vibrate_mode));	//ģʽ
+	PS2_SPI_Packet(ps2_exit_config,sizeof(ps2_exit_config));	//ɲ
+}
+
+//һκ̨ѯ
+u8 PS2_SPI_Poll_Start(void)
+{
+	if(ps2_busy) return 1;
+	ps2_busy = 1;
+
+	ps2_tx[3] = ps2_motor1;
+	ps2_tx[4] = ps2_motor2;
+
+	DMA_Cmd(DMA1_Channel4,DISABLE);
+	DMA_Cmd(DMA1_Channel5,DISABLE);
+	DMA_SetCurrDataCounter(DMA1_Channel4,PS2_FRAME_LEN);
+	DMA_SetCurrDataCounter(DMA1_Channel5,PS2_FRAME_LEN);
+	DMA_ClearFlag(DMA1_FLAG_GL4|DMA1_FLAG_GL5);
+	(void)SPI_I2S_ReceiveData(SPI2);	// RXNE
+
+	DMA_Cmd(DMA1_Channel4,ENABLE);		//ȿ ٿ
+	DMA_Cmd(DMA1_Channel5,ENABLE);
+	SPI_I2S_DMACmd(SPI2,SPI_I2S_DMAReq_Rx,ENABLE);
+
+	PS2_CS_L;
+	TIM_SetCounter(TIM1,0);				//һֽ  CS  PS2_BYTE_US 󷢣 CS ׼ʱ
+	TIM_Cmd(TIM1,ENABLE);
+	return 0;
+}
+
+u8 PS2_SPI_IsBusy(void)
+{
+	return ps2_busy;
+}
+
+// ps2_rx¿պ¼ (же)
+static void PS2_SPI_Decode(void)
+{
+	u16 keys=0,old;
+	u8 valid;
+
+	valid = (ps2_rx[2]==0x5A);
+	if(valid)
+		keys = ~((ps2_rx[4]<<8)|ps2_rx[3]);	//Ϊ0 -> Ϊ1
+	//Ӧ𲻶(ֱϿ)ʱ ȫɿⰴڰ״̬
+
+	old = ps2_state.buttons;
+	ps2_state.pressed  = keys & ~old;
+	ps2_state.released = old & ~keys;
+	ps2_state.buttons  = keys;
+	ps2_state.valid = valid;
+	ps2_state.mode  = ps2_rx[1];
+	if(valid && ps2_rx[1]==PS2_ID_ANALOG_RED)
+	{
+		ps2_state.rx = ps2_rx[5];
+		ps2_state.ry = ps2_rx[6];
+		ps2_state.lx = ps2_rx[7];
+		ps2_state.ly = ps2_rx[8];
+	}
+	else								//̵ģʽ ûҡݣλ
+	{
+		ps2_state.rx = ps2_state.ry = ps2_state.lx = ps2_state.ly = 0x80;
+	}
+	ps2_state.seq++;
+
+	ps2_ev_pressed  |= ps2_state.pressed;
+	ps2_ev_released |= ps2_state.released;
+	ps2_wr++;
+}
+
+u8 PS2_SPI_Read(PS2_State *out)
+{
+	u32 wr;
+	do{
+		wr = ps2_wr;
+		*out = ps2_state;
+	}while(wr!=ps2_wr);					//ƹбжϸд¶
+	if(wr==ps2_rd) return 0;
+	ps2_rd = wr;
+	return 1;
+}
+
+u8 PS2_SPI_Key(const PS2_State *state)
+{
+	u8 index;
+	for(index=0;index<16;index++)
+	{
+		if(state->buttons & PS2_BTN(MASK[index]))
+			return index+1;
+	}
+	return 0;
+}
+
+void PS2_GetEvents(u16 *pressed, u16 *released)
+{
+	__disable_irq();
+	*pressed  = ps2_ev_pressed;
+	*released = ps2_ev_released;
+	ps2_ev_pressed  = 0;
+	ps2_ev_released = 0;
+	__enable_irq();
+}
+
+void PS2_SPI_SetVibration(u8 motor2, u8 motor1)
+{
+	ps2_motor1 = motor1;
+	ps2_motor2 = motor2;
+}
+
+void PS2_SPI_SetCallback(PS2_SPI_Callback cb)
+{
+	ps2_cb = cb;
+}
+
+//SPI2_RX DMA жϣ9 ֽ꣬֡
+void DMA1_Channel4_IRQHandler(void)
+{
+	u8 ok = 0;
+	if(DMA_GetITStatus(DMA1_IT_TC4)!=RESET) ok = 1;
+	else if(DMA_GetITStatus(DMA1_IT_TE4)==RESET) return;
+	DMA_ClearITPendingBit(DMA1_IT_GL4);
+
+	TIM_Cmd(TIM1,DISABLE);
+	while(SPI_I2S_GetFlagStatus(SPI2,SPI_I2S_FLAG_BSY)!=RESET);
+	PS2_CS_H;
+	SPI_I2S_DMACmd(SPI2,SPI_I2S_DMAReq_Rx,DISABLE);
+	DMA_Cmd(DMA1_Channel4,DISABLE);
+	DMA_Cmd(DMA1_Channel5,DISABLE);
+
+	if(ok)
+	{
+		PS2_SPI_Decode();
+		if(ps2_cb) ps2_cb(&ps2_state);
+	}
+	ps2_busy = 0;
+}
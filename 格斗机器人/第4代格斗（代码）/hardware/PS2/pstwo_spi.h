@@ -0,0 +1,71 @@
+#ifndef __PSTWO_SPI_H
+#define __PSTWO_SPI_H
+#include "sys.h"
+#include "pstwo.h"
+
+/*PS2ֱ ӲSPI2 + DMA  ()
+  Ҫ FWLibļ "stm32f10x_spi.c"  "stm32f10x_dma.c"  "stm32f10x_tim.c"  "misc.c"
+
+  ԭ pstwo.c ÿһλ delay_us תʱӣһ֡ 9 ֽԼ 7~8ms ȫռCPU
+   SPI2 LSBСCPOL=1 CPHA=1 (ʱӿΪߣڶزֱʱһ)
+  9 ֽ DMA1 ͨ5(TX)/ͨ4(RX) ں̨շж CS 롣
+  Ͳ SPI  TXE  ( 9 ֽŷеֱ) TIM1 ¼
+  ͨ5ÿ PS2_BYTE_US һֽڣֽ֮ļ ʽ delay_us(16) һ
+  TIM1 ռá
+
+   ( pstwo.h IOӷͬ谴 SPI2 ½)
+	ATT(CS) -> PB12  ͨ
+	CLK     -> PB13  SPI2_SCK
+	DAT     -> PB14  SPI2_MISO   (ֱ DAT Ϊ©)
+	CMD     -> PB15  SPI2_MOSI
+
+  ʹã
+	PS2_SPI_Init();
+	PS2_SPI_SetInit();				//ʽ ð (ֻϵʱ)
+	PS2_SPI_Poll_Start();			//ѭ/ʱ ڴ ( >=10ms һ)
+	if(PS2_SPI_Read(&ps2) && ps2.valid) {...}	//ȡһѯĽ (жҲԵ)
+	PS2_GetEvents(&pressed,&released);
+	if(pressed & PS2_BTN(PSB_L1)) {...}
+*/
+
+#define PS2_SPI_PRESCALER	SPI_BaudRatePrescaler_128	//36MHz/128 = 281KHz (ֱһ㲻 500KHz)
+#define PS2_FRAME_LEN		9		//һ֡ 9 ֽ
+#define PS2_ID_ANALOG_GREEN	0x41	//̵ () ģʽ
+#define PS2_ID_ANALOG_RED	0x73	// (ģ) ģʽ
+
+#define PS2_BTN(psb)		((u16)(1<<((psb)-1)))	//PSB_xxx  -> λͼеλ
+
+typedef struct{
+				u16 buttons;	//λͼ Ϊ1 (λ = PSB_xxx-1)
+				u16 pressed;	//֡ °µļ
+				u16 released;	//֡ ɿļ
+				u8  mode;		//0x41 ̵  0x73 
+				u8  rx,ry;		//ҡ 0~255 (λԼ 128)
+				u8  lx,ly;		//ҡ
+				u8  valid;		//1: ֡Ӧȷ (3ֽΪ 0x5A)
+				u32 seq;		//֡ (ÿɼ1)
+				}PS2_State;
+
+typedef void (*PS2_SPI_Callback)(const PS2_State *state);
+
+void PS2_SPI_Init(void);		//SPI2 + DMA1 ͨ4/5 + TIM1 + PB12(CS) ʼ
+void PS2_SPI_SetInit(void);		//ֱãģģʽ + ģʽ (Լ 2msҪже)
+/* һηѯ
+	0:  1:һ֡û */
+u8 PS2_SPI_Poll_Start(void);
+u8 PS2_SPI_IsBusy(void);		//1: ڴ
+/* ȡ һ֡ 
+	 1: ϴζȡ  0: û */
+u8 PS2_SPI_Read(PS2_State *out);
+/*  PS2_DataKey ֵͬ MASK ˳ һµļ PSB_xxxûа 0 */
+u8 PS2_SPI_Key(const PS2_State *state);
+/* ȡ ϴεۼƵ /ɿ ¼ ( PS2_DataKey ©ͬʱµļ) */
+void PS2_GetEvents(u16 *pressed, u16 *released);
+/* ãһѯЧ
+	motor1:ҲС𶯵 0x00أ
+	motor2:𶯵 0x40~0xFF ֵԽ Խ */
+void PS2_SPI_SetVibration(u8 motor2, u8 motor1);
+/*  ɻص ( DMA жִУҪ) */
+void PS2_SPI_SetCallback(PS2_SPI_Callback cb);
+
+#endif /* __PSTWO_SPI_H */
@@ -3,79 +3,104 @@
 #include "usart.h"		
 #include "delay.h"
 #include "led.h"	
-#include "pstwo.h"
+#include "pstwo_spi.h"
 #include "motor.h"
 #include "math.h"
 #include "stdlib.h"
 
+#include "ctrl_loop.h"
+
 #define speed_max 250
+#define PS2_LOST_TICKS	3	//Ȧûµһ֡ ֱϿ (ͣ)
 /*****************************************/
-u8 flag_red=0 , flywheel=0 , flag_delay1=0 ;   
+u8 flag_red=0 , flywheel=0 ;   
 s16 speed =0 , swerve/*ת*/=0 ;
+static PS2_State ps2;	//һȦ SPI ѯֱ
 
 /*****************************************/
 void speed_select(void);//õһҡ˵ģ  Χ0~256 
 void stop_fast(void);
 void stop_init(void); 
+void Control_Loop(void);//ÿ 11ms  TIM2 жִһ
 
 /*********         ***********      main        ***********             *********/
 int main(void)
 {
 	SystemInit();//ϵͳʱ
 	delay_init();	     //ʱʼ
+	NVIC_PriorityGroupConfig(NVIC_PriorityGroup_2);	//NVICжϷ2:2λռȼ2λӦȼ
 	uart_init(115200);  //1ʼ 
 /*  ж/  ʱ Tout us=   250 * 72 / 72 = 250 us  */
 	TIM3_PWM_Init(speed_max-1,72-1);
 	LED_Init();
-	PS2_Init();			 //˿ڳʼ
-	PS2_SetInit();		 //óʼ,á̵ģʽѡǷ޸ //ģʽ
+	PS2_SPI_Init();		 //SPI2 + DMA ֱ  CS->PB12 CLK->PB13 DAT->PB14 CMD->PB15 (߼ pstwo_spi.h)
+	PS2_SPI_SetInit();	 //óʼ,á̵ģʽѡǷ޸ //ģʽ (ֻϵʱ)
 	M_Init();	   //תźŶ˿ڳʼ	
     stop_init( );
+	Ctrl_Init(CTRL_PERIOD_US,Control_Loop);	//TIM2 ʱ 11ms һȦֱ ->  -> 
 	while(1)
 	{	
-		if(flag_delay1>=110)/*11ms*/
-		{	
-			flag_delay1=0;
-			if( PS2_RedLight() ==0 )//ֵ0-ģʽ
-			{			
-				delay_ms(4); /*4ms!!!!!*/ 
-				LED = 0;//жֱǷΪģʽǣָʾLED
-				flywheel = PS2_DataKey(); //ֱ 
-				speed_select();//õһҡ˵ģ  Χ0~256 				
-				Motor__Control(speed,swerve/*ת*/);//    //speed:ǰ/   swerve:ת/ת 
-				switch(flywheel)
-				{
-					case PSB_L1: F_1 = 0;F_2 = 1;break;
-					case PSB_L2: F_2 = 0;break;
-//					case PSB_L3: PS2_Vibration(0xbf,0x00);/*𶯺ʱdelay_ms(1000)*/;break;
-					case PSB_R1: F_2 = 0;F_1 = 1;break;
-					case PSB_R2: F_1 = 0;break;
-//					case PSB_R3: PS2_Vibration(0x00,0xbf);/*𶯺ʱdelay_ms(1000)*/;break;
-					default: break;
-				}
-			}
-			else	//жֱǺģʽ
-			{
-				LED = 1;
-				stop_init( );
-			}
+		//ȫ TIM2 жѭֻܴڣһ ӡͳƣ "r" ӡ
+		//(ֱ SPI2 + DMA ں̨TIM2 жﲻ ʱ  delay_us)
+		if(USART_RX_STA&0x8000)
+		{
+			Ctrl_Stat_Dump();
+			if(USART_RX_BUF[0]=='r')Ctrl_Stat_Reset();
+			USART_RX_STA=0;
 		}
-		if( speed==0 && swerve==0 )stop_fast();
-//		if(flywheel==PSB_PAD_UP||flywheel==PSB_PAD_RIGHT||flywheel==PSB_PAD_DOWN||flywheel==PSB_PAD_LEFT)
-//		{
-//			F_1 = 0;
-//			F_2 = 0;
-//		}
-		flag_delay1++;
-		delay_us(100);//ʱ
 	}	 
 }
 
+/**************        *****************  ѭ  *****************          *****************/
+void Control_Loop(void)
+{
+	static u8 miss=PS2_LOST_TICKS;
+	//ֱȡһȦ SPI/DMA ѯ ()һ֡жﲻȴ
+	if(PS2_SPI_Read(&ps2))miss=0;
+	else if(miss<PS2_LOST_TICKS)miss++;
+	PS2_SPI_Poll_Start();
+	flywheel = PS2_SPI_Key(&ps2); //ֱ 
+	Ctrl_Stage(CTRL_STAGE_PS2);
+	if( miss<PS2_LOST_TICKS && ps2.valid && ps2.mode == PS2_ID_ANALOG_RED )//0x73-ģʽ
+	{			
+		LED = 0;//жֱǷΪģʽǣָʾLED
+		speed_select();//õһҡ˵ģ  Χ0~256 				
+		Ctrl_Stage(CTRL_STAGE_MIX);
+		Motor__Control(speed,swerve/*ת*/);//    //speed:ǰ/   swerve:ת/ת 
+		switch(flywheel)
+		{
+			case PSB_L1: F_1 = 0;F_2 = 1;break;
+			case PSB_L2: F_2 = 0;break;
+//			case PSB_L3: PS2_Vibration(0xbf,0x00);/*𶯺ʱdelay_ms(1000)*/;break;
+			case PSB_R1: F_2 = 0;F_1 = 1;break;
+			case PSB_R2: F_1 = 0;break;
+//			case PSB_R3: PS2_Vibration(0x00,0xbf);/*𶯺ʱdelay_ms(1000)*/;break;
+			default: break;
+		}
+	}
+	else	//жֱǺģʽ
+	{
+		LED = 1;
+		Ctrl_Stage(CTRL_STAGE_MIX);
+		speed = 0;
+		swerve = 0;
+		F_2 = 0;
+		F_1 = 0;
+		stop_fast( );//ͣ + ɲ (ٵ stop_initÿ /ɲ )
+	}
+//	if(flywheel==PSB_PAD_UP||flywheel==PSB_PAD_RIGHT||flywheel==PSB_PAD_DOWN||flywheel==PSB_PAD_LEFT)
+//	{
+//		F_1 = 0;
+//		F_2 = 0;
+//	}
+	Ctrl_Stage(CTRL_STAGE_MOTOR);
+}
+
 /**************        *****************  õһҡ˵ģ  Χ0~256  *****************          *****************/
 void speed_select(void)//õһҡ˵ģ  Χ0~256 
 {	 
 //	printf("speed_select\r\n");
-	speed = -( PS2_AnologData(PSS_LY)-127 ); //ˣ  ǰ
+	speed = -( ps2.ly-127 ); //ˣ  ǰ
 //	printf("Χ0~125  %d\t",speed);
 	if(flywheel == PSB_L3)
 	{	/*   125*80/35=285  */
@@ -90,7 +115,7 @@ void speed_select(void)//
 			 else speed=0;
 	}
 //	printf("speed  %d\t",speed);
-	swerve = -( PS2_AnologData(PSS_RX)-128 ); //ת  ת
+	swerve = -( ps2.rx-128 ); //ת  ת
 //	printf("Χ0~126  %d\t",swerve);
 	if(flywheel == PSB_R3)
 	{	/*  125*40/19=263 */
@@ -109,24 +134,13 @@ void speed_select(void)//
 }
 
 /***********************************************************************************************/
-void stop_fast(void)//
+void stop_fast(void)//ɲ (б)
 {
-	M1_1 = 1;
-	M1_2 = 1;
-	TIM3->CCR1 = 255;
-	M2_1 = 1;
-	M2_2 = 1;
-	TIM3->CCR2 = 255;
+	Drive_Stop(1);
 }
-void stop_init(void)//
+void stop_init(void)//ͣ + 
 {
-	M1_1 = 0;
-	M1_2 = 0;
-	M2_1 = 0;
-	M2_2 = 0;
-	TIM3->CCR1 = 0;
-	TIM3->CCR2 = 0;
 	F_2 = 0;
 	F_1 = 0;
-} 
-
+	Drive_Stop(0);
+}
@@ -143,6 +143,185 @@ void ADC1_Init(void)
 
 }
 
+/***************** ͨɨ ADC  *****************/
+static u16 ADC_Scan_Buf[2*ADC_SCAN_OVS*ADC_SCAN_MAX_CH];	//DMA ѭ壺ǰ / 
+static u16 ADC_Scan_Result[2][ADC_SCAN_MAX_CH];				// ˫
+static volatile u8 ADC_Scan_Cur=0;							//õһ
+static u8 ADC_Scan_Num=0;
+static ADC_Scan_Callback ADC_Scan_Cb=0;
+volatile u32 ADC_Scan_Seq=0;
+
+//ͨ 0~7:PA0~PA7  8~9:PB0~PB1 ģ
+static void ADC_Scan_GPIO(u8 ch)
+{
+	GPIO_InitTypeDef GPIO_InitStructure;
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AIN;
+	if(ch<=7)
+	{
+		RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA, ENABLE);
+		GPIO_InitStructure.GPIO_Pin = 1<<ch;
+		GPIO_Init(GPIOA,&GPIO_InitStructure);
+	}
+	else if(ch<=9)
+	{
+		RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOB, ENABLE);
+		GPIO_InitStructure.GPIO_Pin = 1<<(ch-8);
+		GPIO_Init(GPIOB,&GPIO_InitStructure);
+	}
+	else if(ch==ADC_Channel_16 || ch==ADC_Channel_17)
+		ADC_TempSensorVrefintCmd(ENABLE);
+}
+
+void ADC_Scan_Init(const ADC_Scan_Chan *list, u8 num)
+{
+	ADC_InitTypeDef 			ADC_InitStructure;
+	DMA_InitTypeDef 			DMA_InitStructure;
+	TIM_TimeBaseInitTypeDef  	TIM_TimeBaseStructure;
+	TIM_OCInitTypeDef  			TIM_OCInitStructure;
+	NVIC_InitTypeDef 			NVIC_InitStructure;
+	u8 n;
+
+	if(num>ADC_SCAN_MAX_CH) num=ADC_SCAN_MAX_CH;
+	ADC_Scan_Num=num;
+
+	RCC_APB2PeriphClockCmd(RCC_APB2Periph_ADC1, ENABLE);
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
+	RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM4, ENABLE);
+	RCC_ADCCLKConfig(RCC_PCLK2_Div6);		//72/6 = 12MHz (<=14MHz)
+	for(n=0;n<num;n++) ADC_Scan_GPIO(list[n].channel);
+
+	/* DMA1 ͨ1ADC1->DR ѭᵽ ADC_Scan_Buf봫/ ж */
+	DMA_DeInit(DMA1_Channel1);
+	DMA_InitStructure.DMA_PeripheralBaseAddr = ADC1_DR_Address;
+	DMA_InitStructure.DMA_MemoryBaseAddr = (u32)ADC_Scan_Buf;
+	DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;
+	DMA_InitStructure.DMA_BufferSize = 2*ADC_SCAN_OVS*num;
+	DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+	DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+	DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+	DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+	DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+	DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+	DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+	DMA_Init(DMA1_Channel1, &DMA_InitStructure);
+	DMA_ITConfig(DMA1_Channel1, DMA_IT_HT|DMA_IT_TC, ENABLE);
+
+	NVIC_InitStructure.NVIC_IRQChannel = DMA1_Channel1_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 3;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+	DMA_Cmd(DMA1_Channel1, ENABLE);
+
+	/* ADC1ɨ裬 (ÿɨһ)TIM4_CC4  */
+	ADC_DeInit(ADC1);
+	ADC_InitStructure.ADC_Mode = ADC_Mode_Independent;
+	ADC_InitStructure.ADC_ScanConvMode = ENABLE;
+	ADC_InitStructure.ADC_ContinuousConvMode = DISABLE;
+	ADC_InitStructure.ADC_ExternalTrigConv = ADC_ExternalTrigConv_T4_CC4;
+	ADC_InitStructure.ADC_DataAlign = ADC_DataAlign_Right;
+	ADC_InitStructure.ADC_NbrOfChannel = num;
+	ADC_Init(ADC1, &ADC_InitStructure);
+	for(n=0;n<num;n++)
+		ADC_RegularChannelConfig(ADC1, list[n].channel, n+1, list[n].sample_time);
+	ADC_DMACmd(ADC1, ENABLE);
+	ADC_Cmd(ADC1, ENABLE);
+	ADC_ResetCalibration(ADC1);
+	while(ADC_GetResetCalibrationStatus(ADC1));
+	ADC_StartCalibration(ADC1);
+	while(ADC_GetCalibrationStatus(ADC1));
+	ADC_ExternalTrigConvCmd(ADC1, ENABLE);
+
+	/* TIM41MHz ÿ 1/ADC_SCAN_RATE_HZ  CC4 Ƚ¼ һɨ () */
+	TIM_DeInit(TIM4);
+	TIM_TimeBaseStructure.TIM_Period = 1000000/ADC_SCAN_RATE_HZ-1;
+	TIM_TimeBaseStructure.TIM_Prescaler = 72-1;
+	TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+	TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
+	TIM_TimeBaseInit(TIM4, &TIM_TimeBaseStructure);
+	TIM_OCInitStructure.TIM_OCMode = TIM_OCMode_PWM1;
+	TIM_OCInitStructure.TIM_OutputState = TIM_OutputState_Enable;
+	TIM_OCInitStructure.TIM_Pulse = 1000000/ADC_SCAN_RATE_HZ/2;
+	TIM_OCInitStructure.TIM_OCPolarity = TIM_OCPolarity_Low;
+	TIM_OC4Init(TIM4, &TIM_OCInitStructure);
+	TIM_Cmd(TIM4, ENABLE);
+}
+
+void ADC_Scan_Stop(void)
+{
+	TIM_Cmd(TIM4, DISABLE);
+	ADC_ExternalTrigConvCmd(ADC1, DISABLE);
+	DMA_Cmd(DMA1_Channel1, DISABLE);
+}
+
+// дİ ȡһ
+static void ADC_Scan_Decimate(const u16 *half)
+{
+	u32 sum[ADC_SCAN_MAX_CH];
+	u16 *dst;
+	u8 n,k;
+
+	for(n=0;n<ADC_Scan_Num;n++) sum[n]=0;
+	for(k=0;k<ADC_SCAN_OVS;k++)
+	{
+		for(n=0;n<ADC_Scan_Num;n++) sum[n]+=half[n];
+		half+=ADC_Scan_Num;
+	}
+	dst=ADC_Scan_Result[ADC_Scan_Cur^1];			//дһ飬дл
+	for(n=0;n<ADC_Scan_Num;n++)
+		dst[n]=(u16)(sum[n]>>(ADC_SCAN_OVS_SHIFT/2));	//16 ۼ /4 -> 14 λ
+	ADC_Scan_Cur^=1;
+	ADC_Scan_Seq++;
+	if(ADC_Scan_Cb) ADC_Scan_Cb(dst, ADC_Scan_Num);
+}
+
+void DMA1_Channel1_IRQHandler(void)
+{
+	if(DMA_GetITStatus(DMA1_IT_HT1)!=RESET)		//ǰд
+	{
+		DMA_ClearITPendingBit(DMA1_IT_HT1);
+		ADC_Scan_Decimate(ADC_Scan_Buf);
+	}
+	if(DMA_GetITStatus(DMA1_IT_TC1)!=RESET)		//д
+	{
+		DMA_ClearITPendingBit(DMA1_IT_TC1);
+		ADC_Scan_Decimate(ADC_Scan_Buf+ADC_SCAN_OVS*ADC_Scan_Num);
+	}
+}
+
+u16 ADC_Scan_Read(u8 idx)
+{
+	if(idx>=ADC_Scan_Num) return 0;
+	return ADC_Scan_Result[ADC_Scan_Cur][idx];
+}
+
+u16 ADC_Scan_Read12(u8 idx)
+{
+	return ADC_Scan_Read(idx)>>(ADC_SCAN_BITS-12);
+}
+
+//Ĺ µһ ض֤ͬһ
+void ADC_Scan_Snapshot(u16 *out)
+{
+	u32 seq;
+	u8 n;
+	do{
+		seq=ADC_Scan_Seq;
+		for(n=0;n<ADC_Scan_Num;n++) out[n]=ADC_Scan_Result[ADC_Scan_Cur][n];
+	}while(seq!=ADC_Scan_Seq);
+}
+
+u16 ADC_Scan_To_mV(u16 val, u16 vref_val)
+{
+	if(vref_val==0) return (u16)((u32)val*3300/ADC_SCAN_FULL);
+	return (u16)((u32)val*ADC_VREFINT_MV/vref_val);		//VDDA ׼ʱ ڲοУ
+}
+
+void ADC_Scan_SetCallback(ADC_Scan_Callback cb)
+{
+	ADC_Scan_Cb=cb;
+}
+
 ////    AD1_value  = 3300000/4096*ADC_ConvertedValue[0]/1000;//PA 0 
 ////    AD2_value  = 3300000/4096*ADC_ConvertedValue[1]/1000;//PA 1
 ////    AD3_value  = 3300000/4096*ADC_ConvertedValue[2]/1000;//PA 2
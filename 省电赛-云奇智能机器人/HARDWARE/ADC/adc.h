@@ -14,5 +14,46 @@ void ADC_Mode_Config(void);
 /*ADC1ĹģʽΪMDAģʽ  */
 void DMA_Mode_Config(void);
 
+/***************** ͨɨ ADC  (ʱ + DMA ˫ + ) *****************
+	TIM4_CC4  ADC_SCAN_RATE_HZ һ ADC1 ɨ (ͨȫͨ)
+	DMA1 ͨ1 ѭ˵ 2 ÿ ADC_SCAN_OVS ɨ裻
+	봫/ж Ѹдİ ÿͨۼ  (ȡ)
+	õ ADC_SCAN_BITS λд˫Ľ飬CPU ÿת
+	TIM4 ֻ (CC4 ӹ PB9PB9  DS18B20  GPIO)
+
+	ʹã
+	static const ADC_Scan_Chan adc_list[] = {
+		{ADC_Channel_8,  ADC_SampleTime_55Cycles5},		//PB0  MQ135
+		{ADC_Channel_17, ADC_SampleTime_239Cycles5},	//ڲο Vrefint
+	};
+	ADC_Scan_Init(adc_list, 2);
+	v=ADC_Scan_Read(0);					//һν 0 ~ ADC_SCAN_FULL
+*/
+#define ADC_SCAN_MAX_CH		8			//ͨ
+#define ADC_SCAN_OVS_SHIFT	4			//ÿ 2^4=16 β
+#define ADC_SCAN_OVS		(1<<ADC_SCAN_OVS_SHIFT)
+#define ADC_SCAN_BITS		(12+ADC_SCAN_OVS_SHIFT/2)		//4^n   n λ14 λ
+#define ADC_SCAN_FULL		((1<<ADC_SCAN_BITS)-1)			// 16383
+#define ADC_SCAN_RATE_HZ	1000		//ÿɨ = ADC_SCAN_RATE_HZ/ADC_SCAN_OVS
+#define ADC_VREFINT_MV		1200		//ڲοѹ ֵ mV
+
+typedef struct{
+				u8 channel;			//ADC_Channel_x (0~9 Զģ룬16 ¶ 17 Vrefint)
+				u8 sample_time;		//ADC_SampleTime_xxx
+				}ADC_Scan_Chan;
+
+/* ص DMA жִУҪ̣val[] Ϊ num ͨĽ */
+typedef void (*ADC_Scan_Callback)(const u16 *val, u8 num);
+
+extern volatile u32 ADC_Scan_Seq;		// (ÿһ1)
+
+void ADC_Scan_Init(const ADC_Scan_Chan *list, u8 num);	//ò
+void ADC_Scan_Stop(void);
+u16  ADC_Scan_Read(u8 idx);				//ͨ idx  Ľ 0~ADC_SCAN_FULL
+u16  ADC_Scan_Read12(u8 idx);			//ͬ  12 λ 0~4095 (ԭ)
+void ADC_Scan_Snapshot(u16 *out);		// ͬһ ȫͨ
+u16  ADC_Scan_To_mV(u16 val, u16 vref_val);	// -> mVvref_val Ϊͬ Vrefint  (0:  3300mV )
+void ADC_Scan_SetCallback(ADC_Scan_Callback cb);
+
 #endif /* __ADC_H */
 
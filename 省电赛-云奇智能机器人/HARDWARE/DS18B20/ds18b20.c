@@ -157,3 +157,314 @@ short DS18B20_Get_Temp(void)
 	else return -tem;    
 } 
  
+
+
+/*********************** ̨ɼTIM3 ʱĵ״̬ ***********************/
+DS18B20_Data DS18B20_Cache;
+
+//߳ 
+#define OW_OP_END		0
+#define OW_OP_RESET		1		//λ + Ӧ
+#define OW_OP_WRITE		2		// 1 ֽ
+#define OW_OP_READ		3		// ȡֽ
+
+//ʱ϶ڵĽ׶
+#define OW_PH_FETCH		0		//ȡһ
+#define OW_PH_RST_REL	1		//λ͵ƽ ͷ
+#define OW_PH_RST_SMP	2		//Ӧ
+#define OW_PH_WBIT		3		//дһλ
+#define OW_PH_W0_REL	4		//д0 ͵ƽ ͷ
+#define OW_PH_RBIT		5		//һλ
+
+static const u8 OW_Prog_Convert[]={OW_OP_RESET, OW_OP_WRITE,0xCC, OW_OP_WRITE,0x44, OW_OP_END};	//skip rom, ת
+static const u8 OW_Prog_Read[]={OW_OP_RESET, OW_OP_WRITE,0xCC, OW_OP_WRITE,0xBE, OW_OP_READ,9, OW_OP_END};	//skip rom, ݴ9ֽ
+
+static const u8 *OW_Prog;
+static u8 OW_Pc;
+static u8 OW_Phase;
+static u8 OW_Byte;
+static u8 OW_Bit;
+static u8 OW_Cnt;
+static u8 OW_Rx[9];
+static u8 OW_Rx_N;
+static volatile u8 OW_Busy=0;
+static volatile u8 OW_Err=0;
+
+#define DS18B20_ST_IDLE		0
+#define DS18B20_ST_CONV		1		//ת
+#define DS18B20_ST_WAIT		2		//ת
+#define DS18B20_ST_READ		3		//ݴ
+
+static u8  DS18B20_State=DS18B20_ST_IDLE;
+static u32 DS18B20_T0=0;
+static u32 DS18B20_Next=0;
+
+//DWT æ (жã SysTick)
+static void OW_Spin_us(u32 us)
+{
+	u32 t=DWT_Get_Cycle();
+	while(DWT_Get_Cycle()-t < us*DWT_CLK_MHZ);
+}
+
+//TIM3 壺us һθж
+static void OW_Timer_Start(u16 us)
+{
+	TIM3->ARR=us-1;
+	TIM3->CNT=0;
+	TIM3->CR1|=TIM_CR1_CEN;
+}
+
+//ִһصһ us0: 
+static u16 OW_Step(void)
+{
+	u8 op,v;
+	while(1)
+	{
+		switch(OW_Phase)
+		{
+			case OW_PH_FETCH:
+				op=OW_Prog[OW_Pc++];
+				if(op==OW_OP_RESET)
+				{
+					DS18B20_IO_OUT();
+					DS18B20_DQ_OUT=0;			// 480us 
+					OW_Phase=OW_PH_RST_REL;
+					return 500;
+				}
+				if(op==OW_OP_WRITE)
+				{
+					OW_Byte=OW_Prog[OW_Pc++];
+					OW_Bit=0;
+					OW_Phase=OW_PH_WBIT;
+					break;
+				}
+				if(op==OW_OP_READ)
+				{
+					OW_Cnt=OW_Prog[OW_Pc++];
+					OW_Byte=0;
+					OW_Bit=0;
+					OW_Rx_N=0;
+					OW_Phase=OW_PH_RBIT;
+					break;
+				}
+				return 0;						//OW_OP_END
+			case OW_PH_RST_REL:
+				DS18B20_DQ_OUT=1;
+				DS18B20_IO_IN();
+				OW_Phase=OW_PH_RST_SMP;
+				return 70;						//Ӧͷź 15~60us ֣ 60~240us
+			case OW_PH_RST_SMP:
+				if(DS18B20_DQ_IN)				//ûӦ
+				{
+					OW_Err=1;
+					return 0;
+				}
+				OW_Phase=OW_PH_FETCH;
+				return 410;						//λʱ϶  >=960us
+			case OW_PH_WBIT:
+				if(OW_Bit==8)
+				{
+					OW_Phase=OW_PH_FETCH;
+					break;
+				}
+				v=OW_Byte&0x01;
+				OW_Byte>>=1;
+				OW_Bit++;
+				DS18B20_IO_OUT();
+				if(v)							//д1 2us ͷ
+				{
+					__disable_irq();
+					DS18B20_DQ_OUT=0;
+					OW_Spin_us(2);
+					DS18B20_DQ_OUT=1;
+					__enable_irq();
+					return 62;
+				}
+				DS18B20_DQ_OUT=0;				//д0 60us
+				OW_Phase=OW_PH_W0_REL;
+				return 60;
+			case OW_PH_W0_REL:
+				DS18B20_DQ_OUT=1;
+				OW_Phase=OW_PH_WBIT;
+				return 2;						//ָʱ
+			case OW_PH_RBIT:
+				if(OW_Bit==8)
+				{
+					OW_Rx[OW_Rx_N++]=OW_Byte;
+					OW_Byte=0;
+					OW_Bit=0;
+					if(--OW_Cnt==0)
+					{
+						OW_Phase=OW_PH_FETCH;
+						break;
+					}
+				}
+				__disable_irq();				// 2usͷź 15us ڲ
+				DS18B20_IO_OUT();
+				DS18B20_DQ_OUT=0;
+				OW_Spin_us(2);
+				DS18B20_DQ_OUT=1;
+				DS18B20_IO_IN();
+				OW_Spin_us(10);
+				v=DS18B20_DQ_IN;
+				__enable_irq();
+				OW_Byte=(OW_Byte>>1)|(v<<7);	//λǰ
+				OW_Bit++;
+				return 55;
+			default:
+				OW_Err=1;
+				return 0;
+		}
+	}
+}
+
+void TIM3_IRQHandler(void)
+{
+	u16 us;
+	if(TIM_GetITStatus(TIM3,TIM_IT_Update)!=RESET)
+	{
+		TIM_ClearITPendingBit(TIM3,TIM_IT_Update);
+		if(!OW_Busy) return;
+		us=OW_Step();
+		if(us) OW_Timer_Start(us);
+		else
+		{
+			DS18B20_IO_OUT();
+			DS18B20_DQ_OUT=1;
+			OW_Busy=0;
+		}
+	}
+}
+
+static void OW_Run(const u8 *prog)
+{
+	OW_Prog=prog;
+	OW_Pc=0;
+	OW_Phase=OW_PH_FETCH;
+	OW_Err=0;
+	OW_Busy=1;
+	OW_Timer_Start(10);
+}
+
+static void OW_Abort(void)
+{
+	TIM3->CR1&=~TIM_CR1_CEN;
+	OW_Busy=0;
+	DS18B20_IO_OUT();
+	DS18B20_DQ_OUT=1;
+}
+
+//Dallas CRC8 (x^8+x^5+x^4+1)
+static u8 OW_Crc8(const u8 *buf, u8 len)
+{
+	u8 crc=0,i,b;
+	while(len--)
+	{
+		b=*buf++;
+		for(i=0;i<8;i++)
+		{
+			if((crc^b)&0x01) crc=(crc>>1)^0x8C;
+			else crc>>=1;
+			b>>=1;
+		}
+	}
+	return crc;
+}
+
+void DS18B20_Async_Init(void)
+{
+	GPIO_InitTypeDef  			GPIO_InitStructure;
+	TIM_TimeBaseInitTypeDef  	TIM_TimeBaseStructure;
+	NVIC_InitTypeDef 			NVIC_InitStructure;
+
+ 	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOB, ENABLE);
+ 	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_9;
+ 	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_PP;
+ 	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+ 	GPIO_Init(GPIOB, &GPIO_InitStructure);
+ 	GPIO_SetBits(GPIOB,GPIO_Pin_9);
+
+	DWT_Cycle_Init();
+
+	RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM3, ENABLE);
+	TIM_DeInit(TIM3);
+	TIM_TimeBaseStructure.TIM_Period = 1000-1;
+	TIM_TimeBaseStructure.TIM_Prescaler = 72-1;			//1MHz
+	TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+	TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
+	TIM_TimeBaseInit(TIM3, &TIM_TimeBaseStructure);
+	TIM_SelectOnePulseMode(TIM3, TIM_OPMode_Single);	//ÿԶͣ
+	TIM_ClearITPendingBit(TIM3,TIM_IT_Update);
+	TIM_ITConfig(TIM3,TIM_IT_Update,ENABLE);
+
+	NVIC_InitStructure.NVIC_IRQChannel = TIM3_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+
+	OW_Busy=0;
+	DS18B20_State=DS18B20_ST_IDLE;
+	DS18B20_Cache.valid=0;
+	DS18B20_Cache.ok=0;
+	DS18B20_Cache.err=0;
+}
+
+void DS18B20_Poll(u32 now)
+{
+	short raw;
+	switch(DS18B20_State)
+	{
+		case DS18B20_ST_IDLE:
+			if((s32)(now-DS18B20_Next)<0) break;
+			DS18B20_Next=now+DS18B20_PERIOD_MS;
+			OW_Run(OW_Prog_Convert);
+			DS18B20_T0=now;
+			DS18B20_State=DS18B20_ST_CONV;
+			break;
+		case DS18B20_ST_CONV:
+		case DS18B20_ST_READ:
+			if(OW_Busy)
+			{
+				if(now-DS18B20_T0>DS18B20_TIMEOUT_MS)
+				{
+					OW_Abort();
+					DS18B20_Cache.err++;
+					DS18B20_State=DS18B20_ST_IDLE;
+				}
+				break;
+			}
+			if(OW_Err)
+			{
+				DS18B20_Cache.err++;
+				DS18B20_State=DS18B20_ST_IDLE;
+				break;
+			}
+			if(DS18B20_State==DS18B20_ST_CONV)
+			{
+				DS18B20_T0=now;
+				DS18B20_State=DS18B20_ST_WAIT;
+				break;
+			}
+			if(OW_Crc8(OW_Rx,8)==OW_Rx[8] && (OW_Rx[4]&0x9F)==0x1F)	//CRC + üĴ ̶λ (ųȫ0)
+			{
+				raw=(short)((OW_Rx[1]<<8)|OW_Rx[0]);	//0.0625C
+				DS18B20_Cache.temp=(short)(((s32)raw*25+(raw<0 ? -2 : 2))/4);	//*6.25  -> 0.01C
+				DS18B20_Cache.stamp=now;
+				DS18B20_Cache.valid=1;
+				DS18B20_Cache.ok++;
+			}
+			else DS18B20_Cache.err++;
+			DS18B20_State=DS18B20_ST_IDLE;
+			break;
+		case DS18B20_ST_WAIT:
+			if(now-DS18B20_T0<DS18B20_CONV_MS) break;
+			OW_Run(OW_Prog_Read);
+			DS18B20_T0=now;
+			DS18B20_State=DS18B20_ST_READ;
+			break;
+		default:
+			DS18B20_State=DS18B20_ST_IDLE;
+			break;
+	}
+}
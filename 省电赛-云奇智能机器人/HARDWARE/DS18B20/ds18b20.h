@@ -18,6 +18,35 @@ u8 DS18B20_Read_Bit(void);//
 u8 DS18B20_Check(void);//ǷDS18B20
 void DS18B20_Rst(void);//λDS18B20    
 
+/* ̨ɼ ()
+	DS18B20_Get_Temp  delay λշûе 750ms ת (һεĽ)
+	̨ʽߵÿʱ϶ TIM3 嶨ʱжƽ (1MHz)
+	ֻ λ/д1 Ŀͷʮ us жжæȣʱ䶼ռCPU
+	"ת -> 750ms  ݴ(CRC)"  DS18B20_Poll ʱƽ DS18B20_Cache
+	TIM3 ר (TIM3_IRQHandler ڱļ)
+	Ҫá
+	ʹã
+		DS18B20_Async_Init();
+		DS18B20_Poll(Sched_Ticks);		//ãΪǰ ms
+		if(DS18B20_Cache.valid) t=DS18B20_Cache.temp;
+*/
+#define DS18B20_PERIOD_MS	1000	//ɼ
+#define DS18B20_CONV_MS		750		//12λ תʱ
+#define DS18B20_TIMEOUT_MS	50		//һ߲ʱ (9ֽ Լ 6ms)
+
+typedef struct{
+				short temp;		//¶ 0.01C ( DS18B20_Get_Temp ͬ2788 = 27.88C)
+				u8  valid;		//1: ٳɹһ
+				u32 stamp;		//һγɹʱ ms
+				u32 ok;			//ɹ
+				u32 err;		//ʧܴ (Ӧ/CRC/ʱ)
+				}DS18B20_Data;
+
+extern DS18B20_Data DS18B20_Cache;	//һγɹ
+
+void DS18B20_Async_Init(void);		//PB9 + TIM3 嶨ʱ ʼ
+void DS18B20_Poll(u32 now);			//ƽɼ״̬now: ǰ ms
+
 #endif
 
 
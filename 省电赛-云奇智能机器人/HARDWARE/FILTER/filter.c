@@ -0,0 +1,105 @@
+/***************STM32F103C8T6**********************
+ * ļ  filter.c
+ *     : ͨ ˲ (ƽ / 2^n ƽ / ֵ / һIIR)
+ * ע    ÿļ  ڴС ޹ (ֵ˲⣬ <= 9)
+****************STM32F103C8T6**********************/
+#include "filter.h"
+
+#if FILTER_MA_EN
+/* к ƽsum +=  - ľ
+    "ÿΰѴٳ" ȫͬ (ʷֵΪ 0) */
+void MA_Filter_Update(MA_Filter *f, const s16 *in, s16 *out)
+{
+	u8  c;
+	s16 *old = &f->buf[f->idx * f->ch];
+
+	for(c=0; c<f->ch; c++)
+	{
+		f->sum[c] += in[c] - old[c];
+		old[c] = in[c];
+		out[c] = f->sum[c] / f->win;
+	}
+	if(++f->idx >= f->win) f->idx = 0;
+}
+
+//Ϊ 2^shift Ļƽλ
+void MA_Filter_Update_Pow2(MA_Filter *f, const s16 *in, s16 *out)
+{
+	u8  c;
+	s16 *old = &f->buf[f->idx * f->ch];
+
+	for(c=0; c<f->ch; c++)
+	{
+		f->sum[c] += in[c] - old[c];
+		old[c] = in[c];
+		out[c] = f->sum[c] >> f->shift;
+	}
+	f->idx = (f->idx + 1) & (f->win - 1);
+}
+
+void MA_Filter_Reset(MA_Filter *f)
+{
+	u32 i;
+	for(i=0; i<(u32)f->ch*f->win; i++) f->buf[i] = 0;
+	for(i=0; i<f->ch; i++) f->sum[i] = 0;
+	f->idx = 0;
+}
+#endif
+
+#if FILTER_MED_EN
+//ȡֵ
+s16 Median3(s16 a, s16 b, s16 c)
+{
+	if(a > b) { s16 t = a; a = b; b = t; }	//a <= b
+	if(b > c) b = c;						//b = min(b,c)
+	return a > b ? a : b;					//max(a, min(b,c))
+}
+
+/* ֵ˲ n   ȡмֵ
+   Ϊ 3 ʱ ֱ Median3
+   tmp ֻ FILTER_MED_MAX n ķΧ  MED_FILTER_DEF ʱ */
+void MED_Filter_Update(MED_Filter *f, const s16 *in, s16 *out)
+{
+	u8  c, i, j;
+	s16 tmp[FILTER_MED_MAX], v;
+
+	for(c=0; c<f->ch; c++) f->buf[f->idx * f->ch + c] = in[c];
+	if(++f->idx >= f->n) f->idx = 0;
+
+	for(c=0; c<f->ch; c++)
+	{
+		if(f->n == 3)
+		{
+			out[c] = Median3(f->buf[c], f->buf[f->ch + c], f->buf[2*f->ch + c]);
+			continue;
+		}
+		for(i=0; i<f->n; i++)
+		{
+			v = f->buf[i * f->ch + c];
+			for(j=i; j>0 && tmp[j-1] > v; j--) tmp[j] = tmp[j-1];
+			tmp[j] = v;
+		}
+		out[c] = tmp[f->n / 2];
+	}
+}
+#endif
+
+#if FILTER_IIR_EN
+/* һ IIR (ָƽ)y = y + (x - y) / 2^k
+   ״̬ acc = y * 2^kС֣Сźʱ ض   ס */
+void IIR_Filter_Update(IIR_Filter *f, const s32 *in, s32 *out)
+{
+	u8 c;
+
+	if(!f->init)
+	{
+		for(c=0; c<f->ch; c++) f->acc[c] = in[c] * ((s32)1 << f->k);	//
+		f->init = 1;
+	}
+	for(c=0; c<f->ch; c++)
+	{
+		f->acc[c] += in[c] - (f->acc[c] >> f->k);
+		out[c] = f->acc[c] >> f->k;
+	}
+}
+#endif
@@ -0,0 +1,80 @@
+#ifndef __FILTER_H
+#define __FILTER_H
+#include "stm32f10x.h"
+
+/****************** ͨ ˲ (IMU / ADC / HX711 /  ) ******************
+  ÿ˲ "ͨ x " ̬䣬 XXX_FILTER_DEF  .c ļﶨʵ
+  Ҫ mallocҲҪ Initÿ Update / ch  s16 ( s32) 
+
+  1. ƽ       MA_Filter_Update      кͣ¼ɣ1 γ봰ڴС޹
+  2. 2^n ƽ   MA_Filter_Update_Pow2 ͬϣλ (ȡ / в)
+  3. ֵ˲       MED_Filter_Update      N ȡֵ޳ë (N Ϊ <= 9)
+  4. һ IIR       IIR_Filter_Update     y += (x - y) / 2^k1 μ + 1 λ
+
+  ĺԹصõ˲ٴ */
+#define FILTER_MA_EN		1	//ʹܣ1/ֹ0ƽ ( 2^n )
+#define FILTER_MED_EN		1	//ʹܣ1/ֹ0ֵ˲
+#define FILTER_IIR_EN		1	//ʹܣ1/ֹ0һ IIR
+
+#define FILTER_MED_MAX		9	//ֵ˲ 󴰿
+
+#if FILTER_MA_EN
+typedef struct{
+				s16  *buf;		//ch*win ʷ,  i  ͨ c  buf[i*ch+c]
+				s32  *sum;		//ch к
+				u8   ch;		//ͨ
+				u8   shift;		//win = 2^shift (ֻ Pow2 汾ʹ)
+				u16  win;		//ڴС
+				u16  idx;		//һҪǵλ
+				}MA_Filter;
+
+// ƽ ʵ: ch ͨ, win 
+#define MA_FILTER_DEF(name, ch, win)		\
+	static s16 name##_buf[(ch)*(win)];		\
+	static s32 name##_sum[ch];				\
+	static MA_Filter name = { name##_buf, name##_sum, ch, 0, win, 0 }
+// 2^n ƽ ʵ: ch ͨ,  2^shift (shift <= 15к )
+#define MA2N_FILTER_DEF(name, ch, shift)	\
+	static s16 name##_buf[(ch)<<(shift)];	\
+	static s32 name##_sum[ch];				\
+	static MA_Filter name = { name##_buf, name##_sum, ch, shift, 1<<(shift), 0 }
+
+void MA_Filter_Update(MA_Filter *f, const s16 *in, s16 *out);		//out = sum / win
+void MA_Filter_Update_Pow2(MA_Filter *f, const s16 *in, s16 *out);	//out = sum >> shift
+void MA_Filter_Reset(MA_Filter *f);
+#endif
+
+#if FILTER_MED_EN
+typedef struct{
+				s16  *buf;		//ch*n ʷ
+				u8   ch;
+				u8   n;			// ()
+				u8   idx;
+				}MED_Filter;
+
+// ֵ˲ ʵ: ch ͨ,  n ( 1 ~ FILTER_MED_MAX 뱨 СΪ)
+#define MED_FILTER_DEF(name, ch, n)			\
+	typedef char name##_n_check[((n) >= 1 && (n) <= FILTER_MED_MAX && ((n) & 1)) ? 1 : -1];	\
+	static s16 name##_buf[(ch)*(n)];		\
+	static MED_Filter name = { name##_buf, ch, n, 0 }
+
+void MED_Filter_Update(MED_Filter *f, const s16 *in, s16 *out);
+s16  Median3(s16 a, s16 b, s16 c);	//ȡֵ (3 αȽ)
+#endif
+
+#if FILTER_IIR_EN
+typedef struct{
+				s32  *acc;		//ch ״̬Ŵ 2^k  (С)
+				u8   ch;
+				u8   k;			//ϵ alpha = 1/2^k
+				u8   init;		//0: һֵʼ 0 
+				}IIR_Filter;
+
+#define IIR_FILTER_DEF(name, ch, k)			\
+	static s32 name##_acc[ch];				\
+	static IIR_Filter name = { name##_acc, ch, k, 0 }
+
+void IIR_Filter_Update(IIR_Filter *f, const s32 *in, s32 *out);
+#endif
+
+#endif
@@ -14,11 +14,179 @@
 #define GET_HIGH_BYTE(A) ((uint8_t)((A) >> 8))
 //宏函数 获得A的高八位
 
-bool isUartRxCompleted;
+volatile bool isUartRxCompleted;           //中断里收完一帧置 true，receiveHandle() 取走后清除
 
-uint8_t LobotTxBuf[128];  //发送缓存
-uint8_t LobotRxBuf[16];
+uint8_t LobotTxBuf[128];  //发送缓存 (组帧用)
+uint8_t LobotRxBuf[16];                     //receiveHandle() 取出的最近一帧 (只在主程序里写)
 uint16_t batteryVolt;
+volatile uint8_t actionGroupRunning = 0xFF;  //正在运行的动作组号，0xFF:没有
+volatile bool isActionGroupDone;             //动作组 运行完成/被停止 时置 true，由用户清除
+LobotStat LobotStats;
+
+/* 发送环形缓冲：组好的帧放进来，由 USART3 TX DMA (DMA1 通道2) 在后台发出
+   head 只在主程序里改，tail 只在 DMA 中断里改 */
+static uint8_t LobotTxRing[LOBOT_TX_RING_LEN];
+static volatile uint16_t LobotTxHead = 0;  //写入位置
+static volatile uint16_t LobotTxTail = 0;  //DMA 读取位置
+static volatile uint16_t LobotTxDmaLen = 0;//DMA 正在发送的字节数，0:空闲
+static bool LobotDmaReady = false;         //未调用 LobotInit() 时退回阻塞发送
+
+/* 同一个 tick 内的舵机移动 先合并，LobotTick() 时一帧发出 */
+static LobotServo LobotPend[LOBOT_SERVO_MAX];
+static uint8_t LobotPendNum = 0;
+static uint16_t LobotPendTime = 0;
+
+/* 接收状态机 */
+static uint8_t LobotRxFrame[16];
+static uint8_t LobotRxState = 0;
+static uint8_t LobotRxIndex = 0;
+/* 收完的帧 双缓冲：中断写 没发布的一块，写完翻转 LobotRxPub，主程序只读已发布的一块
+   主程序复制期间 又来一帧 (LobotRxSeq 变了) 就重新复制 */
+static uint8_t LobotRxDone[2][16];
+static volatile uint8_t LobotRxPub = 0;
+static volatile uint8_t LobotRxSeq = 0;
+
+/*********************************************************************************
+ * Function:  LobotInit
+ * Description： 初始化 USART3 发送 DMA (DMA1 通道2)，须在 uart3_init() 之后调用
+ * Parameters:   无
+ * Return:       无返回
+ * Others:       不调用时 所有指令仍以阻塞方式发送
+ **********************************************************************************/
+void LobotInit(void)
+{
+	DMA_InitTypeDef  DMA_InitStructure;
+	NVIC_InitTypeDef NVIC_InitStructure;
+
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
+
+	DMA_DeInit(DMA1_Channel2);
+	DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&USART3->DR;
+	DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)LobotTxRing;
+	DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;
+	DMA_InitStructure.DMA_BufferSize = 1;
+	DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+	DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+	DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+	DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+	DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+	DMA_InitStructure.DMA_Priority = DMA_Priority_Low;
+	DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+	DMA_Init(DMA1_Channel2, &DMA_InitStructure);
+	DMA_ITConfig(DMA1_Channel2, DMA_IT_TC, ENABLE);
+
+	NVIC_InitStructure.NVIC_IRQChannel = DMA1_Channel2_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 3;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+
+	USART_DMACmd(USART3, USART_DMAReq_Tx, ENABLE);
+	LobotTxHead = LobotTxTail = LobotTxDmaLen = 0;
+	LobotDmaReady = true;
+}
+
+/* 若 DMA 空闲且缓冲里有数据，启动一段连续数据的发送 (调用者保证不被 DMA 中断打断) */
+static void LobotTxKick(void)
+{
+	uint16_t len;
+	if (LobotTxDmaLen != 0 || LobotTxHead == LobotTxTail) {
+		return;
+	}
+	if (LobotTxHead > LobotTxTail) {
+		len = LobotTxHead - LobotTxTail;
+	} else {
+		len = LOBOT_TX_RING_LEN - LobotTxTail;     //先发到缓冲末尾，剩下的下一次中断再发
+	}
+	LobotTxDmaLen = len;
+	DMA_Cmd(DMA1_Channel2, DISABLE);
+	DMA1_Channel2->CMAR = (uint32_t)&LobotTxRing[LobotTxTail];
+	DMA1_Channel2->CNDTR = len;
+	DMA_Cmd(DMA1_Channel2, ENABLE);
+}
+
+/* 把一帧放进发送缓冲，空间不够时丢弃整帧 */
+static void LobotSend(uint8_t *buf, uint8_t len)
+{
+	uint16_t space, head, i;
+
+	if (!LobotDmaReady) {
+		uartWriteBuf(buf, len);
+		return;
+	}
+	head = LobotTxHead;
+	space = (LobotTxTail + LOBOT_TX_RING_LEN - head - 1) % LOBOT_TX_RING_LEN;
+	if (space < len) {
+		LobotStats.txDrop++;
+		return;
+	}
+	for (i = 0; i < len; i++) {
+		LobotTxRing[head] = buf[i];
+		head = (head + 1) % LOBOT_TX_RING_LEN;
+	}
+	LobotTxHead = head;
+	LobotStats.txFrame++;
+
+	NVIC_DisableIRQ(DMA1_Channel2_IRQn);
+	LobotTxKick();
+	NVIC_EnableIRQ(DMA1_Channel2_IRQn);
+}
+
+/*********************************************************************************
+ * Function:  LobotFlush
+ * Description： 把合并中的舵机移动 组成一帧多舵机指令发出
+ * Parameters:   无
+ * Return:       无返回
+ * Others:       其他指令发出前会先调用，保证指令顺序不变
+ **********************************************************************************/
+void LobotFlush(void)
+{
+	if (LobotPendNum == 0) {
+		return;
+	}
+	moveServosNow(LobotPend, LobotPendNum, LobotPendTime);
+	LobotPendNum = 0;
+}
+
+/* 加入一个舵机移动：同一舵机取最后一次的位置，转动时间不同则先把之前的发出 */
+static void LobotPendAdd(uint8_t servoID, uint16_t Position, uint16_t Time)
+{
+	uint8_t i;
+
+	if (LobotPendNum != 0 && Time != LobotPendTime) {
+		LobotFlush();
+	}
+	LobotPendTime = Time;
+	for (i = 0; i < LobotPendNum; i++) {
+		if (LobotPend[i].ID == servoID) {
+			LobotPend[i].Position = Position;
+			LobotStats.merged++;
+			return;
+		}
+	}
+	if (LobotPendNum >= LOBOT_SERVO_MAX) {
+		LobotFlush();
+	}
+	LobotPend[LobotPendNum].ID = servoID;
+	LobotPend[LobotPendNum].Position = Position;
+	LobotPendNum++;
+#if !LOBOT_COALESCE
+	LobotFlush();
+#endif
+}
+
+/*********************************************************************************
+ * Function:  LobotTick
+ * Description： 每个控制周期调用一次：发出本周期合并的舵机移动，处理收到的应答
+ * Parameters:   无
+ * Return:       无返回
+ * Others:
+ **********************************************************************************/
+void LobotTick(void)
+{
+	LobotFlush();
+	receiveHandle();
+}
 
 /*********************************************************************************
  * Function:  moveServo
@@ -33,17 +201,7 @@ void moveServo(uint8_t servoID, uint16_t Position, uint16_t Time)
 	if (servoID > 31 || !(Time > 0)) {  //舵机ID不能打于31,可根据对应控制板修改
 		return;
 	}
-	LobotTxBuf[0] = LobotTxBuf[1] = FRAME_HEADER;    //填充帧头
-	LobotTxBuf[2] = 8;
-	LobotTxBuf[3] = CMD_SERVO_MOVE;           //数据长度=要控制舵机数*3+5，此处=1*3+5//填充舵机移动指令
-	LobotTxBuf[4] = 1;                        //要控制的舵机个数
-	LobotTxBuf[5] = GET_LOW_BYTE(Time);       //取得时间的低八位
-	LobotTxBuf[6] = GET_HIGH_BYTE(Time);      //取得时间的高八位
-	LobotTxBuf[7] = servoID;                  //舵机ID
-	LobotTxBuf[8] = GET_LOW_BYTE(Position);   //取得目标位置的低八位
-	LobotTxBuf[9] = GET_HIGH_BYTE(Position);  //取得目标位置的高八位
-
-	uartWriteBuf(LobotTxBuf, 10);
+	LobotPendAdd(servoID, Position, Time);
 }
 
 /*********************************************************************************
@@ -55,6 +213,28 @@ void moveServo(uint8_t servoID, uint16_t Position, uint16_t Time)
  * Others:
  **********************************************************************************/
 void moveServosByArray(LobotServo servos[], uint8_t Num, uint16_t Time)
+{
+	uint8_t i = 0;
+
+	if (Num < 1 || Num > 32 || !(Time > 0)) {
+		return;                                          //舵机数不能为零和大与32，时间不能为零
+	}
+	for (i = 0; i < Num; i++) {
+		if (servos[i].ID <= 31) {
+			LobotPendAdd(servos[i].ID, servos[i].Position, Time);
+		}
+	}
+}
+
+/*********************************************************************************
+ * Function:  moveServosNow
+ * Description： 控制多个舵机转动，不合并，立即组帧放入发送缓冲
+ * Parameters:   servos[]:舵机结体数组，Num:舵机个数,Time:转动时间
+                    0 < Num <= 32,Time > 0
+ * Return:       无返回
+ * Others:
+ **********************************************************************************/
+void moveServosNow(LobotServo servos[], uint8_t Num, uint16_t Time)
 {
 	uint8_t index = 7;
 	uint8_t i = 0;
@@ -75,7 +255,7 @@ void moveServosByArray(LobotServo servos[], uint8_t Num, uint16_t Time)
 		LobotTxBuf[index++] = GET_HIGH_BYTE(servos[i].Position);//填充目标位置高八位
 	}
 
-	uartWriteBuf(LobotTxBuf, LobotTxBuf[2] + 2);             //发送
+	LobotSend(LobotTxBuf, LobotTxBuf[2] + 2);             //发送
 }
 
 /*********************************************************************************
@@ -87,33 +267,23 @@ void moveServosByArray(LobotServo servos[], uint8_t Num, uint16_t Time)
  **********************************************************************************/
 void moveServos(uint8_t Num, uint16_t Time, ...)
 {
-	uint8_t index = 7;
 	uint8_t i = 0;
+	uint8_t id;
 	uint16_t temp;
 	va_list arg_ptr;  //
 
-	va_start(arg_ptr, Time); //取得可变参数首地址
-	if (Num < 1 || Num > 32) {
-		return;               //舵机数不能为零和大与32，时间不能小于0
+	if (Num < 1 || Num > 32 || !(Time > 0)) {
+		return;               //舵机数不能为零和大与32，时间不能为零
 	}
-	LobotTxBuf[0] = LobotTxBuf[1] = FRAME_HEADER;      //填充帧头
-	LobotTxBuf[2] = Num * 3 + 5;                //数据长度 = 要控制舵机数 * 3 + 5
-	LobotTxBuf[3] = CMD_SERVO_MOVE;             //舵机移动指令
-	LobotTxBuf[4] = Num;                        //要控制舵机数
-	LobotTxBuf[5] = GET_LOW_BYTE(Time);         //取得时间的低八位
-	LobotTxBuf[6] = GET_HIGH_BYTE(Time);        //取得时间的高八位
-
-	for (i = 0; i < Num; i++) {//从可变参数中取得并循环填充舵机ID和对应目标位置
-		temp = va_arg(arg_ptr, int);//可参数中取得舵机ID
-		LobotTxBuf[index++] = GET_LOW_BYTE(((uint16_t)temp));
+	va_start(arg_ptr, Time); //取得可变参数首地址
+	for (i = 0; i < Num; i++) {//从可变参数中取得舵机ID和对应目标位置
+		id = GET_LOW_BYTE(((uint16_t)va_arg(arg_ptr, int)));//可参数中取得舵机ID
 		temp = va_arg(arg_ptr, int);  //可变参数中取得对应目标位置
-		LobotTxBuf[index++] = GET_LOW_BYTE(((uint16_t)temp)); //填充目标位置低八位
-		LobotTxBuf[index++] = GET_HIGH_BYTE(temp);//填充目标位置高八位
+		if (id <= 31) {
+			LobotPendAdd(id, temp, Time);
+		}
 	}
-
 	va_end(arg_ptr);  //置空arg_ptr
-
-	uartWriteBuf(LobotTxBuf, LobotTxBuf[2] + 2);    //发送
 }
 
 
@@ -126,6 +296,7 @@ void moveServos(uint8_t Num, uint16_t Time, ...)
  **********************************************************************************/
 void runActionGroup(uint8_t numOfAction, uint16_t Times)
 {
+	LobotFlush();                          //先发出之前的舵机移动
 	LobotTxBuf[0] = LobotTxBuf[1] = FRAME_HEADER;  //填充帧头
 	LobotTxBuf[2] = 5;                      //数据长度，数据帧除帧头部分数据字节数，此命令固定为5
 	LobotTxBuf[3] = CMD_ACTION_GROUP_RUN;   //填充运行动作组命令
@@ -133,7 +304,7 @@ void runActionGroup(uint8_t numOfAction, uint16_t Times)
 	LobotTxBuf[5] = GET_LOW_BYTE(Times);    //取得要运行次数的低八位
 	LobotTxBuf[6] = GET_HIGH_BYTE(Times);   //取得要运行次数的高八位
 
-	uartWriteBuf(LobotTxBuf, 7);            //发送
+	LobotSend(LobotTxBuf, 7);            //发送
 }
 
 /*********************************************************************************
@@ -145,12 +316,13 @@ void runActionGroup(uint8_t numOfAction, uint16_t Times)
  **********************************************************************************/
 void stopActionGroup(void)
 {
+	LobotFlush();                          //先发出之前的舵机移动
 	LobotTxBuf[0] = FRAME_HEADER;     //填充帧头
 	LobotTxBuf[1] = FRAME_HEADER;
 	LobotTxBuf[2] = 2;                //数据长度，数据帧除帧头部分数据字节数，此命令固定为2
 	LobotTxBuf[3] = CMD_ACTION_GROUP_STOP;   //填充停止运行动作组命令
 
-	uartWriteBuf(LobotTxBuf, 4);      //发送
+	LobotSend(LobotTxBuf, 4);      //发送
 }
 /*********************************************************************************
  * Function:  setActionGroupSpeed
@@ -161,6 +333,7 @@ void stopActionGroup(void)
  **********************************************************************************/
 void setActionGroupSpeed(uint8_t numOfAction, uint16_t Speed)
 {
+	LobotFlush();                          //先发出之前的舵机移动
 	LobotTxBuf[0] = LobotTxBuf[1] = FRAME_HEADER;   //填充帧头
 	LobotTxBuf[2] = 5;                       //数据长度，数据帧除帧头部分数据字节数，此命令固定为5
 	LobotTxBuf[3] = CMD_ACTION_GROUP_SPEED;  //填充设置动作组速度命令
@@ -168,7 +341,7 @@ void setActionGroupSpeed(uint8_t numOfAction, uint16_t Speed)
 	LobotTxBuf[5] = GET_LOW_BYTE(Speed);     //获得目标速度的低八位
 	LobotTxBuf[6] = GET_HIGH_BYTE(Speed);    //获得目标熟读的高八位
 
-	uartWriteBuf(LobotTxBuf, 7);             //发送
+	LobotSend(LobotTxBuf, 7);             //发送
 }
 
 /*********************************************************************************
@@ -192,20 +365,111 @@ void setAllActionGroupSpeed(uint16_t Speed)
  **********************************************************************************/
 void getBatteryVoltage(void)
 {
+	LobotFlush();                          //先发出之前的舵机移动
 //	uint16_t Voltage = 0;
 	LobotTxBuf[0] = FRAME_HEADER;  //填充帧头
 	LobotTxBuf[1] = FRAME_HEADER;
 	LobotTxBuf[2] = 2;             //数据长度，数据帧除帧头部分数据字节数，此命令固定为2
 	LobotTxBuf[3] = CMD_GET_BATTERY_VOLTAGE;  //填充获取电池电压命令
 
-	uartWriteBuf(LobotTxBuf, 4);   //发送
+	LobotSend(LobotTxBuf, 4);   //发送
+}
+
+/*********************************************************************************
+ * Function:  LobotRxByte
+ * Description： 接收状态机，在 USART3 接收中断里逐字节调用
+ * Parameters:   dat: 收到的字节
+ * Return:       无返回
+ * Others:       帧格式 0x55 0x55 Length Cmd Prm1...PrmN，Length = N + 2
+                 电池电压、动作组运行/停止/完成 在中断里直接更新，完整帧另存 LobotRxBuf
+ **********************************************************************************/
+void LobotRxByte(uint8_t dat)
+{
+	switch (LobotRxState) {
+	case 0:                                //帧头1
+	case 1:                                //帧头2
+		if (dat == FRAME_HEADER) {
+			LobotRxFrame[LobotRxState++] = dat;
+		} else {
+			LobotRxState = 0;
+		}
+		break;
+	case 2:                                //数据长度
+		if (dat < 2 || dat > sizeof(LobotRxFrame) - 2) {
+			LobotStats.rxError++;
+			LobotRxState = (dat == FRAME_HEADER) ? 2 : 0;  //55 55 55 ... 继续当作帧头
+			break;
+		}
+		LobotRxFrame[2] = dat;
+		LobotRxIndex = 3;
+		LobotRxState = 3;
+		break;
+	default:                               //指令 + 参数
+		LobotRxFrame[LobotRxIndex++] = dat;
+		if (LobotRxIndex < LobotRxFrame[2] + 2) {
+			break;
+		}
+		LobotRxState = 0;
+		LobotStats.rxFrame++;
+		switch (LobotRxFrame[3]) {
+		case CMD_GET_BATTERY_VOLTAGE:      //电池电压 mV
+			batteryVolt = (((uint16_t)(LobotRxFrame[5])) << 8) | (LobotRxFrame[4]);
+			break;
+		case CMD_ACTION_GROUP_RUN:         //动作组开始运行
+			actionGroupRunning = LobotRxFrame[4];
+			isActionGroupDone = false;
+			break;
+		case CMD_ACTION_GROUP_STOP:        //动作组被停止
+		case CMD_ACTION_GROUP_COMPLETE:    //动作组运行完成
+			actionGroupRunning = 0xFF;
+			isActionGroupDone = true;
+			break;
+		default:
+			break;
+		}
+		memcpy(LobotRxDone[LobotRxPub ^ 1], LobotRxFrame, LobotRxFrame[2] + 2);
+		LobotRxPub ^= 1;
+		LobotRxSeq++;
+		isUartRxCompleted = true;
+		break;
+	}
+}
+
+#if EN_USART3_LOBOT
+void USART3_IRQHandler(void)               //串口3中断服务程序  --  舵机控制板应答
+{
+	if (USART_GetITStatus(USART3, USART_IT_RXNE) != RESET) {
+		LobotRxByte((uint8_t)USART_ReceiveData(USART3));
+	}
+	if (USART_GetFlagStatus(USART3, USART_FLAG_ORE) == SET) {  //溢出
+		USART_ReceiveData(USART3);         //读SR + 读DR 清除
+		LobotRxState = 0;
+		LobotStats.rxError++;
+	}
+}
+#endif
+
+void DMA1_Channel2_IRQHandler(void)        //USART3 TX DMA 发送完成
+{
+	if (DMA_GetITStatus(DMA1_IT_TC2) != RESET) {
+		DMA_ClearITPendingBit(DMA1_IT_GL2);
+		DMA_Cmd(DMA1_Channel2, DISABLE);
+		LobotTxTail = (LobotTxTail + LobotTxDmaLen) % LOBOT_TX_RING_LEN;
+		LobotTxDmaLen = 0;
+		LobotTxKick();                     //发送缓冲里还有就接着发
+	}
 }
 
 void receiveHandle()
 {
 	//可以根据二次开发手册添加其他指令
 	if (isUartRxCompleted) {
-		isUartRxCompleted = false;
+		uint8_t seq;
+		do {
+			seq = LobotRxSeq;
+			isUartRxCompleted = false;
+			memcpy(LobotRxBuf, LobotRxDone[LobotRxPub], sizeof(LobotRxBuf));
+		} while (seq != LobotRxSeq);
 		switch (LobotRxBuf[3]) {
 		case CMD_GET_BATTERY_VOLTAGE: //获取电压
 			batteryVolt = (((uint16_t)(LobotRxBuf[5])) << 8) | (LobotRxBuf[4]);
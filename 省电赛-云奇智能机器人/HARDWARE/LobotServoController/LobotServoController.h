@@ -18,11 +18,23 @@
 #define CMD_ACTION_GROUP_RUN 0x06     //жָ
 #define CMD_ACTION_GROUP_STOP 0x07    //ָֹͣ
 #define CMD_ACTION_GROUP_SPEED 0x0B   //öٶ
+#define CMD_ACTION_GROUP_COMPLETE 0x08 // (ư)
 #define CMD_GET_BATTERY_VOLTAGE 0x0F  //ȡصѹָ
 
-extern bool isUartRxCompleted;
-extern uint8_t LobotRxBuf[16];
+/* ͷʽ
+   LobotInit() ָ֮֡Žͻλ壬 USART3 TX DMA ں̨ȴ 9600 ʣ
+   moveServo/moveServos/moveServosByArray ֻ¼Ŀλãͬһ tick  תʱͬƶ
+    LobotTick() ʱϲһָ֡ (ͬһȡλ)
+   ָǰȰѺϲеƶָ˳򲻱䡣 */
+#define LOBOT_TX_RING_LEN 256         //ͻλС
+#define LOBOT_SERVO_MAX   32          //һ֡
+#define LOBOT_COALESCE    1           //1:ϲ LobotTick() ٷ  0:ÿƶ
+
+extern volatile bool isUartRxCompleted;  //һ֡ (receiveHandle() ȡߺ)
+extern uint8_t LobotRxBuf[16];           //receiveHandle() ȡһ֡
 extern uint16_t batteryVolt;
+extern volatile uint8_t actionGroupRunning;  //еĶţ0xFF:û
+extern volatile bool isActionGroupDone;      // /ֹͣ
 extern void receiveHandle(void);
 
 typedef struct _lobot_servo_ {  //ID,Ŀλ
@@ -30,6 +42,21 @@ typedef struct _lobot_servo_ {  //
 	uint16_t Position;
 } LobotServo;
 
+typedef struct _lobot_stat_ {
+	uint32_t txFrame;   //뷢ͻ֡
+	uint32_t txDrop;    //֡
+	uint32_t merged;    //ϲĶƶ
+	uint32_t rxFrame;   //յӦ֡
+	uint32_t rxError;   //ȴ/
+} LobotStat;
+
+extern LobotStat LobotStats;
+
+void LobotInit(void);                 //USART3 TX DMA ʼ uart3_init() ֮
+void LobotTick(void);                 //ÿڵãϲƶ + receiveHandle()
+void LobotFlush(void);                //ϲеƶ
+void LobotRxByte(uint8_t dat);        //״̬ (USART3 жϵ)
+void moveServosNow(LobotServo servos[], uint8_t Num, uint16_t Time);
 
 void moveServo(uint8_t servoID, uint16_t Position, uint16_t Time);
 void moveServosByArray(LobotServo servos[], uint8_t Num, uint16_t Time);
@@ -29,6 +29,40 @@ u8 I2c_Buf_Read[256];
 /* AT24C04/08A/16Aÿҳ16ֽ */
 //#define I2C_PageSize           16			
 
+/* ȴʱ : ԭ while(!I2C_CheckEvent(...)) 쳣(ӻӦ߱)ʱȣ
+   Ϊ޴ȴʱ STOP ͷ   1 */
+#define I2C_FLAG_TIMEOUT	((u32)0x1000)					//¼ȴ(ѭ)
+#define I2C_LONG_TIMEOUT	((u32)(10 * I2C_FLAG_TIMEOUT))	//æ/ȴ
+u32 I2C_Timeout_Count = 0;	//ʱͳ
+
+static u8 I2C_TIMEOUT_UserCallback(void)
+{
+	I2C_GenerateSTOP(I2C1, ENABLE);			//ͷ
+	I2C_AcknowledgeConfig(I2C1, ENABLE);	//ָӦ𣬹´ν
+	I2C_Timeout_Count++;
+	return 1;
+}
+//ȴ I2C ¼, 0:ɹ  1:ʱ
+static u8 I2C_WaitEvent(u32 I2C_EVENT)
+{
+	u32 timeout = I2C_FLAG_TIMEOUT;
+	while(!I2C_CheckEvent(I2C1, I2C_EVENT))
+	{
+		if((timeout--) == 0) return I2C_TIMEOUT_UserCallback();
+	}
+	return 0;
+}
+//ȴ ߿, 0:ɹ  1:ʱ
+static u8 I2C_WaitBusFree(void)
+{
+	u32 timeout = I2C_LONG_TIMEOUT;
+	while(I2C_GetFlagStatus(I2C1, I2C_FLAG_BUSY))
+	{
+		if((timeout--) == 0) return I2C_TIMEOUT_UserCallback();
+	}
+	return 0;
+}
+
 /* I2C_GPIO_Config
  *   I2C1 I/O
  *   ڲ */
@@ -114,8 +148,10 @@ void InitMPU6050(void)
 void I2C_EE_WaitEepromStandbyState(void)      
 {
 	vu16 SR1_Tmp = 0;
+	u32 timeout = I2C_LONG_TIMEOUT;
 	do
 	{
+		if((timeout--) == 0) { I2C_TIMEOUT_UserCallback(); return; }
 		/* Send START condition */
 		I2C_GenerateSTART(I2C1, ENABLE);
 		/* Read I2C1 SR1 register */
@@ -133,24 +169,24 @@ void I2C_EE_WaitEepromStandbyState(void)
 	pBuffer:	ָ
 	REG_Address:	дַ
 	NumByteToWrite:		дֽ   */
-void I2C_EE_PageWrite(u8* pBuffer, uint8_t REG_Address, u8 NumByteToWrite)
+u8 I2C_EE_PageWrite(u8* pBuffer, uint8_t REG_Address, u8 NumByteToWrite)
 {
-	while(I2C_GetFlagStatus(I2C1, I2C_FLAG_BUSY)); // Added by Najoua 27/08/2008
+	if(I2C_WaitBusFree()) return 1;
 
 	/* Send START condition */
 	I2C_GenerateSTART(I2C1, ENABLE);
 	/* Test on EV5 and clear it */
-	while(!I2C_CheckEvent(I2C1, I2C_EVENT_MASTER_MODE_SELECT)); 
+	if(I2C_WaitEvent(I2C_EVENT_MASTER_MODE_SELECT)) return 1; 
 
 	/* Send EEPROM address for write */
 	I2C_Send7bitAddress(I2C1,MPU6050_WRITE_Address,I2C_Direction_Transmitter);
 	/* Test on EV6 and clear it */
-	while(!I2C_CheckEvent(I2C1, I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED));  
+	if(I2C_WaitEvent(I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED)) return 1;  
 
 	/* Send the EEPROM's internal address to write to */    
 	I2C_SendData(I2C1, REG_Address);  
 	/* Test on EV8 and clear it */
-	while(! I2C_CheckEvent(I2C1, I2C_EVENT_MASTER_BYTE_TRANSMITTED));
+	if(I2C_WaitEvent(I2C_EVENT_MASTER_BYTE_TRANSMITTED)) return 1;
 	/* While there is data to be written */
 	while(NumByteToWrite--)  
 	{
@@ -159,10 +195,11 @@ void I2C_EE_PageWrite(u8* pBuffer, uint8_t REG_Address, u8 NumByteToWrite)
 		/* Point to the next byte to be written */
 		pBuffer++; 
 		/* Test on EV8 and clear it */
-		while (!I2C_CheckEvent(I2C1, I2C_EVENT_MASTER_BYTE_TRANSMITTED));
+		if(I2C_WaitEvent(I2C_EVENT_MASTER_BYTE_TRANSMITTED)) return 1;
 	}
 	/* Send STOP condition */
 	I2C_GenerateSTOP(I2C1, ENABLE);
+	return 0;
 }
 
 
@@ -250,21 +287,22 @@ u8 I2C_EE_BufferWrite(u8 addr, uint8_t REG_Address , u8 NumByteToWrite,u8* pBuff
 	NumByteToWrite:			ҪEEPROMȡֽ   */
 //   I2C_EE_BufferRead(acc_buf,     MPU6050_ACC_OUT,      6);  u8 acc_buf[6]//ٶ
 //u8 I2C_EE_BufferRead(u8 addr, uint8_t REG_Address, u8 NumByteToRead,u8* pBuffer)
-void I2C_EE_BufferRead(u8* pBuffer,  u8 REG_Address,  u8 NumByteToRead)
+u8 I2C_EE_BufferRead(u8* pBuffer,  u8 REG_Address,  u8 NumByteToRead)
 {  
+	u32 timeout;
 	//*((u8 *)0x4001080c) |=0x80; 
-	while(I2C_GetFlagStatus(I2C1, I2C_FLAG_BUSY)); // Added by Najoua 27/08/2008    
+	if(I2C_WaitBusFree()) return 1;
 
 	/* Send START condition */
 	I2C_GenerateSTART(I2C1, ENABLE);
 	//*((u8 *)0x4001080c) &=~0x80;
 	/* Test on EV5 and clear it */
-	while(!I2C_CheckEvent(I2C1, I2C_EVENT_MASTER_MODE_SELECT));
+	if(I2C_WaitEvent(I2C_EVENT_MASTER_MODE_SELECT)) return 1;
 
 	/* Send EEPROM address for write */
 	I2C_Send7bitAddress(I2C1, MPU6050_WRITE_Address, I2C_Direction_Transmitter);
 	/* Test on EV6 and clear it */
-	while(!I2C_CheckEvent(I2C1, I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED));
+	if(I2C_WaitEvent(I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED)) return 1;
 
 	/* Clear EV6 by setting again the PE bit */
 	I2C_Cmd(I2C1, ENABLE);
@@ -272,21 +310,23 @@ void I2C_EE_BufferRead(u8* pBuffer,  u8 REG_Address,  u8 NumByteToRead)
 	/* Send the EEPROM's internal address to write to */
 	I2C_SendData(I2C1, REG_Address);  
 	/* Test on EV8 and clear it */
-	while(!I2C_CheckEvent(I2C1, I2C_EVENT_MASTER_BYTE_TRANSMITTED));
+	if(I2C_WaitEvent(I2C_EVENT_MASTER_BYTE_TRANSMITTED)) return 1;
 
 	/* Send STRAT condition a second time */  
 	I2C_GenerateSTART(I2C1, ENABLE);
 	/* Test on EV5 and clear it */
-	while(!I2C_CheckEvent(I2C1, I2C_EVENT_MASTER_MODE_SELECT));
+	if(I2C_WaitEvent(I2C_EVENT_MASTER_MODE_SELECT)) return 1;
 
 	/* Send EEPROM address for read */
 	I2C_Send7bitAddress(I2C1, MPU6050_WRITE_Address, I2C_Direction_Receiver);
 	/* Test on EV6 and clear it */
-	while(!I2C_CheckEvent(I2C1, I2C_EVENT_MASTER_RECEIVER_MODE_SELECTED));
+	if(I2C_WaitEvent(I2C_EVENT_MASTER_RECEIVER_MODE_SELECTED)) return 1;
 
 	/* While there is data to be read */
+	timeout = I2C_FLAG_TIMEOUT;
 	while(NumByteToRead)  
 	{
+		if((timeout--) == 0) return I2C_TIMEOUT_UserCallback();
 		if(NumByteToRead == 1)
 		{
 			/* Disable Acknowledgement */
@@ -303,10 +343,12 @@ void I2C_EE_BufferRead(u8* pBuffer,  u8 REG_Address,  u8 NumByteToRead)
 			pBuffer++; 
 			/* Decrement the read bytes counter */
 			NumByteToRead--;        
+			timeout = I2C_FLAG_TIMEOUT;
 		}   
 	}
 	/* Enable Acknowledgement to be ready for another reception */
 	I2C_AcknowledgeConfig(I2C1, ENABLE);
+	return 0;
 }
 
 /* I2C_ByteWrite
@@ -314,63 +356,66 @@ void I2C_EE_BufferRead(u8* pBuffer,  u8 REG_Address,  u8 NumByteToRead)
  *   REG_Address ݵIIC豸Ĵĵַ 
  *         REG_data д
  *   ڲ */	
-void I2C_ByteWrite(uint8_t WriteAddr,uint8_t REG_data)
+u8 I2C_ByteWrite(uint8_t WriteAddr,uint8_t REG_data)
 {
 	/* Send STRAT condition */
 	I2C_GenerateSTART(I2C1, ENABLE);
 	/* Test on EV5 and clear it */
-	while(!I2C_CheckEvent(I2C1, I2C_EVENT_MASTER_MODE_SELECT));  
+	if(I2C_WaitEvent(I2C_EVENT_MASTER_MODE_SELECT)) return 1;  
 	
 	/* Send EEPROM address for write */
 	I2C_Send7bitAddress(I2C1, MPU6050_WRITE_Address, I2C_Direction_Transmitter);
 	/* Test on EV6 and clear it */
-	while(!I2C_CheckEvent(I2C1, I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED));
+	if(I2C_WaitEvent(I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED)) return 1;
 
 	/* Send the EEPROM's internal address to write to */
 	I2C_SendData(I2C1, WriteAddr);
 	/* Test on EV8 and clear it */
-	while(!I2C_CheckEvent(I2C1, I2C_EVENT_MASTER_BYTE_TRANSMITTED));
+	if(I2C_WaitEvent(I2C_EVENT_MASTER_BYTE_TRANSMITTED)) return 1;
 	
 	/* Send the byte to be written */
 	I2C_SendData(I2C1, REG_data);    
 	/* Test on EV8 and clear it */
-	while(!I2C_CheckEvent(I2C1, I2C_EVENT_MASTER_BYTE_TRANSMITTED));  
+	if(I2C_WaitEvent(I2C_EVENT_MASTER_BYTE_TRANSMITTED)) return 1;  
 	
 	/* Send STOP condition */
 	I2C_GenerateSTOP(I2C1, ENABLE);
+	return 0;
 }
 
 /* I2C_ByteRead
  *   IIC豸Ĵ                         ȡһֽ
  *   REG_Address ȡݵļĴĵַ 
+ *         REG_data     (ʱ)
+ *   0:ɹ 1:ʱ
  *   ڲ */
-uint8_t I2C_ByteRead(uint8_t REG_Address)
+u8 I2C_ByteRead(uint8_t REG_Address,uint8_t *REG_data)
 {
-	uint8_t REG_data;
-	while(I2C_GetFlagStatus(I2C1,I2C_FLAG_BUSY));
+	if(I2C_WaitBusFree()) return 1;
 	
 	I2C_GenerateSTART(I2C1,ENABLE);//ʼź
-	while(!I2C_CheckEvent(I2C1,I2C_EVENT_MASTER_MODE_SELECT));
+	if(I2C_WaitEvent(I2C_EVENT_MASTER_MODE_SELECT)) return 1;
 	
 	I2C_Send7bitAddress(I2C1,MPU6050_WRITE_Address,I2C_Direction_Transmitter);//豸ַ+дź
-	while(!I2C_CheckEvent(I2C1,I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED));//
+	if(I2C_WaitEvent(I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED)) return 1;//
 	
 	I2C_Cmd(I2C1,ENABLE);
 	I2C_SendData(I2C1,REG_Address);//ʹ洢Ԫַ0ʼ
-	while(!I2C_CheckEvent(I2C1,I2C_EVENT_MASTER_BYTE_TRANSMITTED));
+	if(I2C_WaitEvent(I2C_EVENT_MASTER_BYTE_TRANSMITTED)) return 1;
 	
 	I2C_GenerateSTART(I2C1,ENABLE);//ʼź
-	while(!I2C_CheckEvent(I2C1,I2C_EVENT_MASTER_MODE_SELECT));
+	if(I2C_WaitEvent(I2C_EVENT_MASTER_MODE_SELECT)) return 1;
 	
 	I2C_Send7bitAddress(I2C1,MPU6050_WRITE_Address,I2C_Direction_Receiver);//豸ַ+ź
-	while(!I2C_CheckEvent(I2C1,I2C_EVENT_MASTER_RECEIVER_MODE_SELECTED));
+	if(I2C_WaitEvent(I2C_EVENT_MASTER_RECEIVER_MODE_SELECTED)) return 1;
 	
 	I2C_AcknowledgeConfig(I2C1,DISABLE);
 	I2C_GenerateSTOP(I2C1,ENABLE);
-	while(!(I2C_CheckEvent(I2C1,I2C_EVENT_MASTER_BYTE_RECEIVED)));
+	if(I2C_WaitEvent(I2C_EVENT_MASTER_BYTE_RECEIVED)) return 1;
 	
-	REG_data=I2C_ReceiveData(I2C1);//Ĵ
-	return REG_data;
+	*REG_data=I2C_ReceiveData(I2C1);//Ĵ
+	I2C_AcknowledgeConfig(I2C1,ENABLE);//ָӦ𣬹´ν
+	return 0;
 }
 
 //MPU6050Ǵ̷Χ
@@ -411,30 +456,32 @@ void MPU_Set_Rate(u16 rate)
 }
 
 /* GetData
- *   16λ
+ *   16λ (ֽǰ)
  *   REG_Address Ĵַ
- *   ؼĴ
+ *         data         (ʱ)
+ *   0:ɹ 1:ʱ
  *   ⲿ     */
-unsigned int GetData(unsigned char REG_Address)
+u8 GetData(unsigned char REG_Address,short *data)
 {
-	char H,L;
-	H=I2C_ByteRead(REG_Address);
-	L=I2C_ByteRead(REG_Address+1);
-	return (H<<8)+L;   //ϳ
+	u8 H,L;
+	if(I2C_ByteRead(REG_Address,&H)) return 1;
+	if(I2C_ByteRead(REG_Address+1,&L)) return 1;
+	*data=(short)((H<<8)|L);   //ϳ
+	return 0;
 }
 
 //õ¶ֵ
 /*¶ȴֵͨȡ 0X41 8 λ 0X42 8 λĴõ
 ¶Ȼ㹫ʽΪTemperature = 36.53 + regval/340
 У Temperature Ϊõ¶ֵλΪ棬 regval Ϊ 0X41  0X42 
-¶ȴֵ*/
-short MPU_Get_Temperature(void) 
+¶ȴֵ
+temp: ¶*10 (324==32.4)    0:ɹ 1:ʱ (ʱ temp)*/
+u8 MPU_Get_Temperature(short *temp) 
 {
-	float temp;
 	short HL;
-	HL=GetData(TEMP_OUT_H);
-    temp=36.53+( (double)HL )/340;  
-    return temp*10;//324==32.4
+	if(GetData(TEMP_OUT_H,&HL)) return 1;
+	*temp=(short)((36.53f+HL/340.0f)*10);
+	return 0;
 }
 
 
@@ -445,9 +492,9 @@ void MPU6050_WriteReg(uint8_t WriteAddr,uint8_t REG_data)
      I2C_ByteWrite(  WriteAddr,  REG_data);		    //IICдһֽ
 }
 
-void MPU6050_ReadData(uint8_t REG_Address,u8* pBuffer, u8 NumByteToRead)
+u8 MPU6050_ReadData(uint8_t REG_Address,u8* pBuffer, u8 NumByteToRead)
 {
-     I2C_EE_BufferRead( pBuffer,  REG_Address,  NumByteToRead);// (ҳ)ȡһ  
+     return I2C_EE_BufferRead( pBuffer,  REG_Address,  NumByteToRead);// (ҳ)ȡһ  
 }
 
 void MPU6050ReadID(void)//IDȡ
@@ -459,30 +506,16 @@ void MPU6050ReadID(void)//
 #if 1
 void MPU6050_GetDate(void)//MPU6050ݻȡ
 {
-	u8	acc_buf[6],//ٶ
-		temp_buf[2],//¶
-		gyro_buf[6];//ٶ
-	
-	MPU6050_ReadData(MPU6050_ACC_OUT, acc_buf, 6);		//ٶ
-	MPU6050_ReadData(TEMP_OUT_H,temp_buf, 2);			//¶
-	MPU6050_ReadData(MPU6050_GYRO_OUT, gyro_buf, 6);	//ٶ
-
-	MPU6050_buf[0] = acc_buf[0];
-	MPU6050_buf[1] = acc_buf[1];
-	MPU6050_buf[2] = acc_buf[2];
-	MPU6050_buf[3] = acc_buf[3];
-	MPU6050_buf[4] = acc_buf[4];
-	MPU6050_buf[5] = acc_buf[5];
-	
-	MPU6050_buf[6] = temp_buf[0];
-	MPU6050_buf[7] = temp_buf[1];
-	
-	MPU6050_buf[8]  = gyro_buf[0];
-	MPU6050_buf[9]  = gyro_buf[1];
-	MPU6050_buf[10] = gyro_buf[2];
-	MPU6050_buf[11] = gyro_buf[3];
-	MPU6050_buf[12] = gyro_buf[4];
-	MPU6050_buf[13] = gyro_buf[5];	
+	/* ACCEL_XOUT_H(0x3B) ~ GYRO_ZOUT_L(0x48) ַһͻ 14 ֽڣ
+	   ٶ[0..5] ¶[6..7] ٶ[8..13]ԭ 3 ζҪ 3  ʼ/Ѱַ  */
+	MPU6050_ReadData(MPU6050_ACC_OUT, MPU6050_buf, 14);
+}
+
+// һ֡ 14 ֽԭʼ װ MPU6050_buf ( DMA 첽ȡ ʹ)֮ճ MPU6050_DataCon
+void MPU6050_LoadRaw(const u8 *raw)
+{
+	u8 i;
+	for(i=0;i<14;i++) MPU6050_buf[i] = raw[i];
 }
 #endif
 
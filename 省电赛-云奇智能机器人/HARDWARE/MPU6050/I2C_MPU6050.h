@@ -300,22 +300,23 @@ void InitMPU6050(void);					//
 void I2C_MPU6050_Init(void);			//ʼIICIO			
 static void I2C_GPIO_Config(void);		//   I2C1 I/O
 static void I2C_Mode_Config(void);		//   I2C ģʽ
-unsigned int GetData(unsigned char REG_Address);	//16λ
-short MPU_Get_Temperature(void);//õ¶ֵ
+u8 GetData(unsigned char REG_Address,short *data);	//16λ 0:ɹ 1:ʱ
+u8 MPU_Get_Temperature(short *temp);//õ¶ֵ(*10) 0:ɹ 1:ʱ
 
 /*дһֽڵI2C豸Ĵ	
 	REG_Address ݵIIC豸Ĵĵַ
 	REG_data д */
-void I2C_ByteWrite(uint8_t WriteAddr,uint8_t REG_data);		    //IICдһֽ
+u8 I2C_ByteWrite(uint8_t WriteAddr,uint8_t REG_data);		    //IICдһֽ 0:ɹ 1:ʱ
 /* IIC豸Ĵжȡһֽ
-	REG_Address ȡݵļĴĵַ */
-uint8_t I2C_ByteRead(uint8_t REG_Address);						//IICһֽ
+	REG_Address ȡݵļĴĵַ
+	REG_data  (ʱ) */
+u8 I2C_ByteRead(uint8_t REG_Address,uint8_t *REG_data);		//IICһֽ 0:ɹ 1:ʱ
 
 /*  EEPROM                                                ȡһ (ҳ)      
 			pBuffer:	ŴEEPROMȡݵ  ָ
 		REG_Address:	ȡݵļĴĵַ
 	 NumByteToWrite:	ҪEEPROMȡֽ   */
-void I2C_EE_BufferRead(u8* pBuffer,  u8 REG_Address,  u8 NumByteToRead);// (ҳ)ȡһ  
+u8 I2C_EE_BufferRead(u8* pBuffer,  u8 REG_Address,  u8 NumByteToRead);// (ҳ)ȡһ 0:ɹ 1:ʱ
 
 /*  едI2C EEPROM   						    дһ(ҳ)  
 			pBuffer:	ŴEEPROMдݵ ָ
@@ -328,11 +329,13 @@ u8 I2C_EE_BufferWrite(u8 addr, uint8_t REG_Address , u8 NumByteToWrite,u8* pBuff
 			pBuffer:	ָ
 		REG_Address:	дַ
 	 NumByteToWrite:	дֽ   */
-void I2C_EE_PageWrite(u8* pBuffer, uint8_t REG_Address, u8 NumByteToWrite);
+u8 I2C_EE_PageWrite(u8* pBuffer, uint8_t REG_Address, u8 NumByteToWrite);
 
 // Wait for EEPROM Stand by state 
 void I2C_EE_WaitEepromStandbyState(void);
 
+extern u32 I2C_Timeout_Count;	//I2C ȴʱͳ
+
 
 //MPU6050Ǵ̷Χ
 //fsr:0,250dps;1,500dps;2,1000dps;3,2000dps
@@ -362,10 +365,11 @@ void MPU_Set_Rate(u16 rate);
 //void I2C_ByteWrite(uint8_t REG_Address,uint8_t REG_data);		//IICдһֽ
 void MPU6050_WriteReg(uint8_t REG_Address,uint8_t REG_data);
 
-void MPU6050_ReadData(uint8_t REG_Address,unsigned char* Read,u8 num);
+u8 MPU6050_ReadData(uint8_t REG_Address,unsigned char* Read,u8 num);//0:ɹ 1:ʱ
 
 void MPU6050ReadID(void);//IDȡ
-void MPU6050_GetDate(void);//MPU6050ݻȡ
+void MPU6050_GetDate(void);//MPU6050ݻȡ (ʽ 14ֽͻ)
+void MPU6050_LoadRaw(const u8 *raw);//װһ֡14ֽԭʼ (DMA 첽ȡ)
 void MPU6050_DataCon(Int16_xyz *Data_acc,Int16_xyz *Data_gyr);//MPU6050
 
 
@@ -0,0 +1,323 @@
+/******************** MPU6050 ж + DMA ȡ **************************
+ * Ӳӣ-----------------
+ *          |                 |
+ *          |  PB6-I2C1_SCL		|
+ *          |  PB7-I2C1_SDA   |
+ *          |                 |
+ *           -----------------
+ * Դ    I2C1 ¼/ж, DMA1 ͨ7 (I2C1_RX)
+ * 汾  ST3.5.0
+**********************************************************************************/
+#include "I2C_MPU6050_DMA.h"
+
+/* ״̬ÿ״̬ ȴ һ I2C ¼ */
+typedef enum{
+				MPU_DMA_IDLE = 0,
+				MPU_DMA_START,		//ѷ ʼ,        SB
+				MPU_DMA_ADDR_W,		//ѷ дַ,      ADDR
+				MPU_DMA_REG,		//ѷ Ĵַ,  BTF
+				MPU_DMA_RESTART,	//ѷ ظʼ,    SB
+				MPU_DMA_ADDR_R,		//ѷ ַ,      ADDR
+				MPU_DMA_DATA		//DMA ,       DMA 
+				}MPU_DMA_State;
+
+MPU6050_DMA_Stat MPU6050_DMA_Stats;
+
+static MPU6050_Sample		MPU6050_Ring[MPU6050_RING_NUM];	//˫
+static volatile MPU_DMA_State	MPU_DMA_state = MPU_DMA_IDLE;
+static volatile u8	ring_wr = 0;		//DMA дĿ
+static volatile u8	ring_latest = 0xFF;	//ɵĿ (0xFF: û)
+static u32			ring_seq = 0;		//֡
+static u32			read_seq = 0;		//ûϴζ֡
+static u32			start_cyc;			//δ俪ʼʱ
+static MPU6050_DMA_Callback	MPU6050_DMA_cb = 0;
+
+/* MPU6050_DMA_Init
+ *   I2C1 ¼/ж  DMA1 ͨ7 ʼ InitMPU6050() ֮
+ *   ⲿ */
+void MPU6050_DMA_Init(void)
+{
+	NVIC_InitTypeDef NVIC_InitStructure;
+
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);	//ʹDMA1ʱ
+	DWT_Cycle_Init();									//ʱ / ʱ ʹ DWT ڼ
+
+	DMA_DeInit(DMA1_Channel7);
+	DMA_ITConfig(DMA1_Channel7, DMA_IT_TC | DMA_IT_TE, ENABLE);
+
+	NVIC_InitStructure.NVIC_IRQChannel = I2C1_EV_IRQn;				//I2C1 ¼ж
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+	NVIC_InitStructure.NVIC_IRQChannel = I2C1_ER_IRQn;				//I2C1 ж
+	NVIC_Init(&NVIC_InitStructure);
+	NVIC_InitStructure.NVIC_IRQChannel = DMA1_Channel7_IRQn;		//DMA1 ͨ7 (I2C1_RX)
+	NVIC_Init(&NVIC_InitStructure);
+
+	I2C_ITConfig(I2C1, I2C_IT_ERR, ENABLE);	//жϳ¼ж ֻڴд
+	MPU_DMA_state = MPU_DMA_IDLE;
+}
+
+/* DMA1 ͨ7 ãI2C1->DR -> MPU6050_Ring[ring_wr].raw, 14 ֽ */
+static void MPU6050_DMA_RxConfig(void)
+{
+	DMA_InitTypeDef DMA_InitStructure;
+
+	DMA_Cmd(DMA1_Channel7, DISABLE);
+	DMA_InitStructure.DMA_PeripheralBaseAddr = (u32)&I2C1->DR;			//ַ
+	DMA_InitStructure.DMA_MemoryBaseAddr = (u32)MPU6050_Ring[ring_wr].raw;	//ڴַ
+	DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;					// -> ڴ
+	DMA_InitStructure.DMA_BufferSize = MPU6050_BURST_LEN;
+	DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+	DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+	DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+	DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+	DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+	DMA_InitStructure.DMA_Priority = DMA_Priority_VeryHigh;
+	DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+	DMA_Init(DMA1_Channel7, &DMA_InitStructure);
+	DMA_ITConfig(DMA1_Channel7, DMA_IT_TC | DMA_IT_TE, ENABLE);
+	DMA_Cmd(DMA1_Channel7, ENABLE);
+
+	I2C_DMALastTransferCmd(I2C1, ENABLE);	//һֽ Զ NACK
+	I2C_DMACmd(I2C1, ENABLE);
+}
+
+/*  us ΢ (DWTжҲã SysTick) */
+static void MPU6050_Bus_Wait(u32 us)
+{
+	u32 t = DWT_Get_Cycle();
+	while(DWT_Get_Cycle() - t < us * DWT_CLK_MHZ);
+}
+
+/* ߽ӻ һ뱻 һֱ SDAI2C1 λ Ų
+   PB6/PB7 ʱĳ ©SCL  9 ʱ ôӻֶֽ꣬ STOP */
+static void MPU6050_Bus_Clear(void)
+{
+	GPIO_InitTypeDef GPIO_InitStructure;
+	u8 i;
+
+	I2C_Cmd(I2C1, DISABLE);
+	GPIO_SetBits(GPIOB, GPIO_Pin_6 | GPIO_Pin_7);
+	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_6 | GPIO_Pin_7;
+	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_OD;
+	GPIO_Init(GPIOB, &GPIO_InitStructure);
+	for(i=0; i<9 && !GPIO_ReadInputDataBit(GPIOB, GPIO_Pin_7); i++)
+	{
+		GPIO_ResetBits(GPIOB, GPIO_Pin_6);
+		MPU6050_Bus_Wait(5);
+		GPIO_SetBits(GPIOB, GPIO_Pin_6);
+		MPU6050_Bus_Wait(5);
+	}
+	GPIO_ResetBits(GPIOB, GPIO_Pin_7);			//STOP: SCL ʱ SDA ɵͱ
+	MPU6050_Bus_Wait(5);
+	GPIO_SetBits(GPIOB, GPIO_Pin_7);
+	MPU6050_Bus_Wait(5);
+}
+
+/* ֹδ䣬ͷߣԱռʱ  λ I2C1 */
+static void MPU6050_DMA_Abort(void)
+{
+	I2C_ITConfig(I2C1, I2C_IT_EVT, DISABLE);
+	DMA_Cmd(DMA1_Channel7, DISABLE);
+	I2C_DMACmd(I2C1, DISABLE);
+	I2C_DMALastTransferCmd(I2C1, DISABLE);
+	I2C_ClearFlag(I2C1, I2C_FLAG_AF | I2C_FLAG_BERR | I2C_FLAG_ARLO | I2C_FLAG_OVR);
+	I2C_GenerateSTOP(I2C1, ENABLE);
+	if(I2C_GetFlagStatus(I2C1, I2C_FLAG_BUSY))
+	{
+		MPU6050_Bus_Clear();
+		I2C_SoftwareResetCmd(I2C1, ENABLE);
+		I2C_SoftwareResetCmd(I2C1, DISABLE);
+		I2C_MPU6050_Init();						// PB6/PB7 ÿ©  I2C1
+		I2C_ITConfig(I2C1, I2C_IT_ERR, ENABLE);
+		MPU6050_DMA_Stats.reset++;
+	}
+	I2C_AcknowledgeConfig(I2C1, ENABLE);
+	MPU6050_Ring[ring_wr].seq = 0;				//Ч
+	MPU_DMA_state = MPU_DMA_IDLE;
+}
+
+/* һ֡ɣ¼ʱ/ţл˫ */
+static void MPU6050_DMA_Finish(void)
+{
+	u32 cyc = DWT_Get_Cycle();
+	u8  done = ring_wr;
+
+	if(cyc - start_cyc > MPU6050_DMA_Stats.max_cyc) MPU6050_DMA_Stats.max_cyc = cyc - start_cyc;
+	MPU6050_Ring[done].stamp = cyc;
+	if(++ring_seq == 0) ring_seq = 1;			//0 Ϊ Ч
+	MPU6050_Ring[done].seq = ring_seq;
+	ring_latest = done;
+	ring_wr = (done + 1) % MPU6050_RING_NUM;
+	MPU6050_DMA_Stats.ok++;
+	MPU_DMA_state = MPU_DMA_IDLE;
+	if(MPU6050_DMA_cb) MPU6050_DMA_cb(&MPU6050_Ring[done]);
+}
+
+/* MPU6050_DMA_Start
+ *   һ 14 ֽͻ, 
+ *   0:ѷ  1:һλû  2:æ */
+u8 MPU6050_DMA_Start(void)
+{
+	if(MPU_DMA_state != MPU_DMA_IDLE)
+	{
+		MPU6050_DMA_Stats.busy++;
+		return 1;
+	}
+	if(I2C_GetFlagStatus(I2C1, I2C_FLAG_BUSY)) return 2;	//ʽĶдû
+
+	MPU6050_Ring[ring_wr].seq = 0;				//ʼд룬ΪЧ (ȡݴض)
+	start_cyc = DWT_Get_Cycle();
+	MPU_DMA_state = MPU_DMA_START;
+	I2C_AcknowledgeConfig(I2C1, ENABLE);
+	I2C_ITConfig(I2C1, I2C_IT_EVT, ENABLE);		//ֻ¼жϣж ( DMA )
+	I2C_GenerateSTART(I2C1, ENABLE);
+	return 0;
+}
+
+/* MPU6050_DMA_Poll
+ *   /ʱ⣺
+ *         SR1  AF(NACK)/BERR/ARLO/OVR жûʰ (ס  λû) ֹ
+ *         䳬 MPU6050_DMA_TIMEOUT_US Ҳֹֹʱ ߻ռ ͽ λ I2C1
+ *   ѭ  ȼʱж */
+void MPU6050_DMA_Poll(void)
+{
+	u8 err, late;
+
+	if(MPU_DMA_state == MPU_DMA_IDLE) return;
+	err = (I2C1->SR1 & (I2C_SR1_AF | I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_OVR)) != 0;
+	late = DWT_Get_Cycle() - start_cyc > (u32)MPU6050_DMA_TIMEOUT_US * DWT_CLK_MHZ;
+	if(!err && !late) return;
+	NVIC_DisableIRQ(I2C1_EV_IRQn);
+	NVIC_DisableIRQ(I2C1_ER_IRQn);
+	NVIC_DisableIRQ(DMA1_Channel7_IRQn);
+	if(MPU_DMA_state != MPU_DMA_IDLE)		//жϺȷһΣ/жϾ
+	{
+		MPU6050_DMA_Abort();
+		if(err) MPU6050_DMA_Stats.err++;
+		else    MPU6050_DMA_Stats.timeout++;
+	}
+	NVIC_EnableIRQ(DMA1_Channel7_IRQn);
+	NVIC_EnableIRQ(I2C1_ER_IRQn);
+	NVIC_EnableIRQ(I2C1_EV_IRQn);
+}
+
+u8 MPU6050_DMA_IsBusy(void)
+{
+	return MPU_DMA_state != MPU_DMA_IDLE;
+}
+
+/* MPU6050_DMA_Read
+ *    һ֡б DMA д (seq 仯) ض
+ *   1:   0: û */
+u8 MPU6050_DMA_Read(MPU6050_Sample *out)
+{
+	u8  i, retry, idx;
+	u32 seq;
+
+	for(retry=0; retry<3; retry++)
+	{
+		idx = ring_latest;
+		if(idx >= MPU6050_RING_NUM) return 0;	//ûɹһ֡
+		seq = MPU6050_Ring[idx].seq;
+		if(seq == 0) continue;					// DMA д
+		for(i=0; i<MPU6050_BURST_LEN; i++) out->raw[i] = MPU6050_Ring[idx].raw[i];
+		out->stamp = MPU6050_Ring[idx].stamp;
+		out->seq = seq;
+		if(MPU6050_Ring[idx].seq != seq) continue;	//ڼ䱻д
+		if(seq == read_seq) return 0;
+		read_seq = seq;
+		return 1;
+	}
+	return 0;
+}
+
+void MPU6050_DMA_SetCallback(MPU6050_DMA_Callback cb)
+{
+	MPU6050_DMA_cb = cb;
+}
+
+/* **************** I2C1 ¼жϣƽ ʼ/Ѱַ ״̬ **************** */
+void I2C1_EV_IRQHandler(void)
+{
+	u16 sr1 = I2C1->SR1;
+
+	switch(MPU_DMA_state)
+	{
+		case MPU_DMA_START:		//EV5: SR1 + дDR  SB
+			if(sr1 & I2C_SR1_SB)
+			{
+				I2C_Send7bitAddress(I2C1, MPU6050_WRITE_Address, I2C_Direction_Transmitter);
+				MPU_DMA_state = MPU_DMA_ADDR_W;
+			}
+			break;
+		case MPU_DMA_ADDR_W:	//EV6: SR1 + SR2  ADDR
+			if(sr1 & I2C_SR1_ADDR)
+			{
+				(void)I2C1->SR2;
+				I2C_SendData(I2C1, MPU6050_ACC_OUT);	// ACCEL_XOUT_H ʼ
+				MPU_DMA_state = MPU_DMA_REG;
+			}
+			break;
+		case MPU_DMA_REG:		//EV8_2: Ĵַ
+			if(sr1 & I2C_SR1_BTF)
+			{
+				I2C_GenerateSTART(I2C1, ENABLE);		//ظʼ
+				MPU_DMA_state = MPU_DMA_RESTART;
+			}
+			break;
+		case MPU_DMA_RESTART:
+			if(sr1 & I2C_SR1_SB)
+			{
+				MPU6050_DMA_RxConfig();					// ADDR ֮ǰ ʹ DMA
+				I2C_Send7bitAddress(I2C1, MPU6050_WRITE_Address, I2C_Direction_Receiver);
+				MPU_DMA_state = MPU_DMA_ADDR_R;
+			}
+			break;
+		case MPU_DMA_ADDR_R:
+			if(sr1 & I2C_SR1_ADDR)
+			{
+				I2C_ITConfig(I2C1, I2C_IT_EVT, DISABLE);	//֮󽻸 DMA
+				(void)I2C1->SR2;
+				MPU_DMA_state = MPU_DMA_DATA;
+			}
+			break;
+		default:				//ڴУص¼ж ֹж
+			I2C_ITConfig(I2C1, I2C_IT_EVT, DISABLE);
+			break;
+	}
+}
+
+/* **************** I2C1 жϣӦʧ/ߴ/ٲöʧ **************** */
+void I2C1_ER_IRQHandler(void)
+{
+	I2C_ClearITPendingBit(I2C1, I2C_IT_AF | I2C_IT_BERR | I2C_IT_ARLO | I2C_IT_OVR);
+	if(MPU_DMA_state != MPU_DMA_IDLE)
+	{
+		MPU6050_DMA_Abort();
+		MPU6050_DMA_Stats.err++;
+	}
+}
+
+/* **************** DMA1 ͨ7 (I2C1_RX)  **************** */
+void DMA1_Channel7_IRQHandler(void)
+{
+	if(DMA_GetITStatus(DMA1_IT_TC7))
+	{
+		DMA_ClearITPendingBit(DMA1_IT_GL7);
+		I2C_GenerateSTOP(I2C1, ENABLE);
+		DMA_Cmd(DMA1_Channel7, DISABLE);
+		I2C_DMACmd(I2C1, DISABLE);
+		I2C_DMALastTransferCmd(I2C1, DISABLE);
+		MPU6050_DMA_Finish();
+	}
+	else if(DMA_GetITStatus(DMA1_IT_TE7))
+	{
+		DMA_ClearITPendingBit(DMA1_IT_GL7);
+		MPU6050_DMA_Abort();
+		MPU6050_DMA_Stats.err++;
+	}
+}
@@ -0,0 +1,58 @@
+#ifndef __I2C_MPU6050_DMA_H
+#define	__I2C_MPU6050_DMA_H
+#include "stm32f10x.h"
+#include "I2C_MPU6050.h"
+
+/*MPU6050 ж + DMA ʽ  ȡ
+  Ҫ FWLibļ "stm32f10x_i2c.c"  "stm32f10x_dma.c"  "misc.c"
+
+  һ 14 ֽͻ ACCEL_XOUT_H(0x3B) ~ GYRO_ZOUT_L(0x48)
+	ʼ/Ѱַ/Ĵַ/ظʼ  I2C1 ¼ж ƽ
+	14 ֽ DMA1 ͨ7 (I2C1_RX) գж﷢ STOP
+  CPU ֻ 5 ¼ж + 1  DMA жͣ us
+  ԭ MPU6050_GetDate() Լ 3 x 150us ʱȫѭ
+
+  ʹã
+	InitMPU6050();				//ʽ üĴ (ֻϵʱ)
+	MPU6050_DMA_Init();
+	MPU6050_DMA_Start();		//ʱж / ݾж ﴥ
+	MPU6050_DMA_Poll();			//ѭ ʱ
+	if(MPU6050_DMA_Read(&s)) { MPU6050_LoadRaw(s.raw); MPU6050_DataCon(&Accel,&Gyro); }
+*/
+
+#define MPU6050_BURST_LEN		14		//ٶ6 + ¶2 + ٶ6
+#define MPU6050_RING_NUM		2		//˫壺DMA дһ飬ûһ
+#define MPU6050_DMA_TIMEOUT_US	2000	//һͻʱʱ (400KHz Լ 450us)
+
+typedef struct{
+				u8  raw[MPU6050_BURST_LEN];	//ԭʼ ֽǰ
+				u32 stamp;					//ʱ (DWT )
+				u32 seq;					//֡ (0 ʾ д/Ч)
+				}MPU6050_Sample;
+
+typedef struct{
+				u32 ok;			//ɹ֡
+				u32 err;		//ߴ (AF/BERR/ARLO/OVR)
+				u32 timeout;	//ʱ
+				u32 busy;		//һδֱĴ
+				u32 reset;		//߱ռס λ I2C1 Ĵ
+				u32 max_cyc;	//δʱ (DWT )
+				}MPU6050_DMA_Stat;
+
+typedef void (*MPU6050_DMA_Callback)(const MPU6050_Sample *sample);
+
+extern MPU6050_DMA_Stat MPU6050_DMA_Stats;
+
+void MPU6050_DMA_Init(void);	//I2C1 ¼/ж + DMA1 ͨ7 ʼ
+/* һ 14 ֽͻ, 
+	0:ѷ  1:һλû  2:æ */
+u8 MPU6050_DMA_Start(void);
+void MPU6050_DMA_Poll(void);	///ʱ⣬ֹ߿ס λ I2C1 (ѭ/ʱе)
+u8 MPU6050_DMA_IsBusy(void);	//1: ڴ
+/* ȡ һ֡ ()
+	 1: бϴζȡµ  0: û */
+u8 MPU6050_DMA_Read(MPU6050_Sample *out);
+/*  ɻص ( DMA жִУҪ̣sample һ Start ֮ǰЧ) */
+void MPU6050_DMA_SetCallback(MPU6050_DMA_Callback cb);
+
+#endif /* __I2C_MPU6050_DMA_H */
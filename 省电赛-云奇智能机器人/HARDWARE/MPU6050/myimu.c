@@ -10,34 +10,29 @@
 
 float AngleOffset_Rol=0.0,AngleOffset_Pit=0;
 
+/* ٶ˲3 ͨ FILTER_NUM  ƽ
+   ԭÿ 3 x 20 ʷֵͣ filter.c кͣ
+   ÿֻ ¼ + 3 γԭͬ */
+MA_FILTER_DEF(acc_filter, 3, FILTER_NUM);
+
 void Accel_Con(Int16_xyz *acc_in,Int16_xyz *acc_out)//ٶ˲
 {
-	static uint8_t 	filter_cnt=0;
-	static int16_t	ACC_X_BUF[FILTER_NUM]={0},ACC_Y_BUF[FILTER_NUM]={0},ACC_Z_BUF[FILTER_NUM]={0};
-	int32_t temp1=0,temp2=0,temp3=0;
-	uint8_t i;
-
-	ACC_X_BUF[filter_cnt] = acc_in->X;
-	ACC_Y_BUF[filter_cnt] = acc_in->Y;
-	ACC_Z_BUF[filter_cnt] = acc_in->Z;
-	for(i=0;i<FILTER_NUM;i++)
-	{
-		temp1 += ACC_X_BUF[i];
-		temp2 += ACC_Y_BUF[i];
-		temp3 += ACC_Z_BUF[i];
-	}
-	acc_out->X = temp1 / FILTER_NUM;
-	acc_out->Y = temp2 / FILTER_NUM;
-	acc_out->Z = temp3 / FILTER_NUM;
-//	printf("temp1 %d\ttemp2 %d\ttemp3 %d\r\n",temp1,temp2,temp3);
-	filter_cnt++;
-	if(filter_cnt==FILTER_NUM)	filter_cnt=0;
+	s16 in[3], out[3];
+
+	in[0] = acc_in->X;
+	in[1] = acc_in->Y;
+	in[2] = acc_in->Z;
+	MA_Filter_Update(&acc_filter, in, out);
+	acc_out->X = out[0];
+	acc_out->Y = out[1];
+	acc_out->Z = out[2];
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 #define Kp 1.6f                        // proportional gain governs rate of convergence to accelerometer/magnetometer
 #define Ki 0.001f                      // integral gain governs rate of convergence of gyroscope biases
-#define halfT 0.001f                   // half the sample period ڵһ
+float IMU_halfT = 0.001f;              // half the sample period ڵһ (IMU_Set_Period ޸)
+#define halfT IMU_halfT
 
 float q0 = 1, q1 = 0, q2 = 0, q3 = 0;  // quaternion elements representing the estimated orientation
 float exInt = 0, eyInt = 0, ezInt = 0; // scaled integral error
@@ -102,8 +97,255 @@ void IMUupdate(Int16_xyz *gyr, Int16_xyz *acc, Float_angle *angle)
 	q2 = q2 / norm;
 	q3 = q3 / norm;
 	//õ//
-	angle->yaw += -gyr->Z*Gyro_G*0.002f;
+	angle->yaw += -gyr->Z*Gyro_G*(2*halfT);
 	angle->rol = -asin(-2 * q1 * q3 + 2 * q0* q2)* 57.3 - AngleOffset_Pit; // pitch
 	angle->pit = -atan2(2 * q2 * q3 + 2 * q0 * q1, -2 * q1 * q1 - 2 * q2* q2 + 1)* 57.3 - AngleOffset_Rol; // roll
 }
 
+
+// IMUupdate Ĳ (us) 2ms һ: IMU_Set_Period(2000)
+void IMU_Set_Period(u32 dt_us)
+{
+	IMU_halfT = dt_us * 0.0000005f;
+}
+
+// DWT ʱ (MPU6050_Sample.stamp  DWT_Get_Cycle()) ϴεõ (us)
+//һε  쳣ʱ  IMU_DT_DEFAULT_US
+u32 IMU_Get_dt_us(u32 stamp)
+{
+	static u32 last_stamp = 0;
+	static u8  first = 1;
+	u32 dt;
+
+	dt = DWT_CYC_TO_US(stamp - last_stamp);
+	last_stamp = stamp;
+	if(first || dt == 0 || dt > IMU_DT_MAX_US)
+	{
+		first = 0;
+		return IMU_DT_DEFAULT_US;
+	}
+	return dt;
+}
+
+/******************************************************************************
+ *  ̬ ( IMUupdate ͬһ㷨ͬһӿ)
+ * STM32F103 û FPUIMUupdate ÿ float ˳sqrtasinatan2 ⺯
+ * ȫĳ 32/64 λ㣺
+ *		Ԫ/λ   Q30  (1.0 = 1<<30)
+ *		һ             + 2 ţٵ  1/sqrt
+ *		asin/atan2        ˷Բ + ʽ (Q15) < 0.01 
+ *  dt_us ɵߴ (IMU_Get_dt_us ʱ)д halfT
+ ******************************************************************************/
+#define Q30_ONE			((s32)1<<30)
+#define Q30_MUL(a,b)	((s32)(((int64_t)(a)*(b))>>30))
+#define KP_Q30			1717986918		//Kp  1.6   (Q30)
+#define KI_Q30			1073742			//Ki  0.001 (Q30)
+#define GYRO_GR_Q30		1143857			//Gyro_Gr   ٶLSB -> rad/s (Q30)
+#define GYRO_G_US_Q48	17179853		//Gyro_G/1e6 ٶLSB x us ->  (Q48)
+#define EXINT_LIMIT		Q30_ONE			//޷ (汾ûУ)
+
+static s32 qq0 = Q30_ONE, qq1 = 0, qq2 = 0, qq3 = 0;	//Ԫ Q30
+static s32 qexInt = 0, qeyInt = 0, qezInt = 0;			// Q30
+
+//32λ ǰ (ַڽ)
+static u8 fx_clz32(u32 x)
+{
+	u8 n = 0;
+	if(x == 0) return 32;
+	if(!(x & 0xFFFF0000)) { n += 16; x <<= 16; }
+	if(!(x & 0xFF000000)) { n += 8;  x <<= 8;  }
+	if(!(x & 0xF0000000)) { n += 4;  x <<= 4;  }
+	if(!(x & 0xC0000000)) { n += 2;  x <<= 2;  }
+	if(!(x & 0x80000000)) { n += 1; }
+	return n;
+}
+
+/* 1/sqrt(x) ֵm һ [0.25,1) 4 λ 12 Σȡе (Q29) */
+static const u32 invsqrt_tab[12] = {
+	1012333500, 915690104, 842312387, 784150157, 736580814, 696735698,
+	662727842,  633258380, 607400100, 584471019, 563956835, 545461392
+};
+
+/* 1/sqrt(x), x>0
+    Q29 β y*k Ϊָ1/sqrt(x) = y * 2^(-29-k) */
+static u32 fx_invsqrt(uint64_t x, s32 *k)
+{
+	s32 e, bits;
+	u32 m, y, t;
+
+	//x Чλ
+	if(x >> 32) bits = 64 - fx_clz32((u32)(x >> 32));
+	else        bits = 32 - fx_clz32((u32)x);
+	//żλʹ m  [2^28, 2^30)   [0.25,1)  Q30
+	e = bits - 30;
+	if(e & 1) e++;
+	if(e >= 0) m = (u32)(x >> e);
+	else       m = (u32)(x << (-e));
+
+	y = invsqrt_tab[(m >> 26) - 4];
+	//ţٵ y = y*(3 - m*y*y)/2
+	t = (u32)(((uint64_t)m * y) >> 29);			//m*y    Q30
+	t = (u32)(((uint64_t)t * y) >> 29);			//m*y*y  Q30
+	y = (u32)(((uint64_t)y * ((3u<<30) - t)) >> 31);
+	t = (u32)(((uint64_t)m * y) >> 29);
+	t = (u32)(((uint64_t)t * y) >> 29);
+	y = (u32)(((uint64_t)y * ((3u<<30) - t)) >> 31);
+
+	*k = 15 + e / 2;
+	return y;
+}
+
+//v * y * 2^(1-k) fx_invsqrt õ λ (Q30)
+static s32 fx_scale(s32 v, u32 y, s32 k)
+{
+	int64_t p = (int64_t)v * y;
+	if(k >= 1) return (s32)(p >> (k - 1));
+	return (s32)(p << (1 - k));
+}
+
+/* atan2(y,x)y/x ͬһ꣬  Q29 */
+static s32 fx_atan2(s32 y, s32 x)
+{
+	u32 ay = y < 0 ? -(u32)y : (u32)y;
+	u32 ax = x < 0 ? -(u32)x : (u32)x;
+	u32 num, den;
+	s32 z, z2, p, a;
+	u8  swap = 0, sh;
+
+	if(ax == 0 && ay == 0) return 0;
+	if(ay > ax) { num = ax; den = ay; swap = 1; }	//֤ z = num/den <= 1
+	else        { num = ay; den = ax; }
+	sh = fx_clz32(den) - 1;							//den Ŵ [2^30,2^31)
+	den <<= sh; num <<= sh;
+	z = (s32)(num / (den >> 15));					//Q15
+	if(z > 32768) z = 32768;
+	//atan(z) = z*(c1 + c3 z^2 + c5 z^4 + c7 z^6 + c9 z^8)   0<=z<=1
+	z2 = (z * z) >> 15;
+	p = 683;
+	p = -2790 + ((p * z2) >> 15);
+	p =  5903 + ((p * z2) >> 15);
+	p = -10823 + ((p * z2) >> 15);
+	p = 32764 + ((p * z2) >> 15);
+	a = ((p * z) >> 15) << 14;						//Q15 -> Q29
+	if(swap) a = 843314857 - a;						//pi/2 - a      (pi/2 Q29)
+	if(x < 0) a = 1686629713 - a;					//pi - a        (pi   Q29)
+	return y < 0 ? -a : a;
+}
+
+/* asin(v)  v Ϊ Q30  Q29 */
+static s32 fx_asin(s32 v)
+{
+	s32 w, c, k;
+	u32 y;
+
+	if(v >  Q30_ONE) v =  Q30_ONE;
+	if(v < -Q30_ONE) v = -Q30_ONE;
+	w = Q30_ONE - Q30_MUL(v, v);			//1 - v^2
+	if(w <= 0) c = 0;
+	else
+	{
+		y = fx_invsqrt((uint64_t)w, &k);
+		c = (s32)(((int64_t)w * y) >> (14 + k));	//sqrt(1-v^2)  Q30
+	}
+	return fx_atan2(v, c);
+}
+
+//λ (Ԫصˮƽ)
+void IMUupdate_Q_Reset(void)
+{
+	qq0 = Q30_ONE; qq1 = qq2 = qq3 = 0;
+	qexInt = qeyInt = qezInt = 0;
+}
+
+// IMU ̬㣬dt_us: ϴεõʱ (us)
+void IMUupdate_Q(Int16_xyz *gyr, Int16_xyz *acc, Float_angle *angle, u32 dt_us)
+{
+	s32 ax, ay, az, k;
+	s32 vx, vy, vz, ex, ey, ez;
+	s32 gx, gy, gz, hT;
+	s32 t0, t1, t2, t3;
+	u32 y;
+
+	if(acc->X == 0 || acc->Y == 0 || acc->Z == 0) return;
+	if(dt_us > IMU_DT_MAX_US) dt_us = IMU_DT_MAX_US;
+	hT = (s32)(((uint64_t)dt_us * 8796093) >> 14);		//halfT  Q30  (2^30/2e6 = 536.87)
+
+	//acc ݹһ
+	ax = acc->X; ay = acc->Y; az = acc->Z;
+	y = fx_invsqrt((uint64_t)((int64_t)ax*ax + (int64_t)ay*ay + (int64_t)az*az), &k);
+	ax = fx_scale(ax, y, k);
+	ay = fx_scale(ay, y, k);
+	az = fx_scale(az, y, k);
+	//Ԫ  ϵϵ λ
+	vx = 2 * (Q30_MUL(qq1, qq3) - Q30_MUL(qq0, qq2));
+	vy = 2 * (Q30_MUL(qq0, qq1) + Q30_MUL(qq2, qq3));
+	vz = Q30_MUL(qq0, qq0) - Q30_MUL(qq1, qq1) - Q30_MUL(qq2, qq2) + Q30_MUL(qq3, qq3);
+	// = 
+	ex = Q30_MUL(ay, vz) - Q30_MUL(az, vy);
+	ey = Q30_MUL(az, vx) - Q30_MUL(ax, vz);
+	ez = Q30_MUL(ax, vy) - Q30_MUL(ay, vx);
+	// (ͬ汾ÿεûһ)
+	qexInt += Q30_MUL(ex, KI_Q30);
+	qeyInt += Q30_MUL(ey, KI_Q30);
+	qezInt += Q30_MUL(ez, KI_Q30);
+	if(qexInt > EXINT_LIMIT) qexInt = EXINT_LIMIT; else if(qexInt < -EXINT_LIMIT) qexInt = -EXINT_LIMIT;
+	if(qeyInt > EXINT_LIMIT) qeyInt = EXINT_LIMIT; else if(qeyInt < -EXINT_LIMIT) qeyInt = -EXINT_LIMIT;
+	if(qezInt > EXINT_LIMIT) qezInt = EXINT_LIMIT; else if(qezInt < -EXINT_LIMIT) qezInt = -EXINT_LIMIT;
+	//( + PI ) * halfT  -> 벽ת Q30
+	gx = (s32)((((int64_t)gyr->X * GYRO_GR_Q30 + Q30_MUL(ex, KP_Q30) + qexInt) * hT) >> 30);
+	gy = (s32)((((int64_t)gyr->Y * GYRO_GR_Q30 + Q30_MUL(ey, KP_Q30) + qeyInt) * hT) >> 30);
+	gz = (s32)((((int64_t)gyr->Z * GYRO_GR_Q30 + Q30_MUL(ez, KP_Q30) + qezInt) * hT) >> 30);
+	//һױϿ (븡汾ͬ ˳)
+	qq0 += (s32)(((int64_t)-qq1*gx - (int64_t)qq2*gy - (int64_t)qq3*gz) >> 30);
+	qq1 += (s32)(((int64_t) qq0*gx + (int64_t)qq2*gz - (int64_t)qq3*gy) >> 30);
+	qq2 += (s32)(((int64_t) qq0*gy - (int64_t)qq1*gz + (int64_t)qq3*gx) >> 30);
+	qq3 += (s32)(((int64_t) qq0*gz + (int64_t)qq1*gy - (int64_t)qq2*gx) >> 30);
+	//Ԫһ
+	y = fx_invsqrt((uint64_t)((int64_t)qq0*qq0 + (int64_t)qq1*qq1 + (int64_t)qq2*qq2 + (int64_t)qq3*qq3), &k);
+	qq0 = fx_scale(qq0, y, k);
+	qq1 = fx_scale(qq1, y, k);
+	qq2 = fx_scale(qq2, y, k);
+	qq3 = fx_scale(qq3, y, k);
+	//// (Q29 -> , 븡汾ͬ 57.3)
+	t0 = 2 * (Q30_MUL(qq0, qq2) - Q30_MUL(qq1, qq3));
+	t1 = 2 * (Q30_MUL(qq2, qq3) + Q30_MUL(qq0, qq1));
+	t2 = Q30_ONE - 2 * (Q30_MUL(qq1, qq1) + Q30_MUL(qq2, qq2));
+	t3 = (s32)(((int64_t)-gyr->Z * dt_us * GYRO_G_US_Q48 + ((int64_t)1<<31)) >> 32);	//  Q16 (룬ۻƫ)
+	angle->yaw += t3 * (1.0f / 65536);
+	angle->rol = -fx_asin(t0) * (57.3f / (1<<29)) - AngleOffset_Pit; // pitch
+	angle->pit = -fx_atan2(t1, t2) * (57.3f / (1<<29)) - AngleOffset_Rol; // roll
+}
+
+/******************************************************************************
+ * / ֽ ִʱԱ (DWT ڼ) printf 
+ * ͬһ   times Σǰ󱣴/ָ ״̬Ӱ
+ ******************************************************************************/
+void IMU_Benchmark(Int16_xyz *gyr, Int16_xyz *acc, u16 times)
+{
+	float s_q[4], s_e[3], s_halfT = IMU_halfT;
+	s32 s_qq[4], s_qe[3];
+	Float_angle a_f = {0,0,0}, a_q = {0,0,0};
+	u32 c0, c_float, c_fixed;
+	u16 n;
+
+	if(times == 0) return;
+	DWT_Cycle_Init();
+	s_q[0]=q0; s_q[1]=q1; s_q[2]=q2; s_q[3]=q3; s_e[0]=exInt; s_e[1]=eyInt; s_e[2]=ezInt;
+	s_qq[0]=qq0; s_qq[1]=qq1; s_qq[2]=qq2; s_qq[3]=qq3; s_qe[0]=qexInt; s_qe[1]=qeyInt; s_qe[2]=qezInt;
+
+	IMU_Set_Period(IMU_DT_DEFAULT_US);
+	c0 = DWT_Get_Cycle();
+	for(n=0; n<times; n++) IMUupdate(gyr, acc, &a_f);
+	c_float = DWT_Get_Cycle() - c0;
+
+	c0 = DWT_Get_Cycle();
+	for(n=0; n<times; n++) IMUupdate_Q(gyr, acc, &a_q, IMU_DT_DEFAULT_US);
+	c_fixed = DWT_Get_Cycle() - c0;
+
+	printf("IMU  : %lu /   : %lu /\r\n", (unsigned long)(c_float/times), (unsigned long)(c_fixed/times));
+	printf("IMU  rol %f pit %f   rol %f pit %f\r\n", a_f.rol, a_f.pit, a_q.rol, a_q.pit);
+
+	q0=s_q[0]; q1=s_q[1]; q2=s_q[2]; q3=s_q[3]; exInt=s_e[0]; eyInt=s_e[1]; ezInt=s_e[2];
+	qq0=s_qq[0]; qq1=s_qq[1]; qq2=s_qq[2]; qq3=s_qq[3]; qexInt=s_qe[0]; qeyInt=s_qe[1]; qezInt=s_qe[2];
+	IMU_halfT = s_halfT;
+}
@@ -4,6 +4,7 @@
 #include "I2C_MPU6050.h"
 #include "math.h"
 #include "usart.h"
+#include "filter.h"
 
 extern float AngleOffset_Rol,AngleOffset_Pit; 
 
@@ -11,5 +12,18 @@ void Accel_Con(Int16_xyz *acc_in,Int16_xyz *acc_out);
 
 void IMUupdate(Int16_xyz *gyr, Int16_xyz *acc, Float_angle *angle);
 
+#define IMU_DT_DEFAULT_US	2000	//Ĭϲ 2ms
+#define IMU_DT_MAX_US		50000	// (ΪǶ֡/)
+
+extern float IMU_halfT;
+void IMU_Set_Period(u32 dt_us);	// IMUupdate Ĳ (us)
+u32  IMU_Get_dt_us(u32 stamp);	// DWT ʱ  (us)
+
+// ̬ (Q30 Ԫ޸)
+void IMUupdate_Q(Int16_xyz *gyr, Int16_xyz *acc, Float_angle *angle, u32 dt_us);
+void IMUupdate_Q_Reset(void);
+/// ִʱԱ (DWT )printf 
+void IMU_Benchmark(Int16_xyz *gyr, Int16_xyz *acc, u16 times);
+
 
 #endif
@@ -18,6 +18,11 @@
 //[5]0 1 2 3 ... 127	
 //[6]0 1 2 3 ... 127	
 //[7]0 1 2 3 ... 127 			   
+static u8 OLED_GRAM[8][Max_Column];	//1KB Դ棬OLED_FB_xxx ֻOLED_Refresh ٷ
+static u8 OLED_Dirty_x0[8]={Max_Column,Max_Column,Max_Column,Max_Column,
+							Max_Column,Max_Column,Max_Column,Max_Column};	//ÿҳ зΧ [x0,x1]
+static u8 OLED_Dirty_x1[8]={0};		//x0>x1 ʾҳûиĶ
+static u8 OLED_Refresh_Page=0;		//OLED_Refresh_Step ´δһҳʼ
 /**********************************************
 //IIC Start
 **********************************************/
@@ -134,6 +139,26 @@ void OLED_WR_Byte(unsigned dat,unsigned cmd)
 }
 
 
+/**********************************************
+// IIC Write Block
+// һ IIC д len ֽڣʼ + ַ + ֽ ֻһ
+// ctrl: 0x00    0x40  (еַԶ1)
+**********************************************/
+void Write_IIC_Block(unsigned char ctrl,const unsigned char *buf,unsigned char len)
+{
+	IIC_Start();
+	Write_IIC_Byte(0x78);
+	IIC_Wait_Ack();
+	Write_IIC_Byte(ctrl);
+	IIC_Wait_Ack();
+	while(len--)
+	{
+		Write_IIC_Byte(*buf++);
+		IIC_Wait_Ack();
+	}
+	IIC_Stop();
+}
+
 /********************************************
 // fill_Picture
 ********************************************/
@@ -318,6 +343,184 @@ void OLED_DrawBMP(unsigned char x0, unsigned char y0,unsigned char x1, unsigned
 	}
 } 
 
+/***********************Դ (֡) ͼ****************************************/
+// OLED_FB_xxx / OLED_DrawPoint / OLED_Fill ֻ OLED_GRAM ¼
+// IIC OLED_Refresh() ѭﷴ OLED_Refresh_Step() ͵ϡ
+//ÿҳֻ 1  + 1 ݴ䣬ԭÿֽڶҪ ʼ/ַ///ֹͣ
+
+// page ҳ x0~x1  Ҫˢ
+static void OLED_FB_Dirty(u8 page,u8 x0,u8 x1)
+{
+	if(page>7) return;
+	if(x1>Max_Column-1) x1=Max_Column-1;
+	if(x0<OLED_Dirty_x0[page]) OLED_Dirty_x0[page]=x0;
+	if(x1>OLED_Dirty_x1[page]) OLED_Dirty_x1[page]=x1;
+}
+
+//Դ (Ϊ)
+void OLED_FB_Clear(void)
+{
+	u8 i,n;
+	for(i=0;i<8;i++)
+	{
+		for(n=0;n<Max_Column;n++) OLED_GRAM[i][n]=0;
+		OLED_FB_Dirty(i,0,Max_Column-1);
+	}
+}
+
+//
+//x:0~127
+//y:0~63
+//t:1  0,
+void OLED_DrawPoint(u8 x,u8 y,u8 t)
+{
+	if(x>Max_Column-1||y>Max_Row-1) return;
+	if(t) OLED_GRAM[y>>3][x]|=1<<(y&7);
+	else  OLED_GRAM[y>>3][x]&=~(1<<(y&7));
+	OLED_FB_Dirty(y>>3,x,x);
+}
+
+// (߽)
+//x1,y1,x2,y2 Խ꣬ȷ x1<=x2;y1<=y2 0<=x<=127 0<=y<=63
+//dot:0,;1,
+void OLED_Fill(u8 x1,u8 y1,u8 x2,u8 y2,u8 dot)
+{
+	u8 page,x,mask;
+	if(x2>Max_Column-1) x2=Max_Column-1;
+	if(y2>Max_Row-1) y2=Max_Row-1;
+	if(x1>x2||y1>y2) return;
+	for(page=y1>>3;page<=(y2>>3);page++)
+	{
+		mask=0xFF;								//ҳ y1~y2 ռλ
+		if(page==(y1>>3)) mask&=0xFF<<(y1&7);
+		if(page==(y2>>3)) mask&=0xFF>>(7-(y2&7));
+		for(x=x1;x<=x2;x++)
+		{
+			if(dot) OLED_GRAM[page][x]|=mask;
+			else    OLED_GRAM[page][x]&=~mask;
+		}
+		OLED_FB_Dirty(page,x1,x2);
+	}
+}
+
+//Դָλûһַ ( OLED_ShowChar ͬ)
+//x:0~127
+//y:ҳ 0~7
+//Char_Size:16 (8x16 ռҳ)   (6x8)
+void OLED_FB_ShowChar(u8 x,u8 y,u8 chr,u8 Char_Size)
+{
+	unsigned char c=0,i=0;
+	c=chr-' ';//õƫƺֵ
+	if(x>Max_Column-1){x=0;y=y+2;}
+	if(Char_Size ==16)
+	{
+		if(y>6) return;
+		for(i=0;i<8&&x+i<Max_Column;i++)
+		{
+			OLED_GRAM[y][x+i]=F8X16[c*16+i];
+			OLED_GRAM[y+1][x+i]=F8X16[c*16+i+8];
+		}
+		OLED_FB_Dirty(y,x,x+7);
+		OLED_FB_Dirty(y+1,x,x+7);
+	}
+	else
+	{
+		if(y>7) return;
+		for(i=0;i<6&&x+i<Max_Column;i++)
+			OLED_GRAM[y][x+i]=F6x8[c][i];
+		OLED_FB_Dirty(y,x,x+5);
+	}
+}
+
+//Դ滭 ( OLED_ShowNum ͬ)
+void OLED_FB_ShowNum(u8 x,u8 y,u32 num,u8 len,u8 size2)
+{
+	u8 t,temp;
+	u8 enshow=0;
+	for(t=0;t<len;t++)
+	{
+		temp=(num/oled_pow(10,len-t-1))%10;
+		if(enshow==0&&t<(len-1))
+		{
+			if(temp==0)
+			{
+				OLED_FB_ShowChar(x+(size2/2)*t,y,' ',size2);
+				continue;
+			}else enshow=1;
+		}
+		OLED_FB_ShowChar(x+(size2/2)*t,y,temp+'0',size2);
+	}
+}
+
+//Դ滭ַ ( OLED_ShowString ͬ)
+void OLED_FB_ShowString(u8 x,u8 y,u8 *chr,u8 Char_Size)
+{
+	unsigned char j=0;
+	while (chr[j]!='\0')
+	{
+		OLED_FB_ShowChar(x,y,chr[j],Char_Size);
+		x+=8;
+		if(x>120){x=0;y+=2;}
+		j++;
+	}
+}
+
+//Դ滭 BMP ( OLED_DrawBMP ͬ)  x0~x1 Уy0~y1 ҳ
+void OLED_FB_DrawBMP(unsigned char x0, unsigned char y0,unsigned char x1, unsigned char y1,unsigned char BMP[])
+{
+	unsigned int j=0;
+	unsigned char x,y;
+	if(x1>Max_Column) x1=Max_Column;
+	if(y1>8) y1=8;
+	if(x0>=x1) return;
+	for(y=y0;y<y1;y++)
+	{
+		for(x=x0;x<x1;x++)
+			OLED_GRAM[y][x]=BMP[j++];
+		OLED_FB_Dirty(y,x0,x1-1);
+	}
+}
+
+//ˢһҳ 1:ˢһҳ  0:ûҳ
+//һ 3 ֽ + 128 ֽڣʺϷѭ/̯ʱ
+u8 OLED_Refresh_Step(void)
+{
+	u8 n,page,x0,x1;
+	u8 cmd[3];
+	for(n=0;n<8;n++)
+	{
+		page=(OLED_Refresh_Page+n)&7;
+		x0=OLED_Dirty_x0[page];
+		x1=OLED_Dirty_x1[page];
+		if(x0>x1) continue;
+		OLED_Dirty_x0[page]=Max_Column;		//ǣ͹ٻĻһֲ
+		OLED_Dirty_x1[page]=0;
+
+		cmd[0]=0xb0+page;					//ҳַ
+		cmd[1]=((x0&0xf0)>>4)|0x10;			//иߵַ
+		cmd[2]=x0&0x0f;						//е͵ַ
+		Write_IIC_Block(0x00,cmd,3);
+		Write_IIC_Block(0x40,&OLED_GRAM[page][x0],x1-x0+1);
+		OLED_Refresh_Page=page+1;
+		return 1;
+	}
+	return 0;
+}
+
+//ҳˢ
+void OLED_Refresh(void)
+{
+	while(OLED_Refresh_Step());
+}
+
+//ط (Ļֱд뺯Ĺ֮)
+void OLED_Refresh_All(void)
+{
+	u8 i;
+	for(i=0;i<8;i++) OLED_FB_Dirty(i,0,Max_Column-1);
+	OLED_Refresh();
+}
+
 //ʼSSD1306					    
 void OLED_Init(void)//   PA5,PA7
 {  
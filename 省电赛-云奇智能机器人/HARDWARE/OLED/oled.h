@@ -65,12 +65,23 @@ void OLED_DrawBMP(unsigned char x0, unsigned char y0,unsigned char x1, unsigned
 void Delay_50ms(unsigned int Del_50ms);
 void Delay_1ms(unsigned int Del_1ms);
 void fill_picture(unsigned char fill_Data);
+//Դ (֡) ͼȻ RAM OLED_Refresh ֻĶҳ/
+//OLED_DrawPoint / OLED_Fill ҲǻԴ
+void OLED_FB_Clear(void);
+void OLED_FB_ShowChar(u8 x,u8 y,u8 chr,u8 Char_Size);
+void OLED_FB_ShowNum(u8 x,u8 y,u32 num,u8 len,u8 size);
+void OLED_FB_ShowString(u8 x,u8 y,u8 *p,u8 Char_Size);
+void OLED_FB_DrawBMP(unsigned char x0, unsigned char y0,unsigned char x1, unsigned char y1,unsigned char BMP[]);
+u8 OLED_Refresh_Step(void);		//ˢһҳ 1:ˢ  0:ûҳ
+void OLED_Refresh(void);		//ˢҳ
+void OLED_Refresh_All(void);	//ط
 //void Picture();
 void IIC_Start(void);
 void IIC_Stop(void);
 void Write_IIC_Command(unsigned char IIC_Command);
 void Write_IIC_Data(unsigned char IIC_Data);
 void Write_IIC_Byte(unsigned char IIC_Byte);
+void Write_IIC_Block(unsigned char ctrl,const unsigned char *buf,unsigned char len);
 
 void IIC_Wait_Ack(void);
 #endif  
@@ -9,21 +9,34 @@ Float_angle  Att_Angle;	 //ATT
 static Int16_xyz mpu6050_dataacc,mpu6050_datagyr;
 Int16_xyz	Acc_Data_Con;  //˲ļٶ
 
+//IMU  (2ms)ȡһ DMA ͻĽ̬㣬ٷһΣ
 void sensor_0(void)
 {
-	MPU6050_GetDate();//MPU6050ݻȡ
-	MPU6050_DataCon(&mpu6050_dataacc,&mpu6050_datagyr);	//2ms
-	// 							accٶ      	  gyrٶ	
-	Accel.X = mpu6050_dataacc.X;
-	Accel.Y = mpu6050_dataacc.Y;
-	Accel.Z = mpu6050_dataacc.Z;
-	Gyro.X = mpu6050_datagyr.X;
-	Gyro.Y = mpu6050_datagyr.Y;
-	Gyro.Z = mpu6050_datagyr.Z;
-
-	Accel_Con( &Accel, &Gyro);//ٶ˲
-	IMUupdate( &Gyro, &Acc_Data_Con, &Att_Angle);	//IMU̬
-	printf("Pitch : %f \t Roll : %f \t Yaw %f \t\r\n",Att_Angle.pit,Att_Angle.rol,Att_Angle.yaw);
+	MPU6050_Sample s;
+
+	MPU6050_DMA_Poll();//ʱ
+	if(MPU6050_DMA_Read(&s))
+	{
+		MPU6050_LoadRaw(s.raw);
+		MPU6050_DataCon(&mpu6050_dataacc,&mpu6050_datagyr);
+		// 							accٶ      	  gyrٶ	
+		Accel.X = mpu6050_dataacc.X;
+		Accel.Y = mpu6050_dataacc.Y;
+		Accel.Z = mpu6050_dataacc.Z;
+		Gyro.X = mpu6050_datagyr.X;
+		Gyro.Y = mpu6050_datagyr.Y;
+		Gyro.Z = mpu6050_datagyr.Z;
+
+		Accel_Con( &Accel, &Gyro);//ٶ˲
+#if IMU_BENCH_EN
+		{
+			static u8 bench=0;
+			if(!bench){ bench=1; IMU_Benchmark( &Gyro, &Acc_Data_Con, 100); }	//ʵ  100 ΣĽ״̬
+		}
+#endif
+		IMUupdate_Q( &Gyro, &Acc_Data_Con, &Att_Angle, IMU_Get_dt_us(s.stamp));	//̬㣬ʵʲ
+	}
+	MPU6050_DMA_Start();//һ 14 ֽͻ (һû)
 }
 #endif
 
@@ -31,11 +44,10 @@ void sensor_0(void)
 // 
 void sensor_task(void)//()
 {
-	u8 tempe_humi_data[4];
-	DHT11_Read_Data(tempe_humi_data); //ȡʪֵ  PA11					    
-	_value[0]=tempe_humi_data[0]; //ʪ
-	_value[1]=ADC_GetConversionValue(ADC1);//MQ135--PB0 ֵ: 0~4095(12λADC2^12=4096) , 0~4095 ɶӦѹֵ 0~3.3V  
-	_value[2]=DS18B20_Get_Temp()/100; // PB9  ȣ1C , 2788 /100 = 27 ¶ֵ-55.00~125.00 
+	//DHT11/DS18B20  DHT11_Poll/DS18B20_Poll ̨ɼֻȡ
+	if(DHT11_Cache.valid)_value[0]=DHT11_Cache.humi; //ʪ  PA11
+	_value[1]=ADC_Scan_Read12(0);//MQ135--PB0 (ADC ɨ ̨) ֵ: 0~4095(12λADC2^12=4096) , 0~4095 ɶӦѹֵ 0~3.3V  
+	if(DS18B20_Cache.valid)_value[2]=DS18B20_Cache.temp/100; // PB9  ȣ1C , 2788 /100 = 27 ¶ֵ-55.00~125.00 
 //		printf("DS18B20 : %d\r\n",_value[3]);  
 //		printf("ʪ : %d\r\n",tempe_humi_data[0]);  //ú > 2000
 //		printf("ʪȸλ : %d\r\n",_value[1]);  //ú > 2000
@@ -352,7 +364,7 @@ void select_num(u8 num)
         break;
 
     };
-	delay_ms(2000);//2000ms
+	//Լ 2s ɵ Ľű ȴ (VOICE_NUM_MS)
 }
 void MQ135(void)//ú > 2000
 {
@@ -382,49 +394,125 @@ void ds18b20(void)
 {
     if(_value[2]>2400&&_value[2]<2900)
     {
-        OLED_DrawBMP(0,0,128,8,BMP2);//Ц
+        OLED_FB_DrawBMP(0,0,128,8,BMP2);//Ц
         printf("play,094,$");  //   
     }
     else if(_value[2]<=2400)
         {
-            OLED_DrawBMP(0,0,128,8,BMP3);//
+            OLED_FB_DrawBMP(0,0,128,8,BMP3);//
             printf("play,096,$");  //   
         }
         else if(_value[2]>=2900)
             {
-                OLED_DrawBMP(0,0,128,8,BMP4);//
+                OLED_FB_DrawBMP(0,0,128,8,BMP4);//
                 printf("play,095,$");  //   
             }
 }
 
+/************************  / ű  ************************
+  ԭ һ delay_ms(2500/3000) ˵˵һ䣬סü롣
+   һָ ɲ ŽУVoice_Step()  ʱִһȴ
+  ÿִ ->  wait  -> һ */
+#define VOICE_Q_LEN		16		//в (2 )
+#define VOICE_CMD_MAX	6		//һָ ༸
+#define VOICE_NUM_MS	2000	//select_num һ Լʱ
+
+#define VS_WAIT		0		//ֻȴ
+#define VS_PLAY		1		//printf("play,a,$")
+#define VS_NUM		2		//select_num(_value[a])
+#define VS_MQ135	3		//MQ135() 
+#define VS_FACE		4		//ds18b20()  + ¶
+#define VS_ACTION	5		//runActionGroup(a,b)
+
+typedef struct{
+				u8  op;
+				u8  a,b;
+				u16 wait;		//ִк ȶ ms ִһ
+				}Voice_Step_t;
+
+static Voice_Step_t Voice_Q[VOICE_Q_LEN];
+static u8 Voice_Head=0,Voice_Tail=0;			//ֻѭ
+static Voice_Step_t Voice_New[VOICE_CMD_MAX];	//һָ
+static u8 Voice_New_Num=0;
+static u32 Voice_Next=0;						//һ ִеĽ
+u32 Voice_Drop=0;								// ָ
+
+static void Voice_Add(u8 op,u8 a,u8 b,u16 wait)
+{
+	if(Voice_New_Num>=VOICE_CMD_MAX)return;
+	Voice_New[Voice_New_Num].op=op;
+	Voice_New[Voice_New_Num].a=a;
+	Voice_New[Voice_New_Num].b=b;
+	Voice_New[Voice_New_Num].wait=wait;
+	Voice_New_Num++;
+}
+
+//һָ ŽУŲ  (ֻ˵)
+static void Voice_Commit(void)
+{
+	u8 i;
+	if((u8)(VOICE_Q_LEN-(u8)(Voice_Tail-Voice_Head))<Voice_New_Num)
+	{
+		Voice_Drop++;
+	}
+	else
+	{
+		for(i=0;i<Voice_New_Num;i++)
+		{
+			Voice_Q[Voice_Tail&(VOICE_Q_LEN-1)]=Voice_New[i];
+			Voice_Tail++;
+		}
+	}
+	Voice_New_Num=0;
+}
+
+//ڵ (now:  ms)ʱִһ
+void Voice_Step(u32 now)
+{
+	Voice_Step_t *st;
+
+	while(Voice_Head!=Voice_Tail && (s32)(now-Voice_Next)>=0)
+	{
+		st=&Voice_Q[Voice_Head&(VOICE_Q_LEN-1)];
+		switch(st->op)
+		{
+			case VS_PLAY:	printf("play,%03u,$",st->a);		break;
+			case VS_NUM:	select_num(_value[st->a]);			break;
+			case VS_MQ135:	MQ135();							break;
+			case VS_FACE:	ds18b20();							break;
+			case VS_ACTION:	runActionGroup(st->a,st->b);		break;
+			default:											break;
+		}
+		Voice_Next=now+st->wait;
+		Voice_Head++;
+	}
+}
+
+u8 Voice_Busy(void)
+{
+	return Voice_Head!=Voice_Tail;
+}
+
 //************
 void voice_go(u8 Times)
 {
-	u8 num=0;
-	num=Times;
-    runActionGroup(1,1); //1Ŷ1
-	delay_ms(1000);
-    runActionGroup(2,Times); //1ŶTimes
-	while(num--)delay_ms(1000);
-    runActionGroup(3,1); //2Ŷ1
+    Voice_Add(VS_ACTION,1,1,1000); //1Ŷ1
+    Voice_Add(VS_ACTION,2,Times,1000*Times); //1ŶTimes
+    Voice_Add(VS_ACTION,3,1,0); //2Ŷ1
 }//*************
 void voice_back(u8 Times)
 {
-	u8 num=0;
-	num=Times;
-    runActionGroup(4,1); //4Ŷ1
-	delay_ms(1000);
-    runActionGroup(5,Times); //5ŶTimes
-	while(num--)delay_ms(1000);
-    runActionGroup(6,1); //6Ŷ1
+    Voice_Add(VS_ACTION,4,1,1000); //4Ŷ1
+    Voice_Add(VS_ACTION,5,Times,1000*Times); //5ŶTimes
+    Voice_Add(VS_ACTION,6,1,0); //6Ŷ1
 }//*************
 void voice_left(u8 Times)
 {
-    runActionGroup(12,Times); //12ŶTimes
+    Voice_Add(VS_ACTION,12,Times,0); //12ŶTimes
 }
 void voice_right(u8 Times)
 {
-    runActionGroup(13,Times); //13ŶTimes
+    Voice_Add(VS_ACTION,13,Times,0); //13ŶTimes
 }
 void yuying_Android(void)//Ի
 { 
@@ -511,21 +599,18 @@ void yuying_Android(void)//
 //			
 //            break;
 			case 23: 
-					printf("play,023,$"); //ǰ¶Ϊ
-					delay_ms(2500);
-				    select_num(_value[0]);
-					printf("play,021,$"); //
+					Voice_Add(VS_PLAY,23,0,2500); //ǰ¶Ϊ
+					Voice_Add(VS_NUM,0,0,VOICE_NUM_MS);
+					Voice_Add(VS_PLAY,21,0,0); //
             break;
 			case 24: 
-					printf("play,024,$"); //ǰʪΪ
-					delay_ms(2500);
-				    select_num(_value[2]);
-					ds18b20();
+					Voice_Add(VS_PLAY,24,0,2500); //ǰʪΪ
+					Voice_Add(VS_NUM,2,0,VOICE_NUM_MS);
+					Voice_Add(VS_FACE,0,0,0);
             break;
 			case 25: 
-					printf("play,025,$"); //ǰΪ
-					delay_ms(3000);
-					MQ135();
+					Voice_Add(VS_PLAY,25,0,3000); //ǰΪ
+					Voice_Add(VS_MQ135,0,0,0);
             break;
 			case 26: 
 			
@@ -543,62 +628,60 @@ void yuying_Android(void)//
 			
             break;
 			case 31: 
-					runActionGroup(10,1); //10Ŷ1
-					printf("play,031,$"); //ãܸʶ
+					Voice_Add(VS_ACTION,10,1,0); //10Ŷ1
+					Voice_Add(VS_PLAY,31,0,0); //ãܸʶ
             break;
 			case 32: 
-					runActionGroup(11,1); //10Ŷ1
-					printf("play,032,$"); //ҺãСƣϲ裬ҵǳΪܵĻ
+					Voice_Add(VS_ACTION,11,1,0); //10Ŷ1
+					Voice_Add(VS_PLAY,32,0,0); //ҺãСƣϲ裬ҵǳΪܵĻ
             break;
 			case 33: 
-					printf("play,033,$"); //					
-					delay_ms(2500);//2000ms
-					printf("play,050,$"); //֡ɶ
+					Voice_Add(VS_PLAY,33,0,2500); //
+					Voice_Add(VS_PLAY,50,0,0); //֡ɶ
             break;
 			case 34: 
-					printf("play,034,$"); //赸
-					delay_ms(2500);//2000ms
-					runActionGroup(14,1); 
-					printf("play,049,$"); //֡Сƻ
+					Voice_Add(VS_PLAY,34,0,2500); //赸
+					Voice_Add(VS_ACTION,14,1,0);
+					Voice_Add(VS_PLAY,49,0,0); //֡Сƻ
             break;
 			case 35: 
-					printf("play,035,$"); //
+					Voice_Add(VS_PLAY,35,0,0); //
             break;
 			case 36: 
-					printf("play,036,$"); //ӳɹ
+					Voice_Add(VS_PLAY,36,0,0); //ӳɹ
             break;
 			case 37:
-					printf("play,037,$"); //ʧ
+					Voice_Add(VS_PLAY,37,0,0); //ʧ
             break;
 			case 38: 
-					printf("play,038,$"); //Ͽ
+					Voice_Add(VS_PLAY,38,0,0); //Ͽ
             break;
 			case 39: 
-					printf("play,039,$"); //
+					Voice_Add(VS_PLAY,39,0,0); //
             break;
 			case 40: 
-					printf("play,040,$"); //һ
+					Voice_Add(VS_PLAY,40,0,0); //һ
             break;
 			case 41:
-					printf("play,041,$"); //µӰУаɣ֮
+					Voice_Add(VS_PLAY,41,0,0); //µӰУаɣ֮
             break;
 			case 42:
-					printf("play,042,$"); //ŵӰ:޳衢׸鹫Ԣ
+					Voice_Add(VS_PLAY,42,0,0); //ŵӰ:޳衢׸鹫Ԣ
             break;
 			case 43:
-					printf("play,043,$"); //һ֮ڳϺ
+					Voice_Add(VS_PLAY,43,0,0); //һ֮ڳϺ
             break;
 			case 44:
-					printf("play,044,$"); //ÿһ㣬
+					Voice_Add(VS_PLAY,44,0,0); //ÿһ㣬
             break;
 			case 45:
-					printf("play,045,$"); //Ը;УնɿգϺã
+					Voice_Add(VS_PLAY,45,0,0); //Ը;УնɿգϺã
             break;
 			case 46:
-					printf("play,046,$"); //821յԤ
+					Voice_Add(VS_PLAY,46,0,0); //821յԤ
             break;
 			case 47:
-					printf("play,047,$"); //ڣһҪŶ
+					Voice_Add(VS_PLAY,47,0,0); //ڣһҪŶ
             break;
 //			case 48:
 //					printf("play,048,$"); //õ
@@ -610,28 +693,28 @@ void yuying_Android(void)//
 //					printf("play,050,$"); //֡ɶ
 //            break;
 			case 51://
-					runActionGroup(15,1); //15Ŷ1
+					Voice_Add(VS_ACTION,15,1,0); //15Ŷ1
             break;
 			case 52://
-					printf("play,048,$"); //õ
-					runActionGroup(9,1); //15Ŷ1
+					Voice_Add(VS_PLAY,48,0,0); //õ
+					Voice_Add(VS_ACTION,9,1,0); //15Ŷ1
             break;
 			case 53://
-					runActionGroup(0,1); //15Ŷ1
+					Voice_Add(VS_ACTION,0,1,0); //15Ŷ1
             break;
 			case 54://ҡͷ    500-2500
 					MG90S_out(1600); 
 					s_val=2;
 					s=2; 
 					j=1600;//ҡͷ
-					TIM_Cmd(TIM2, ENABLE); //ʹTIM2					 
+					//s_val λ  Head_Swing_Task (10ms ) ִж
             break;
 			case 55://ͷ //500-2500
 					SG90_out(1200); 
 					s_val=1;
 					s=2; 
 					i=1200;//ͷ
-					TIM_Cmd(TIM2, ENABLE); //ʹTIM2					 
+					//s_val λ  Head_Swing_Task (10ms ) ִж
             break;
 			case 56:
 
@@ -723,7 +806,7 @@ void yuying_Android(void)//
 
 
 		}		
-		
+		Voice_Commit();//ָ  Voice_Step() ʱִ
 	}
 }
 
@@ -736,33 +819,33 @@ void yuying_Run(void)//
 		switch(ct)
         {
 			case 23: //ds18b20
-					delay_ms(2500); //ǰ¶Ϊ
-				    select_num(_value[2]);
-					printf("play,021,$"); //
+					Voice_Add(VS_WAIT,0,0,2500); //ǰ¶Ϊ (ģԼ˵)
+					Voice_Add(VS_NUM,2,0,VOICE_NUM_MS);
+					Voice_Add(VS_PLAY,21,0,0); //
 //					ds18b20();	
 			break;
 			case 24: //dht11
-					delay_ms(3000);//ǰʪΪٷ֮
-				    select_num(_value[0]);
+					Voice_Add(VS_WAIT,0,0,3000);//ǰʪΪٷ֮
+					Voice_Add(VS_NUM,0,0,0);
 			break;
 			case 25: //MQ135
-					delay_ms(3000);//ǰΪ
-					MQ135();
+					Voice_Add(VS_WAIT,0,0,3000);//ǰΪ
+					Voice_Add(VS_MQ135,0,0,0);
             break;
 			case 31: //ãܸʶ
-					runActionGroup(10,1); //10Ŷ1
+					Voice_Add(VS_ACTION,10,1,0); //10Ŷ1
             break;
 			case 32: //ҽܡ
-					runActionGroup(11,1); //Ϲ
+					Voice_Add(VS_ACTION,11,1,0); //Ϲ
             break;
 			case 33: 
-					delay_ms(2500);//		
-					printf("play,050,$"); //֡ɶ
+					Voice_Add(VS_WAIT,0,0,2500);//
+					Voice_Add(VS_PLAY,50,0,0); //֡ɶ
             break;
 			case 34: 
-					delay_ms(2500); //赸
-					printf("play,049,$"); //֡Сƻ
-					runActionGroup(14,1); 
+					Voice_Add(VS_WAIT,0,0,2500); //赸
+					Voice_Add(VS_PLAY,49,0,0); //֡Сƻ
+					Voice_Add(VS_ACTION,14,1,0);
             break;
 //			case 49:
 //					printf("play,049,$"); //֡Сƻ
@@ -771,27 +854,27 @@ void yuying_Run(void)//
 //					printf("play,050,$"); //֡ɶ
 //            break;
 			case 51://
-					runActionGroup(15,1); //15Ŷ1
+					Voice_Add(VS_ACTION,15,1,0); //15Ŷ1
             break;
 			case 52://
-					runActionGroup(9,1); //15Ŷ1
+					Voice_Add(VS_ACTION,9,1,0); //15Ŷ1
             break;
 			case 53://
-					runActionGroup(0,1); //15Ŷ1
+					Voice_Add(VS_ACTION,0,1,0); //15Ŷ1
             break;
 			case 54://ҡͷ    500-2500
 					MG90S_out(1600); 
 					s_val=2;
 					s=2; 
 					j=1600;//ҡͷ
-					TIM_Cmd(TIM2, ENABLE); //ʹTIM2					 
+					//s_val λ  Head_Swing_Task (10ms ) ִж
             break;
 			case 55://ͷ //500-2500
 					SG90_out(1200); 
 					s_val=1;
 					s=2; 
 					i=1200;//ͷ
-					TIM_Cmd(TIM2, ENABLE); //ʹTIM2					 
+					//s_val λ  Head_Swing_Task (10ms ) ִж
             break;
 
 			case 15:  
@@ -800,8 +883,7 @@ void runActionGroup(uint8_t numOfAction, uint16_t Times)
 							NumOfAction:
 												Times:ִд
 												Times = 0 ʱѭ  */
-					runActionGroup(7,1);
-					delay_ms(3000);
+					Voice_Add(VS_ACTION,7,1,3000);
 			break;
  
 
@@ -809,6 +891,7 @@ void runActionGroup(uint8_t numOfAction, uint16_t Times)
 
 
 		}
+		Voice_Commit();//ָ  Voice_Step() ʱִ
 	}
 	
 }
@@ -4,13 +4,22 @@
 #include "delay.h"
 #include "usart.h"
 #include "oled.h"
+#include "adc.h"
 #include "LobotServoController.h"
 #include "timer_asmx_pwm.h"
 #include "dht11.h"
 #include "ds18b20.h"
 #include "I2C_MPU6050.h"
+#include "I2C_MPU6050_DMA.h"
 #include "myimu.h"
 
+#ifndef MPU6050_EN
+#define MPU6050_EN	0	//1: MPU6050 (PB6/PB7) IMU   0: (Ĭϣ˵İ ڹ Define  MPU6050_EN=1)
+#endif
+#ifndef IMU_BENCH_EN
+#define IMU_BENCH_EN	0	//1: һ֡ IMU  һ / ʱԱȣprintf  (ãҪ MPU6050_EN=1)
+#endif
+
 extern uint16_t _value[4];
 extern u8 mmc;
 
@@ -31,7 +40,11 @@ void voice_back(u8 Times);
 void voice_right(u8 Times);
 void voice_left(u8 Times);
 
-void yuying_Android(void);//Ի
+void yuying_Android(void);//Ի (ָŽűУȴ)
+void yuying_Run(void);//Ի (ģ USART1ָŽűУȴ)
+void Voice_Step(u32 now);//ڵãʱִнűһ (now:  ms)
+u8   Voice_Busy(void);//1: űûִ
+extern u32 Voice_Drop;//ű ָ
 void ds18b20(void);
 void MQ135(void);
 void sensor_0(void);
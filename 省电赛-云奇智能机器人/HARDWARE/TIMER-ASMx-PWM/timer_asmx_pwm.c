@@ -196,65 +196,56 @@ u8 s=2;
 u8 Flag=0;
 u16 i=1200;//ͷ
 u16 j=1600;//ҡͷ
-void TIM2_IRQHandler(void)
+/* ͷ/ҡͷԭ TIM2 10ms ж TIM2 Ϊ 1ms  (sched.c)
+   Ϊ 10ms s_val Ϊ 0 ʱֱӷ */
+void Head_Swing_Task(void)
 {
-	if(TIM_GetITStatus(TIM2,TIM_IT_Update)==SET) //ж
+	if(s_val==0)return;
+	if(Flag==0)
 	{
-		if(Flag==0)
+		i-=10;
+		j-=10;
+	}
+	if(Flag==1)
+	{
+		i+=10;
+		j+=10;
+	}
+	if(s_val==1)//ͷ
+	{
+		if(i<=950)
 		{
-			i-=10;
-			j-=10;
+			Flag=1;
 		}
-		if(Flag==1)
+		if(i>=1450)
 		{
-			i+=10;
-			j+=10;
+			Flag=0;
 		}
-		if(s_val==1)//ͷ
+		if(i==1200)s--;
+		SG90_out(i);//500-2500   PB 13
+	}
+	else if(s_val==2)//ҡͷ
 		{
-			if(i<=950)
+			if(j<=1300)
 			{
 				Flag=1;
 			}
-			if(i>=1450)
+			if(j>=1900)
 			{
 				Flag=0;
 			}
-			if(i==1200)s--;
-			SG90_out(i);//500-2500   PB 13
+			if(j==1600)s--;
+			MG90S_out(j);//500-2500  PB 14
 		}
-		else if(s_val==2)//ҡͷ
-			{
-				if(j<=1300)
-				{
-					Flag=1;
-				}
-				if(j>=1900)
-				{
-					Flag=0;
-				}
-				if(j==1600)s--;
-				MG90S_out(j);//500-2500  PB 14
-			}
-	}
-	TIM_ClearITPendingBit(TIM2,TIM_IT_Update);  //жϱ־λ
 	if(s==0)
 	{		
 		if(s_val==2)MG90S_out(1600); 
 		else if(s_val==1 )SG90_out(1200); 
 		s_val=0;
-		TIM_Cmd(TIM2, DISABLE); 
 	}				 
 
 }
-void TIM3_IRQHandler(void)
-{
-	if(TIM_GetITStatus(TIM3,TIM_IT_Update)==SET) //ж
-	{
-		printf("TIM 3 .......\r\n");
-	}
-	TIM_ClearITPendingBit(TIM3,TIM_IT_Update);  //жϱ־λ
-}
+//TIM3  DS18B20 ̨ɼ (ʱ϶ʱ)TIM3_IRQHandler  ds18b20.c
 void TIM4_IRQHandler(void)
 {
 	if(TIM_GetITStatus(TIM4,TIM_IT_Update)==SET) //ж
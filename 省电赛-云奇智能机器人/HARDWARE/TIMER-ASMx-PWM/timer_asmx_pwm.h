@@ -39,4 +39,7 @@ void TIM4_Int_Init(u16 arr,u16 psc);
 void SG90_out(u16 num);//500-2500  --  20 000
 void MG90S_out(u16 num);//500-2500  --  20 000
 
+//ͷ/ҡͷ 10ms һ ( s_val Զλ)
+void Head_Swing_Task(void);
+
 #endif
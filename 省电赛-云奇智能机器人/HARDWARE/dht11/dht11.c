@@ -120,3 +120,136 @@ u8 DHT11_Init(void)
 	return DHT11_Check();//ȴDHT11ĻӦ
 } 
 
+
+/*********************** ̨ɼTIM1_CH4 벶 ***********************/
+DHT11_Data DHT11_Cache;
+
+#define DHT11_ST_IDLE	0		//һɼ
+#define DHT11_ST_START	1		//
+#define DHT11_ST_RX		2		//
+
+static u8  DHT11_State=DHT11_ST_IDLE;
+static u32 DHT11_T0=0;						//ǰ״̬ʼʱ ms
+static u32 DHT11_Next=0;					//´βɼʱ ms
+static volatile u8  DHT11_Edges=0;			//Ѳ½ظ
+static volatile u16 DHT11_Last_Cap=0;		//һ½صĲֵ
+static volatile u8  DHT11_Rx[5];
+static volatile u8  DHT11_Rx_Done=0;
+
+//PA11 ߣTIM1_CH4 ½벶 (жȲ)
+void DHT11_Async_Init(void)
+{
+	GPIO_InitTypeDef  GPIO_InitStructure;
+	TIM_ICInitTypeDef TIM_ICInitStructure;
+	NVIC_InitTypeDef  NVIC_InitStructure;
+
+ 	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA|RCC_APB2Periph_TIM1, ENABLE);
+ 	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_11;
+ 	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_PP;
+ 	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+ 	GPIO_Init(GPIOA, &GPIO_InitStructure);
+ 	GPIO_SetBits(GPIOA,GPIO_Pin_11);
+
+	TIM_ICInitStructure.TIM_Channel = TIM_Channel_4;
+	TIM_ICInitStructure.TIM_ICPolarity = TIM_ICPolarity_Falling;	//ֻ½
+	TIM_ICInitStructure.TIM_ICSelection = TIM_ICSelection_DirectTI;
+	TIM_ICInitStructure.TIM_ICPrescaler = TIM_ICPSC_DIV1;
+	TIM_ICInitStructure.TIM_ICFilter = 0x03;						//8 ˲ȥë
+	TIM_ICInit(TIM1, &TIM_ICInitStructure);
+	TIM_ITConfig(TIM1, TIM_IT_CC4, DISABLE);
+
+	NVIC_InitStructure.NVIC_IRQChannel = TIM1_CC_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0;		//һλԼ 78usҪʱȡֵ߲
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+
+	DHT11_State=DHT11_ST_IDLE;
+	DHT11_Cache.valid=0;
+	DHT11_Cache.ok=0;
+	DHT11_Cache.err=0;
+}
+
+/* ½˳
+	0  DHT11 Ӧ 80us ʼ
+	1  Ӧ 80us һλʼ (Լ 160us)
+	2~41  ÿһλ (Ҳһλ/źŵĿʼ)λֵ */
+void TIM1_CC_IRQHandler(void)
+{
+	u16 cap,dt;
+	u8 n;
+	if(TIM_GetITStatus(TIM1,TIM_IT_CC4)!=RESET)
+	{
+		cap=TIM_GetCapture4(TIM1);		// CCR4 ͬʱ CC4IF
+		dt=(cap>=DHT11_Last_Cap) ? cap-DHT11_Last_Cap : cap+DHT11_TIM_PERIOD-DHT11_Last_Cap;
+		DHT11_Last_Cap=cap;
+		n=DHT11_Edges++;
+		if(n>=2 && n<42)
+		{
+			n-=2;
+			DHT11_Rx[n>>3]<<=1;
+			if(dt>DHT11_BIT1_US) DHT11_Rx[n>>3]|=1;
+			if(n==39)
+			{
+				TIM_ITConfig(TIM1, TIM_IT_CC4, DISABLE);
+				DHT11_Rx_Done=1;
+			}
+		}
+	}
+}
+
+static void DHT11_Finish(u32 now, u8 ok)
+{
+	TIM_ITConfig(TIM1, TIM_IT_CC4, DISABLE);
+	DHT11_IO_OUT();
+	DHT11_DQ_OUT=1;
+	if(ok)
+	{
+		DHT11_Cache.humi=DHT11_Rx[0];
+		DHT11_Cache.humi_dec=DHT11_Rx[1];
+		DHT11_Cache.temp=DHT11_Rx[2];
+		DHT11_Cache.temp_dec=DHT11_Rx[3];
+		DHT11_Cache.stamp=now;
+		DHT11_Cache.valid=1;
+		DHT11_Cache.ok++;
+	}
+	else DHT11_Cache.err++;
+	DHT11_State=DHT11_ST_IDLE;
+}
+
+void DHT11_Poll(u32 now)
+{
+	switch(DHT11_State)
+	{
+		case DHT11_ST_IDLE:
+			if((s32)(now-DHT11_Next)<0) break;
+			DHT11_Next=now+DHT11_PERIOD_MS;
+			DHT11_IO_OUT();
+			DHT11_DQ_OUT=0;				//ʼź  >=18ms
+			DHT11_T0=now;
+			DHT11_State=DHT11_ST_START;
+			break;
+		case DHT11_ST_START:
+			if(now-DHT11_T0<DHT11_START_MS) break;
+			DHT11_Edges=0;
+			DHT11_Rx_Done=0;
+			DHT11_Rx[0]=DHT11_Rx[1]=DHT11_Rx[2]=DHT11_Rx[3]=DHT11_Rx[4]=0;
+			DHT11_Last_Cap=TIM_GetCapture4(TIM1);
+			TIM_ClearITPendingBit(TIM1, TIM_IT_CC4);
+			TIM_ITConfig(TIM1, TIM_IT_CC4, ENABLE);
+			DHT11_DQ_OUT=1;				//ͷ ()֮ DHT11 Ӧ
+			DHT11_IO_IN();
+			DHT11_T0=now;
+			DHT11_State=DHT11_ST_RX;
+			break;
+		case DHT11_ST_RX:
+			if(DHT11_Rx_Done)
+				DHT11_Finish(now, (u8)(DHT11_Rx[0]+DHT11_Rx[1]+DHT11_Rx[2]+DHT11_Rx[3])==DHT11_Rx[4]);
+			else if(now-DHT11_T0>DHT11_TIMEOUT_MS)
+				DHT11_Finish(now, 0);
+			break;
+		default:
+			DHT11_State=DHT11_ST_IDLE;
+			break;
+	}
+}
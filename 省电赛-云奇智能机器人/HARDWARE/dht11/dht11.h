@@ -18,4 +18,38 @@ u8 DHT11_Read_Bit(void);//
 u8 DHT11_Check(void);//DHT11
 void DHT11_Rst(void);//λDHT11   
 
+/* ̨ɼ ()
+	 DHT11_Read_Data  delay λжϣһҪ 20ms+ ȫռCPU
+	̨ʽ 18ms  DHT11_Poll ʱƽȴ
+	֮ÿһλ½ TIM1_CH4 (PA11) 벶¼ʱ̣
+	½ؼ = 50us + 26~28us(0)  70us(1)Լ 78us Ϊ0Լ 120us Ϊ1
+	TIM1 ʱ (1MHz 20ms)  TIM1_PWM_Init(20000-1,72-1)  (PWM  CH1/CH2)Ҫȳʼ
+	ʹã
+		TIM1_PWM_Init(20000-1,72-1);
+		DHT11_Async_Init();
+		DHT11_Poll(Sched_Ticks);		// (<=10ms һ)Ϊǰ ms
+		if(DHT11_Cache.valid) humi=DHT11_Cache.humi;
+*/
+#define DHT11_PERIOD_MS		2000	//ɼ (DHT11 ζȡٸ 1s)
+#define DHT11_START_MS		20		//ʼź ʱ (>=18ms)
+#define DHT11_TIMEOUT_MS	10		//ʼźź 40λĳʱ (Լ 5ms)
+#define DHT11_BIT1_US		100		//½ؼ ڴΪ1
+#define DHT11_TIM_PERIOD	20000	//TIM1  (ARR+1)
+
+typedef struct{
+				u8  humi;		//ʪ  %
+				u8  humi_dec;	//ʪ С
+				u8  temp;		//¶  C
+				u8  temp_dec;	//¶ С
+				u8  valid;		//1: ٳɹһ
+				u32 stamp;		//һγɹʱ ms
+				u32 ok;			//ɹ
+				u32 err;		//ʧܴ (ʱ/У)
+				}DHT11_Data;
+
+extern DHT11_Data DHT11_Cache;		//һγɹ
+
+void DHT11_Async_Init(void);		//PA11 + TIM1_CH4 벶 ʼ
+void DHT11_Poll(u32 now);			//ƽɼ״̬now: ǰ ms
+
 #endif
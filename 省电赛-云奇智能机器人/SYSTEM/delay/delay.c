@@ -70,4 +70,14 @@ void longdelay(u8 s) //
 }
 
 
- 
\ No newline at end of file
+ 
+
+//ʹ DWT ڼ (ظ)
+void DWT_Cycle_Init(void)
+{
+	if(DWT_CTRL & DWT_CTRL_CYCCNTENA) return;	//Ѿʹ
+	DEM_CR |= DEM_CR_TRCENA;		//ʹ DWT/ITM ģ
+	DWT_CYCCNT = 0;
+	DWT_CTRL |= DWT_CTRL_CYCCNTENA;	//ڼ
+}
+
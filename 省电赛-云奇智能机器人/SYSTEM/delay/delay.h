@@ -10,5 +10,19 @@ void delay_ms(u16 nms);
 void delay_us(u32 nus);
 void longdelay(u8 s); //ʱ
 void delay(u8 ms);   // ʱӳ
+
+/* DWT ڼ (Cortex-M3 ںԴ 32λ ÿ HCLK  1)
+   ʱ  ִʱռ SysTick  ʱ 
+   72MHz ʱ Լ 59.6s һΣֵʱֱ޷żɡ */
+#define DEM_CR				(*(volatile u32 *)0xE000EDFC)	//CoreDebug->DEMCR
+#define DWT_CTRL			(*(volatile u32 *)0xE0001000)
+#define DWT_CYCCNT			(*(volatile u32 *)0xE0001004)
+#define DEM_CR_TRCENA		(1<<24)
+#define DWT_CTRL_CYCCNTENA	(1<<0)
+#define DWT_CLK_MHZ			72								//HCLK 72MHz
+#define DWT_CYC_TO_US(cyc)	((u32)(cyc)/DWT_CLK_MHZ)		// -> us
+
+void DWT_Cycle_Init(void);		//ʹ DWT ڼ
+#define DWT_Get_Cycle()		(DWT_CYCCNT)					//ȡǰ
 				    
 #endif
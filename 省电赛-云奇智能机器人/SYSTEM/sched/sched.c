@@ -0,0 +1,191 @@
+#include "sched.h"
+#include "delay.h"
+#include "usart.h"
+#include <stdio.h>
+
+volatile u32 Sched_Ticks=0;		//ļ (ms)ֻ TIM2 ж
+u16 Sched_Load=0;				//CPU ռ 0.1%
+
+static Sched_Task *Sched_Tab=0;
+static u8 Sched_Num=0;
+static u32 Sched_Busy_Cyc=0;	//ִʱۼ
+static u32 Sched_Window=0;		//ڿʼ
+static u8 Sched_Report_Row=0;	//һ Ҫʽ к (0: )
+static char Sched_Report_Buf[160];	//ڷһ (ٴ Ҳ)
+static u16 Sched_Report_Pos=0,Sched_Report_Len=0;
+
+//TIM2 1ms ģ72MHz/72 = 1MHz 1000 һ
+static void Sched_Tick_Init(void)
+{
+	TIM_TimeBaseInitTypeDef  	TIM_TimeBaseStructure;
+	NVIC_InitTypeDef 			NVIC_InitStructure;
+
+	RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM2, ENABLE);
+	TIM_DeInit(TIM2);
+
+	TIM_TimeBaseStructure.TIM_Period = 1000*SCHED_TICK_MS-1;
+	TIM_TimeBaseStructure.TIM_Prescaler = 72-1;
+	TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+	TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
+	TIM_TimeBaseInit(TIM2, &TIM_TimeBaseStructure);
+	TIM_ClearITPendingBit(TIM2,TIM_IT_Update);
+	TIM_ITConfig(TIM2,TIM_IT_Update,ENABLE);
+
+	NVIC_InitStructure.NVIC_IRQChannel = TIM2_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+
+	TIM_Cmd(TIM2, ENABLE);
+}
+
+void Sched_Reset_Stats(void)
+{
+	u8 n;
+	for(n=0;n<Sched_Num;n++)
+	{
+		Sched_Tab[n].runs=0;
+		Sched_Tab[n].overruns=0;
+		Sched_Tab[n].last_cyc=0;
+		Sched_Tab[n].max_cyc=0;
+		Sched_Tab[n].sum_cyc=0;
+		Sched_Tab[n].max_late=0;
+	}
+	Sched_Busy_Cyc=0;
+	Sched_Window=Sched_Ticks;
+}
+
+void Sched_Init(Sched_Task *tab, u8 num)
+{
+	u8 n;
+	Sched_Tab=tab;
+	Sched_Num=num;
+	DWT_Cycle_Init();
+	for(n=0;n<num;n++)
+	{
+		tab[n].ready=0;
+		tab[n].next=Sched_Ticks+tab[n].offset;
+	}
+	Sched_Reset_Stats();
+	Sched_Tick_Init();
+}
+
+//ڼ飺ʱ ֻһΣ overruns
+static void Sched_Release(u32 now)
+{
+	u8 n;
+	Sched_Task *t;
+	for(n=0;n<Sched_Num;n++)
+	{
+		t=&Sched_Tab[n];
+		if(t->period==0 || (s32)(now-t->next)<0) continue;
+		if(t->ready) t->overruns++;		//һλûֵ
+		t->ready=1;
+		t->next+=t->period;
+		while((s32)(now-t->next)>=0)	//ֹһڣ
+		{
+			t->next+=t->period;
+			t->overruns++;
+		}
+	}
+}
+
+void Sched_Run(void)
+{
+	u8 n;
+	u32 now,cyc,late;
+	Sched_Task *t=0;
+
+	now=Sched_Ticks;
+	Sched_Release(now);
+
+	for(n=0;n<Sched_Num;n++)			//ȼߵľ
+	{
+		if(Sched_Tab[n].ready && (t==0 || Sched_Tab[n].prio<t->prio))
+			t=&Sched_Tab[n];
+	}
+	if(t)
+	{
+		late=now-(t->next-t->period);	//ڵʼ ˶
+		if(late>t->max_late) t->max_late=late;
+		t->ready=0;
+
+		cyc=DWT_Get_Cycle();
+		t->func();
+		cyc=DWT_Get_Cycle()-cyc;
+
+		t->runs++;
+		t->last_cyc=cyc;
+		t->sum_cyc+=cyc;
+		if(cyc>t->max_cyc) t->max_cyc=cyc;
+		Sched_Busy_Cyc+=cyc;
+	}
+
+	if(now-Sched_Window>=SCHED_LOAD_WINDOW)	// CPU ռ
+	{
+		Sched_Load=(u16)((uint64_t)Sched_Busy_Cyc*1000/((u32)(now-Sched_Window)*DWT_CLK_MHZ*1000));
+		Sched_Busy_Cyc=0;
+		Sched_Window=now;
+	}
+}
+
+u32 Sched_Avg_Cyc(const Sched_Task *t)
+{
+	if(t->runs==0) return 0;
+	return (u32)(t->sum_cyc/t->runs);
+}
+
+u8 Sched_Report_Step(USART_TypeDef *USARTx)
+{
+	char *buf=Sched_Report_Buf;
+	Sched_Task *t;
+	int len;
+
+	if(Sched_Report_Pos>=Sched_Report_Len)	//һзˣʽһ
+	{
+		if(Sched_Report_Row==0)
+		{
+			len=snprintf(buf,sizeof Sched_Report_Buf,"sched load %u.%u%% tick %lu\r\n",Sched_Load/10,Sched_Load%10,(unsigned long)Sched_Ticks);
+		}
+		else
+		{
+			t=&Sched_Tab[Sched_Report_Row-1];
+			len=snprintf(buf,sizeof Sched_Report_Buf,"%-8s p%-4u run %-7lu ovr %-5lu avg %-6luus max %-6luus late %lums\r\n",
+					t->name,t->period,(unsigned long)t->runs,(unsigned long)t->overruns,
+					(unsigned long)DWT_CYC_TO_US(Sched_Avg_Cyc(t)),(unsigned long)DWT_CYC_TO_US(t->max_cyc),
+					(unsigned long)t->max_late);
+		}
+		if(len<0) len=0;
+		if(len>=(int)sizeof Sched_Report_Buf)	//ص (̫)β
+		{
+			len=sizeof Sched_Report_Buf-1;
+			buf[len-2]='\r';
+			buf[len-1]='\n';
+		}
+		Sched_Report_Len=(u16)len;
+		Sched_Report_Pos=0;
+		Sched_Report_Row++;
+	}
+
+	//ֻд ͼĴճֽڣȴ
+	while(Sched_Report_Pos<Sched_Report_Len && USART_GetFlagStatus(USARTx,USART_FLAG_TXE)!=RESET)
+		USART_SendData(USARTx,Sched_Report_Buf[Sched_Report_Pos++]);
+
+	if(Sched_Report_Pos>=Sched_Report_Len && Sched_Report_Row>Sched_Num)
+	{
+		Sched_Report_Row=0;
+		return 1;
+	}
+	return 0;
+}
+
+//жϣֻκ
+void TIM2_IRQHandler(void)
+{
+	if(TIM_GetITStatus(TIM2,TIM_IT_Update)!=RESET)
+	{
+		TIM_ClearITPendingBit(TIM2,TIM_IT_Update);
+		Sched_Ticks++;
+	}
+}
@@ -0,0 +1,56 @@
+#ifndef __SCHED_H
+#define __SCHED_H
+#include "sys.h"
+#include "stdint.h"
+
+/* Эʽ (ǰ̨ ѭ)
+	TIM2 1ms жֻļ 1ѭﰴȼУһе
+	ÿڡ״ƫơȼ(0 )
+	ͳƣдʱ()/ƽִʱ (DWT ڼ)CPU ռʡ
+
+	ʹã
+	static Sched_Task task_tab[] = {
+		//					ms	ƫms	ȼ
+		{Head_Swing_Task,	"head",		10,		0,		0},
+		{LobotTick,			"lobot",	20,		5,		1},
+	};
+	Sched_Init(task_tab, SCHED_TASK_NUM(task_tab));
+	while(1) Sched_Run();
+*/
+
+#define SCHED_TICK_MS		1		// 1ms (TIM2)
+#define SCHED_LOAD_WINDOW	1000	//CPU ռ ͳƴ ms
+
+#define SCHED_TASK_NUM(tab)	(sizeof(tab)/sizeof((tab)[0]))
+
+typedef struct{
+				/*  (ﾲ̬) */
+				void (*func)(void);		//̫
+				const char *name;		// (ͳ)
+				u16 period;				// ms0:
+				u16 offset;				//״ƫ ms ͬһ
+				u8  prio;				//ȼ 0ߣͬʱʱ
+				/* ʱ (ά) */
+				u8  ready;				//ѵ ȴ
+				u32 next;				//´εڵĽ
+				u32 runs;				//д
+				u32 overruns;			//һλû ֵ () Ĵ
+				u32 last_cyc;			//һִʱ (DWT )
+				u32 max_cyc;			//ִʱ
+				uint64_t sum_cyc;		//ۼִʱ䣬ƽ = sum_cyc / runs
+				u32 max_late;			//ں ˶ٽĲ (ms)
+				}Sched_Task;
+
+extern volatile u32 Sched_Ticks;		//ļ (ms)
+extern u16 Sched_Load;					//һ CPU ռ 0.1% (ִʱ / ʱ)
+
+void Sched_Init(Sched_Task *tab, u8 num);	//TIM2 1ms  + DWT ʼλͳ
+void Sched_Run(void);						//ѭﷴãڣһȼľ
+void Sched_Reset_Stats(void);				//ͳ
+u32  Sched_Avg_Cyc(const Sched_Task *t);	//ƽִʱ (DWT )
+/* ͳһһиʽÿε ֻ TXE ճֽ д DRȴ
+	 1ms ȼ  (115200  ÿ 1~2 ֽ)
+	 1: һȫ */
+u8 Sched_Report_Step(USART_TypeDef *USARTx);
+
+#endif /* __SCHED_H */
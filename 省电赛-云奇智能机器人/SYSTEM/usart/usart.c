@@ -340,7 +340,8 @@ void uart3_init(u32 bound)
     //USART_ITConfig(USART3, USART_IT_TXE, ENABLE); //3ж  
     USART_Cmd(USART3, ENABLE); 					 //ʹܴ3   
 }
-	#if EN_USART_code_key  /* ݰʽ */
+	#if EN_USART3_LOBOT  /* ưӦ  LobotRxByte()  */
+	#elif EN_USART_code_key  /* ݰʽ */
 u8 USART3_RX_head=0;		//״̬ --  ͷ
 u8 USART3_RX_num=0;		//״̬ --  ݼ
 u8 USART3_RX_len=0;		//״̬ --  ݰ
@@ -30,6 +30,7 @@ extern char *pDataByte;
 #define EN_USART1_RX		1		//ʹܣ1/ֹ01
 #define EN_USART2_RX		1		//ʹܣ1/ֹ02
 #define EN_USART3_RX		1		//ʹܣ1/ֹ02
+#define EN_USART3_LOBOT		1		//1: 3Ӷư壬ж LobotServoController.c 
 
 #define USART1_REC_LEN		100 		//"FF 00 01 01 EE " =15ֽ 30
 #define USART2_REC_LEN		100  	//ֽ 
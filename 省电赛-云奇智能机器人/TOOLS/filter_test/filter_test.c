@@ -0,0 +1,177 @@
+/* ˲ filter.c  (УƬ)
+	ÿ˲ ֱӰ ĲοȽ (룬̶)
+		ƽ      ԭ Accel_Con  "ÿȫٳ" ͬ (3 ͨ 20 )
+		2^n ƽ   ȫͺ >>shift ͬ shift=8 ( 256)
+		ֵ           ȡм ͬ 3 (Median3)  5/9 ()
+		һ IIR       ͬʽ 64 λ ͬ
+
+	룺gcc -O2 -I ../../../COMMON/TOOLS -I stub -I ../../HARDWARE/FILTER -o filter_test filter_test.c
+	÷filter_test        ȫͨ 0򷵻 1 ӡ һͬλ
+*/
+#include "filter.c"
+#include "test_common.h"
+#include <string.h>
+
+#define STEP_NUM	200000
+
+static s16 Rand_S16(void)
+{
+	return (s16)(Rand() >> 8);
+}
+
+/* ԭ Accel_Con λ ÿȫ */
+#define FILTER_NUM	20
+static void Old_Accel_Con(const s16 *in, s16 *out)
+{
+	static u8  filter_cnt = 0;
+	static s16 buf[3][FILTER_NUM];
+	s32 sum;
+	u8  c, i;
+
+	for(c=0; c<3; c++)
+	{
+		buf[c][filter_cnt] = in[c];
+		for(sum=0, i=0; i<FILTER_NUM; i++) sum += buf[c][i];
+		out[c] = sum / FILTER_NUM;
+	}
+	if(++filter_cnt == FILTER_NUM) filter_cnt = 0;
+}
+
+static int Cmp_S16(const void *a, const void *b)
+{
+	return *(const s16 *)a - *(const s16 *)b;
+}
+
+MA_FILTER_DEF(acc_filter, 3, FILTER_NUM);
+static int Test_MA(void)
+{
+	s16 in[3], a[3], b[3];
+	long n;
+
+	for(n=0; n<STEP_NUM; n++)
+	{
+		in[0] = Rand_S16(); in[1] = Rand_S16(); in[2] = Rand_S16() % 1000;
+		Old_Accel_Con(in, a);
+		MA_Filter_Update(&acc_filter, in, b);
+		if(memcmp(a, b, sizeof(a)))
+		{
+			printf("ƽ  %ld : ԭ %d %d %d   %d %d %d\n", n, a[0], a[1], a[2], b[0], b[1], b[2]);
+			return 1;
+		}
+	}
+	//Reset ֮  նʱһ
+	MA_Filter_Reset(&acc_filter);
+	in[0] = in[1] = in[2] = 200;
+	MA_Filter_Update(&acc_filter, in, b);
+	if(b[0] != 200 / FILTER_NUM)
+	{
+		printf("ƽ Reset  %d ӦΪ %d\n", b[0], 200 / FILTER_NUM);
+		return 1;
+	}
+	return 0;
+}
+
+MA2N_FILTER_DEF(ma8, 2, 3);
+MA2N_FILTER_DEF(ma256, 1, 8);
+static int Test_MA_Pow2_One(MA_Filter *f, const char *name)
+{
+	static s16 hist[2][256];
+	s16 in[2], out[2];
+	s32 sum;
+	long n;
+	u16 i, c;
+
+	memset(hist, 0, sizeof(hist));
+	for(n=0; n<STEP_NUM; n++)
+	{
+		for(c=0; c<f->ch; c++)
+		{
+			in[c] = Rand_S16();
+			hist[c][n % f->win] = in[c];
+		}
+		MA_Filter_Update_Pow2(f, in, out);
+		for(c=0; c<f->ch; c++)
+		{
+			for(sum=0, i=0; i<f->win; i++) sum += hist[c][i];
+			if(out[c] != (s16)(sum >> f->shift))
+			{
+				printf("%s  %ld  ͨ %d: %d ӦΪ %d\n", name, n, c, out[c], (s16)(sum >> f->shift));
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
+
+MED_FILTER_DEF(med3, 2, 3);
+MED_FILTER_DEF(med5, 1, 5);
+MED_FILTER_DEF(med9, 1, 9);
+static int Test_MED_One(MED_Filter *f, const char *name)
+{
+	static s16 hist[2][FILTER_MED_MAX];
+	s16 in[2], out[2], tmp[FILTER_MED_MAX];
+	long n;
+	u8 c;
+
+	memset(hist, 0, sizeof(hist));
+	for(n=0; n<STEP_NUM; n++)
+	{
+		for(c=0; c<f->ch; c++)
+		{
+			in[c] = Rand_S16() >> (n & 7);		//СȶУҲȵֵ
+			hist[c][n % f->n] = in[c];
+		}
+		MED_Filter_Update(f, in, out);
+		for(c=0; c<f->ch; c++)
+		{
+			memcpy(tmp, hist[c], f->n * sizeof(s16));
+			qsort(tmp, f->n, sizeof(s16), Cmp_S16);
+			if(out[c] != tmp[f->n / 2])
+			{
+				printf("%s  %ld  ͨ %d: %d ӦΪ %d\n", name, n, c, out[c], tmp[f->n / 2]);
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
+
+IIR_FILTER_DEF(iir, 2, 4);
+static int Test_IIR(void)
+{
+	int64_t y[2];
+	s32 in[2], out[2];
+	long n;
+	u8 c;
+
+	for(n=0; n<STEP_NUM; n++)
+	{
+		in[0] = Rand_S16();
+		in[1] = -20000 + (Rand_S16() & 0xFF);	//һֱǸ
+		IIR_Filter_Update(&iir, in, out);
+		for(c=0; c<2; c++)
+		{
+			if(n == 0) y[c] = (int64_t)in[c] * 16;
+			else       y[c] += in[c] - (y[c] >> 4);
+			if(out[c] != (s32)(y[c] >> 4))
+			{
+				printf("IIR  %ld  ͨ %d: %ld ӦΪ %ld\n", n, c, (long)out[c], (long)(y[c] >> 4));
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
+
+int main(void)
+{
+	Fail |= Test_MA();
+	Fail |= Test_MA_Pow2_One(&ma8, "2^3 ƽ");
+	Fail |= Test_MA_Pow2_One(&ma256, "2^8 ƽ");
+	Fail |= Test_MED_One(&med3, "ֵ3");
+	Fail |= Test_MED_One(&med5, "ֵ5");
+	Fail |= Test_MED_One(&med9, "ֵ9");
+	Fail |= Test_IIR();
+	CHECK(Median3(3, 1, 2) == 2 && Median3(-5, -5, 7) == -5, "Median3 ");
+	return Test_Done();
+}
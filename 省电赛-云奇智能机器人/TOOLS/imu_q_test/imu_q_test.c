@@ -0,0 +1,132 @@
+/* ̬ IMUupdate_Q طŲ (УƬ)
+	ͬһ  ͬʱι  IMUupdate   IMUupdate_QȽ̬ǣ
+	 ϳɵ / Ұڶ + ת +  (̶ӣÿһ)
+	ǰһ ̶ 2ms ڣһ  1.5~2.5ms ֮䶶 ( IMU_Get_dt_us ʵʸһ)
+	ⵥ fx_asin / fx_atan2 
+
+	룺gcc -O2 -I ../../../COMMON/TOOLS -I stub -I ../../HARDWARE/MPU6050 -I ../../HARDWARE/FILTER -o imu_q_test imu_q_test.c -lm
+	÷imu_q_test        ȫͨ 0򷵻 1 ӡ һλ
+*/
+#include "myimu.c"
+#include "filter.c"
+#include "test_common.h"
+#include <math.h>
+
+#define STEP_NUM		20000		//طŵ
+#define ANGLE_TOL		0.05		/// ̬  ()
+#define TRIG_TOL		1.75e-4		//asin/atan2  (ȣԼ 0.01 )
+
+static int Rand_Range(int n)		//[-n, n]
+{
+	return (int)((Rand() >> 8) % (2 * n + 1)) - n;
+}
+
+//һ㣺t ʱ  ٶ (2g  16384/g)  ٶ (2000dps )
+static void Make_Sample(double t, Int16_xyz *acc, Int16_xyz *gyr)
+{
+	double r = 0.8 * sin(t * 0.7), p = 0.5 * cos(t * 0.45);
+	acc->X = (int16_t)(16384 * (-sin(p))) + Rand_Range(20);
+	acc->Y = (int16_t)(16384 * sin(r) * cos(p)) + Rand_Range(20);
+	acc->Z = (int16_t)(16384 * cos(r) * cos(p)) + Rand_Range(20);
+	gyr->X = (int16_t)(0.8 * 0.7 * cos(t * 0.7) / 0.0010653) + Rand_Range(5);
+	gyr->Y = (int16_t)(-0.5 * 0.45 * sin(t * 0.45) / 0.0010653) + Rand_Range(5);
+	gyr->Z = (int16_t)(300 * sin(t)) + Rand_Range(5);
+}
+
+static double Angle_Diff(const Float_angle *a, const Float_angle *b)
+{
+	double d = fabs(a->rol - b->rol);
+	if(fabs(a->pit - b->pit) > d) d = fabs(a->pit - b->pit);
+	if(fabs(a->yaw - b->yaw) > d) d = fabs(a->yaw - b->yaw);
+	return d;
+}
+
+static int Test_Replay(void)
+{
+	Float_angle af = {0,0,0}, aq = {0,0,0};
+	Int16_xyz acc, gyr;
+	double t = 0, d, max_d = 0;
+	u32 dt = IMU_DT_DEFAULT_US;
+	int n;
+
+	IMUupdate_Q_Reset();
+	for(n = 0; n < STEP_NUM; n++)
+	{
+		if(n >= STEP_NUM / 2) dt = IMU_DT_DEFAULT_US + Rand_Range(500);
+		t += dt * 1e-6;
+		Make_Sample(t, &acc, &gyr);
+		IMU_Set_Period(dt);
+		IMUupdate(&gyr, &acc, &af);
+		IMUupdate_Q(&gyr, &acc, &aq, dt);
+		d = Angle_Diff(&af, &aq);
+		if(d > max_d) max_d = d;
+		if(d > ANGLE_TOL)
+		{
+			printf("ط  %d   %.4f :  %.3f %.3f %.3f   %.3f %.3f %.3f\n",
+				n, d, af.rol, af.pit, af.yaw, aq.rol, aq.pit, aq.yaw);
+			return 1;
+		}
+	}
+	printf("ط %d   %.4f    rol %.3f pit %.3f yaw %.3f\n", STEP_NUM, max_d, aq.rol, aq.pit, aq.yaw);
+	return 0;
+}
+
+//ֹˮƽֽ㶼Ӧ 0 
+static int Test_Level(void)
+{
+	Int16_xyz acc = {0, 0, 16384}, gyr = {0, 0, 0};
+	Float_angle af = {0,0,0}, aq = {0,0,0};
+	int n, fail = 0;
+
+	q0 = 1; q1 = q2 = q3 = 0;			// û Resetط֮ ֶصʼ״̬
+	exInt = eyInt = ezInt = 0;
+	IMU_Set_Period(IMU_DT_DEFAULT_US);
+	IMUupdate_Q_Reset();
+	for(n = 0; n < 5000; n++)
+	{
+		IMUupdate(&gyr, &acc, &af);
+		IMUupdate_Q(&gyr, &acc, &aq, IMU_DT_DEFAULT_US);
+	}
+	if(fabs(af.rol) > ANGLE_TOL || fabs(af.pit) > ANGLE_TOL || fabs(af.yaw) > ANGLE_TOL)
+	{
+		printf("ֹ  : rol %.4f pit %.4f yaw %.4f\n", af.rol, af.pit, af.yaw);
+		fail = 1;
+	}
+	if(fabs(aq.rol) > ANGLE_TOL || fabs(aq.pit) > ANGLE_TOL || fabs(aq.yaw) > ANGLE_TOL)
+	{
+		printf("ֹ  : rol %.4f pit %.4f yaw %.4f\n", aq.rol, aq.pit, aq.yaw);
+		fail = 1;
+	}
+	return fail;
+}
+
+static int Test_Trig(void)
+{
+	double e, max_asin = 0, max_atan2 = 0, v, th;
+	int i;
+
+	for(i = -1000; i <= 1000; i++)
+	{
+		v = i / 1000.0;
+		e = fabs(fx_asin((s32)(v * Q30_ONE)) / (double)(1 << 29) - asin(v));
+		if(e > max_asin) max_asin = e;
+	}
+	for(i = 0; i < 3600; i++)
+	{
+		th = i * M_PI / 1800 - M_PI;
+		e = fabs(fx_atan2((s32)(sin(th) * 1e9), (s32)(cos(th) * 1e9)) / (double)(1 << 29) - atan2(sin(th), cos(th)));
+		if(e > M_PI) e = fabs(e - 2 * M_PI);
+		if(e > max_atan2) max_atan2 = e;
+	}
+	printf("asin  %.2e   atan2  %.2e \n", max_asin, max_atan2);
+	return max_asin > TRIG_TOL || max_atan2 > TRIG_TOL;
+}
+
+int main(void)
+{
+	Rand_Seed = 12345;
+	Fail |= Test_Trig();
+	Fail |= Test_Replay();
+	Fail |= Test_Level();
+	return Test_Done();
+}
@@ -0,0 +1,9 @@
+/* ϱãDWT ڼ ÿһ 1000  */
+#ifndef __DELAY_H
+#define __DELAY_H
+static u32 fake_cyc;
+#define DWT_Cycle_Init()
+#define DWT_Get_Cycle()		(fake_cyc+=1000)
+#define DWT_CLK_MHZ			72
+#define DWT_CYC_TO_US(cyc)	((u32)(cyc)/DWT_CLK_MHZ)
+#endif
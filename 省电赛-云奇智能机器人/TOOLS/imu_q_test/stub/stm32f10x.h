@@ -0,0 +1,11 @@
+/* ϱãֻ myimu.c / filter.c õ */
+#ifndef __STM32F10x_H
+#define __STM32F10x_H
+#include <stdint.h>
+typedef int32_t  s32;
+typedef int16_t  s16;
+typedef int8_t   s8;
+typedef uint32_t u32;
+typedef uint16_t u16;
+typedef uint8_t  u8;
+#endif
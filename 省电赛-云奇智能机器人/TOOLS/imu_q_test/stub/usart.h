@@ -0,0 +1,5 @@
+/* ϱãprintf ֱӵն */
+#ifndef __USART_H
+#define __USART_H
+#include <stdio.h>
+#endif
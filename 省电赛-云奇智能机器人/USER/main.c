@@ -13,6 +13,82 @@
 
 #include "ds18b20.h"
 #include "timer_asmx_pwm.h"
+#include "LobotServoController.h"
+#include "play_music.h"
+#include "sched.h"
+
+#define SCHED_REPORT_EN		0	//1: 调度统计 周期从 USART2 (蓝牙) 输出，调试用
+
+static void Voice_Task(void)//语音模块 USART1 收到指令，放进脚本队列
+{
+	if(USART1_led)
+	{
+		USART1_led=0;
+		yuying_Run();
+	}
+	Voice_Step(Sched_Ticks);//到时间的 播报/动作 步骤
+}
+
+static void Android_Task(void)//蓝牙 Android USART2 收到指令
+{
+	if(USART2_led)
+	{
+		USART2_led=0;
+		yuying_Android();
+	}
+}
+
+static void Temp_Task(void)//DHT11/DS18B20 后台采集 状态机推进，不阻塞
+{
+	DHT11_Poll(Sched_Ticks);
+	DS18B20_Poll(Sched_Ticks);
+}
+
+static void Oled_Task(void)//每次只刷一个脏页 (画图都用 OLED_FB_xxx 画进显存)
+{
+	OLED_Refresh_Step();
+}
+
+#if SCHED_REPORT_EN
+#define SCHED_REPORT_MS		1000	//每隔多久 输出一轮统计
+
+static void Report_Task(void)//1ms 任务，每次只写 TXE 空出来的字节
+{
+	static u8  run=0;
+	static u32 start=0;
+	if(!run)
+	{
+		if(Sched_Ticks-start<SCHED_REPORT_MS)return;
+		start=Sched_Ticks;
+		run=1;
+	}
+	if(Sched_Report_Step(USART2))run=0;
+}
+#endif
+
+/* ADC 扫描通道表 (顺序即 ADC_Scan_Read 的下标) */
+static const ADC_Scan_Chan Adc_List[] = {
+	{ADC_Channel_8,		ADC_SampleTime_55Cycles5},	//0: PB0  MQ135
+	{ADC_Channel_17,	ADC_SampleTime_239Cycles5},	//1: 内部参考 Vrefint (换算 mV 用)
+};
+
+/* 任务表：周期 ms，偏移 ms 把各任务错开，优先级 0最高 */
+static Sched_Task Task_Tab[] = {
+	//函数				名字		周期	偏移	优先级
+	{Head_Swing_Task,	"head",		10,		0,		0},
+	{LobotTick,			"lobot",	20,		3,		1},
+	{Voice_Task,		"voice",	20,		7,		2},
+	{Android_Task,		"android",	20,		13,		2},
+	{Temp_Task,			"temp",		5,		1,		1},
+	{Oled_Task,			"oled",		50,		17,		3},
+	{sensor_task,		"sensor",	2000,	500,	4},
+#if MPU6050_EN
+	{sensor_0,			"imu",		2,		0,		0},	//MPU6050 DMA 突发读 + 姿态解算
+#endif
+#if SCHED_REPORT_EN
+	{Report_Task,		"report",	1,		0,		5},
+#endif
+};
 
 
 int main(void)
@@ -23,19 +99,23 @@ int main(void)
 	delay_init(72);
     	GPIO_PinRemapConfig(GPIO_Remap_SWJ_JTAGDisable , ENABLE);   // 不使用JTAG调试，对应的IO口作为普通IO口使用
     	OLED_Init();//初始化OLED     SCL--PA5    SDA--PA7
-    	OLED_DrawBMP(0,0,128,8,BMP1);//默认  
-	/* 中断/溢出  时间 Tout us= ((arr+1)*(psc+1))/Tclk  */
-	// TIM2 中断/溢出  时间 Tout us=   1000 * 72 / 72 = 1000 us
-	TIM2_Int_Init(1000-1,720-1);// 10ms中断
+    	OLED_FB_DrawBMP(0,0,128,8,BMP1);//默认 表情 画进显存，oled 任务 分页送到屏上
+	/* TIM2 改为调度器 1ms 节拍，在 Sched_Init 里初始化 */
 	TIM1_PWM_Init(20000-1,72-1); //舵机的控制   用来产生PWM 频率  20ms = 50hz. 
 	uart1_init(115200);//语音                                                           USART1_TX PA.9  RX  PA.10
 	uart2_init(115200);//蓝牙 Android   												PA2 TXD2        PA3 RXD2   #&0001%
 	uart3_init(9600);//舵机控制板                                                       PB10  TXD3      PB11 RXD3 
-    	ADC1_Mode_init( );///stm32_adc转换，模拟输入端为  													PB0
-	DHT11_Init();//																						PA11
-   	DS18B20_Init();// 																					PB9 
+	LobotInit();//舵机控制板 指令经 USART3 TX DMA 后台发送
+    	ADC_Scan_Init(Adc_List, sizeof(Adc_List)/sizeof(Adc_List[0]));//ADC 扫描 TIM4触发 DMA双缓冲 16倍过采样 	PB0
+	DHT11_Async_Init();//后台采集 TIM1_CH4 输入捕获 (要在 TIM1_PWM_Init 之后)							PA11
+   	DS18B20_Async_Init();//后台采集 TIM3 定时单总线 																PB9 
+#if MPU6050_EN
+	InitMPU6050();//阻塞方式 配置寄存器 (只在上电时)		PB6-SCL  PB7-SDA
+	MPU6050_DMA_Init();//之后 由 imu 任务 I2C1 中断 + DMA 后台突发读
+#endif
 
+	Sched_Init(Task_Tab, SCHED_TASK_NUM(Task_Tab));//TIM2 1ms 节拍
 	while(1) {
-	/* test */
+		Sched_Run();//运行到期的最高优先级任务
     	}
 }